@@ -39,6 +39,9 @@
 *                             scan input file: off - on
 *                             number of freq: 2 -> 3
 *                           add option -noscan
+*           2026/10/17 1.20 add option -scan1, -j, -sf
+*           2026/10/17 1.21 add option -crx, -gz
+*                           show no progress of per-file conversion threads
 *-----------------------------------------------------------------------------*/
 #include <stdio.h>
 #include <stdlib.h>
@@ -49,6 +52,25 @@
 #define PRGNAME   "CONVBIN"
 #define TRACEFILE "convbin.trace"
 #define NOUTFILE        9       /* number of output files */
+#define MAXTHREAD       64      /* max number of conversion threads */
+
+typedef struct {                /* per-file conversion control type */
+    int    format;              /* input format */
+    const rnxopt_t *opt;        /* rinex options */
+    char   **ifile;             /* input files */
+    int    nf;                  /* number of input files */
+    char   **file;              /* output files */
+    char   *dir;                /* output directory */
+    int    next;                /* next file to be converted */
+    int    stat;                /* status */
+    lock_t lock;                /* lock flag */
+} convf_t;
+
+#ifdef WIN32
+static DWORD mainthread;        /* main thread id */
+#else
+static pthread_t mainthread;    /* main thread id */
+#endif
 
 /* help text -----------------------------------------------------------------*/
 static const char *help[]={
@@ -131,6 +153,11 @@ static const char *help[]={
 "     -ol          include leap seconds in rinex nav header [off]",
 "     -scan        scan input file [on]",
 "     -noscan      no scan input file [off]",
+"     -scan1       scan input file in single pass [off]",
+"     -j nthread   number of threads for wild-card expanded input files [1]",
+"     -sf          convert each input file to separate output files [off]",
+"     -crx         output compact rinex (hatanaka) obs [off]",
+"     -gz          compress output files by gzip [off]",
 "     -halfc       half-cycle ambiguity correction [off]",
 "     -mask   [sig[,...]] signal mask(s) (sig={G|R|E|J|S|C|I}L{1C|1P|1W|...})",
 "     -nomask [sig[,...]] signal no mask (same as above)",
@@ -151,7 +178,14 @@ static const char *help[]={
 "",
 " If any output file specified, default output files (<file>.obs,",
 " <file>.nav, <file>.gnav, <file>.hnav, <file>.qnav, <file>.lnav and",
-" <file>.sbs) are used.",
+" <file>.sbs) are used. With option -crx, the default obs file is <file>.crx.",
+" With option -gz, .gz is appended to the output files.",
+"",
+" With option -j, wild-card expanded input files of RTCM 3 or RINEX are",
+" decoded in parallel and merged into the output files. The files are",
+" converted in sequence if the decoding depends on the previous file or for",
+" other formats. With option -sf, each input file is converted to the output",
+" files for the file and -j sets the number of files converted in parallel.",
 "",
 " If receiver type is not specified, type is recognized by the input",
 " file extension as follows.",
@@ -181,6 +215,13 @@ static void printhelp(void)
 extern int showmsg(char *format, ...)
 {
     va_list arg;
+    
+    /* no progress of per-file conversion threads */
+#ifdef WIN32
+    if (GetCurrentThreadId()!=mainthread) return 0;
+#else
+    if (!pthread_equal(pthread_self(),mainthread)) return 0;
+#endif
     va_start(arg,format); vfprintf(stderr,format,arg); va_end(arg);
     fprintf(stderr,*format?"\r":"\n");
     return 0;
@@ -190,7 +231,7 @@ static int convbin(int format, rnxopt_t *opt, const char *ifile, char **file,
                    char *dir)
 {
     int i,def;
-    static char work[1024],ofile_[NOUTFILE][1024]={"","","","","","","","",""};
+    char work[1024],ofile_[NOUTFILE][1024]={"","","","","","","","",""};
     char *ofile[NOUTFILE],*p;
     char *extnav=opt->rnxver<=2.99||opt->navsys==SYS_GPS?"N":"P";
     char *extlog=format==STRFMT_LEXR?"lex":"sbs";
@@ -202,12 +243,12 @@ static int convbin(int format, rnxopt_t *opt, const char *ifile, char **file,
     
     if (file[0]) strcpy(ofile[0],file[0]);
     else if (*opt->staid) {
-        strcpy(ofile[0],"%r%n0.%yO");
+        strcpy(ofile[0],opt->crinex?"%r%n0.%yD":"%r%n0.%yO");
     }
     else if (def) {
         strcpy(ofile[0],ifile);
-        if ((p=strrchr(ofile[0],'.'))) strcpy(p,".obs");
-        else strcat(ofile[0],".obs");
+        if ((p=strrchr(ofile[0],'.'))) strcpy(p,opt->crinex?".crx":".obs");
+        else strcat(ofile[0],opt->crinex?".crx":".obs");
     }
     if (file[1]) strcpy(ofile[1],file[1]);
     else if (*opt->staid) {
@@ -309,6 +350,87 @@ static int convbin(int format, rnxopt_t *opt, const char *ifile, char **file,
     fprintf(stderr,"\n");
     return 0;
 }
+/* per-file conversion thread ------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI convfthread(void *arg)
+#else
+static void *convfthread(void *arg)
+#endif
+{
+    convf_t *cf=(convf_t *)arg;
+    rnxopt_t *opt;
+    int k,stat;
+    
+    if (!(opt=(rnxopt_t *)malloc(sizeof(rnxopt_t)))) return 0;
+    
+    for (;;) {
+        lock(&cf->lock);
+        k=cf->next++;
+        unlock(&cf->lock);
+        if (k>=cf->nf) break;
+        
+        /* convert a file with default options */
+        *opt=*cf->opt;
+        opt->nthread=0;
+        sprintf(opt->comment[0],"log: %-55.55s",cf->ifile[k]);
+        
+        stat=convbin(cf->format,opt,cf->ifile[k],cf->file,cf->dir);
+        
+        lock(&cf->lock);
+        if (stat) cf->stat=stat;
+        unlock(&cf->lock);
+    }
+    free(opt);
+    return 0;
+}
+/* convert input files separately --------------------------------------------*/
+static int convbin_f(int format, rnxopt_t *opt, const char *ifile, char **file,
+                     char *dir)
+{
+    convf_t cf={0};
+    thread_t thread[MAXTHREAD];
+    char *paths[MAXEXFILE]={0};
+    int i,n,nt;
+    
+    for (i=0;i<MAXEXFILE;i++) {
+        if (!(paths[i]=(char *)malloc(1024))) {
+            for (i=0;i<MAXEXFILE;i++) free(paths[i]);
+            return -1;
+        }
+    }
+    cf.format=format;
+    cf.opt=opt;
+    cf.ifile=paths;
+    cf.nf=expath(ifile,paths,MAXEXFILE);
+    cf.file=file;
+    cf.dir=dir;
+    initlock(&cf.lock);
+    
+    nt=opt->nthread<1?1:(opt->nthread<MAXTHREAD?opt->nthread:MAXTHREAD);
+    
+    for (n=0;n<nt&&n<cf.nf;n++) {
+#ifdef WIN32
+        if (!(thread[n]=CreateThread(NULL,0,convfthread,&cf,0,NULL))) break;
+#else
+        if (pthread_create(thread+n,NULL,convfthread,&cf)) break;
+#endif
+    }
+    for (i=0;i<n;i++) {
+#ifdef WIN32
+        WaitForSingleObject(thread[i],INFINITE);
+        CloseHandle(thread[i]);
+#else
+        pthread_join(thread[i],NULL);
+#endif
+    }
+    for (i=0;i<MAXEXFILE;i++) free(paths[i]);
+    
+    if (n<=0&&cf.nf>0) {
+        fprintf(stderr,"thread create error\n");
+        return -1;
+    }
+    return cf.stat;
+}
 /* set signal mask -----------------------------------------------------------*/
 static void setmask(const char *argv, rnxopt_t *opt, int mask)
 {
@@ -333,7 +455,7 @@ static void setmask(const char *argv, rnxopt_t *opt, int mask)
 }
 /* parse command line options ------------------------------------------------*/
 static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
-                   char **ofile, char **dir, int *trace)
+                   char **ofile, char **dir, int *trace, int *sepfile)
 {
     double eps[]={1980,1,1,0,0,0},epe[]={2037,12,31,0,0,0};
     double epr[]={2010,1,1,0,0,0},span=0.0;
@@ -447,6 +569,21 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
         else if (!strcmp(argv[i],"-noscan")) {
             opt->scanobs=0;
         }
+        else if (!strcmp(argv[i],"-scan1")) {
+            opt->scanobs=2;
+        }
+        else if (!strcmp(argv[i],"-j" )&&i+1<argc) {
+            opt->nthread=atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"-sf")) {
+            *sepfile=1;
+        }
+        else if (!strcmp(argv[i],"-crx")) {
+            opt->crinex=1;
+        }
+        else if (!strcmp(argv[i],"-gz")) {
+            opt->gzip=1;
+        }
         else if (!strcmp(argv[i],"-halfc")) {
             opt->halfcyc=1;
         }
@@ -547,11 +684,16 @@ static int cmdopts(int argc, char **argv, rnxopt_t *opt, char **ifile,
 int main(int argc, char **argv)
 {
     rnxopt_t opt={{0}};
-    int format,trace=0,stat;
+    int format,trace=0,sepfile=0,stat;
     char *ifile="",*ofile[NOUTFILE]={0},*dir="";
     
+#ifdef WIN32
+    mainthread=GetCurrentThreadId();
+#else
+    mainthread=pthread_self();
+#endif
     /* parse command line options */
-    format=cmdopts(argc,argv,&opt,&ifile,ofile,&dir,&trace);
+    format=cmdopts(argc,argv,&opt,&ifile,ofile,&dir,&trace,&sepfile);
     
     if (!*ifile) {
         fprintf(stderr,"no input file\n");
@@ -572,7 +714,12 @@ int main(int argc, char **argv)
         traceopen(TRACEFILE);
         tracelevel(trace);
     }
-    stat=convbin(format,&opt,ifile,ofile,dir);
+    if (sepfile) {
+        stat=convbin_f(format,&opt,ifile,ofile,dir);
+    }
+    else {
+        stat=convbin(format,&opt,ifile,ofile,dir);
+    }
     
     traceclose();
     
@@ -16,6 +16,7 @@
 *           2015/05/15  1.8 -r or -l options for fixed or ppp-fixed mode
 *           2015/06/12  1.9 output patch level in header
 *           2016/09/07  1.10 add option -sys
+*           2026/10/17  1.11 add option -bat
 *-----------------------------------------------------------------------------*/
 #include <stdarg.h>
 #include "rtklib.h"
@@ -55,6 +56,7 @@ static const char *help[]={
 " -v thres  validation threshold for integer ambiguity (0.0:no AR) [3.0]",
 " -b        backward solutions [off]",
 " -c        forward/backward combined solutions [off]",
+" -bat      batch static solution for static mode [off]",
 " -i        instantaneous integer ambiguity resolution [off]",
 " -h        fix and hold for integer ambiguity resolution [off]",
 " -e        output x/y/z-ecef position [latitude/longitude/height]",
@@ -152,6 +154,7 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i],"-d")&&i+1<argc) solopt.timeu=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-b")) prcopt.soltype=1;
         else if (!strcmp(argv[i],"-c")) prcopt.soltype=2;
+        else if (!strcmp(argv[i],"-bat")) prcopt.soltype=3;
         else if (!strcmp(argv[i],"-i")) prcopt.modear=2;
         else if (!strcmp(argv[i],"-h")) prcopt.modear=3;
         else if (!strcmp(argv[i],"-t")) solopt.timef=1;
@@ -370,6 +370,7 @@ void __fastcall TMonitorDialog::ShowRtk(void)
 	AnsiString freq[]={"-","L1","L1+L2","L1+L2+L5","L1+L2+L5+L6","L1+L2+L5+L6+L7","L1+L2+L5+L6+L7+L8",""};
 	double *del,*off1,*off2,runtime,rt[3]={0},dop[4]={0};
 	double azel[MAXSAT*2],pos[3],vel[3];
+	obs_t *cur;
 	int i,j,k,thread,cycle,state,rtkstat,nsat0,nsat1,prcout,nave;
 	int cputime,nb[3]={0},nmsg[3][10]={{0}},ne;
 	char tstr[64],*ant,id[32],s1[64]="-",s2[64]="-",s3[64]="-";
@@ -385,8 +386,8 @@ void __fastcall TMonitorDialog::ShowRtk(void)
 	cycle=rtksvr.cycle;
 	state=rtksvr.state;
 	rtkstat=rtksvr.rtk.sol.stat;
-	nsat0=rtksvr.obs[0][0].n;
-	nsat1=rtksvr.obs[1][0].n;
+	nsat0=(cur=rtksvrobs(&rtksvr,0))?cur->n:0;
+	nsat1=(cur=rtksvrobs(&rtksvr,1))?cur->n:0;
 	cputime=rtksvr.cputime;
 	prcout =rtksvr.prcout;
 	nave=rtksvr.nave;
@@ -978,15 +979,14 @@ void __fastcall TMonitorDialog::ShowObs(void)
 {
 	AnsiString s;
 	obsd_t obs[MAXOBS*2];
+	obs_t *cur;
 	char tstr[64],id[32],*code;
 	int i,j,k,n=0,nex=ObsMode?NEXOBS:0;
 	
 	rtksvrlock(&rtksvr);
-	for (i=0;i<rtksvr.obs[0][0].n&&n<MAXOBS*2;i++) {
-		obs[n++]=rtksvr.obs[0][0].data[i];
-	}
-	for (i=0;i<rtksvr.obs[1][0].n&&n<MAXOBS*2;i++) {
-		obs[n++]=rtksvr.obs[1][0].data[i];
+	for (k=0;k<2;k++) {
+		if (!(cur=rtksvrobs(&rtksvr,k))) continue;
+		for (i=0;i<cur->n&&n<MAXOBS*2;i++) obs[n++]=cur->data[i];
 	}
 	rtksvrunlock(&rtksvr);
 	
@@ -1537,7 +1537,7 @@ void __fastcall TMonitorDialog::SetSbsLong(void)
 void __fastcall TMonitorDialog::ShowSbsLong(void)
 {
 	AnsiString s;
-	sbssat_t sbssat;
+	sbssat_t sbssat={0};
 	sbssatp_t *satp;
 	gtime_t time;
 	int i,j,valid;
@@ -1545,7 +1545,7 @@ void __fastcall TMonitorDialog::ShowSbsLong(void)
 	
 	rtksvrlock(&rtksvr); // lock
 	time=rtksvr.rtk.sol.time;
-	sbssat=rtksvr.nav.sbssat;
+	if (rtksvr.nav.sbssat) sbssat=*rtksvr.nav.sbssat;
 	rtksvrunlock(&rtksvr); // unlock
 	
 	Label->Caption="";
@@ -1593,12 +1593,12 @@ void __fastcall TMonitorDialog::SetSbsIono(void)
 void __fastcall TMonitorDialog::ShowSbsIono(void)
 {
 	AnsiString s,s0="-";
-	sbsion_t sbsion[MAXBAND+1],*ion;
+	sbsion_t sbsion[MAXBAND+1]={0},*ion;
 	char tstr[64];
 	int i,j,k,n=0;
 	
 	rtksvrlock(&rtksvr); // lock
-	for (i=0;i<=MAXBAND;i++) sbsion[i]=rtksvr.nav.sbsion[i];
+	for (i=0;i<=MAXBAND&&rtksvr.nav.sbsion;i++) sbsion[i]=rtksvr.nav.sbsion[i];
 	rtksvrunlock(&rtksvr); // unlock
 	
 	Label->Caption="";
@@ -1639,7 +1639,7 @@ void __fastcall TMonitorDialog::SetSbsFast(void)
 void __fastcall TMonitorDialog::ShowSbsFast(void)
 {
 	AnsiString s,s0="-";
-	sbssat_t sbssat;
+	sbssat_t sbssat={0};
 	sbssatp_t *satp;
 	gtime_t time;
 	int i,j,valid;
@@ -1647,7 +1647,7 @@ void __fastcall TMonitorDialog::ShowSbsFast(void)
 	
 	rtksvrlock(&rtksvr); // lock
 	time=rtksvr.rtk.sol.time;
-	sbssat=rtksvr.nav.sbssat;
+	if (rtksvr.nav.sbssat) sbssat=*rtksvr.nav.sbssat;
 	rtksvrunlock(&rtksvr); // unlock
 	
 	Label->Caption="";
@@ -1821,13 +1821,13 @@ void __fastcall TMonitorDialog::ShowRtcmDgps(void)
 {
 	AnsiString s;
 	gtime_t time;
-	dgps_t dgps[MAXSAT];
+	dgps_t dgps[MAXSAT]={0};
 	int i,j,valid;
 	char tstr[64],id[32];
 	
 	rtksvrlock(&rtksvr);
 	time=rtksvr.rtk.sol.time;
-	for (i=0;i<MAXSAT;i++) dgps[i]=rtksvr.nav.dgps[i];
+	for (i=0;i<MAXSAT&&rtksvr.nav.dgps;i++) dgps[i]=rtksvr.nav.dgps[i];
 	rtksvrunlock(&rtksvr);
 	
 	Label->Caption="";
@@ -1874,7 +1874,7 @@ void __fastcall TMonitorDialog::ShowRtcmSsr(void)
 {
 	AnsiString s;
 	gtime_t time;
-	ssr_t ssr[MAXSAT];
+	ssr_t ssr[MAXSAT]={0};
 	int i,j,k,valid;
 	char tstr[64],id[32],buff[256]="",*p;
 
@@ -1882,9 +1882,9 @@ void __fastcall TMonitorDialog::ShowRtcmSsr(void)
 	time=rtksvr.rtk.sol.time;
 	for (i=0;i<MAXSAT;i++) {
 		if (SelStr->ItemIndex<3) {
-			ssr[i]=rtksvr.rtcm[SelStr->ItemIndex].ssr[i];
+			if (rtksvr.rtcm[SelStr->ItemIndex].ssr) ssr[i]=rtksvr.rtcm[SelStr->ItemIndex].ssr[i];
 		}
-		else ssr[i]=rtksvr.nav.ssr[i];
+		else if (rtksvr.nav.ssr) ssr[i]=rtksvr.nav.ssr[i];
 	}
 	rtksvrunlock(&rtksvr);
 
@@ -2025,13 +2025,13 @@ void __fastcall TMonitorDialog::ShowLexEph(void)
 {
 	AnsiString s;
 	gtime_t time;
-	lexeph_t lexeph[MAXSAT];
+	lexeph_t lexeph[MAXSAT]={0};
 	int i,j,k,n,sys,valid;
 	char tstr[64],health[16],id[32],*p;
 
 	rtksvrlock(&rtksvr);
 	time=rtksvr.rtk.sol.time;
-	for (i=0;i<MAXSAT;i++) lexeph[i]=rtksvr.nav.lexeph[i];
+	for (i=0;i<MAXSAT&&rtksvr.nav.lexeph;i++) lexeph[i]=rtksvr.nav.lexeph[i];
 	rtksvrunlock(&rtksvr);
 	
 	Label->Caption="";
@@ -2170,6 +2170,7 @@ void __fastcall TMonitorDialog::ShowIonCorr(void)
 	AnsiString s;
 	gtime_t time;
 	nav_t nav={0};
+	sbsion_t sbsion[MAXBAND+1];
 	double lat,lon,pos[3]={0},ion,var,azel[]={0.0,PI/2.0};
 	int i,j,ionoopt;
 	
@@ -2178,7 +2179,8 @@ void __fastcall TMonitorDialog::ShowIonCorr(void)
 	for (i=0;i<8;i++) nav.ion_gps[i]=rtksvr.nav.ion_gps[i];
 	for (i=0;i<4;i++) nav.ion_gal[i]=rtksvr.nav.ion_gal[i];
 	for (i=0;i<8;i++) nav.ion_qzs[i]=rtksvr.nav.ion_qzs[i];
-	for (i=0;i<MAXBAND+1;i++) nav.sbsion[i]=rtksvr.nav.sbsion[i];
+	for (i=0;i<MAXBAND+1&&rtksvr.nav.sbsion;i++) sbsion[i]=rtksvr.nav.sbsion[i];
+	if (rtksvr.nav.sbsion) nav.sbsion=sbsion;
 	nav.lexion=rtksvr.nav.lexion;
 	rtksvrunlock(&rtksvr);
 	
@@ -1215,7 +1215,7 @@ void __fastcall TMainForm::SvrStart(void)
         for (i=0;i<3;i++) PrcOpt.antdel[1][i]=RefAntDel[i];
     }
     if (RovAntPcvF||RefAntPcvF) {
-        free(pcvr.pcv);
+        freepcv(&pcvr);
     }
     if (PrcOpt.sateph==EPHOPT_PREC||PrcOpt.sateph==EPHOPT_SSRCOM) {
         if (!readpcv(SatPcvFileF.c_str(),&pcvs)) {
@@ -1223,11 +1223,11 @@ void __fastcall TMainForm::SvrStart(void)
             Message->Parent->Hint=Message->Caption;
             return;
         }
-        for (i=0;i<MAXSAT;i++) {
+        for (i=0;i<MAXSAT&&allocnav(&rtksvr.nav,0x100);i++) {
             if (!(pcv=searchpcv(i+1,"",time,&pcvs))) continue;
             rtksvr.nav.pcvs[i]=*pcv;
         }
-        free(pcvs.pcv);
+        freepcv(&pcvs);
     }
     if (BaselineC) {
         PrcOpt.baseline[0]=Baseline[0];
@@ -1227,7 +1227,7 @@ void __fastcall TOptDialog::ReadAntList(void)
 	RovAnt->Items=list;
 	RefAnt->Items=list;
 	
-	free(pcvs.pcv);
+	freepcv(&pcvs);
 }
 //---------------------------------------------------------------------------
 void __fastcall TOptDialog::NavSys6Click(TObject *Sender)
@@ -359,6 +359,7 @@ void MonitorDialog::ShowRtk(void)
     QString freq[]={tr("-"),tr("L1"),tr("L1+L2"),tr("L1+L2+L5"),tr("L1+L2+L5+L6"),tr("L1+L2+L5+L6+L7"),tr("L1+L2+L5+L6+L7+L8"),""};
     double *del,*off1,*off2,rt[3]={0},dop[4]={0};
 	double azel[MAXSAT*2],pos[3],vel[3];
+	obs_t *cur;
     int i,j,k,cycle,state,rtkstat,nsat0,nsat1,prcout,nave;
     unsigned long thread;
 	int cputime,nb[3]={0},nmsg[3][10]={{0}},ne;
@@ -375,8 +376,8 @@ void MonitorDialog::ShowRtk(void)
 	cycle=rtksvr.cycle;
 	state=rtksvr.state;
 	rtkstat=rtksvr.rtk.sol.stat;
-	nsat0=rtksvr.obs[0][0].n;
-	nsat1=rtksvr.obs[1][0].n;
+	nsat0=(cur=rtksvrobs(&rtksvr,0))?cur->n:0;
+	nsat1=(cur=rtksvrobs(&rtksvr,1))?cur->n:0;
 	cputime=rtksvr.cputime;
 	prcout =rtksvr.prcout;
     nave=rtksvr.nave;
@@ -964,15 +965,14 @@ void MonitorDialog::SetObs(void)
 void MonitorDialog::ShowObs(void)
 {
 	obsd_t obs[MAXOBS*2];
+	obs_t *cur;
 	char tstr[64],id[32],*code;
     int i,k,n=0,nex=ObsMode?NEXOBS:0;
 	
 	rtksvrlock(&rtksvr);
-	for (i=0;i<rtksvr.obs[0][0].n&&n<MAXOBS*2;i++) {
-		obs[n++]=rtksvr.obs[0][0].data[i];
-	}
-	for (i=0;i<rtksvr.obs[1][0].n&&n<MAXOBS*2;i++) {
-		obs[n++]=rtksvr.obs[1][0].data[i];
+	for (k=0;k<2;k++) {
+		if (!(cur=rtksvrobs(&rtksvr,k))) continue;
+		for (i=0;i<cur->n&&n<MAXOBS*2;i++) obs[n++]=cur->data[i];
 	}
 	rtksvrunlock(&rtksvr);
 
@@ -1531,14 +1531,14 @@ void MonitorDialog::SetSbsLong(void)
 //---------------------------------------------------------------------------
 void MonitorDialog::ShowSbsLong(void)
 {
-	sbssat_t sbssat;
+	sbssat_t sbssat={0};
 	gtime_t time;
     int i;
 	char tstr[64],id[32];
 	
 	rtksvrlock(&rtksvr); // lock
 	time=rtksvr.rtk.sol.time;
-	sbssat=rtksvr.nav.sbssat;
+	if (rtksvr.nav.sbssat) sbssat=*rtksvr.nav.sbssat;
 	rtksvrunlock(&rtksvr); // unlock
 	
     Console->setRowCount(sbssat.nsat<=0?2:sbssat.nsat);
@@ -1587,12 +1587,12 @@ void MonitorDialog::SetSbsIono(void)
 void MonitorDialog::ShowSbsIono(void)
 {
     QString s0="-";
-    sbsion_t sbsion[MAXBAND+1];
+    sbsion_t sbsion[MAXBAND+1]={0};
 	char tstr[64];
 	int i,j,k,n=0;
 	
 	rtksvrlock(&rtksvr); // lock
-    for (i=0;i<=MAXBAND;i++) {sbsion[i]=rtksvr.nav.sbsion[i];n+=sbsion[i].nigp;};
+    for (i=0;i<=MAXBAND&&rtksvr.nav.sbsion;i++) {sbsion[i]=rtksvr.nav.sbsion[i];n+=sbsion[i].nigp;};
 	rtksvrunlock(&rtksvr); // unlock
 	
     Console->setRowCount(n);
@@ -1637,14 +1637,14 @@ void MonitorDialog::SetSbsFast(void)
 void MonitorDialog::ShowSbsFast(void)
 {
     QString s0="-";
-	sbssat_t sbssat;
+	sbssat_t sbssat={0};
 	gtime_t time;
     int i;
 	char tstr[64],id[32];
 	
 	rtksvrlock(&rtksvr); // lock
 	time=rtksvr.rtk.sol.time;
-	sbssat=rtksvr.nav.sbssat;
+	if (rtksvr.nav.sbssat) sbssat=*rtksvr.nav.sbssat;
 	rtksvrunlock(&rtksvr); // unlock
 	
     Label->setText("");
@@ -1819,13 +1819,13 @@ void MonitorDialog::SetRtcmDgps(void)
 void MonitorDialog::ShowRtcmDgps(void)
 {
 	gtime_t time;
-	dgps_t dgps[MAXSAT];
+	dgps_t dgps[MAXSAT]={0};
     int i;
 	char tstr[64],id[32];
 	
 	rtksvrlock(&rtksvr);
 	time=rtksvr.rtk.sol.time;
-	for (i=0;i<MAXSAT;i++) dgps[i]=rtksvr.nav.dgps[i];
+	for (i=0;i<MAXSAT&&rtksvr.nav.dgps;i++) dgps[i]=rtksvr.nav.dgps[i];
 	rtksvrunlock(&rtksvr);
 	
     Label->setText("");
@@ -1872,7 +1872,7 @@ void MonitorDialog::SetRtcmSsr(void)
 void MonitorDialog::ShowRtcmSsr(void)
 {
 	gtime_t time;
-	ssr_t ssr[MAXSAT];
+	ssr_t ssr[MAXSAT]={0};
     int i,k;
 	char tstr[64],id[32];
 
@@ -1880,9 +1880,9 @@ void MonitorDialog::ShowRtcmSsr(void)
 	time=rtksvr.rtk.sol.time;
 	for (i=0;i<MAXSAT;i++) {
         if (SelStr->currentIndex()<3) {
-            ssr[i]=rtksvr.rtcm[SelStr->currentIndex()].ssr[i];
+            if (rtksvr.rtcm[SelStr->currentIndex()].ssr) ssr[i]=rtksvr.rtcm[SelStr->currentIndex()].ssr[i];
 		}
-		else ssr[i]=rtksvr.nav.ssr[i];
+		else if (rtksvr.nav.ssr) ssr[i]=rtksvr.nav.ssr[i];
 	}
 	rtksvrunlock(&rtksvr);
 
@@ -2011,13 +2011,13 @@ void MonitorDialog::SetLexEph(void)
 void MonitorDialog::ShowLexEph(void)
 {
 	gtime_t time;
-	lexeph_t lexeph[MAXSAT];
+	lexeph_t lexeph[MAXSAT]={0};
     int i,j,k,n,valid;
     char tstr[64],health[16],id[32],*p;
 
 	rtksvrlock(&rtksvr);
 	time=rtksvr.rtk.sol.time;
-	for (i=0;i<MAXSAT;i++) lexeph[i]=rtksvr.nav.lexeph[i];
+	for (i=0;i<MAXSAT&&rtksvr.nav.lexeph;i++) lexeph[i]=rtksvr.nav.lexeph[i];
 	rtksvrunlock(&rtksvr);
 	
     Label->setText("");
@@ -2158,6 +2158,7 @@ void MonitorDialog::ShowIonCorr(void)
 {
 	gtime_t time;
     nav_t nav;
+    sbsion_t sbsion[MAXBAND+1];
     double pos[3]={0,0,0},ion,var,azel[]={0.0,PI/2.0};
 	int i,j,ionoopt;
 	
@@ -2168,7 +2169,8 @@ void MonitorDialog::ShowIonCorr(void)
 	for (i=0;i<8;i++) nav.ion_gps[i]=rtksvr.nav.ion_gps[i];
 	for (i=0;i<4;i++) nav.ion_gal[i]=rtksvr.nav.ion_gal[i];
 	for (i=0;i<8;i++) nav.ion_qzs[i]=rtksvr.nav.ion_qzs[i];
-	for (i=0;i<MAXBAND+1;i++) nav.sbsion[i]=rtksvr.nav.sbsion[i];
+	for (i=0;i<MAXBAND+1&&rtksvr.nav.sbsion;i++) sbsion[i]=rtksvr.nav.sbsion[i];
+	if (rtksvr.nav.sbsion) nav.sbsion=sbsion;
 	nav.lexion=rtksvr.nav.lexion;
 	rtksvrunlock(&rtksvr);
 	
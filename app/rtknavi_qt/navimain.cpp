@@ -1008,18 +1008,18 @@ void  MainWindow::SvrStart(void)
         for (i=0;i<3;i++) PrcOpt.antdel[1][i]=RefAntDel[i];
     }
     if (RovAntPcvF||RefAntPcvF) {
-        free(pcvr.pcv);
+        freepcv(&pcvr);
     }
     if (PrcOpt.sateph==EPHOPT_PREC||PrcOpt.sateph==EPHOPT_SSRCOM) {
         if (!readpcv(qPrintable(SatPcvFileF),&pcvs)) {
             Message->setText(QString(tr("sat ant file read error %1")).arg(SatPcvFileF));
             return;
         }
-        for (i=0;i<MAXSAT;i++) {
+        for (i=0;i<MAXSAT&&allocnav(&rtksvr.nav,0x100);i++) {
             if (!(pcv=searchpcv(i+1,"",time,&pcvs))) continue;
             rtksvr.nav.pcvs[i]=*pcv;
         }
-        free(pcvs.pcv);
+        freepcv(&pcvs);
     }
     if (BaselineC) {
         PrcOpt.baseline[0]=Baseline[0];
@@ -1157,7 +1157,7 @@ void OptDialog::ReadAntList(void)
 {
     QString AntPcvFile_Text=AntPcvFile->text();
     QStringList list;
-    pcvs_t pcvs={0,0,NULL};
+    pcvs_t pcvs={0,0,NULL,NULL};
 	char *p;
 	
     if (!readpcv(qPrintable(AntPcvFile_Text),&pcvs)) return;
@@ -1176,7 +1176,7 @@ void OptDialog::ReadAntList(void)
     RovAnt->addItems(list);
     RefAnt->addItems(list);
 	
-	free(pcvs.pcv);
+	freepcv(&pcvs);
 }
 //---------------------------------------------------------------------------
 
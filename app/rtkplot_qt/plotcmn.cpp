@@ -206,6 +206,102 @@ TIMEPOS * Plot::SolToNsat(solbuf_t *sol, int index, int qflag)
     }
     return ns;
 }
+// get solution points with level-of-detail index ---------------------------
+//   sel=0:solution 1,1:solution 2,2:solution 1-2, type=0-2:SolToPos(),3:nsat
+//   the points are cached until the solutions, the origin or the time
+//   settings are changed. the returned points are owned by the cache.
+SOLLOD * Plot::SolToLod(int sel, int qflag, int type)
+{
+    SOLLOD key,*lod;
+    TIMEPOS *pos1,*pos2;
+    sol_t *data;
+    const double *y[3];
+    int i,j;
+    
+    trace(3,"SolToLod: sel=%d qflag=%d type=%d\n",sel,qflag,type);
+    
+    key.sel=sel; key.qflag=qflag; key.type=type; key.gen=SolGen;
+    key.week=Week; key.tlabel=TimeLabel;
+    key.tint=TimeEna[2]?TimeInt:0.0;
+    key.oepoch=OEpoch;
+    for (i=0;i<3;i++) {
+        key.opos[i]=OPos[i];
+        key.ovel[i]=OVel[i];
+    }
+    for (i=0;i<2;i++) {
+        key.n[i]=SolData[i].n;
+        key.ts[i]=key.te[i]=OEpoch;
+        if ((data=getsol(SolData+i,0))) key.ts[i]=data->time;
+        if ((data=getsol(SolData+i,SolData[i].n-1))) key.te[i]=data->time;
+    }
+    for (i=0;i<MAXSOLLOD;i++) {
+        if (!(lod=SolLod[i])) continue;
+        if (lod->sel!=key.sel||lod->qflag!=key.qflag||lod->type!=key.type||
+            lod->gen!=key.gen||lod->week!=key.week||lod->tlabel!=key.tlabel||
+            lod->tint!=key.tint||timediff(lod->oepoch,key.oepoch)!=0.0) continue;
+        for (j=0;j<3;j++) {
+            if (lod->opos[j]!=key.opos[j]||lod->ovel[j]!=key.ovel[j]) break;
+        }
+        if (j<3) continue;
+        for (j=0;j<2;j++) {
+            if (lod->n[j]!=key.n[j]||timediff(lod->ts[j],key.ts[j])!=0.0||
+                timediff(lod->te[j],key.te[j])!=0.0) break;
+        }
+        if (j>=2) return lod;
+    }
+    lod=new SOLLOD;
+    lod->sel=sel; lod->qflag=qflag; lod->type=type; lod->gen=key.gen;
+    lod->week=key.week; lod->tlabel=key.tlabel; lod->tint=key.tint;
+    lod->oepoch=key.oepoch;
+    for (i=0;i<3;i++) {
+        lod->opos[i]=key.opos[i];
+        lod->ovel[i]=key.ovel[i];
+    }
+    for (i=0;i<2;i++) {
+        lod->n[i]=key.n[i];
+        lod->ts[i]=key.ts[i];
+        lod->te[i]=key.te[i];
+    }
+    if (type==3) {
+        lod->pos=SolToNsat(SolData+sel,-1,qflag);
+    }
+    else if (sel<2) {
+        lod->pos=SolToPos(SolData+sel,-1,qflag,type);
+    }
+    else {
+        pos1=SolToPos(SolData  ,-1,0,type);
+        pos2=SolToPos(SolData+1,-1,0,type);
+        lod->pos=pos1->diff(pos2,qflag);
+        delete pos1;
+        delete pos2;
+    }
+    lod->tp=new double [lod->pos->n>0?lod->pos->n:1];
+    for (i=0;i<lod->pos->n;i++) {
+        lod->tp[i]=TimePos(lod->pos->t[i]);
+    }
+    y[0]=lod->pos->x; y[1]=lod->pos->y; y[2]=lod->pos->z;
+    lod->ser.Build(lod->tp,y,3,lod->pos->q,lod->pos->n);
+    if (type==0) {
+        lod->trk.Build(lod->pos->x,lod->pos->y,lod->pos->q,lod->pos->n);
+    }
+    delete SolLod[SolLodNext];
+    SolLod[SolLodNext]=lod;
+    SolLodNext=(SolLodNext+1)%MAXSOLLOD;
+    return lod;
+}
+// clear cached solution points ---------------------------------------------
+void Plot::ClearSolLod(void)
+{
+    int i;
+    
+    trace(3,"ClearSolLod\n");
+    
+    for (i=0;i<MAXSOLLOD;i++) {
+        delete SolLod[i];
+        SolLod[i]=NULL;
+    }
+    SolGen++;
+}
 // transform solution to xyz-terms ------------------------------------------
 void Plot::PosToXyz(gtime_t time, const double *rr, int type,
                                 double *xyz)
@@ -571,3 +667,22 @@ TIMEPOS *TIMEPOS::diff(const TIMEPOS *pos2, int qflag)
     return pos;
 }
 //---------------------------------------------------------------------------
+// solution points with level-of-detail index ---------------------------------
+SOLLOD::SOLLOD()
+{
+    gtime_t t0={0,0};
+    
+    sel=qflag=type=gen=week=tlabel=0;
+    n[0]=n[1]=0;
+    ts[0]=ts[1]=te[0]=te[1]=oepoch=t0;
+    tint=0.0;
+    for (int i=0;i<3;i++) opos[i]=ovel[i]=0.0;
+    pos=NULL;
+    tp=NULL;
+}
+SOLLOD::~SOLLOD()
+{
+    delete pos;
+    delete [] tp;
+}
+//---------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 
 #include "rtklib.h"
 #include "plotmain.h"
+#include "plotload.h"
 #include "mapdlg.h"
 #include "pntdlg.h"
 #include "geview.h"
@@ -21,8 +22,6 @@
 #define MAX_SIMOBS	16384			// max genrated obs epochs
 #define MAX_SKYIMG_R 2048			// max size of resampled sky image
 
-#define THRES_SLIP  2.0             // threshold of cycle-slip
-
 
 static char path_str[MAXNFILE][1024];
 static const char *XMLNS="http://www.topografix.com/GPX/1/1";
@@ -64,6 +63,7 @@ void Plot::ReadSol(const QStringList &files, int sel)
     }
     freesolbuf(SolData+sel);
     SolData[sel]=sol;
+    ClearSolLod();
     
     if (SolFiles[sel]!=files) {
         SolFiles[sel]=files;
@@ -138,180 +138,29 @@ void Plot::ReadSolStat(const QStringList &files, int sel)
 // read observation data ----------------------------------------------------
 void Plot::ReadObs(const QStringList &files)
 {
-    obs_t obs={0,0,NULL};
-    nav_t nav;
-    sta_t sta;
-    int nobs;
-    
     trace(3,"ReadObs\n");
     
-    setlocale(LC_NUMERIC,"C"); // use point as decimal separator in formated output
-
-    memset(&nav,0,sizeof(nav_t));
-    memset(&sta,0,sizeof(sta_t));
-
     if (files.size()==0) return;
     
-    ReadWaitStart();
     ShowLegend(NULL);
     
-    if ((nobs=ReadObsRnx(files,&obs,&nav,&sta))<=0) {
-        ReadWaitEnd();
-        return;
-    }
-    ClearObs();
-
-    Obs=obs;
-    Nav=nav;
-    Sta=sta;
-    SimObs=0;
-
-    UpdateObs(nobs);
-    UpdateMp();
-    
-    if (ObsFiles!=files) {
-        ObsFiles=files;
-    }
-    NavFiles.clear();
-    
-    setWindowTitle(files.at(0) + (files.size()>1?"...":""));
-    
-    BtnSol1->setChecked(true);
-
-    time2gpst(Obs.data[0].time,&Week);
-    SolIndex[0]=SolIndex[1]=ObsIndex=0;
-    
-    if (PlotType<PLOT_OBS||PLOT_DOP<PlotType) {
-        UpdateType(PLOT_OBS);
-    }
-    else {
-        UpdatePlotType();
-    }
-    FitTime();
-    
-    ReadWaitEnd();
-    UpdateObsType();
-    UpdateTime();
-    UpdatePlot();
-    UpdateEnable();
-}
-// read observation data rinex ----------------------------------------------
-int Plot::ReadObsRnx(const QStringList &files, obs_t *obs, nav_t *nav,
-                                 sta_t *sta)
-{
-    gtime_t ts,te;
-    double tint;
-    int i,n;
-    char obsfile[1024],navfile[1024]="",*p,*q,opt[2048];
-    strcpy(opt,qPrintable(RnxOpts));
-    
-    trace(3,"ReadObsRnx\n");
-    
-    setlocale(LC_NUMERIC,"C"); // use point as decimal separator in formated output
-
-    TimeSpan(&ts,&te,&tint);
-    
-    for (i=0;i<files.count();i++) {
-        strcpy(obsfile,qPrintable(QDir::toNativeSeparators(files.at(i))));
-        
-        ShowMsg(QString(tr("reading obs data... %1")).arg(obsfile));
-        qApp->processEvents();
-
-        if (readrnxt(obsfile,1,ts,te,tint,opt,obs,nav,sta)<0) {
-            ShowMsg(tr("error: insufficient memory"));
-            return -1;
-        }
-    }
-    ShowMsg(tr("reading nav data..."));
-    qApp->processEvents();
-
-    for (i=0;i<files.count();i++) {
-        strcpy(navfile,qPrintable(QDir::toNativeSeparators(files.at(i))));
-        
-        if (!(p=strrchr(navfile,'.'))) continue;
-        
-        if (!strcmp(p,".obs")||!strcmp(p,".OBS")) {
-            strcpy(p,".nav" ); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p,".gnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p,".hnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p,".qnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p,".lnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-        }
-        else if (!strcmp(p+3,"o" )||!strcmp(p+3,"d" )||
-                 !strcmp(p+3,"O" )||!strcmp(p+3,"D" )) {
-            n=nav->n;
-            
-            strcpy(p+3,"N"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p+3,"G"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p+3,"H"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p+3,"Q"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p+3,"L"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            strcpy(p+3,"P"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-            
-            if (nav->n>n||!(q=strrchr(navfile,'\\'))) continue;
-            
-            // read brdc navigation data
-            memcpy(q+1,"BRDC",4);
-            strcpy(p+3,"N"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
-        }
-    }
-    if (obs->n<=0) {
-        ShowMsg(QString(tr("no observation data: %1...")).arg(files.at(0)));
-        qApp->processEvents();
-        freenav(nav,0xFF);
-        return 0;
-    }
-    uniqnav(nav);
-    return sortobs(obs);
+    StartLoad(files,QStringList());
 }
 // read navigation data -----------------------------------------------------
 void Plot::ReadNav(const QStringList &files)
 {
-    gtime_t ts,te;
-    double tint;
-    char navfile[1024],opt[2048];
-    int i;
-    strcpy(opt,qPrintable(RnxOpts));
-
     trace(3,"ReadNav\n");
     
     if (files.size()<=0) return;
     
-    setlocale(LC_NUMERIC,"C"); // use point as decimal separator in formated output
-
-    ReadWaitStart();
-    ShowLegend(NULL);
-    
-    TimeSpan(&ts,&te,&tint);
-    
-    freenav(&Nav,0xFF);
-    
-    ShowMsg(tr("reading nav data..."));
-
-    qApp->processEvents();
-    
-    for (i=0;i<files.size();i++) {
-        strcpy(navfile,qPrintable(QDir::toNativeSeparators(files.at(i))));
-        readrnxt(navfile,1,ts,te,tint,opt,NULL,&Nav,NULL);
-    }
-    uniqnav(&Nav);
-    
-    if (Nav.n<=0&&Nav.ng<=0&&Nav.ns<=0) {
-        ShowMsg(QString(tr("no nav message: %1...")).arg(QDir::toNativeSeparators(files.at(i))));
-        ReadWaitEnd();
+    // read after loading obs data (reload)
+    if (Loader->isRunning()&&Loader->ObsFiles.size()>0) {
+        PendingNavFiles=files;
         return;
     }
-    if (NavFiles!=files) {
-        NavFiles=files;
-    }
-    for (i=0;i<NavFiles.size();i++) NavFiles[i]=QDir::toNativeSeparators(NavFiles.at(i));
-
-    UpdateObs(NObs);
-    UpdateMp();
-    ReadWaitEnd();
+    ShowLegend(NULL);
     
-    UpdatePlot();
-    UpdateEnable();
+    StartLoad(QStringList(),files);
 }
 // read elevation mask data -------------------------------------------------
 void Plot::ReadElMaskData(const QString &file)
@@ -1088,83 +937,40 @@ int Plot::CheckObs(const QString &file)
 // update observation data index, azimuth/elevation, satellite list ---------
 void Plot::UpdateObs(int nobs)
 {
-    prcopt_t opt=prcopt_default;
-    gtime_t time;
-    sol_t sol;
-    double pos[3],rr[3],e[3],azel[MAXOBS*2]={0},rs[6],dts[2],var;
-    int i,j,k,svh,per,per_=-1;
-    char msg[128],name[16];
+    azelopt_t opt;
+    int i,e0,e1,nep,per;
     
     trace(3,"UpdateObs\n");
     
-    memset(&sol,0,sizeof(sol_t));
-
     delete [] IndexObs; IndexObs=NULL;
     delete [] Az; Az=NULL;
     delete [] El; El=NULL;
     NObs=0;
     if (nobs<=0) return;
     
-    IndexObs=new int[nobs+1];
+    IndexObs=new int[Obs.n+1];
     Az=new double[Obs.n];
     El=new double[Obs.n];
     
-    opt.err[0]=900.0;
+    opt.rcvpos=RcvPos;
+    for (i=0;i<3;i++) opt.pos[i]=OOPos[i];
+    opt.tle=&TLEData;
     
     ReadWaitStart();
     ShowLegend(NULL);
     
-    for (i=0;i<Obs.n;i=j) {
-        time=Obs.data[i].time;
-        for (j=i;j<Obs.n;j++) {
-            if (timediff(Obs.data[j].time,time)>TTOL) break;
-        }
-        IndexObs[NObs++]=i;
+    NObs=PlotLoader::EpochIndex(&Obs,IndexObs);
+    nep=MAX(NObs/LOAD_NCHUNK,1);
+    
+    // az/el in parallel across epochs
+    for (e0=0;e0<NObs;e0=e1) {
+        e1=MIN(e0+nep,NObs);
+        PlotLoader::CalcAzEl(&Obs,&Nav,&Sta,&opt,IndexObs,e0,e1,Az,El);
         
-        for (k=0;k<j-i;k++) {
-            azel[k*2]=azel[1+k*2]=0.0;
-        }
-        if (RcvPos==0) {
-            pntpos(Obs.data+i,j-i,&Nav,&opt,&sol,azel,NULL,msg);
-            matcpy(rr,sol.rr,3,1);
-            ecef2pos(rr,pos);
-        }
-        else {
-            if (RcvPos==1) { // lat/lon/height
-                for (k=0;k<3;k++) pos[k]=OOPos[k];
-                pos2ecef(pos,rr);
-            }
-            else { // rinex header position
-                for (k=0;k<3;k++) rr[k]=Sta.pos[k];
-                ecef2pos(rr,pos);
-            }
-            for (k=0;k<j-i;k++) {
-                azel[k*2]=azel[1+k*2]=0.0;
-                if (!satpos(time,time,Obs.data[i+k].sat,EPHOPT_BRDC,&Nav,rs,dts,
-                            &var,&svh)) continue;
-                if (geodist(rs,rr,e)>0.0) satazel(pos,e,azel+k*2);
-            }
-        }
-        // satellite azel by tle data
-        for (k=0;k<j-i;k++) {
-            if (azel[k*2]!=0.0||azel[1+k*2]!=0.0) continue;
-            satno2id(Obs.data[i+k].sat,name);
-            if (!tle_pos(time,name,"","",&TLEData,NULL,rs)) continue;
-            if (geodist(rs,rr,e)>0.0) satazel(pos,e,azel+k*2);
-        }
-        for (k=0;k<j-i;k++) {
-            Az[i+k]=azel[  k*2];
-            El[i+k]=azel[1+k*2];
-            if (Az[i+k]<0.0) Az[i+k]+=2.0*PI;
-        }
-        per=(i+1)*100/Obs.n;
-        if (per!=per_) {
-            ShowMsg(QString(tr("updating azimuth/elevation... (%1%)")).arg(per_=per));
-            qApp->processEvents();
-        }
+        per=e1*100/NObs;
+        ShowMsg(QString(tr("updating azimuth/elevation... (%1%)")).arg(per));
+        qApp->processEvents();
     }
-    IndexObs[NObs]=Obs.n;
-    
     UpdateSatList();
     
     ReadWaitEnd();
@@ -1172,9 +978,7 @@ void Plot::UpdateObs(int nobs)
 // update Multipath ------------------------------------------------------------
 void Plot::UpdateMp(void)
 {
-    obsd_t *data;
-    double lam1,lam2,I,C,B;
-    int i,j,k,f1,f2,sat,sys,per,per_=-1,n;
+    int i;
     
     trace(3,"UpdateMp\n");
     
@@ -1188,73 +992,12 @@ void Plot::UpdateMp(void)
     }
     ReadWaitStart();
     ShowLegend(NULL);
+    ShowMsg(tr("updating multipath..."));
+    qApp->processEvents();
+    
+    // multipath in parallel across records and satellites
+    PlotLoader::CalcMp(&Obs,&Nav,Mp);
     
-    for (i=0;i<Obs.n;i++) {
-        data=Obs.data+i;
-        sys=satsys(data->sat,NULL);
-        
-        for (j=0;j<NFREQ+NEXOBS;j++) {
-            Mp[j][i]=0.0;
-            
-            code2obs(data->code[j],&f1);
-            
-            if (sys==SYS_CMP) {
-                if      (f1==5) f1=2; /* B2 */
-                else if (f1==4) f1=3; /* B3 */
-            }
-            if      (sys==SYS_GAL) f2=f1==1?3:1; /* E1/E5a */
-            else if (sys==SYS_SBS) f2=f1==1?3:1; /* L1/L5 */
-            else if (sys==SYS_CMP) f2=f1==1?2:1; /* B1/B2 */
-            else                   f2=f1==1?2:1; /* L1/L2 */
-            
-            lam1=satwavelen(data->sat,f1-1,&Nav);
-            lam2=satwavelen(data->sat,f2-1,&Nav);
-            if (lam1==0.0||lam2==0.0) continue;
-            
-            if (data->P[j]!=0.0&&data->L[j]!=0.0&&data->L[f2-1]!=0.0) {
-                C=SQR(lam1)/(SQR(lam1)-SQR(lam2));
-                I=lam1*data->L[j]-lam2*data->L[f2-1];
-                Mp[j][i]=data->P[j]-lam1*data->L[j]+2.0*C*I;
-            }
-        }
-    }
-    for (sat=1;sat<=MAXSAT;sat++) for (i=0;i<NFREQ+NEXOBS;i++) {
-        sys=satsys(sat,NULL);
-        
-        for (j=k=n=0,B=0.0;j<Obs.n;j++) {
-            if (Obs.data[j].sat!=sat) continue;
-            
-            code2obs(Obs.data[j].code[i],&f1);
-            
-            if (sys==SYS_CMP) {
-                if      (f1==5) f1=2; /* B2 */
-                else if (f1==4) f1=3; /* B3 */
-            }
-            if      (sys==SYS_GAL) f2=f1==1?3:1;
-            else if (sys==SYS_CMP) f2=f1==1?2:1;
-            else                   f2=f1==1?2:1;
-            
-            if ((Obs.data[j].LLI[i]&1)||(Obs.data[j].LLI[f2-1]&1)||
-                fabs(Mp[i][j]-B)>THRES_SLIP) {
-                
-                for (;k<j;k++) if (Obs.data[k].sat==sat) Mp[i][k]-=B;
-                B=Mp[i][j]; n=1; k=j;
-            }
-            else {
-                if (n==0) k=j;
-                B+=(Mp[i][j]-B)/++n;
-            }
-        }
-        if (n>0) {
-            for (;k<j;k++) if (Obs.data[k].sat==sat) Mp[i][k]-=B;
-        }
-        per=sat*100/MAXSAT;
-        if (per!=per_) {
-            ShowMsg(QString(tr("updating multipath... (%1%)")).arg(per));
-            per_=per;
-            qApp->processEvents();
-        }
-    }
     ReadWaitEnd();
 }
 // set connect path ---------------------------------------------------------
@@ -1292,6 +1035,8 @@ void Plot::ClearObs(void)
     
     memset(&sta0,0,sizeof(sta_t));
 
+    StopLoad();
+    
     freeobs(&Obs);
     freenav(&Nav,0xFF);
     delete [] IndexObs; IndexObs=NULL;
@@ -1321,6 +1066,7 @@ void Plot::ClearSol(void)
     SolFiles[0].clear();
     SolFiles[1].clear();
     SolIndex[0]=SolIndex[1]=0;
+    ClearSolLod();
 }
 // clear data ------------------------------------------------------------------
 void Plot::Clear(void)
@@ -1386,6 +1132,156 @@ void Plot::Reload(void)
     ReadSol(SolFiles[1],1);
     
 }
+// start background loading of obs/nav data --------------------------------
+void Plot::StartLoad(const QStringList &obsfiles, const QStringList &navfiles)
+{
+    int i;
+    
+    trace(3,"StartLoad\n");
+    
+    setlocale(LC_NUMERIC,"C"); // use point as decimal separator in formated output
+    
+    StopLoad();
+    
+    Loader->ObsFiles=obsfiles;
+    Loader->NavFiles=navfiles;
+    Loader->RnxOpts=RnxOpts;
+    TimeSpan(&Loader->ts,&Loader->te,&Loader->tint);
+    Loader->opt.rcvpos=RcvPos;
+    for (i=0;i<3;i++) Loader->opt.pos[i]=OOPos[i];
+    Loader->opt.tle=&TLEData;
+    Loader->Job++;
+    
+    if (obsfiles.size()>0) Loader->Start(NULL,NULL,NULL,0);
+    else Loader->Start(&Obs,&Sta,IndexObs,NObs);
+    
+    LoadFiles=obsfiles.size()>0?obsfiles:navfiles;
+    LoadFirst=obsfiles.size()>0;
+    PendingNavFiles.clear();
+    
+    // plot is kept enabled to show partial data
+    MenuFile->setEnabled(false);
+    MenuEdit->setEnabled(false);
+    MenuHelp->setEnabled(false);
+    setCursor(Qt::BusyCursor);
+    
+    Loader->start();
+}
+// stop background loading (data of aborted job discarded) ------------------
+void Plot::StopLoad(void)
+{
+    if (!Loader->isRunning()) return;
+    
+    trace(3,"StopLoad\n");
+    
+    Loader->Abort();
+    Loader->wait();
+    Loader->Job++;
+}
+// callback on loader progress ----------------------------------------------
+void Plot::LoadProgress(const QString &msg)
+{
+    ShowMsg(msg);
+}
+// callback on obs/nav data loaded (partial or final) -----------------------
+void Plot::LoadObsReady(int job, PlotObsData *data)
+{
+    int i,final=data->final,navonly=data->navonly;
+    
+    trace(3,"LoadObsReady: job=%d final=%d navonly=%d\n",job,final,navonly);
+    
+    if (job!=Loader->Job) {
+        delete data;
+        return;
+    }
+    if (!navonly) {
+        freeobs(&Obs);
+        delete [] IndexObs;
+        delete [] Az;
+        delete [] El;
+        Obs=data->obs; memset(&data->obs,0,sizeof(obs_t));
+        Sta=data->sta;
+        IndexObs=data->index; data->index=NULL;
+        NObs=data->nobs;
+        Az=data->az; data->az=NULL;
+        El=data->el; data->el=NULL;
+        for (i=0;i<NFREQ+NEXOBS;i++) {
+            delete [] Mp[i];
+            Mp[i]=data->mp[i]; data->mp[i]=NULL;
+        }
+        SimObs=0;
+    }
+    if (final||LoadFirst) {
+        freenav(&Nav,0xFF);
+        Nav=data->nav; memset(&data->nav,0,sizeof(nav_t));
+    }
+    delete data;
+    
+    if (navonly) {
+        NavFiles=LoadFiles;
+        for (i=0;i<NavFiles.size();i++) NavFiles[i]=QDir::toNativeSeparators(NavFiles.at(i));
+    }
+    else if (LoadFirst) {
+        LoadFirst=0;
+        NavFiles.clear();
+        setWindowTitle(LoadFiles.at(0) + (LoadFiles.size()>1?"...":""));
+        BtnSol1->setChecked(true);
+        time2gpst(Obs.data[0].time,&Week);
+        SolIndex[0]=SolIndex[1]=ObsIndex=0;
+        
+        if (PlotType<PLOT_OBS||PLOT_DOP<PlotType) {
+            UpdateType(PLOT_OBS);
+        }
+        else {
+            UpdatePlotType();
+        }
+    }
+    if (final&&!navonly) ObsFiles=LoadFiles;
+    if (!navonly) FitTime();
+    
+    UpdateSatList();
+    UpdateObsType();
+    UpdateTime();
+    UpdatePlot();
+    UpdateEnable();
+}
+// callback on az/el of records i0 to i1-1 computed -------------------------
+void Plot::LoadAzElReady(int job, int i0, int i1)
+{
+    if (job!=Loader->Job||!Az||!El) return;
+    
+    Loader->CopyAzEl(i0,i1,Az,El);
+    
+    if (i1>=Obs.n) UpdateSatList();
+    UpdatePlot();
+}
+// callback on multipath computed -------------------------------------------
+void Plot::LoadMpReady(int job)
+{
+    if (job!=Loader->Job) return;
+    
+    Loader->TakeMp(Mp);
+    UpdatePlot();
+}
+// callback on loader finished ----------------------------------------------
+void Plot::LoadFinished()
+{
+    QStringList files;
+    
+    trace(3,"LoadFinished\n");
+    
+    if (Loader->isRunning()) return; // restarted
+    
+    ReadWaitEnd();
+    
+    if (PendingNavFiles.size()>0) {
+        files=PendingNavFiles;
+        PendingNavFiles.clear();
+        ReadNav(files);
+        return;
+    }
+    UpdateEnable();
+}
 // read wait start ----------------------------------------------------------
 void Plot::ReadWaitStart(void)
 {
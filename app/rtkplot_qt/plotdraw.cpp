@@ -74,6 +74,7 @@ void Plot::DrawTrk(QPainter &c,int level)
 {
     QString label,header;
     TIMEPOS *pos,*pos1,*pos2,*vel;
+    SOLLOD *lod;
     gtime_t time1={0,0},time2={0,0};
     sol_t *sol;
     QPoint p1,p2;
@@ -124,33 +125,26 @@ void Plot::DrawTrk(QPainter &c,int level)
         header="ORI="+LatLonStr(opos,9)+QString(" %1m").arg(opos[2],0,'f',4);
     }
     if (BtnSol1->isChecked()) {
-        pos=SolToPos(SolData,-1,QFlag->currentIndex(),0);
-        DrawTrkPnt(c,pos,level,0);
+        lod=SolToLod(0,QFlag->currentIndex(),0);
+        DrawTrkPnt(c,lod,level,0);
         if (BtnShowMap->isChecked()) {
             DrawTrkPos(c,SolData[0].rb,0,8,CColor[2],tr("Base Station 1"));
         }
-        DrawTrkStat(c,pos,header,p++);
+        DrawTrkStat(c,lod->pos,header,p++);
         header="";
-        delete pos;
     }
     if (BtnSol2->isChecked()) {
-        pos=SolToPos(SolData+1,-1,QFlag->currentIndex(),0);
-        DrawTrkPnt(c,pos,level,1);
+        lod=SolToLod(1,QFlag->currentIndex(),0);
+        DrawTrkPnt(c,lod,level,1);
         if (BtnShowMap->isChecked()) {
             DrawTrkPos(c,SolData[1].rb,0,8,CColor[2],tr("Base Station 2"));
         }
-        DrawTrkStat(c,pos,header,p++);
-        delete pos;
+        DrawTrkStat(c,lod->pos,header,p++);
     }
     if (BtnSol12->isChecked()) {
-        pos1=SolToPos(SolData  ,-1,0,0);
-        pos2=SolToPos(SolData+1,-1,0,0);
-        pos=pos1->diff(pos2,QFlag->currentIndex());
-        DrawTrkPnt(c,pos,level,0);
-        DrawTrkStat(c,pos,"",p++);
-        delete pos;
-        delete pos1;
-        delete pos2;
+        lod=SolToLod(2,QFlag->currentIndex(),0);
+        DrawTrkPnt(c,lod,level,0);
+        DrawTrkStat(c,lod->pos,"",p++);
     }
     if (BtnShowTrack->isChecked()&&BtnSol1->isChecked()) {
         
@@ -359,29 +353,58 @@ void Plot::DrawTrkMap(QPainter &c,int level)
     }
 }
 // draw track-points on track-plot ------------------------------------------
-void Plot::DrawTrkPnt(QPainter &c,const TIMEPOS *pos, int level, int style)
+//   the polyline and the marks are decimated to the pixel size by the track
+//   grid of the solution points
+void Plot::DrawTrkPnt(QPainter &c,const SOLLOD *lod, int level, int style)
 {
+    const TIMEPOS *pos=lod->pos;
     QVector<QColor> color;
-    int i;
+    std::vector<int> index;
+    double xl[2],yl[2],xs,ys,*x,*y;
+    int i,j,n;
     
     trace(3,"DrawTrkPnt: level=%d style=%d\n",level,style);
     
     if (level) DrawTrkArrow(c,pos);
     
+    GraphT->GetLim(xl,yl);
+    GraphT->GetScale(xs,ys);
+    
     if (level&&PlotStyle<=1&&!BtnShowTrack->isChecked()) { // error circle
-        DrawTrkError(c,pos,style);
+        lod->trk.QueryMarks(xl,yl,MIN(xs,ys),index);
+        DrawTrkError(c,pos,style,&index);
     }
     if (!(PlotStyle%2)) {
-        GraphT->DrawPoly(c,pos->x,pos->y,pos->n,CColor[3],style);
+        lod->trk.QueryLine(xl,yl,MIN(xs,ys),index);
+        x=new double [index.size()+1];
+        y=new double [index.size()+1];
+        for (i=0;i<(int)index.size();i=j+1) {
+            for (j=i,n=0;j<(int)index.size()&&index[j]>=0;j++,n++) {
+                x[n]=pos->x[index[j]];
+                y[n]=pos->y[index[j]];
+            }
+            GraphT->DrawPoly(c,x,y,n,CColor[3],style);
+        }
+        delete [] x;
+        delete [] y;
     }
     if (level&&PlotStyle<2) {
+        n=lod->trk.QueryMarks(xl,yl,MIN(xs,ys),index);
+        x=new double [n+1];
+        y=new double [n+1];
+        for (i=0;i<n;i++) {
+            x[i]=pos->x[index[i]];
+            y[i]=pos->y[index[i]];
+        }
         if (BtnShowImg->isChecked()) {
-            for (i=0;i<pos->n;i++) color.append(CColor[0]);
-            GraphT->DrawMarks(c,pos->x,pos->y,color,pos->n,0,MarkSize+2,0);
+            for (i=0;i<n;i++) color.append(CColor[0]);
+            GraphT->DrawMarks(c,x,y,color,n,0,MarkSize+2,0);
         }
         color.clear();
-        for (i=0;i<pos->n;i++) color.append(MColor[style][pos->q[i]]);
-        GraphT->DrawMarks(c,pos->x,pos->y,color,pos->n,0,MarkSize,0);
+        for (i=0;i<n;i++) color.append(MColor[style][pos->q[index[i]]]);
+        GraphT->DrawMarks(c,x,y,color,n,0,MarkSize,0);
+        delete [] x;
+        delete [] y;
     }
 }
 // draw point with label on track-plot --------------------------------------
@@ -442,7 +465,8 @@ void Plot::DrawTrkStat(QPainter &c,const TIMEPOS *pos, const QString &header, in
     }
 }
 // draw error-circle on track-plot ------------------------------------------
-void Plot::DrawTrkError(QPainter &c,const TIMEPOS *pos, int style)
+void Plot::DrawTrkError(QPainter &c,const TIMEPOS *pos, int style,
+                        const std::vector<int> *index)
 {
     const double sint[36]={
          0.0000, 0.1736, 0.3420, 0.5000, 0.6428, 0.7660, 0.8660, 0.9397, 0.9848,
@@ -451,13 +475,14 @@ void Plot::DrawTrkError(QPainter &c,const TIMEPOS *pos, int style)
         -1.0000,-0.9848,-0.9397,-0.8660,-0.7660,-0.6428,-0.5000,-0.3420,-0.1736
     };
     double xc[37],yc[37],a,b,s,cc;
-    int i,j;
+    int i,j,k,n=index?(int)index->size():pos->n;
     
     trace(3,"DrawTrkError: style=%d\n",style);
     
     if (!ShowErr) return;
     
-    for (i=0;i<pos->n;i++) {
+    for (k=0;k<n;k++) {
+        i=index?(*index)[k]:k;
         if (pos->xs[i]<=0.0||pos->ys[i]<=0.0) continue;
         
         a=pos->xys[i]/SQRT(pos->xs[i]);
@@ -532,6 +557,7 @@ void Plot::DrawSol(QPainter &c,int level, int type)
     QString label[]={tr("E-W"),tr("N-S"),tr("U-D")},unit[]={"m","m/s",QString("m/s%1").arg(up2Char)};
     QPushButton *btn[]={BtnOn1,BtnOn2,BtnOn3};
     TIMEPOS *pos,*pos1,*pos2;
+    SOLLOD *lod;
     gtime_t time1={0,0},time2={0,0};
     QPoint p1,p2;
     double xc,yc,xl[2],yl[2],off,y;
@@ -568,26 +594,19 @@ void Plot::DrawSol(QPainter &c,int level, int type)
         GraphG[i]->DrawAxis(c,ShowLabel,ShowLabel);
     }
     if (BtnSol1->isChecked()) {
-        pos=SolToPos(SolData,-1,QFlag->currentIndex(),type);
-        DrawSolPnt(c,pos,level,0);
-        DrawSolStat(c,pos,unit[type],p++);
-        delete pos;
+        lod=SolToLod(0,QFlag->currentIndex(),type);
+        DrawSolPnt(c,lod,level,0);
+        DrawSolStat(c,lod->pos,unit[type],p++);
     }
     if (BtnSol2->isChecked()) {
-        pos=SolToPos(SolData+1,-1,QFlag->currentIndex(),type);
-        DrawSolPnt(c,pos,level,1);
-        DrawSolStat(c,pos,unit[type],p++);
-        delete pos;
+        lod=SolToLod(1,QFlag->currentIndex(),type);
+        DrawSolPnt(c,lod,level,1);
+        DrawSolStat(c,lod->pos,unit[type],p++);
     }
     if (BtnSol12->isChecked()) {
-        pos1=SolToPos(SolData  ,-1,0,type);
-        pos2=SolToPos(SolData+1,-1,0,type);
-        pos=pos1->diff(pos2,QFlag->currentIndex());
-        DrawSolPnt(c,pos,level,0);
-        DrawSolStat(c,pos,unit[type],p++);
-        delete pos;
-        delete pos1;
-        delete pos2;
+        lod=SolToLod(2,QFlag->currentIndex(),type);
+        DrawSolPnt(c,lod,level,0);
+        DrawSolStat(c,lod->pos,unit[type],p++);
     }
     if (BtnShowTrack->isChecked()&&(BtnSol1->isChecked()||BtnSol2->isChecked()||BtnSol12->isChecked())) {
         
@@ -650,56 +669,67 @@ void Plot::DrawSol(QPainter &c,int level, int type)
     }
 }
 // draw points and line on solution-plot ------------------------------------
-void Plot::DrawSolPnt(QPainter &c,const TIMEPOS *pos, int level, int style)
+//   the points are decimated to the pixel columns by the time-series pyramid
+//   of the solution points keeping min/max in each column
+void Plot::DrawSolPnt(QPainter &c,const SOLLOD *lod, int level, int style)
 {
     QPushButton *btn[]={BtnOn1,BtnOn2,BtnOn3};
-    double *x,*y,*s,xs,ys,*yy;
-    int i,j;
+    const TIMEPOS *pos=lod->pos;
+    std::vector<int> index;
+    double *x,*y,*s,xs,ys,*yy,xl[2],yl[2],*yp,*sp;
+    int i,j,n;
     
     trace(3,"DrawSolPnt: level=%d style=%d\n",level,style);
     
-    x=new double [pos->n];
+    x =new double [pos->n+1];
+    yy=new double [pos->n+1];
+    s =new double [pos->n+1];
+    y =new double [pos->n+1];
     
-    for (i=0;i<pos->n;i++) {
-        x[i]=TimePos(pos->t[i]);
-    }
     for (i=0;i<3;i++) {
         if (!btn[i]->isChecked()) continue;
         
-        y=i==0?pos->x :(i==1?pos->y :pos->z );
-        s=i==0?pos->xs:(i==1?pos->ys:pos->zs);
+        yp=i==0?pos->x :(i==1?pos->y :pos->z );
+        sp=i==0?pos->xs:(i==1?pos->ys:pos->zs);
+        
+        GraphG[i]->GetLim(xl,yl);
+        GraphG[i]->GetScale(xs,ys);
         
+        n=lod->ser.Query(xl[0],xl[1],static_cast<int>((xl[1]-xl[0])/xs)+1,i,index);
+        
+        for (j=0;j<n;j++) {
+            x[j]=lod->tp[index[j]];
+            y[j]=yp[index[j]];
+            s[j]=sp[index[j]];
+        }
         if (!level||!(PlotStyle%2)) {
-            DrawPolyS(GraphG[i],c,x,y,pos->n,CColor[3],style);
+            DrawPolyS(GraphG[i],c,x,y,n,CColor[3],style);
         }
         if (level&&ShowErr&&PlotType<=PLOT_SOLA&&PlotStyle<2) {
             
-            GraphG[i]->GetScale(xs,ys);
-            
             if (ShowErr==1) {
-                for (j=0;j<pos->n;j++) {
+                for (j=0;j<n;j++) {
                     GraphG[i]->DrawMark(c,x[j],y[j],12,CColor[1],static_cast<int>(SQRT(s[j])*2.0/ys),0);
                 }
             }
             else {
-                yy=new double [pos->n];
-                
-                for (j=0;j<pos->n;j++) yy[j]=y[j]-SQRT(s[j]);
-                DrawPolyS(GraphG[i],c,x,yy,pos->n,CColor[1],1);
+                for (j=0;j<n;j++) yy[j]=y[j]-SQRT(s[j]);
+                DrawPolyS(GraphG[i],c,x,yy,n,CColor[1],1);
                 
-                for (j=0;j<pos->n;j++) yy[j]=y[j]+SQRT(s[j]);
-                DrawPolyS(GraphG[i],c,x,yy,pos->n,CColor[1],1);
-                
-                delete [] yy;
+                for (j=0;j<n;j++) yy[j]=y[j]+SQRT(s[j]);
+                DrawPolyS(GraphG[i],c,x,yy,n,CColor[1],1);
             }
         }
         if (level&&PlotStyle<2) {
             QVector<QColor> color;
-            for (j=0;j<pos->n;j++) color.append(MColor[style][pos->q[j]]);
-            GraphG[i]->DrawMarks(c,x,y,color,pos->n,0,MarkSize,0);
+            for (j=0;j<n;j++) color.append(MColor[style][pos->q[index[j]]]);
+            GraphG[i]->DrawMarks(c,x,y,color,n,0,MarkSize,0);
         }
     }
     delete [] x;
+    delete [] y;
+    delete [] yy;
+    delete [] s;
 }
 // draw statistics on solution-plot -----------------------------------------
 void Plot::DrawSolStat(QPainter &c,const TIMEPOS *pos, const QString &unit, int p)
@@ -779,14 +809,10 @@ void Plot::DrawNsat(QPainter &c,int level)
         GraphG[i]->DrawAxis(c,ShowLabel,ShowLabel);
     }
     if (BtnSol1->isChecked()) {
-        ns=SolToNsat(SolData,-1,QFlag->currentIndex());
-        DrawSolPnt(c,ns,level,0);
-        delete ns;
+        DrawSolPnt(c,SolToLod(0,QFlag->currentIndex(),3),level,0);
     }
     if (BtnSol2->isChecked()) {
-        ns=SolToNsat(SolData+1,-1,QFlag->currentIndex());
-        DrawSolPnt(c,ns,level,1);
-        delete ns;
+        DrawSolPnt(c,SolToLod(1,QFlag->currentIndex(),3),level,1);
     }
     if (BtnShowTrack->isChecked()&&(BtnSol1->isChecked()||BtnSol2->isChecked())) {
         
@@ -0,0 +1,401 @@
+//---------------------------------------------------------------------------
+// plotload : rtkplot background observation data loader
+//---------------------------------------------------------------------------
+#include <QDir>
+#include <QVector>
+#include <QMetaType>
+#include <QtConcurrentMap>
+
+#include "rtklib.h"
+#include "plotload.h"
+
+#define MIN_NEPOCH  256             // min number of epochs in a chunk
+
+// azimuth/elevation of an epoch --------------------------------------------
+struct AzElEpoch
+{
+    typedef void result_type;
+    const obs_t *obs;
+    const nav_t *nav;
+    const sta_t *sta;
+    const azelopt_t *opt;
+    const int *index;
+    double *az,*el;
+
+    void operator()(const int &e) const
+    {
+        prcopt_t popt=prcopt_default;
+        gtime_t time;
+        sol_t sol;
+        double pos[3],rr[3],e_[3],azel[MAXOBS*2]={0},rs[6],dts[2],var;
+        int i=index[e],n=index[e+1]-index[e],k,svh;
+        char msg[128],name[16];
+
+        memset(&sol,0,sizeof(sol_t));
+        popt.err[0]=900.0;
+        time=obs->data[i].time;
+        if (n>MAXOBS) n=MAXOBS;
+
+        if (opt->rcvpos==0) {
+            pntpos(obs->data+i,n,nav,&popt,&sol,azel,NULL,msg);
+            matcpy(rr,sol.rr,3,1);
+            ecef2pos(rr,pos);
+        }
+        else {
+            if (opt->rcvpos==1) { // lat/lon/height
+                for (k=0;k<3;k++) pos[k]=opt->pos[k];
+                pos2ecef(pos,rr);
+            }
+            else { // rinex header position
+                for (k=0;k<3;k++) rr[k]=sta->pos[k];
+                ecef2pos(rr,pos);
+            }
+            for (k=0;k<n;k++) {
+                if (!satpos(time,time,obs->data[i+k].sat,EPHOPT_BRDC,nav,rs,dts,
+                            &var,&svh)) continue;
+                if (geodist(rs,rr,e_)>0.0) satazel(pos,e_,azel+k*2);
+            }
+        }
+        // satellite azel by tle data
+        for (k=0;k<n;k++) {
+            if (azel[k*2]!=0.0||azel[1+k*2]!=0.0||!opt->tle) continue;
+            satno2id(obs->data[i+k].sat,name);
+            if (!tle_pos(time,name,"","",opt->tle,NULL,rs)) continue;
+            if (geodist(rs,rr,e_)>0.0) satazel(pos,e_,azel+k*2);
+        }
+        for (k=0;k<index[e+1]-index[e];k++) {
+            az[i+k]=k<n?azel[  k*2]:0.0;
+            el[i+k]=k<n?azel[1+k*2]:0.0;
+            if (az[i+k]<0.0) az[i+k]+=2.0*PI;
+        }
+    }
+};
+// constructor of observation data set --------------------------------------
+PlotObsData::PlotObsData()
+{
+    memset(&obs,0,sizeof(obs_t));
+    memset(&nav,0,sizeof(nav_t));
+    memset(&sta,0,sizeof(sta_t));
+    nobs=0;
+    index=NULL;
+    az=el=NULL;
+    for (int i=0;i<NFREQ+NEXOBS;i++) mp[i]=NULL;
+    final=navonly=0;
+}
+// destructor of observation data set (free data not adopted) ---------------
+PlotObsData::~PlotObsData()
+{
+    freeobs(&obs);
+    freenav(&nav,0xFF);
+    delete [] index;
+    delete [] az;
+    delete [] el;
+    for (int i=0;i<NFREQ+NEXOBS;i++) delete [] mp[i];
+}
+// constructor of loader ----------------------------------------------------
+PlotLoader::PlotLoader(QObject *parent):QThread(parent)
+{
+    qRegisterMetaType<PlotObsData *>("PlotObsData *");
+
+    ts.time=ts.sec=0;
+    te.time=te.sec=0;
+    tint=0.0;
+    memset(&opt,0,sizeof(azelopt_t));
+    Job=0;
+    memset(&Obs,0,sizeof(obs_t));
+    memset(&Nav,0,sizeof(nav_t));
+    memset(&Sta,0,sizeof(sta_t));
+    Index=NULL;
+    NObs=0;
+    Az=El=NULL;
+    for (int i=0;i<NFREQ+NEXOBS;i++) Mp[i]=NULL;
+}
+// destructor of loader -----------------------------------------------------
+PlotLoader::~PlotLoader()
+{
+    Abort();
+    wait();
+    FreeBuff();
+}
+// set current obs data for nav-only loading and reset abort flag -----------
+void PlotLoader::Start(const obs_t *obs, const sta_t *sta, const int *index,
+                       int nobs)
+{
+    if (obs) Obs=*obs; else memset(&Obs,0,sizeof(obs_t));
+    if (sta) Sta=*sta; else memset(&Sta,0,sizeof(sta_t));
+    memset(&Nav,0,sizeof(nav_t));
+    Index=index;
+    NObs=nobs;
+    AbortFlag=0;
+}
+// abort loading ------------------------------------------------------------
+void PlotLoader::Abort(void)
+{
+    AbortFlag=1;
+}
+// copy az/el of records i0 to i1-1 published by AzElReady() ---------------
+void PlotLoader::CopyAzEl(int i0, int i1, double *az, double *el) const
+{
+    if (!Az||!El||i1<=i0) return;
+    memcpy(az+i0,Az+i0,sizeof(double)*(i1-i0));
+    memcpy(el+i0,El+i0,sizeof(double)*(i1-i0));
+}
+// take multipath published by MpReady() ------------------------------------
+void PlotLoader::TakeMp(double **mp)
+{
+    for (int i=0;i<NFREQ+NEXOBS;i++) {
+        if (!Mp[i]) continue;
+        delete [] mp[i];
+        mp[i]=Mp[i];
+        Mp[i]=NULL;
+    }
+}
+// free az/el and multipath buffers -----------------------------------------
+void PlotLoader::FreeBuff(void)
+{
+    delete [] Az; Az=NULL;
+    delete [] El; El=NULL;
+    for (int i=0;i<NFREQ+NEXOBS;i++) {
+        delete [] Mp[i]; Mp[i]=NULL;
+    }
+}
+// observation data index of epochs (index[0..nobs]) ------------------------
+int PlotLoader::EpochIndex(const obs_t *obs, int *index)
+{
+    int i,j,n=0;
+
+    for (i=0;i<obs->n;i=j) {
+        for (j=i;j<obs->n;j++) {
+            if (timediff(obs->data[j].time,obs->data[i].time)>DTTOL) break;
+        }
+        index[n++]=i;
+    }
+    index[n]=obs->n;
+    return n;
+}
+// azimuth/elevation of epochs e0 to e1-1 in parallel -----------------------
+void PlotLoader::CalcAzEl(const obs_t *obs, const nav_t *nav,
+                          const sta_t *sta, const azelopt_t *opt,
+                          const int *index, int e0, int e1, double *az,
+                          double *el)
+{
+    AzElEpoch func;
+    QVector<int> epochs;
+
+    for (int e=e0;e<e1;e++) epochs.append(e);
+
+    func.obs=obs; func.nav=nav; func.sta=sta; func.opt=opt;
+    func.index=index; func.az=az; func.el=el;
+    QtConcurrent::blockingMap(epochs,func);
+}
+// multipath of all records by observation qc ------------------------------
+void PlotLoader::CalcMp(const obs_t *obs, const nav_t *nav, double **mp)
+{
+    qc_t *qc=new qc_t;
+
+    initqc(qc);
+    obsqc(qc,obs,nav,mp);
+    delete qc;
+}
+// publish obs data set (final: move obs and nav, else copy obs) ------------
+void PlotLoader::Publish(obs_t *obs, nav_t *nav, const sta_t *sta, int final,
+                         int navonly)
+{
+    PlotObsData *data=new PlotObsData;
+    int i;
+
+    if (!navonly) {
+        sortobs(obs);
+        if (final) {
+            data->obs=*obs;
+            memset(obs,0,sizeof(obs_t));
+        }
+        else if ((data->obs.data=(obsd_t *)malloc(sizeof(obsd_t)*obs->n))) {
+            memcpy(data->obs.data,obs->data,sizeof(obsd_t)*obs->n);
+            data->obs.n=data->obs.nmax=obs->n;
+        }
+        data->index=new int[data->obs.n+1];
+        data->nobs=EpochIndex(&data->obs,data->index);
+        data->az=new double[data->obs.n]();
+        data->el=new double[data->obs.n]();
+        for (i=0;i<NFREQ+NEXOBS;i++) data->mp[i]=new double[data->obs.n]();
+    }
+    if (nav) {
+        data->nav=*nav;
+        memset(nav,0,sizeof(nav_t));
+    }
+    if (sta) data->sta=*sta;
+    data->final=final;
+    data->navonly=navonly;
+
+    // data for az/el and multipath (owned by the main thread)
+    if (final) {
+        if (!navonly) {
+            Obs=data->obs;
+            Sta=data->sta;
+            Index=data->index;
+            NObs=data->nobs;
+        }
+        Nav=data->nav;
+    }
+    emit ObsReady(Job,data);
+}
+// read nav data of obs files -----------------------------------------------
+void PlotLoader::ReadNavAuto(nav_t *nav, const char *opt)
+{
+    char navfile[1024],*p,*q;
+    int i,n;
+
+    for (i=0;i<ObsFiles.size();i++) {
+        strcpy(navfile,qPrintable(QDir::toNativeSeparators(ObsFiles.at(i))));
+
+        if (!(p=strrchr(navfile,'.'))) continue;
+
+        if (!strcmp(p,".obs")||!strcmp(p,".OBS")) {
+            strcpy(p,".nav" ); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p,".gnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p,".hnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p,".qnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p,".lnav"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+        }
+        else if (!strcmp(p+3,"o" )||!strcmp(p+3,"d" )||
+                 !strcmp(p+3,"O" )||!strcmp(p+3,"D" )) {
+            n=nav->n;
+
+            strcpy(p+3,"N"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p+3,"G"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p+3,"H"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p+3,"Q"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p+3,"L"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+            strcpy(p+3,"P"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+
+            if (nav->n>n||!(q=strrchr(navfile,'\\'))) continue;
+
+            // read brdc navigation data
+            memcpy(q+1,"BRDC",4);
+            strcpy(p+3,"N"); readrnxt(navfile,1,ts,te,tint,opt,NULL,nav,NULL);
+        }
+    }
+}
+// read obs files and publish obs data after each file ----------------------
+int PlotLoader::ReadObs(void)
+{
+    obs_t obs;
+    nav_t nav;
+    sta_t sta;
+    char obsfile[1024],opt[2048];
+    int i;
+
+    trace(3,"PlotLoader::ReadObs\n");
+
+    memset(&obs,0,sizeof(obs_t));
+    memset(&nav,0,sizeof(nav_t));
+    memset(&sta,0,sizeof(sta_t));
+    strcpy(opt,qPrintable(RnxOpts));
+
+    for (i=0;i<ObsFiles.size();i++) {
+        if (AbortFlag) break;
+
+        strcpy(obsfile,qPrintable(QDir::toNativeSeparators(ObsFiles.at(i))));
+
+        emit Progress(QString(tr("reading obs data... %1")).arg(obsfile));
+
+        if (readrnxt(obsfile,1,ts,te,tint,opt,&obs,&nav,&sta)<0) {
+            emit Progress(tr("error: insufficient memory"));
+            break;
+        }
+        // publish partial obs data
+        if (i<ObsFiles.size()-1&&obs.n>0) Publish(&obs,NULL,&sta,0,0);
+    }
+    if (i<ObsFiles.size()) {
+        freeobs(&obs);
+        freenav(&nav,0xFF);
+        return 0;
+    }
+    emit Progress(tr("reading nav data..."));
+
+    ReadNavAuto(&nav,opt);
+
+    if (obs.n<=0) {
+        emit Progress(QString(tr("no observation data: %1...")).arg(ObsFiles.at(0)));
+        freenav(&nav,0xFF);
+        return 0;
+    }
+    uniqnav(&nav);
+
+    Publish(&obs,&nav,&sta,1,0);
+    return 1;
+}
+// read nav files -----------------------------------------------------------
+int PlotLoader::ReadNav(void)
+{
+    nav_t nav;
+    char navfile[1024],opt[2048];
+    int i;
+
+    trace(3,"PlotLoader::ReadNav\n");
+
+    memset(&nav,0,sizeof(nav_t));
+    strcpy(opt,qPrintable(RnxOpts));
+
+    emit Progress(tr("reading nav data..."));
+
+    for (i=0;i<NavFiles.size()&&!AbortFlag;i++) {
+        strcpy(navfile,qPrintable(QDir::toNativeSeparators(NavFiles.at(i))));
+        readrnxt(navfile,1,ts,te,tint,opt,NULL,&nav,NULL);
+    }
+    uniqnav(&nav);
+
+    if (AbortFlag||(nav.n<=0&&nav.ng<=0&&nav.ns<=0)) {
+        if (!AbortFlag) {
+            emit Progress(QString(tr("no nav message: %1...")).arg(NavFiles.at(0)));
+        }
+        freenav(&nav,0xFF);
+        return 0;
+    }
+    Publish(NULL,&nav,NULL,1,1);
+    return 1;
+}
+// loader thread: read files, compute az/el by chunks and multipath ---------
+void PlotLoader::run()
+{
+    int i,e0,e1,nep;
+
+    trace(3,"PlotLoader::run\n");
+
+    FreeBuff();
+
+    if (ObsFiles.size()>0) {
+        if (!ReadObs()) return;
+    }
+    else if (!ReadNav()) return;
+
+    if (NObs<=0) return;
+
+    Az=new double[Obs.n]();
+    El=new double[Obs.n]();
+    nep=NObs/LOAD_NCHUNK>MIN_NEPOCH?NObs/LOAD_NCHUNK:MIN_NEPOCH;
+
+    for (e0=0;e0<NObs;e0=e1) {
+        if (AbortFlag) return;
+
+        emit Progress(QString(tr("updating azimuth/elevation... (%1%)")).arg(e0*100/NObs));
+
+        e1=e0+nep<NObs?e0+nep:NObs;
+        CalcAzEl(&Obs,&Nav,&Sta,&opt,Index,e0,e1,Az,El);
+
+        emit AzElReady(Job,Index[e0],Index[e1]);
+    }
+    if (AbortFlag) return;
+
+    emit Progress(tr("updating multipath..."));
+
+    for (i=0;i<NFREQ+NEXOBS;i++) Mp[i]=new double[Obs.n]();
+
+    CalcMp(&Obs,&Nav,Mp);
+
+    if (AbortFlag) return;
+
+    emit Progress("");
+    emit MpReady(Job);
+}
@@ -0,0 +1,91 @@
+//---------------------------------------------------------------------------
+#ifndef plotloadH
+#define plotloadH
+//---------------------------------------------------------------------------
+#include <QThread>
+#include <QString>
+#include <QStringList>
+#include <QAtomicInt>
+
+#include "rtklib.h"
+
+#define LOAD_NCHUNK 20                  // number of chunks to publish az/el
+
+// azimuth/elevation options ------------------------------------------------
+typedef struct {
+    int rcvpos;                         // receiver pos (0:single,1:llh,2:rinex)
+    double pos[3];                      // receiver lat/lon/hgt (rad,m)
+    const tle_t *tle;                   // tle data
+} azelopt_t;
+
+// observation data set -----------------------------------------------------
+class PlotObsData
+{
+public:
+    obs_t obs;
+    nav_t nav;
+    sta_t sta;
+    int nobs,*index;
+    double *az,*el,*mp[NFREQ+NEXOBS];
+    int final;                          // final data set of the file list
+    int navonly;                        // only nav data updated
+
+    PlotObsData();
+    ~PlotObsData();
+};
+
+// background observation data loader ---------------------------------------
+class PlotLoader : public QThread
+{
+    Q_OBJECT
+
+public:
+    QStringList ObsFiles,NavFiles;
+    QString RnxOpts;
+    gtime_t ts,te;
+    double tint;
+    azelopt_t opt;
+    int Job;
+
+    explicit PlotLoader(QObject *parent);
+    ~PlotLoader();
+    void  Start    (const obs_t *obs, const sta_t *sta, const int *index,
+                    int nobs);
+    void  Abort    (void);
+    void  CopyAzEl (int i0, int i1, double *az, double *el) const;
+    void  TakeMp   (double **mp);
+
+    static int  EpochIndex(const obs_t *obs, int *index);
+    static void CalcAzEl(const obs_t *obs, const nav_t *nav, const sta_t *sta,
+                         const azelopt_t *opt, const int *index, int e0, int e1,
+                         double *az, double *el);
+    static void CalcMp  (const obs_t *obs, const nav_t *nav, double **mp);
+
+signals:
+    void  Progress (const QString &msg);
+    void  ObsReady (int job, PlotObsData *data);
+    void  AzElReady(int job, int i0, int i1);
+    void  MpReady  (int job);
+
+protected:
+    void  run      ();
+
+private:
+    QAtomicInt AbortFlag;
+    obs_t Obs;                          // obs data for az/el (not owned)
+    nav_t Nav;                          // nav data for az/el (not owned)
+    sta_t Sta;
+    const int *Index;
+    int NObs;
+    double *Az,*El,*Mp[NFREQ+NEXOBS];
+
+    int   ReadObs  (void);
+    int   ReadNav  (void);
+    void  ReadNavAuto(nav_t *nav, const char *opt);
+    void  Publish  (obs_t *obs, nav_t *nav, const sta_t *sta, int final,
+                    int navonly);
+    void  FreeBuff (void);
+};
+
+//---------------------------------------------------------------------------
+#endif
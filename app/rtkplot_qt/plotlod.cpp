@@ -0,0 +1,447 @@
+//---------------------------------------------------------------------------
+// plotlod : rtkplot level-of-detail index for solution drawing
+//---------------------------------------------------------------------------
+#include <math.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <utility>
+#include <algorithm>
+
+#include "plotlod.h"
+
+#define NSTEP       1001                // number of edges to estimate margin
+
+//---------------------------------------------------------------------------
+// min/max-preserving pyramid over time series
+//---------------------------------------------------------------------------
+
+// constructor --------------------------------------------------------------
+SeriesLod::SeriesLod()
+{
+    t_=NULL; q_=NULL;
+    for (int k=0;k<LOD_MAXSER;k++) y_[k]=NULL;
+    n_=ny_=ns_=0; sorted_=1;
+}
+// clear index --------------------------------------------------------------
+void SeriesLod::Clear(void)
+{
+    t_=NULL; q_=NULL;
+    n_=ny_=ns_=0; sorted_=1;
+    lev_.clear();
+}
+// compare samples i and j for statistics s (1:i precedes j) ----------------
+int SeriesLod::Less(int i, int j, int s) const
+{
+    if (s<2*ny_) {
+        return s%2?y_[s/2][i]>y_[s/2][j]:y_[s/2][i]<y_[s/2][j];
+    }
+    return q_[i]>q_[j];
+}
+// statistics s of block i of level L ---------------------------------------
+int SeriesLod::Stat(int i, int s, int L) const
+{
+    return L==0?i:lev_[L][(i>>L)*ns_+s];
+}
+// build index --------------------------------------------------------------
+//   t[n] must be non-decreasing for decimation, otherwise Query() returns all
+//   samples. s=2k: min of y[k], s=2k+1: max of y[k], s=2*ny: max of q
+void SeriesLod::Build(const double *t, const double * const *y, int ny,
+                      const int *q, int n)
+{
+    int i,a,b,s,L,nb;
+
+    Clear();
+    if (n<=0||ny>LOD_MAXSER) return;
+
+    t_=t; q_=q; n_=n; ny_=ny; ns_=2*ny+(q?1:0);
+    for (i=0;i<ny;i++) y_[i]=y[i];
+
+    for (i=1;i<n;i++) if (t[i]<t[i-1]) break;
+    if (!(sorted_=i>=n)) return;
+
+    lev_.push_back(std::vector<int>()); // level 0: samples
+
+    for (L=1;(nb=n>>L)>0;L++) {
+        lev_.push_back(std::vector<int>(nb*ns_));
+        for (i=0;i<nb;i++) for (s=0;s<ns_;s++) {
+            a=Stat(2*i<<(L-1),s,L-1);
+            b=Stat((2*i+1)<<(L-1),s,L-1);
+            lev_[L][i*ns_+s]=Less(b,a,s)?b:a;
+        }
+    }
+}
+// index of min/max sample in range [i0,i1) for statistics s -----------------
+int SeriesLod::ArgMin(int i0, int i1, int s) const
+{
+    int L,c,best=-1,nlev=(int)lev_.size();
+
+    while (i0<i1) {
+        for (L=0;L+1<nlev&&!(i0&((2<<L)-1))&&i0+(2<<L)<=i1;L++) ;
+        c=Stat(i0,s,L);
+        if (best<0||Less(c,best,s)) best=c;
+        i0+=1<<L;
+    }
+    return best;
+}
+// query decimated samples --------------------------------------------------
+//   args   : double t0,t1       I   time range
+//            int    npix        I   number of pixel columns in range
+//            int    k           I   series index
+//            vector<int> &index O   sample indices (ascending)
+//   return : number of samples
+//   notes  : for each pixel column the first, last, min, max and max-quality
+//            samples are returned. one sample before and after the range
+//            are included for polylines.
+int SeriesLod::Query(double t0, double t1, int npix, int k,
+                     std::vector<int> &index) const
+{
+    int i,j,m,a,b,i0,i1,c,cand[5];
+    double te,dt;
+
+    index.clear();
+
+    if (n_<=0||k<0||k>=ny_) return 0;
+
+    if (!sorted_||npix<=0||t1<=t0) {
+        for (i=0;i<n_;i++) index.push_back(i);
+        return n_;
+    }
+    i0=(int)(std::lower_bound(t_,t_+n_,t0)-t_);
+    i1=(int)(std::upper_bound(t_,t_+n_,t1)-t_);
+    if (i0>0) i0--;
+    if (i1<n_) i1++;
+
+    if (i1-i0<=4*npix) {
+        for (i=i0;i<i1;i++) index.push_back(i);
+        return (int)index.size();
+    }
+    if (t_[i0]<t0) index.push_back(i0++);
+
+    dt=(t1-t0)/npix;
+
+    for (c=0,a=i0;c<npix&&a<i1;c++,a=b) {
+        te=t0+(c+1)*dt;
+        if (c<npix-1) b=(int)(std::lower_bound(t_+a,t_+i1,te)-t_);
+        else          b=(int)(std::upper_bound(t_+a,t_+i1,t1)-t_);
+        if (b<=a) continue;
+
+        m=0;
+        cand[m++]=a;
+        cand[m++]=ArgMin(a,b,2*k);
+        cand[m++]=ArgMin(a,b,2*k+1);
+        if (q_) cand[m++]=ArgMin(a,b,2*ny_);
+        cand[m++]=b-1;
+        std::sort(cand,cand+m);
+        for (j=0;j<m;j++) {
+            if (j>0&&cand[j]==cand[j-1]) continue;
+            index.push_back(cand[j]);
+        }
+    }
+    for (;a<i1;a++) index.push_back(a);
+
+    return (int)index.size();
+}
+
+//---------------------------------------------------------------------------
+// multiresolution grid index over track points
+//---------------------------------------------------------------------------
+
+// constructor --------------------------------------------------------------
+TrackLod::TrackLod()
+{
+    x_=y_=NULL; n_=0;
+    x0_=y0_=0.0; cell_=1.0;
+}
+// clear index --------------------------------------------------------------
+void TrackLod::Clear(void)
+{
+    x_=y_=NULL; n_=0;
+    x0_=y0_=0.0; cell_=1.0;
+    line_.clear();
+    mark_.clear();
+}
+// cell key of point i at level L -------------------------------------------
+unsigned int TrackLod::Key(int i, int L) const
+{
+    double fx=(x_[i]-x0_)/cell_,fy=(y_[i]-y0_)/cell_;
+    unsigned int ix,iy;
+
+    ix=fx<=0.0?0:(fx>=LOD_MAXCELL-1?LOD_MAXCELL-1:(unsigned int)fx);
+    iy=fy<=0.0?0:(fy>=LOD_MAXCELL-1?LOD_MAXCELL-1:(unsigned int)fy);
+    return ((iy>>L)<<16)|(ix>>L);
+}
+// key of parent cell -------------------------------------------------------
+unsigned int TrackLod::Parent(unsigned int key)
+{
+    return ((key>>17)<<16)|((key&0xFFFF)>>1);
+}
+// distance between cells (cells) -------------------------------------------
+int TrackLod::Dist(unsigned int k0, unsigned int k1)
+{
+    int dx=abs((int)(k0&0xFFFF)-(int)(k1&0xFFFF));
+    int dy=abs((int)(k0>>16)-(int)(k1>>16));
+    return dx>dy?dx:dy;
+}
+// sort and remove duplicated edges (keep first end point) ------------------
+void TrackLod::Unique(std::vector<Edge> &edge)
+{
+    size_t i,n=0;
+
+    std::sort(edge.begin(),edge.end());
+    for (i=0;i<edge.size();i++) {
+        if (n>0&&edge[i].key==edge[n-1].key) continue;
+        edge[n++]=edge[i];
+    }
+    edge.resize(n);
+}
+// add polyline level -------------------------------------------------------
+//   edges longer than the margin (the larger of LOD_LONGSEG and the median
+//   edge length in cells) are kept in a list instead of the cells.
+void TrackLod::AddLine(int L, const std::vector<int> &seq,
+                       const std::vector<Edge> &edge)
+{
+    Line lv;
+    std::vector<int> len;
+    unsigned int k0,k1;
+    int i,p,m=(int)edge.size(),inc;
+
+    lv.L=L;
+    lv.seq=seq;
+    lv.margin=LOD_LONGSEG;
+
+    inc=m<=NSTEP?1:m/NSTEP;
+    for (i=0;i<m;i+=inc) {
+        len.push_back(Dist((unsigned int)(edge[i].key>>32),(unsigned int)edge[i].key));
+    }
+    if (!len.empty()) {
+        std::nth_element(len.begin(),len.begin()+len.size()/2,len.end());
+        lv.margin=std::max(lv.margin,len[len.size()/2]);
+    }
+    for (i=0;i<m;i++) {
+        p=(int)(std::lower_bound(seq.begin(),seq.end(),edge[i].i)-seq.begin())-1;
+        k0=Key(seq[p],L);
+        k1=Key(seq[p+1],L);
+        if (Dist(k0,k1)>lv.margin) {
+            lv.longedge.push_back(p);
+        }
+        else {
+            Cell c={k0,p};
+            lv.edge.push_back(c);
+        }
+    }
+    std::sort(lv.edge.begin(),lv.edge.end());
+    std::sort(lv.longedge.begin(),lv.longedge.end());
+    line_.push_back(lv);
+}
+// build index --------------------------------------------------------------
+//   level 0 has cells of extent/(LOD_MAXCELL-1). the edges of level L are the
+//   edges of level L-1 mapped to the parent cells, since the points dropped
+//   from a level are in the same cell as the preceding point. a level is
+//   stored only if it halves the edges or marks of the finer stored level.
+void TrackLod::Build(const double *x, const double *y, const int *q, int n)
+{
+    std::vector<int> seq,prev;
+    std::vector<Cell> rep;
+    std::vector<Edge> edge;
+    Mark mk;
+    double xmax,ymax;
+    size_t nedge,nmark;
+    unsigned int k0,k1,key;
+    int i,j,m,L;
+
+    Clear();
+    if (n<=0) return;
+
+    x_=x; y_=y; n_=n;
+
+    x0_=xmax=x[0]; y0_=ymax=y[0];
+    for (i=1;i<n;i++) {
+        if (x[i]<x0_) x0_=x[i]; else if (x[i]>xmax) xmax=x[i];
+        if (y[i]<y0_) y0_=y[i]; else if (y[i]>ymax) ymax=y[i];
+    }
+    cell_=std::max(xmax-x0_,ymax-y0_)/(LOD_MAXCELL-1);
+    if (cell_<=0.0) cell_=1.0;
+
+    // level 0: all points
+    prev.resize(n);
+    rep.resize(n);
+    for (i=0;i<n;i++) {
+        Cell c={Key(i,0),i};
+        prev[i]=i;
+        rep[i]=c;
+    }
+    for (i=0;i<n-1;i++) {
+        k0=std::min(rep[i].key,rep[i+1].key);
+        k1=std::max(rep[i].key,rep[i+1].key);
+        Edge e={((unsigned long long)k0<<32)|k1,i+1};
+        edge.push_back(e);
+    }
+    Unique(edge);
+    AddLine(0,prev,edge);
+    mk.L=0;
+    mk.mark=rep;
+    std::sort(mk.mark.begin(),mk.mark.end());
+    mark_.push_back(mk);
+    nedge=edge.size();
+    nmark=rep.size();
+
+    for (L=1;(LOD_MAXCELL-1)>>(L-1);L++) {
+
+        // first point of each run of points in a cell and the last point
+        seq.clear();
+        for (i=0;i<(int)prev.size();i++) {
+            key=Key(prev[i],L);
+            if (!seq.empty()&&Key(seq.back(),L)==key) continue;
+            seq.push_back(prev[i]);
+        }
+        if (seq.back()!=n-1) seq.push_back(n-1);
+        prev.swap(seq);
+
+        // edges between parent cells
+        for (i=m=0;i<(int)edge.size();i++) {
+            k0=Parent((unsigned int)(edge[i].key>>32));
+            k1=Parent((unsigned int)edge[i].key);
+            if (k0==k1) continue;
+            edge[m].key=((unsigned long long)k0<<32)|k1;
+            edge[m++].i=edge[i].i;
+        }
+        edge.resize(m);
+        Unique(edge);
+
+        if (2*edge.size()<=nedge) {
+            AddLine(L,prev,edge);
+            nedge=edge.size();
+        }
+        // representative point of each cell (max quality flag)
+        for (i=0;i<(int)rep.size();i++) rep[i].key=Parent(rep[i].key);
+        std::sort(rep.begin(),rep.end());
+        for (i=m=0;i<(int)rep.size();i=j) {
+            Cell c=rep[i];
+            for (j=i+1;j<(int)rep.size()&&rep[j].key==rep[i].key;j++) {
+                if (q&&q[rep[j].i]>q[c.i]) c.i=rep[j].i;
+            }
+            rep[m++]=c;
+        }
+        rep.resize(m);
+
+        if (2*rep.size()<=nmark) {
+            mk.L=L;
+            mk.mark=rep;
+            mark_.push_back(mk);
+            nmark=rep.size();
+        }
+    }
+}
+// cell range of area at level L (ix[0]>ix[1]: out of grid) ------------------
+void TrackLod::Range(const double *xl, const double *yl, int L, double margin,
+                     int *ix, int *iy) const
+{
+    double size=cell_*(1<<L),f[4];
+    int i,nmax=(LOD_MAXCELL-1)>>L,*p[4]={ix,ix+1,iy,iy+1};
+
+    f[0]=floor((xl[0]-margin-x0_)/size);
+    f[1]=floor((xl[1]+margin-x0_)/size);
+    f[2]=floor((yl[0]-margin-y0_)/size);
+    f[3]=floor((yl[1]+margin-y0_)/size);
+
+    for (i=0;i<4;i++) {
+        *p[i]=f[i]<0.0?0:(f[i]>nmax?nmax:(int)f[i]);
+    }
+    // area entirely outside of the grid
+    if (f[1]<0.0||f[3]<0.0||f[0]>nmax||f[2]>nmax) ix[0]=ix[1]+1;
+}
+// entries of sorted cells in cell range ------------------------------------
+void TrackLod::Cells(const std::vector<Cell> &cells, const int *ix,
+                     const int *iy, std::vector<int> &out) const
+{
+    std::vector<Cell>::const_iterator it;
+    unsigned int cx,cy;
+    int row;
+
+    if (ix[0]>ix[1]||iy[0]>iy[1]) return;
+
+    if ((size_t)(iy[1]-iy[0]+1)>cells.size()/16+1) { // linear scan
+        for (it=cells.begin();it!=cells.end();++it) {
+            cx=it->key&0xFFFF; cy=it->key>>16;
+            if ((int)cx<ix[0]||(int)cx>ix[1]||(int)cy<iy[0]||(int)cy>iy[1]) continue;
+            out.push_back(it->i);
+        }
+        return;
+    }
+    for (row=iy[0];row<=iy[1];row++) {
+        Cell c={((unsigned int)row<<16)|(unsigned int)ix[0],INT_MIN};
+        for (it=std::lower_bound(cells.begin(),cells.end(),c);it!=cells.end();++it) {
+            if (it->key>(((unsigned int)row<<16)|(unsigned int)ix[1])) break;
+            out.push_back(it->i);
+        }
+    }
+}
+// query polyline points in area --------------------------------------------
+//   args   : double *xl,*yl     I   area {min,max}
+//            double pix         I   pixel size
+//            vector<int> &index O   point indices, -1 separates polylines
+//   return : number of points
+//   notes  : the coarsest level with cell size <= pix is used
+int TrackLod::QueryLine(const double *xl, const double *yl, double pix,
+                        std::vector<int> &index) const
+{
+    const Line *lv;
+    std::vector<int> pos;
+    int i,p,p0,p1,ix[2],iy[2],np=0;
+
+    index.clear();
+    if (n_<=0) return 0;
+
+    for (lv=&line_[0],i=1;i<(int)line_.size();i++) {
+        if (cell_*(1<<line_[i].L)<=pix) lv=&line_[i];
+    }
+    // edges crossing area have the first end point within the margin
+    Range(xl,yl,lv->L,(lv->margin+1)*cell_*(1<<lv->L),ix,iy);
+    Cells(lv->edge,ix,iy,pos);
+
+    for (i=0;i<(int)lv->longedge.size();i++) {
+        p=lv->longedge[i];
+        p0=lv->seq[p]; p1=lv->seq[p+1];
+        if (std::max(x_[p0],x_[p1])<xl[0]||std::min(x_[p0],x_[p1])>xl[1]||
+            std::max(y_[p0],y_[p1])<yl[0]||std::min(y_[p0],y_[p1])>yl[1]) {
+            continue;
+        }
+        pos.push_back(p);
+    }
+    std::sort(pos.begin(),pos.end());
+
+    for (i=0;i<(int)pos.size();i++) {
+        if (i==0||pos[i]!=pos[i-1]+1) {
+            if (i>0) index.push_back(-1);
+            index.push_back(lv->seq[pos[i]]);
+            np++;
+        }
+        index.push_back(lv->seq[pos[i]+1]);
+        np++;
+    }
+    return np;
+}
+// query mark points in area ------------------------------------------------
+//   args   : double *xl,*yl     I   area {min,max}
+//            double pix         I   pixel size
+//            vector<int> &index O   point indices (ascending)
+//   return : number of points
+//   notes  : the coarsest level with cell size <= pix is used
+int TrackLod::QueryMarks(const double *xl, const double *yl, double pix,
+                         std::vector<int> &index) const
+{
+    const Mark *lv;
+    int i,ix[2],iy[2];
+
+    index.clear();
+    if (n_<=0) return 0;
+
+    for (lv=&mark_[0],i=1;i<(int)mark_.size();i++) {
+        if (cell_*(1<<mark_[i].L)<=pix) lv=&mark_[i];
+    }
+    Range(xl,yl,lv->L,0.0,ix,iy);
+    Cells(lv->mark,ix,iy,index);
+    std::sort(index.begin(),index.end());
+
+    return (int)index.size();
+}
@@ -0,0 +1,101 @@
+//---------------------------------------------------------------------------
+#ifndef plotlodH
+#define plotlodH
+//---------------------------------------------------------------------------
+#include <vector>
+
+#define LOD_MAXSER  3                   // max number of series per time index
+#define LOD_MAXCELL 65536               // max number of grid cells per axis
+#define LOD_LONGSEG 2                   // min long edge length (cells)
+
+// min/max-preserving multiresolution pyramid over time series --------------
+// level L stores, for each block of 2^L samples, the sample indices of the
+// minimum and maximum of every series and of the maximum quality flag. the
+// data arrays are not copied and must outlive the index.
+class SeriesLod
+{
+public:
+    SeriesLod();
+    void  Build (const double *t, const double * const *y, int ny,
+                 const int *q, int n);
+    void  Clear (void);
+    int   Query (double t0, double t1, int npix, int k,
+                 std::vector<int> &index) const;
+
+private:
+    const double *t_,*y_[LOD_MAXSER];
+    const int *q_;
+    int n_,ny_,ns_,sorted_;
+    std::vector<std::vector<int> > lev_;
+
+    int   ArgMin(int i0, int i1, int s) const;
+    int   Stat  (int i, int s, int L) const;
+    int   Less  (int i, int j, int s) const;
+};
+
+// multiresolution grid index over track points -----------------------------
+// level L has cells of size cell*2^L. level 0 keeps every point, coarser
+// levels keep the first point of each run of points in the same cell for
+// polylines and one representative point (maximum quality flag) for each
+// occupied cell for marks. polyline edges joining the same pair of cells are
+// indexed once, so that repeated laps over a track are drawn once. the data
+// arrays are not copied and must outlive the index.
+class TrackLod
+{
+public:
+    TrackLod();
+    void  Build     (const double *x, const double *y, const int *q, int n);
+    void  Clear     (void);
+    int   QueryLine (const double *xl, const double *yl, double pix,
+                     std::vector<int> &index) const;
+    int   QueryMarks(const double *xl, const double *yl, double pix,
+                     std::vector<int> &index) const;
+
+private:
+    struct Cell {
+        unsigned int key;               // cell key (iy<<16|ix)
+        int i;                          // seq position or point index
+        bool operator<(const Cell &c) const
+        {
+            return key<c.key||(key==c.key&&i<c.i);
+        }
+    };
+    struct Edge {
+        unsigned long long key;         // cell keys of end points (min,max)
+        int i;                          // index of second end point
+        bool operator<(const Edge &e) const
+        {
+            return key<e.key||(key==e.key&&i<e.i);
+        }
+    };
+    struct Line {
+        int L;                          // level (cell size=cell*2^L)
+        int margin;                     // max length of short edges (cells)
+        std::vector<int> seq;           // point indices along the track
+        std::vector<Cell> edge;         // short edges seq[i]-seq[i+1] by key
+        std::vector<int> longedge;      // long edges seq[i]-seq[i+1]
+    };
+    struct Mark {
+        int L;                          // level (cell size=cell*2^L)
+        std::vector<Cell> mark;         // representative points by key
+    };
+    const double *x_,*y_;
+    int n_;
+    double x0_,y0_,cell_;
+    std::vector<Line> line_;
+    std::vector<Mark> mark_;
+
+    unsigned int Key(int i, int L) const;
+    static unsigned int Parent(unsigned int key);
+    static int  Dist  (unsigned int k0, unsigned int k1);
+    static void Unique(std::vector<Edge> &edge);
+    void  AddLine(int L, const std::vector<int> &seq,
+                  const std::vector<Edge> &edge);
+    void  Range  (const double *xl, const double *yl, int L, double margin,
+                  int *ix, int *iy) const;
+    void  Cells  (const std::vector<Cell> &cells, const int *ix,
+                  const int *iy, std::vector<int> &out) const;
+};
+
+//---------------------------------------------------------------------------
+#endif
@@ -53,6 +53,7 @@
 
 #include "rtklib.h"
 #include "plotmain.h"
+#include "plotload.h"
 #include "plotopt.h"
 #include "refdlg.h"
 #include "tspandlg.h"
@@ -121,6 +122,8 @@ Plot::Plot(QWidget *parent) : QMainWindow(parent)
         SolStat[i]=solstat0;
         SolIndex[i]=0;
     }
+    for (i=0;i<MAXSOLLOD;i++) SolLod[i]=NULL;
+    SolGen=SolLodNext=0;
     ObsIndex=0;
     Obs=obs0;
     Nav=nav0;
@@ -136,6 +139,14 @@ Plot::Plot(QWidget *parent) : QMainWindow(parent)
     for (i=0;i<3;i++) OPos[i]=OVel[i]=0.0;
     Az=El=NULL;
     for (i=0;i<NFREQ+NEXOBS;i++) Mp[i]=NULL;
+    
+    Loader=new PlotLoader(this);
+    LoadFirst=0;
+    connect(Loader,SIGNAL(Progress(const QString &)),this,SLOT(LoadProgress(const QString &)));
+    connect(Loader,SIGNAL(ObsReady(int,PlotObsData *)),this,SLOT(LoadObsReady(int,PlotObsData *)));
+    connect(Loader,SIGNAL(AzElReady(int,int,int)),this,SLOT(LoadAzElReady(int,int,int)));
+    connect(Loader,SIGNAL(MpReady(int)),this,SLOT(LoadMpReady(int)));
+    connect(Loader,SIGNAL(finished()),this,SLOT(LoadFinished()));
 
     GraphT =new Graph(Disp);
     GraphT->Fit=0;
@@ -340,6 +351,9 @@ Plot::Plot(QWidget *parent) : QMainWindow(parent)
 // destructor ---------------------------------------------------------------
 Plot::~Plot()
 {
+    StopLoad();
+    ClearSolLod();
+    
     delete [] IndexObs;
     delete [] Az;
     delete [] El;
@@ -462,6 +476,8 @@ void Plot::closeEvent(QCloseEvent *)
 {
     trace(3,"FormClose\n");
     
+    StopLoad();
+    
     RangeList->setVisible(false);
 
     SaveOpt();
@@ -1813,6 +1829,12 @@ void Plot::keyPressEvent(QKeyEvent* event)
     
     trace(3,"FormKeyDown:\n");
     
+    // abort background loading
+    if (event->key()==Qt::Key_Escape&&Loader->isRunning()) {
+        Loader->Abort();
+        ShowMsg(tr("aborted"));
+        return;
+    }
     switch (event->key()) {
         case Qt::Key_Up   : key+=1; break;
         case Qt::Key_Down : key+=2; break;
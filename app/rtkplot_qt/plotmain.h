@@ -9,6 +9,7 @@
 #include "graph.h"
 #include "console.h"
 #include "rtklib.h"
+#include "plotlod.h"
 
 #include "ui_plotmain.h"
 
@@ -17,6 +18,7 @@
 #define MAXWAYPNT   99                  // max number of waypoints
 #define MAXMAPPATH  4096                // max number of map paths
 #define MAXMAPLAYER 12                  // max number of map layers
+#define MAXSOLLOD   6                   // max number of cached solution points
 
 #define PRGNAME     "RTKPLOT-QT"           // program name
 
@@ -81,6 +83,8 @@ class PntDialog;
 class FileSelDialog;
 class TextViewer;
 class VecMapDialog;
+class PlotLoader;
+class PlotObsData;
 
 class QEvent;
 class QMouseEvent;
@@ -108,6 +112,24 @@ public:
     TIMEPOS *diff(const TIMEPOS *pos2, int qflag);
 };
 
+// solution points with level-of-detail index --------------------------------
+class SOLLOD
+{
+private:
+    SOLLOD(SOLLOD &){}
+public:
+    int sel,qflag,type,gen,week,tlabel; // key (sel=2:sol1-sol2,type=3:nsat)
+    int n[2];
+    gtime_t ts[2],te[2],oepoch;
+    double tint,opos[3],ovel[3];
+    TIMEPOS *pos;                       // solution points
+    double *tp;                         // plot time of points
+    SeriesLod ser;                      // time-series pyramid
+    TrackLod trk;                       // track grid (type=0)
+    SOLLOD();
+    ~SOLLOD();
+};
+
 // rtkplot class ------------------------------------------------------------
 class Plot : public QMainWindow, public Ui::Plot
 {
@@ -211,6 +233,12 @@ public slots:
         void  MenuOpenWaypointClick();
         void  MenuSaveWaypointClick();
 
+        void  LoadProgress  (const QString &msg);
+        void  LoadObsReady  (int job, PlotObsData *data);
+        void  LoadAzElReady (int job, int i0, int i1);
+        void  LoadMpReady   (int job);
+        void  LoadFinished  ();
+
 private:
     QPixmap Buff;
     QImage MapImage;
@@ -230,6 +258,8 @@ private:
     solbuf_t SolData[2];
     solstatbuf_t SolStat[2];
     int SolIndex[2];
+    SOLLOD *SolLod[MAXSOLLOD];
+    int SolGen,SolLodNext;
     obs_t Obs;
     nav_t Nav;
     sta_t Sta;
@@ -254,8 +284,11 @@ private:
     int GEState,GEDataState[2];
     double GEHeading;
     
+    PlotLoader *Loader;
+    QStringList LoadFiles,PendingNavFiles;
+    int LoadFirst;
+    
     void  ReadSolStat  (const QStringList &files, int sel);
-    int   ReadObsRnx   (const QStringList &files, obs_t *obs, nav_t *nav, sta_t *sta);
     void  ReadMapTag   (const QString &file);
     void  ReadShapeFile(const QStringList &file);
     void  GenVisData   (void);
@@ -275,6 +308,8 @@ private:
     void  Reload       (void);
     void  ReadWaitStart(void);
     void  ReadWaitEnd  (void);
+    void  StartLoad    (const QStringList &obsfiles, const QStringList &navfiles);
+    void  StopLoad     (void);
     
     void  UpdateDisp   (void);
     void  UpdateType   (int type);
@@ -311,16 +346,17 @@ private:
     void  DrawTrkImage (QPainter &g,int level);
     void  DrawTrkMap   (QPainter &g,int level);
     void  DrawTrkPath  (QPainter &g,int level);
-    void  DrawTrkPnt   (QPainter &g,const TIMEPOS *pos, int level, int style);
+    void  DrawTrkPnt   (QPainter &g,const SOLLOD *lod, int level, int style);
     void  DrawTrkPos   (QPainter &g,const double *rr, int type, int siz, QColor color, const QString &label);
     void  DrawTrkStat  (QPainter &g,const TIMEPOS *pos, const QString &header, int p);
-    void  DrawTrkError (QPainter &g,const TIMEPOS *pos, int style);
+    void  DrawTrkError (QPainter &g,const TIMEPOS *pos, int style,
+                        const std::vector<int> *index=NULL);
     void  DrawTrkArrow (QPainter &g,const TIMEPOS *pos);
     void  DrawTrkVel   (QPainter &g,const TIMEPOS *vel);
     void  DrawLabel    (Graph *,QPainter &g, const QPoint &p, const QString &label, int ha, int va);
     void  DrawMark     (Graph *,QPainter &g, const QPoint &p, int mark, const QColor &color, int size, int rot);
     void  DrawSol      (QPainter &g,int level, int type);
-    void  DrawSolPnt   (QPainter &g,const TIMEPOS *pos, int level, int style);
+    void  DrawSolPnt   (QPainter &g,const SOLLOD *lod, int level, int style);
     void  DrawSolStat  (QPainter &g,const TIMEPOS *pos, const QString &unit, int p);
     void  DrawNsat     (QPainter &g,int level);
     void  DrawRes      (QPainter &g,int level);
@@ -340,6 +376,8 @@ private:
     
     TIMEPOS *  SolToPos (solbuf_t *sol, int index, int qflag, int type);
     TIMEPOS *  SolToNsat(solbuf_t *sol, int index, int qflag);
+    SOLLOD *   SolToLod (int sel, int qflag, int type);
+    void  ClearSolLod  (void);
     
     void  PosToXyz     (gtime_t time, const double *rr, int type, double *xyz);
     void  CovToXyz     (const double *rr, const float *qr, int type,
@@ -7,7 +7,7 @@
 QT       += widgets core gui xml
 
 greaterThan(QT_MAJOR_VERSION, 4) {
-    QT += widgets serialport
+    QT += widgets serialport concurrent
     DEFINES += QT5
 }
 
@@ -61,6 +61,8 @@ SOURCES += \
     plotdata.cpp \
     plotdraw.cpp \
     plotinfo.cpp \
+    plotload.cpp \
+    plotlod.cpp \
     plotmain.cpp \
     plotopt.cpp \
     pntdlg.cpp \
@@ -87,6 +89,8 @@ HEADERS  += \
     conndlg.h \
     geview.h \
     mapdlg.h \
+    plotload.h \
+    plotlod.h \
     plotmain.h \
     plotopt.h \
     pntdlg.h \
@@ -1066,7 +1066,7 @@ void __fastcall TOptDialog::ReadAntList(void)
 	RovAnt->Items=list;
 	RefAnt->Items=list;
 	
-	free(pcvs.pcv);
+	freepcv(&pcvs);
 }
 //---------------------------------------------------------------------------
 void __fastcall TOptDialog::BtnHelpClick(TObject *Sender)
@@ -1066,7 +1066,7 @@ void OptDialog::SetPos(int type, QLineEdit **edit, double *pos)
 void OptDialog::ReadAntList(void)
 {
     QString AntPcvFile_Text=AntPcvFile->text();
-    pcvs_t pcvs={0,0,0};
+    pcvs_t pcvs={0,0,0,0};
 	char *p;
 	
     if (!readpcv(qPrintable(AntPcvFile_Text),&pcvs)) return;
@@ -1085,7 +1085,7 @@ void OptDialog::ReadAntList(void)
         RefAnt->addItem(pcvs.pcv[i].type);
     }
 	
-	free(pcvs.pcv);
+	freepcv(&pcvs);
 }
 //---------------------------------------------------------------------------
 void OptDialog::BtnHelpClick()
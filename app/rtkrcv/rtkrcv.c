@@ -35,6 +35,11 @@
 *           2016/09/19 1.20 support multiple remote console connections
 *                           add option -w
 *           2017/09/01 1.21 add command ssr
+*           2026/10/17 1.22 support nav corrections allocated on demand
+*                           free antenna parameters by freepcv()
+*                           add option -mt for metrics address and port
+*                           add options misc-svrcpu,misc-svrsched,misc-svrprio,
+*                           misc-strcpu,misc-strsched,misc-strprio
 *-----------------------------------------------------------------------------*/
 #include <stdlib.h>
 #include <signal.h>
@@ -86,6 +91,7 @@ extern int pclose(FILE *);
 /* global variables ----------------------------------------------------------*/
 static rtksvr_t svr;                    /* rtk server struct */
 static stream_t moni;                   /* monitor stream */
+static metsvr_t metsvr;                 /* metrics server */
 
 static int intflg       =0;             /* interrupt flag (2:shtdown) */
 
@@ -115,9 +121,16 @@ static char stopcmd [MAXSTR]="";        /* stop command */
 static int modflgr[256] ={0};           /* modified flags of receiver options */
 static int modflgs[256] ={0};           /* modified flags of system options */
 static int moniport     =0;             /* monitor port */
+static char *metpath   ="";            /* metrics address and port */
 static int keepalive    =0;             /* keep alive flag */
 static int start        =0;             /* auto start */
 static int fswapmargin  =30;            /* file swap margin (s) */
+static int svrcpu       =-1;            /* rtk server thread cpu (-1:any) */
+static int svrsched     =0;             /* rtk server thread policy */
+static int svrprio      =50;            /* rtk server thread priority */
+static int strcpu       =-1;            /* stream threads cpu (-1:any) */
+static int strsched     =0;             /* stream threads policy */
+static int strprio      =10;            /* stream threads priority */
 static char sta_name[256]="";           /* station name */
 
 static prcopt_t prcopt;                 /* processing options */
@@ -126,11 +139,14 @@ static filopt_t filopt  ={""};          /* file options */
 
 /* help text -----------------------------------------------------------------*/
 static const char *usage[]={
-    "usage: rtkrcv [-s][-p port][-d dev][-o file][-w pwd][-r level][-t level][-sta sta]",
+    "usage: rtkrcv [-s][-p port][-m port][-mt [addr:]port][-d dev][-o file][-w pwd]",
+    "              [-r level][-t level][-sta sta]",
     "options",
     "  -s         start RTK server on program startup",
     "  -p port    port number for telnet console",
     "  -m port    port number for monitor stream",
+    "  -mt [addr:]port address (default 127.0.0.1) and port number for metrics",
+    "             (http GET /metrics or /metrics.json)",
     "  -d dev     terminal device for console",
     "  -o file    processing options file",
     "  -w pwd     login password for remote console (\"\": no password)",
@@ -183,8 +199,9 @@ static const char *pathopts[]={         /* path options help */
 #define OSTOPT  "0:off,1:serial,2:file,3:tcpsvr,4:tcpcli,6:ntripsvr,11:ntripc_c"
 #define FMTOPT  "0:rtcm2,1:rtcm3,2:oem4,3:oem3,4:ubx,5:swiftnav,6:hemis,7:skytraq,8:gw10,9:javad,10:nvs,11:binex,12:rt17,13:sbf,14:cmr,15:tersus,18:sp3"
 #define NMEOPT  "0:off,1:latlon,2:single"
-#define SOLOPT  "0:llh,1:xyz,2:enu,3:nmea,4:stat"
+#define SOLOPT  "0:llh,1:xyz,2:enu,3:nmea,4:stat,6:statb"
 #define MSGOPT  "0:all,1:rover,2:base,3:corr"
+#define SCHOPT  "0:other,1:fifo,2:rr"
 
 static opt_t rcvopts[]={
     {"console-passwd",  2,  (void *)passwd,              ""     },
@@ -226,6 +243,12 @@ static opt_t rcvopts[]={
     {"misc-navmsgsel",  3,  (void *)&navmsgsel,          MSGOPT },
     {"misc-proxyaddr",  2,  (void *)proxyaddr,           ""     },
     {"misc-fswapmargin",0,  (void *)&fswapmargin,        "s"    },
+    {"misc-svrcpu",     0,  (void *)&svrcpu,             "-1:any"},
+    {"misc-svrsched",   3,  (void *)&svrsched,           SCHOPT },
+    {"misc-svrprio",    0,  (void *)&svrprio,            "1-99" },
+    {"misc-strcpu",     0,  (void *)&strcpu,             "-1:any"},
+    {"misc-strsched",   3,  (void *)&strsched,           SCHOPT },
+    {"misc-strprio",    0,  (void *)&strprio,            "1-99" },
     
     {"misc-startcmd",   2,  (void *)startcmd,            ""     },
     {"misc-stopcmd",    2,  (void *)stopcmd,             ""     },
@@ -382,14 +405,27 @@ static void readant(vt_t *vt, prcopt_t *opt, nav_t *nav)
     else vt_printf(vt,"antenna file open error %s",filopt.rcvantp);
     
     if (readpcv(filopt.satantp,&pcvs)) {
-        for (i=0;i<MAXSAT;i++) {
+        for (i=0;i<MAXSAT&&allocnav(nav,0x100);i++) {
             if (!(pcv=searchpcv(i+1,"",time,&pcvs))) continue;
             nav->pcvs[i]=*pcv;
         }
     }
     else vt_printf(vt,"antenna file open error %s",filopt.satantp);
     
-    free(pcvr.pcv); free(pcvs.pcv);
+    freepcv(&pcvr); freepcv(&pcvs);
+}
+/* set thread options of rtk server and streams -----------------------------*/
+static void setthrdopts(void)
+{
+    thrdopt_t thopt={""};
+    
+    svr.thopt.cpu=svrcpu;
+    svr.thopt.policy=svrsched;
+    svr.thopt.prio=svrprio;
+    thopt.cpu=strcpu;
+    thopt.policy=strsched;
+    thopt.prio=strprio;
+    strsetthrd(&thopt);
 }
 /* start rtk server ----------------------------------------------------------*/
 static int startsvr(vt_t *vt)
@@ -455,6 +491,7 @@ static int startsvr(vt_t *vt)
     stropt[3]=buffsize;
     stropt[4]=fswapmargin;
     strsetopt(stropt);
+    setthrdopts();
     
     if (strfmt[2]==8) strfmt[2]=STRFMT_SP3;
     
@@ -634,12 +671,13 @@ static void prstatus(vt_t *vt)
          "PPP-kinema","PPP-static"
     };
     gtime_t eventime={0};
+    obs_t *obs;
     const char *freq[]={"-","L1","L1+L2","L1+L2+E5b","L1+L2+E5b+L5","",""};
     rtcm_t rtcm[3];
     int i,j,n,thread,cycle,state,rtkstat,nsat0,nsat1,prcout,rcvcount,tmcount,timevalid,nave;
-    int cputime,nb[3]={0},nmsg[3][10]={{0}};
+    int cputime,jitmax,nb[3]={0},nmsg[3][10]={{0}};
     char tstr[64],tmstr[64],s[1024],*p;
-    double runtime,rt[3]={0},dop[4]={0},rr[3],bl1=0.0,bl2=0.0;
+    double runtime,rt[3]={0},dop[4]={0},rr[3],bl1=0.0,bl2=0.0,jitave;
     double azel[MAXSAT*2],pos[3],vel[3],*del;
     
     trace(4,"prstatus:\n");
@@ -650,11 +688,13 @@ static void prstatus(vt_t *vt)
     cycle=svr.cycle;
     state=svr.state;
     rtkstat=svr.rtk.sol.stat;
-    nsat0=svr.obs[0][0].n;
-    nsat1=svr.obs[1][0].n;
+    nsat0=(obs=rtksvrobs(&svr,0))?obs->n:0;
+    nsat1=(obs=rtksvrobs(&svr,1))?obs->n:0;
     rcvcount = svr.raw[0].obs.rcvcount;
     tmcount = svr.raw[0].obs.tmcount;
     cputime=svr.cputime;
+    jitave=svr.njit>0?svr.jitsum/svr.njit:0.0;
+    jitmax=svr.jitmax;
     prcout=svr.prcout;
     nave=svr.nave;
     for (i=0;i<3;i++) nb[i]=svr.nb[i];
@@ -692,6 +732,7 @@ static void prstatus(vt_t *vt)
     vt_printf(vt,"%-28s: %s\n","frequencies",freq[rtk.opt.nf]);
     vt_printf(vt,"%-28s: %02.0f:%02.0f:%04.1f\n","accumulated time to run",rt[0],rt[1],rt[2]);
     vt_printf(vt,"%-28s: %d\n","cpu time for a cycle (ms)",cputime);
+    vt_printf(vt,"%-28s: %.0f,%d\n","cycle jitter avg,max (us)",jitave,jitmax);
     vt_printf(vt,"%-28s: %d\n","missing obs data count",prcout);
     vt_printf(vt,"%-28s: %d,%d\n","bytes in input buffer",nb[0],nb[1]);
     for (i=0;i<3;i++) {
@@ -824,17 +865,16 @@ static void prsatellite(vt_t *vt, int nf)
 static void probserv(vt_t *vt, int nf)
 {
     obsd_t obs[MAXOBS*2];
+    obs_t *cur;
     char tstr[64],id[32];
     int i,j,n=0,frq[]={1,2,5,7,8,6,9};
     
     trace(4,"probserv:\n");
     
     rtksvrlock(&svr);
-    for (i=0;i<svr.obs[0][0].n&&n<MAXOBS*2;i++) {
-        obs[n++]=svr.obs[0][0].data[i];
-    }
-    for (i=0;i<svr.obs[1][0].n&&n<MAXOBS*2;i++) {
-        obs[n++]=svr.obs[1][0].data[i];
+    for (j=0;j<2;j++) {
+        if (!(cur=rtksvrobs(&svr,j))) continue;
+        for (i=0;i<cur->n&&n<MAXOBS*2;i++) obs[n++]=cur->data[i];
     }
     rtksvrunlock(&svr);
     
@@ -938,7 +978,7 @@ static void prstream(vt_t *vt)
     };
     const char *fmt[]={"rtcm2","rtcm3","oem4","oem3","ubx","sbp","hemis","skytreq",
                        "gw10","javad","nvs","binex","rt17","sbf","cmr","trs","","","sp3",""};
-    const char *sol[]={"llh","xyz","enu","nmea","stat","-"};
+    const char *sol[]={"llh","xyz","enu","nmea","stat","-","statb"};
     stream_t stream[9];
     int i,format[9]={0};
     
@@ -968,14 +1008,14 @@ static void prssr(vt_t *vt)
 {
     static char buff[128*MAXSAT];
     gtime_t time;
-    ssr_t ssr[MAXSAT];
+    ssr_t ssr[MAXSAT],ssr0={{{0}}};
     int i,valid;
     char tstr[64],id[32],*p=buff;
     
     rtksvrlock(&svr);
     time=svr.rtk.sol.time;
     for (i=0;i<MAXSAT;i++) {
-        ssr[i]=svr.nav.ssr[i];
+        ssr[i]=svr.nav.ssr?svr.nav.ssr[i]:ssr0;
     }
     rtksvrunlock(&svr);
     
@@ -1523,9 +1563,15 @@ static void accept_sock(int ssock, con_t **con)
     trace(2,"remote console connection refused. addr=%s\n",
          inet_ntoa(addr.sin_addr));
 }
+/* output metrics of rtk server ---------------------------------------------*/
+static int outmetric(int fmt, char *buff, int nmax, void *arg)
+{
+    return rtksvrmetric((rtksvr_t *)arg,fmt,buff,nmax);
+}
 /* rtkrcv main -----------------------------------------------------------------
 * sysnopsis
-*     rtkrcv [-s][-p port][-d dev][-o file][-r level][-t level][-sta sta]
+*     rtkrcv [-s][-p port][-m port][-mt [addr:]port][-d dev][-o file][-r level]
+*            [-t level][-sta sta]
 *
 * description
 *     A command line version of the real-time positioning AP by rtklib. To start
@@ -1543,6 +1589,12 @@ static void accept_sock(int ssock, con_t **con)
 *     -s         start RTK server on program startup
 *     -p port    port number for telnet console
 *     -m port    port number for monitor stream
+*     -mt [addr:]port
+*                address and port number for metrics of rtk server and
+*                streams. the metrics are output in prometheus text format
+*                for http request GET /metrics and in json for GET
+*                /metrics.json. the server is bound to 127.0.0.1 if no
+*                address (0.0.0.0 for all interfaces)
 *     -d dev     terminal device for console
 *     -o file    processing options file
 *     -w pwd     login password for remote console ("": no password)
@@ -1637,6 +1689,7 @@ int main(int argc, char **argv)
         if      (!strcmp(argv[i],"-s")) start=1;
         else if (!strcmp(argv[i],"-p")&&i+1<argc) port=atoi(argv[++i]);
         else if (!strcmp(argv[i],"-m")&&i+1<argc) moniport=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-mt")&&i+1<argc) metpath=argv[++i];
         else if (!strcmp(argv[i],"-d")&&i+1<argc) dev=argv[++i];
         else if (!strcmp(argv[i],"-o")&&i+1<argc) strcpy(file,argv[++i]);
         else if (!strcmp(argv[i],"-w")&&i+1<argc) strcpy(passwd,argv[++i]);
@@ -1661,18 +1714,23 @@ int main(int argc, char **argv)
         fprintf(stderr,"no options file: %s. defaults used\n",file);
     }
     getsysopts(&prcopt,solopt,&filopt);
+    setthrdopts();
     
     /* read navigation data */
     if (!readnav(NAVIFILE,&svr.nav)) {
         fprintf(stderr,"no navigation data: %s\n",NAVIFILE);
     }
     if (outstat>0) {
-        rtkopenstat(STATFILE,outstat);
+        rtkopenstatf(STATFILE,outstat,solopt[0].sstatf);
     }
     /* open monitor port */
     if (moniport>0&&!openmoni(moniport)) {
         fprintf(stderr,"monitor port open error: %d\n",moniport);
     }
+    /* start metrics server */
+    if (*metpath&&!metsvrstart(&metsvr,metpath,outmetric,&svr)) {
+        fprintf(stderr,"metrics port open error: %s\n",metpath);
+    }
     if (port) {
         /* open socket for remote console */
         if ((sock=open_sock(port))<=0) {
@@ -1707,6 +1765,8 @@ int main(int argc, char **argv)
     /* stop rtk server */
     stopsvr(NULL);
     
+    if (*metpath) metsvrstop(&metsvr);
+    
     /* close consoles */
     for (i=0;i<MAXCON;i++) {
         con_close(con[i]);
@@ -27,6 +27,9 @@
 *           2016/09/06  1.15 add reload soure table by USR2 signal
 *           2016/09/17  1.16 add option -b
 *           2017/05/26  1.17 add input format tersus
+*           2026/10/17  1.18 add option -mt
+*                            add option -cpu,-prio,-rr
+*                            bind metrics server to loopback by default
 *-----------------------------------------------------------------------------*/
 #include <signal.h>
 #include <unistd.h>
@@ -38,6 +41,7 @@
 
 /* global variables ----------------------------------------------------------*/
 static strsvr_t strsvr;                /* stream server */
+static metsvr_t metsvr;                /* metrics server */
 static volatile int intrflg=0;         /* interrupt flag */
 static char srctbl[1024]="";           /* source table file */
 
@@ -112,11 +116,21 @@ static const char *help[]={
 " -l  local_dir     ftp/http local directory []",
 " -x  proxy_addr    http/ntrip proxy address [no]",
 " -b  str_no        relay back messages from output str to input str [no]",
+" -mt [addr:]port   metrics address (default 127.0.0.1) and port",
+"                   (http GET /metrics or /metrics.json) [no]",
+" -cpu cpu[,cpu]    cpu affinity of server[,stream] threads (-1:any) [-1]",
+" -prio prio[,prio] real-time priority of server[,stream] threads (1-99) [no]",
+" -rr               real-time policy round-robin instead of fifo [no]",
 " -t  level         trace level [0]",
 " -ft file          ntrip souce table file []",
 " -fl file          log file [str2str.trace]",
 " -h                print help",
 };
+/* output metrics of stream server ------------------------------------------*/
+static int outmetric(int fmt, char *buff, int nmax, void *arg)
+{
+    return strsvrmetric((strsvr_t *)arg,fmt,buff,nmax);
+}
 /* print help ----------------------------------------------------------------*/
 static void printhelp(void)
 {
@@ -225,10 +239,12 @@ int main(int argc, char **argv)
     char *cmdfile[MAXSTR]={"","","","",""},*cmds[MAXSTR],*cmds_periodic[MAXSTR];
     char *local="",*proxy="",*msg="1004,1019",*opt="",buff[256],*p;
     char strmsg[MAXSTRMSG]="",*antinfo="",*rcvinfo="";
-    char *ant[]={"","",""},*rcv[]={"","",""},*logfile="";
+    char *ant[]={"","",""},*rcv[]={"","",""},*logfile="",*metpath="";
     int i,j,n=0,dispint=5000,trlevel=0,opts[]={10000,10000,2000,32768,10,0,30,0};
     int types[MAXSTR]={STR_FILE,STR_FILE},stat[MAXSTR]={0},byte[MAXSTR]={0};
     int bps[MAXSTR]={0},fmts[MAXSTR]={0},sta=0;
+    int cpu[2]={-1,-1},prio[2]={0},policy=THRDPOL_FIFO;
+    thrdopt_t thopt={""};
     
     for (i=0;i<MAXSTR;i++) {
         paths[i]=s[i];
@@ -277,6 +293,14 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i],"-l"  )&&i+1<argc) local=argv[++i];
         else if (!strcmp(argv[i],"-x"  )&&i+1<argc) proxy=argv[++i];
         else if (!strcmp(argv[i],"-b"  )&&i+1<argc) opts[7]=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-mt" )&&i+1<argc) metpath=argv[++i];
+        else if (!strcmp(argv[i],"-cpu")&&i+1<argc) {
+            sscanf(argv[++i],"%d,%d",cpu,cpu+1);
+        }
+        else if (!strcmp(argv[i],"-prio")&&i+1<argc) {
+            sscanf(argv[++i],"%d,%d",prio,prio+1);
+        }
+        else if (!strcmp(argv[i],"-rr" )) policy=THRDPOL_RR;
         else if (!strcmp(argv[i],"-ft" )&&i+1<argc) strcpy(srctbl,argv[++i]);
         else if (!strcmp(argv[i],"-fl" )&&i+1<argc) logfile=argv[++i];
         else if (!strcmp(argv[i],"-t"  )&&i+1<argc) trlevel=atoi(argv[++i]);
@@ -318,6 +342,15 @@ int main(int argc, char **argv)
     
     strsvrinit(&strsvr,n+1);
     
+    /* set thread options of stream server and streams */
+    strsvr.thopt.cpu=cpu[0];
+    strsvr.thopt.policy=prio[0]>0?policy:THRDPOL_OTHER;
+    strsvr.thopt.prio=prio[0];
+    thopt.cpu=cpu[1];
+    thopt.policy=prio[1]>0?policy:THRDPOL_OTHER;
+    thopt.prio=prio[1];
+    strsetthrd(&thopt);
+    
     if (trlevel>0) {
         traceopen(*logfile?logfile:TRFILE);
         tracelevel(trlevel);
@@ -341,6 +374,10 @@ int main(int argc, char **argv)
         strsvrsetsrctbl(&strsvr,srctbl);
         signal(SIGUSR2,reload_srctbl);
     }
+    /* start metrics server */
+    if (*metpath&&!metsvrstart(&metsvr,metpath,outmetric,&strsvr)) {
+        fprintf(stderr,"metrics port open error: %s\n",metpath);
+    }
     for (intrflg=0;!intrflg;) {
         
         /* get stream server status */
@@ -357,9 +394,14 @@ int main(int argc, char **argv)
     for (i=0;i<MAXSTR;i++) {
         if (*cmdfile[i]) readcmd(cmdfile[i],cmds[i],1);
     }
-    /* stop stream server */
+    /* stop metrics and stream server */
+    if (*metpath) metsvrstop(&metsvr);
     strsvrstop(&strsvr,cmds);
     
+    fprintf(stderr,"cycle jitter avg=%.0f us max=%d us (%u cycles)\n",
+            strsvr.njit>0?strsvr.jitsum/strsvr.njit:0.0,strsvr.jitmax,
+            strsvr.njit);
+    
     for (i=0;i<n;i++) {
         strconvfree(conv[i]);
     }
@@ -33,12 +33,24 @@
 *                           scan_obstype()
 *           2018/10/10 1.14 add trace of half-cycle ambiguity status
 *                           fix bug on missing navigation data
+*           2026/10/17 1.15 support single-pass conversion with scanning obs
+*                           types (opt->scanobs=2)
+*                           support parallel decoding of rtcm 3 and rinex
+*                           input files (opt->nthread)
+*                           support compact rinex and gzip output
+*                           (opt->crinex,opt->gzip)
+*                           report errors of decoder threads by main thread
+*                           fix format of site occupation event record
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
 #define NOUTFILE        9       /* number of output files */
 #define NSATSYS         7       /* number of satellite systems */
 #define TSTARTMARGIN    60.0    /* time margin for file name replacement */
+#define MAXTHREAD       64      /* max number of conversion threads */
+#define SPOOL_STATE     -3      /* spooled decoder state at end of file */
+#define BOUND_TAIL      1       /* decoder state at end of file not spooled */
+#define BOUND_HEAD      2       /* file decoded by state of previous file */
 
 #define TL_HALFC        4       /* trace level for half-cyc ambiguity status */
 
@@ -73,8 +85,59 @@ typedef struct {                /* stream file type */
     raw_t  raw;                 /* receiver raw data */
     rnxctr_t rnx;               /* rinex data */
     FILE   *fp;                 /* file pointer */
+    FILE   *sfp;                /* decoded message spool (NULL: not used) */
+    char   *msg;                /* error message buffer (NULL: showmsg) */
 } strfile_t;
 
+typedef struct {                /* spooled message header type */
+    int    type;                /* message type */
+    int    sat;                 /* satellite number */
+    int    n;                   /* number of obs data */
+    int    flag;                /* epoch flag */
+    int    staid;               /* station id */
+    int    msg;                 /* rtcm message number of station info */
+    int    nlock;               /* number of lock records after message */
+    gtime_t time;               /* message time */
+} spoolh_t;
+
+typedef struct {                /* spooled lock record type */
+    int    sat;                 /* satellite number */
+    int    slot;                /* obs data index of signal */
+    int    lock;                /* rtcm 3 lock time indicator */
+} spoolk_t;
+
+typedef struct {                /* nav header parameters type */
+    double utc_gps[4],utc_glo[4],utc_gal[4],utc_qzs[4]; /* utc parameters */
+    double utc_cmp[4],utc_irn[4],utc_sbs[4];
+    double ion_gps[8],ion_gal[4],ion_qzs[8]; /* iono model parameters */
+    double ion_cmp[8],ion_irn[8];
+    int    leaps;               /* leap seconds (s) */
+    char   glo_fcn[MAXPRNGLO+1]; /* glonass frequency channel number + 8 */
+} navpar_t;
+
+typedef struct convp_tag {      /* parallel conversion control type */
+    int    format;              /* stream format (STRFMT_???) */
+    const char *rcvopt;         /* receiver options */
+    gtime_t time0;              /* decoder time of first file */
+    gtime_t time;               /* approx log start time */
+    char   **files;             /* input files */
+    struct convf_tag *file;     /* decoders of input files */
+    int    nf;                  /* number of input files */
+    int    nthread;             /* number of decoder threads */
+    int    abort;               /* abort flag */
+    lock_t lock;                /* lock flag */
+} convp_t;
+
+typedef struct convf_tag {      /* input file decoder type */
+    convp_t *cp;                /* parallel conversion control */
+    int    k;                   /* index of input file */
+    int    run;                 /* status (0:not started,1:running,2:done) */
+    thread_t thread;            /* decoder thread */
+    FILE   *spool;              /* decoded message spool (NULL: error) */
+    int    bound;               /* state at file boundary (BOUND_???) */
+    char   msg[MAXERRMSG];      /* decode error message */
+} convf_t;
+
 /* global variables ----------------------------------------------------------*/
 static const int navsys[]={     /* system codes */
     SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN,0
@@ -277,8 +340,23 @@ static void raw2opt(const raw_t *raw, rnxopt_t *opt)
         opt->antdel[2]=0.0;
     }
 }
+/* show or save error message ------------------------------------------------
+* buff has MAXERRMSG bytes. string arguments of format must be bounded as %.900s
+*-----------------------------------------------------------------------------*/
+static void errmsg(char *buff, const char *format, ...)
+{
+    va_list ap;
+    char msg[MAXERRMSG];
+    
+    va_start(ap,format); vsprintf(msg,format,ap); va_end(ap);
+    
+    trace(2,"%s\n",msg);
+    
+    if (buff) sprintf(buff,"%.*s",MAXERRMSG-1,msg); else showmsg("%s",msg);
+}
 /* generate stream file ------------------------------------------------------*/
-static strfile_t *gen_strfile(int format, const char *opt, gtime_t time)
+static strfile_t *gen_strfile(int format, const char *opt, gtime_t time,
+                              char *msg)
 {
     strfile_t *str;
     
@@ -288,7 +366,8 @@ static strfile_t *gen_strfile(int format, const char *opt, gtime_t time)
     
     if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
         if (!init_rtcm(&str->rtcm)) {
-            showmsg("init rtcm error");
+            errmsg(msg,"init rtcm error");
+            free(str);
             return 0;
         }
         str->rtcm.time=time;
@@ -298,7 +377,8 @@ static strfile_t *gen_strfile(int format, const char *opt, gtime_t time)
     }
     else if (format<=MAXRCVFMT) {
         if (!init_raw(&str->raw,format)) {
-            showmsg("init raw error");
+            errmsg(msg,"init raw error");
+            free(str);
             return 0;
         }
         str->raw.time=time;
@@ -308,7 +388,8 @@ static strfile_t *gen_strfile(int format, const char *opt, gtime_t time)
     }
     else if (format==STRFMT_RINEX) {
         if (!init_rnxctr(&str->rnx)) {
-            showmsg("init rnx error");
+            errmsg(msg,"init rnx error");
+            free(str);
             return 0;
         }
         str->obs=&str->rnx.obs;
@@ -318,6 +399,7 @@ static strfile_t *gen_strfile(int format, const char *opt, gtime_t time)
     str->format=format;
     str->sat=0;
     str->fp=NULL;
+    str->msg=msg;
     return str;
 }
 /* free stream file ----------------------------------------------------------*/
@@ -336,6 +418,341 @@ static void free_strfile(strfile_t *str)
     }
     free(str);
 }
+/* save nav header parameters -----------------------------------------------*/
+static void save_navpar(const nav_t *nav, navpar_t *par)
+{
+    memcpy(par->utc_gps,nav->utc_gps,sizeof(par->utc_gps));
+    memcpy(par->utc_glo,nav->utc_glo,sizeof(par->utc_glo));
+    memcpy(par->utc_gal,nav->utc_gal,sizeof(par->utc_gal));
+    memcpy(par->utc_qzs,nav->utc_qzs,sizeof(par->utc_qzs));
+    memcpy(par->utc_cmp,nav->utc_cmp,sizeof(par->utc_cmp));
+    memcpy(par->utc_irn,nav->utc_irn,sizeof(par->utc_irn));
+    memcpy(par->utc_sbs,nav->utc_sbs,sizeof(par->utc_sbs));
+    memcpy(par->ion_gps,nav->ion_gps,sizeof(par->ion_gps));
+    memcpy(par->ion_gal,nav->ion_gal,sizeof(par->ion_gal));
+    memcpy(par->ion_qzs,nav->ion_qzs,sizeof(par->ion_qzs));
+    memcpy(par->ion_cmp,nav->ion_cmp,sizeof(par->ion_cmp));
+    memcpy(par->ion_irn,nav->ion_irn,sizeof(par->ion_irn));
+    memcpy(par->glo_fcn,nav->glo_fcn,sizeof(par->glo_fcn));
+    par->leaps=nav->leaps;
+}
+/* update parameters if decoded ----------------------------------------------*/
+static void update_par(double *dst, const double *src, int n)
+{
+    if (norm(src,n)>0.0) matcpy(dst,src,n,1);
+}
+/* load nav header parameters ------------------------------------------------*/
+static void load_navpar(const navpar_t *par, nav_t *nav)
+{
+    int i;
+    
+    update_par(nav->utc_gps,par->utc_gps,4);
+    update_par(nav->utc_glo,par->utc_glo,4);
+    update_par(nav->utc_gal,par->utc_gal,4);
+    update_par(nav->utc_qzs,par->utc_qzs,4);
+    update_par(nav->utc_cmp,par->utc_cmp,4);
+    update_par(nav->utc_irn,par->utc_irn,4);
+    update_par(nav->utc_sbs,par->utc_sbs,4);
+    update_par(nav->ion_gps,par->ion_gps,8);
+    update_par(nav->ion_gal,par->ion_gal,4);
+    update_par(nav->ion_qzs,par->ion_qzs,8);
+    update_par(nav->ion_cmp,par->ion_cmp,8);
+    update_par(nav->ion_irn,par->ion_irn,8);
+    for (i=0;i<=MAXPRNGLO;i++) {
+        if (par->glo_fcn[i]) nav->glo_fcn[i]=par->glo_fcn[i];
+    }
+    if (par->leaps) nav->leaps=par->leaps;
+}
+/* station info in stream file -----------------------------------------------*/
+static sta_t *strfile_sta(strfile_t *str)
+{
+    if (str->format==STRFMT_RTCM2||str->format==STRFMT_RTCM3) {
+        return &str->rtcm.sta;
+    }
+    else if (str->format<=MAXRCVFMT) {
+        return &str->raw.sta;
+    }
+    return &str->rnx.sta;
+}
+/* write lock records ----------------------------------------------------------
+* count (fp=NULL) or write lock records of rtcm 3 decoder. if obs is set,
+* records of signals first seen in the file are written and marked as seen.
+* otherwise records of all seen signals are written.
+*-----------------------------------------------------------------------------*/
+static int write_lock(const rtcm_t *rtcm, const obs_t *obs,
+                      unsigned char seen[][NFREQ+NEXOBS], FILE *fp)
+{
+    spoolk_t k;
+    int i,j,n=0;
+    
+    for (i=0;i<(obs?obs->n:MAXSAT);i++) {
+        k.sat=obs?obs->data[i].sat:i+1;
+        if (k.sat<1||k.sat>MAXSAT) continue;
+        
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            if (obs&&(obs->data[i].code[j]==CODE_NONE||seen[k.sat-1][j])) {
+                continue;
+            }
+            if (!obs&&!seen[k.sat-1][j]) continue;
+            n++;
+            if (!fp) continue;
+            k.slot=j;
+            k.lock=rtcm->lock[k.sat-1][j];
+            if (fwrite(&k,sizeof(k),1,fp)<1) return -1;
+            seen[k.sat-1][j]=1;
+        }
+    }
+    return n;
+}
+/* spool decoded message -------------------------------------------------------
+* write a decoded message of stream file to spool file. data referred by
+* convobs(), convnav(), convsbs(), convlex() and update_stas() are written
+* after the message header. messages of type 0 are not written.
+* if seen is set, lock records of rtcm 3 decoder are written after obs data
+* and the decoder state at end of file.
+*-----------------------------------------------------------------------------*/
+static int spool_msg(strfile_t *str, FILE *fp, int type,
+                     unsigned char seen[][NFREQ+NEXOBS])
+{
+    spoolh_t h={0};
+    navpar_t par;
+    int sys,prn,stat;
+    
+    h.type=type;
+    h.sat=str->sat;
+    h.time=str->time;
+    h.staid=str->rtcm.staid;
+    if (type==1) {
+        h.n=str->obs->n;
+        h.flag=str->obs->flag;
+    }
+    if (seen&&(type==1||type==SPOOL_STATE)) {
+        h.nlock=write_lock(&str->rtcm,type==1?str->obs:NULL,seen,NULL);
+    }
+    if (type==5&&str->format==STRFMT_RTCM3) {
+        h.msg=(int)getbitu(str->rtcm.buff,24,12);
+    }
+    if (fwrite(&h,sizeof(h),1,fp)<1) return 0;
+    
+    switch (type) {
+        case 1:
+            stat=fwrite(str->obs->data,sizeof(obsd_t),h.n,fp)==(size_t)h.n;
+            if (seen) {
+                stat&=write_lock(&str->rtcm,str->obs,seen,fp)==h.nlock;
+            }
+            break;
+        case 2:
+            sys=satsys(str->sat,&prn);
+            if (sys==SYS_GLO) {
+                stat=fwrite(str->nav->geph+prn-1,sizeof(geph_t),1,fp)==1;
+            }
+            else if (sys==SYS_SBS) {
+                stat=fwrite(str->nav->seph+prn-MINPRNSBS,sizeof(seph_t),1,fp)==1;
+            }
+            else {
+                stat=fwrite(str->nav->eph+str->sat-1,sizeof(eph_t),1,fp)==1;
+            }
+            break;
+        case 3:
+            stat=fwrite(&str->raw.sbsmsg,sizeof(sbsmsg_t),1,fp)==1;
+            break;
+        case 31:
+            stat=fwrite(&str->raw.lexmsg,sizeof(lexmsg_t),1,fp)==1;
+            break;
+        case 5:
+            stat=fwrite(&str->rtcm.sta,sizeof(sta_t),1,fp)==1;
+            break;
+        case 9:
+        case SPOOL_STATE:
+            save_navpar(str->nav,&par);
+            stat=fwrite(&par,sizeof(par),1,fp)==1;
+            if (type==SPOOL_STATE) {
+                stat&=fwrite(strfile_sta(str),sizeof(sta_t),1,fp)==1;
+            }
+            if (type==SPOOL_STATE&&seen) {
+                stat&=write_lock(&str->rtcm,NULL,seen,fp)==h.nlock;
+            }
+            break;
+        default:
+            stat=1;
+            break;
+    }
+    return stat;
+}
+/* receiver options in stream file -----------------------------------------*/
+static const char *strfile_opt(const strfile_t *str)
+{
+    if (str->format==STRFMT_RTCM2||str->format==STRFMT_RTCM3) {
+        return str->rtcm.opt;
+    }
+    else if (str->format<=MAXRCVFMT) {
+        return str->raw.opt;
+    }
+    return str->rnx.opt;
+}
+/* read spooled ephemeris ------------------------------------------------------
+* the decoder of a file outputs the first ephemeris of a satellite in the file.
+* for rtcm 3, it is discarded (*dup=1) if unchanged from the previous one by the
+* test of the rtcm 3 decoder without option -EPHALL.
+*-----------------------------------------------------------------------------*/
+static int read_spool_eph(strfile_t *str, int sat, int *dup)
+{
+    eph_t eph,*e;
+    geph_t geph,*g;
+    seph_t seph;
+    int sys,prn,test;
+    
+    sys=satsys(sat,&prn);
+    test=str->format==STRFMT_RTCM3&&!strstr(strfile_opt(str),"-EPHALL");
+    *dup=0;
+    
+    if (sys==SYS_GLO) {
+        if (fread(&geph,sizeof(geph_t),1,str->sfp)<1) return 0;
+        g=str->nav->geph+prn-1;
+        *dup=test&&fabs(timediff(geph.toe,g->toe))<1.0&&geph.svh==g->svh;
+        if (!*dup) *g=geph;
+    }
+    else if (sys==SYS_SBS) {
+        if (fread(&seph,sizeof(seph_t),1,str->sfp)<1) return 0;
+        str->nav->seph[prn-MINPRNSBS]=seph;
+    }
+    else {
+        if (fread(&eph,sizeof(eph_t),1,str->sfp)<1) return 0;
+        e=str->nav->eph+sat-1;
+        if (test&&eph.iode==e->iode) {
+            if (sys==SYS_QZS) *dup=eph.iodc==e->iodc;
+            else if (sys==SYS_CMP) {
+                *dup=eph.iodc==e->iodc&&timediff(eph.toe,e->toe)==0.0;
+            }
+            else *dup=1;
+        }
+        if (!*dup) *e=eph;
+    }
+    return 1;
+}
+/* read spooled lock records ---------------------------------------------------
+* if obs is set, loss-of-lock indicators of signals first seen in the file are
+* set by the lock times at end of the previous file as the rtcm 3 decoder.
+* otherwise lock times at end of the file are saved for the next file.
+*-----------------------------------------------------------------------------*/
+static int read_spool_lock(strfile_t *str, int n, obs_t *obs)
+{
+    spoolk_t k;
+    unsigned short *lock;
+    int i,j;
+    
+    for (i=0;i<n;i++) {
+        if (fread(&k,sizeof(k),1,str->sfp)<1||k.sat<1||k.sat>MAXSAT||
+            k.slot<0||k.slot>=NFREQ+NEXOBS) return 0;
+        
+        lock=&str->rtcm.lock[k.sat-1][k.slot];
+        if (!obs) {
+            *lock=(unsigned short)k.lock;
+            continue;
+        }
+        for (j=0;j<obs->n;j++) {
+            if (obs->data[j].sat!=k.sat) continue;
+            obs->data[j].LLI[k.slot]&=~LLI_SLIP;
+            obs->data[j].LLI[k.slot]|=(!k.lock&&!*lock)||k.lock<*lock;
+            break;
+        }
+    }
+    return 1;
+}
+/* update station info by rtcm 3 message -------------------------------------*/
+static void update_sta(sta_t *dst, const sta_t *src, int msg)
+{
+    switch (msg) {
+        case 1005:
+        case 1006:
+            dst->deltype=src->deltype;
+            matcpy(dst->pos,src->pos,3,1);
+            matcpy(dst->del,src->del,3,1);
+            dst->hgt=src->hgt;
+            dst->itrf=src->itrf;
+            break;
+        case 1007:
+        case 1008:
+        case 1033:
+            strcpy(dst->antdes,src->antdes);
+            strcpy(dst->antsno,src->antsno);
+            dst->antsetup=src->antsetup;
+            if (msg!=1033) break;
+            strcpy(dst->rectype,src->rectype);
+            strcpy(dst->recver ,src->recver );
+            strcpy(dst->recsno ,src->recsno );
+            break;
+        default:
+            *dst=*src;
+            break;
+    }
+}
+/* input spooled message -----------------------------------------------------*/
+static int input_spool(strfile_t *str)
+{
+    spoolh_t h;
+    navpar_t par;
+    sta_t sta,*p;
+    int dup,stat=1;
+    
+    for (;;) {
+        if (fread(&h,sizeof(h),1,str->sfp)<1) return -2;
+        
+        if (h.type!=SPOOL_STATE) break;
+        
+        /* restore decoder state at end of file */
+        if (fread(&par,sizeof(par),1,str->sfp)<1||
+            fread(&sta,sizeof(sta),1,str->sfp)<1) return -2;
+        load_navpar(&par,str->nav);
+        
+        /* station info of rtcm 3 is updated by each message */
+        if (str->format!=STRFMT_RTCM3&&(*sta.name||*sta.marker||*sta.antdes||
+            *sta.rectype||norm(sta.pos,3)>0.0)) {
+            p=strfile_sta(str);
+            *p=sta;
+        }
+        if (!read_spool_lock(str,h.nlock,NULL)) return -2;
+    }
+    if (h.type>=1) {
+        str->time=h.time;
+        str->sat=h.sat;
+    }
+    str->rtcm.staid=h.staid;
+    
+    switch (h.type) {
+        case 1:
+            if (h.n<0||h.n>MAXOBS) return -2;
+            stat=fread(str->obs->data,sizeof(obsd_t),h.n,str->sfp)==(size_t)h.n;
+            str->obs->n=h.n;
+            if (h.flag) str->obs->flag=h.flag; /* cleared by convobs() */
+            if (stat) stat=read_spool_lock(str,h.nlock,str->obs);
+            break;
+        case 2:
+            if (!(stat=read_spool_eph(str,h.sat,&dup))) break;
+            
+            /* decoders of later files output the same ephemeris again */
+            if (dup) h.type=0;
+            break;
+        case 3:
+            stat=fread(&str->raw.sbsmsg,sizeof(sbsmsg_t),1,str->sfp)==1;
+            break;
+        case 31:
+            stat=fread(&str->raw.lexmsg,sizeof(lexmsg_t),1,str->sfp)==1;
+            break;
+        case 5:
+            if ((stat=fread(&sta,sizeof(sta_t),1,str->sfp)==1)) {
+                update_sta(&str->rtcm.sta,&sta,h.msg);
+            }
+            str->rtcm.time=h.time;
+            break;
+        case 9:
+            if ((stat=fread(&par,sizeof(par),1,str->sfp)==1)) {
+                load_navpar(&par,str->nav);
+            }
+            break;
+    }
+    return stat?h.type:-2;
+}
 /* input stream file ---------------------------------------------------------*/
 static int input_strfile(strfile_t *str)
 {
@@ -343,7 +760,10 @@ static int input_strfile(strfile_t *str)
     
     trace(4,"input_strfile:\n");
     
-    if (str->format==STRFMT_RTCM2) {
+    if (str->sfp) {
+        type=input_spool(str);
+    }
+    else if (str->format==STRFMT_RTCM2) {
         if ((type=input_rtcm2f(&str->rtcm,str->fp))>=1) {
             str->time=str->rtcm.time;
             str->sat=str->rtcm.ephsat;
@@ -378,13 +798,13 @@ static int open_strfile(strfile_t *str, const char *file)
     
     if (str->format==STRFMT_RTCM2||str->format==STRFMT_RTCM3) {
         if (!(str->fp=fopen(file,"rb"))) {
-            showmsg("rtcm open error: %s",file);
+            errmsg(str->msg,"rtcm open error: %.900s",file);
             return 0;
         }
     }
     else if (str->format<=MAXRCVFMT) {
         if (!(str->fp=fopen(file,"rb"))) {
-            showmsg("log open error: %s",file);
+            errmsg(str->msg,"log open error: %.900s",file);
             return 0;
         }
         /* read head to resolve time ambiguity */
@@ -397,12 +817,12 @@ static int open_strfile(strfile_t *str, const char *file)
     }
     else if (str->format==STRFMT_RINEX) {
         if (!(str->fp=fopen(file,"r"))) {
-            showmsg("rinex open error: %s",file);
+            errmsg(str->msg,"rinex open error: %.900s",file);
             return 0;
         }
         /* open rinex control */
         if (!open_rnxctr(&str->rnx,str->fp)) {
-            showmsg("no rinex file: %s",file);
+            errmsg(str->msg,"no rinex file: %.900s",file);
             fclose(str->fp);
             return 0;
         }
@@ -586,6 +1006,59 @@ static void resolve_halfc(halfc_t *halfc, obsd_t *obs)
         }
     }
 }
+/* scan observation types in obs epoch --------------------------------------*/
+static void scan_obs(const obs_t *obs, unsigned char codes[][33],
+                     unsigned char types[][33], int *n, halfc_t *halfc)
+{
+    int i,j,k,l,sys;
+    
+    for (i=0;i<obs->n;i++) {
+        sys=satsys(obs->data[i].sat,NULL);
+        for (l=0;navsys[l];l++) if (navsys[l]==sys) break;
+        if (!navsys[l]) continue;
+        
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            if (!obs->data[i].code[j]) continue;
+            
+            for (k=0;k<n[l];k++) {
+                if (codes[l][k]==obs->data[i].code[j]) break;
+            }
+            if (k>=n[l]&&n[l]<32) {
+                codes[l][n[l]++]=obs->data[i].code[j];
+            }
+            if (k<n[l]) {
+                if (obs->data[i].P[j]!=0.0) types[l][k]|=1;
+                if (obs->data[i].L[j]!=0.0) types[l][k]|=2;
+                if (obs->data[i].D[j]!=0.0) types[l][k]|=4;
+                if (obs->data[i].SNR[j]!=0) types[l][k]|=8;
+            }
+        }
+        /* update half-cycle ambiguity status */
+        update_halfc(halfc,obs->data+i);
+    }
+}
+/* set scanned observation types in rinex option -----------------------------*/
+static void setopt_scanned(unsigned char codes[][33], unsigned char types[][33],
+                           const int *n, rnxopt_t *opt)
+{
+    int i,j;
+    
+    for (i=0;i<NSATSYS;i++) for (j=0;j<n[i];j++) {
+		trace(2,"scan_obstype: sys=%d code=%s type=%d\n",i,code2obs(codes[i][j],NULL),types[i][j]);
+    }
+    for (i=0;i<NSATSYS;i++) {
+        
+        /* sort codes */
+        sort_codes(codes[i],types[i],n[i]);
+        
+        /* set observation types in rinex option */
+        setopt_obstype(codes[i],types[i],i,opt);
+        
+        for (j=0;j<n[i];j++) {
+            trace(3,"scan_obstype: sys=%d code=%s\n",i,code2obs(codes[i][j],NULL));
+        }
+    }
+}
 /* scan observation types and station parameters -----------------------------*/
 static int scan_obstype(int format, char **files, int nf, rnxopt_t *opt,
                         stas_t **stas, halfc_t *halfc, gtime_t *time)
@@ -594,11 +1067,11 @@ static int scan_obstype(int format, char **files, int nf, rnxopt_t *opt,
     unsigned char codes[NSATSYS][33]={{0}};
     unsigned char types[NSATSYS][33]={{0}};
     char msg[128];
-    int i,j,k,l,m,c=0,type,sys,abort=0,n[NSATSYS]={0};
+    int m,c=0,type,abort=0,n[NSATSYS]={0};
     
     trace(3,"scan_obstype: nf=%d, opt=%s\n",nf,opt);
     
-    if (!(str=gen_strfile(format,opt->rcvopt,*time))) return 0;
+    if (!(str=gen_strfile(format,opt->rcvopt,*time,NULL))) return 0;
     
     for (m=0;m<nf&&!abort;m++) {
         
@@ -615,31 +1088,9 @@ static int scan_obstype(int format, char **files, int nf, rnxopt_t *opt,
             if (type!=1||str->obs->n<=0) continue;
             
             if (!opt->ts.time||timediff(str->obs->data[0].time,opt->ts)>=0.001) {
-                 
-                for (i=0;i<str->obs->n;i++) {
-                    sys=satsys(str->obs->data[i].sat,NULL);
-                    for (l=0;navsys[l];l++) if (navsys[l]==sys) break;
-                    if (!navsys[l]) continue;
-                    
-                    for (j=0;j<NFREQ+NEXOBS;j++) {
-                        if (!str->obs->data[i].code[j]) continue;
-                        
-                        for (k=0;k<n[l];k++) {
-                            if (codes[l][k]==str->obs->data[i].code[j]) break;
-                        }
-                        if (k>=n[l]&&n[l]<32) {
-                            codes[l][n[l]++]=str->obs->data[i].code[j];
-                        }
-                        if (k<n[l]) {
-                            if (str->obs->data[i].P[j]!=0.0) types[l][k]|=1;
-                            if (str->obs->data[i].L[j]!=0.0) types[l][k]|=2;
-                            if (str->obs->data[i].D[j]!=0.0) types[l][k]|=4;
-                            if (str->obs->data[i].SNR[j]!=0) types[l][k]|=8;
-                        }
-                    }
-                    /* update half-cycle ambiguity status */
-                    update_halfc(halfc,str->obs->data+i);
-                }
+                
+                scan_obs(str->obs,codes,types,n,halfc);
+                
                 if (!time->time) *time=str->obs->data[0].time;
             }
             if (opt->te.time&&timediff(str->obs->data[0].time,opt->te)>10.0) break;
@@ -661,21 +1112,7 @@ static int scan_obstype(int format, char **files, int nf, rnxopt_t *opt,
         trace(2,"aborted in scan\n");
         return 0;
     }
-    for (i=0;i<NSATSYS;i++) for (j=0;j<n[i];j++) {
-		trace(2,"scan_obstype: sys=%d code=%s type=%d\n",i,code2obs(codes[i][j],NULL),types[i][j]);
-    }
-    for (i=0;i<NSATSYS;i++) {
-        
-        /* sort codes */
-        sort_codes(codes[i],types[i],n[i]);
-        
-        /* set observation types in rinex option */
-        setopt_obstype(codes[i],types[i],i,opt);
-        
-        for (j=0;j<n[i];j++) {
-            trace(3,"scan_obstype: sys=%d code=%s\n",i,code2obs(codes[i][j],NULL));
-        }
-    }
+    setopt_scanned(codes,types,n,opt);
     return 1;
 }
 /* set observation types -----------------------------------------------------*/
@@ -848,7 +1285,7 @@ static void restslips(unsigned char slips[][NFREQ+NEXOBS], obsd_t *data, int n)
 }
 /* open output files ---------------------------------------------------------*/
 static int openfile(FILE **ofp, char *files[], const char *file,
-                    const rnxopt_t *opt, nav_t *nav)
+                    rnxopt_t *opt, nav_t *nav)
 {
     char path[1024];
     int i;
@@ -872,6 +1309,16 @@ static int openfile(FILE **ofp, char *files[], const char *file,
             for (i--;i>=0;i--) if (ofp[i]) fclose(ofp[i]);
             return 0;
         }
+        /* initialize compact rinex encoder for obs */
+        if (i==0&&opt->crinex) {
+            if (!(opt->crx=(crx_t *)malloc(sizeof(crx_t)))||
+                !init_crx(opt->crx,opt)) {
+                showmsg("memory allocation error");
+                free(opt->crx); opt->crx=NULL;
+                fclose(ofp[0]);
+                return 0;
+            }
+        }
         /* write header to file */
         switch (i) {
             case 0: outrnxobsh (ofp[0],opt,nav); break;
@@ -887,7 +1334,7 @@ static int openfile(FILE **ofp, char *files[], const char *file,
     return 1;
 }
 /* close output files --------------------------------------------------------*/
-static void closefile(FILE **ofp, const rnxopt_t *opt, nav_t *nav)
+static void closefile(FILE **ofp, rnxopt_t *opt, nav_t *nav)
 {
     int i;
     
@@ -911,30 +1358,55 @@ static void closefile(FILE **ofp, const rnxopt_t *opt, nav_t *nav)
         }
         fclose(ofp[i]);
     }
+    if (opt->crx) {
+        free_crx(opt->crx);
+        free(opt->crx);
+        opt->crx=NULL;
+    }
+}
+/* compress output files -----------------------------------------------------*/
+static void compfile(FILE **ofp, char **files, const rnxopt_t *opt,
+                     const int *n)
+{
+    char path[1024];
+    int i;
+    
+    if (!opt->gzip) return;
+    
+    for (i=0;i<NOUTFILE;i++) {
+        if (!ofp[i]||n[i]<=0) continue;
+        if (rtk_compress(files[i],path)<0) {
+            showmsg("file compress error: %s",files[i]);
+        }
+    }
 }
 /* output rinex event --------------------------------------------------------*/
 static void outrnxevent(FILE *fp, rnxopt_t *opt, int staid, stas_t *stas)
 {
     stas_t *p;
-    double pos[3],enu[3],del[3];
+    double pos[3],enu[3],del[3]={0};
+    char buff[1024],*q=buff;
     
     trace(2,"outrnxevent: staid=%d\n",staid);
     
     for (p=stas;p;p=p->next) {
         if (p->staid==staid) break;
     }
-    fprintf(fp,"%31s%d%3d\n","",3,p?6:2); /* new site occupation event */
-    fprintf(fp,"station ID: %4d%44s%-20s\n",staid,"","COMMENT");
-    fprintf(fp,"%04d%-56s%-20s\n",staid,"","MARKER NAME");
+    /* new site occupation event (flag at col 29 for ver.2, col 32 for ver.3) */
+    if (opt->rnxver<=2.99) q+=sprintf(q,"%28s%d%3d\n","",3,p?6:2);
+    else q+=sprintf(q,">%30s%d%3d\n","",3,p?6:2);
+    q+=sprintf(q,"station ID: %4d%44s%-20s\n",staid,"","COMMENT");
+    q+=sprintf(q,"%04d%-56s%-20s\n",staid,"","MARKER NAME");
     if (!p) {
+        outrnxobsr(fp,opt,buff,(int)(q-buff));
         return;
     }
-    fprintf(fp,"%-20.20s%-20.20s%-20.20s%-20s\n",p->sta.recsno,
-            p->sta.rectype,p->sta.recver,"REC # / TYPE / VERS");
-    fprintf(fp,"%-20.20s%-20.20s%-20.20s%-20s\n",p->sta.antsno,
-            p->sta.antdes,"","ANT # / TYPE");
-    fprintf(fp,"%14.4f%14.4f%14.4f%-18s%-20s\n",p->sta.pos[0],
-            p->sta.pos[1],p->sta.pos[2],"","APPROX POSITION XYZ");
+    q+=sprintf(q,"%-20.20s%-20.20s%-20.20s%-20s\n",p->sta.recsno,
+              p->sta.rectype,p->sta.recver,"REC # / TYPE / VERS");
+    q+=sprintf(q,"%-20.20s%-20.20s%-20.20s%-20s\n",p->sta.antsno,
+              p->sta.antdes,"","ANT # / TYPE");
+    q+=sprintf(q,"%14.4f%14.4f%14.4f%-18s%-20s\n",p->sta.pos[0],
+              p->sta.pos[1],p->sta.pos[2],"","APPROX POSITION XYZ");
     
     /* antenna delta */
     if (norm(p->sta.del,3)>0.0) {
@@ -956,8 +1428,9 @@ static void outrnxevent(FILE *fp, rnxopt_t *opt, int staid, stas_t *stas)
         del[1]=0.0;
         del[2]=0.0;
     }
-    fprintf(fp,"%14.4f%14.4f%14.4f%-18s%-20s\n",del[0],del[1],del[2],"",
-            "ANTENNA: DELTA H/E/N");
+    q+=sprintf(q,"%14.4f%14.4f%14.4f%-18s%-20s\n",del[0],del[1],del[2],"",
+              "ANTENNA: DELTA H/E/N");
+    outrnxobsr(fp,opt,buff,(int)(q-buff));
 }
 /* screen time with time tolerance -------------------------------------------*/
 static int screent_ttol(gtime_t time, gtime_t ts, gtime_t te, double tint,
@@ -969,13 +1442,64 @@ static int screent_ttol(gtime_t time, gtime_t ts, gtime_t te, double tint,
            (ts.time==0||timediff(time,ts)>=-ttol)&&
            (te.time==0||timediff(time,te)<  ttol);
 }
-/* convert obs message -------------------------------------------------------*/
+/* output obs epoch ----------------------------------------------------------*/
+static void outobs(FILE *fp, rnxopt_t *opt, int format, obs_t *obs, int staid,
+                   int *staid_prev, stas_t *stas, halfc_t *halfc)
+{
+    int i;
+    
+    /* output event if station changed */
+    if ((format==STRFMT_RTCM2||format==STRFMT_RTCM3)&&staid!=*staid_prev) {
+        if (*staid_prev>=0) {
+            outrnxevent(fp,opt,staid,stas);
+        }
+        *staid_prev=staid;
+    }
+    /* half-cycle ambiguity correction */
+    if (opt->halfcyc) {
+        for (i=0;i<obs->n;i++) {
+            resolve_halfc(halfc,obs->data+i);
+        }
+    }
+    /* output rinex obs */
+    outrnxobsb(fp,opt,obs->data,obs->n,obs->flag);
+}
+/* write obs epoch to spool file ---------------------------------------------*/
+static int write_spool(FILE *fp, const obs_t *obs, int staid)
+{
+    spoolh_t h={0};
+    
+    h.type=1;
+    h.n=obs->n;
+    h.flag=obs->flag;
+    h.staid=staid;
+    h.time=obs->n>0?obs->data[0].time:h.time;
+    
+    return fwrite(&h,sizeof(h),1,fp)==1&&
+           fwrite(obs->data,sizeof(obsd_t),obs->n,fp)==(size_t)obs->n;
+}
+/* read obs epoch from spool file --------------------------------------------*/
+static int read_spool(FILE *fp, obs_t *obs, int *staid)
+{
+    spoolh_t h;
+    
+    if (fread(&h,sizeof(h),1,fp)<1||h.n<0||h.n>obs->nmax) return 0;
+    
+    if (fread(obs->data,sizeof(obsd_t),h.n,fp)<(size_t)h.n) return 0;
+    obs->n=h.n;
+    obs->flag=h.flag;
+    *staid=h.staid;
+    return 1;
+}
+/* convert obs message ---------------------------------------------------------
+* if spool is set, ofp[0] is the spool file and the epoch is written to it
+* instead of rinex obs, to be output by conv_spool() after scanning obs types
+*-----------------------------------------------------------------------------*/
 static void convobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *staid,
                     stas_t *stas, halfc_t *halfc, int *n,
-                    unsigned char slips[][NFREQ+NEXOBS])
+                    unsigned char slips[][NFREQ+NEXOBS], int spool)
 {
     gtime_t time;
-    int i;
     
     trace(3,"convobs :\n");
     
@@ -993,22 +1517,17 @@ static void convobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *staid,
     /* restore slips */
     restslips(slips,str->obs->data,str->obs->n);
     
-    /* output event if station changed */
-    if ((str->format==STRFMT_RTCM2||str->format==STRFMT_RTCM3)&&
-        str->rtcm.staid!=*staid) {
-        if (*staid>=0) {
-            outrnxevent(ofp[0],opt,str->rtcm.staid,stas);
+    if (spool) {
+        /* write obs epoch to spool */
+        if (!write_spool(ofp[0],str->obs,str->rtcm.staid)) {
+            trace(1,"spool file write error\n");
         }
-        *staid=str->rtcm.staid;
     }
-    /* half-cycle ambiguity correction */
-    if (opt->halfcyc) {
-        for (i=0;i<str->obs->n;i++) {
-            resolve_halfc(halfc,str->obs->data+i);
-        }
+    else {
+        /* output rinex obs */
+        outobs(ofp[0],opt,str->format,str->obs,str->rtcm.staid,staid,stas,
+               halfc);
     }
-    /* output rinex obs */
-    outrnxobsb(ofp[0],opt,str->obs->data,str->obs->n,str->obs->flag);
     /* n[NOUTFILE+1] - count of events converted to rinex */
     if (str->obs->flag == 5)
        n[NOUTFILE+1]++;
@@ -1020,6 +1539,26 @@ static void convobs(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *staid,
     
     n[0]++;
 }
+/* convert spooled obs epochs ------------------------------------------------*/
+static int conv_spool(FILE *fp, FILE *spool, rnxopt_t *opt, int format,
+                      stas_t *stas, halfc_t *halfc)
+{
+    obs_t obs={0};
+    int staid,staid_prev=-1;
+    
+    trace(3,"conv_spool:\n");
+    
+    if (!(obs.data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))) return 0;
+    obs.nmax=MAXOBS;
+    
+    rewind(spool);
+    
+    while (read_spool(spool,&obs,&staid)) {
+        outobs(fp,opt,format,&obs,staid,&staid_prev,stas,halfc);
+    }
+    free(obs.data);
+    return 1;
+}
 /* convert nav message -------------------------------------------------------*/
 static void convnav(FILE **ofp, rnxopt_t *opt, strfile_t *str, int *n)
 {
@@ -1248,6 +1787,471 @@ static int showstat(int sess, gtime_t ts, gtime_t te, int *n)
     }
     return showmsg(msg);
 }
+/* convert messages in stream file ---------------------------------------------
+* input messages of an opened stream file and convert them. if codes is set,
+* obs types, station list and half-cycle status are scanned in the same pass.
+* if spool is set, obs epochs are written to spool file ofp[0] to be output by
+* conv_spool() after scanning. return abort status of showstat()
+*-----------------------------------------------------------------------------*/
+static int conv_strfile(int sess, rnxopt_t *opt, strfile_t *str, FILE **ofp,
+                        int spool, unsigned char codes[][33],
+                        unsigned char types[][33], int *nc, gtime_t *time,
+                        stas_t **stas, halfc_t *halfc, int *staid,
+                        unsigned char slips[][NFREQ+NEXOBS], gtime_t tend,
+                        gtime_t *ts, gtime_t *te, int *n)
+{
+    int i,type,conv=1,scan=codes!=NULL;
+    
+    for (i=0;(conv||scan)&&(type=input_strfile(str))>=-1;i++) {
+        
+        if (i%11==1&&showstat(sess,*te,*te,n)) return 1;
+        
+        if (scan&&type==5) { /* update station list */
+            update_stas(stas,str);
+        }
+        else if (scan&&type==1&&str->obs->n>0) {
+            if (!opt->ts.time||
+                timediff(str->obs->data[0].time,opt->ts)>=0.001) {
+                
+                scan_obs(str->obs,codes,types,nc,halfc);
+                
+                if (!time->time) *time=str->obs->data[0].time;
+            }
+            if (opt->te.time&&
+                timediff(str->obs->data[0].time,opt->te)>10.0) scan=0;
+        }
+        if (!conv) continue;
+        
+        /* avoid duplicated if overlapped data */
+        if (type==1&&tend.time&&timediff(str->time,tend)<=0.0) continue;
+        
+        /* convert message */
+        switch (type) {
+            case  1: convobs(ofp,opt,str,staid,*stas,halfc,n,slips,spool); break;
+            case  2: convnav(ofp,opt,str,n); break;
+            case  3: convsbs(ofp,opt,str,n); break;
+            case 31: convlex(ofp,opt,str,n); break;
+            case -1: n[NOUTFILE]++; break; /* error */
+        }
+        *te=str->time; if (ts->time==0) *ts=*te;
+        
+        /* set approx position */
+        if (type==1&&!opt->autopos&&norm(opt->apppos,3)<=0.0) {
+            setapppos(str,opt);
+        }
+        if (opt->te.time&&timediff(*te,opt->te)>=-opt->ttol) conv=0;
+    }
+    return 0;
+}
+/* close converted output files ----------------------------------------------*/
+static void closeconv(int sess, int format, rnxopt_t *opt, strfile_t *str,
+                      const stas_t *stas, FILE **ofp, char **ofile,
+                      char **paths, gtime_t ts, gtime_t te, int *n)
+{
+    int i;
+    
+    /* set receiver and antenna information to option */
+    if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
+        rtcm2opt(&str->rtcm,stas,opt);
+    }
+    else if (format==STRFMT_RINEX) {
+        rnx2opt(&str->rnx,opt);
+    }
+    else if (format==STRFMT_CMR) {
+        raw2opt(&str->raw,opt);
+    }
+    /* close output files */
+    closefile(ofp,opt,str->nav);
+    
+    /* remove empty output files */
+    for (i=0;i<NOUTFILE;i++) {
+        if (ofp[i]&&n[i]<=0) remove(ofile[i]);
+    }
+    /* compress output files */
+    compfile(ofp,paths,opt,n);
+    
+    if (ts.time>0) showstat(sess,ts,te,n);
+}
+/* copy spooled file body to output file ------------------------------------*/
+static int copy_spool(FILE *ofp, FILE *spool)
+{
+    char buff[32768];
+    size_t n;
+    
+    rewind(spool);
+    
+    while ((n=fread(buff,1,sizeof(buff),spool))>0) {
+        if (fwrite(buff,1,n,ofp)<n) return 0;
+    }
+    return 1;
+}
+/* abort status of parallel conversion --------------------------------------*/
+static int conv_abort(convp_t *cp)
+{
+    int abort;
+    
+    lock(&cp->lock);
+    abort=cp->abort;
+    unlock(&cp->lock);
+    return abort;
+}
+/* test rtcm 3 decoder state at file boundary ----------------------------------
+* return BOUND_HEAD if a message of the file is decoded by the decoder state of
+* the previous file: message time before the first obs epoch, glonass carrier-
+* phase by frequency channel of previous ephemeris or a partial epoch discarded
+* after lock times updated. tpend is the time of pending partial epoch before
+* the message
+*-----------------------------------------------------------------------------*/
+static int test_bound(const rtcm_t *rtcm, int k, int type, gtime_t tpend,
+                      int *timed)
+{
+    const obsd_t *data=rtcm->obs.data;
+    int i,j,bound=0;
+    
+    if (tpend.time&&(rtcm->obs.n<=0||timediff(data[0].time,tpend)!=0.0)) {
+        bound=BOUND_HEAD;
+    }
+    if (k<=0) return bound;
+    
+    if (type>=2&&!*timed) bound=BOUND_HEAD;
+    if (rtcm->obs.n>0) *timed=1;
+    
+    for (i=0;type==1&&i<rtcm->obs.n;i++) {
+        if (satsys(data[i].sat,NULL)!=SYS_GLO||data[i].freq) continue;
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            if (data[i].code[j]!=CODE_NONE&&data[i].L[j]==0.0) bound=BOUND_HEAD;
+        }
+    }
+    return bound;
+}
+/* decode input file to spool --------------------------------------------------
+* decode an input file by an independent decoder and write the messages to a
+* spool file. for rtcm 3, the decoder is initialized by the approx log start
+* time and lock records are spooled to set loss-of-lock indicators as decoded
+* in sequence. f->bound is set if the spool does not reproduce the sequential
+* decoding at the file boundary.
+*-----------------------------------------------------------------------------*/
+static FILE *spool_file(convf_t *f)
+{
+    convp_t *cp=f->cp;
+    FILE *fp;
+    strfile_t *str;
+    gtime_t t0={0},tpend;
+    unsigned char (*seen)[NFREQ+NEXOBS]=NULL;
+    int i,n=0,type,stat=1,timed=0,rtcm3=cp->format==STRFMT_RTCM3;
+    
+    trace(3,"spool_file: file=%s\n",cp->files[f->k]);
+    
+    if (!(str=gen_strfile(cp->format,cp->rcvopt,f->k?cp->time:cp->time0,
+                          f->msg))) {
+        return NULL;
+    }
+    if (rtcm3&&!(seen=(unsigned char (*)[NFREQ+NEXOBS])calloc(
+        sizeof(*seen),MAXSAT))) {
+        errmsg(f->msg,"memory allocation error");
+        free_strfile(str);
+        return NULL;
+    }
+    if (!open_strfile(str,cp->files[f->k])) {
+        free_strfile(str);
+        free(seen);
+        return NULL;
+    }
+    if (!(fp=tmpfile())) {
+        errmsg(f->msg,"spool file open error");
+        close_strfile(str);
+        free_strfile(str);
+        free(seen);
+        return NULL;
+    }
+    while (stat&&!conv_abort(cp)) {
+        tpend=t0;
+        if (rtcm3&&!str->rtcm.obsflag&&str->rtcm.obs.n>0) {
+            tpend=str->rtcm.obs.data[0].time;
+        }
+        if ((type=input_strfile(str))<-1) break;
+        
+        if (rtcm3) f->bound|=test_bound(&str->rtcm,f->k,type,tpend,&timed);
+        
+        if (type==0) continue;
+        
+        stat=spool_msg(str,fp,type,seen);
+        
+        if (type==1) str->obs->flag=0;
+    }
+    if (rtcm3) {
+        /* partial frame or epoch at end of file */
+        if (str->rtcm.nbyte>0||(!str->rtcm.obsflag&&str->rtcm.obs.n>0)) {
+            f->bound|=BOUND_TAIL;
+        }
+        /* legacy obs messages (1001-1004,1009-1012) with carrier-phase and
+           lock by previous file */
+        for (i=1;i<=12;i++) {
+            if (i<=4||i>=9) n+=str->rtcm.nmsg3[i];
+        }
+        if (f->k>0&&n>0) f->bound|=BOUND_HEAD;
+    }
+    stat&=spool_msg(str,fp,SPOOL_STATE,seen);
+    
+    close_strfile(str);
+    free_strfile(str);
+    free(seen);
+    
+    if (!stat) {
+        errmsg(f->msg,"spool file write error: %.900s",cp->files[f->k]);
+        fclose(fp);
+        return NULL;
+    }
+    return fp;
+}
+/* decoder thread ------------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI convthread(void *arg)
+#else
+static void *convthread(void *arg)
+#endif
+{
+    convf_t *f=(convf_t *)arg;
+    
+    f->spool=spool_file(f);
+    return 0;
+}
+/* start decoder thread of input file ----------------------------------------*/
+static void start_spool(convp_t *cp, int k)
+{
+    convf_t *f=cp->file+k;
+    
+    if (k>=cp->nf) return;
+#ifdef WIN32
+    if ((f->thread=CreateThread(NULL,0,convthread,f,0,NULL))) f->run=1;
+#else
+    if (!pthread_create(&f->thread,NULL,convthread,f)) f->run=1;
+#endif
+}
+/* join decoder thread of input file -----------------------------------------*/
+static void join_spool(convf_t *f)
+{
+    if (f->run!=1) return;
+#ifdef WIN32
+    WaitForSingleObject(f->thread,INFINITE);
+    CloseHandle(f->thread);
+#else
+    pthread_join(f->thread,NULL);
+#endif
+    f->run=2;
+}
+/* wait for spooled input file -------------------------------------------------
+* join the decoder thread of the file, or decode the file if the thread was not
+* started, and start the decoder thread of the file nthread ahead
+*-----------------------------------------------------------------------------*/
+static FILE *wait_spool(convp_t *cp, int k)
+{
+    convf_t *f=cp->file+k;
+    
+    if (f->run==1) join_spool(f);
+    else if (!f->run) f->spool=spool_file(f);
+    f->run=2;
+    
+    start_spool(cp,k+cp->nthread);
+    
+    if (f->spool) rewind(f->spool);
+    return f->spool;
+}
+/* release spooled input file ------------------------------------------------*/
+static void release_spool(convp_t *cp, int k)
+{
+    if (cp->file[k].spool) fclose(cp->file[k].spool);
+    cp->file[k].spool=NULL;
+}
+/* rinex converter for single-session in single pass -------------------------*/
+static int convrnx_s1(int sess, int format, rnxopt_t *opt, const char *path,
+                      char **epath, int nf, char **ofile, gtime_t time,
+                      convp_t *cp)
+{
+    FILE *ofp[NOUTFILE]={NULL},*tfp[NOUTFILE]={NULL};
+    strfile_t *str;
+    stas_t *stas=NULL,*p,*next;
+    halfc_t halfc={{{0}}};
+    gtime_t ts={0},te={0},tend={0};
+    unsigned char slips[MAXSAT][NFREQ+NEXOBS]={{0}};
+    unsigned char codes[NSATSYS][33]={{0}},types[NSATSYS][33]={{0}};
+    int i,n[NOUTFILE+2]={0},nc[NSATSYS]={0},staid=-1;
+    int stat=1,abort=0,bound=0;
+    char *paths[NOUTFILE],s[NOUTFILE][1024];
+    char *staname=*opt->staid?opt->staid:"0000";
+    
+    trace(3,"convrnx_s1: sess=%d format=%d nf=%d\n",sess,format,nf);
+    
+    if (!(str=gen_strfile(format,opt->rcvopt,time,NULL))) return 0;
+    
+    /* open spool files for obs epochs and nav/sbs bodies */
+    for (i=0;i<NOUTFILE;i++) {
+        if (!*ofile[i]) continue;
+        if (!(tfp[i]=tmpfile())) {
+            showmsg("spool file open error");
+            for (i--;i>=0;i--) if (tfp[i]) fclose(tfp[i]);
+            free_strfile(str);
+            return 0;
+        }
+    }
+    for (i=0;i<nf&&!abort;i++) {
+        
+        /* open stream file or wait for spooled messages of file */
+        if (cp) {
+            if (!(str->sfp=wait_spool(cp,i))) {
+                if (*cp->file[i].msg) showmsg("%s",cp->file[i].msg);
+                continue;
+            }
+            /* decoder state at file boundary not reproduced by spool */
+            if ((bound&BOUND_TAIL)||(cp->file[i].bound&BOUND_HEAD)) {
+                trace(2,"decoder state at file boundary: %s bound=%d %d\n",
+                      epath[i],bound,cp->file[i].bound);
+                str->sfp=NULL;
+                stat=-2;
+                break;
+            }
+            bound=cp->file[i].bound;
+        }
+        else if (!open_strfile(str,epath[i])) continue;
+        
+        /* input message, scan obs types and convert in a pass */
+        abort=conv_strfile(sess,opt,str,tfp,1,opt->scanobs?codes:NULL,types,
+                           nc,&time,&stas,&halfc,&staid,slips,tend,&ts,&te,n);
+        
+        /* close stream file */
+        if (cp) {
+            str->sfp=NULL;
+            release_spool(cp,i);
+        }
+        else close_strfile(str);
+        
+        tend=te; /* end time of a file */
+    }
+    if (!abort&&stat>0) {
+        if (opt->scanobs) {
+            /* set scanned observation types in rinex option */
+            setopt_scanned(codes,types,nc,opt);
+        }
+        else {
+            /* set observation types by format */
+            set_obstype(format,opt);
+        }
+        time=opt->ts.time?opt->ts:(time.time?timeadd(time,TSTARTMARGIN):time);
+        
+        /* replace keywords in output file */
+        for (i=0;i<NOUTFILE;i++) {
+            paths[i]=s[i];
+            if (reppath(ofile[i],paths[i],time,staname,"")<0) {
+                showmsg("no time for output path: %s",ofile[i]);
+                stat=0;
+                break;
+            }
+        }
+    }
+    /* open output files and write headers */
+    if (!abort&&stat>0&&!openfile(ofp,paths,path,opt,str->nav)) stat=0;
+    
+    if (!abort&&stat>0) {
+        
+        /* output rinex obs body and copy nav/sbs bodies */
+        if (ofp[0]) conv_spool(ofp[0],tfp[0],opt,format,stas,&halfc);
+        
+        for (i=1;i<NOUTFILE;i++) {
+            if (ofp[i]&&!copy_spool(ofp[i],tfp[i])) {
+                showmsg("file write error: %s",paths[i]);
+            }
+        }
+        closeconv(sess,format,opt,str,stas,ofp,ofile,paths,ts,te,n);
+    }
+    for (i=0;i<NOUTFILE;i++) {
+        if (tfp[i]) fclose(tfp[i]);
+    }
+    for (p=stas;p;p=next) {
+        next=p->next;
+        free(p);
+    }
+    free_strfile(str);
+    
+    if (opt->tstart.time==0) opt->tstart=opt->ts;
+    if (opt->tend  .time==0) opt->tend  =opt->te;
+    
+    return abort?-1:stat;
+}
+/* first obs time in rtcm 3 file --------------------------------------------*/
+static gtime_t scan_firstobs(int format, const char *rcvopt, const char *file,
+                             gtime_t time, gtime_t ts)
+{
+    strfile_t *str;
+    gtime_t t0={0};
+    char msg[MAXERRMSG];
+    int type;
+    
+    if (!(str=gen_strfile(format,rcvopt,time,msg))) return t0;
+    
+    if (open_strfile(str,file)) {
+        while ((type=input_strfile(str))>=-1) {
+            if (type!=1||str->obs->n<=0) continue;
+            if (!ts.time||timediff(str->obs->data[0].time,ts)>=0.001) {
+                t0=str->obs->data[0].time;
+                break;
+            }
+        }
+        close_strfile(str);
+    }
+    free_strfile(str);
+    return t0;
+}
+/* rinex converter for single-session with parallel decoders -------------------
+* return -2 if the files are not decoded in parallel as in sequence
+*-----------------------------------------------------------------------------*/
+static int convrnx_p(int sess, int format, rnxopt_t *opt, const char *path,
+                     char **epath, int nf, char **ofile, gtime_t time)
+{
+    convp_t cp={0};
+    int i,stat;
+    
+    trace(3,"convrnx_p: sess=%d format=%d nf=%d nthread=%d\n",sess,format,nf,
+          opt->nthread);
+    
+    cp.time0=cp.time=time;
+    
+    /* decoder time by first obs epoch as scan_obstype() and approx log start
+       time to resolve week of rtcm 3 messages in later files */
+    if (format==STRFMT_RTCM3&&!time.time) {
+        cp.time=scan_firstobs(format,opt->rcvopt,epath[0],time,opt->ts);
+        if (!cp.time.time) return -2;
+        if (opt->scanobs==1) cp.time0=cp.time;
+    }
+    cp.format=format;
+    cp.rcvopt=opt->rcvopt;
+    cp.files=epath;
+    cp.nf=nf;
+    cp.nthread=opt->nthread<MAXTHREAD?opt->nthread:MAXTHREAD;
+    if (!(cp.file=(convf_t *)calloc(sizeof(convf_t),nf))) return 0;
+    initlock(&cp.lock);
+    
+    /* start decoder threads of first files */
+    for (i=0;i<nf;i++) {
+        cp.file[i].cp=&cp;
+        cp.file[i].k=i;
+    }
+    for (i=0;i<cp.nthread;i++) start_spool(&cp,i);
+    
+    /* merge spooled messages in order of input files */
+    stat=convrnx_s1(sess,format,opt,path,epath,nf,ofile,time,&cp);
+    
+    /* stop decoder threads */
+    lock(&cp.lock);
+    cp.abort=1;
+    unlock(&cp.lock);
+    
+    for (i=0;i<nf;i++) {
+        join_spool(cp.file+i);
+        release_spool(&cp,i);
+    }
+    free(cp.file);
+    return stat;
+}
 /* rinex converter for single-session ----------------------------------------*/
 static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
                      char **ofile)
@@ -1257,8 +2261,9 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     stas_t *stas=NULL,*p,*next;
     halfc_t halfc={{{0}}};
     gtime_t ts={0},te={0},tend={0},time={0};
+    rnxopt_t opt0;
     unsigned char slips[MAXSAT][NFREQ+NEXOBS]={{0}};
-    int i,j,nf,type,n[NOUTFILE+2]={0},staid=-1,abort=0;
+    int i,nf,n[NOUTFILE+2]={0},staid=-1,abort=0,stat;
     char path[1024],*paths[NOUTFILE],s[NOUTFILE][1024];
     char *epath[MAXEXFILE]={0},*staname=*opt->staid?opt->staid:"0000";
     
@@ -1283,6 +2288,26 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
     if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
         time=opt->trtcm;
     }
+    if (opt->nthread>1&&nf>1&&
+        (format==STRFMT_RTCM3||format==STRFMT_RINEX)) {
+        
+        /* decode input files in parallel and convert in single pass */
+        opt0=*opt;
+        if ((stat=convrnx_p(sess,format,opt,path,epath,nf,ofile,time))!=-2) {
+            for (i=0;i<MAXEXFILE;i++) free(epath[i]);
+            return stat;
+        }
+        /* convert in sequence */
+        showmsg("");
+        *opt=opt0;
+    }
+    if (opt->scanobs==2) {
+        
+        /* scan observation types and convert in single pass */
+        stat=convrnx_s1(sess,format,opt,path,epath,nf,ofile,time,NULL);
+        for (i=0;i<MAXEXFILE;i++) free(epath[i]);
+        return stat;
+    }
     if (opt->scanobs) {
         
         /* scan observation types and station parameters */
@@ -1295,7 +2320,7 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
 #if 1
     dump_halfc(&halfc);
 #endif
-    if (!(str=gen_strfile(format,opt->rcvopt,time))) {
+    if (!(str=gen_strfile(format,opt->rcvopt,time,NULL))) {
         for (i=0;i<MAXEXFILE;i++) free(epath[i]);
         return 0;
     }
@@ -1322,53 +2347,16 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
         /* open stream file */
         if (!open_strfile(str,epath[i])) continue;
         
-        /* input message */
-        for (j=0;(type=input_strfile(str))>=-1;j++) {
-            
-            if (j%11==1&&(abort=showstat(sess,te,te,n))) break;
-            
-            /* avioid duplicated if overlapped data */
-            if (type==1&&tend.time&&timediff(str->time,tend)<=0.0) continue;
-            
-            /* convert message */
-            switch (type) {
-                case  1: convobs(ofp,opt,str,&staid,stas,&halfc,n,slips); break;
-                case  2: convnav(ofp,opt,str,n); break;
-                case  3: convsbs(ofp,opt,str,n); break;
-                case 31: convlex(ofp,opt,str,n); break;
-                case -1: n[NOUTFILE]++; break; /* error */
-            }
-            te=str->time; if (ts.time==0) ts=te;
-            
-            /* set approx position */
-            if (type==1&&!opt->autopos&&norm(opt->apppos,3)<=0.0) {
-                setapppos(str,opt);
-            }
-            if (opt->te.time&&timediff(te,opt->te)>=-opt->ttol) break;
-        }
+        /* input message and convert */
+        abort=conv_strfile(sess,opt,str,ofp,0,NULL,NULL,NULL,&time,&stas,
+                           &halfc,&staid,slips,tend,&ts,&te,n);
+        
         /* close stream file */
         close_strfile(str);
         
         tend=te; /* end time of a file */
     }
-    /* set receiver and antenna information to option */
-    if (format==STRFMT_RTCM2||format==STRFMT_RTCM3) {
-        rtcm2opt(&str->rtcm,stas,opt);
-    }
-    else if (format==STRFMT_RINEX) {
-        rnx2opt(&str->rnx,opt);
-    }
-    else if (format==STRFMT_CMR) {
-        raw2opt(&str->raw,opt);
-    }
-    /* close output files */
-    closefile(ofp,opt,str->nav);
-    
-    /* remove empty output files */
-    for (i=0;i<NOUTFILE;i++) {
-        if (ofp[i]&&n[i]<=0) remove(ofile[i]);
-    }
-    if (ts.time>0) showstat(sess,ts,te,n);
+    closeconv(sess,format,opt,str,stas,ofp,ofile,paths,ts,te,n);
     
     for (p=stas;p;p=next) {
         next=p->next;
@@ -1405,6 +2393,18 @@ static int convrnx_s(int sess, int format, rnxopt_t *opt, const char *file,
 *          keywords in ofile[] are replaced by first obs date/time and station
 *          id (%r)
 *          the order of wild-card expanded files must be in-order by time
+*          if opt->nthread>1, wild-card expanded files of rtcm 3 or rinex are
+*          decoded in parallel by independent decoders and merged in order of
+*          the files. lock times of rtcm 3 are carried over the files. if the
+*          decoding of a file depends on the decoder state of the previous file
+*          (legacy rtcm 3 obs, messages before the first obs epoch or a file
+*          split in an epoch), the files are converted in sequence. other
+*          formats are always converted in sequence.
+*          the decoders run on worker threads and must not keep static state.
+*          their errors are shown by showmsg() of the calling thread
+*          if opt->crinex is set, rinex obs is output in compact rinex
+*          (hatanaka) format. if opt->gzip is set, output files are compressed
+*          by gzip to <file>.gz after conversion
 *-----------------------------------------------------------------------------*/
 extern int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile)
 {
@@ -1419,6 +2419,8 @@ extern int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile)
     
     showmsg("");
     
+    opt_.crx=NULL;
+    
     if (opt->ts.time==0||opt->te.time==0||opt->tunit<=0.0) {
         
         /* single-session */
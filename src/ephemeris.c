@@ -55,6 +55,7 @@
 *                           set MAX_ITER_KEPLER for alm2pos()
 *           2017/04/11 1.12 fix bug on max number of obs data in satposs()
 *           2018/10/10 1.13 update reference [7]
+*           2026/10/17 1.14 support corrections allocated on demand in nav_t
 *                           support ura value in var_uraeph() for galileo
 *                           test eph->flag to recognize beidou geo
 *                           add api satseleph() for ephemeris selection
@@ -556,11 +557,11 @@ static int satpos_sbas(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
     trace(4,"satpos_sbas: time=%s sat=%2d\n",time_str(time,3),sat);
     
     /* search sbas satellite correciton */
-    for (i=0;i<nav->sbssat.nsat;i++) {
-        sbs=nav->sbssat.sat+i;
+    for (i=0;nav->sbssat&&i<nav->sbssat->nsat;i++) {
+        sbs=nav->sbssat->sat+i;
         if (sbs->sat==sat) break;
     }
-    if (i>=nav->sbssat.nsat) {
+    if (!nav->sbssat||i>=nav->sbssat->nsat) {
         trace(2,"no sbas correction for orbit: %s sat=%2d\n",time_str(time,0),sat);
         ephpos(time,teph,sat,nav,-1,rs,dts,var,svh);
         *svh=-1;
@@ -585,6 +586,10 @@ static int satpos_ssr(gtime_t time, gtime_t teph, int sat, const nav_t *nav,
     
     trace(4,"satpos_ssr: time=%s sat=%2d\n",time_str(time,3),sat);
     
+    if (!nav->ssr) {
+        trace(2,"no ssr correction: %s sat=%2d\n",time_str(time,0),sat);
+        return 0;
+    }
     ssr=nav->ssr+sat-1;
     
     if (!ssr->t0[0].time) {
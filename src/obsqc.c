@@ -0,0 +1,338 @@
+/*------------------------------------------------------------------------------
+* obsqc.c : observation data quality check functions
+*
+* notes   : multipath (code-minus-carrier corrected by twice the ionospheric
+*           delay of the geometry-free phase) of the observation code i is
+*
+*               MP_i = P_i - lam_i*L_i + 2*C*(lam_i*L_i - lam_j*L_j)
+*               C    = lam_i^2/(lam_i^2 - lam_j^2)
+*
+*           with the pair frequency j (L2 for L1 or L1 for others, E5a or E1
+*           for GAL, L5 or L1 for SBS and B2 or B1 for BDS). the multipath
+*           includes the code and phase biases, which are removed as the mean
+*           over the continuous arc of each satellite and observation code.
+*           the arc is broken by the loss-of-lock indicators of the code i and
+*           j or by the jump of the multipath from the arc mean over the
+*           threshold.
+*
+*           the ionospheric rate is the time difference of the L1 ionospheric
+*           delay of the geometry-free phase of the first observation code in
+*           the same arc, converted to TECU/min by the frequency of the code.
+*
+*           all the statistics are accumulated by one pass over observation
+*           records in time order, with the running mean and sum of squared
+*           deviations of the multipath in the arc. the multipath of the
+*           records in an arc is corrected by the arc mean as the arc is
+*           closed, by following the links to the next records of the
+*           satellite.
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define SQR(x)      ((x)*(x))
+
+#define THRES_SLIP  2.0             /* multipath jump of cycle-slip (m) */
+#define MAXGAP_ION  60.0            /* max gap of ionospheric rate (s) */
+#define K_TEC       40.3E16         /* ionospheric delay factor (m*Hz^2/TECU) */
+
+/* frequency pair of multipath -----------------------------------------------*/
+static void mpfreq(int sys, unsigned char code, int *f1, int *f2)
+{
+    code2obs(code,f1);
+
+    if (sys==SYS_CMP) {
+        if      (*f1==5) *f1=2; /* B2 */
+        else if (*f1==4) *f1=3; /* B3 */
+    }
+    if      (sys==SYS_GAL) *f2=*f1==1?3:1; /* E1/E5a */
+    else if (sys==SYS_SBS) *f2=*f1==1?3:1; /* L1/L5 */
+    else if (sys==SYS_CMP) *f2=*f1==1?2:1; /* B1/B2 */
+    else                   *f2=*f1==1?2:1; /* L1/L2 */
+}
+/* carrier wave length of satellite ------------------------------------------*/
+static double wavelen(qcsat_t *s, int sat, int f, const nav_t *nav)
+{
+    if (f<1||MAXFREQ<f) return 0.0;
+    if (s->lam[f-1]==0.0) s->lam[f-1]=satwavelen(sat,f-1,nav);
+    return s->lam[f-1];
+}
+/* close multipath arc -------------------------------------------------------*/
+static void closearc(qcarc_t *arc, qcstat_t *stat, const int *next, double *mp)
+{
+    int k;
+
+    if (arc->n<=0) return;
+
+    if (next&&mp) {
+        for (k=arc->first;k>=0;k=next[k]) {
+            if (mp[k]!=0.0) mp[k]-=arc->mean;
+            if (k==arc->last) break;
+        }
+    }
+    stat->nmp+=arc->n;
+    stat->narc++;
+    stat->mpss+=arc->m2;
+    arc->n=0;
+    arc->first=arc->last=-1;
+}
+/* close all multipath arcs --------------------------------------------------*/
+static void closearcs(qc_t *qc, const int *next, double **mp)
+{
+    int i,j;
+
+    for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ+NEXOBS;j++) {
+        closearc(qc->sat[i].arc+j,qc->sat[i].stat+j,next,mp?mp[j]:NULL);
+    }
+}
+/* update ionospheric rate ---------------------------------------------------*/
+static void updrot(qc_t *qc, qcsat_t *s, gtime_t time, double ion, double lam,
+                   int slip)
+{
+    double tt,rot;
+
+    if (s->tion.time&&!slip) {
+        tt=timediff(time,s->tion);
+        if (tt>0.0&&tt<=qc->maxgap) {
+            rot=(ion-s->ion)/tt*60.0*SQR(CLIGHT/lam)/K_TEC;
+            s->rotss+=rot*rot;
+            if (fabs(rot)>s->rotmax) s->rotmax=fabs(rot);
+            s->nrot++;
+        }
+    }
+    s->tion=time;
+    s->ion=ion;
+}
+/* quality check of an observation record --------------------------------------
+* i: record index (-1:no index), next: links of records (NULL:no links)
+* mp: raw multipath of records (NULL:no output)
+* mpr: multipath minus running arc mean of the record (NULL:no output)
+*-----------------------------------------------------------------------------*/
+static int qcrec(qc_t *qc, const obsd_t *data, const nav_t *nav, int i,
+                 const int *next, double **mp, double *mpr)
+{
+    qcsat_t *s;
+    qcarc_t *arc;
+    qcstat_t *stat;
+    double lam1,lam2,C,I,v,d,snr;
+    int j,f1,f2,sys,slip,nv=0;
+
+    for (j=0;j<NFREQ+NEXOBS;j++) {
+        if (mp) mp[j][i]=0.0;
+        if (mpr) mpr[j]=0.0;
+    }
+    if (data->sat<=0||MAXSAT<data->sat) return 0;
+
+    s=qc->sat+data->sat-1;
+    sys=satsys(data->sat,NULL);
+
+    for (j=0;j<NFREQ+NEXOBS;j++) {
+        arc=s->arc+j;
+        stat=s->stat+j;
+        if (data->L[j]==0.0&&data->P[j]==0.0) continue;
+
+        stat->nobs++;
+        if (data->SNR[j]>0) {
+            snr=data->SNR[j]*0.25;
+            if (stat->nsnr==0||snr<stat->snrmin) stat->snrmin=snr;
+            if (stat->nsnr==0||snr>stat->snrmax) stat->snrmax=snr;
+            stat->snrs+=snr;
+            stat->snrss+=snr*snr;
+            stat->nsnr++;
+        }
+        mpfreq(sys,data->code[j],&f1,&f2);
+        if (f2>NFREQ+NEXOBS) continue;
+
+        if ((data->LLI[j]&1)||(data->LLI[f2-1]&1)) arc->slip=1;
+
+        lam1=wavelen(s,data->sat,f1,nav);
+        lam2=wavelen(s,data->sat,f2,nav);
+        if (lam1==0.0||lam2==0.0||data->P[j]==0.0||data->L[j]==0.0||
+            data->L[f2-1]==0.0) continue;
+
+        C=SQR(lam1)/(SQR(lam1)-SQR(lam2));
+        I=lam1*data->L[j]-lam2*data->L[f2-1];
+        v=data->P[j]-lam1*data->L[j]+2.0*C*I;
+
+        slip=arc->n>0&&(arc->slip||fabs(v-arc->mean)>qc->thres);
+
+        if (j==0) updrot(qc,s,data->time,-C*I,lam1,slip||arc->slip);
+
+        if (slip) {
+            closearc(arc,stat,next,mp?mp[j]:NULL);
+            stat->nslip++;
+        }
+        arc->slip=0;
+
+        if (arc->n==0) {
+            arc->ts=data->time;
+            arc->first=i;
+            arc->mean=v;
+            arc->m2=0.0;
+            arc->n=1;
+        }
+        else {
+            d=v-arc->mean;
+            arc->mean+=d/++arc->n;
+            arc->m2+=d*(v-arc->mean);
+        }
+        arc->te=data->time;
+        arc->last=i;
+
+        if (mp) mp[j][i]=v;
+        if (mpr) mpr[j]=v-arc->mean;
+        nv++;
+    }
+    return nv;
+}
+/* initialize observation qc ---------------------------------------------------
+* initialize observation qc states and statistics
+* args   : qc_t   *qc       O   observation qc
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void initqc(qc_t *qc)
+{
+    int i,j;
+
+    trace(3,"initqc:\n");
+
+    memset(qc,0,sizeof(qc_t));
+    qc->thres=THRES_SLIP;
+    qc->maxgap=MAXGAP_ION;
+
+    for (i=0;i<MAXSAT;i++) {
+        qc->sat[i].last=-1;
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            qc->sat[i].arc[j].first=qc->sat[i].arc[j].last=-1;
+        }
+    }
+}
+/* input observation data of an epoch to qc ------------------------------------
+* update observation qc statistics by observation data of an epoch
+* args   : qc_t   *qc       IO  observation qc
+*          obsd_t *obs      I   observation data
+*          int    n         I   number of observation data
+*          nav_t  *nav      I   navigation data
+*          double *mp       O   multipath minus running arc mean (m)
+*                               mp[i*(NFREQ+NEXOBS)+j]: obs[i] code j
+*                               (0.0:no multipath) (NULL:no output)
+* return : number of multipath samples
+* notes  : for real-time use. the arc mean is that of the samples up to the
+*          epoch.
+*-----------------------------------------------------------------------------*/
+extern int inputqc(qc_t *qc, const obsd_t *obs, int n, const nav_t *nav,
+                   double *mp)
+{
+    int i,nv=0;
+
+    trace(4,"inputqc: n=%d\n",n);
+
+    for (i=0;i<n;i++) {
+        nv+=qcrec(qc,obs+i,nav,-1,NULL,NULL,mp?mp+i*(NFREQ+NEXOBS):NULL);
+    }
+    return nv;
+}
+/* observation data qc ---------------------------------------------------------
+* compute multipath and qc statistics of observation data
+* args   : qc_t   *qc       IO  observation qc (initialized by initqc())
+*          obs_t  *obs      I   observation data (sorted by time)
+*          nav_t  *nav      I   navigation data
+*          double **mp      O   multipath minus arc mean (m)
+*                               mp[j][i]: obs->data[i] code j
+*                               (0.0:no multipath) (NULL:no output)
+* return : number of multipath samples (-1:memory allocation error)
+* notes  : all the arcs are closed at the end of the data.
+*-----------------------------------------------------------------------------*/
+extern int obsqc(qc_t *qc, const obs_t *obs, const nav_t *nav, double **mp)
+{
+    qcsat_t *s;
+    int i,sat,*next,nv=0;
+
+    trace(3,"obsqc: n=%d\n",obs->n);
+
+    if (obs->n<=0) return 0;
+
+    if (!(next=(int *)malloc(sizeof(int)*obs->n))) return -1;
+
+    for (i=0;i<MAXSAT;i++) qc->sat[i].last=-1;
+
+    for (i=0;i<obs->n;i++) {
+        next[i]=-1;
+        sat=obs->data[i].sat;
+        if (0<sat&&sat<=MAXSAT) {
+            s=qc->sat+sat-1;
+            if (s->last>=0) next[s->last]=i;
+            s->last=i;
+        }
+        nv+=qcrec(qc,obs->data+i,nav,i,next,mp,NULL);
+    }
+    closearcs(qc,next,mp);
+
+    free(next);
+    return nv;
+}
+/* close observation qc --------------------------------------------------------
+* close all multipath arcs and add them to qc statistics
+* args   : qc_t   *qc       IO  observation qc
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void closeqc(qc_t *qc)
+{
+    trace(3,"closeqc:\n");
+
+    closearcs(qc,NULL,NULL);
+}
+/* output observation qc statistics --------------------------------------------
+* output observation qc statistics of each satellite and code
+* args   : FILE   *fp       I   output file pointer
+*          qc_t   *qc       I   observation qc
+* return : number of output satellites and codes
+* notes  : the statistics include those of the open arcs.
+*          the ionospheric rate is output to the first code of the satellite.
+*-----------------------------------------------------------------------------*/
+extern int outqc(FILE *fp, const qc_t *qc)
+{
+    const qcsat_t *s;
+    const qcstat_t *stat;
+    const qcarc_t *arc;
+    double mpss,ave,std;
+    int i,j,n=0,nmp,narc;
+    char id[32];
+
+    trace(3,"outqc:\n");
+
+    fprintf(fp,"%%  SAT FRQ    NOBS     NMP  NARC NSLIP  MPRMS(m) SNRAVE SNRSTD "
+            "SNRMIN SNRMAX  ROTRMS  ROTMAX\n");
+
+    for (i=0;i<MAXSAT;i++) {
+        s=qc->sat+i;
+        satno2id(i+1,id);
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            stat=s->stat+j;
+            arc=s->arc+j;
+            if (stat->nobs<=0) continue;
+
+            nmp =stat->nmp +arc->n;
+            narc=stat->narc+(arc->n>0?1:0);
+            mpss=stat->mpss+(arc->n>0?arc->m2:0.0);
+            ave=std=0.0;
+            if (stat->nsnr>0) {
+                ave=stat->snrs/stat->nsnr;
+                std=stat->snrss/stat->nsnr-ave*ave;
+                std=std>0.0?sqrt(std):0.0;
+            }
+            fprintf(fp,"%6s  L%d %7d %7d %5d %5d %9.4f %6.2f %6.2f %6.2f %6.2f",
+                    id,j+1,stat->nobs,nmp,narc,stat->nslip,
+                    nmp>0?sqrt(mpss/nmp):0.0,ave,std,stat->snrmin,stat->snrmax);
+            if (j==0&&s->nrot>0) {
+                fprintf(fp," %7.3f %7.3f\n",sqrt(s->rotss/s->nrot),s->rotmax);
+            }
+            else {
+                fprintf(fp," %7s %7s\n","-","-");
+            }
+            n++;
+        }
+    }
+    return n;
+}
@@ -24,6 +24,8 @@
 *           2016/06/10  1.9  add ant2-maxaveep,ant2-initrst
 *           2016/07/31  1.10 add out-outsingle,out-maxsolstd
 *           2017/06/14  1.11 add out-outvel
+*           2026/10/17  1.12 add 3:batch as pos1-soltype option
+*                            add 2:chisq as pos1-posopt5 option
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -39,9 +41,10 @@ static char snrmask_[NFREQ][1024];
 
 /* system options table ------------------------------------------------------*/
 #define SWTOPT  "0:off,1:on"
+#define RAIMOPT "0:off,1:on,2:chisq"
 #define MODOPT  "0:single,1:dgps,2:kinematic,3:static,4:static-start,5:movingbase,6:fixed,7:ppp-kine,8:ppp-static,9:ppp-fixed"
 #define FRQOPT  "1:l1,2:l1+l2,3:l1+l2+l5,4:l1+l2+l5+l6"
-#define TYPOPT  "0:forward,1:backward,2:combined"
+#define TYPOPT  "0:forward,1:backward,2:combined,3:batch"
 #define IONOPT  "0:off,1:brdc,2:sbas,3:dual-freq,4:est-stec,5:ionex-tec,6:qzs-brdc,7:qzs-lex,8:stec"
 #define TRPOPT  "0:off,1:saas,2:sbas,3:est-ztd,4:est-ztdgrad,5:ztd"
 #define EPHOPT  "0:brdc,1:precise,2:brdc+sbas,3:brdc+ssrapc,4:brdc+ssrcom"
@@ -56,6 +59,7 @@ static char snrmask_[NFREQ][1024];
 #define GEOOPT  "0:internal,1:egm96,2:egm08_2.5,3:egm08_1,4:gsi2000"
 #define STAOPT  "0:all,1:single"
 #define STSOPT  "0:off,1:state,2:residual"
+#define STFOPT  "0:text,1:binary"
 #define ARMOPT  "0:off,1:continuous,2:instantaneous,3:fix-and-hold"
 #define POSOPT  "0:llh,1:xyz,2:single,3:posfile,4:rinexhead,5:rtcm,6:raw"
 #define TIDEOPT "0:off,1:on,2:otl"
@@ -80,7 +84,7 @@ EXPORT opt_t sysopts[]={
     {"pos1-posopt2",    3,  (void *)&prcopt_.posopt[1],  SWTOPT },
     {"pos1-posopt3",    3,  (void *)&prcopt_.posopt[2],  PHWOPT },
     {"pos1-posopt4",    3,  (void *)&prcopt_.posopt[3],  SWTOPT },
-    {"pos1-posopt5",    3,  (void *)&prcopt_.posopt[4],  SWTOPT },
+    {"pos1-posopt5",    3,  (void *)&prcopt_.posopt[4],  RAIMOPT},
     {"pos1-posopt6",    3,  (void *)&prcopt_.posopt[5],  SWTOPT },
     {"pos1-exclsats",   2,  (void *)exsats_,             "prn ..."},
     {"pos1-navsys",     0,  (void *)&prcopt_.navsys,     NAVOPT },
@@ -132,6 +136,7 @@ EXPORT opt_t sysopts[]={
     {"out-nmeaintv1",   1,  (void *)&solopt_.nmeaintv[0],"s"    },
     {"out-nmeaintv2",   1,  (void *)&solopt_.nmeaintv[1],"s"    },
     {"out-outstat",     3,  (void *)&solopt_.sstat,      STSOPT },
+    {"out-statformat",  3,  (void *)&solopt_.sstatf,     STFOPT },
     
     {"stats-weightmode",3,  (void *)&prcopt_.weightmode, WEIGHTOPT},
     {"stats-eratio1",   1,  (void *)&prcopt_.eratio[0],  ""     },
@@ -17,6 +17,11 @@
 *           2014/05/26 1.4  support galileo and beidou
 *           2015/03/19 1.5  fix bug on ionosphere correction for GLO and BDS
 *           2018/10/10 1.6  support api change of satexclude()
+*           2026/10/17 1.7  raim fde by downdates of normal matrix with
+*                           multiple satellite exclusion
+*                           raim fde also for chi-square test failure
+*                           (opt->posopt[4]=2)
+*                           limit number of solutions evaluated by raim fde
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -28,6 +33,8 @@
 #define NX          (4+3)       /* # of estimated parameters */
 
 #define MAXITR      10          /* max number of iteration for point pos */
+#define MAXRAIMEXC  3           /* max number of satellites excluded by raim */
+#define MAXRAIMSOL  32          /* max number of solutions evaluated by raim */
 #define ERR_ION     5.0         /* ionospheric delay std (m) */
 #define ERR_TROP    3.0         /* tropspheric delay std (m) */
 #define ERR_SAAS    0.3         /* saastamoinen model error std (m) */
@@ -296,6 +303,12 @@ static int rescode(int iter, const obsd_t *obs, int n, const double *rs,
     }
     return nv;
 }
+/* chi-square test of residuals ----------------------------------------------*/
+static int testchisq(const double *v, int nv, int nx, double *vv)
+{
+    *vv=dot(v,v,nv);
+    return nv<=nx||*vv<=chisqr[nv-nx-1];
+}
 /* validate solution ---------------------------------------------------------*/
 static int valsol(const double *azel, const int *vsat, int n,
                   const prcopt_t *opt, const double *v, int nv, int nx,
@@ -307,8 +320,7 @@ static int valsol(const double *azel, const int *vsat, int n,
     trace(3,"valsol  : n=%d nv=%d\n",n,nv);
     
     /* chi-square validation of residuals */
-    vv=dot(v,v,nv);
-    if (nv>nx&&vv>chisqr[nv-nx-1]) {
+    if (!testchisq(v,nv,nx,&vv)) {
         sprintf(msg,"Warning: large chi-square error nv=%d vv=%.1f cs=%.1f",nv,vv,chisqr[nv-nx-1]);
         /* return 0; */ /* threshold too strict for all use cases, report error but continue on */
     }
@@ -326,79 +338,113 @@ static int valsol(const double *azel, const int *vsat, int n,
     }
     return 1;
 }
-/* estimate receiver position ------------------------------------------------*/
-static int estpos(const obsd_t *obs, int n, const double *rs, const double *dts,
+/* least square estimation of receiver position --------------------------------
+* iterate least square estimation of receiver position from initial x
+* args   : ...                     same as estpos()
+*          double *x        IO  receiver position and clock biases {x,y,z,dtr,...}
+*          double *Q        O   covariance of x (NX x NX)
+*          double *v,*H,*var O  residuals, design matrix weighted by std and
+*                               variances of the last iteration
+*          int    *nv,*ns   O   number of residuals and valid satellites
+* return : status (1:converged,0:error)
+*-----------------------------------------------------------------------------*/
+static int lsqpos(const obsd_t *obs, int n, const double *rs, const double *dts,
                   const double *vare, const int *svh, const nav_t *nav,
-                  const prcopt_t *opt, const ssat_t *ssat, sol_t *sol, double *azel,
-                  int *vsat, double *resp, char *msg)
+                  const prcopt_t *opt, const ssat_t *ssat, double *x, double *Q,
+                  double *v, double *H, double *var, double *azel, int *vsat,
+                  double *resp, int *nv, int *ns, char *msg)
 {
-    double x[NX]={0},dx[NX],Q[NX*NX],*v,*H,*var,sig;
-    int i,j,k,info,stat,nv,ns;
-    
-    trace(3,"estpos  : n=%d\n",n);
-    
-    v=mat(n+4,1); H=mat(NX,n+4); var=mat(n+4,1);
-    
-    for (i=0;i<3;i++) x[i]=sol->rr[i];
+    double dx[NX],sig;
+    int i,j,k,info;
     
     for (i=0;i<MAXITR;i++) {
         
         /* pseudorange residuals */
-        nv=rescode(i,obs,n,rs,dts,vare,svh,nav,x,opt,ssat,v,H,var,azel,vsat,resp,
-                   &ns);
+        *nv=rescode(i,obs,n,rs,dts,vare,svh,nav,x,opt,ssat,v,H,var,azel,vsat,
+                    resp,ns);
         
-        if (nv<NX) {
-            sprintf(msg,"lack of valid sats ns=%d",nv);
-            break;
+        if (*nv<NX) {
+            sprintf(msg,"lack of valid sats ns=%d",*nv);
+            return 0;
         }
         /* weight by variance */
-        for (j=0;j<nv;j++) {
+        for (j=0;j<*nv;j++) {
             sig=sqrt(var[j]);
             v[j]/=sig;
             for (k=0;k<NX;k++) H[k+j*NX]/=sig;
         }
         /* least square estimation */
-        if ((info=lsq(H,v,NX,nv,dx,Q))) {
+        if ((info=lsq(H,v,NX,*nv,dx,Q))) {
             sprintf(msg,"lsq error info=%d",info);
-            break;
+            return 0;
         }
         for (j=0;j<NX;j++) x[j]+=dx[j];
         
-        if (norm(dx,NX)<1E-4) {
-            sol->type=0;
-            sol->time=timeadd(obs[0].time,-x[3]/CLIGHT);
-            sol->dtr[0]=x[3]/CLIGHT; /* receiver clock bias (s) */
-            sol->dtr[1]=x[4]/CLIGHT; /* glo-gps time offset (s) */
-            sol->dtr[2]=x[5]/CLIGHT; /* gal-gps time offset (s) */
-            sol->dtr[3]=x[6]/CLIGHT; /* bds-gps time offset (s) */
-            for (j=0;j<6;j++) sol->rr[j]=j<3?x[j]:0.0;
-            for (j=0;j<3;j++) sol->qr[j]=(float)Q[j+j*NX];
-            sol->qr[3]=(float)Q[1];    /* cov xy */
-            sol->qr[4]=(float)Q[2+NX]; /* cov yz */
-            sol->qr[5]=(float)Q[2];    /* cov zx */
-            sol->ns=(unsigned char)ns;
-            sol->age=sol->ratio=0.0;
-            
-            /* validate solution */
-            if ((stat=valsol(azel,vsat,n,opt,v,nv,NX,msg))) {
-                sol->stat=opt->sateph==EPHOPT_SBAS?SOLQ_SBAS:SOLQ_SINGLE;
-            }
-            free(v); free(H); free(var);
-            
-            return stat;
-        }
+        if (norm(dx,NX)<1E-4) return 1;
     }
-    if (i>=MAXITR) sprintf(msg,"iteration divergent i=%d",i);
+    sprintf(msg,"iteration divergent i=%d",i);
+    return 0;
+}
+/* estimate receiver position ------------------------------------------------*/
+static int estpos(const obsd_t *obs, int n, const double *rs, const double *dts,
+                  const double *vare, const int *svh, const nav_t *nav,
+                  const prcopt_t *opt, const ssat_t *ssat, sol_t *sol, double *azel,
+                  int *vsat, double *resp, char *msg, int *chisq)
+{
+    double x[NX]={0},Q[NX*NX],*v,*H,*var,vv;
+    int j,stat=0,nv,ns;
+    
+    trace(3,"estpos  : n=%d\n",n);
     
+    v=mat(n+4,1); H=mat(NX,n+4); var=mat(n+4,1);
+    
+    for (j=0;j<3;j++) x[j]=sol->rr[j];
+    
+    if (lsqpos(obs,n,rs,dts,vare,svh,nav,opt,ssat,x,Q,v,H,var,azel,vsat,resp,
+               &nv,&ns,msg)) {
+        sol->type=0;
+        sol->time=timeadd(obs[0].time,-x[3]/CLIGHT);
+        sol->dtr[0]=x[3]/CLIGHT; /* receiver clock bias (s) */
+        sol->dtr[1]=x[4]/CLIGHT; /* glo-gps time offset (s) */
+        sol->dtr[2]=x[5]/CLIGHT; /* gal-gps time offset (s) */
+        sol->dtr[3]=x[6]/CLIGHT; /* bds-gps time offset (s) */
+        for (j=0;j<6;j++) sol->rr[j]=j<3?x[j]:0.0;
+        for (j=0;j<3;j++) sol->qr[j]=(float)Q[j+j*NX];
+        sol->qr[3]=(float)Q[1];    /* cov xy */
+        sol->qr[4]=(float)Q[2+NX]; /* cov yz */
+        sol->qr[5]=(float)Q[2];    /* cov zx */
+        sol->ns=(unsigned char)ns;
+        sol->age=sol->ratio=0.0;
+        
+        /* validate solution */
+        if ((stat=valsol(azel,vsat,n,opt,v,nv,NX,msg))) {
+            sol->stat=opt->sateph==EPHOPT_SBAS?SOLQ_SBAS:SOLQ_SINGLE;
+        }
+        if (chisq) *chisq=testchisq(v,nv,NX,&vv);
+    }
     free(v); free(H); free(var);
     
-    return 0;
+    return stat;
 }
-/* raim fde (failure detection and exclution) -------------------------------*/
-static int raim_fde(const obsd_t *obs, int n, const double *rs,
-                    const double *dts, const double *vare, const int *svh,
-                    const nav_t *nav, const prcopt_t *opt, const ssat_t *ssat, 
-                    sol_t *sol, double *azel, int *vsat, double *resp, char *msg)
+/* rms of residuals of valid satellites --------------------------------------*/
+static double rmsres(const double *resp, const int *vsat, int n, int *nvsat)
+{
+    double rms=0.0;
+    int i;
+    
+    for (i=*nvsat=0;i<n;i++) {
+        if (!vsat[i]) continue;
+        rms+=SQR(resp[i]);
+        (*nvsat)++;
+    }
+    return *nvsat>0?sqrt(rms/(*nvsat)):0.0;
+}
+/* raim fde by exhaustive search (failure detection and exclution) -----------*/
+static int raim_fde_exh(const obsd_t *obs, int n, const double *rs,
+                        const double *dts, const double *vare, const int *svh,
+                        const nav_t *nav, const prcopt_t *opt, const ssat_t *ssat,
+                        sol_t *sol, double *azel, int *vsat, double *resp,
+                        char *msg, int maxsol)
 {
     obsd_t *obs_e;
     sol_t sol_e={{0}};
@@ -406,13 +452,13 @@ static int raim_fde(const obsd_t *obs, int n, const double *rs,
     double *rs_e,*dts_e,*vare_e,*azel_e,*resp_e,rms_e,rms=100.0;
     int i,j,k,nvsat,stat=0,*svh_e,*vsat_e,sat=0;
     
-    trace(3,"raim_fde: %s n=%2d\n",time_str(obs[0].time,0),n);
+    trace(3,"raim_fde_exh: %s n=%2d\n",time_str(obs[0].time,0),n);
     
     if (!(obs_e=(obsd_t *)malloc(sizeof(obsd_t)*n))) return 0;
     rs_e = mat(6,n); dts_e = mat(2,n); vare_e=mat(1,n); azel_e=zeros(2,n);
     svh_e=imat(1,n); vsat_e=imat(1,n); resp_e=mat(1,n); 
     
-    for (i=0;i<n;i++) {
+    for (i=0;i<n&&i<maxsol;i++) {
         
         /* satellite exclution */
         for (j=k=0;j<n;j++) {
@@ -425,22 +471,17 @@ static int raim_fde(const obsd_t *obs, int n, const double *rs,
         }
         /* estimate receiver position without a satellite */
         if (!estpos(obs_e,n-1,rs_e,dts_e,vare_e,svh_e,nav,opt,ssat,&sol_e,azel_e,
-                    vsat_e,resp_e,msg_e)) {
+                    vsat_e,resp_e,msg_e,NULL)) {
             trace(3,"raim_fde: exsat=%2d (%s)\n",obs[i].sat,msg);
             continue;
         }
-        for (j=nvsat=0,rms_e=0.0;j<n-1;j++) {
-            if (!vsat_e[j]) continue;
-            rms_e+=SQR(resp_e[j]);
-            nvsat++;
-        }
+        rms_e=rmsres(resp_e,vsat_e,n-1,&nvsat);
+        
         if (nvsat<5) {
             trace(3,"raim_fde: exsat=%2d lack of satellites nvsat=%2d\n",
                   obs[i].sat,nvsat);
             continue;
         }
-        rms_e=sqrt(rms_e/nvsat);
-        
         trace(3,"raim_fde: exsat=%2d rms=%8.3f\n",obs[i].sat,rms_e);
         
         if (rms_e>rms) continue;
@@ -469,6 +510,135 @@ static int raim_fde(const obsd_t *obs, int n, const double *rs,
     free(svh_e); free(vsat_e); free(resp_e);
     return stat;
 }
+/* predict rms of residuals by excluding satellites --------------------------
+* predict rms of residuals (m) after excluding each satellite by downdates of
+* the normal matrix of weighted least square
+* args   : double *H,*v,*var I  weighted design matrix, residuals and variances
+*          double *Q      I     inverse of normal matrix (NX x NX)
+*          int    ns      I     number of satellite residuals (first ns of v)
+*          double *rms    O     predicted rms excluding each satellite
+* return : none
+*-----------------------------------------------------------------------------*/
+static void predrms(const double *H, const double *v, const double *var,
+                    const double *Q, int ns, double *rms)
+{
+    double q[NX],hkk,c,r;
+    int j,k,l;
+    
+    for (k=0;k<ns;k++) {
+        
+        /* q=Q*h_k, leverage hkk=h_k'*Q*h_k */
+        matmul("NN",NX,1,NX,1.0,Q,H+k*NX,0.0,q);
+        hkk=dot(H+k*NX,q,NX);
+        
+        /* residual change of the others: r_j+h_j'*q*r_k/(1-hkk) */
+        c=1.0-hkk>1E-9?v[k]/(1.0-hkk):0.0;
+        
+        for (j=0,rms[k]=0.0;j<ns;j++) {
+            if (j==k) continue;
+            for (l=0,r=0.0;l<NX;l++) r+=H[l+j*NX]*q[l];
+            rms[k]+=SQR((v[j]+r*c)*sqrt(var[j]));
+        }
+        rms[k]=ns>1?sqrt(rms[k]/(ns-1)):0.0;
+    }
+}
+/* raim fde (failure detection and exclution) ----------------------------------
+* solve position once for the satellite set, predict residuals after each
+* satellite exclusion by downdates of normal matrix and verify the best one
+* with a position estimation. with opt->posopt[4]=2, the exclusion is repeated
+* up to MAXRAIMEXC satellites while the solution fails in chi-square test.
+* it falls back to exhaustive search if the first solution is not converged.
+* the number of solutions evaluated in an epoch is limited to MAXRAIMSOL.
+*-----------------------------------------------------------------------------*/
+static int raim_fde(const obsd_t *obs, int n, const double *rs,
+                    const double *dts, const double *vare, const int *svh,
+                    const nav_t *nav, const prcopt_t *opt, const ssat_t *ssat, 
+                    sol_t *sol, double *azel, int *vsat, double *resp, char *msg)
+{
+    sol_t sol_e;
+    char tstr[32],name[16],msg_e[128];
+    double x[NX],Q[NX*NX],v[MAXOBS+4],H[NX*(MAXOBS+4)],var[MAXOBS+4];
+    double rms[MAXOBS],rms_e,*azel_e,*resp_e;
+    int i,j,k,nv,ns,nvsat,chisq=0,stat=0,nexc=0,nsol=0,ind[MAXOBS];
+    int svh_e[MAXOBS],*vsat_e,tried[MAXOBS];
+    
+    trace(3,"raim_fde: %s n=%2d\n",time_str(obs[0].time,0),n);
+    
+    if (n>MAXOBS) n=MAXOBS;
+    for (i=0;i<n;i++) svh_e[i]=svh[i];
+    azel_e=zeros(2,n); vsat_e=imat(1,n); resp_e=mat(1,n);
+    
+    while (nexc<MAXRAIMEXC&&nsol<MAXRAIMSOL) {
+        
+        /* solve once for the current satellite set */
+        for (j=0;j<NX;j++) x[j]=j<3?sol->rr[j]:0.0;
+        nsol++;
+        if (!lsqpos(obs,n,rs,dts,vare,svh_e,nav,opt,ssat,x,Q,v,H,var,azel_e,
+                    vsat_e,resp_e,&nv,&ns,msg_e)) {
+            if (nexc==0) {
+                free(azel_e); free(vsat_e); free(resp_e);
+                return raim_fde_exh(obs,n,rs,dts,vare,svh,nav,opt,ssat,sol,
+                                    azel,vsat,resp,msg,MAXRAIMSOL-nsol);
+            }
+            break;
+        }
+        if (ns<6) break;
+        
+        /* index of satellite residuals */
+        for (i=k=0;i<n;i++) if (vsat_e[i]) ind[k++]=i;
+        
+        /* predict rms of residuals by excluding each satellite */
+        predrms(H,v,var,Q,ns,rms);
+        
+        /* verify candidates in order of predicted rms */
+        for (k=0;k<ns;k++) tried[k]=0;
+        for (;;) {
+            for (j=0,k=-1;j<ns;j++) {
+                if (!tried[j]&&(k<0||rms[j]<rms[k])) k=j;
+            }
+            if (k<0||nsol>=MAXRAIMSOL) {k=-1; break;}
+            tried[k]=1;
+            
+            svh_e[ind[k]]=-1;
+            sol_e=*sol;
+            nsol++;
+            if (estpos(obs,n,rs,dts,vare,svh_e,nav,opt,ssat,&sol_e,azel_e,
+                       vsat_e,resp_e,msg_e,&chisq)) {
+                rms_e=rmsres(resp_e,vsat_e,n,&nvsat);
+                
+                trace(3,"raim_fde: exsat=%2d rms=%8.3f pred=%8.3f\n",
+                      obs[ind[k]].sat,rms_e,rms[k]);
+                
+                if (nvsat>=5&&rms_e<=100.0) break;
+            }
+            svh_e[ind[k]]=svh[ind[k]];
+        }
+        if (k<0) break;
+        
+        /* save result */
+        for (i=0;i<n;i++) {
+            if (svh_e[i]!=-1||svh[i]==-1) {
+                azel[2*i]=azel_e[2*i]; azel[1+2*i]=azel_e[1+2*i];
+            }
+            vsat[i]=vsat_e[i];
+            resp[i]=resp_e[i];
+        }
+        sol_e.eventime=sol->eventime;
+        *sol=sol_e;
+        strcpy(msg,msg_e);
+        stat=1;
+        nexc++;
+        
+        time2str(obs[0].time,tstr,2); satno2id(obs[ind[k]].sat,name);
+        trace(2,"%s: %s excluded by raim\n",tstr+11,name);
+        
+        if (chisq||opt->posopt[4]<2) break;
+    }
+    trace(3,"raim_fde: nexc=%d nsol=%d\n",nexc,nsol);
+    
+    free(azel_e); free(vsat_e); free(resp_e);
+    return stat;
+}
 /* doppler residuals ---------------------------------------------------------*/
 static int resdop(const obsd_t *obs, int n, const double *rs, const double *dts,
                   const nav_t *nav, const double *rr, const double *x,
@@ -564,7 +734,7 @@ extern int pntpos(const obsd_t *obs, int n, const nav_t *nav,
 {
     prcopt_t opt_=*opt;
     double *rs,*dts,*var,*azel_,*resp;
-    int i,stat,vsat[MAXOBS]={0},svh[MAXOBS];
+    int i,stat,chisq=1,vsat[MAXOBS]={0},svh[MAXOBS];
     
     sol->stat=SOLQ_NONE;
     
@@ -597,11 +767,13 @@ extern int pntpos(const obsd_t *obs, int n, const nav_t *nav,
     satposs(sol->time,obs,n,nav,opt_.sateph,rs,dts,var,svh);
     
     /* estimate receiver position with pseudorange */
-    stat=estpos(obs,n,rs,dts,var,svh,nav,&opt_,ssat,sol,azel_,vsat,resp,msg);
+    stat=estpos(obs,n,rs,dts,var,svh,nav,&opt_,ssat,sol,azel_,vsat,resp,msg,
+                &chisq);
     
     /* raim fde */
-    if (!stat&&n>=6&&opt->posopt[4]) {
-        stat=raim_fde(obs,n,rs,dts,var,svh,nav,&opt_,ssat,sol,azel_,vsat,resp,msg);
+    if ((!stat||(!chisq&&opt->posopt[4]==2))&&n>=6&&opt->posopt[4]) {
+        if (raim_fde(obs,n,rs,dts,var,svh,nav,&opt_,ssat,sol,azel_,vsat,resp,
+                     msg)) stat=1;
     }
     /* estimate receiver velocity with doppler */
     if (stat) estvel(obs,n,rs,dts,nav,&opt_,sol,azel_,vsat);
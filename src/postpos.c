@@ -39,6 +39,9 @@
 *           2016/08/29  1.21 suppress warnings
 *           2016/10/10  1.22 fix bug on identification of file fopt->blq
 *           2017/06/13  1.23 add smoother of velocity solution
+*           2026/10/17  1.24 support nav corrections allocated on demand
+*                            free antenna parameters by freepcv()
+*                            add batch static solution (soltype=3)
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -47,6 +50,7 @@
 
 #define MAXPRCDAYS  100          /* max days of continuous processing */
 #define MAXINFILE   1000         /* max number of input files */
+#define NPASS_BATCH 2            /* number of passes of batch static solution */
 
 /* constants/global variables ------------------------------------------------*/
 
@@ -225,6 +229,8 @@ static void update_rtcm_ssr(gtime_t time)
         if (input_rtcm3f(&rtcm,fp_rtcm)<-1) break;
         
         /* update ssr corrections */
+        if (!rtcm.ssr||!allocnav(&navs,0x200)) continue;
+        
         for (i=0;i<MAXSAT;i++) {
             if (!rtcm.ssr[i].update||
                 rtcm.ssr[i].iod[0]!=rtcm.ssr[i].iod[1]||
@@ -399,6 +405,8 @@ static void corr_phase_bias_ssr(obsd_t *obs, int n, const nav_t *nav)
     double lam;
     int i,j,code;
     
+    if (!nav->ssr) return;
+    
     for (i=0;i<n;i++) for (j=0;j<NFREQ;j++) {
         
         if (!(code=obs[i].code[j])) continue;
@@ -502,6 +510,44 @@ static void procpos(FILE *fp, FILE *fptm, const prcopt_t *popt, const solopt_t *
         outsol(fp,&sol,rb,sopt);
     }
 }
+/* batch static positioning --------------------------------------------------*/
+static void procbatch(FILE *fp, const prcopt_t *popt, const solopt_t *sopt,
+                      rtk_t *rtk)
+{
+    batch_t bat;
+    obsd_t obs[MAXOBS*2]; /* for rover and base */
+    int i,n,nobs,pass,stat=SOLQ_NONE;
+    
+    trace(3,"procbatch:\n");
+    
+    batchinit(&bat);
+    
+    for (pass=0;pass<NPASS_BATCH;pass++) {
+        rtkinit(rtk,popt);
+        iobsu=iobsr=isbs=ilex=revs=0;
+        
+        while ((nobs=inputobs(obs,stat,popt))>=0) {
+            
+            /* exclude satellites */
+            for (i=n=0;i<nobs;i++) {
+                if ((satsys(obs[i].sat,NULL)&popt->navsys)&&
+                    popt->exsats[obs[i].sat-1]!=1) obs[n++]=obs[i];
+            }
+            if (n<=0) continue;
+            
+            batchpos(rtk,&bat,obs,n,&navs);
+        }
+        if (!aborts) stat=batchsol(rtk,&bat,pass==NPASS_BATCH-1);
+        
+        if (aborts||stat==SOLQ_NONE||pass==NPASS_BATCH-1) break;
+        rtkfree(rtk);
+    }
+    if (!aborts&&stat!=SOLQ_NONE) {
+        outsol(fp,&rtk->sol,rtk->rb,sopt);
+    }
+    batchfree(&bat);
+    rtkfree(rtk);
+}
 /* validation of combined solutions ------------------------------------------*/
 static int valcomb(const sol_t *solf, const sol_t *solb)
 {
@@ -970,8 +1016,8 @@ static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
     trace(3,"closeses:\n");
     
     /* free antenna parameters */
-    free(pcvs->pcv); pcvs->pcv=NULL; pcvs->n=pcvs->nmax=0;
-    free(pcvr->pcv); pcvr->pcv=NULL; pcvr->n=pcvr->nmax=0;
+    freepcv(pcvs);
+    freepcv(pcvr);
     
     /* close geoid data */
     closegeoid();
@@ -979,6 +1025,9 @@ static void closeses(nav_t *nav, pcvs_t *pcvs, pcvs_t *pcvr)
     /* free erp data */
     free(nav->erp.data); nav->erp.data=NULL; nav->erp.n=nav->erp.nmax=0;
     
+    /* free corrections */
+    freenav(nav,0x1F00);
+    
     /* close solution statistics and debug trace */
     rtkclosestat();
     traceclose();
@@ -993,7 +1042,7 @@ static void setpcv(gtime_t time, prcopt_t *popt, nav_t *nav, const pcvs_t *pcvs,
     char id[64];
     
     /* set satellite antenna parameters */
-    for (i=0;i<MAXSAT;i++) {
+    for (i=0;i<MAXSAT&&allocnav(nav,0x100);i++) {
         if (!(satsys(i+1,NULL)&popt->navsys)) continue;
         if (!(pcv=searchpcv(i+1,"",time,pcvs))) {
             satno2id(i+1,id);
@@ -1166,7 +1215,7 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
         strcpy(statfile,outfile);
         strcat(statfile,".stat");
         rtkclosestat();
-        rtkopenstat(statfile,sopt->sstat);
+        rtkopenstatf(statfile,sopt->sstat,sopt->sstatf);
     }
     /* write header to output file */
     if (flag&&!outhead(outfile,infile,n,&popt_,sopt)) {
@@ -1180,7 +1229,8 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
 
     iobsu=iobsr=isbs=ilex=revs=aborts=0;
     
-    if (popt_.mode==PMODE_SINGLE||popt_.soltype==0) {
+    if (popt_.mode==PMODE_SINGLE||popt_.soltype==0||
+        (popt_.soltype==3&&popt_.mode!=PMODE_STATIC)) {
         if ((fp=openfile(outfile)) && (fptm=openfile(outfiletm))) {
             procpos(fp,fptm,&popt_,sopt,&rtk,0); /* forward */
             fclose(fp);
@@ -1195,6 +1245,12 @@ static int execses(gtime_t ts, gtime_t te, double ti, const prcopt_t *popt,
             fclose(fptm);
         }
     }
+    else if (popt_.soltype==3) { /* batch */
+        if ((fp=openfile(outfile))) {
+            procbatch(fp,&popt_,sopt,&rtk);
+            fclose(fp);
+        }
+    }
     else { /* combined */
         solf=(sol_t *)malloc(sizeof(sol_t)*nepoch);
         solb=(sol_t *)malloc(sizeof(sol_t)*nepoch);
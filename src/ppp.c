@@ -57,6 +57,7 @@
 *           2016/01/22 1.12 delete support for yaw-model bug
 *                           add support for ura of ephemeris
 *           2018/10/10 1.13 support api change of satexclude()
+*           2026/10/17 1.14 support satellite pcv and ssr allocated on demand
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -206,7 +207,7 @@ static void testeclipse(const obsd_t *obs, int n, const nav_t *nav, double *rs)
     normv3(rsun,esun);
     
     for (i=0;i<n;i++) {
-        type=nav->pcvs[obs[i].sat-1].type;
+        type=nav->pcvs?nav->pcvs[obs[i].sat-1].type:"";
         
         if ((r=norm(rs+i*6,3))<=0.0) continue;
         
@@ -408,7 +409,7 @@ static void corr_meas(const obsd_t *obs, const nav_t *nav, const double *azel,
                 ix=(i==0?CODE_L1W-1:CODE_L2W-1);
             else if (sys==SYS_GLO)
                 ix=(i==0?CODE_L1P-1:CODE_L2P-1);
-            P[i]+=(nav->ssr[obs->sat-1].cbias[obs->code[i]-1]-nav->ssr[obs->sat-1].cbias[ix]); /* ssr correction */
+            if (nav->ssr) P[i]+=(nav->ssr[obs->sat-1].cbias[obs->code[i]-1]-nav->ssr[obs->sat-1].cbias[ix]); /* ssr correction */
         }
         else {
             /* P1-C1,P2-C2 dcb correction (C1->P1,C2->P2) */
@@ -997,11 +998,11 @@ static int ppp_res(int post, const obsd_t *obs, int n, const double *rs,
             continue;
         }
         /* satellite and receiver antenna model */
-        if (opt->posopt[0]) satantpcv(rs+i*6,rr,nav->pcvs+sat-1,dants);
+        if (opt->posopt[0]&&nav->pcvs) satantpcv(rs+i*6,rr,nav->pcvs+sat-1,dants);
         antmodel(opt->pcvr,opt->antdel[0],azel+i*2,opt->posopt[1],dantr);
         
         /* phase windup model */
-        if (!model_phw(rtk->sol.time,sat,nav->pcvs[sat-1].type,
+        if (!model_phw(rtk->sol.time,sat,nav->pcvs?nav->pcvs[sat-1].type:"",
                        opt->posopt[2]?2:0,rs+i*6,rr,&rtk->ssat[sat-1].phw)) {
             continue;
         }
@@ -41,6 +41,10 @@
 *           2015/05/10 1.15 add api readfcb()
 *                           modify api readdcb()
 *           2017/04/11 1.16 fix bug on antenna offset correction in peph2pos()
+*           2026/10/17 1.17 allocate satellite pcv in nav data on demand
+*                           free antenna parameters by freepcv()
+*                           read sp3 body by blocks
+*                           pre-size precise ephemeris by sp3 header
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -64,7 +68,7 @@ static int code2sys(char code)
 }
 /* read sp3 header -----------------------------------------------------------*/
 static int readsp3h(FILE *fp, gtime_t *time, char *type, int *sats,
-                    double *bfact, char *tsys)
+                    double *bfact, char *tsys, int *ne)
 {
     int i,j,k=0,ns=0,sys,prn;
     char buff[1024];
@@ -77,6 +81,7 @@ static int readsp3h(FILE *fp, gtime_t *time, char *type, int *sats,
         if (i==0) {
             *type=buff[2];
             if (str2time(buff,3,28,time)) return 0;
+            *ne=(int)str2num(buff,32,7);
         }
         else if (2<=i&&i<=6) {
             if (i==2) {
@@ -98,36 +103,41 @@ static int readsp3h(FILE *fp, gtime_t *time, char *type, int *sats,
     }
     return ns;
 }
-/* add precise ephemeris -----------------------------------------------------*/
-static int addpeph(nav_t *nav, peph_t *peph)
+/* reserve precise ephemeris -------------------------------------------------*/
+static int resvpeph(nav_t *nav, int n)
 {
     peph_t *nav_peph;
     
-    if (nav->ne>=nav->nemax) {
-        nav->nemax+=256;
-        if (!(nav_peph=(peph_t *)realloc(nav->peph,sizeof(peph_t)*nav->nemax))) {
-            trace(1,"readsp3b malloc error n=%d\n",nav->nemax);
-            free(nav->peph); nav->peph=NULL; nav->ne=nav->nemax=0;
-            return 0;
-        }
-        nav->peph=nav_peph;
+    if (nav->ne+n<=nav->nemax) return 1;
+    
+    if (!(nav_peph=(peph_t *)realloc(nav->peph,sizeof(peph_t)*(nav->ne+n)))) {
+        trace(1,"readsp3b malloc error n=%d\n",nav->ne+n);
+        free(nav->peph); nav->peph=NULL; nav->ne=nav->nemax=0;
+        return 0;
     }
-    nav->peph[nav->ne++]=*peph;
+    nav->peph=nav_peph;
+    nav->nemax=nav->ne+n;
     return 1;
 }
 /* read sp3 body -------------------------------------------------------------*/
 static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
-                     char *tsys, int index, int opt, nav_t *nav)
+                     char *tsys, int index, int opt, int ne, nav_t *nav)
 {
-    peph_t peph;
+    lnbuf_t lb;
+    peph_t *peph;
     gtime_t time;
     double val,std,base;
-    int i,j,sat,sys,prn,n=ns*(type=='P'?1:2),pred_o,pred_c,v;
-    char buff[1024];
+    int i,j,len,sat,sys,prn,n=ns*(type=='P'?1:2),pred_o,pred_c,v;
+    char *buff;
     
     trace(3,"readsp3b: type=%c ns=%d index=%d opt=%d\n",type,ns,index,opt);
     
-    while (fgets(buff,sizeof(buff),fp)) {
+    /* pre-size precise ephemeris by number of epochs in header */
+    if (ne>0&&!resvpeph(nav,ne)) return;
+    
+    if (!initlnbuf(&lb,fp,65536)) return;
+    
+    while ((buff=getlnbuf(&lb))) {
         
         if (!strncmp(buff,"EOF",3)) break;
         
@@ -136,24 +146,29 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
             continue;
         }
         if (!strcmp(tsys,"UTC")) time=utc2gpst(time); /* utc->gpst */
-        peph.time =time;
-        peph.index=index;
+        
+        if (nav->ne>=nav->nemax&&!resvpeph(nav,256)) break;
+        
+        /* decode records into next precise ephemeris */
+        peph=nav->peph+nav->ne;
+        peph->time =time;
+        peph->index=index;
         
         for (i=0;i<MAXSAT;i++) {
             for (j=0;j<4;j++) {
-                peph.pos[i][j]=0.0;
-                peph.std[i][j]=0.0f;
-                peph.vel[i][j]=0.0;
-                peph.vst[i][j]=0.0f;
+                peph->pos[i][j]=0.0;
+                peph->std[i][j]=0.0f;
+                peph->vel[i][j]=0.0;
+                peph->vst[i][j]=0.0f;
             }
             for (j=0;j<3;j++) {
-                peph.cov[i][j]=0.0f;
-                peph.vco[i][j]=0.0f;
+                peph->cov[i][j]=0.0f;
+                peph->vco[i][j]=0.0f;
             }
         }
-        for (i=pred_o=pred_c=v=0;i<n&&fgets(buff,sizeof(buff),fp);i++) {
+        for (i=pred_o=pred_c=v=0;i<n&&(buff=getlnbuf(&lb));i++) {
             
-            if (strlen(buff)<4||(buff[0]!='P'&&buff[0]!='V')) continue;
+            if ((len=(int)strlen(buff))<4||(buff[0]!='P'&&buff[0]!='V')) continue;
             
             sys=buff[1]==' '?SYS_GPS:code2sys(buff[1]);
             prn=(int)str2num(buff,2,2);
@@ -163,8 +178,8 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
             if (!(sat=satno(sys,prn))) continue;
             
             if (buff[0]=='P') {
-                pred_c=strlen(buff)>=76&&buff[75]=='P';
-                pred_o=strlen(buff)>=80&&buff[79]=='P';
+                pred_c=len>=76&&buff[75]=='P';
+                pred_o=len>=80&&buff[79]=='P';
             }
             for (j=0;j<4;j++) {
                 
@@ -179,27 +194,26 @@ static void readsp3b(FILE *fp, char type, int *sats, int ns, double *bfact,
                 
                 if (buff[0]=='P') { /* position */
                     if (val!=0.0&&fabs(val-999999.999999)>=1E-6) {
-                        peph.pos[sat-1][j]=val*(j<3?1000.0:1E-6);
+                        peph->pos[sat-1][j]=val*(j<3?1000.0:1E-6);
                         v=1; /* valid epoch */
                     }
                     if ((base=bfact[j<3?0:1])>0.0&&std>0.0) {
-                        peph.std[sat-1][j]=(float)(pow(base,std)*(j<3?1E-3:1E-12));
+                        peph->std[sat-1][j]=(float)(pow(base,std)*(j<3?1E-3:1E-12));
                     }
                 }
                 else if (v) { /* velocity */
                     if (val!=0.0&&fabs(val-999999.999999)>=1E-6) {
-                        peph.vel[sat-1][j]=val*(j<3?0.1:1E-10);
+                        peph->vel[sat-1][j]=val*(j<3?0.1:1E-10);
                     }
                     if ((base=bfact[j<3?0:1])>0.0&&std>0.0) {
-                        peph.vst[sat-1][j]=(float)(pow(base,std)*(j<3?1E-7:1E-16));
+                        peph->vst[sat-1][j]=(float)(pow(base,std)*(j<3?1E-7:1E-16));
                     }
                 }
             }
         }
-        if (v) {
-            if (!addpeph(nav,&peph)) return;
-        }
+        if (v) nav->ne++;
     }
+    freelnbuf(&lb);
 }
 /* compare precise ephemeris -------------------------------------------------*/
 static int cmppeph(const void *p1, const void *p2)
@@ -256,7 +270,7 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
     FILE *fp;
     gtime_t time={0};
     double bfact[2]={0};
-    int i,j,n,ns,sats[MAXSAT]={0};
+    int i,j,n,ns,ne=0,sats[MAXSAT]={0};
     char *efiles[MAXEXFILE],*ext,type=' ',tsys[4]="";
     
     trace(3,"readpephs: file=%s\n",file);
@@ -281,10 +295,10 @@ extern void readsp3(const char *file, nav_t *nav, int opt)
             continue;
         }
         /* read sp3 header */
-        ns=readsp3h(fp,&time,&type,sats,bfact,tsys);
+        ns=readsp3h(fp,&time,&type,sats,bfact,tsys,&ne);
         
         /* read sp3 body */
-        readsp3b(fp,type,sats,ns,bfact,tsys,j++,opt,nav);
+        readsp3b(fp,type,sats,ns,bfact,tsys,j++,opt,ne,nav);
         
         fclose(fp);
     }
@@ -311,11 +325,15 @@ extern int readsap(const char *file, gtime_t time, nav_t *nav)
     
     if (!readpcv(file,&pcvs)) return 0;
     
+    if (!allocnav(nav,0x100)) {
+        freepcv(&pcvs);
+        return 0;
+    }
     for (i=0;i<MAXSAT;i++) {
         pcv=searchpcv(i+1,"",time,&pcvs);
         nav->pcvs[i]=pcv?*pcv:pcv0;
     }
-    free(pcvs.pcv);
+    freepcv(&pcvs);
     return 1;
 }
 /* read dcb parameters file --------------------------------------------------*/
@@ -657,13 +675,16 @@ extern void satantoff(gtime_t time, const double *rs, int sat, const nav_t *nav,
                       double *dant)
 {
     const double *lam=nav->lam[sat-1];
-    const pcv_t *pcv=nav->pcvs+sat-1;
+    const pcv_t *pcv;
     double ex[3],ey[3],ez[3],es[3],r[3],rsun[3],gmst,erpv[5]={0};
     double gamma,C1,C2,dant1,dant2;
     int i,j=0,k=1;
     
     trace(4,"satantoff: time=%s sat=%2d\n",time_str(time,3),sat);
     
+    if (!nav->pcvs) return;
+    pcv=nav->pcvs+sat-1;
+    
     /* sun position in ecef */
     sunmoonpos(gpst2utc(time),erpv,rsun,NULL,&gmst);
     
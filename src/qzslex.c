@@ -13,6 +13,7 @@
 *           2013/05/11 1.3  fix bugs on decoding message type 12
 *           2013/09/01 1.4  consolidate mt 12 handling codes provided by T.O.
 *           2016/07/29 1.5  crc24q() -> rtk_crc24q()
+*           2026/10/17 1.6  support lex ephemeris and ssr allocated on demand
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -82,7 +83,7 @@ static int decode_lexhealth(const unsigned char *buff, int i, gtime_t tof,
         
         if (j<3) sat=satno(SYS_QZS,j+193);
         else     sat=satno(SYS_GPS,j-2);
-        if (!sat) continue;
+        if (!sat||!allocnav(nav,0x800)) continue;
         
         nav->lexeph[sat-1].tof=tof;
         nav->lexeph[sat-1].health=health;
@@ -130,6 +131,8 @@ static int decode_lexeph(const unsigned char *buff, int i, gtime_t toe,
         trace(2,"lex ephemeris prn error prn=%d\n",prn);
         return i;
     }
+    if (!allocnav(nav,0x800)) return i;
+    
     eph.toe=toe;
     eph.sat=sat;
     tof   =nav->lexeph[sat-1].tof;
@@ -290,7 +293,7 @@ static int lex2rtcm(const unsigned char *msg, int i, unsigned char *buff)
 /* decode type 12: madoca orbit and clock correction -------------------------*/
 static int decode_lextype12(const lexmsg_t *msg, nav_t *nav, gtime_t *tof)
 {
-    static rtcm_t stock_rtcm={0};
+    static ssr_t stock_ssr[MAXSAT],ssr[MAXSAT];
     rtcm_t rtcm={0};
     double tow;
     unsigned char buff[1200];
@@ -302,7 +305,10 @@ static int decode_lextype12(const lexmsg_t *msg, nav_t *nav, gtime_t *tof)
     week=getbitu(msg->msg,i,13); i+=13;
     *tof=gpst2time(week,tow);
     
+    if (!allocnav(nav,0x200)) return 0;
+    
     /* copy rtcm ssr corrections */
+    rtcm.ssr=ssr;
     for (k=0;k<MAXSAT;k++) {
         rtcm.ssr[k]=nav->ssr[k];
         rtcm.ssr[k].update=0;
@@ -324,42 +330,42 @@ static int decode_lextype12(const lexmsg_t *msg, nav_t *nav, gtime_t *tof)
                 rtcm.ssr[k].update=0;
                 
                 if (rtcm.ssr[k].t0[3].time){      /* ura */
-                    stock_rtcm.ssr[k].t0[3]=rtcm.ssr[k].t0[3];
-                    stock_rtcm.ssr[k].udi[3]=rtcm.ssr[k].udi[3];
-                    stock_rtcm.ssr[k].iod[3]=rtcm.ssr[k].iod[3];
-                    stock_rtcm.ssr[k].ura=rtcm.ssr[k].ura;
+                    stock_ssr[k].t0[3]=rtcm.ssr[k].t0[3];
+                    stock_ssr[k].udi[3]=rtcm.ssr[k].udi[3];
+                    stock_ssr[k].iod[3]=rtcm.ssr[k].iod[3];
+                    stock_ssr[k].ura=rtcm.ssr[k].ura;
                 }
                 if (rtcm.ssr[k].t0[2].time){      /* hr-clock correction*/
                     
                     /* convert hr-clock correction to clock correction*/
-                    stock_rtcm.ssr[k].t0[1]=rtcm.ssr[k].t0[2];
-                    stock_rtcm.ssr[k].udi[1]=rtcm.ssr[k].udi[2];
-                    stock_rtcm.ssr[k].iod[1]=rtcm.ssr[k].iod[2];
-                    stock_rtcm.ssr[k].dclk[0]=rtcm.ssr[k].hrclk;
-                    stock_rtcm.ssr[k].dclk[1]=stock_rtcm.ssr[k].dclk[2]=0.0;
+                    stock_ssr[k].t0[1]=rtcm.ssr[k].t0[2];
+                    stock_ssr[k].udi[1]=rtcm.ssr[k].udi[2];
+                    stock_ssr[k].iod[1]=rtcm.ssr[k].iod[2];
+                    stock_ssr[k].dclk[0]=rtcm.ssr[k].hrclk;
+                    stock_ssr[k].dclk[1]=stock_ssr[k].dclk[2]=0.0;
                     
                     /* activate orbit correction(60.0s is tentative) */
-                    if((stock_rtcm.ssr[k].iod[0]==rtcm.ssr[k].iod[2]) &&
-                       (timediff(stock_rtcm.ssr[k].t0[0],rtcm.ssr[k].t0[2]) < 60.0)){
-                        rtcm.ssr[k] = stock_rtcm.ssr[k];
+                    if((stock_ssr[k].iod[0]==rtcm.ssr[k].iod[2]) &&
+                       (timediff(stock_ssr[k].t0[0],rtcm.ssr[k].t0[2]) < 60.0)){
+                        rtcm.ssr[k] = stock_ssr[k];
                     }
                     else continue; /* not apply */
                 }
                 else if (rtcm.ssr[k].t0[0].time){ /* orbit correction*/
-                    stock_rtcm.ssr[k].t0[0]=rtcm.ssr[k].t0[0];
-                    stock_rtcm.ssr[k].udi[0]=rtcm.ssr[k].udi[0];
-                    stock_rtcm.ssr[k].iod[0]=rtcm.ssr[k].iod[0];
+                    stock_ssr[k].t0[0]=rtcm.ssr[k].t0[0];
+                    stock_ssr[k].udi[0]=rtcm.ssr[k].udi[0];
+                    stock_ssr[k].iod[0]=rtcm.ssr[k].iod[0];
                     for (l=0;l<3;l++) {
-                        stock_rtcm.ssr[k].deph [l]=rtcm.ssr[k].deph [l];
-                        stock_rtcm.ssr[k].ddeph[l]=rtcm.ssr[k].ddeph[l];
+                        stock_ssr[k].deph [l]=rtcm.ssr[k].deph [l];
+                        stock_ssr[k].ddeph[l]=rtcm.ssr[k].ddeph[l];
                     }
-                    stock_rtcm.ssr[k].iode=rtcm.ssr[k].iode;
-                    stock_rtcm.ssr[k].refd=rtcm.ssr[k].refd;
+                    stock_ssr[k].iode=rtcm.ssr[k].iode;
+                    stock_ssr[k].refd=rtcm.ssr[k].refd;
                     
                     /* activate clock correction(60.0s is tentative) */
-                    if((stock_rtcm.ssr[k].iod[1]==rtcm.ssr[k].iod[0]) &&
-                      (timediff(stock_rtcm.ssr[k].t0[1],rtcm.ssr[k].t0[0]) < 60.0)){
-                        rtcm.ssr[k] = stock_rtcm.ssr[k];
+                    if((stock_ssr[k].iod[1]==rtcm.ssr[k].iod[0]) &&
+                      (timediff(stock_ssr[k].t0[1],rtcm.ssr[k].t0[0]) < 60.0)){
+                        rtcm.ssr[k] = stock_ssr[k];
                     }
                     else continue; /* not apply */
                 }
@@ -553,7 +559,7 @@ extern int lexeph2pos(gtime_t time, int sat, const nav_t *nav, double *rs,
     
     trace(3,"lexsatpos: time=%s sat=%2d\n",time_str(time,3),sat);
     
-    if (!sat) return 0;
+    if (!sat||!nav->lexeph) return 0;
     
     eph=nav->lexeph+sat-1;
     
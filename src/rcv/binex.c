@@ -1043,7 +1043,7 @@ static unsigned char *decode_bnx_7f_05_obs(raw_t *raw, unsigned char *buff,
     /* get code priority */
     for (i=0;i<nobs;i++) {
         code2obs(codes[code[i]&0x3F],freq+i);
-        pri[i]=getcodepri(sys,codes[code[i]&0x3F],raw->opt);
+        pri[i]=tblcodepri(&raw->codepri,sys,codes[code[i]&0x3F]);
         
         /* frequency index for beidou */
         if (sys==SYS_CMP) {
@@ -1118,6 +1118,7 @@ static int decode_bnx_7f_05(raw_t *raw, unsigned char *buff, int len)
     
     trace(4,"decode_bnx_7f_05\n");
     
+    updcodepri(&raw->codepri,raw->opt);
     raw->obs.n=0;
     flag=U1(p++);
     nsat=(int)(flag&0x3F)+1;
@@ -225,6 +225,7 @@ static int decode_rangecmpb(raw_t *raw)
     int track,plock,clock,parity,halfc,lli;
     char *msg;
     unsigned char *p=raw->buff+CNAVHLEN;
+    rawsat_t *rs;
     
     trace(3,"decode_rangecmpb: len=%d\n",raw->len);
     
@@ -270,9 +271,10 @@ static int decode_rangecmpb(raw_t *raw)
         lockt=(U4(p+18)&0x1FFFFF)/32.0; /* lock time */
         if (lockt<2) parity=0; /* pseudo-parity */
         
-        if (raw->tobs[sat-1][pos].time!=0) {
-            tt=timediff(raw->time,raw->tobs[sat-1][pos]);
-            lli=(lockt<65535.968&&lockt-raw->lockt[sat-1][pos]+0.05<=tt)?LLI_SLIP:0;
+        rs=rawsat(raw,sat);
+        if (rs->tobs[pos].time!=0) {
+            tt=timediff(raw->time,rs->tobs[pos]);
+            lli=(lockt<65535.968&&lockt-rs->lockt[pos]+0.05<=tt)?LLI_SLIP:0;
         }
         else {
             lli=0;
@@ -282,11 +284,11 @@ static int decode_rangecmpb(raw_t *raw)
 #if 0
         if (halfc  ) lli|=LLI_HALFA;
 #else
-        if (halfc!=raw->halfc[sat-1][pos]) lli|=LLI_SLIP;
+        if (halfc!=rs->halfc[pos]) lli|=LLI_SLIP;
 #endif
-        raw->tobs [sat-1][pos]=raw->time;
-        raw->lockt[sat-1][pos]=lockt;
-        raw->halfc[sat-1][pos]=halfc;
+        rs->tobs[pos]=raw->time;
+        rs->lockt[pos]=lockt;
+        rs->halfc[pos]=halfc;
         
         snr=((U2(p+20)&0x3FF)>>5)+20.0;
         if ((sys!=SYS_GAL&&!clock)||(sys==SYS_GAL&&!plock)) psr=0.0;     /* code unlock */
@@ -322,6 +324,7 @@ static int decode_rangeb(raw_t *raw)
     int i,index,nobs,prn,sat,sys,code,freq,pos;
     int track,plock,clock,parity,halfc,lli,gfrq;
     unsigned char *p=raw->buff+CNAVHLEN;
+    rawsat_t *rs;
     
     trace(3,"decode_rangeb: len=%d\n",raw->len);
     
@@ -365,18 +368,19 @@ static int decode_rangeb(raw_t *raw)
         if (sys==SYS_GLO&&raw->nav.geph[prn-1].sat!=sat) {
             raw->nav.geph[prn-1].frq=gfrq-7;
         }
-        if (raw->tobs[sat-1][pos].time!=0) {
-            tt=timediff(raw->time,raw->tobs[sat-1][pos]);
-            lli=lockt-raw->lockt[sat-1][pos]+0.05<=tt?LLI_SLIP:0;
+        rs=rawsat(raw,sat);
+        if (rs->tobs[pos].time!=0) {
+            tt=timediff(raw->time,rs->tobs[pos]);
+            lli=lockt-rs->lockt[pos]+0.05<=tt?LLI_SLIP:0;
         }
         else {
             lli=0;
         }
         if (!parity) lli|=LLI_HALFC;
         if (halfc  ) lli|=LLI_HALFA;
-        raw->tobs [sat-1][pos]=raw->time;
-        raw->lockt[sat-1][pos]=lockt;
-        raw->halfc[sat-1][pos]=halfc;
+        rs->tobs[pos]=raw->time;
+        rs->lockt[pos]=lockt;
+        rs->halfc[pos]=halfc;
         
         if (!clock) psr=0.0;     /* code unlock */
         if (!plock) adr=dop=0.0; /* phase unlock */
@@ -554,6 +558,7 @@ static int decode_qzssrawephemb(raw_t *raw)
     eph_t eph={0};
     char *msg;
     int i,prn,id,sat;
+    rawsat_t *rs;
     
     trace(3,"decode_qzssrawephemb: len=%d\n",raw->len);
     
@@ -574,13 +579,14 @@ static int decode_qzssrawephemb(raw_t *raw)
     }
     if (id<1||3<id) return 0;
     
-    q=raw->subfrm[sat-1]+(id-1)*30;
+    rs=rawsat(raw,sat);
+    q=rs->subfrm+(id-1)*30;
     for (i=0;i<30;i++) *q++=p[8+i];
     
     if (id<3) return 0;
-    if (decode_frame(raw->subfrm[sat-1]   ,&eph,NULL,NULL,NULL,NULL)!=1||
-        decode_frame(raw->subfrm[sat-1]+30,&eph,NULL,NULL,NULL,NULL)!=2||
-        decode_frame(raw->subfrm[sat-1]+60,&eph,NULL,NULL,NULL,NULL)!=3) {
+    if (decode_frame(rs->subfrm   ,&eph,NULL,NULL,NULL,NULL)!=1||
+        decode_frame(rs->subfrm+30,&eph,NULL,NULL,NULL,NULL)!=2||
+        decode_frame(rs->subfrm+60,&eph,NULL,NULL,NULL,NULL)!=3) {
         return 0;
     }
     if (!strstr(raw->opt,"-EPHALL")) {
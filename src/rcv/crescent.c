@@ -100,6 +100,7 @@ static int decode_cresraw(raw_t *raw)
     int i,j,n,prn,sat,week,word2,lli=0;
     unsigned int word1,sn,sc;
     unsigned char *p=raw->buff+8;
+    rawsat_t *rs;
     
     trace(4,"decode_cresraw: len=%d\n",raw->len);
     
@@ -130,10 +131,11 @@ static int decode_cresraw(raw_t *raw)
         sn =(word1>>8)&0xFF;
         snr=sn==0?0.0:10.0*log10(0.8192*sn)+SNR2CN0_L1;
         sc =(unsigned int)(word1>>24);
+        rs=rawsat(raw,sat);
         if (raw->time.time!=0) {
-            lli=(int)((unsigned char)sc-(unsigned char)raw->lockt[sat-1][0])>0;
+            lli=(int)((unsigned char)sc-(unsigned char)rs->lockt[0])>0;
         }
-        raw->lockt[sat-1][0]=(unsigned char)sc;
+        rs->lockt[0]=(unsigned char)sc;
         dop=word2/16/4096.0;
         
         raw->obs.data[n].time=time;
@@ -165,6 +167,7 @@ static int decode_cresraw2(raw_t *raw)
     int i,j,n=0,prn,sat,week,lli[2]={0};
     unsigned int word1,word2,word3,sc,sn;
     unsigned char *p=raw->buff+8;
+    rawsat_t *rs;
     
     trace(4,"decode_cresraw2: len=%d\n",raw->len);
     
@@ -199,14 +202,15 @@ static int decode_cresraw2(raw_t *raw)
         sn=word1&0xFFF;
         snr[0]=sn==0?0.0:10.0*log10(0.1024*sn)+SNR2CN0_L1;
         sc=(unsigned int)(word1>>24);
+        rs=rawsat(raw,sat);
         if (raw->time.time!=0) {
-            lli[0]=(int)((unsigned char)sc-(unsigned char)raw->lockt[sat-1][0])>0;
+            lli[0]=(int)((unsigned char)sc-(unsigned char)rs->lockt[0])>0;
         }
         else {
             lli[0]=0;
         }
         lli[0]|=((word1>>12)&7)?2:0;
-        raw->lockt[sat-1][0]=(unsigned char)sc;
+        rs->lockt[0]=(unsigned char)sc;
         dop[0]=((word2>>1)&0x7FFFFF)/512.0;
         if ((word2>>24)&1) dop[0]=-dop[0];
         pr[0]=pr1+(word3&0xFFFF)/256.0;
@@ -223,13 +227,13 @@ static int decode_cresraw2(raw_t *raw)
             snr[1]=sn==0?0.0:10.0*log10(0.1164*sn)+SNR2CN0_L2;
             sc=(unsigned int)(word1>>24);
             if (raw->time.time==0) {
-                lli[1]=(int)((unsigned char)sc-(unsigned char)raw->lockt[sat-1][1])>0;
+                lli[1]=(int)((unsigned char)sc-(unsigned char)rs->lockt[1])>0;
             }
             else {
                 lli[1]=0;
             }
             lli[1]|=((word1>>12)&7)?2:0;
-            raw->lockt[sat-1][1]=(unsigned char)sc;
+            rs->lockt[1]=(unsigned char)sc;
             dop[1]=((word2>>1)&0x7FFFFF)/512.0;
             if ((word2>>24)&1) dop[1]=-dop[1];
             pr[1]=(word3&0xFFFF)/256.0;
@@ -366,6 +370,7 @@ static int decode_cresgloraw(raw_t *raw)
     int i,j,n=0,prn,sat,week,lli[2]={0};
     unsigned int word1,word2,word3,sc,sn;
     unsigned char *p=raw->buff+8;
+    rawsat_t *rs;
     
     trace(4,"decode_cregloraw: len=%d\n",raw->len);
     
@@ -403,14 +408,15 @@ static int decode_cresgloraw(raw_t *raw)
         sn=word1&0xFFF;
         snr[0]=sn==0?0.0:10.0*log10(0.1024*sn)+SNR2CN0_L1;
         sc=(unsigned int)(word1>>24);
+        rs=rawsat(raw,sat);
         if (raw->time.time!=0) {
-            lli[0]=(int)((unsigned char)sc-(unsigned char)raw->lockt[sat-1][0])>0;
+            lli[0]=(int)((unsigned char)sc-(unsigned char)rs->lockt[0])>0;
         }
         else {
             lli[0]=0;
         }
         lli[0]|=((word1>>12)&7)?2:0;
-        raw->lockt[sat-1][0]=(unsigned char)sc;
+        rs->lockt[0]=(unsigned char)sc;
         dop[0]=((word2>>1)&0x7FFFFF)/512.0;
         if ((word2>>24)&1) dop[0]=-dop[0];
         pr[0]=pr1+(word3&0xFFFF)/256.0;
@@ -427,13 +433,13 @@ static int decode_cresgloraw(raw_t *raw)
         snr[1]=sn==0?0.0:10.0*log10(0.1164*sn)+SNR2CN0_L2;
         sc=(unsigned int)(word1>>24);
         if (raw->time.time==0) {
-            lli[1]=(int)((unsigned char)sc-(unsigned char)raw->lockt[sat-1][1])>0;
+            lli[1]=(int)((unsigned char)sc-(unsigned char)rs->lockt[1])>0;
         }
         else {
             lli[1]=0;
         }
         lli[1]|=((word1>>12)&7)?2:0;
-        raw->lockt[sat-1][1]=(unsigned char)sc;
+        rs->lockt[1]=(unsigned char)sc;
         dop[1]=((word2>>1)&0x7FFFFF)/512.0;
         if ((word2>>24)&1) dop[1]=-dop[1];
         pr[1]=(word3&0xFFFF)/256.0;
@@ -476,6 +482,7 @@ static int decode_cresgloeph(raw_t *raw)
     geph_t geph={0};
     unsigned char *p=raw->buff+8,str[12];
     int i,j,k,sat,prn,frq,time,no;
+    rawsat_t *rs;
     
     trace(4,"decode_cregloeph: len=%d\n",raw->len);
     
@@ -489,6 +496,8 @@ static int decode_cresgloeph(raw_t *raw)
         trace(2,"creasent bin 65 satellite number error: prn=%d\n",prn);
         return -1;
     }
+    rs=rawsat(raw,sat);
+    
     for (i=0;i<5;i++) {
         for (j=0;j<3;j++) for (k=3;k>=0;k--) {
             str[k+j*4]=U1(p++);
@@ -498,11 +507,11 @@ static int decode_cresgloeph(raw_t *raw)
                   i+1,no);
             return -1;
         }
-        memcpy(raw->subfrm[sat-1]+10*i,str,10);
+        memcpy(rs->subfrm+10*i,str,10);
     }
     /* decode glonass ephemeris strings */
     geph.tof=raw->time;
-    if (!decode_glostr(raw->subfrm[sat-1],&geph)||geph.sat!=sat) return -1;
+    if (!decode_glostr(rs->subfrm,&geph)||geph.sat!=sat) return -1;
     geph.frq=frq;
     
     if (!strstr(raw->opt,"-EPHALL")) {
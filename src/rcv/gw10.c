@@ -194,6 +194,7 @@ static int decode_gw10gps(raw_t *raw)
     unsigned int buff=0;
     int i,prn,sat,id,leaps;
     unsigned char *p=raw->buff+2,subfrm[30];
+    rawsat_t *rs;
     
     trace(4,"decode_gw10gps: len=%d\n",raw->len);
     
@@ -219,12 +220,13 @@ static int decode_gw10gps(raw_t *raw)
         trace(2,"gw10 gps frame id error: tow=%.1f prn=%2d id=%d\n",tow,prn,id);
         return -1;
     }
-    for (i=0;i<30;i++) raw->subfrm[sat-1][i+(id-1)*30]=subfrm[i];
+    rs=rawsat(raw,sat);
+    for (i=0;i<30;i++) rs->subfrm[i+(id-1)*30]=subfrm[i];
     
     if (id==3) { /* decode ephemeris */
-        if (decode_frame(raw->subfrm[sat-1]   ,&eph,NULL,NULL,NULL,NULL)!=1||
-            decode_frame(raw->subfrm[sat-1]+30,&eph,NULL,NULL,NULL,NULL)!=2||
-            decode_frame(raw->subfrm[sat-1]+60,&eph,NULL,NULL,NULL,NULL)!=3) {
+        if (decode_frame(rs->subfrm   ,&eph,NULL,NULL,NULL,NULL)!=1||
+            decode_frame(rs->subfrm+30,&eph,NULL,NULL,NULL,NULL)!=2||
+            decode_frame(rs->subfrm+60,&eph,NULL,NULL,NULL,NULL)!=3) {
             return 0;
         }
         if (!strstr(raw->opt,"-EPHALL")) {
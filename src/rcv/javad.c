@@ -44,6 +44,7 @@
 *                           fix bug on saving galileo bgd to ephemeris
 *                           add receiver option -GALINAV, -GALFNAV
 *           2019/05/10 1.15 save galileo E5b data to obs index 2
+*           2026/10/17 1.16 fix out-of-bounds access by invalid sat in decode_TC()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -262,7 +263,9 @@ static int flushobuf(raw_t *raw)
             raw->obuf.data[i].code[j]=CODE_NONE;
         }
     }
-    for (i=0;i<MAXSAT;i++) raw->prCA[i]=raw->dpCA[i]=0.0;
+    for (i=0;i<MAXSAT;i++) {
+        if (raw->sats[i]) raw->sats[i]->prCA=raw->sats[i]->dpCA=0.0;
+    }
     return n>0?1:0;
 }
 /* decode [~~] receiver time -------------------------------------------------*/
@@ -865,7 +868,7 @@ static int decode_L1nav(unsigned char *buff, int len, int sat, raw_t *raw)
         trace(2,"navigation subframe format error: id=%d\n",id);
         return 0;
     }
-    subfrm=raw->subfrm[sat-1];
+    subfrm=rawsat(raw,sat)->subfrm;
     
     for (i=0,p=subfrm+(id-1)*30;i<10;i++) {
         word=U4((unsigned char*)buff+i*4)>>6;
@@ -1058,6 +1061,7 @@ static int decode_lD(raw_t *raw)
     unsigned char *p=raw->buff+5;
     char *msg;
     int i,sat,prn,frq,time,type,len,id;
+    rawsat_t *rs;
     
     if (!checksum(raw->buff,raw->len)) {
         trace(2,"javad lD checksum error: len=%d\n",raw->len);
@@ -1090,15 +1094,16 @@ static int decode_lD(raw_t *raw)
     if ((id=(U4(p)>>20)&0xF)<1) return 0;
     
     /* get 77 bit (25x3+2) in frame without hamming and time mark */
+    rs=rawsat(raw,sat);
     for (i=0;i<4;i++) {
-        setbitu(raw->subfrm[sat-1]+(id-1)*10,i*25,i<3?25:2,
+        setbitu(rs->subfrm+(id-1)*10,i*25,i<3?25:2,
                 U4(p+4*i)>>(i<3?0:23));
     }
     if (id!=4) return 0;
     
     /* decode glonass ephemeris strings */
     geph.tof=raw->time;
-    if (!decode_glostr(raw->subfrm[sat-1],&geph)||geph.sat!=sat) return -1;
+    if (!decode_glostr(rs->subfrm,&geph)||geph.sat!=sat) return -1;
     geph.frq=frq;
     
     if (!strstr(raw->opt,"-EPHALL")) {
@@ -1198,7 +1203,7 @@ static int decode_Rx(raw_t *raw, char code)
         
         prm=pr*CLIGHT;
         
-        if (code=='C') raw->prCA[sat-1]=prm;
+        if (code=='C') rawsat(raw,sat)->prCA=prm;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1244,7 +1249,7 @@ static int decode_rx(raw_t *raw, char code)
         else if (sys==SYS_IRN) prm=(pr*2E-11+0.105)*CLIGHT; /* [6] */
         else                   prm=(pr*1E-11+0.075)*CLIGHT;
         
-        if (code=='c') raw->prCA[sat-1]=prm;
+        if (code=='c') rawsat(raw,sat)->prCA=prm;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1262,6 +1267,7 @@ static int decode_xR(raw_t *raw, char code)
     float pr;
     int i,j,freq,type,sat,sys;
     unsigned char *p=raw->buff+5;
+    rawsat_t *rs;
     
     if (!is_meas(code)||raw->tod<0||raw->obuf.n==0) return 0;
     
@@ -1277,13 +1283,14 @@ static int decode_xR(raw_t *raw, char code)
         pr=R4(p); p+=4; if (pr==0.0) continue;
         
         sat=raw->obuf.data[i].sat;
-        if (!(sys=satsys(sat,NULL))||raw->prCA[sat-1]==0.0) continue;
+        rs=rawsat(raw,sat);
+        if (!(sys=satsys(sat,NULL))||rs->prCA==0.0) continue;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
         if ((j=checkpri(raw->opt,sys,type,freq))>=0) {
             if (!settag(raw->obuf.data+i,raw->time)) continue;
-            raw->obuf.data[i].P[j]=pr*CLIGHT+raw->prCA[sat-1];
+            raw->obuf.data[i].P[j]=pr*CLIGHT+rs->prCA;
             raw->obuf.data[i].code[j]=type;
         }
     }
@@ -1296,6 +1303,7 @@ static int decode_xr(raw_t *raw, char code)
     short pr;
     int i,j,freq,type,sat,sys;
     unsigned char *p=raw->buff+5;
+    rawsat_t *rs;
     
     if (!is_meas(code)||raw->tod<0||raw->obuf.n==0) return 0;
     
@@ -1311,9 +1319,10 @@ static int decode_xr(raw_t *raw, char code)
         pr=I2(p); p+=2; if (pr==(short)0x7FFF) continue;
         
         sat=raw->obuf.data[i].sat;
-        if (!(sys=satsys(sat,NULL))||raw->prCA[sat-1]==0.0) continue;
+        rs=rawsat(raw,sat);
+        if (!(sys=satsys(sat,NULL))||rs->prCA==0.0) continue;
         
-        prm=(pr*1E-11+2E-7)*CLIGHT+raw->prCA[sat-1];
+        prm=(pr*1E-11+2E-7)*CLIGHT+rs->prCA;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1395,6 +1404,7 @@ static int decode_xP(raw_t *raw, char code)
     double cp,rcp,fn;
     int i,j,freq,type,sat,sys;
     unsigned char *p=raw->buff+5;
+    rawsat_t *rs;
     
     if (!is_meas(code)||raw->tod<0||raw->obuf.n==0) return 0;
     
@@ -1410,7 +1420,8 @@ static int decode_xP(raw_t *raw, char code)
         rcp=R4(p); p+=4; if (rcp==0.0) continue;
         
         sat=raw->obuf.data[i].sat;
-        if (!(sys=satsys(sat,NULL))||raw->prCA[sat-1]==0.0) continue;
+        rs=rawsat(raw,sat);
+        if (!(sys=satsys(sat,NULL))||rs->prCA==0.0) continue;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1418,7 +1429,7 @@ static int decode_xP(raw_t *raw, char code)
             if (!settag(raw->obuf.data+i,raw->time)) continue;
             
             fn=freq_sys(sys,freq,raw->freqn[i]);
-            cp=(rcp+raw->prCA[sat-1]/CLIGHT)*fn;
+            cp=(rcp+rs->prCA/CLIGHT)*fn;
             
             raw->obuf.data[i].L[j]=cp;
             raw->obuf.data[i].code[j]=type;
@@ -1432,6 +1443,7 @@ static int decode_xp(raw_t *raw, char code)
     double cp,fn;
     int i,j,rcp,freq,type,sat,sys;
     unsigned char *p=raw->buff+5;
+    rawsat_t *rs;
     
     if (!is_meas(code)||raw->tod<0||raw->obuf.n==0) return 0;
     
@@ -1447,7 +1459,8 @@ static int decode_xp(raw_t *raw, char code)
         rcp=I4(p); p+=4; if (rcp==0x7FFFFFFF) continue;
         
         sat=raw->obuf.data[i].sat;
-        if (!(sys=satsys(sat,NULL))||raw->prCA[sat-1]==0.0) continue;
+        rs=rawsat(raw,sat);
+        if (!(sys=satsys(sat,NULL))||rs->prCA==0.0) continue;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1455,7 +1468,7 @@ static int decode_xp(raw_t *raw, char code)
             if (!settag(raw->obuf.data+i,raw->time)) continue;
             
             fn=freq_sys(sys,freq,raw->freqn[i]);
-            cp=(rcp*P2_40+raw->prCA[sat-1]/CLIGHT)*fn;
+            cp=(rcp*P2_40+rs->prCA/CLIGHT)*fn;
             
             raw->obuf.data[i].L[j]=cp;
             raw->obuf.data[i].code[j]=type;
@@ -1488,7 +1501,7 @@ static int decode_Dx(raw_t *raw, char code)
         
         dop=-dp*1E-4;
         
-        if (code=='C') raw->dpCA[sat-1]=dop;
+        if (code=='C') rawsat(raw,sat)->dpCA=dop;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1506,6 +1519,7 @@ static int decode_xd(raw_t *raw, char code)
     short rdp;
     int i,j,freq,type,sat,sys;
     unsigned char *p=raw->buff+5;
+    rawsat_t *rs;
     
     if (!is_meas(code)||raw->tod<0||raw->obuf.n==0) return 0;
     
@@ -1521,7 +1535,8 @@ static int decode_xd(raw_t *raw, char code)
         rdp=I2(p); p+=2; if (rdp==(short)0x7FFF) continue;
         
         sat=raw->obuf.data[i].sat;
-        if (!(sys=satsys(sat,NULL))||raw->dpCA[sat-1]==0.0) continue;
+        rs=rawsat(raw,sat);
+        if (!(sys=satsys(sat,NULL))||rs->dpCA==0.0) continue;
         
         if ((freq=tofreq(code,sys,&type))<0) continue;
         
@@ -1529,7 +1544,7 @@ static int decode_xd(raw_t *raw, char code)
             if (!settag(raw->obuf.data+i,raw->time)) continue;
             f1=freq_sys(sys,0   ,raw->freqn[i]);
             fn=freq_sys(sys,freq,raw->freqn[i]);
-            dop=(-rdp+raw->dpCA[sat-1]*1E4)*fn/f1*1E-4;
+            dop=(-rdp+rs->dpCA*1E4)*fn/f1*1E-4;
             
             raw->obuf.data[i].D[j]=(float)dop;
         }
@@ -1643,6 +1658,7 @@ static int decode_TC(raw_t *raw)
     unsigned short tt,tt_p;
     int i,sat;
     unsigned char *p=raw->buff+5;
+    rawsat_t *rs;
     
     if (raw->obuf.n==0) return 0;
     
@@ -1660,7 +1676,9 @@ static int decode_TC(raw_t *raw)
         if (!settag(raw->obuf.data+i,raw->time)) continue;
         
         sat=raw->obuf.data[i].sat;
-        tt_p=(unsigned short)raw->lockt[sat-1][0];
+        if (sat<1||sat>MAXSAT) continue; /* unknown or glonass w/o slot */
+        rs=rawsat(raw,sat);
+        tt_p=(unsigned short)rs->lockt[0];
         
         trace(4,"%s: sat=%2d tt=%6d->%6d\n",time_str(raw->time,3),sat,tt_p,tt);
         
@@ -1670,7 +1688,7 @@ static int decode_TC(raw_t *raw)
                   time_str(raw->time,3),sat,tt_p,tt);
             raw->obuf.data[i].LLI[0]|=1;
         }
-        raw->lockt[sat-1][0]=tt;
+        rs->lockt[0]=tt;
     }
     return 0;
 }
@@ -59,6 +59,7 @@ static int decode_xf5raw(raw_t *raw)
     int i,j,prn,sat,n=0,nsat,week;
     unsigned char *p=raw->buff+2;
     char *q,tstr[32],flag;
+    rawsat_t *rs;
     
     trace(4,"decode_xf5raw: len=%d\n",raw->len);
     
@@ -141,8 +142,9 @@ static int decode_xf5raw(raw_t *raw)
         
         /* set LLI if meas flag 4 (carrier phase present) off -> on */
         flag=U1(p+28);
-        raw->obs.data[n].LLI[0]=(flag&0x08)&&!(raw->halfc[sat-1][0]&0x08)?1:0;
-        raw->halfc[sat-1][0]=flag;
+        rs=rawsat(raw,sat);
+        raw->obs.data[n].LLI[0]=(flag&0x08)&&!(rs->halfc[0]&0x08)?1:0;
+        rs->halfc[0]=flag;
         
 #if 0
         if (raw->obs.data[n].SNR[0] > 160) {
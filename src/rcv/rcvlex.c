@@ -14,6 +14,7 @@
 *           2013/06/02 1.1 fix bug on unable compile
 *           2014/10/26 1.2 suppress warning on type-punning pointer
 *           2017/04/11 1.3 (char *) -> (signed char *)
+*           2026/10/17 1.4 no static crc table in crc32r()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -55,21 +56,14 @@ static double R8(unsigned char *p)
 /* crc-32 parity (ref [2] 15) ------------------------------------------------*/
 static unsigned int crc32r(const unsigned char *buff, int len)
 {
-    static unsigned int crcs[256]={0};
     unsigned int crc;
     int i,j;
     
-    if (!crcs[1]) {
-        for (i=0;i<256;i++) {
-            crc=(unsigned int)i;
-            for (j=0;j<8;j++) {
-                if (crc&1) crc=(crc>>1)^0xEDB88320u; else crc>>=1;
-            }
-            crcs[i]=crc;
-        }
-    }
     for (crc=0xFFFFFFFFu,i=0;i<len;i++) {
-        crc=(crc>>8)^crcs[(int)(crc^buff[i])&255];
+        crc^=buff[i];
+        for (j=0;j<8;j++) {
+            if (crc&1) crc=(crc>>1)^0xEDB88320u; else crc>>=1;
+        }
     }
     return crc^0xFFFFFFFFu;
 }
@@ -81,6 +75,7 @@ static int decode_lexraw(raw_t *raw)
     unsigned char *p=raw->buff+16,lli;
     double clk,pr,dop,adr;
     int i,j,ncpu,cpuid,satid,nsig,type,node,prn,stat,sat,n=0;
+    rawsat_t *rs;
     
     ncpu =U1(p);       p+=1;
     cpuid=U1(p);       p+=1;
@@ -135,12 +130,13 @@ static int decode_lexraw(raw_t *raw)
             if (j!=3) continue;
             
             lli=0;
-            if (ttt<=0.0||ttt*0.001<raw->lockt[sat-1][3]) {
+            rs=rawsat(raw,sat);
+            if (ttt<=0.0||ttt*0.001<rs->lockt[3]) {
                 trace(2,"lexraw loss of lock: t=%s ttt=%6.0f->%6.0f\n",
-                      time_str(raw->time,3),raw->lockt[sat-1][3],ttt*0.001);
+                      time_str(raw->time,3),rs->lockt[3],ttt*0.001);
                 lli=1;
             }
-            raw->lockt[sat-1][3]=ttt*0.001;
+            rs->lockt[3]=ttt*0.001;
             lli|=stat<=4?2:0;
             
             raw->obs.data[n].P[3]=pr;
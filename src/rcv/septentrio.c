@@ -36,6 +36,8 @@
 *           2016/07/29  1.8  crc24q() -> rtk_crc24q() by T.T
 *           2017/04/11  1.9  (char *) -> (signed char *) by T.T
 *           2017/09/01  1.10 suppress warnings
+*           2026/10/17  1.11 allocate sbas corrections on demand
+*                           keep signal lock time in per-satellite state
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -45,8 +47,6 @@
 extern const sbsigpband_t igpband1[][8]; /* SBAS IGP band 0-8 */
 extern const sbsigpband_t igpband2[][5]; /* SBAS IGP band 9-10 */
 
-static unsigned char locktime[255][32];
-
 /* SBF definitions Version 2.9.1 */
 #define SBF_SYNC1   0x24        /* SBF message header sync field 1 (correspond to $) */
 #define SBF_SYNC2   0x40        /* SBF message header sync field 2 (correspont to @)*/
@@ -246,6 +246,7 @@ static int decode_measepoch(raw_t *raw){
     uint8_t ObsInfo,ObsInfo2, offsetMSB;
     double SB1_WaveLength, SB1_Code = 0.0;
     short SB1_FreqNr;
+    rawsat_t *rs;
 
     trace(4,"SBF decode_measepoch: len=%d\n",raw->len);
 
@@ -261,6 +262,8 @@ static int decode_measepoch(raw_t *raw){
 
     time=gpst2time(week, tow*0.001);
 
+    updcodepri(&raw->codepri,raw->opt);
+
     /* number of type1 sub-blocks also equal to number of satellites */
     nsat   = U1(p+6);
 
@@ -367,6 +370,7 @@ static int decode_measepoch(raw_t *raw){
         };
 
         raw->obs.data[n].sat=sat;
+        rs=rawsat(raw,sat);
 
         /* start new observation period */
         if (fabs(timediff(raw->obs.data[0].time,raw->time))>1E-9) {
@@ -398,7 +402,7 @@ static int decode_measepoch(raw_t *raw){
         else                         h = 0;
 #endif
         /* store signal info */
-        if (h<=NFREQ+NEXOBS) {
+        if (h<NFREQ+NEXOBS) {
             raw->obs.data[n].L[h]    = adr;
             raw->obs.data[n].P[h]    = psr;
             raw->obs.data[n].D[h]    = (float)dopplerType1;
@@ -409,9 +413,9 @@ static int decode_measepoch(raw_t *raw){
             if ((ObsInfo&0x4)==0x4) raw->obs.data[n].LLI[h]|=0x2; /* half-cycle ambiguity */
             if (LockTime!=65535){
                 LockTime = LockTime>254?254:LockTime; /* limit locktime to sizeof(unsigned char) */
-                if (locktime[sat][signType1]>LockTime) raw->obs.data[n].LLI[h]|=0x1;
-                raw->lockt[sat][h]       = (unsigned char)LockTime;
-                locktime[sat][signType1] = LockTime;
+                if (rs->locksig[signType1]>LockTime) raw->obs.data[n].LLI[h]|=0x1;
+                rs->lockt[h] = (unsigned char)LockTime;
+                rs->locksig[signType1] = (unsigned char)LockTime;
             };
         }
 
@@ -477,10 +481,10 @@ static int decode_measepoch(raw_t *raw){
             else if (freqType2 == FREQE5ab) h = 5;
             else                         h = 0;
 #endif
-            pri=getcodepri(sys,getSignalCode(signType2),raw->opt); /* get signal priority */
+            pri=tblcodepri(&raw->codepri,sys,getSignalCode(signType2)); /* get signal priority */
             /* store signal info */
-            if ((h<=NFREQ+NEXOBS)&&
-                    (pri>getcodepri(sys,raw->obs.data[n].code[h],raw->opt))) {
+            if ((h<NFREQ+NEXOBS)&&
+                    (pri>tblcodepri(&raw->codepri,sys,raw->obs.data[n].code[h]))) {
                 raw->obs.data[n].L[h]    = Ltype2;
                 raw->obs.data[n].P[h]    = PRtype2;
                 raw->obs.data[n].D[h]    = (float)dopplerType2;
@@ -490,9 +494,9 @@ static int decode_measepoch(raw_t *raw){
                 /* lock to signal indication */
                 if ((ObsInfo2&0x4)==0x4) raw->obs.data[n].LLI[h]|=0x2; /* half-cycle ambiguity */
                 if (LockTime2!=255) {
-                    if (locktime[sat][signType2]>LockTime2) raw->obs.data[n].LLI[h]|=0x1;
-                    raw->lockt[sat][h]       = (unsigned char)LockTime2;
-                    locktime[sat][signType2] = (unsigned char)LockTime2;
+                    if (rs->locksig[signType2]>LockTime2) raw->obs.data[n].LLI[h]|=0x1;
+                    rs->lockt[h] = (unsigned char)LockTime2;
+                    rs->locksig[signType2] = (unsigned char)LockTime2;
                 };
             }
 
@@ -1206,6 +1210,7 @@ static int decode_rawnav(raw_t *raw, int sys){
     int sat,prn;
     uint8_t _buf[30]={0};
     int i=0,ii=0;
+    rawsat_t *rs;
 
     trace(3,"SBF decode_gpsrawcanav: len=%d\n",raw->len);
 
@@ -1242,11 +1247,12 @@ static int decode_rawnav(raw_t *raw, int sys){
      id=getbitu(_buf,43,3); /* get subframe id */
      if ((id < 1) || (id > 5)) return -1;
 
-     memcpy(raw->subfrm[sat-1]+(id-1)*30,_buf,30);
+     rs=rawsat(raw,sat);
+     memcpy(rs->subfrm+(id-1)*30,_buf,30);
 
-     if (decode_frame(raw->subfrm[sat-1]   ,&eph,NULL,NULL,NULL,NULL)==1&&
-         decode_frame(raw->subfrm[sat-1]+30,&eph,NULL,NULL,NULL,NULL)==2&&
-         decode_frame(raw->subfrm[sat-1]+60,&eph,NULL,NULL,NULL,NULL)==3) {
+     if (decode_frame(rs->subfrm   ,&eph,NULL,NULL,NULL,NULL)==1&&
+         decode_frame(rs->subfrm+30,&eph,NULL,NULL,NULL,NULL)==2&&
+         decode_frame(rs->subfrm+60,&eph,NULL,NULL,NULL,NULL)==3) {
 
              if (!strstr(raw->opt,"-EPHALL")) {
                  if ((eph.iode==raw->nav.eph[sat-1].iode)&&
@@ -1259,12 +1265,12 @@ static int decode_rawnav(raw_t *raw, int sys){
      }
      if (id==4) {
          if (sys==SYS_GPS) {
-                 decode_frame(raw->subfrm[sat-1]+90,NULL,raw->nav.alm,raw->nav.ion_gps,
+                 decode_frame(rs->subfrm+90,NULL,raw->nav.alm,raw->nav.ion_gps,
                               raw->nav.utc_gps,&raw->nav.leaps);
                  adj_utcweek(raw->time,raw->nav.utc_gps);
              }
              else if (sys==SYS_QZS) {
-                 decode_frame(raw->subfrm[sat-1]+90,NULL,raw->nav.alm,raw->nav.ion_qzs,
+                 decode_frame(rs->subfrm+90,NULL,raw->nav.alm,raw->nav.ion_qzs,
                               raw->nav.utc_qzs,&raw->nav.leaps);
                  adj_utcweek(raw->time,raw->nav.utc_qzs);
              }
@@ -1272,10 +1278,10 @@ static int decode_rawnav(raw_t *raw, int sys){
      };
      if (id==5) {
          if (sys==SYS_GPS) {
-                 decode_frame(raw->subfrm[sat-1]+120,NULL,raw->nav.alm,NULL,NULL,NULL);
+                 decode_frame(rs->subfrm+120,NULL,raw->nav.alm,NULL,NULL,NULL);
              }
              else if (sys==SYS_QZS) {
-                 decode_frame(raw->subfrm[sat-1]+120,NULL,raw->nav.alm,raw->nav.ion_qzs,
+                 decode_frame(rs->subfrm+120,NULL,raw->nav.alm,raw->nav.ion_qzs,
                               raw->nav.utc_qzs,&raw->nav.leaps);
                  adj_utcweek(raw->time,raw->nav.utc_qzs);
              }
@@ -1342,6 +1348,7 @@ static int decode_galrawinav(raw_t *raw){
     uint8_t type;
     uint8_t part1,part2,page1,page2;
     int i,j;
+    rawsat_t *rs;
 
     p=(raw->buff)+6;
     prn=U1(p+8)-70;
@@ -1388,6 +1395,8 @@ static int decode_galrawinav(raw_t *raw){
         return -1;
     }
 
+    rs=rawsat(raw,sat);
+
     if ((U4(p+14)&0x80)!=0x80) /* E5b-I */
     {
         int pos,i;
@@ -1397,7 +1406,7 @@ static int decode_galrawinav(raw_t *raw){
 
         pos=type*16;
 
-        for (i=0,j=2;i<16;i++,j+=8) raw->subfrm[sat-1][pos++]=getbitu(buff,j,8);
+        for (i=0,j=2;i<16;i++,j+=8) rs->subfrm[pos++]=getbitu(buff,j,8);
     } else
     { /* E1-B */
         int pos,i;
@@ -1408,11 +1417,11 @@ static int decode_galrawinav(raw_t *raw){
 
         pos=type*16;
 
-        for (i=0,j=2;i<16;i++,j+=8) raw->subfrm[sat-1][pos++]=getbitu(buff,j,8);
+        for (i=0,j=2;i<16;i++,j+=8) rs->subfrm[pos++]=getbitu(buff,j,8);
     };
 
     /* decode galileo inav ephemeris */
-    if (!decode_gal_inav(raw->subfrm[sat-1],&eph)) {
+    if (!decode_gal_inav(rs->subfrm,&eph)) {
         return 0; /* incomplete ephemeris */
     }
     /* test svid consistency */
@@ -1439,6 +1448,7 @@ static int decode_glorawcanav(raw_t *raw){
     geph_t geph={0};
     int prn,sat;
     int j,k;
+    rawsat_t *rs;
 
     if (raw->len<12)
     {
@@ -1479,13 +1489,14 @@ static int decode_glorawcanav(raw_t *raw){
         return -1;
     }
 
-    memcpy(raw->subfrm[sat-1]+(m-1)*10,buff,10);
+    rs=rawsat(raw,sat);
+    memcpy(rs->subfrm+(m-1)*10,buff,10);
 
     if (m!=4) return 0;
 
     /* decode glonass ephemeris strings */
     geph.tof=gpst2time(U2(p+6),U4(p+2)/1000);
-    if (!decode_glostr(raw->subfrm[sat-1],&geph)||geph.sat!=sat) return 0;
+    if (!decode_glostr(rs->subfrm,&geph)||geph.sat!=sat) return 0;
     geph.frq=U1(p+12)-8;
 
     if (!strstr(raw->opt,"-EPHALL")) {
@@ -1508,6 +1519,7 @@ static int decode_cmpraw(raw_t *raw){
     uint8_t *p;
     int sat,prn;
     int i,id,pgn;
+    rawsat_t *rs;
 
     p=(raw->buff)+6;
     prn=U1(p+8)-140;
@@ -1531,15 +1543,17 @@ static int decode_cmpraw(raw_t *raw){
         trace(2,"SBF decode_cmprawinav length error: sat=%2d\n",sat);
         return -1;
     }
+    rs=rawsat(raw,sat);
+
     if (prn>=5) { /* IGSO/MEO */
 
         for (i=0;i<10;i++) {
-            setbitu(raw->subfrm[sat-1]+(id-1)*38,i*30,30,words[i]);
+            setbitu(rs->subfrm+(id-1)*38,i*30,30,words[i]);
         }
         if (id!=3) return 0;
 
         /* decode beidou D1 ephemeris */
-        if (!decode_bds_d1(raw->subfrm[sat-1],&eph)) return 0;
+        if (!decode_bds_d1(rs->subfrm,&eph)) return 0;
     }
     else { /* GEO */
         if (id!=1) return 0;
@@ -1551,12 +1565,12 @@ static int decode_cmpraw(raw_t *raw){
             return -1;
         }
         for (i=0;i<10;i++) {
-            setbitu(raw->subfrm[sat-1]+(pgn-1)*38,i*30,30,words[i]);
+            setbitu(rs->subfrm+(pgn-1)*38,i*30,30,words[i]);
                 }
                 if (pgn!=10) return 0;
 
                 /* decode beidou D2 ephemeris */
-                if (!decode_bds_d2(raw->subfrm[sat-1],&eph)) return 0;
+                if (!decode_bds_d2(rs->subfrm,&eph)) return 0;
             }
             if (!strstr(raw->opt,"-EPHALL")) {
                 if (timediff(eph.toe,raw->nav.eph[sat-1].toe)==0.0) return 0; /* unchanged */
@@ -1779,6 +1793,7 @@ static int decode_sbsfast(raw_t *raw)
         trace(1,"SBF decode_sbsfast: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
@@ -1797,28 +1812,28 @@ static int decode_sbsfast(raw_t *raw)
     sbCount=U1(p+12);
     sbLength=U1(p+13);
 
-    if (raw->nav.sbssat.iodp!=U1(p+10)) return 0;
+    if (raw->nav.sbssat->iodp!=U1(p+10)) return 0;
     if (type>5) return -1;
 
     for (i=0;i<sbCount;i++) {
-        if ((j=13*((type==0?2:type)-2)+i)>=raw->nav.sbssat.nsat) break;
-        t0_old =raw->nav.sbssat.sat[j].fcorr.t0;
-        prc_old =raw->nav.sbssat.sat[j].fcorr.prc;
-
-        raw->nav.sbssat.sat[j].fcorr.t0=gpst2time(week,tow);
-        raw->nav.sbssat.sat[j].fcorr.udre=U1(p+14+i*sbLength+1);
-        raw->nav.sbssat.sat[j].fcorr.prc=R4(p+14+i*sbLength+4);
-
-        dt=timediff(raw->nav.sbssat.sat[j].fcorr.t0,t0_old);
-        if (t0_old.time==0||dt<=0.0||18.0<dt||raw->nav.sbssat.sat[j].fcorr.ai==0) {
-            raw->nav.sbssat.sat[j].fcorr.rrc=0.0;
-            raw->nav.sbssat.sat[j].fcorr.dt=0.0;
+        if ((j=13*((type==0?2:type)-2)+i)>=raw->nav.sbssat->nsat) break;
+        t0_old =raw->nav.sbssat->sat[j].fcorr.t0;
+        prc_old =raw->nav.sbssat->sat[j].fcorr.prc;
+
+        raw->nav.sbssat->sat[j].fcorr.t0=gpst2time(week,tow);
+        raw->nav.sbssat->sat[j].fcorr.udre=U1(p+14+i*sbLength+1);
+        raw->nav.sbssat->sat[j].fcorr.prc=R4(p+14+i*sbLength+4);
+
+        dt=timediff(raw->nav.sbssat->sat[j].fcorr.t0,t0_old);
+        if (t0_old.time==0||dt<=0.0||18.0<dt||raw->nav.sbssat->sat[j].fcorr.ai==0) {
+            raw->nav.sbssat->sat[j].fcorr.rrc=0.0;
+            raw->nav.sbssat->sat[j].fcorr.dt=0.0;
         }
         else {
-            raw->nav.sbssat.sat[j].fcorr.rrc=(raw->nav.sbssat.sat[j].fcorr.prc-prc_old)/dt;
-            raw->nav.sbssat.sat[j].fcorr.dt=dt;
+            raw->nav.sbssat->sat[j].fcorr.rrc=(raw->nav.sbssat->sat[j].fcorr.prc-prc_old)/dt;
+            raw->nav.sbssat->sat[j].fcorr.dt=dt;
         }
-        raw->nav.sbssat.sat[j].fcorr.iodf=iodf;
+        raw->nav.sbssat->sat[j].fcorr.iodf=iodf;
     }
     trace(5,"SBF decode_sbsfast: type=%d iodf=%d\n",U1(p+9),iodf);
     return 0;
@@ -1838,15 +1853,16 @@ static int decode_sbsprnmask(raw_t *raw)
         trace(1,"SBF decode_sbsprnmask: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
     if (prn < 120) return -1;
     if (prn > 139) return -1;
 
-    raw->nav.sbssat.nsat=U1(p+10);
+    raw->nav.sbssat->nsat=U1(p+10);
 
-    for (n=0;n<raw->nav.sbssat.nsat&&n<MAXSAT;n++) {
+    for (n=0;n<raw->nav.sbssat->nsat&&n<MAXSAT;n++) {
        i=U1(p+11+n);
        if      (i<= 37) sat=satno(SYS_GPS,i);    /*   0- 37: gps */
        else if (i<= 61) sat=satno(SYS_GLO,i-37); /*  38- 61: glonass */
@@ -1856,11 +1872,11 @@ static int decode_sbsprnmask(raw_t *raw)
        else if (i<=192) sat=satno(SYS_SBS,i+10); /* 183-192: qzss ref [2] */
        else if (i<=202) sat=satno(SYS_QZS,i);    /* 193-202: qzss ref [2] */
        else             sat=0;                   /* 203-   : reserved */
-       raw->nav.sbssat.sat[n].sat=sat;
+       raw->nav.sbssat->sat[n].sat=sat;
     }
-    raw->nav.sbssat.iodp=U1(p+9);
+    raw->nav.sbssat->iodp=U1(p+9);
 
-    trace(5,"SBF decode_sbsprnmask: nprn=%d iodp=%d\n",n,raw->nav.sbssat.iodp);
+    trace(5,"SBF decode_sbsprnmask: nprn=%d iodp=%d\n",n,raw->nav.sbssat->iodp);
     return 0;
 }
 
@@ -1879,6 +1895,7 @@ static int decode_sbsintegriy(raw_t *raw)
         trace(1,"SBF decode_sbsintegriy: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
@@ -1888,10 +1905,10 @@ static int decode_sbsintegriy(raw_t *raw)
     for (i=0;i<4;i++) {
         iodf[i]=U1(p+10+i);
     }
-    for (i=0;i<raw->nav.sbssat.nsat&&i<MAXSAT;i++) {
-        if (raw->nav.sbssat.sat[i].fcorr.iodf!=iodf[i/13]) continue;
+    for (i=0;i<raw->nav.sbssat->nsat&&i<MAXSAT;i++) {
+        if (raw->nav.sbssat->sat[i].fcorr.iodf!=iodf[i/13]) continue;
         udre=U1(p+14+i);
-        raw->nav.sbssat.sat[i].fcorr.udre=udre;
+        raw->nav.sbssat->sat[i].fcorr.udre=udre;
     }
     trace(5,"SBF decode_sbsintegriy: iodf=%d %d %d %d\n",iodf[0],iodf[1],iodf[2],iodf[3]);
     return 0;
@@ -1911,18 +1928,19 @@ static int decode_sbsfastcorrdegr(raw_t *raw)
         trace(1,"SBF decode_sbsfastcorrdegr: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
     if (prn < 120) return -1;
     if (prn > 139) return -1;
 
-    if (raw->nav.sbssat.iodp!=U1(p+9)) return 0;
+    if (raw->nav.sbssat->iodp!=U1(p+9)) return 0;
 
-    raw->nav.sbssat.tlat=U1(p+10);
+    raw->nav.sbssat->tlat=U1(p+10);
 
-    for (i=0;i<raw->nav.sbssat.nsat&&i<MAXSAT;i++) {
-        raw->nav.sbssat.sat[i].fcorr.ai=U1(p+11+i);
+    for (i=0;i<raw->nav.sbssat->nsat&&i<MAXSAT;i++) {
+        raw->nav.sbssat->sat[i].fcorr.ai=U1(p+11+i);
     }
     return 0;
 }
@@ -1943,6 +1961,7 @@ static int decode_sbsionodelay(raw_t *raw)
         trace(1,"SBF decode_sbsionodelay: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
@@ -1998,6 +2017,7 @@ static int decode_sbsigpmask(raw_t *raw) /* TODO: verify this function */
         trace(1,"SBF decode_sbsigpmask: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
@@ -2044,6 +2064,7 @@ static int decode_sbslongcorrh(raw_t* raw)
         trace(1,"SBF decode_sbslongcorrh: Block too short\n");
         return -1;
     }
+    if (!allocnav(&raw->nav,0x1000)) return -1;
 
     /* get satellite number */
     prn=U1(p+8);
@@ -2062,28 +2083,28 @@ static int decode_sbslongcorrh(raw_t* raw)
     for (i=0;i<count;i++)
     {
         no=U1(p+14+i*sbLength+1);
-        raw->nav.sbssat.sat[no-1].lcorr.iode=U1(p+14+i*sbLength+3);
-        raw->nav.sbssat.sat[no-1].lcorr.dpos[0]=R4(p+14+i*sbLength+ 4);
-        raw->nav.sbssat.sat[no-1].lcorr.dpos[1]=R4(p+14+i*sbLength+ 8);
-        raw->nav.sbssat.sat[no-1].lcorr.dpos[2]=R4(p+14+i*sbLength+12);
+        raw->nav.sbssat->sat[no-1].lcorr.iode=U1(p+14+i*sbLength+3);
+        raw->nav.sbssat->sat[no-1].lcorr.dpos[0]=R4(p+14+i*sbLength+ 4);
+        raw->nav.sbssat->sat[no-1].lcorr.dpos[1]=R4(p+14+i*sbLength+ 8);
+        raw->nav.sbssat->sat[no-1].lcorr.dpos[2]=R4(p+14+i*sbLength+12);
         if (U1(p+14+i*sbLength)==1)
         {
-            raw->nav.sbssat.sat[no-1].lcorr.dvel[i]=R4(p+14+i*sbLength+16);
-            raw->nav.sbssat.sat[no-1].lcorr.dvel[i]=R4(p+14+i*sbLength+20);
-            raw->nav.sbssat.sat[no-1].lcorr.dvel[i]=R4(p+14+i*sbLength+24);
+            raw->nav.sbssat->sat[no-1].lcorr.dvel[i]=R4(p+14+i*sbLength+16);
+            raw->nav.sbssat->sat[no-1].lcorr.dvel[i]=R4(p+14+i*sbLength+20);
+            raw->nav.sbssat->sat[no-1].lcorr.dvel[i]=R4(p+14+i*sbLength+24);
 
-            raw->nav.sbssat.sat[no-1].lcorr.daf1=R4(p+14+i*sbLength+32);
+            raw->nav.sbssat->sat[no-1].lcorr.daf1=R4(p+14+i*sbLength+32);
         } else
         {
-            raw->nav.sbssat.sat[no-1].lcorr.dvel[0]=raw->nav.sbssat.sat[no-1].lcorr.dvel[1]=raw->nav.sbssat.sat[no-1].lcorr.dvel[2]=0.0;
-            raw->nav.sbssat.sat[no-1].lcorr.daf1=0;
+            raw->nav.sbssat->sat[no-1].lcorr.dvel[0]=raw->nav.sbssat->sat[no-1].lcorr.dvel[1]=raw->nav.sbssat->sat[no-1].lcorr.dvel[2]=0.0;
+            raw->nav.sbssat->sat[no-1].lcorr.daf1=0;
         };
-        raw->nav.sbssat.sat[no-1].lcorr.daf0=R4(p+14+i*sbLength+28);
+        raw->nav.sbssat->sat[no-1].lcorr.daf0=R4(p+14+i*sbLength+28);
 
         t=(int)U4(p+14+i*sbLength+32)-(int)tow%86400;
         if      (t<=-43200) t+=86400;
         else if (t>  43200) t-=86400;
-        raw->nav.sbssat.sat[no-1].lcorr.t0=gpst2time(week,tow+t);
+        raw->nav.sbssat->sat[no-1].lcorr.t0=gpst2time(week,tow+t);
     };
 
     return 0;
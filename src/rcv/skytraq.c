@@ -146,6 +146,7 @@ static int decode_stqraw(raw_t *raw)
     unsigned char *p=raw->buff+4,ind;
     double pr1,cp1;
     int i,j,iod,prn,sys,sat,n=0,nsat;
+    rawsat_t *rs;
     
     trace(4,"decode_stqraw: len=%d\n",raw->len);
     
@@ -199,11 +200,12 @@ static int decode_stqraw(raw_t *raw)
         raw->obs.data[n].LLI[0]=0;
         raw->obs.data[n].code[0]=sys==SYS_CMP?CODE_L1I:CODE_L1C;
         
-        raw->lockt[sat-1][0]=ind&8?1:0; /* cycle slip */
+        rs=rawsat(raw,sat);
+        rs->lockt[0]=ind&8?1:0; /* cycle slip */
         
         if (raw->obs.data[n].L[0]!=0.0) {
-            raw->obs.data[n].LLI[0]=(unsigned char)raw->lockt[sat-1][0];
-            raw->lockt[sat-1][0]=0;
+            raw->obs.data[n].LLI[0]=(unsigned char)rs->lockt[0];
+            rs->lockt[0]=0;
         }
         /* receiver dependent options */
         if (strstr(raw->opt,"-INVCP")) {
@@ -230,6 +232,7 @@ static int decode_stqrawx(raw_t *raw)
     double tow,peri,pr1,cp1;
     int i,j,ver,week,nsat,sys,sig,prn,sat,n=0;
     int gnss_type, signal_type;
+    rawsat_t *rs;
     
     trace(4,"decode_stqraw: len=%d\n",raw->len);
     
@@ -328,11 +331,12 @@ static int decode_stqrawx(raw_t *raw)
         raw->obs.data[n].LLI[0]=0;
         raw->obs.data[n].code[0]=sys==SYS_CMP?CODE_L1I:CODE_L1C;
         
-        raw->lockt[sat-1][0]=ind&8?1:0; /* cycle slip */
+        rs=rawsat(raw,sat);
+        rs->lockt[0]=ind&8?1:0; /* cycle slip */
         
         if (raw->obs.data[n].L[0]!=0.0) {
-            raw->obs.data[n].LLI[0]=(unsigned char)raw->lockt[sat-1][0];
-            raw->lockt[sat-1][0]=0;
+            raw->obs.data[n].LLI[0]=(unsigned char)rs->lockt[0];
+            rs->lockt[0]=0;
         }
         /* receiver dependent options */
         if (strstr(raw->opt,"-INVCP")) {
@@ -372,7 +376,7 @@ static int save_subfrm(int sat, raw_t *raw)
         trace(2,"stq subframe id error: id=%d\n",id);
         return 0;
     }
-    q=raw->subfrm[sat-1]+(id-1)*30;
+    q=rawsat(raw,sat)->subfrm+(id-1)*30;
     
     for (i=0;i<30;i++) q[i]=p[i];
     
@@ -382,12 +386,14 @@ static int save_subfrm(int sat, raw_t *raw)
 static int decode_ephem(int sat, raw_t *raw)
 {
     eph_t eph={0};
+    rawsat_t *rs;
     
     trace(4,"decode_ephem: sat=%2d\n",sat);
     
-    if (decode_frame(raw->subfrm[sat-1]   ,&eph,NULL,NULL,NULL,NULL)!=1||
-        decode_frame(raw->subfrm[sat-1]+30,&eph,NULL,NULL,NULL,NULL)!=2||
-        decode_frame(raw->subfrm[sat-1]+60,&eph,NULL,NULL,NULL,NULL)!=3) return 0;
+    rs=rawsat(raw,sat);
+    if (decode_frame(rs->subfrm   ,&eph,NULL,NULL,NULL,NULL)!=1||
+        decode_frame(rs->subfrm+30,&eph,NULL,NULL,NULL,NULL)!=2||
+        decode_frame(rs->subfrm+60,&eph,NULL,NULL,NULL,NULL)!=3) return 0;
     
     if (!strstr(raw->opt,"-EPHALL")) {
         if (eph.iode==raw->nav.eph[sat-1].iode&&
@@ -402,16 +408,19 @@ static int decode_ephem(int sat, raw_t *raw)
 static int decode_alm1(int sat, raw_t *raw)
 {
     int sys=satsys(sat,NULL);
+    rawsat_t *rs;
     
     trace(4,"decode_alm1 : sat=%2d\n",sat);
     
+    rs=rawsat(raw,sat);
+    
     if (sys==SYS_GPS) {
-        decode_frame(raw->subfrm[sat-1]+90,NULL,raw->nav.alm,raw->nav.ion_gps,
+        decode_frame(rs->subfrm+90,NULL,raw->nav.alm,raw->nav.ion_gps,
                      raw->nav.utc_gps,&raw->nav.leaps);
         adj_utcweek(raw->time,raw->nav.utc_gps);
     }
     else if (sys==SYS_QZS) {
-        decode_frame(raw->subfrm[sat-1]+90,NULL,raw->nav.alm,raw->nav.ion_qzs,
+        decode_frame(rs->subfrm+90,NULL,raw->nav.alm,raw->nav.ion_qzs,
                      raw->nav.utc_qzs,&raw->nav.leaps);
         adj_utcweek(raw->time,raw->nav.utc_qzs);
     }
@@ -421,14 +430,17 @@ static int decode_alm1(int sat, raw_t *raw)
 static int decode_alm2(int sat, raw_t *raw)
 {
     int sys=satsys(sat,NULL);
+    rawsat_t *rs;
     
     trace(4,"decode_alm2 : sat=%2d\n",sat);
     
+    rs=rawsat(raw,sat);
+    
     if (sys==SYS_GPS) {
-        decode_frame(raw->subfrm[sat-1]+120,NULL,raw->nav.alm,NULL,NULL,NULL);
+        decode_frame(rs->subfrm+120,NULL,raw->nav.alm,NULL,NULL,NULL);
     }
     else if (sys==SYS_QZS) {
-        decode_frame(raw->subfrm[sat-1]+120,NULL,raw->nav.alm,raw->nav.ion_qzs,
+        decode_frame(rs->subfrm+120,NULL,raw->nav.alm,raw->nav.ion_qzs,
                      raw->nav.utc_qzs,&raw->nav.leaps);
         adj_utcweek(raw->time,raw->nav.utc_qzs);
     }
@@ -467,6 +479,7 @@ static int decode_stqglo(raw_t *raw)
     geph_t geph={0};
     int i,prn,sat,m;
     unsigned char *p=raw->buff+4;
+    rawsat_t *rs;
     
     trace(4,"decode_stqglo: len=%d\n",raw->len);
     
@@ -487,15 +500,16 @@ static int decode_stqglo(raw_t *raw)
     if (m<1||4<m) {
         return 0; /* non-immediate info and almanac */
     }
-    setbitu(raw->subfrm[sat-1]+(m-1)*10,1,4,m);
+    rs=rawsat(raw,sat);
+    setbitu(rs->subfrm+(m-1)*10,1,4,m);
     for (i=0;i<9;i++) {
-        setbitu(raw->subfrm[sat-1]+(m-1)*10,5+i*8,8,p[3+i]);
+        setbitu(rs->subfrm+(m-1)*10,5+i*8,8,p[3+i]);
     }
     if (m!=4) return 0;
     
     /* decode glonass ephemeris strings */
     geph.tof=raw->time;
-    if (!decode_glostr(raw->subfrm[sat-1],&geph)||geph.sat!=sat) return 0;
+    if (!decode_glostr(rs->subfrm,&geph)||geph.sat!=sat) return 0;
     
     if (!strstr(raw->opt,"-EPHALL")) {
         if (geph.iode==raw->nav.geph[prn-1].iode) return 0; /* unchanged */
@@ -535,6 +549,7 @@ static int decode_stqbds(raw_t *raw)
     unsigned int word;
     int i,j=0,id,pgn,prn,sat;
     unsigned char *p=raw->buff+4;
+    rawsat_t *rs;
     
     trace(4,"decode_stqbds: len=%d\n",raw->len);
     
@@ -556,18 +571,20 @@ static int decode_stqbds(raw_t *raw)
         trace(2,"stq bds subframe id error: prn=%2d\n",prn);
         return -1;
     }
+    rs=rawsat(raw,sat);
+    
     if (prn>5) { /* IGSO/MEO */
         word=getbitu(p+3,j,26)<<4; j+=26;
-        setbitu(raw->subfrm[sat-1]+(id-1)*38,0,30,word);
+        setbitu(rs->subfrm+(id-1)*38,0,30,word);
         
         for (i=1;i<10;i++) {
             word=getbitu(p+3,j,22)<<8; j+=22;
-            setbitu(raw->subfrm[sat-1]+(id-1)*38,i*30,30,word);
+            setbitu(rs->subfrm+(id-1)*38,i*30,30,word);
         }
         if (id!=3) return 0;
         
         /* decode beidou D1 ephemeris */
-        if (!decode_bds_d1(raw->subfrm[sat-1],&eph)) return 0;
+        if (!decode_bds_d1(rs->subfrm,&eph)) return 0;
     }
     else { /* GEO */
         if (id!=1) return 0;
@@ -578,16 +595,16 @@ static int decode_stqbds(raw_t *raw)
             return -1;
         }
         word=getbitu(p+3,j,26)<<4; j+=26;
-        setbitu(raw->subfrm[sat-1]+(pgn-1)*38,0,30,word);
+        setbitu(rs->subfrm+(pgn-1)*38,0,30,word);
         
         for (i=1;i<10;i++) {
             word=getbitu(p+3,j,22)<<8; j+=22;
-            setbitu(raw->subfrm[sat-1]+(pgn-1)*38,i*30,30,word);
+            setbitu(rs->subfrm+(pgn-1)*38,i*30,30,word);
         }
         if (pgn!=10) return 0;
         
         /* decode beidou D2 ephemeris */
-        if (!decode_bds_d2(raw->subfrm[sat-1],&eph)) return 0;
+        if (!decode_bds_d2(rs->subfrm,&eph)) return 0;
     }
     if (!strstr(raw->opt,"-EPHALL")) {
         if (timediff(eph.toe,raw->nav.eph[sat-1].toe)==0.0&&
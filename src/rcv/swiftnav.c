@@ -323,7 +323,7 @@ static int flushobuf(raw_t *raw) {
     }
   }
   for (i = 0; i < MAXSAT; i++) {
-    raw->prCA[i] = raw->dpCA[i] = 0.0;
+    if (raw->sats[i]) raw->sats[i]->prCA = raw->sats[i]->dpCA = 0.0;
   }
   return n > 0 ? 1 : 0;
 }
@@ -373,6 +373,7 @@ static int decode_msgobs(raw_t *raw) {
   uint8_t flags, sat_id, cn0_int, slip, half_cycle_amb;
   uint32_t code = 0, sys = 0, freq = 0;
   int iDidFlush = 0, iSatFound = 0;
+    rawsat_t *rs;
 
   trace(4, "SBF decode_msgobs: len=%d\n", raw->len);
 
@@ -455,7 +456,8 @@ static int decode_msgobs(raw_t *raw) {
       raw->obuf.data[ii].code[freq] = code;
 
       if (flags & 0x2) {
-        prev_lockt = rtcm_phase_lock_table[(raw->halfc[sat - 1][freq])];
+        rs=rawsat(raw,sat);
+        prev_lockt = rtcm_phase_lock_table[(rs->halfc[freq])];
         curr_lockt = rtcm_phase_lock_table[lock_info];
         slip =
             calculate_loss_of_lock(delta_time * 1000.0, prev_lockt, curr_lockt);
@@ -466,7 +468,7 @@ static int decode_msgobs(raw_t *raw) {
 
         raw->obuf.data[ii].LLI[freq] |= slip;
         /* using the field below just to store previous lock info */
-        raw->halfc[sat - 1][freq] = lock_info;
+        rs->halfc[freq] = lock_info;
       }
     }
 
@@ -196,6 +196,7 @@ static int decode_rangeb(raw_t *raw)
     int i,index,nobs,prn,sat,sys,code,freq,pos;
     int track,plock,clock,parity,halfc,lli,gfrq;
     unsigned char *p=raw->buff+TERSUSHLEN;
+    rawsat_t *rs;
     
     trace(3,"decode_rangeb: len=%d\n",raw->len);
     
@@ -239,18 +240,19 @@ static int decode_rangeb(raw_t *raw)
         if (sys==SYS_GLO&&raw->nav.geph[prn-1].sat!=sat) {
             raw->nav.geph[prn-1].frq=gfrq-7;
         }
-        if (raw->tobs[sat-1][pos].time!=0) {
-            tt=timediff(raw->time,raw->tobs[sat-1][pos]);
-            lli=lockt-raw->lockt[sat-1][pos]+0.05<=tt?LLI_SLIP:0;
+        rs=rawsat(raw,sat);
+        if (rs->tobs[pos].time!=0) {
+            tt=timediff(raw->time,rs->tobs[pos]);
+            lli=lockt-rs->lockt[pos]+0.05<=tt?LLI_SLIP:0;
         }
         else {
             lli=0;
         }
         if (!parity) lli|=LLI_HALFC;
         if (halfc  ) lli|=LLI_HALFA;
-        raw->tobs [sat-1][pos]=raw->time;
-        raw->lockt[sat-1][pos]=lockt;
-        raw->halfc[sat-1][pos]=halfc;
+        rs->tobs[pos]=raw->time;
+        rs->lockt[pos]=lockt;
+        rs->halfc[pos]=halfc;
         
         if (!clock) psr=0.0;     /* code unlock */
         if (!plock) adr=dop=0.0; /* phase unlock */
@@ -278,6 +280,7 @@ static int decode_rangecmpb(raw_t *raw)
     int track,plock,clock,parity,halfc,lli;
     char *msg;
     unsigned char *p=raw->buff+TERSUSHLEN;
+    rawsat_t *rs;
     
     trace(3,"decode_rangecmpb: len=%d\n",raw->len);
     
@@ -323,18 +326,19 @@ static int decode_rangecmpb(raw_t *raw)
         
         lockt=(U4(p+18)&0x1FFFFF)/32.0; /* lock time */
         
-        if (raw->tobs[sat-1][pos].time!=0) {
-            tt=timediff(raw->time,raw->tobs[sat-1][pos]);
-            lli=(lockt<65535.968&&lockt-raw->lockt[sat-1][pos]+0.05<=tt)?LLI_SLIP:0;
+        rs=rawsat(raw,sat);
+        if (rs->tobs[pos].time!=0) {
+            tt=timediff(raw->time,rs->tobs[pos]);
+            lli=(lockt<65535.968&&lockt-rs->lockt[pos]+0.05<=tt)?LLI_SLIP:0;
         }
         else {
             lli=0;
         }
         if (!parity) lli|=LLI_HALFC;
         if (halfc  ) lli|=LLI_HALFA;
-        raw->tobs [sat-1][pos]=raw->time;
-        raw->lockt[sat-1][pos]=lockt;
-        raw->halfc[sat-1][pos]=halfc;
+        rs->tobs[pos]=raw->time;
+        rs->lockt[pos]=lockt;
+        rs->halfc[pos]=halfc;
         
         snr=((U2(p+20)&0x3FF)>>5)+20.0;
         if (!clock) psr=0.0;     /* code unlock */
@@ -354,7 +358,7 @@ static int decode_rangecmpb(raw_t *raw)
         }
 #if 0 /* for debug */
         trace(3,"sys=%d prn=%3d cp=%12.5f lli=%2d plock=%2d clock=%2d lockt=%4.2f halfc=%2d parity=%2d ts=%s\n",
-              sys,prn,adr,lli,plock,clock,lockt,halfc,parity,time_str(raw->tobs,3));
+              sys,prn,adr,lli,plock,clock,lockt,halfc,parity,time_str(rs->tobs[pos],3));
 #endif
 
     }
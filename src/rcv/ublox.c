@@ -65,6 +65,7 @@
 *           2019/05/10 1.27 disable half-cyc-subtract flag on LLI for RXM-RAWX
 *                           save galileo E5b data to obs index 2
 *                           handle C17 as no-GEO (MEO/IGSO)
+*           2026/10/17 1.28 no static state in decode_trkmeas(),decode_trkd5()
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -260,6 +261,7 @@ static int decode_rxmraw(raw_t *raw)
     int i,j,prn,sat,n=0,nsat,week;
     unsigned char *p=raw->buff+6;
     char *q;
+    rawsat_t *rs;
     
     trace(4,"decode_rxmraw: len=%d\n",raw->len);
     
@@ -311,9 +313,10 @@ static int decode_rxmraw(raw_t *raw)
         }
         raw->obs.data[n].sat=sat;
         
-        if (raw->obs.data[n].LLI[0]&1) raw->lockt[sat-1][0]=0.0;
-        else if (tt<1.0||10.0<tt) raw->lockt[sat-1][0]=0.0;
-        else raw->lockt[sat-1][0]+=tt;
+        rs=rawsat(raw,sat);
+        if (raw->obs.data[n].LLI[0]&1) rs->lockt[0]=0.0;
+        else if (tt<1.0||10.0<tt) rs->lockt[0]=0.0;
+        else rs->lockt[0]+=tt;
         
         for (j=1;j<NFREQ+NEXOBS;j++) {
             raw->obs.data[n].L[j]=raw->obs.data[n].P[j]=0.0;
@@ -337,6 +340,7 @@ static int decode_rxmrawx(raw_t *raw)
     double tow,P,L,D,tn,tadj=0.0,toff=0.0;
     int i,j,k,f,sys,prn,sat,code,slip,halfv,halfc,LLI,n=0,cpstd_valid,cpstd_slip;
     int week,nmeas,ver,gnss,svid,sigid,frqid,lockt,cn0,cpstd,prstd,tstat;
+    rawsat_t *rs;
 
     trace(4,"decode_rxmrawx: len=%d\n",raw->len);
     
@@ -435,16 +439,17 @@ static int decode_rxmrawx(raw_t *raw)
         else
             halfv=tstat&4?1:0; /* half cycle valid */
         halfc=tstat&8?1:0; /* half cycle subtracted from phase */
-        slip=lockt==0||lockt*1E-3<raw->lockt[sat-1][f-1]||
-             halfc!=raw->halfc[sat-1][f-1];
+        rs=rawsat(raw,sat);
+        slip=lockt==0||lockt*1E-3<rs->lockt[f-1]||
+             halfc!=rs->halfc[f-1];
         if (cpstd>=cpstd_slip) slip=LLI_SLIP;
-        if (slip) raw->lockflag[sat-1][f-1]=slip;
-        raw->lockt[sat-1][f-1]=lockt*1E-3;
-        raw->halfc[sat-1][f-1]=halfc;
+        if (slip) rs->lockflag[f-1]=slip;
+        rs->lockt[f-1]=lockt*1E-3;
+        rs->halfc[f-1]=halfc;
         /* LLI: bit1=slip,bit2=half-cycle-invalid */
         LLI=!halfv&&L!=0.0?LLI_HALFC:0;
-        LLI|=halfc!=raw->halfc[sat-1][f-1]?1:0;
-        if (L!=0.0) LLI|=raw->lockflag[sat-1][f-1]>0.0?LLI_SLIP:0;
+        LLI|=halfc!=rs->halfc[f-1]?1:0;
+        if (L!=0.0) LLI|=rs->lockflag[f-1]>0.0?LLI_SLIP:0;
 
         for (j=0;j<n;j++) {
             if (raw->obs.data[j].sat==sat) break;
@@ -472,7 +477,7 @@ static int decode_rxmrawx(raw_t *raw)
         raw->obs.data[j].SNR[f-1]=(unsigned char)(cn0*4);
         raw->obs.data[j].LLI[f-1]=(unsigned char)LLI;
         raw->obs.data[j].code[f-1]=(unsigned char)code;
-        if (L!=0.0) raw->lockflag[sat-1][f-1]=0;
+        if (L!=0.0) rs->lockflag[f-1]=0;
     }
     raw->time=time;
     raw->obs.n=n;
@@ -488,7 +493,7 @@ static int save_subfrm(int sat, raw_t *raw)
     
     if (id<1||5<id) return 0;
     
-    q=raw->subfrm[sat-1]+(id-1)*30;
+    q=rawsat(raw,sat)->subfrm+(id-1)*30;
     
     for (i=n=0,p+=2;i<10;i++,p+=4) {
         for (j=23;j>=0;j--) {
@@ -501,12 +506,14 @@ static int save_subfrm(int sat, raw_t *raw)
 static int decode_ephem(int sat, raw_t *raw)
 {
     eph_t eph={0};
+    rawsat_t *rs;
     
     trace(4,"decode_ephem: sat=%2d\n",sat);
     
-    if (decode_frame(raw->subfrm[sat-1]   ,&eph,NULL,NULL,NULL,NULL)!=1||
-        decode_frame(raw->subfrm[sat-1]+30,&eph,NULL,NULL,NULL,NULL)!=2||
-        decode_frame(raw->subfrm[sat-1]+60,&eph,NULL,NULL,NULL,NULL)!=3) return 0;
+    rs=rawsat(raw,sat);
+    if (decode_frame(rs->subfrm   ,&eph,NULL,NULL,NULL,NULL)!=1||
+        decode_frame(rs->subfrm+30,&eph,NULL,NULL,NULL,NULL)!=2||
+        decode_frame(rs->subfrm+60,&eph,NULL,NULL,NULL,NULL)!=3) return 0;
     
     if (!strstr(raw->opt,"-EPHALL")) {
         if (eph.iode==raw->nav.eph[sat-1].iode&&
@@ -521,16 +528,19 @@ static int decode_ephem(int sat, raw_t *raw)
 static int decode_alm1(int sat, raw_t *raw)
 {
     int sys=satsys(sat,NULL);
+    rawsat_t *rs;
     
     trace(4,"decode_alm1 : sat=%2d\n",sat);
     
+    rs=rawsat(raw,sat);
+    
     if (sys==SYS_GPS) {
-        decode_frame(raw->subfrm[sat-1]+90,NULL,raw->nav.alm,raw->nav.ion_gps,
+        decode_frame(rs->subfrm+90,NULL,raw->nav.alm,raw->nav.ion_gps,
                      raw->nav.utc_gps,&raw->nav.leaps);
         adj_utcweek(raw->time,raw->nav.utc_gps);
     }
     else if (sys==SYS_QZS) {
-        decode_frame(raw->subfrm[sat-1]+90,NULL,raw->nav.alm,raw->nav.ion_qzs,
+        decode_frame(rs->subfrm+90,NULL,raw->nav.alm,raw->nav.ion_qzs,
                      raw->nav.utc_qzs,&raw->nav.leaps);
         adj_utcweek(raw->time,raw->nav.utc_qzs);
     }
@@ -540,14 +550,17 @@ static int decode_alm1(int sat, raw_t *raw)
 static int decode_alm2(int sat, raw_t *raw)
 {
     int sys=satsys(sat,NULL);
+    rawsat_t *rs;
     
     trace(4,"decode_alm2 : sat=%2d\n",sat);
     
+    rs=rawsat(raw,sat);
+    
     if (sys==SYS_GPS) {
-        decode_frame(raw->subfrm[sat-1]+120,NULL,raw->nav.alm,NULL,NULL,NULL);
+        decode_frame(rs->subfrm+120,NULL,raw->nav.alm,NULL,NULL,NULL);
     }
     else if (sys==SYS_QZS) {
-        decode_frame(raw->subfrm[sat-1]+120,NULL,raw->nav.alm,raw->nav.ion_qzs,
+        decode_frame(rs->subfrm+120,NULL,raw->nav.alm,raw->nav.ion_qzs,
                      raw->nav.utc_qzs,&raw->nav.leaps);
         adj_utcweek(raw->time,raw->nav.utc_qzs);
     }
@@ -630,7 +643,6 @@ static int decode_navtime(raw_t *raw)
 /* decode ubx-trk-meas: trace measurement data -------------------------------*/
 static int decode_trkmeas(raw_t *raw)
 {
-    static double adrs[MAXSAT]={0};
     gtime_t time;
     double ts,tr=-1.0,t,tau,utc_gpst,snr,adr,dop;
     int i,j,n=0,nch,sys,prn,sat,qi,frq,flag,lock1,lock2,week,fw=0;
@@ -640,6 +652,7 @@ static int decode_trkmeas(raw_t *raw)
        values based on difference between TRK_MEAS values and  RXM-RAWX values */
     const char P_adj_fw2[]={ 0, 0, 0, 0, 1, 3, 2, 0,-4,-3,-9,-8,-7,-4, 0};  /* fw 2.30 */
     const char P_adj_fw3[]={11,13,13,14,14,13,12,10, 8, 6, 5, 5, 5, 7, 0};  /* fw 3.01 */
+    rawsat_t *rs;
     
     trace(4,"decode_trkmeas: len=%d\n",raw->len);
     
@@ -713,18 +726,17 @@ static int decode_trkmeas(raw_t *raw)
         dop  =I4(p+40)*P2_10*10.0;
         
         /* set slip flag */
-        if (lock2==0||lock2<raw->lockt[sat-1][0]) raw->lockt[sat-1][1]=1.0;
-        raw->lockt[sat-1][0]=lock2;
+        rs=rawsat(raw,sat);
+        if (lock2==0||lock2<rs->lockt[0]) rs->lockt[1]=1.0;
+        rs->lockt[0]=lock2;
         
 #if 0 /* for debug */
         trace(2,"[%2d] qi=%d sys=%d prn=%3d frq=%2d flag=%02X ?=%02X %02X "
               "%02X %02X %02X %02X %02X lock=%3d %3d ts=%10.3f snr=%4.1f "
-              "dop=%9.3f adr=%13.3f %6.3f\n",U1(p),qi,U1(p+4),prn,frq,flag,
+              "dop=%9.3f adr=%13.3f\n",U1(p),qi,U1(p+4),prn,frq,flag,
               U1(p+9),U1(p+10),U1(p+11),U1(p+12),U1(p+13),U1(p+14),U1(p+15),
-              lock1,lock2,ts,snr,dop,adr,
-              adrs[sat-1]==0.0||dop==0.0?0.0:(adr-adrs[sat-1])-dop);
+              lock1,lock2,ts,snr,dop,adr);
 #endif
-        adrs[sat-1]=adr;
         
         /* check phase lock */
         if (!(flag&0x20)) continue;
@@ -737,14 +749,14 @@ static int decode_trkmeas(raw_t *raw)
         raw->obs.data[n].SNR[0]=(unsigned char)(snr*4.0);
         raw->obs.data[n].code[0]=sys==SYS_CMP?CODE_L2I:CODE_L1C;
         raw->obs.data[n].qualL[0]=8-qi;
-        raw->obs.data[n].LLI[0]=raw->lockt[sat-1][1]>0.0?1:0;
+        raw->obs.data[n].LLI[0]=rs->lockt[1]>0.0?1:0;
         if (sys==SYS_SBS) { /* half-cycle valid */
             raw->obs.data[n].LLI[0]|=lock2>142?0:2;
         }
         else {
             raw->obs.data[n].LLI[0]|=flag&0x80?0:2;
         }
-        raw->lockt[sat-1][1]=0.0;
+        rs->lockt[1]=0.0;
         /* adjust code measurements for GLONASS sats */
         if (sys==SYS_GLO&&frq>=-7&&frq<=7) {
             if (fw==2) raw->obs.data[n].P[0]+=(double)P_adj_fw2[frq+7];
@@ -767,11 +779,11 @@ static int decode_trkmeas(raw_t *raw)
 /* decode ubx-trkd5: trace measurement data ----------------------------------*/
 static int decode_trkd5(raw_t *raw)
 {
-    static double adrs[MAXSAT]={0};
     gtime_t time;
     double ts,tr=-1.0,t,tau,adr,dop,snr,utc_gpst;
     int i,j,n=0,type,off,len,sys,prn,sat,qi,frq,flag,week;
     unsigned char *p=raw->buff+6;
+    rawsat_t *rs;
     
     trace(4,"decode_trkd5: len=%d\n",raw->len);
     
@@ -841,15 +853,14 @@ static int decode_trkd5(raw_t *raw)
         dop=I4(p+16)*P2_10/4.0;
         snr=U2(p+32)/256.0;
         
-        if (snr<=10.0) raw->lockt[sat-1][1]=1.0;
+        rs=rawsat(raw,sat);
+        if (snr<=10.0) rs->lockt[1]=1.0;
         
 #if 0 /* for debug */
         trace(2,"[%2d] qi=%d sys=%d prn=%3d frq=%2d flag=%02X ts=%1.3f "
-              "snr=%4.1f dop=%9.3f adr=%13.3f %6.3f\n",U1(p+35),qi,U1(p+56),
-              prn,frq,flag,ts,snr,dop,adr,
-              adrs[sat-1]==0.0||dop==0.0?0.0:(adr-adrs[sat-1])-dop);
+              "snr=%4.1f dop=%9.3f adr=%13.3f\n",U1(p+35),qi,U1(p+56),
+              prn,frq,flag,ts,snr,dop,adr);
 #endif
-        adrs[sat-1]=adr;
         
         /* check phase lock */
         if (!(flag&0x08)) continue;
@@ -861,8 +872,8 @@ static int decode_trkd5(raw_t *raw)
         raw->obs.data[n].D[0]=(float)dop;
         raw->obs.data[n].SNR[0]=(unsigned char)(snr*4.0);
         raw->obs.data[n].code[0]=sys==SYS_CMP?CODE_L2I:CODE_L1C;
-        raw->obs.data[n].LLI[0]=raw->lockt[sat-1][1]>0.0?1:0;
-        raw->lockt[sat-1][1]=0.0;
+        raw->obs.data[n].LLI[0]=rs->lockt[1]>0.0?1:0;
+        rs->lockt[1]=0.0;
         
         for (j=1;j<NFREQ+NEXOBS;j++) {
             raw->obs.data[n].L[j]=raw->obs.data[n].P[j]=0.0;
@@ -902,7 +913,7 @@ static int decode_nav(raw_t *raw, int sat, int off)
         return -1;
     }
     for (i=0;i<10;i++) {
-        setbitu(raw->subfrm[sat-1]+(id-1)*30,i*24,24,words[i]);
+        setbitu(rawsat(raw,sat)->subfrm+(id-1)*30,i*24,24,words[i]);
     }
     if (id==3) return decode_ephem(sat,raw);
     if (id==4) return decode_alm1 (sat,raw);
@@ -915,6 +926,7 @@ static int decode_enav(raw_t *raw, int sat, int off)
     eph_t eph={0};
     unsigned char *p=raw->buff+6+off,buff[32],crc_buff[26]={0};
     int i,j,k,part1,page1,part2,page2,type;
+    rawsat_t *rs;
     
     if (raw->len<44+off) {
         trace(2,"ubx rawsfrbx length error: sat=%d len=%d\n",sat,raw->len);
@@ -949,22 +961,23 @@ static int decode_enav(raw_t *raw, int sat, int off)
     if (type>6) return 0;
     
     /* clear word 0-6 flags */
-    if (type==2) raw->subfrm[sat-1][112]=0;
+    rs=rawsat(raw,sat);
+    if (type==2) rs->subfrm[112]=0;
     
     /* save page data (112 + 16 bits) to frame buffer */
     k=type*16;
-    for (i=0,j=2;i<14;i++,j+=8) raw->subfrm[sat-1][k++]=getbitu(buff   ,j,8);
-    for (i=0,j=2;i< 2;i++,j+=8) raw->subfrm[sat-1][k++]=getbitu(buff+16,j,8);
+    for (i=0,j=2;i<14;i++,j+=8) rs->subfrm[k++]=getbitu(buff   ,j,8);
+    for (i=0,j=2;i< 2;i++,j+=8) rs->subfrm[k++]=getbitu(buff+16,j,8);
     
     /* test word 0-6 flags */
-    raw->subfrm[sat-1][112]|=(1<<type);
-    if (raw->subfrm[sat-1][112]!=0x7F) return 0;
+    rs->subfrm[112]|=(1<<type);
+    if (rs->subfrm[112]!=0x7F) return 0;
     
     if (strstr(raw->opt,"-GALFNAV")) {
         return 0;
     }
     /* decode galileo inav ephemeris */
-    if (!decode_gal_inav(raw->subfrm[sat-1],&eph)) {
+    if (!decode_gal_inav(rs->subfrm,&eph)) {
         return 0;
     }
     /* test svid consistency */
@@ -989,6 +1002,7 @@ static int decode_cnav(raw_t *raw, int sat, int off)
     unsigned int words[10];
     int i,id,pgn,prn;
     unsigned char *p=raw->buff+6+off;
+    rawsat_t *rs;
     
     if (raw->len<48+off) {
         trace(2,"ubx rawsfrbx length error: sat=%d len=%d\n",sat,raw->len);
@@ -1002,15 +1016,17 @@ static int decode_cnav(raw_t *raw, int sat, int off)
         trace(2,"ubx rawsfrbx subfrm id error: sat=%2d\n",sat);
         return -1;
     }
+    rs=rawsat(raw,sat);
+    
     if (prn>5&&prn<59) { /* IGSO/MEO */
         
         for (i=0;i<10;i++) {
-            setbitu(raw->subfrm[sat-1]+(id-1)*38,i*30,30,words[i]);
+            setbitu(rs->subfrm+(id-1)*38,i*30,30,words[i]);
         }
         if (id!=3) return 0;
         
         /* decode beidou D1 ephemeris */
-        if (!decode_bds_d1(raw->subfrm[sat-1],&eph)) return 0;
+        if (!decode_bds_d1(rs->subfrm,&eph)) return 0;
     }
     else { /* GEO (C01-05, C59-63) */
         if (id!=1) return 0;
@@ -1022,12 +1038,12 @@ static int decode_cnav(raw_t *raw, int sat, int off)
             return -1;
         }
         for (i=0;i<10;i++) {
-            setbitu(raw->subfrm[sat-1]+(pgn-1)*38,i*30,30,words[i]);
+            setbitu(rs->subfrm+(pgn-1)*38,i*30,30,words[i]);
         }
         if (pgn!=10) return 0;
         
         /* decode beidou D2 ephemeris */
-        if (!decode_bds_d2(raw->subfrm[sat-1],&eph)) return 0;
+        if (!decode_bds_d2(rs->subfrm,&eph)) return 0;
     }
     if (!strstr(raw->opt,"-EPHALL")) {
         if (timediff(eph.toe,raw->nav.eph[sat-1].toe)==0.0&&
@@ -1045,6 +1061,7 @@ static int decode_gnav(raw_t *raw, int sat, int off, int frq)
     geph_t geph={0};
     int i,j,k,m,prn;
     unsigned char *p=raw->buff+6+off,buff[64],*fid;
+    rawsat_t *rs;
     
     satsys(sat,&prn);
     
@@ -1066,18 +1083,19 @@ static int decode_gnav(raw_t *raw, int sat, int off, int frq)
         return -1;
     }
     /* flush frame buffer if frame-id changed */
-    fid=raw->subfrm[sat-1]+150;
+    rs=rawsat(raw,sat);
+    fid=rs->subfrm+150;
     if (fid[0]!=buff[12]||fid[1]!=buff[13]) {
-        for (i=0;i<4;i++) memset(raw->subfrm[sat-1]+i*10,0,10);
+        for (i=0;i<4;i++) memset(rs->subfrm+i*10,0,10);
         memcpy(fid,buff+12,2); /* save frame-id */
     }
-    memcpy(raw->subfrm[sat-1]+(m-1)*10,buff,10);
+    memcpy(rs->subfrm+(m-1)*10,buff,10);
     
     if (m!=4) return 0;
     
     /* decode glonass ephemeris strings */
     geph.tof=raw->time;
-    if (!decode_glostr(raw->subfrm[sat-1],&geph)||geph.sat!=sat) return 0;
+    if (!decode_glostr(rs->subfrm,&geph)||geph.sat!=sat) return 0;
     geph.frq=frq-7;
     
     if (!strstr(raw->opt,"-EPHALL")) {
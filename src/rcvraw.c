@@ -37,6 +37,10 @@
 *           2018/10/10 1.15 update reference [5]
 *                           add set of eph->code/flag for galileo and beidou
 *           2018/12/05 1.16 add test of galileo i/nav word type 5
+*           2026/10/17 1.17 free nav corrections allocated on demand
+*                           notify decoded obs and ephemeris to raw->sink
+*                           add api rawsat(), allocate per-satellite states
+*                           on demand
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 #include <stdint.h>
@@ -867,6 +871,8 @@ extern int init_raw(raw_t *raw, int format)
     seph_t seph0={0};
     sbsmsg_t sbsmsg0={0};
     lexmsg_t lexmsg0={0};
+    rawsat_t sat0={{{0}}};
+    decsink_t sink0={0};
     int i,j,sys,ret=1;
     
     trace(3,"init_raw: format=%d\n",format);
@@ -875,23 +881,16 @@ extern int init_raw(raw_t *raw, int format)
     raw->ephsat=0;
     raw->sbsmsg=sbsmsg0;
     raw->msgtype[0]='\0';
-    for (i=0;i<MAXSAT;i++) {
-        for (j=0;j<380;j++) raw->subfrm[i][j]=0;
-        for (j=0;j<NFREQ+NEXOBS;j++) {
-            raw->tobs [i][j]=time0;
-            raw->lockt[i][j]=0.0;
-            raw->halfc[i][j]=0;
-        }
-        raw->icpp[i]=raw->off[i]=raw->prCA[i]=raw->dpCA[i]=0.0;
-    }
+    for (i=0;i<MAXSAT;i++) raw->sats[i]=NULL;
+    raw->sat0=sat0;
     for (i=0;i<MAXOBS;i++) raw->freqn[i]=0;
     raw->lexmsg=lexmsg0;
-    raw->icpc=0.0;
     raw->nbyte=raw->len=0;
     raw->iod=raw->flag=raw->tbase=raw->outtype=0;
     raw->tod=-1;
     for (i=0;i<MAXRAWLEN;i++) raw->buff[i]=0;
     raw->opt[0]='\0';
+    raw->codepri.stamp=0;
     raw->format=-1;
     
     raw->obs.data =NULL;
@@ -900,8 +899,11 @@ extern int init_raw(raw_t *raw, int format)
     raw->nav.alm  =NULL;
     raw->nav.geph =NULL;
     raw->nav.seph =NULL;
+    raw->nav.pcvs=NULL; raw->nav.ssr=NULL; raw->nav.dgps=NULL;
+    raw->nav.lexeph=NULL; raw->nav.sbssat=NULL; raw->nav.sbsion=NULL;
     raw->half_cyc =NULL;
     raw->rcv_data =NULL;
+    raw->sink=sink0;
     
     if (!(raw->obs.data =(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))||
         !(raw->obuf.data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))||
@@ -957,6 +959,7 @@ extern int init_raw(raw_t *raw, int format)
 extern void free_raw(raw_t *raw)
 {
     half_cyc_t *p,*next;
+    int i;
     
     trace(3,"free_raw:\n");
     
@@ -966,6 +969,7 @@ extern void free_raw(raw_t *raw)
     free(raw->nav.alm  ); raw->nav.alm  =NULL; raw->nav.na=0;
     free(raw->nav.geph ); raw->nav.geph =NULL; raw->nav.ng=0;
     free(raw->nav.seph ); raw->nav.seph =NULL; raw->nav.ns=0;
+    freenav(&raw->nav,0x1F00);
     
     /* free half-cycle correction list */
     for (p=raw->half_cyc;p;p=next) {
@@ -974,6 +978,10 @@ extern void free_raw(raw_t *raw)
     }
     raw->half_cyc=NULL;
     
+    /* free per-satellite states */
+    for (i=0;i<MAXSAT;i++) {
+        free(raw->sats[i]); raw->sats[i]=NULL;
+    }
     /* free receiver dependent data */
     switch (raw->format) {
         case STRFMT_CMR : free_cmr (raw); break;
@@ -981,6 +989,37 @@ extern void free_raw(raw_t *raw)
     }
     raw->rcv_data=NULL;
 }
+/* per-satellite state of receiver raw data ------------------------------------
+* get per-satellite state (tracking and subframe buffers) in receiver raw data
+* control struct. the state is allocated and cleared at the first access
+* args   : raw_t  *raw   IO     receiver raw data control struct
+*          int    sat    I      satellite number
+* return : per-satellite state
+* notes  : the pointer is valid until free_raw(). for invalid satellite number
+*          or memory allocation error, raw->sat0 is returned instead.
+*-----------------------------------------------------------------------------*/
+extern rawsat_t *rawsat(raw_t *raw, int sat)
+{
+    if (sat<1||sat>MAXSAT) return &raw->sat0;
+    
+    if (!raw->sats[sat-1]&&
+        !(raw->sats[sat-1]=(rawsat_t *)calloc(1,sizeof(rawsat_t)))) {
+        trace(1,"rawsat: memory allocation error sat=%d\n",sat);
+        return &raw->sat0;
+    }
+    return raw->sats[sat-1];
+}
+/* notify decoded data to event sink ----------------------------------------*/
+static int notify_raw(raw_t *raw, int ret)
+{
+    if (ret==1&&raw->sink.on_obs_epoch) {
+        raw->sink.on_obs_epoch(&raw->sink,&raw->obs);
+    }
+    else if (ret==2&&raw->sink.on_ephemeris) {
+        raw->sink.on_ephemeris(&raw->sink,raw->ephsat,&raw->nav);
+    }
+    return ret;
+}
 /* input receiver raw data from stream -----------------------------------------
 * fetch next receiver raw data and input a message from stream
 * args   : raw_t  *raw   IO     receiver raw data control struct
@@ -989,29 +1028,34 @@ extern void free_raw(raw_t *raw)
 * return : status (-1: error message, 0: no message, 1: input observation data,
 *                  2: input ephemeris, 3: input sbas message,
 *                  9: input ion/utc parameter, 31: input lex message)
+* notes  : observation data and ephemeris are also passed by pointers to the
+*          callbacks in raw->sink if set after init_raw(). the pointers are
+*          valid only until the next input.
 *-----------------------------------------------------------------------------*/
 extern int input_raw(raw_t *raw, int format, unsigned char data)
 {
+    int ret=0;
+    
     trace(5,"input_raw: format=%d data=0x%02x\n",format,data);
     
     switch (format) {
-        case STRFMT_OEM4 : return input_oem4 (raw,data);
-        case STRFMT_CNAV : return input_cnav (raw,data);
-        case STRFMT_UBX  : return input_ubx  (raw,data);
-        case STRFMT_SBP  : return input_sbp  (raw,data);
-        case STRFMT_CRES : return input_cres (raw,data);
-        case STRFMT_STQ  : return input_stq  (raw,data);
-        case STRFMT_GW10 : return input_gw10 (raw,data);
-        case STRFMT_JAVAD: return input_javad(raw,data);
-        case STRFMT_NVS  : return input_nvs  (raw,data);
-        case STRFMT_BINEX: return input_bnx  (raw,data);
-        case STRFMT_RT17 : return input_rt17 (raw,data);
-        case STRFMT_SEPT : return input_sbf  (raw,data);
-        case STRFMT_CMR  : return input_cmr  (raw,data);
-        case STRFMT_TERSUS: return input_tersus(raw,data);
-        case STRFMT_LEXR : return input_lexr (raw,data);
+        case STRFMT_OEM4 : ret=input_oem4 (raw,data); break;
+        case STRFMT_CNAV : ret=input_cnav (raw,data); break;
+        case STRFMT_UBX  : ret=input_ubx  (raw,data); break;
+        case STRFMT_SBP  : ret=input_sbp  (raw,data); break;
+        case STRFMT_CRES : ret=input_cres (raw,data); break;
+        case STRFMT_STQ  : ret=input_stq  (raw,data); break;
+        case STRFMT_GW10 : ret=input_gw10 (raw,data); break;
+        case STRFMT_JAVAD: ret=input_javad(raw,data); break;
+        case STRFMT_NVS  : ret=input_nvs  (raw,data); break;
+        case STRFMT_BINEX: ret=input_bnx  (raw,data); break;
+        case STRFMT_RT17 : ret=input_rt17 (raw,data); break;
+        case STRFMT_SEPT : ret=input_sbf  (raw,data); break;
+        case STRFMT_CMR  : ret=input_cmr  (raw,data); break;
+        case STRFMT_TERSUS: ret=input_tersus(raw,data); break;
+        case STRFMT_LEXR : ret=input_lexr (raw,data); break;
     }
-    return 0;
+    return notify_raw(raw,ret);
 }
 /* input receiver raw data from file -------------------------------------------
 * fetch next receiver raw data and input a message from file
@@ -1022,24 +1066,26 @@ extern int input_raw(raw_t *raw, int format, unsigned char data)
 *-----------------------------------------------------------------------------*/
 extern int input_rawf(raw_t *raw, int format, FILE *fp)
 {
+    int ret=-2;
+    
     trace(4,"input_rawf: format=%d\n",format);
     
     switch (format) {
-        case STRFMT_OEM4 : return input_oem4f (raw,fp);
-        case STRFMT_CNAV : return input_cnavf (raw,fp);
-        case STRFMT_UBX  : return input_ubxf  (raw,fp);
-        case STRFMT_SBP  : return input_sbpf  (raw,fp);
-        case STRFMT_CRES : return input_cresf (raw,fp);
-        case STRFMT_STQ  : return input_stqf  (raw,fp);
-        case STRFMT_GW10 : return input_gw10f (raw,fp);
-        case STRFMT_JAVAD: return input_javadf(raw,fp);
-        case STRFMT_NVS  : return input_nvsf  (raw,fp);
-        case STRFMT_BINEX: return input_bnxf  (raw,fp);
-        case STRFMT_RT17 : return input_rt17f (raw,fp);
-        case STRFMT_SEPT : return input_sbff  (raw,fp);
-        case STRFMT_CMR  : return input_cmrf  (raw,fp);
-        case STRFMT_TERSUS: return input_tersusf(raw,fp);
-        case STRFMT_LEXR : return input_lexrf (raw,fp);
+        case STRFMT_OEM4 : ret=input_oem4f (raw,fp); break;
+        case STRFMT_CNAV : ret=input_cnavf (raw,fp); break;
+        case STRFMT_UBX  : ret=input_ubxf  (raw,fp); break;
+        case STRFMT_SBP  : ret=input_sbpf  (raw,fp); break;
+        case STRFMT_CRES : ret=input_cresf (raw,fp); break;
+        case STRFMT_STQ  : ret=input_stqf  (raw,fp); break;
+        case STRFMT_GW10 : ret=input_gw10f (raw,fp); break;
+        case STRFMT_JAVAD: ret=input_javadf(raw,fp); break;
+        case STRFMT_NVS  : ret=input_nvsf  (raw,fp); break;
+        case STRFMT_BINEX: ret=input_bnxf  (raw,fp); break;
+        case STRFMT_RT17 : ret=input_rt17f (raw,fp); break;
+        case STRFMT_SEPT : ret=input_sbff  (raw,fp); break;
+        case STRFMT_CMR  : ret=input_cmrf  (raw,fp); break;
+        case STRFMT_TERSUS: ret=input_tersusf(raw,fp); break;
+        case STRFMT_LEXR : ret=input_lexrf (raw,fp); break;
     }
-    return -2;
+    return notify_raw(raw,ret);
 }
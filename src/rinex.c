@@ -93,6 +93,12 @@
 *           2018/10/10 1.28 support galileo sisa value for rinex nav output
 *                           fix bug on handling beidou B1 code in rinex 3.03
 *           2019/08/19 1.29 support galileo sisa index for rinex nav input
+*           2026/10/17 1.30 buffered and printf-free output of obs/nav records
+*                           add api init_crx(),free_crx(),outcrxobs(),
+*                           outrnxobsr()
+*                           support compact rinex (hatanaka) obs output
+*                           read rinex clock body by blocks
+*                           skip station clock records without conversion
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -106,6 +112,7 @@
 #define MINFREQ_GLO -7                  /* min frequency number glonass */
 #define MAXFREQ_GLO 13                  /* max frequency number glonass */
 #define NINCOBS     262144              /* inclimental number of obs data */
+#define OBSBUFFSIZE 8192                /* obs record output buffer size */
 
 static const int navsys[]={             /* satellite systems */
     SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN,0
@@ -1415,14 +1422,62 @@ static int readrnxnav(FILE *fp, const char *opt, double ver, int sys,
     }
     return nav->n>0||nav->ng>0||nav->ns>0;
 }
-/* read rinex clock ----------------------------------------------------------*/
-static int readrnxclk(FILE *fp, const char *opt, int index, nav_t *nav)
+/* last epoch of rinex clock records -----------------------------------------*/
+static int lastclkepoch(FILE *fp, gtime_t *time)
+{
+    long pos;
+    int n,stat=0;
+    char buff[8192],*p;
+    
+    /* read tail of file and restore file position */
+    if ((pos=ftell(fp))<0||fseek(fp,0,SEEK_END)) return 0;
+    if (ftell(fp)-pos>(long)sizeof(buff)-1) {
+        fseek(fp,-(long)sizeof(buff)+1,SEEK_END);
+    }
+    else fseek(fp,pos,SEEK_SET);
+    n=(int)fread(buff,1,sizeof(buff)-1,fp);
+    buff[n]='\0';
+    fseek(fp,pos,SEEK_SET);
+    
+    for (p=buff+n;p>buff;) {
+        for (p--;p>buff&&*(p-1)!='\n';p--) ;
+        if (p[0]=='A'&&p[1]=='S'&&!str2time(p,8,26,time)) {
+            stat=1;
+            break;
+        }
+    }
+    return stat;
+}
+/* reserve precise clock -----------------------------------------------------*/
+static int resvpclk(nav_t *nav, int n)
 {
     pclk_t *nav_pclk;
-    gtime_t time;
-    double data[2];
-    int i,j,sat,mask;
-    char buff[MAXRNXLEN],satid[8]="";
+    
+    if (nav->nc+n<=nav->ncmax) return 1;
+    
+    if (!(nav_pclk=(pclk_t *)realloc(nav->pclk,sizeof(pclk_t)*(nav->nc+n)))) {
+        trace(1,"readrnxclk malloc error: nmax=%d\n",nav->nc+n);
+        free(nav->pclk); nav->pclk=NULL; nav->nc=nav->ncmax=0;
+        return 0;
+    }
+    nav->pclk=nav_pclk;
+    nav->ncmax=nav->nc+n;
+    return 1;
+}
+/* read rinex clock ------------------------------------------------------------
+* notes  : only satellite clock (AS) records are decoded. other records
+*          including station clock (AR) records are skipped by the record type
+*          without any conversion. the output is pre-sized by the interval of
+*          the first epochs and the last epoch of the file.
+*-----------------------------------------------------------------------------*/
+static int readrnxclk(FILE *fp, const char *opt, int index, nav_t *nav)
+{
+    lnbuf_t lb;
+    pclk_t *pclk;
+    gtime_t time={0},time0={0},tlast={0};
+    double data[2],tint;
+    int i,sat,mask,nep=0,last,stat=1;
+    char *buff,epoch[27]="",satid[8]="";
     
     trace(3,"readrnxclk: index=%d\n", index);
     
@@ -1431,43 +1486,57 @@ static int readrnxclk(FILE *fp, const char *opt, int index, nav_t *nav)
     /* set system mask */
     mask=set_sysmask(opt);
     
-    while (fgets(buff,sizeof(buff),fp)) {
-        
-        if (str2time(buff,8,26,&time)) {
-            trace(2,"rinex clk invalid epoch: %34.34s\n",buff);
-            continue;
-        }
-        strncpy(satid,buff+3,4);
+    last=lastclkepoch(fp,&tlast);
+    
+    if (!initlnbuf(&lb,fp,65536)) return -1;
+    
+    while ((buff=getlnbuf(&lb))) {
         
         /* only read AS (satellite clock) record */
-        if (strncmp(buff,"AS",2)||!(sat=satid2no(satid))) continue;
+        if (buff[0]!='A'||buff[1]!='S'||strlen(buff)<34) continue;
         
-        if (!(satsys(sat,NULL)&mask)) continue;
+        strncpy(satid,buff+3,4);
         
-        for (i=0,j=40;i<2;i++,j+=20) data[i]=str2num(buff,j,19);
+        if (!(sat=satid2no(satid))||!(satsys(sat,NULL)&mask)) continue;
         
-        if (nav->nc>=nav->ncmax) {
-            nav->ncmax+=1024;
-            if (!(nav_pclk=(pclk_t *)realloc(nav->pclk,sizeof(pclk_t)*(nav->ncmax)))) {
-                trace(1,"readrnxclk malloc error: nmax=%d\n",nav->ncmax);
-                free(nav->pclk); nav->pclk=NULL; nav->nc=nav->ncmax=0;
-                return -1;
+        /* convert epoch only if changed from previous record */
+        if (strncmp(buff+8,epoch,26)) {
+            if (str2time(buff,8,26,&time)) {
+                trace(2,"rinex clk invalid epoch: %34.34s\n",buff);
+                continue;
+            }
+            strncpy(epoch,buff+8,26);
+            
+            /* pre-size precise clock at second epoch */
+            if (nep++==0) time0=time;
+            else if (nep==2&&last&&(tint=timediff(time,time0))>0.0) {
+                tint=timediff(tlast,time0)/tint+2.0;
+                if (tint<1E6&&!resvpclk(nav,(int)tint)) {
+                    stat=-1;
+                    break;
+                }
             }
-            nav->pclk=nav_pclk;
+        }
+        for (i=0;i<2;i++) data[i]=str2num(buff,40+i*20,19);
+        if (nav->nc>=nav->ncmax&&!resvpclk(nav,1024)) {
+            stat=-1;
+            break;
         }
         if (nav->nc<=0||fabs(timediff(time,nav->pclk[nav->nc-1].time))>1E-9) {
-            nav->nc++;
-            nav->pclk[nav->nc-1].time =time;
-            nav->pclk[nav->nc-1].index=index;
+            pclk=nav->pclk+nav->nc++;
+            pclk->time =time;
+            pclk->index=index;
             for (i=0;i<MAXSAT;i++) {
-                nav->pclk[nav->nc-1].clk[i][0]=0.0;
-                nav->pclk[nav->nc-1].std[i][0]=0.0f;
+                pclk->clk[i][0]=0.0;
+                pclk->std[i][0]=0.0f;
             }
         }
         nav->pclk[nav->nc-1].clk[sat-1][0]=data[0];
         nav->pclk[nav->nc-1].std[sat-1][0]=(float)data[1];
     }
-    return nav->nc>0;
+    freelnbuf(&lb);
+    
+    return stat<0?-1:nav->nc>0;
 }
 /* read rinex file -----------------------------------------------------------*/
 static int readrnxfp(FILE *fp, gtime_t ts, gtime_t te, double tint,
@@ -1922,6 +1991,13 @@ extern int outrnxobsh(FILE *fp, const rnxopt_t *opt, const nav_t *nav)
     
     timestr_rnx(date);
     
+    if (opt->crx) { /* compact rinex */
+        fprintf(fp,"%-20s%-40s%-20s\n",opt->crx->ver==1?"1.0":"3.0",
+                "COMPACT RINEX FORMAT","CRINEX VERS   / TYPE");
+        fprintf(fp,"%-40.40s%-20.20s%-20s\n",opt->prog,date,
+                "CRINEX PROG / DATE");
+    }
+    
     if (opt->rnxver<=2.99) { /* ver.2 */
         sys=opt->navsys==SYS_GPS?"G (GPS)":"M (MIXED)";
     }
@@ -2011,22 +2087,50 @@ extern int outrnxobsh(FILE *fp, const rnxopt_t *opt, const nav_t *nav)
     }
     return fprintf(fp,"%-60.60s%-20s\n","","END OF HEADER")!=EOF;
 }
-/* output obs data field -----------------------------------------------------*/
-static void outrnxobsf(FILE *fp, double obs, int lli, int qual)
+/* format fixed-point field as "%*.3f" ---------------------------------------*/
+static char *fmtfix3(char *p, double value, int width)
+{
+    char s[32],*q=s+sizeof(s);
+    double a=fabs(value),x,r,f;
+    unsigned long ip,fp;
+    int i;
+    
+    x=a*1000.0; r=floor(x); f=x-r;
+    
+    /* printf for out of range or value close to half of last digit */
+    if (!(a<1E9)||value==0.0||fabs(f-0.5)<1E-3) {
+        return p+sprintf(p,"%*.3f",width,value);
+    }
+    if (f>0.5) r+=1.0;
+    ip=(unsigned long)floor(r/1000.0);
+    fp=(unsigned long)(r-ip*1000.0);
+    for (i=0;i<3;i++,fp/=10) *--q=(char)('0'+fp%10);
+    *--q='.';
+    do *--q=(char)('0'+ip%10); while (ip/=10);
+    if (value<0.0) *--q='-';
+    for (i=(int)(s+sizeof(s)-q);i<width;i++) *p++=' ';
+    while (q<s+sizeof(s)) *p++=*q++;
+    return p;
+}
+/* format obs data field -----------------------------------------------------*/
+static char *fmtrnxobsf(char *p, double obs, int lli, int qual)
 {
-    if (obs==0.0) { 
-        fprintf(fp,"              ");
+    if (obs==0.0) {
+        memset(p,' ',14); p+=14;
     }
     else {
-        fprintf(fp,"%14.3f",fmod(obs,1e9));
+        p=fmtfix3(p,fmod(obs,1e9),14);
     }
     if (lli<0||!(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK))) {
-        fprintf(fp," ");
+        *p++=' ';
     }
     else {
-        fprintf(fp,"%1.1d",lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK));
+        *p++=(char)('0'+(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK)));
     }
-    if (qual<=0) fprintf(fp," "); else fprintf(fp,"%1.1x",qual);
+    if (qual<=0) *p++=' ';
+    else if (qual<16) *p++="0123456789abcdef"[qual];
+    else p+=sprintf(p,"%1.1x",qual);
+    return p;
 }
 /* search obs data index -----------------------------------------------------*/
 static int obsindex(double ver, int sys, const unsigned char *code,
@@ -2090,26 +2194,41 @@ static int obsindex(double ver, int sys, const unsigned char *code,
     }
     return -1;
 }
+/* output rinex obs records ----------------------------------------------------
+* output formatted rinex obs body text as rinex or compact rinex
+* args   : FILE   *fp       I   output file pointer
+*          rnxopt_t *opt    I   rinex options (opt->crx: compact rinex encoder)
+*          char   *buff     I   rinex obs body text (partial lines allowed)
+*          int    n         I   number of chars in buff
+* return : status (1:ok, 0:output error)
+*-----------------------------------------------------------------------------*/
+extern int outrnxobsr(FILE *fp, const rnxopt_t *opt, const char *buff, int n)
+{
+    if (opt->crx) return outcrxobs(opt->crx,fp,buff,n);
+    return n<=0||fwrite(buff,n,1,fp)==1;
+}
 /* output rinex event time ---------------------------------------------------*/
 static void outrinexevent(FILE *fp, const rnxopt_t *opt, const obsd_t *obs,
                           const double epdiff)
 {
     int n;
     double epe[6];
+    char buff[256],*p=buff;
 
     time2epoch(obs[0].eventime,epe);
     n = obs->timevalid ? 0 : 1;
 
     if (opt->rnxver<=2.99) { /* ver.2 */
-        if (epdiff < 0) fprintf(fp,"\n");
-        fprintf(fp," %02d %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d",
-                (int)epe[0]%100,epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
-        if (epdiff >= 0) fprintf(fp,"\n");
+        if (epdiff < 0) p+=sprintf(p,"\n");
+        p+=sprintf(p," %02d %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d",
+                   (int)epe[0]%100,epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
+        if (epdiff >= 0) p+=sprintf(p,"\n");
     } else { /* ver.3 */
-        fprintf(fp,"> %04.0f %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d\n",
-                epe[0],epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
+        p+=sprintf(p,"> %04.0f %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d\n",
+                   epe[0],epe[1],epe[2],epe[3],epe[4],epe[5],5,n);
     }
-    if (n) fprintf(fp,"%-60.60s%-20s\n"," Time mark is not valid","COMMENT");
+    if (n) p+=sprintf(p,"%-60.60s%-20s\n"," Time mark is not valid","COMMENT");
+    outrnxobsr(fp,opt,buff,(int)(p-buff));
 }
 /* output rinex obs body -------------------------------------------------------
 * output rinex obs body
@@ -2125,7 +2244,7 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
 {
     const char *mask;
     double epdiff,ep[6];
-    char sats[MAXOBS][4]={""};
+    char sats[MAXOBS][4]={""},buff[OBSBUFFSIZE],*p=buff;
     int i,j,k,m,ns,sys,ind[MAXOBS],s[MAXOBS]={0};
 
     trace(3,"outrnxobsb: n=%d\n",n);
@@ -2156,48 +2275,53 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
         outrinexevent(fp, opt, obs, epdiff);
     }
 
+    /* records are formatted into the buffer and written in blocks */
     if (opt->rnxver<=2.99) { /* ver.2 */
-        fprintf(fp," %02d %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d",
-                (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5],0,ns);
+        p+=sprintf(p," %02d %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d",
+                   (int)ep[0]%100,ep[1],ep[2],ep[3],ep[4],ep[5],0,ns);
         for (i=0;i<ns;i++) {
-            if (i>0&&i%12==0) fprintf(fp,"\n%32s","");
-            fprintf(fp,"%-3s",sats[i]);
+            if (i>0&&i%12==0) p+=sprintf(p,"\n%32s","");
+            p+=sprintf(p,"%-3s",sats[i]);
         }
     }
     else { /* ver.3 */
-        fprintf(fp,"> %04.0f %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d%21s\n",
-                ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],0,ns,"");
+        p+=sprintf(p,"> %04.0f %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d%21s\n",
+                   ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],0,ns,"");
     }
     for (i=0;i<ns;i++) {
         sys=satsys(obs[ind[i]].sat,NULL);
         
+        if (p-buff>OBSBUFFSIZE-2*MAXRNXLEN) {
+            if (!outrnxobsr(fp,opt,buff,(int)(p-buff))) return 0;
+            p=buff;
+        }
         if (opt->rnxver<=2.99) { /* ver.2 */
             m=0;
             mask=opt->mask[s[i]];
         }
         else { /* ver.3 */
-            fprintf(fp,"%-3s",sats[i]);
+            p+=sprintf(p,"%-3s",sats[i]);
             m=s[i];
             mask=opt->mask[s[i]];
         }
         for (j=0;j<opt->nobs[m];j++) {
             
             if (opt->rnxver<=2.99) { /* ver.2 */
-                if (j%5==0) fprintf(fp,"\n");
+                if (j%5==0) *p++='\n';
             }
             /* search obs data index */
             if ((k=obsindex(opt->rnxver,sys,obs[ind[i]].code,opt->tobs[m][j],
                             mask))<0) {
-                outrnxobsf(fp,0.0,-1,-1);
+                p=fmtrnxobsf(p,0.0,-1,-1);
                 continue;
             }
             /* output field */
             switch (opt->tobs[m][j][0]) {
                 case 'C':
-                case 'P': outrnxobsf(fp,obs[ind[i]].P[k],-1,obs[ind[i]].qualP[k]); break;
-                case 'L': outrnxobsf(fp,obs[ind[i]].L[k],obs[ind[i]].LLI[k],obs[ind[i]].qualL[k]); break;
-                case 'D': outrnxobsf(fp,obs[ind[i]].D[k],-1,-1); break;
-                case 'S': outrnxobsf(fp,obs[ind[i]].SNR[k]*0.25,-1,-1); break;
+                case 'P': p=fmtrnxobsf(p,obs[ind[i]].P[k],-1,obs[ind[i]].qualP[k]); break;
+                case 'L': p=fmtrnxobsf(p,obs[ind[i]].L[k],obs[ind[i]].LLI[k],obs[ind[i]].qualL[k]); break;
+                case 'D': p=fmtrnxobsf(p,obs[ind[i]].D[k],-1,-1); break;
+                case 'S': p=fmtrnxobsf(p,obs[ind[i]].SNR[k]*0.25,-1,-1); break;
             }
         }
 
@@ -2211,8 +2335,9 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
                 obs[ind[i]].SNR[1]*0.25, obs[ind[i]].LLI[1], obs[ind[i]].qualL[1]);
         }
 
-        if (opt->rnxver>2.99&&fprintf(fp,"\n")==EOF) return 0;
+        if (opt->rnxver>2.99) *p++='\n';
     }
+    if (!outrnxobsr(fp,opt,buff,(int)(p-buff))) return 0;
 
     if (flag == 5 && epdiff < 0) {
         outrinexevent(fp, opt, obs, epdiff);
@@ -2220,13 +2345,34 @@ extern int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obs, int n,
 
     if (opt->rnxver>2.99) return 1;
     
-    return fprintf(fp,"\n")!=EOF;
+    return outrnxobsr(fp,opt,"\n",1);
 }
 /* output nav member by rinex nav format -------------------------------------*/
 static void outnavf(FILE *fp, double value)
 {
     double e=fabs(value)<1E-99?0.0:floor(log10(fabs(value))+1.0);
-    fprintf(fp," %s.%012.0fE%+03.0f",value<0.0?"-":" ",fabs(value)/pow(10.0,e-12.0),e);
+    double m=fabs(value)/pow(10.0,e-12.0),r=floor(m),f=m-r;
+    unsigned long hi,lo;
+    char buff[64],*p=buff;
+    int i;
+    
+    /* printf for out of range values */
+    if (!(m<1E13)||!(fabs(e)<100.0)) {
+        fprintf(fp," %s.%012.0fE%+03.0f",value<0.0?"-":" ",m,e);
+        return;
+    }
+    /* round half to even as printf */
+    if (f>0.5||(f==0.5&&fmod(r,2.0)!=0.0)) r+=1.0;
+    hi=(unsigned long)floor(r/1E6);
+    lo=(unsigned long)(r-hi*1E6);
+    *p++=' '; *p++=value<0.0?'-':' '; *p++='.';
+    if (hi>=1000000) p+=sprintf(p,"%lu",hi);
+    else for (i=100000;i>0;i/=10) *p++=(char)('0'+hi/i%10);
+    for (i=100000;i>0;i/=10) *p++=(char)('0'+lo/i%10);
+    *p++='E'; *p++=e<0.0?'-':'+';
+    i=(int)fabs(e);
+    *p++=(char)('0'+i/10); *p++=(char)('0'+i%10); *p='\0';
+    fputs(buff,fp);
 }
 /* output rinex nav header -----------------------------------------------------
 * output rinex nav file header
@@ -2766,3 +2912,285 @@ extern int outrnxinavh(FILE *fp, const rnxopt_t *opt, const nav_t *nav)
     }
     return fprintf(fp,"%60s%-20s\n","","END OF HEADER")!=EOF;
 }
+/*------------------------------------------------------------------------------
+* compact rinex (hatanaka) encoder functions
+*-----------------------------------------------------------------------------*/
+
+/* initialize compact rinex encoder --------------------------------------------
+* initialize compact rinex (hatanaka) encoder
+* args   : crx_t  *crx      IO  compact rinex encoder
+*          rnxopt_t *opt    I   rinex options (rnxver,nobs)
+* return : status (1:ok,0:memory allocation error)
+* notes  : crinex 1.0 for rinex ver.2 and 3.0 for ver.3 is encoded with the
+*          difference order 3. receiver clock offset is not encoded as
+*          outrnxobsb() does not output it.
+*-----------------------------------------------------------------------------*/
+extern int init_crx(crx_t *crx, const rnxopt_t *opt)
+{
+    int i;
+    
+    trace(3,"init_crx:\n");
+    
+    memset(crx,0,sizeof(crx_t));
+    crx->ver=opt->rnxver<=2.99?1:3;
+    for (i=0;i<7;i++) crx->nobs[i]=opt->nobs[i];
+    crx->init=1;
+    
+    if (!(crx->sat=(crxsat_t *)calloc(sizeof(crxsat_t),MAXSAT))) return 0;
+    return 1;
+}
+/* free compact rinex encoder ------------------------------------------------*/
+extern void free_crx(crx_t *crx)
+{
+    trace(3,"free_crx:\n");
+    
+    free(crx->sat ); crx->sat =NULL;
+    free(crx->buff); crx->buff=NULL;
+    crx->nb=crx->nbmax=0;
+}
+/* append string to output buffer --------------------------------------------*/
+static int crx_append(crx_t *crx, const char *str, int n)
+{
+    char *buff;
+    int nmax;
+    
+    if (crx->nb+n>crx->nbmax) {
+        nmax=crx->nbmax<=0?65536:crx->nbmax*2;
+        while (nmax<crx->nb+n) nmax*=2;
+        if (!(buff=(char *)realloc(crx->buff,nmax))) return 0;
+        crx->buff=buff;
+        crx->nbmax=nmax;
+    }
+    memcpy(crx->buff+crx->nb,str,n);
+    crx->nb+=n;
+    return 1;
+}
+/* text difference -------------------------------------------------------------
+* ' ': same as previous, '&': space, others: new character. if init is set,
+* all characters are output as the previous string is unknown to decoder
+*-----------------------------------------------------------------------------*/
+static int crx_strdiff(const char *str, int n, const char *str_p, int init,
+                       char *out)
+{
+    int i,m=0,n_p=(int)strlen(str_p);
+    char c,c_p;
+    
+    for (i=0;i<n||(!init&&i<n_p);i++) {
+        c  =i<n  ?str[i]  :' ';
+        c_p=i<n_p?str_p[i]:' ';
+        if (init) out[i]=c==' '?'&':c;
+        else out[i]=c==c_p?' ':(c==' '?'&':c);
+        if (out[i]!=' ') m=i+1;
+    }
+    out[m]='\0';
+    return m;
+}
+/* right trimmed length of string --------------------------------------------*/
+static int crx_trimlen(const char *str, int n)
+{
+    while (n>0&&(str[n-1]==' '||str[n-1]=='\r'||str[n-1]=='\n')) n--;
+    return n;
+}
+/* obs type index by satellite system code -----------------------------------*/
+static int crx_nobs(const crx_t *crx, char code)
+{
+    const char *p;
+    
+    if (crx->ver==1) return crx->nobs[0];
+    return (p=strchr(syscodes,code))&&*p?crx->nobs[p-syscodes]:0;
+}
+/* encode data record of satellite ---------------------------------------------
+* data line: <field> <field> ... <field> <flags>, field: M&<value> (arc init),
+* <difference> or empty (no data). values are integers in 0.001 unit
+*-----------------------------------------------------------------------------*/
+static int crx_encsat(crx_t *crx, const char *id, int nt)
+{
+    crxsat_t sat0={0},*s=&sat0;
+    double val,d[4];
+    char out[32*MAXOBSTYPE+64],flag[MAXOBSTYPE*2+1],*p=out,*q;
+    const char *f;
+    int i,j,k,sat,init,sign;
+    
+    if ((sat=satid2no(id))>0) s=crx->sat+sat-1;
+    init=crx->init||s->epoch!=crx->nep-1;
+    s->epoch=crx->nep;
+    
+    for (i=crx->nd;i<16*nt;i++) crx->data[i]=' ';
+    
+    for (i=0;i<nt;i++) {
+        f=crx->data+16*i;
+        flag[i*2  ]=f[14];
+        flag[i*2+1]=f[15];
+        if (i>0) *p++=' ';
+        
+        /* value in 0.001 unit */
+        for (j=0,val=0.0,sign=0,k=0;j<14;j++) {
+            if (f[j]=='-') sign=1;
+            else if ('0'<=f[j]&&f[j]<='9') {val=val*10.0+(f[j]-'0'); k=1;}
+        }
+        if (!k) { /* no data */
+            s->arc[i]=0;
+            continue;
+        }
+        if (sign) val=-val;
+        
+        if (init||s->arc[i]==0) { /* initialize data arc */
+            p+=sprintf(p,"3&%.0f",val);
+            s->dat[i][0]=val;
+            s->arc[i]=1;
+            continue;
+        }
+        for (d[0]=val,j=1;j<=s->arc[i];j++) d[j]=d[j-1]-s->dat[i][j-1];
+        p+=sprintf(p,"%.0f",d[s->arc[i]]);
+        for (j=0;j<=s->arc[i];j++) s->dat[i][j]=d[j];
+        if (s->arc[i]<3) s->arc[i]++;
+    }
+    *p++=' ';
+    q=p;
+    p+=crx_strdiff(flag,nt*2,s->flag,init,p);
+    memcpy(s->flag,flag,nt*2);
+    s->flag[nt*2]='\0';
+    
+    /* remove trailing spaces of the flags as well as no flag differences */
+    if (p==q) p--;
+    *p++='\n';
+    return crx_append(crx,out,(int)(p-out));
+}
+/* output compact rinex epoch ------------------------------------------------*/
+static int crx_outepoch(crx_t *crx, FILE *fp)
+{
+    char out[sizeof(crx->epoch)+2];
+    int n=(int)strlen(crx->epoch),stat;
+    
+    if (crx->init) {
+        strcpy(out,crx->epoch);
+        if (crx->ver==1) out[0]='&';
+        out[crx_trimlen(out,n)]='\0';
+    }
+    else {
+        crx_strdiff(crx->epoch,n,crx->epoch_p,0,out);
+    }
+    strcpy(crx->epoch_p,crx->epoch);
+    
+    /* epoch line, receiver clock offset line (empty) and data lines */
+    stat=fprintf(fp,"%s\n\n",out)!=EOF&&
+         (crx->nb<=0||fwrite(crx->buff,crx->nb,1,fp)==1);
+    crx->nb=0;
+    crx->nep++;
+    crx->init=0;
+    return stat;
+}
+/* encode a line of rinex obs body -------------------------------------------*/
+static int crx_encline(crx_t *crx, FILE *fp)
+{
+    char *line=crx->line,id[4]="";
+    int n,nt,flag,pos=crx->ver==1?28:31;
+    
+    line[crx->nc]='\0';
+    n=crx_trimlen(line,crx->nc);
+    
+    switch (crx->stat) {
+        case 0: /* epoch line (flag at col 29 for ver.2 or col 32 for ver.3) */
+            if (n<pos+4||(crx->ver==3&&line[0]!='>')) {
+                trace(2,"crx_encline: invalid epoch line: %.40s\n",line);
+                return 1;
+            }
+            flag=(int)str2num(line,pos,1);
+            crx->ns=(int)str2num(line,pos+1,3);
+            
+            if (flag>1) { /* event: output as is and initialize next epoch */
+                line[n]='\0';
+                if (crx->ver==1) line[0]='&';
+                if (fprintf(fp,"%s\n",line)==EOF) return 0;
+                crx->init=1;
+                if (crx->ns>0) {
+                    crx->stat=3;
+                    crx->nline=crx->ns;
+                }
+                return 1;
+            }
+            if (crx->ver==1) {
+                sprintf(crx->epoch,"%-32.32s%.36s",line,n>32?line+32:"");
+                crx->epoch[crx_trimlen(crx->epoch,(int)strlen(crx->epoch))]='\0';
+                crx->stat=crx->ns>12?1:2;
+                nt=crx->nobs[0];
+                crx->nline=nt>0?(nt-1)/5+1:0;
+            }
+            else {
+                sprintf(crx->epoch,"%-41.41s",line);
+                crx->stat=2;
+                crx->nline=1;
+            }
+            crx->isat=crx->nd=0;
+            if (crx->ns<=0||crx->nline<=0) {
+                crx->stat=0;
+                return crx_outepoch(crx,fp);
+            }
+            return 1;
+            
+        case 1: /* satellite list continuation (ver.2) */
+            n=(int)strlen(crx->epoch);
+            sprintf(crx->epoch+n,"%.36s",crx->nc>32?line+32:"");
+            crx->epoch[crx_trimlen(crx->epoch,(int)strlen(crx->epoch))]='\0';
+            if (32+3*crx->ns<=(int)strlen(crx->epoch)) crx->stat=2;
+            return 1;
+            
+        case 2: /* observation data */
+            if (crx->ver==1) {
+                sprintf(crx->data+crx->nd,"%-80.80s",line);
+                crx->nd+=80;
+                if (--crx->nline>0) return 1;
+                memcpy(id,crx->epoch+32+3*crx->isat,3);
+                nt=crx->nobs[0];
+                crx->nd=crx->nd<16*nt?crx->nd:16*nt;
+            }
+            else {
+                memcpy(id,line,3);
+                nt=crx_nobs(crx,id[0]);
+                n=crx->nc>3?crx->nc-3:0;
+                n=n<16*nt?n:16*nt;
+                memcpy(crx->data,line+3,n);
+                crx->nd=n;
+                n=(int)strlen(crx->epoch);
+                if (n+3<(int)sizeof(crx->epoch)) sprintf(crx->epoch+n,"%s",id);
+            }
+            if (!crx_encsat(crx,id,nt)) return 0;
+            crx->nd=0;
+            if (crx->ver==1) {
+                nt=crx->nobs[0];
+                crx->nline=nt>0?(nt-1)/5+1:0;
+            }
+            if (++crx->isat<crx->ns) return 1;
+            crx->stat=0;
+            return crx_outepoch(crx,fp);
+            
+        case 3: /* event records */
+            if (--crx->nline<=0) crx->stat=0;
+            return fprintf(fp,"%s\n",line)!=EOF;
+    }
+    return 1;
+}
+/* output compact rinex obs body -----------------------------------------------
+* encode rinex obs body text and output compact rinex obs body
+* args   : crx_t  *crx      IO  compact rinex encoder
+*          FILE   *fp       I   output file pointer
+*          char   *buff     I   rinex obs body text (partial lines allowed)
+*          int    n         I   number of chars in buff
+* return : status (1:ok, 0:output error)
+* notes  : the rinex obs body should be the format output by outrnxobsb()
+*-----------------------------------------------------------------------------*/
+extern int outcrxobs(crx_t *crx, FILE *fp, const char *buff, int n)
+{
+    int i;
+    
+    for (i=0;i<n;i++) {
+        if (buff[i]=='\n') {
+            if (!crx_encline(crx,fp)) return 0;
+            crx->nc=0;
+        }
+        else if (crx->nc<(int)sizeof(crx->line)-1) {
+            crx->line[crx->nc++]=buff[i];
+        }
+    }
+    return 1;
+}
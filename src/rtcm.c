@@ -49,6 +49,10 @@
 *           2018/10/10 1.10 fix bug on initializing rtcm struct
 *                           add rtcm option -GALINAV, -GALFNAV
 *           2018/11/05 1.11 add notes for api gen_rtcm3()
+*           2026/10/17 1.12 add api input_rtcm3b()
+*                           read frames by blocks in input_rtcm3f()
+*                           allocate ssr corrections on demand
+*                           notify decoded obs, ephemeris and ssr to rtcm->sink
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -62,6 +66,8 @@ extern int encode_rtcm3(rtcm_t *rtcm, int type, int sync);
 #define RTCM2PREAMB 0x66        /* rtcm ver.2 frame preamble */
 #define RTCM3PREAMB 0xD3        /* rtcm ver.3 frame preamble */
 
+#define MIN(x,y)    ((x)<(y)?(x):(y))
+
 /* initialize rtcm control -----------------------------------------------------
 * initialize rtcm control struct and reallocate memory for observation and
 * ephemeris buffer in rtcm control struct
@@ -74,7 +80,7 @@ extern int init_rtcm(rtcm_t *rtcm)
     obsd_t data0={{0}};
     eph_t  eph0 ={0,-1,-1};
     geph_t geph0={0,-1};
-    ssr_t ssr0={{{0}}};
+    decsink_t sink0={0};
     int i,j;
     
     trace(3,"init_rtcm:\n");
@@ -90,10 +96,10 @@ extern int init_rtcm(rtcm_t *rtcm)
     }
     rtcm->sta.hgt=0.0;
     rtcm->dgps=NULL;
-    for (i=0;i<MAXSAT;i++) {
-        rtcm->ssr[i]=ssr0;
-    }
+    rtcm->ssr=NULL;
+    rtcm->sink=sink0;
     rtcm->msg[0]=rtcm->msgtype[0]=rtcm->opt[0]='\0';
+    rtcm->codepri.stamp=0;
     for (i=0;i<6;i++) rtcm->msmtype[i][0]='\0';
     rtcm->obsflag=rtcm->ephsat=0;
     for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ+NEXOBS;j++) {
@@ -109,6 +115,8 @@ extern int init_rtcm(rtcm_t *rtcm)
     rtcm->obs.data=NULL;
     rtcm->nav.eph =NULL;
     rtcm->nav.geph=NULL;
+    rtcm->nav.pcvs=NULL; rtcm->nav.ssr=NULL; rtcm->nav.dgps=NULL;
+    rtcm->nav.lexeph=NULL; rtcm->nav.sbssat=NULL; rtcm->nav.sbsion=NULL;
     
     /* reallocate memory for observation and ephemris buffer */
     if (!(rtcm->obs.data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))||
@@ -138,6 +146,24 @@ extern void free_rtcm(rtcm_t *rtcm)
     free(rtcm->obs.data); rtcm->obs.data=NULL; rtcm->obs.n=0;
     free(rtcm->nav.eph ); rtcm->nav.eph =NULL; rtcm->nav.n=0;
     free(rtcm->nav.geph); rtcm->nav.geph=NULL; rtcm->nav.ng=0;
+    
+    /* free memory for ssr and navigation corrections */
+    free(rtcm->ssr); rtcm->ssr=NULL;
+    freenav(&rtcm->nav,0x1F00);
+}
+/* notify decoded data to event sink ----------------------------------------*/
+static int notify_rtcm(rtcm_t *rtcm, int ret)
+{
+    if (ret==1&&rtcm->sink.on_obs_epoch) {
+        rtcm->sink.on_obs_epoch(&rtcm->sink,&rtcm->obs);
+    }
+    else if (ret==2&&rtcm->sink.on_ephemeris) {
+        rtcm->sink.on_ephemeris(&rtcm->sink,rtcm->ephsat,&rtcm->nav);
+    }
+    else if (ret==10&&rtcm->ssr&&rtcm->sink.on_ssr) {
+        rtcm->sink.on_ssr(&rtcm->sink,rtcm->ssr);
+    }
+    return ret;
 }
 /* input rtcm 2 message from stream --------------------------------------------
 * fetch next rtcm 2 message and input a message from byte stream
@@ -152,6 +178,9 @@ extern void free_rtcm(rtcm_t *rtcm)
 *          ambiguity of time in rtcm messages.
 *          supported msgs RTCM ver.2: 1,3,9,14,16,17,18,19,22
 *          refer [1] for RTCM ver.2
+*          observation data, ephemeris and ssr corrections are also passed by
+*          pointers to the callbacks in rtcm->sink if set after init_rtcm().
+*          the pointers are valid only until the next input.
 *-----------------------------------------------------------------------------*/
 extern int input_rtcm2(rtcm_t *rtcm, unsigned char data)
 {
@@ -190,10 +219,20 @@ extern int input_rtcm2(rtcm_t *rtcm, unsigned char data)
         rtcm->nbyte=0; rtcm->word&=0x3;
         
         /* decode rtcm2 message */
-        return decode_rtcm2(rtcm);
+        return notify_rtcm(rtcm,decode_rtcm2(rtcm));
     }
     return 0;
 }
+/* check parity and decode rtcm 3 frame ---------------------------------------*/
+static int decode_frame3(rtcm_t *rtcm)
+{
+    if (rtk_crc24q(rtcm->buff,rtcm->len)!=getbitu(rtcm->buff,rtcm->len*8,24)) {
+        trace(2,"rtcm3 parity error: len=%d\n",rtcm->len);
+        return 0;
+    }
+    /* decode rtcm3 message */
+    return notify_rtcm(rtcm,decode_rtcm3(rtcm));
+}
 /* input rtcm 3 message from stream --------------------------------------------
 * fetch next rtcm 3 message and input a message from byte stream
 * args   : rtcm_t *rtcm IO   rtcm control struct
@@ -279,13 +318,64 @@ extern int input_rtcm3(rtcm_t *rtcm, unsigned char data)
     if (rtcm->nbyte<3||rtcm->nbyte<rtcm->len+3) return 0;
     rtcm->nbyte=0;
     
-    /* check parity */
-    if (rtk_crc24q(rtcm->buff,rtcm->len)!=getbitu(rtcm->buff,rtcm->len*8,24)) {
-        trace(2,"rtcm3 parity error: len=%d\n",rtcm->len);
-        return 0;
+    return decode_frame3(rtcm);
+}
+/* input rtcm 3 messages from buffer -------------------------------------------
+* fetch next rtcm 3 message and input a message from buffer
+* args   : rtcm_t *rtcm IO   rtcm control struct
+*          unsigned char *buff I stream data
+*          int    n      I   number of stream data (bytes)
+*          int    *pos   IO  buffer position (bytes)
+* return : status (same as input_rtcm3())
+* notes  : the function returns at every complete frame or at the end of the
+*          buffer (0) with *pos advanced to the next byte to be input.
+*          preambles are searched by memchr() and frames are copied in blocks.
+*          a frame may be split across buffers. the result is same as for
+*          input_rtcm3() with every byte of the buffer.
+*          usage:
+*            for (i=0;i<n;) {
+*                ret=input_rtcm3b(rtcm,buff,n,&i);
+*                ...
+*            }
+*-----------------------------------------------------------------------------*/
+extern int input_rtcm3b(rtcm_t *rtcm, const unsigned char *buff, int n,
+                        int *pos)
+{
+    const unsigned char *p;
+    int i=*pos,k;
+    
+    trace(5,"input_rtcm3b: n=%d pos=%d\n",n,*pos);
+    
+    while (i<n) {
+        
+        /* synchronize frame */
+        if (rtcm->nbyte==0) {
+            if (!(p=(const unsigned char *)memchr(buff+i,RTCM3PREAMB,n-i))) {
+                i=n;
+                break;
+            }
+            i=(int)(p-buff);
+        }
+        /* frame header */
+        if (rtcm->nbyte<3) {
+            k=MIN(3-rtcm->nbyte,n-i);
+            memcpy(rtcm->buff+rtcm->nbyte,buff+i,k);
+            rtcm->nbyte+=k; i+=k;
+            if (rtcm->nbyte<3) break;
+            rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
+        }
+        /* message and parity */
+        k=MIN(rtcm->len+3-rtcm->nbyte,n-i);
+        memcpy(rtcm->buff+rtcm->nbyte,buff+i,k);
+        rtcm->nbyte+=k; i+=k;
+        if (rtcm->nbyte<rtcm->len+3) break;
+        rtcm->nbyte=0;
+        
+        *pos=i;
+        return decode_frame3(rtcm);
     }
-    /* decode rtcm3 message */
-    return decode_rtcm3(rtcm);
+    *pos=i;
+    return 0;
 }
 /* input rtcm 2 message from file ----------------------------------------------
 * fetch next rtcm 2 message and input a messsage from file
@@ -315,13 +405,32 @@ extern int input_rtcm2f(rtcm_t *rtcm, FILE *fp)
 *-----------------------------------------------------------------------------*/
 extern int input_rtcm3f(rtcm_t *rtcm, FILE *fp)
 {
-    int i,data=0,ret;
+    int i,k,data=0,ret;
     
     trace(4,"input_rtcm3f: data=%02x\n",data);
     
-    for (i=0;i<4096;i++) {
-        if ((data=fgetc(fp))==EOF) return -2;
-        if ((ret=input_rtcm3(rtcm,(unsigned char)data))) return ret;
+    for (i=0;i<4096;) {
+        
+        /* synchronize frame */
+        if (rtcm->nbyte==0) {
+            if ((data=getc(fp))==EOF) return -2;
+            i++;
+            if (data!=RTCM3PREAMB) continue;
+            rtcm->buff[rtcm->nbyte++]=(unsigned char)data;
+        }
+        /* read frame header, message and parity by blocks */
+        if (rtcm->nbyte<3) {
+            k=(int)fread(rtcm->buff+rtcm->nbyte,1,3-rtcm->nbyte,fp);
+            rtcm->nbyte+=k; i+=k;
+            if (rtcm->nbyte<3) return -2;
+            rtcm->len=getbitu(rtcm->buff,14,10)+3; /* length without parity */
+        }
+        k=(int)fread(rtcm->buff+rtcm->nbyte,1,rtcm->len+3-rtcm->nbyte,fp);
+        rtcm->nbyte+=k; i+=k;
+        if (rtcm->nbyte<rtcm->len+3) return -2;
+        rtcm->nbyte=0;
+        
+        if ((ret=decode_frame3(rtcm))) return ret;
     }
     return 0; /* return at every 4k bytes */
 }
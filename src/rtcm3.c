@@ -38,6 +38,10 @@
 *                           add rtcm option -GALINAV, -GALFNAV
 *           2018/11/05 1.20 fix problem on invalid time in message monitor
 *           2019/05/10 1.21 save galileo E5b data to obs index 2
+*           2026/10/17 1.22 add precomputed msm signal tables
+*                           msm_code[],msm_freq[],msm_lam[]
+*                           allocate ssr corrections on demand
+*                           use code priority table compiled from options
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -105,6 +109,81 @@ const char *msm_sig_cmp[32]={
     ""  ,"7I","7Q","7X",""  ,""  ,""  ,""  ,""  ,""  ,""  ,""  ,
     ""  ,""  ,""  ,""  ,""  ,""  ,""  ,""
 };
+/* msm signal tables ---------------------------------------------------------
+* precomputed from msm_sig_*[] to avoid string handling in msm decode/encode.
+* msm_freq[] includes the frequency index conversion of beidou and galileo.
+* wave lengths of glonass fdma signals depend on the satellite (0.0).
+*-----------------------------------------------------------------------------*/
+const unsigned char msm_code[6][32]={ /* msm signal id -> obs code */
+    { /* GPS */
+        CODE_NONE,CODE_L1C,CODE_L1P,CODE_L1W,CODE_L1Y,CODE_L1M,
+        CODE_NONE,CODE_L2C,CODE_L2P,CODE_L2W,CODE_L2Y,CODE_L2M,
+        CODE_NONE,CODE_NONE,CODE_L2S,CODE_L2L,CODE_L2X,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_L5I,CODE_L5Q,CODE_L5X,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_L1S,
+        CODE_L1L,CODE_L1X
+    },
+    { /* GLONASS */
+        CODE_NONE,CODE_L1C,CODE_L1P,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_L2C,CODE_L2P,CODE_NONE,CODE_L3I,CODE_L3Q,
+        CODE_L3X,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE
+    },
+    { /* Galileo */
+        CODE_NONE,CODE_L1C,CODE_L1A,CODE_L1B,CODE_L1X,CODE_L1Z,
+        CODE_NONE,CODE_L6C,CODE_L6A,CODE_L6B,CODE_L6X,CODE_L6Z,
+        CODE_NONE,CODE_L7I,CODE_L7Q,CODE_L7X,CODE_NONE,CODE_NONE,
+        CODE_L8Q,CODE_L8X,CODE_NONE,CODE_L5I,CODE_L5Q,CODE_L5X,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE
+    },
+    { /* QZSS */
+        CODE_NONE,CODE_L1C,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_L6S,CODE_L6L,CODE_L6X,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_L2S,CODE_L2L,CODE_L2X,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_L5I,CODE_L5Q,CODE_L5X,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_L1S,
+        CODE_L1L,CODE_L1X
+    },
+    { /* SBAS */
+        CODE_NONE,CODE_L1C,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_L5I,CODE_L5Q,CODE_L5X,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE
+    },
+    { /* BeiDou */
+        CODE_NONE,CODE_L2I,CODE_L2Q,CODE_L2X,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_L6I,CODE_L6Q,CODE_L6X,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_L7I,CODE_L7Q,CODE_L7X,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,CODE_NONE,
+        CODE_NONE,CODE_NONE
+    }
+};
+const unsigned char msm_freq[6][32]={ /* msm signal id -> frequency index */
+    {0,1,1,1,1,1,0,2,2,2,2,2,0,0,2,2,2,0,0,0,0,3,3,3,0,0,0,0,0,1,1,1},
+    {0,1,1,0,0,0,0,2,2,0,3,3,3,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0},
+    {0,1,1,1,1,1,0,4,4,4,4,4,0,2,2,2,0,0,2,2,0,3,3,3,0,0,0,0,0,0,0,0},
+    {0,1,0,0,0,0,0,0,4,4,4,0,0,0,2,2,2,0,0,0,0,3,3,3,0,0,0,0,0,1,1,1},
+    {0,1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,3,3,3,0,0,0,0,0,0,0,0},
+    {0,1,1,2,0,0,0,3,3,3,0,0,0,2,2,2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}
+};
+const double msm_lam[6][6]={ /* frequency index -> wave length (m) */
+    {CLIGHT/FREQL1   ,CLIGHT/FREQL2   ,CLIGHT/FREQL5   ,CLIGHT/FREQE6,0.0,0.0},
+    {0.0             ,0.0             ,CLIGHT/FREQ3_GLO,0.0          ,0.0,0.0},
+    {CLIGHT/FREQL1   ,CLIGHT/FREQE5b  ,CLIGHT/FREQL5   ,CLIGHT/FREQE6,0.0,
+     CLIGHT/FREQE5ab},
+    {CLIGHT/FREQL1   ,CLIGHT/FREQL2   ,CLIGHT/FREQL5   ,CLIGHT/FREQE6,0.0,0.0},
+    {CLIGHT/FREQL1   ,CLIGHT/FREQL2   ,CLIGHT/FREQL5   ,CLIGHT/FREQE6,0.0,0.0},
+    {CLIGHT/FREQ1_CMP,CLIGHT/FREQ2_CMP,CLIGHT/FREQ3_CMP,0.0          ,0.0,0.0}
+};
+static const char **msm_sigs[6]={
+    msm_sig_gps,msm_sig_glo,msm_sig_gal,msm_sig_qzs,msm_sig_sbs,msm_sig_cmp
+};
 /* ssr update intervals ------------------------------------------------------*/
 static const double ssrudint[16]={
     1,2,5,10,15,30,60,120,240,300,600,900,1800,3600,7200,10800
@@ -1266,6 +1345,17 @@ static int decode_type1042(rtcm_t *rtcm)
     rtcm->ephsat=sat;
     return 2;
 }
+/* allocate ssr corrections on demand ----------------------------------------*/
+static int alloc_ssr(rtcm_t *rtcm)
+{
+    if (rtcm->ssr) return 1;
+    
+    if (!(rtcm->ssr=(ssr_t *)calloc(MAXSAT,sizeof(ssr_t)))) {
+        trace(1,"rtcm3 ssr memory allocation error\n");
+        return 0;
+    }
+    return 1;
+}
 /* decode ssr 1,4 message header ---------------------------------------------*/
 static int decode_ssr1_head(rtcm_t *rtcm, int sys, int *sync, int *iod,
                             double *udint, int *refd, int *hsize)
@@ -1277,6 +1367,7 @@ static int decode_ssr1_head(rtcm_t *rtcm, int sys, int *sync, int *iod,
     ns=sys==SYS_QZS?4:6;
     
     if (i+(sys==SYS_GLO?53:50+ns)>rtcm->len*8) return -1;
+    if (!alloc_ssr(rtcm)) return -1;
     
     if (sys==SYS_GLO) {
         tod=getbitu(rtcm->buff,i,17); i+=17;
@@ -1318,6 +1409,7 @@ static int decode_ssr2_head(rtcm_t *rtcm, int sys, int *sync, int *iod,
     ns=sys==SYS_QZS?4:6;
     
     if (i+(sys==SYS_GLO?52:49+ns)>rtcm->len*8) return -1;
+    if (!alloc_ssr(rtcm)) return -1;
     
     if (sys==SYS_GLO) {
         tod=getbitu(rtcm->buff,i,17); i+=17;
@@ -1658,6 +1750,7 @@ static int decode_ssr7_head(rtcm_t *rtcm, int sys, int *sync, int *iod,
     ns=sys==SYS_QZS?4:6;
     
     if (i+(sys==SYS_GLO?54:51+ns)>rtcm->len*8) return -1;
+    if (!alloc_ssr(rtcm)) return -1;
     
     if (sys==SYS_GLO) {
         tod=getbitu(rtcm->buff,i,17); i+=17;
@@ -1752,7 +1845,7 @@ static int decode_ssr7(rtcm_t *rtcm, int sys)
 }
 /* get signal index ----------------------------------------------------------*/
 static void sigindex(int sys, const unsigned char *code, const int *freq, int n,
-                     const char *opt, int *ind)
+                     const codepri_t *codepri, int *ind)
 {
     int i,nex,pri,pri_h[8]={0},index[8]={0},ex[32]={0};
     
@@ -1765,7 +1858,7 @@ static void sigindex(int sys, const unsigned char *code, const int *freq, int n,
             continue;
         }
         /* code priority */
-        pri=getcodepri(sys,code[i],opt);
+        pri=tblcodepri(codepri,sys,code[i]);
         
         /* select highest priority signal */
         if (pri>pri_h[freq[i]-1]) {
@@ -1794,46 +1887,39 @@ static void save_msm_obs(rtcm_t *rtcm, int sys, msm_h_t *h, const double *r,
                          const double *rrf, const double *cnr, const int *lock,
                          const int *ex, const int *half)
 {
-    const char *sig[32];
-    double tt,wl;
+    const char *sig;
+    double tt,wl,lam[32];
     unsigned char code[32];
     char *msm_type="",*q=NULL;
-    int i,j,k,type,prn,sat,fn,index=0,freq[32],ind[32];
+    int i,j,k,m=-1,type,prn,sat,fn,index=0,freq[32],ind[32];
     
     type=getbitu(rtcm->buff,24,12);
     
     switch (sys) {
-        case SYS_GPS: msm_type=q=rtcm->msmtype[0]; break;
-        case SYS_GLO: msm_type=q=rtcm->msmtype[1]; break;
-        case SYS_GAL: msm_type=q=rtcm->msmtype[2]; break;
-        case SYS_QZS: msm_type=q=rtcm->msmtype[3]; break;
-        case SYS_SBS: msm_type=q=rtcm->msmtype[4]; break;
-        case SYS_CMP: msm_type=q=rtcm->msmtype[5]; break;
-    }
-    /* id to signal */
+        case SYS_GPS: m=0; break;
+        case SYS_GLO: m=1; break;
+        case SYS_GAL: m=2; break;
+        case SYS_QZS: m=3; break;
+        case SYS_SBS: m=4; break;
+        case SYS_CMP: m=5; break;
+    }
+    if (m>=0) msm_type=q=rtcm->msmtype[m];
+    
+    /* id to signal by msm signal tables */
     for (i=0;i<h->nsig;i++) {
-        switch (sys) {
-            case SYS_GPS: sig[i]=msm_sig_gps[h->sigs[i]-1]; break;
-            case SYS_GLO: sig[i]=msm_sig_glo[h->sigs[i]-1]; break;
-            case SYS_GAL: sig[i]=msm_sig_gal[h->sigs[i]-1]; break;
-            case SYS_QZS: sig[i]=msm_sig_qzs[h->sigs[i]-1]; break;
-            case SYS_SBS: sig[i]=msm_sig_sbs[h->sigs[i]-1]; break;
-            case SYS_CMP: sig[i]=msm_sig_cmp[h->sigs[i]-1]; break;
-            default: sig[i]=""; break;
-        }
-        /* signal to rinex obs type */
-        code[i]=obs2code(sig[i],freq+i);
-        
-        /* freqency index for beidou and galileo */
-        if (sys==SYS_CMP) {
-            if      (freq[i]==5) freq[i]=2; /* B2 */
-            else if (freq[i]==4) freq[i]=3; /* B3 */
+        if (m>=0) {
+            code[i]=msm_code[m][h->sigs[i]-1];
+            freq[i]=msm_freq[m][h->sigs[i]-1];
+            lam [i]=freq[i]>0?msm_lam[m][freq[i]-1]:0.0;
         }
-        else if (sys==SYS_GAL) {
-            if (freq[i]==5) freq[i]=2; /* E5b */
+        else {
+            code[i]=CODE_NONE; freq[i]=0; lam[i]=0.0;
         }
         if (code[i]!=CODE_NONE) {
-            if (q) q+=sprintf(q,"L%s%s",sig[i],i<h->nsig-1?",":"");
+            sig=msm_sigs[m][h->sigs[i]-1];
+            *q++='L'; *q++=sig[0]; *q++=sig[1];
+            if (i<h->nsig-1) *q++=',';
+            *q='\0';
         }
         else {
             if (q) q+=sprintf(q,"(%d)%s",h->sigs[i],i<h->nsig-1?",":"");
@@ -1844,7 +1930,8 @@ static void save_msm_obs(rtcm_t *rtcm, int sys, msm_h_t *h, const double *r,
     trace(3,"rtcm3 %d: signals=%s\n",type,msm_type);
     
     /* get signal index */
-    sigindex(sys,code,freq,h->nsig,rtcm->opt,ind);
+    updcodepri(&rtcm->codepri,rtcm->opt);
+    sigindex(sys,code,freq,h->nsig,&rtcm->codepri,ind);
     
     for (i=j=0;i<h->nsat;i++) {
         
@@ -1868,7 +1955,7 @@ static void save_msm_obs(rtcm_t *rtcm, int sys, msm_h_t *h, const double *r,
             if (sat&&index>=0&&ind[k]>=0) {
                 
                 /* satellite carrier wave length */
-                wl=satwavelen(sat,freq[k]-1,&rtcm->nav);
+                wl=lam[k]!=0.0?lam[k]:satwavelen(sat,freq[k]-1,&rtcm->nav);
                 
                 /* glonass wave length by extended info */
                 if (sys==SYS_GLO&&ex&&ex[i]<=13) {
@@ -35,6 +35,8 @@
 *           2018/10/10 1.17 merge changes for 2.4.2 p13
 *                           change mt for ssr 7 phase biases
 *           2019/05/10 1.21 save galileo E5b data to obs index 2
+*           2026/10/17 1.22 use precomputed msm signal tables in to_sigid()
+*                           skip ssr messages without ssr corrections
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -54,12 +56,51 @@
 #define MIN(x,y)    ((x)<(y)?(x):(y))
 
 /* msm signal id table -------------------------------------------------------*/
-extern const char *msm_sig_gps[32];
-extern const char *msm_sig_glo[32];
-extern const char *msm_sig_gal[32];
-extern const char *msm_sig_qzs[32];
-extern const char *msm_sig_sbs[32];
-extern const char *msm_sig_cmp[32];
+extern const unsigned char msm_freq[6][32];
+extern const double msm_lam[6][6];
+
+/* msm signal id by obs code (inverse of msm_code[] in rtcm3.c) ---------------
+* signals undefined by rtcm (gps L1Y,L1M,L1N,L2D,L2Y,L2M,L2N) are mapped to
+* L1P or L2P
+*-----------------------------------------------------------------------------*/
+static const unsigned char msm_sigid[6][MAXCODE+1]={ /* obs code -> signal id */
+    { /* GPS */
+         0, 2, 3, 4, 3, 3, 3,30,31, 0, 0, 0,32, 0,
+         8, 9,15,16,17, 9,10, 9, 9, 9,22,23,24, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    },
+    { /* GLONASS */
+         0, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         8, 0, 0, 0, 0, 9, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0,11,12,13, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    },
+    { /* Galileo */
+         0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 3, 4, 5, 6,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0,22,23,24,14,
+        15,16, 9,10, 8,11,12, 0, 0, 0,19,20, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    },
+    { /* QZSS */
+         0, 2, 0, 0, 0, 0, 0,30,31, 0, 0, 0,32, 0,
+         0, 0,15,16,17, 0, 0, 0, 0, 0,22,23,24, 0,
+         0, 0, 0, 0, 0,11, 0, 9,10, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    },
+    { /* SBAS */
+         0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0,22,23,24, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    },
+    { /* BeiDou */
+         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+         0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0, 0,14,
+        15,16, 0, 0, 0,10, 0, 0, 0, 0, 0, 0, 2, 3,
+         8, 9, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    }
+};
 
 /* ssr update intervals ------------------------------------------------------*/
 static const double ssrudint[16]={
@@ -1410,6 +1451,8 @@ static int encode_ssr1(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr1: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; ni= 8; nj= 0; offp=  0; break;
         case SYS_GLO: np=5; ni= 8; nj= 0; offp=  0; break;
@@ -1464,6 +1507,8 @@ static int encode_ssr2(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr2: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; offp=  0; break;
         case SYS_GLO: np=5; offp=  0; break;
@@ -1510,6 +1555,8 @@ static int encode_ssr3(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr3: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; offp=  0; codes=codes_gps; ncode=17; break;
         case SYS_GLO: np=5; offp=  0; codes=codes_glo; ncode= 4; break;
@@ -1557,6 +1604,8 @@ static int encode_ssr4(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr4: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; ni= 8; nj= 0; offp=  0; break;
         case SYS_GLO: np=5; ni= 8; nj= 0; offp=  0; break;
@@ -1617,6 +1666,8 @@ static int encode_ssr5(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr5: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; offp=  0; break;
         case SYS_GLO: np=5; offp=  0; break;
@@ -1654,6 +1705,8 @@ static int encode_ssr6(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr6: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; offp=  0; break;
         case SYS_GLO: np=5; offp=  0; break;
@@ -1694,6 +1747,8 @@ static int encode_ssr7(rtcm_t *rtcm, int sys, int sync)
     
     trace(3,"encode_ssr7: sys=%d sync=%d\n",sys,sync);
     
+    if (!rtcm->ssr) return 0;
+    
     switch (sys) {
         case SYS_GPS: np=6; offp=  0; codes=codes_gps; ncode=17; break;
         case SYS_GLO: np=5; offp=  0; codes=codes_glo; ncode= 4; break;
@@ -1753,45 +1808,25 @@ static int to_satid(int sys, int sat)
     return prn;
 }
 /* observation code to msm signal id -----------------------------------------*/
-static int to_sigid(int sys, unsigned char code, int *freq)
+static int to_sigid(int sys, unsigned char code, int *freq, double *lam)
 {
-    const char **msm_sig;
-    char *sig;
-    int i;
-    
-    /* signal conversion for undefined signal by rtcm */
-    if (sys==SYS_GPS) {
-        if      (code==CODE_L1Y) code=CODE_L1P;
-        else if (code==CODE_L1M) code=CODE_L1P;
-        else if (code==CODE_L1N) code=CODE_L1P;
-        else if (code==CODE_L2D) code=CODE_L2P;
-        else if (code==CODE_L2Y) code=CODE_L2P;
-        else if (code==CODE_L2M) code=CODE_L2P;
-        else if (code==CODE_L2N) code=CODE_L2P;
-    }
-    if (!*(sig=code2obs(code,freq))) return 0;
+    int m,sig;
     
     switch (sys) {
-        case SYS_GPS: msm_sig=msm_sig_gps; break;
-        case SYS_GLO: msm_sig=msm_sig_glo; break;
-        case SYS_GAL: msm_sig=msm_sig_gal; break;
-        case SYS_QZS: msm_sig=msm_sig_qzs; break;
-        case SYS_SBS: msm_sig=msm_sig_sbs; break;
-        case SYS_CMP: msm_sig=msm_sig_cmp; break;
+        case SYS_GPS: m=0; break;
+        case SYS_GLO: m=1; break;
+        case SYS_GAL: m=2; break;
+        case SYS_QZS: m=3; break;
+        case SYS_SBS: m=4; break;
+        case SYS_CMP: m=5; break;
         default: return 0;
     }
-    /* freqency index for beidou and galileo */
-    if (sys==SYS_CMP) {
-        if      (*freq==5) *freq=2; /* B2 */
-        else if (*freq==4) *freq=3; /* B3 */
-    }
-    else if (sys==SYS_GAL) {
-        if (*freq==5) *freq=2; /* E5b */
-    }
-    for (i=0;i<32;i++) {
-        if (!strcmp(sig,msm_sig[i])) return i+1;
-    }
-    return 0;
+    if (code<=CODE_NONE||MAXCODE<code||!(sig=msm_sigid[m][code])) return 0;
+    
+    /* freqency index and wave length (0.0: satellite dependent) */
+    *freq=msm_freq[m][sig-1];
+    if (lam) *lam=msm_lam[m][*freq-1];
+    return sig;
 }
 /* generate msm satellite, signal and cell index -----------------------------*/
 static void gen_msm_index(rtcm_t *rtcm, int sys, int *nsat, int *nsig,
@@ -1807,7 +1842,7 @@ static void gen_msm_index(rtcm_t *rtcm, int sys, int *nsat, int *nsig,
         if (!(sat=to_satid(sys,rtcm->obs.data[i].sat))) continue;
         
         for (j=0;j<NFREQ+NEXOBS;j++) {
-            if (!(sig=to_sigid(sys,rtcm->obs.data[i].code[j],&f))) continue;
+            if (!(sig=to_sigid(sys,rtcm->obs.data[i].code[j],&f,NULL))) continue;
             
             sat_ind[sat-1]=sig_ind[sig-1]=1;
         }
@@ -1823,7 +1858,7 @@ static void gen_msm_index(rtcm_t *rtcm, int sys, int *nsat, int *nsig,
         if (!(sat=to_satid(sys,rtcm->obs.data[i].sat))) continue;
         
         for (j=0;j<NFREQ+NEXOBS;j++) {
-            if (!(sig=to_sigid(sys,rtcm->obs.data[i].code[j],&f))) continue;
+            if (!(sig=to_sigid(sys,rtcm->obs.data[i].code[j],&f,NULL))) continue;
             
             cell=sig_ind[sig-1]-1+(sat_ind[sat-1]-1)*(*nsig);
             cell_ind[cell]=1;
@@ -1839,7 +1874,7 @@ static void gen_msm_sat(rtcm_t *rtcm, int sys, int nsat,
                         double *rrate, unsigned char *info)
 {
     obsd_t *data;
-    double lambda,rrng_s,rrate_s;
+    double lambda,lam,rrng_s,rrate_s;
     int i,j,k,sat,sig,f,fcn;
     
     for (i=0;i<64;i++) rrng[i]=rrate[i]=0.0;
@@ -1850,13 +1885,13 @@ static void gen_msm_sat(rtcm_t *rtcm, int sys, int nsat,
         fcn=fcn_glo(data->sat,rtcm,i);
         
         for (j=0;j<NFREQ+NEXOBS;j++) {
-            if (!(sig=to_sigid(sys,data->code[j],&f))) continue;
+            if (!(sig=to_sigid(sys,data->code[j],&f,&lam))) continue;
             k=sat_ind[sat-1]-1;
             if (sys==SYS_GLO&&fcn>=0) {
                 lambda=CLIGHT/((j==1?FREQ2_GLO:FREQ1_GLO)+
                            (j==1?DFRQ2_GLO:DFRQ1_GLO)*(fcn-7));
             } else {
-                lambda=satwavelen(data->sat,f-1,&rtcm->nav);
+                lambda=lam!=0.0?lam:satwavelen(data->sat,f-1,&rtcm->nav);
             }
             /* rough range (ms) and rough phase-range-rate (m/s) */
             rrng_s =ROUND( data->P[j]/RANGE_MS/P2_10)*RANGE_MS*P2_10;
@@ -1879,7 +1914,7 @@ static void gen_msm_sig(rtcm_t *rtcm, int sys, int nsat, int nsig, int ncell,
                         float *cnr)
 {
     obsd_t *data;
-    double lambda,psrng_s,phrng_s,rate_s,lt;
+    double lambda,lam,psrng_s,phrng_s,rate_s,lt;
     int i,j,k,fcn,sat,sig,cell,f,LLI;
     
     for (i=0;i<ncell;i++) {
@@ -1894,14 +1929,14 @@ static void gen_msm_sig(rtcm_t *rtcm, int sys, int nsat, int nsig, int ncell,
         fcn=fcn_glo(data->sat,rtcm,i);
         
         for (j=0;j<NFREQ+NEXOBS;j++) {
-            if (!(sig=to_sigid(sys,data->code[j],&f))) continue;
+            if (!(sig=to_sigid(sys,data->code[j],&f,&lam))) continue;
             k=sat_ind[sat-1]-1;
             if ((cell=cell_ind[sig_ind[sig-1]-1+k*nsig])>=64) continue;
             if (sys==SYS_GLO&&fcn>=0) {
                 lambda=CLIGHT/((j==1?FREQ2_GLO:FREQ1_GLO)+
                            (j==1?DFRQ2_GLO:DFRQ1_GLO)*(fcn-7));
             } else {
-                lambda=satwavelen(data->sat,f-1,&rtcm->nav);
+                lambda=lam!=0.0?lam:satwavelen(data->sat,f-1,&rtcm->nav);
             }
             psrng_s=data->P[j]==0.0?0.0:data->P[j]-rrng[k];
             phrng_s=data->L[j]==0.0||lambda<=0.0?0.0: data->L[j]*lambda-rrng [k];
@@ -125,7 +125,27 @@
 *           2016/09/19 1.42 modify api deg2dms() to consider numerical error
 *           2017/04/11 1.43 delete EXPORT for global variables
 *           2018/10/10 1.44 modify api satexclude()
+*           2026/10/17 1.45 add api rtk_compress()
+*                           rtk_crc24q() by slicing-by-8
+*                           add api allocnav()
+*                           free corrections by freenav()
+*                           skip sort of sorted data in sortobs()
+*                           add api updcodepri(),tblcodepri()
+*                           index antenna parameters in readpcv()
+*                           add api freepcv()
+*                           support IERS finals in readerp()
+*                           interpolate erp values by slopes in geterp()
+*                           add api str2dec()
+*                           str2num(),str2time() without sscanf()
+*                           add api initlnbuf(),freelnbuf(),getlnbuf()
+*                           add api tickgetus(),setthrdopt()
+*                           add api initobsring(),freeobsring(),obsringslot(),
+*                           obsringcommit(),obsringcount(),obsringpeek(),
+*                           obsringrelease()
 *-----------------------------------------------------------------------------*/
+#ifdef __linux__
+#define _GNU_SOURCE /* pthread_setname_np(),pthread_setaffinity_np() */
+#endif
 #define _POSIX_C_SOURCE 199506
 #include <stdarg.h>
 #include <ctype.h>
@@ -145,6 +165,7 @@
 
 #define SQR(x)      ((x)*(x))
 #define MAX_VAR_EPH SQR(300.0)  /* max variance eph to reject satellite (m^2) */
+#define MAXDECM     900719925474098.0 /* max mantissa to add digit (<2^53/10) */
 
 static const double gpst0[]={1980,1, 6,0,0,0}; /* gps time reference */
 static const double gst0 []={1999,8,22,0,0,0}; /* galileo system time reference */
@@ -270,6 +291,7 @@ static char codepris[7][MAXFREQ][16]={  /* code priority table */
     {"IQX"     ,"IQX"       ,"IQX"   ,"IQX"     ,""      ,""    }, /* BDS */
     {""        ,""          ,"ABCX"  ,""        ,""      ,"ABCX"}  /* IRN */
 };
+static int codepri_stamp=1;         /* stamp of code priority settings */
 static fatalfunc_t *fatalfunc=NULL; /* fatal callback function */
 
 /* crc tables generated by util/gencrc ---------------------------------------*/
@@ -341,6 +363,246 @@ static const unsigned int tbl_CRC24Q[]={
     0xE37B16,0x6537ED,0x69AE1B,0xEFE2E0,0x709DF7,0xF6D10C,0xFA48FA,0x7C0401,
     0x42FA2F,0xC4B6D4,0xC82F22,0x4E63D9,0xD11CCE,0x575035,0x5BC9C3,0xDD8538
 };
+static const unsigned int tbl_CRC24Q8[7][256]={ /* slicing-by-8 tables */
+    { /* 1 zero byte */
+        0x000000,0x668F48,0xCD1E90,0xAB91D8,0x1C71DB,0x7AFE93,0xD16F4B,0xB7E003,
+        0x38E3B6,0x5E6CFE,0xF5FD26,0x93726E,0x24926D,0x421D25,0xE98CFD,0x8F03B5,
+        0x71C76C,0x174824,0xBCD9FC,0xDA56B4,0x6DB6B7,0x0B39FF,0xA0A827,0xC6276F,
+        0x4924DA,0x2FAB92,0x843A4A,0xE2B502,0x555501,0x33DA49,0x984B91,0xFEC4D9,
+        0xE38ED8,0x850190,0x2E9048,0x481F00,0xFFFF03,0x99704B,0x32E193,0x546EDB,
+        0xDB6D6E,0xBDE226,0x1673FE,0x70FCB6,0xC71CB5,0xA193FD,0x0A0225,0x6C8D6D,
+        0x9249B4,0xF4C6FC,0x5F5724,0x39D86C,0x8E386F,0xE8B727,0x4326FF,0x25A9B7,
+        0xAAAA02,0xCC254A,0x67B492,0x013BDA,0xB6DBD9,0xD05491,0x7BC549,0x1D4A01,
+        0x41514B,0x27DE03,0x8C4FDB,0xEAC093,0x5D2090,0x3BAFD8,0x903E00,0xF6B148,
+        0x79B2FD,0x1F3DB5,0xB4AC6D,0xD22325,0x65C326,0x034C6E,0xA8DDB6,0xCE52FE,
+        0x309627,0x56196F,0xFD88B7,0x9B07FF,0x2CE7FC,0x4A68B4,0xE1F96C,0x877624,
+        0x087591,0x6EFAD9,0xC56B01,0xA3E449,0x14044A,0x728B02,0xD91ADA,0xBF9592,
+        0xA2DF93,0xC450DB,0x6FC103,0x094E4B,0xBEAE48,0xD82100,0x73B0D8,0x153F90,
+        0x9A3C25,0xFCB36D,0x5722B5,0x31ADFD,0x864DFE,0xE0C2B6,0x4B536E,0x2DDC26,
+        0xD318FF,0xB597B7,0x1E066F,0x788927,0xCF6924,0xA9E66C,0x0277B4,0x64F8FC,
+        0xEBFB49,0x8D7401,0x26E5D9,0x406A91,0xF78A92,0x9105DA,0x3A9402,0x5C1B4A,
+        0x82A296,0xE42DDE,0x4FBC06,0x29334E,0x9ED34D,0xF85C05,0x53CDDD,0x354295,
+        0xBA4120,0xDCCE68,0x775FB0,0x11D0F8,0xA630FB,0xC0BFB3,0x6B2E6B,0x0DA123,
+        0xF365FA,0x95EAB2,0x3E7B6A,0x58F422,0xEF1421,0x899B69,0x220AB1,0x4485F9,
+        0xCB864C,0xAD0904,0x0698DC,0x601794,0xD7F797,0xB178DF,0x1AE907,0x7C664F,
+        0x612C4E,0x07A306,0xAC32DE,0xCABD96,0x7D5D95,0x1BD2DD,0xB04305,0xD6CC4D,
+        0x59CFF8,0x3F40B0,0x94D168,0xF25E20,0x45BE23,0x23316B,0x88A0B3,0xEE2FFB,
+        0x10EB22,0x76646A,0xDDF5B2,0xBB7AFA,0x0C9AF9,0x6A15B1,0xC18469,0xA70B21,
+        0x280894,0x4E87DC,0xE51604,0x83994C,0x34794F,0x52F607,0xF967DF,0x9FE897,
+        0xC3F3DD,0xA57C95,0x0EED4D,0x686205,0xDF8206,0xB90D4E,0x129C96,0x7413DE,
+        0xFB106B,0x9D9F23,0x360EFB,0x5081B3,0xE761B0,0x81EEF8,0x2A7F20,0x4CF068,
+        0xB234B1,0xD4BBF9,0x7F2A21,0x19A569,0xAE456A,0xC8CA22,0x635BFA,0x05D4B2,
+        0x8AD707,0xEC584F,0x47C997,0x2146DF,0x96A6DC,0xF02994,0x5BB84C,0x3D3704,
+        0x207D05,0x46F24D,0xED6395,0x8BECDD,0x3C0CDE,0x5A8396,0xF1124E,0x979D06,
+        0x189EB3,0x7E11FB,0xD58023,0xB30F6B,0x04EF68,0x626020,0xC9F1F8,0xAF7EB0,
+        0x51BA69,0x373521,0x9CA4F9,0xFA2BB1,0x4DCBB2,0x2B44FA,0x80D522,0xE65A6A,
+        0x6959DF,0x0FD697,0xA4474F,0xC2C807,0x752804,0x13A74C,0xB83694,0xDEB9DC
+    },
+    { /* 2 zero bytes */
+        0x000000,0x8309D7,0x805F55,0x035682,0x86F251,0x05FB86,0x06AD04,0x85A4D3,
+        0x8BA859,0x08A18E,0x0BF70C,0x88FEDB,0x0D5A08,0x8E53DF,0x8D055D,0x0E0C8A,
+        0x911C49,0x12159E,0x11431C,0x924ACB,0x17EE18,0x94E7CF,0x97B14D,0x14B89A,
+        0x1AB410,0x99BDC7,0x9AEB45,0x19E292,0x9C4641,0x1F4F96,0x1C1914,0x9F10C3,
+        0xA47469,0x277DBE,0x242B3C,0xA722EB,0x228638,0xA18FEF,0xA2D96D,0x21D0BA,
+        0x2FDC30,0xACD5E7,0xAF8365,0x2C8AB2,0xA92E61,0x2A27B6,0x297134,0xAA78E3,
+        0x356820,0xB661F7,0xB53775,0x363EA2,0xB39A71,0x3093A6,0x33C524,0xB0CCF3,
+        0xBEC079,0x3DC9AE,0x3E9F2C,0xBD96FB,0x383228,0xBB3BFF,0xB86D7D,0x3B64AA,
+        0xCEA429,0x4DADFE,0x4EFB7C,0xCDF2AB,0x485678,0xCB5FAF,0xC8092D,0x4B00FA,
+        0x450C70,0xC605A7,0xC55325,0x465AF2,0xC3FE21,0x40F7F6,0x43A174,0xC0A8A3,
+        0x5FB860,0xDCB1B7,0xDFE735,0x5CEEE2,0xD94A31,0x5A43E6,0x591564,0xDA1CB3,
+        0xD41039,0x5719EE,0x544F6C,0xD746BB,0x52E268,0xD1EBBF,0xD2BD3D,0x51B4EA,
+        0x6AD040,0xE9D997,0xEA8F15,0x6986C2,0xEC2211,0x6F2BC6,0x6C7D44,0xEF7493,
+        0xE17819,0x6271CE,0x61274C,0xE22E9B,0x678A48,0xE4839F,0xE7D51D,0x64DCCA,
+        0xFBCC09,0x78C5DE,0x7B935C,0xF89A8B,0x7D3E58,0xFE378F,0xFD610D,0x7E68DA,
+        0x706450,0xF36D87,0xF03B05,0x7332D2,0xF69601,0x759FD6,0x76C954,0xF5C083,
+        0x1B04A9,0x980D7E,0x9B5BFC,0x18522B,0x9DF6F8,0x1EFF2F,0x1DA9AD,0x9EA07A,
+        0x90ACF0,0x13A527,0x10F3A5,0x93FA72,0x165EA1,0x955776,0x9601F4,0x150823,
+        0x8A18E0,0x091137,0x0A47B5,0x894E62,0x0CEAB1,0x8FE366,0x8CB5E4,0x0FBC33,
+        0x01B0B9,0x82B96E,0x81EFEC,0x02E63B,0x8742E8,0x044B3F,0x071DBD,0x84146A,
+        0xBF70C0,0x3C7917,0x3F2F95,0xBC2642,0x398291,0xBA8B46,0xB9DDC4,0x3AD413,
+        0x34D899,0xB7D14E,0xB487CC,0x378E1B,0xB22AC8,0x31231F,0x32759D,0xB17C4A,
+        0x2E6C89,0xAD655E,0xAE33DC,0x2D3A0B,0xA89ED8,0x2B970F,0x28C18D,0xABC85A,
+        0xA5C4D0,0x26CD07,0x259B85,0xA69252,0x233681,0xA03F56,0xA369D4,0x206003,
+        0xD5A080,0x56A957,0x55FFD5,0xD6F602,0x5352D1,0xD05B06,0xD30D84,0x500453,
+        0x5E08D9,0xDD010E,0xDE578C,0x5D5E5B,0xD8FA88,0x5BF35F,0x58A5DD,0xDBAC0A,
+        0x44BCC9,0xC7B51E,0xC4E39C,0x47EA4B,0xC24E98,0x41474F,0x4211CD,0xC1181A,
+        0xCF1490,0x4C1D47,0x4F4BC5,0xCC4212,0x49E6C1,0xCAEF16,0xC9B994,0x4AB043,
+        0x71D4E9,0xF2DD3E,0xF18BBC,0x72826B,0xF726B8,0x742F6F,0x7779ED,0xF4703A,
+        0xFA7CB0,0x797567,0x7A23E5,0xF92A32,0x7C8EE1,0xFF8736,0xFCD1B4,0x7FD863,
+        0xE0C8A0,0x63C177,0x6097F5,0xE39E22,0x663AF1,0xE53326,0xE665A4,0x656C73,
+        0x6B60F9,0xE8692E,0xEB3FAC,0x68367B,0xED92A8,0x6E9B7F,0x6DCDFD,0xEEC42A
+    },
+    { /* 3 zero bytes */
+        0x000000,0x360952,0x6C12A4,0x5A1BF6,0xD82548,0xEE2C1A,0xB437EC,0x823EBE,
+        0x36066B,0x000F39,0x5A14CF,0x6C1D9D,0xEE2323,0xD82A71,0x823187,0xB438D5,
+        0x6C0CD6,0x5A0584,0x001E72,0x361720,0xB4299E,0x8220CC,0xD83B3A,0xEE3268,
+        0x5A0ABD,0x6C03EF,0x361819,0x00114B,0x822FF5,0xB426A7,0xEE3D51,0xD83403,
+        0xD819AC,0xEE10FE,0xB40B08,0x82025A,0x003CE4,0x3635B6,0x6C2E40,0x5A2712,
+        0xEE1FC7,0xD81695,0x820D63,0xB40431,0x363A8F,0x0033DD,0x5A282B,0x6C2179,
+        0xB4157A,0x821C28,0xD807DE,0xEE0E8C,0x6C3032,0x5A3960,0x002296,0x362BC4,
+        0x821311,0xB41A43,0xEE01B5,0xD808E7,0x5A3659,0x6C3F0B,0x3624FD,0x002DAF,
+        0x367FA3,0x0076F1,0x5A6D07,0x6C6455,0xEE5AEB,0xD853B9,0x82484F,0xB4411D,
+        0x0079C8,0x36709A,0x6C6B6C,0x5A623E,0xD85C80,0xEE55D2,0xB44E24,0x824776,
+        0x5A7375,0x6C7A27,0x3661D1,0x006883,0x82563D,0xB45F6F,0xEE4499,0xD84DCB,
+        0x6C751E,0x5A7C4C,0x0067BA,0x366EE8,0xB45056,0x825904,0xD842F2,0xEE4BA0,
+        0xEE660F,0xD86F5D,0x8274AB,0xB47DF9,0x364347,0x004A15,0x5A51E3,0x6C58B1,
+        0xD86064,0xEE6936,0xB472C0,0x827B92,0x00452C,0x364C7E,0x6C5788,0x5A5EDA,
+        0x826AD9,0xB4638B,0xEE787D,0xD8712F,0x5A4F91,0x6C46C3,0x365D35,0x005467,
+        0xB46CB2,0x8265E0,0xD87E16,0xEE7744,0x6C49FA,0x5A40A8,0x005B5E,0x36520C,
+        0x6CFF46,0x5AF614,0x00EDE2,0x36E4B0,0xB4DA0E,0x82D35C,0xD8C8AA,0xEEC1F8,
+        0x5AF92D,0x6CF07F,0x36EB89,0x00E2DB,0x82DC65,0xB4D537,0xEECEC1,0xD8C793,
+        0x00F390,0x36FAC2,0x6CE134,0x5AE866,0xD8D6D8,0xEEDF8A,0xB4C47C,0x82CD2E,
+        0x36F5FB,0x00FCA9,0x5AE75F,0x6CEE0D,0xEED0B3,0xD8D9E1,0x82C217,0xB4CB45,
+        0xB4E6EA,0x82EFB8,0xD8F44E,0xEEFD1C,0x6CC3A2,0x5ACAF0,0x00D106,0x36D854,
+        0x82E081,0xB4E9D3,0xEEF225,0xD8FB77,0x5AC5C9,0x6CCC9B,0x36D76D,0x00DE3F,
+        0xD8EA3C,0xEEE36E,0xB4F898,0x82F1CA,0x00CF74,0x36C626,0x6CDDD0,0x5AD482,
+        0xEEEC57,0xD8E505,0x82FEF3,0xB4F7A1,0x36C91F,0x00C04D,0x5ADBBB,0x6CD2E9,
+        0x5A80E5,0x6C89B7,0x369241,0x009B13,0x82A5AD,0xB4ACFF,0xEEB709,0xD8BE5B,
+        0x6C868E,0x5A8FDC,0x00942A,0x369D78,0xB4A3C6,0x82AA94,0xD8B162,0xEEB830,
+        0x368C33,0x008561,0x5A9E97,0x6C97C5,0xEEA97B,0xD8A029,0x82BBDF,0xB4B28D,
+        0x008A58,0x36830A,0x6C98FC,0x5A91AE,0xD8AF10,0xEEA642,0xB4BDB4,0x82B4E6,
+        0x829949,0xB4901B,0xEE8BED,0xD882BF,0x5ABC01,0x6CB553,0x36AEA5,0x00A7F7,
+        0xB49F22,0x829670,0xD88D86,0xEE84D4,0x6CBA6A,0x5AB338,0x00A8CE,0x36A19C,
+        0xEE959F,0xD89CCD,0x82873B,0xB48E69,0x36B0D7,0x00B985,0x5AA273,0x6CAB21,
+        0xD893F4,0xEE9AA6,0xB48150,0x828802,0x00B6BC,0x36BFEE,0x6CA418,0x5AAD4A
+    },
+    { /* 4 zero bytes */
+        0x000000,0xD9FE8C,0x35B1E3,0xEC4F6F,0x6B63C6,0xB29D4A,0x5ED225,0x872CA9,
+        0xD6C78C,0x0F3900,0xE3766F,0x3A88E3,0xBDA44A,0x645AC6,0x8815A9,0x51EB25,
+        0x2BC3E3,0xF23D6F,0x1E7200,0xC78C8C,0x40A025,0x995EA9,0x7511C6,0xACEF4A,
+        0xFD046F,0x24FAE3,0xC8B58C,0x114B00,0x9667A9,0x4F9925,0xA3D64A,0x7A28C6,
+        0x5787C6,0x8E794A,0x623625,0xBBC8A9,0x3CE400,0xE51A8C,0x0955E3,0xD0AB6F,
+        0x81404A,0x58BEC6,0xB4F1A9,0x6D0F25,0xEA238C,0x33DD00,0xDF926F,0x066CE3,
+        0x7C4425,0xA5BAA9,0x49F5C6,0x900B4A,0x1727E3,0xCED96F,0x229600,0xFB688C,
+        0xAA83A9,0x737D25,0x9F324A,0x46CCC6,0xC1E06F,0x181EE3,0xF4518C,0x2DAF00,
+        0xAF0F8C,0x76F100,0x9ABE6F,0x4340E3,0xC46C4A,0x1D92C6,0xF1DDA9,0x282325,
+        0x79C800,0xA0368C,0x4C79E3,0x95876F,0x12ABC6,0xCB554A,0x271A25,0xFEE4A9,
+        0x84CC6F,0x5D32E3,0xB17D8C,0x688300,0xEFAFA9,0x365125,0xDA1E4A,0x03E0C6,
+        0x520BE3,0x8BF56F,0x67BA00,0xBE448C,0x396825,0xE096A9,0x0CD9C6,0xD5274A,
+        0xF8884A,0x2176C6,0xCD39A9,0x14C725,0x93EB8C,0x4A1500,0xA65A6F,0x7FA4E3,
+        0x2E4FC6,0xF7B14A,0x1BFE25,0xC200A9,0x452C00,0x9CD28C,0x709DE3,0xA9636F,
+        0xD34BA9,0x0AB525,0xE6FA4A,0x3F04C6,0xB8286F,0x61D6E3,0x8D998C,0x546700,
+        0x058C25,0xDC72A9,0x303DC6,0xE9C34A,0x6EEFE3,0xB7116F,0x5B5E00,0x82A08C,
+        0xD853E3,0x01AD6F,0xEDE200,0x341C8C,0xB33025,0x6ACEA9,0x8681C6,0x5F7F4A,
+        0x0E946F,0xD76AE3,0x3B258C,0xE2DB00,0x65F7A9,0xBC0925,0x50464A,0x89B8C6,
+        0xF39000,0x2A6E8C,0xC621E3,0x1FDF6F,0x98F3C6,0x410D4A,0xAD4225,0x74BCA9,
+        0x25578C,0xFCA900,0x10E66F,0xC918E3,0x4E344A,0x97CAC6,0x7B85A9,0xA27B25,
+        0x8FD425,0x562AA9,0xBA65C6,0x639B4A,0xE4B7E3,0x3D496F,0xD10600,0x08F88C,
+        0x5913A9,0x80ED25,0x6CA24A,0xB55CC6,0x32706F,0xEB8EE3,0x07C18C,0xDE3F00,
+        0xA417C6,0x7DE94A,0x91A625,0x4858A9,0xCF7400,0x168A8C,0xFAC5E3,0x233B6F,
+        0x72D04A,0xAB2EC6,0x4761A9,0x9E9F25,0x19B38C,0xC04D00,0x2C026F,0xF5FCE3,
+        0x775C6F,0xAEA2E3,0x42ED8C,0x9B1300,0x1C3FA9,0xC5C125,0x298E4A,0xF070C6,
+        0xA19BE3,0x78656F,0x942A00,0x4DD48C,0xCAF825,0x1306A9,0xFF49C6,0x26B74A,
+        0x5C9F8C,0x856100,0x692E6F,0xB0D0E3,0x37FC4A,0xEE02C6,0x024DA9,0xDBB325,
+        0x8A5800,0x53A68C,0xBFE9E3,0x66176F,0xE13BC6,0x38C54A,0xD48A25,0x0D74A9,
+        0x20DBA9,0xF92525,0x156A4A,0xCC94C6,0x4BB86F,0x9246E3,0x7E098C,0xA7F700,
+        0xF61C25,0x2FE2A9,0xC3ADC6,0x1A534A,0x9D7FE3,0x44816F,0xA8CE00,0x71308C,
+        0x0B184A,0xD2E6C6,0x3EA9A9,0xE75725,0x607B8C,0xB98500,0x55CA6F,0x8C34E3,
+        0xDDDFC6,0x04214A,0xE86E25,0x3190A9,0xB6BC00,0x6F428C,0x830DE3,0x5AF36F
+    },
+    { /* 5 zero bytes */
+        0x000000,0x36EB3D,0x6DD67A,0x5B3D47,0xDBACF4,0xED47C9,0xB67A8E,0x8091B3,
+        0x311513,0x07FE2E,0x5CC369,0x6A2854,0xEAB9E7,0xDC52DA,0x876F9D,0xB184A0,
+        0x622A26,0x54C11B,0x0FFC5C,0x391761,0xB986D2,0x8F6DEF,0xD450A8,0xE2BB95,
+        0x533F35,0x65D408,0x3EE94F,0x080272,0x8893C1,0xBE78FC,0xE545BB,0xD3AE86,
+        0xC4544C,0xF2BF71,0xA98236,0x9F690B,0x1FF8B8,0x291385,0x722EC2,0x44C5FF,
+        0xF5415F,0xC3AA62,0x989725,0xAE7C18,0x2EEDAB,0x180696,0x433BD1,0x75D0EC,
+        0xA67E6A,0x909557,0xCBA810,0xFD432D,0x7DD29E,0x4B39A3,0x1004E4,0x26EFD9,
+        0x976B79,0xA18044,0xFABD03,0xCC563E,0x4CC78D,0x7A2CB0,0x2111F7,0x17FACA,
+        0x0EE463,0x380F5E,0x633219,0x55D924,0xD54897,0xE3A3AA,0xB89EED,0x8E75D0,
+        0x3FF170,0x091A4D,0x52270A,0x64CC37,0xE45D84,0xD2B6B9,0x898BFE,0xBF60C3,
+        0x6CCE45,0x5A2578,0x01183F,0x37F302,0xB762B1,0x81898C,0xDAB4CB,0xEC5FF6,
+        0x5DDB56,0x6B306B,0x300D2C,0x06E611,0x8677A2,0xB09C9F,0xEBA1D8,0xDD4AE5,
+        0xCAB02F,0xFC5B12,0xA76655,0x918D68,0x111CDB,0x27F7E6,0x7CCAA1,0x4A219C,
+        0xFBA53C,0xCD4E01,0x967346,0xA0987B,0x2009C8,0x16E2F5,0x4DDFB2,0x7B348F,
+        0xA89A09,0x9E7134,0xC54C73,0xF3A74E,0x7336FD,0x45DDC0,0x1EE087,0x280BBA,
+        0x998F1A,0xAF6427,0xF45960,0xC2B25D,0x4223EE,0x74C8D3,0x2FF594,0x191EA9,
+        0x1DC8C6,0x2B23FB,0x701EBC,0x46F581,0xC66432,0xF08F0F,0xABB248,0x9D5975,
+        0x2CDDD5,0x1A36E8,0x410BAF,0x77E092,0xF77121,0xC19A1C,0x9AA75B,0xAC4C66,
+        0x7FE2E0,0x4909DD,0x12349A,0x24DFA7,0xA44E14,0x92A529,0xC9986E,0xFF7353,
+        0x4EF7F3,0x781CCE,0x232189,0x15CAB4,0x955B07,0xA3B03A,0xF88D7D,0xCE6640,
+        0xD99C8A,0xEF77B7,0xB44AF0,0x82A1CD,0x02307E,0x34DB43,0x6FE604,0x590D39,
+        0xE88999,0xDE62A4,0x855FE3,0xB3B4DE,0x33256D,0x05CE50,0x5EF317,0x68182A,
+        0xBBB6AC,0x8D5D91,0xD660D6,0xE08BEB,0x601A58,0x56F165,0x0DCC22,0x3B271F,
+        0x8AA3BF,0xBC4882,0xE775C5,0xD19EF8,0x510F4B,0x67E476,0x3CD931,0x0A320C,
+        0x132CA5,0x25C798,0x7EFADF,0x4811E2,0xC88051,0xFE6B6C,0xA5562B,0x93BD16,
+        0x2239B6,0x14D28B,0x4FEFCC,0x7904F1,0xF99542,0xCF7E7F,0x944338,0xA2A805,
+        0x710683,0x47EDBE,0x1CD0F9,0x2A3BC4,0xAAAA77,0x9C414A,0xC77C0D,0xF19730,
+        0x401390,0x76F8AD,0x2DC5EA,0x1B2ED7,0x9BBF64,0xAD5459,0xF6691E,0xC08223,
+        0xD778E9,0xE193D4,0xBAAE93,0x8C45AE,0x0CD41D,0x3A3F20,0x610267,0x57E95A,
+        0xE66DFA,0xD086C7,0x8BBB80,0xBD50BD,0x3DC10E,0x0B2A33,0x501774,0x66FC49,
+        0xB552CF,0x83B9F2,0xD884B5,0xEE6F88,0x6EFE3B,0x581506,0x032841,0x35C37C,
+        0x8447DC,0xB2ACE1,0xE991A6,0xDF7A9B,0x5FEB28,0x690015,0x323D52,0x04D66F
+    },
+    { /* 6 zero bytes */
+        0x000000,0x3B918C,0x772318,0x4CB294,0xEE4630,0xD5D7BC,0x996528,0xA2F4A4,
+        0x5AC09B,0x615117,0x2DE383,0x16720F,0xB486AB,0x8F1727,0xC3A5B3,0xF8343F,
+        0xB58136,0x8E10BA,0xC2A22E,0xF933A2,0x5BC706,0x60568A,0x2CE41E,0x177592,
+        0xEF41AD,0xD4D021,0x9862B5,0xA3F339,0x01079D,0x3A9611,0x762485,0x4DB509,
+        0xED4E97,0xD6DF1B,0x9A6D8F,0xA1FC03,0x0308A7,0x38992B,0x742BBF,0x4FBA33,
+        0xB78E0C,0x8C1F80,0xC0AD14,0xFB3C98,0x59C83C,0x6259B0,0x2EEB24,0x157AA8,
+        0x58CFA1,0x635E2D,0x2FECB9,0x147D35,0xB68991,0x8D181D,0xC1AA89,0xFA3B05,
+        0x020F3A,0x399EB6,0x752C22,0x4EBDAE,0xEC490A,0xD7D886,0x9B6A12,0xA0FB9E,
+        0x5CD1D5,0x674059,0x2BF2CD,0x106341,0xB297E5,0x890669,0xC5B4FD,0xFE2571,
+        0x06114E,0x3D80C2,0x713256,0x4AA3DA,0xE8577E,0xD3C6F2,0x9F7466,0xA4E5EA,
+        0xE950E3,0xD2C16F,0x9E73FB,0xA5E277,0x0716D3,0x3C875F,0x7035CB,0x4BA447,
+        0xB39078,0x8801F4,0xC4B360,0xFF22EC,0x5DD648,0x6647C4,0x2AF550,0x1164DC,
+        0xB19F42,0x8A0ECE,0xC6BC5A,0xFD2DD6,0x5FD972,0x6448FE,0x28FA6A,0x136BE6,
+        0xEB5FD9,0xD0CE55,0x9C7CC1,0xA7ED4D,0x0519E9,0x3E8865,0x723AF1,0x49AB7D,
+        0x041E74,0x3F8FF8,0x733D6C,0x48ACE0,0xEA5844,0xD1C9C8,0x9D7B5C,0xA6EAD0,
+        0x5EDEEF,0x654F63,0x29FDF7,0x126C7B,0xB098DF,0x8B0953,0xC7BBC7,0xFC2A4B,
+        0xB9A3AA,0x823226,0xCE80B2,0xF5113E,0x57E59A,0x6C7416,0x20C682,0x1B570E,
+        0xE36331,0xD8F2BD,0x944029,0xAFD1A5,0x0D2501,0x36B48D,0x7A0619,0x419795,
+        0x0C229C,0x37B310,0x7B0184,0x409008,0xE264AC,0xD9F520,0x9547B4,0xAED638,
+        0x56E207,0x6D738B,0x21C11F,0x1A5093,0xB8A437,0x8335BB,0xCF872F,0xF416A3,
+        0x54ED3D,0x6F7CB1,0x23CE25,0x185FA9,0xBAAB0D,0x813A81,0xCD8815,0xF61999,
+        0x0E2DA6,0x35BC2A,0x790EBE,0x429F32,0xE06B96,0xDBFA1A,0x97488E,0xACD902,
+        0xE16C0B,0xDAFD87,0x964F13,0xADDE9F,0x0F2A3B,0x34BBB7,0x780923,0x4398AF,
+        0xBBAC90,0x803D1C,0xCC8F88,0xF71E04,0x55EAA0,0x6E7B2C,0x22C9B8,0x195834,
+        0xE5727F,0xDEE3F3,0x925167,0xA9C0EB,0x0B344F,0x30A5C3,0x7C1757,0x4786DB,
+        0xBFB2E4,0x842368,0xC891FC,0xF30070,0x51F4D4,0x6A6558,0x26D7CC,0x1D4640,
+        0x50F349,0x6B62C5,0x27D051,0x1C41DD,0xBEB579,0x8524F5,0xC99661,0xF207ED,
+        0x0A33D2,0x31A25E,0x7D10CA,0x468146,0xE475E2,0xDFE46E,0x9356FA,0xA8C776,
+        0x083CE8,0x33AD64,0x7F1FF0,0x448E7C,0xE67AD8,0xDDEB54,0x9159C0,0xAAC84C,
+        0x52FC73,0x696DFF,0x25DF6B,0x1E4EE7,0xBCBA43,0x872BCF,0xCB995B,0xF008D7,
+        0xBDBDDE,0x862C52,0xCA9EC6,0xF10F4A,0x53FBEE,0x686A62,0x24D8F6,0x1F497A,
+        0xE77D45,0xDCECC9,0x905E5D,0xABCFD1,0x093B75,0x32AAF9,0x7E186D,0x4589E1
+    },
+    { /* 7 zero bytes */
+        0x000000,0xF50BAF,0x6C5BA5,0x99500A,0xD8B74A,0x2DBCE5,0xB4ECEF,0x41E740,
+        0x37226F,0xC229C0,0x5B79CA,0xAE7265,0xEF9525,0x1A9E8A,0x83CE80,0x76C52F,
+        0x6E44DE,0x9B4F71,0x021F7B,0xF714D4,0xB6F394,0x43F83B,0xDAA831,0x2FA39E,
+        0x5966B1,0xAC6D1E,0x353D14,0xC036BB,0x81D1FB,0x74DA54,0xED8A5E,0x1881F1,
+        0xDC89BC,0x298213,0xB0D219,0x45D9B6,0x043EF6,0xF13559,0x686553,0x9D6EFC,
+        0xEBABD3,0x1EA07C,0x87F076,0x72FBD9,0x331C99,0xC61736,0x5F473C,0xAA4C93,
+        0xB2CD62,0x47C6CD,0xDE96C7,0x2B9D68,0x6A7A28,0x9F7187,0x06218D,0xF32A22,
+        0x85EF0D,0x70E4A2,0xE9B4A8,0x1CBF07,0x5D5847,0xA853E8,0x3103E2,0xC4084D,
+        0x3F5F83,0xCA542C,0x530426,0xA60F89,0xE7E8C9,0x12E366,0x8BB36C,0x7EB8C3,
+        0x087DEC,0xFD7643,0x642649,0x912DE6,0xD0CAA6,0x25C109,0xBC9103,0x499AAC,
+        0x511B5D,0xA410F2,0x3D40F8,0xC84B57,0x89AC17,0x7CA7B8,0xE5F7B2,0x10FC1D,
+        0x663932,0x93329D,0x0A6297,0xFF6938,0xBE8E78,0x4B85D7,0xD2D5DD,0x27DE72,
+        0xE3D63F,0x16DD90,0x8F8D9A,0x7A8635,0x3B6175,0xCE6ADA,0x573AD0,0xA2317F,
+        0xD4F450,0x21FFFF,0xB8AFF5,0x4DA45A,0x0C431A,0xF948B5,0x6018BF,0x951310,
+        0x8D92E1,0x78994E,0xE1C944,0x14C2EB,0x5525AB,0xA02E04,0x397E0E,0xCC75A1,
+        0xBAB08E,0x4FBB21,0xD6EB2B,0x23E084,0x6207C4,0x970C6B,0x0E5C61,0xFB57CE,
+        0x7EBF06,0x8BB4A9,0x12E4A3,0xE7EF0C,0xA6084C,0x5303E3,0xCA53E9,0x3F5846,
+        0x499D69,0xBC96C6,0x25C6CC,0xD0CD63,0x912A23,0x64218C,0xFD7186,0x087A29,
+        0x10FBD8,0xE5F077,0x7CA07D,0x89ABD2,0xC84C92,0x3D473D,0xA41737,0x511C98,
+        0x27D9B7,0xD2D218,0x4B8212,0xBE89BD,0xFF6EFD,0x0A6552,0x933558,0x663EF7,
+        0xA236BA,0x573D15,0xCE6D1F,0x3B66B0,0x7A81F0,0x8F8A5F,0x16DA55,0xE3D1FA,
+        0x9514D5,0x601F7A,0xF94F70,0x0C44DF,0x4DA39F,0xB8A830,0x21F83A,0xD4F395,
+        0xCC7264,0x3979CB,0xA029C1,0x55226E,0x14C52E,0xE1CE81,0x789E8B,0x8D9524,
+        0xFB500B,0x0E5BA4,0x970BAE,0x620001,0x23E741,0xD6ECEE,0x4FBCE4,0xBAB74B,
+        0x41E085,0xB4EB2A,0x2DBB20,0xD8B08F,0x9957CF,0x6C5C60,0xF50C6A,0x0007C5,
+        0x76C2EA,0x83C945,0x1A994F,0xEF92E0,0xAE75A0,0x5B7E0F,0xC22E05,0x3725AA,
+        0x2FA45B,0xDAAFF4,0x43FFFE,0xB6F451,0xF71311,0x0218BE,0x9B48B4,0x6E431B,
+        0x188634,0xED8D9B,0x74DD91,0x81D63E,0xC0317E,0x353AD1,0xAC6ADB,0x596174,
+        0x9D6939,0x686296,0xF1329C,0x043933,0x45DE73,0xB0D5DC,0x2985D6,0xDC8E79,
+        0xAA4B56,0x5F40F9,0xC610F3,0x331B5C,0x72FC1C,0x87F7B3,0x1EA7B9,0xEBAC16,
+        0xF32DE7,0x062648,0x9F7642,0x6A7DED,0x2B9AAD,0xDE9102,0x47C108,0xB2CAA7,
+        0xC40F88,0x310427,0xA8542D,0x5D5F82,0x1CB8C2,0xE9B36D,0x70E367,0x85E8C8
+    }
+};
 const double ura_value[]={              /* ura max values */
     2.4,3.4,4.85,6.85,9.65,13.65,24.0,48.0,96.0,192.0,384.0,768.0,1536.0,
     3072.0,6144.0
@@ -632,6 +894,7 @@ extern void setcodepri(int sys, int freq, const char *pri)
     if (sys&SYS_SBS) strcpy(codepris[4][freq-1],pri);
     if (sys&SYS_CMP) strcpy(codepris[5][freq-1],pri);
     if (sys&SYS_IRN) strcpy(codepris[6][freq-1],pri);
+    codepri_stamp++;
 }
 /* get code priority -----------------------------------------------------------
 * get code priority for multiple codes in a frequency
@@ -657,6 +920,7 @@ extern int getcodepri(int sys, unsigned char code, const char *opt)
         default: return 0;
     }
     obs=code2obs(code,&j);
+    if (j<1||MAXFREQ<j) return 0;
     
     /* parse code options */
     for (p=opt;p&&(p=strchr(p,'-'));p++) {
@@ -666,6 +930,56 @@ extern int getcodepri(int sys, unsigned char code, const char *opt)
     /* search code priority */
     return (p=strchr(codepris[i][j-1],obs[1]))?14-(int)(p-codepris[i][j-1]):0;
 }
+/* update code priority table --------------------------------------------------
+* compile code priorities for code options into code priority table. the table
+* is compiled only if the options or the code priority settings are changed
+* args   : codepri_t *tbl IO    code priority table
+*          char   *opt    I     code options (NULL:no option)
+* return : none
+* notes  : call it once before a series of tblcodepri() for a message
+*-----------------------------------------------------------------------------*/
+extern void updcodepri(codepri_t *tbl, const char *opt)
+{
+    const int sys[]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN};
+    int i,j;
+    
+    if (!opt) opt="";
+    if (tbl->stamp==codepri_stamp&&!strcmp(tbl->opt,opt)) return;
+    
+    trace(3,"updcodepri: opt=%s\n",opt);
+    
+    for (i=0;i<7;i++) {
+        tbl->pri[i][CODE_NONE]=0;
+        for (j=1;j<=MAXCODE;j++) {
+            tbl->pri[i][j]=(unsigned char)getcodepri(sys[i],(unsigned char)j,opt);
+        }
+    }
+    strncpy(tbl->opt,opt,sizeof(tbl->opt)-1);
+    tbl->opt[sizeof(tbl->opt)-1]='\0';
+    tbl->stamp=strcmp(tbl->opt,opt)?0:codepri_stamp;
+}
+/* get code priority by code priority table ------------------------------------
+* get code priority in code priority table compiled by updcodepri()
+* args   : codepri_t *tbl I     code priority table
+*          int    sys     I     system (SYS_???)
+*          unsigned char code I obs code (CODE_???)
+* return : priority (15:highest-1:lowest,0:error)
+*-----------------------------------------------------------------------------*/
+extern int tblcodepri(const codepri_t *tbl, int sys, unsigned char code)
+{
+    if (code>MAXCODE) return 0;
+    
+    switch (sys) {
+        case SYS_GPS: return tbl->pri[0][code];
+        case SYS_GLO: return tbl->pri[1][code];
+        case SYS_GAL: return tbl->pri[2][code];
+        case SYS_QZS: return tbl->pri[3][code];
+        case SYS_SBS: return tbl->pri[4][code];
+        case SYS_CMP: return tbl->pri[5][code];
+        case SYS_IRN: return tbl->pri[6][code];
+    }
+    return 0;
+}
 /* extract unsigned/signed bits ------------------------------------------------
 * extract unsigned/signed bits from byte data
 * args   : unsigned char *buff I byte data
@@ -736,15 +1050,24 @@ extern unsigned int rtk_crc32(const unsigned char *buff, int len)
 *          int    len    I      data length (bytes)
 * return : crc-24Q parity
 * notes  : see reference [2] A.4.3.3 Parity
+*          8 bytes are processed at once by slicing-by-8. tbl_CRC24Q8[k-1][i]
+*          is crc of byte i followed by k zero bytes.
 *-----------------------------------------------------------------------------*/
 extern unsigned int rtk_crc24q(const unsigned char *buff, int len)
 {
+    const unsigned char *p=buff;
     unsigned int crc=0;
     int i;
     
     trace(4,"rtk_crc24q: len=%d\n",len);
     
-    for (i=0;i<len;i++) crc=((crc<<8)&0xFFFFFF)^tbl_CRC24Q[(crc>>16)^buff[i]];
+    for (i=0;i+8<=len;i+=8,p+=8) {
+        crc=tbl_CRC24Q8[6][p[0]^(crc>>16)]^tbl_CRC24Q8[5][p[1]^((crc>>8)&0xFF)]^
+            tbl_CRC24Q8[4][p[2]^(crc&0xFF)]^tbl_CRC24Q8[3][p[3]]^
+            tbl_CRC24Q8[2][p[4]]^tbl_CRC24Q8[1][p[5]]^tbl_CRC24Q8[0][p[6]]^
+            tbl_CRC24Q[p[7]];
+    }
+    for (;i<len;i++,p++) crc=((crc<<8)&0xFFFFFF)^tbl_CRC24Q[(crc>>16)^*p];
     return crc;
 }
 /* crc-16 parity ---------------------------------------------------------------
@@ -1228,21 +1551,156 @@ extern void matprint(const double A[], int n, int m, int p, int q)
 {
     matfprint(A,n,m,p,q,stdout);
 }
+/* decimal number in fixed-width field ---------------------------------------*/
+static int decnum(const char *s, const char *e, int dexp, double *value)
+{
+    static const double p10[]={
+        1E0,1E1,1E2,1E3,1E4,1E5,1E6,1E7,1E8,1E9,1E10,1E11,1E12,1E13,1E14,1E15,
+        1E16,1E17,1E18,1E19,1E20,1E21,1E22
+    };
+    const char *p=s,*q;
+    double m=0.0;
+    int neg=0,nd=0,ex=0,x=0,xneg=0;
+    char str[256],*r=str,*end;
+    
+    while (p<e&&(*p==' '||('\t'<=*p&&*p<='\r'))) p++;
+    
+    if (p<e&&(*p=='+'||*p=='-')) neg=*p++=='-';
+    
+    for (;p<e&&'0'<=*p&&*p<='9';p++,nd++) {
+        if (m==0.0&&*p=='0') continue;
+        if (m>MAXDECM) goto slow;
+        m=m*10.0+(*p-'0');
+    }
+    if (p<e&&*p=='.') {
+        for (p++;p<e&&'0'<=*p&&*p<='9';p++,nd++,ex--) {
+            if (m==0.0&&*p=='0') continue;
+            if (m>MAXDECM) goto slow;
+            m=m*10.0+(*p-'0');
+        }
+    }
+    if (!nd||(p<e&&(*p=='x'||*p=='X'))) goto slow; /* inf, nan or hex */
+    
+    if (p<e&&(*p=='e'||*p=='E'||(dexp&&(*p=='d'||*p=='D')))) {
+        q=p+1;
+        if (q<e&&(*q=='+'||*q=='-')) xneg=*q++=='-';
+        if (q<e&&'0'<=*q&&*q<='9') {
+            for (;q<e&&'0'<=*q&&*q<='9';q++) if (x<10000) x=x*10+(*q-'0');
+            ex+=xneg?-x:x;
+            p=q;
+        }
+    }
+    if (m==0.0) {
+        *value=neg?-0.0:0.0;
+        return (int)(p-s);
+    }
+    /* mantissa and power of 10 are exact in double */
+    if (-22<=ex&&ex<=22) {
+        *value=ex<0?m/p10[-ex]:m*p10[ex];
+        if (neg) *value=-*value;
+        return (int)(p-s);
+    }
+slow:
+    for (p=s;p<e&&*p&&r<str+sizeof(str)-1;p++) {
+        *r++=dexp&&(*p=='d'||*p=='D')?'E':*p;
+    }
+    *r='\0';
+    *value=strtod(str,&end);
+    return (int)(end-str);
+}
+/* string to decimal number ----------------------------------------------------
+* convert decimal number at head of string without sscanf()
+* args   : char   *s        I   string ("  nnn.nnnE+nn ...")
+*          int    n         I   max length of number field
+*          double *value    O   converted number (0.0: no number)
+* return : number of characters converted (0: no number)
+* notes  : the field ends at n characters or at the null terminator. the result
+*          is identical to strtod(): numbers whose integer mantissa (<=2^53) and
+*          power of 10 (<=1E22) are exact in double are converted by one
+*          correctly rounded operation independent of locale, others by
+*          strtod().
+*-----------------------------------------------------------------------------*/
+extern int str2dec(const char *s, int n, double *value)
+{
+    int k;
+    
+    if (n<=0||!(k=decnum(s,s+n,0,value))) {
+        *value=0.0;
+        return 0;
+    }
+    return k;
+}
+/* initialize line buffer ------------------------------------------------------
+* initialize line buffer to read text lines from file by blocks
+* args   : lnbuf_t *lb      O   line buffer
+*          FILE   *fp       I   file pointer
+*          int    nmax      I   buffer size (bytes)
+* return : status (1:ok,0:memory allocation error)
+*-----------------------------------------------------------------------------*/
+extern int initlnbuf(lnbuf_t *lb, FILE *fp, int nmax)
+{
+    lb->fp=fp;
+    lb->nmax=nmax;
+    lb->n=lb->p=lb->eof=0;
+    if (!(lb->buff=(char *)malloc(nmax+1))) {
+        lb->nmax=0;
+        return 0;
+    }
+    return 1;
+}
+/* free line buffer ----------------------------------------------------------*/
+extern void freelnbuf(lnbuf_t *lb)
+{
+    free(lb->buff); lb->buff=NULL;
+    lb->nmax=lb->n=lb->p=0;
+}
+/* read line from line buffer --------------------------------------------------
+* read a text line from line buffer
+* args   : lnbuf_t *lb      IO  line buffer
+* return : line without new-line (NULL: end of file)
+* notes  : the line is valid until the next call. lines longer than the buffer
+*          are returned in pieces as fgets() does.
+*-----------------------------------------------------------------------------*/
+extern char *getlnbuf(lnbuf_t *lb)
+{
+    char *p,*q;
+    int n;
+    
+    for (;;) {
+        p=lb->buff+lb->p;
+        if ((q=(char *)memchr(p,'\n',lb->n-lb->p))) {
+            *q='\0';
+            lb->p=(int)(q-lb->buff)+1;
+            return p;
+        }
+        if (lb->eof||lb->n-lb->p>=lb->nmax) {
+            if (lb->p>=lb->n) return NULL;
+            lb->buff[lb->n]='\0';
+            lb->p=lb->n;
+            return p;
+        }
+        /* move rest of data to buffer head and read next block */
+        n=lb->n-lb->p;
+        memmove(lb->buff,p,n);
+        lb->n=n; lb->p=0;
+        n=(int)fread(lb->buff+lb->n,1,lb->nmax-lb->n,lb->fp);
+        if (n<=0) lb->eof=1; else lb->n+=n;
+    }
+}
 /* string to number ------------------------------------------------------------
 * convert substring in string to number
 * args   : char   *s        I   string ("... nnn.nnn ...")
 *          int    i,n       I   substring position and width
 * return : converted number (0.0:error)
+* notes  : 'd' or 'D' is accepted as exponent. the result is identical to
+*          sscanf("%lf") on the substring.
 *-----------------------------------------------------------------------------*/
 extern double str2num(const char *s, int i, int n)
 {
     double value;
-    char str[256],*p=str;
     
-    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<n) return 0.0;
-    for (s+=i;*s&&--n>=0;s++) *p++=*s=='d'||*s=='D'?'E':*s;
-    *p='\0';
-    return sscanf(str,"%lf",&value)==1?value:0.0;
+    if (i<0||255<n||memchr(s,'\0',i)) return 0.0;
+    return n>0&&decnum(s+i,s+i+n,1,&value)?value:0.0;
 }
 /* string to time --------------------------------------------------------------
 * convert substring in string to gtime_t struct
@@ -1253,14 +1711,16 @@ extern double str2num(const char *s, int i, int n)
 *-----------------------------------------------------------------------------*/
 extern int str2time(const char *s, int i, int n, gtime_t *t)
 {
+    const char *p,*e;
     double ep[6];
-    char str[256],*p=str;
+    int j,k;
     
-    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<i) return -1;
-    for (s+=i;*s&&--n>=0;) *p++=*s++;
-    *p='\0';
-    if (sscanf(str,"%lf %lf %lf %lf %lf %lf",ep,ep+1,ep+2,ep+3,ep+4,ep+5)<6)
-        return -1;
+    if (i<0||255<i||memchr(s,'\0',i)) return -1;
+    p=s+i; e=p+(n<255?n:255);
+    
+    for (j=0;j<6;j++,p+=k) {
+        if (p>=e||!(k=decnum(p,e,0,ep+j))) return -1;
+    }
     if (ep[0]<100.0) ep[0]+=ep[0]<80.0?2000.0:1900.0;
     *t=epoch2time(ep);
     return 0;
@@ -1707,6 +2167,36 @@ extern unsigned int tickget(void)
 #endif
 #endif /* WIN32 */
 }
+/* get tick time in us ---------------------------------------------------------
+* get current tick in us
+* args   : none
+* return : current tick in us
+* notes  : the tick wraps around in about 71 min. use the difference of ticks
+*          as unsigned int to measure time intervals.
+*-----------------------------------------------------------------------------*/
+extern unsigned int tickgetus(void)
+{
+#ifdef WIN32
+    LARGE_INTEGER freq,count;
+    
+    if (!QueryPerformanceFrequency(&freq)||!QueryPerformanceCounter(&count)) {
+        return (unsigned int)timeGetTime()*1000u;
+    }
+    return (unsigned int)(count.QuadPart/freq.QuadPart*1000000+
+                          count.QuadPart%freq.QuadPart*1000000/freq.QuadPart);
+#else
+    struct timespec tp={0};
+    struct timeval  tv={0};
+    
+#ifdef CLOCK_MONOTONIC_RAW
+    if (!clock_gettime(CLOCK_MONOTONIC_RAW,&tp)) {
+        return tp.tv_sec*1000000u+tp.tv_nsec/1000u;
+    }
+#endif
+    gettimeofday(&tv,NULL);
+    return tv.tv_sec*1000000u+tv.tv_usec;
+#endif /* WIN32 */
+}
 /* sleep ms --------------------------------------------------------------------
 * sleep ms
 * args   : int   ms         I   miliseconds to sleep (<0:no sleep)
@@ -1724,6 +2214,81 @@ extern void sleepms(int ms)
     nanosleep(&ts,NULL);
 #endif
 }
+/* set thread options ----------------------------------------------------------
+* set name, cpu affinity and scheduling policy of the calling thread
+* args   : thrdopt_t *opt   I   thread options
+* return : status (1:ok,0:error)
+* notes  : real-time policies (THRDPOL_FIFO,THRDPOL_RR) need the privilege
+*          (root or CAP_SYS_NICE on linux). if not permitted, the thread runs
+*          with the normal policy. the thread name is set only on linux.
+*          on windows, the real-time policies are mapped to the thread
+*          priority highest (prio<50) or time-critical (prio>=50).
+*-----------------------------------------------------------------------------*/
+extern int setthrdopt(const thrdopt_t *opt)
+{
+#ifdef WIN32
+    int stat=1,prio;
+    
+    tracet(3,"setthrdopt: name=%s cpu=%d policy=%d prio=%d\n",opt->name,
+           opt->cpu,opt->policy,opt->prio);
+    
+    if (opt->cpu>=0&&opt->cpu<(int)sizeof(DWORD_PTR)*8) {
+        if (!SetThreadAffinityMask(GetCurrentThread(),(DWORD_PTR)1<<opt->cpu)) {
+            tracet(2,"setthrdopt: affinity error name=%s cpu=%d\n",opt->name,
+                   opt->cpu);
+            stat=0;
+        }
+    }
+    if (opt->policy!=THRDPOL_OTHER) {
+        prio=opt->prio<50?THREAD_PRIORITY_HIGHEST:THREAD_PRIORITY_TIME_CRITICAL;
+        if (!SetThreadPriority(GetCurrentThread(),prio)) {
+            tracet(2,"setthrdopt: priority error name=%s prio=%d\n",opt->name,
+                   opt->prio);
+            stat=0;
+        }
+    }
+    return stat;
+#else
+    struct sched_param param={0};
+    int stat=1,policy,err;
+#ifdef __linux__
+    cpu_set_t cpus;
+#endif
+    
+    tracet(3,"setthrdopt: name=%s cpu=%d policy=%d prio=%d\n",opt->name,
+           opt->cpu,opt->policy,opt->prio);
+    
+#ifdef __linux__
+    if (*opt->name) pthread_setname_np(pthread_self(),opt->name);
+    
+    if (opt->cpu>=0&&opt->cpu<CPU_SETSIZE) {
+        CPU_ZERO(&cpus);
+        CPU_SET(opt->cpu,&cpus);
+        if ((err=pthread_setaffinity_np(pthread_self(),sizeof(cpus),&cpus))) {
+            tracet(2,"setthrdopt: affinity error name=%s cpu=%d err=%d\n",
+                   opt->name,opt->cpu,err);
+            stat=0;
+        }
+    }
+#endif
+    if (opt->policy!=THRDPOL_OTHER) {
+        policy=opt->policy==THRDPOL_RR?SCHED_RR:SCHED_FIFO;
+        param.sched_priority=opt->prio;
+        if (param.sched_priority<sched_get_priority_min(policy)) {
+            param.sched_priority=sched_get_priority_min(policy);
+        }
+        if (param.sched_priority>sched_get_priority_max(policy)) {
+            param.sched_priority=sched_get_priority_max(policy);
+        }
+        if ((err=pthread_setschedparam(pthread_self(),policy,&param))) {
+            tracet(2,"setthrdopt: policy error name=%s policy=%d prio=%d "
+                   "err=%d\n",opt->name,opt->policy,opt->prio,err);
+            stat=0;
+        }
+    }
+    return stat;
+#endif /* WIN32 */
+}
 /* convert degree to deg-min-sec -----------------------------------------------
 * convert degree to degree-minute-second
 * args   : double deg       I   degree
@@ -2245,6 +2810,99 @@ static int readantex(const char *file, pcvs_t *pcvs)
     
     return 1;
 }
+/* normalize antenna type to "antenna radome" and "antenna" ------------------*/
+static int normtype(const char *type, char *full, char *ant)
+{
+    const char *p=type;
+    char *q=full;
+    int n;
+    
+    *full=*ant='\0';
+    for (n=0;n<2;n++) {
+        while (*p==' '||*p=='\t'||*p=='\r'||*p=='\n') p++;
+        if (!*p) break;
+        if (n>0) *q++=' ';
+        while (*p&&*p!=' '&&*p!='\t'&&*p!='\r'&&*p!='\n'&&q<full+MAXANT-1) {
+            *q++=*p++;
+        }
+        *q='\0';
+        if (n==0) strcpy(ant,full);
+    }
+    return n;
+}
+/* hash of antenna type (fnv-1a) ---------------------------------------------*/
+static unsigned int hashtype(const char *key)
+{
+    unsigned int h=2166136261u;
+    
+    for (;*key;key++) h=(h^(unsigned char)*key)*16777619u;
+    return h;
+}
+/* search slot of receiver antenna type in hash table -----------------------*/
+static int *hashslot(const pcvs_t *pcvs, const char *key)
+{
+    const pcvidx_t *idx=pcvs->idx;
+    char full[MAXANT],ant[MAXANT];
+    unsigned int i=hashtype(key)&(idx->nhash-1);
+    int *slot;
+    
+    for (;;i=(i+1)&(idx->nhash-1)) {
+        slot=idx->hash+i;
+        if (*slot<0) return slot;
+        normtype(pcvs->pcv[*slot/2].type,full,ant);
+        if (!strcmp(*slot%2?ant:full,key)) return slot;
+    }
+}
+/* free antenna parameters index ---------------------------------------------*/
+static void freepcvidx(pcvs_t *pcvs)
+{
+    if (!pcvs->idx) return;
+    free(pcvs->idx->ent);
+    free(pcvs->idx->hash);
+    free(pcvs->idx); pcvs->idx=NULL;
+}
+/* index antenna parameters --------------------------------------------------*/
+static void indexpcv(pcvs_t *pcvs)
+{
+    pcvidx_t *idx;
+    char full[MAXANT],ant[MAXANT];
+    int i,n,*slot;
+    
+    freepcvidx(pcvs);
+    
+    if (!(idx=(pcvidx_t *)calloc(1,sizeof(pcvidx_t)))) return;
+    for (n=1;n<pcvs->n*4;n*=2) ;
+    idx->n=pcvs->n;
+    idx->nhash=n;
+    if (!(idx->ent =(int *)malloc(sizeof(int)*(pcvs->n>0?pcvs->n:1)))||
+        !(idx->hash=(int *)malloc(sizeof(int)*n))) {
+        trace(1,"indexpcv: memory allocation error\n");
+        free(idx->ent); free(idx->hash); free(idx);
+        return;
+    }
+    pcvs->idx=idx;
+    
+    /* satellite antennas grouped by satellite in file order */
+    for (i=0;i<pcvs->n;i++) {
+        if (pcvs->pcv[i].sat>0&&pcvs->pcv[i].sat<=MAXSAT) {
+            idx->sat[pcvs->pcv[i].sat-1]++;
+        }
+    }
+    for (i=0;i<MAXSAT;i++) idx->sat[i+1]+=idx->sat[i];
+    for (i=pcvs->n-1;i>=0;i--) {
+        if (pcvs->pcv[i].sat>0&&pcvs->pcv[i].sat<=MAXSAT) {
+            idx->ent[--idx->sat[pcvs->pcv[i].sat-1]]=i;
+        }
+    }
+    /* receiver antennas by antenna+radome and antenna (first one in file) */
+    for (i=0;i<n;i++) idx->hash[i]=-1;
+    for (i=0;i<pcvs->n;i++) {
+        if (normtype(pcvs->pcv[i].type,full,ant)<=0) continue;
+        if (*(slot=hashslot(pcvs,full))<0) *slot=i*2;
+        if (*(slot=hashslot(pcvs,ant ))<0) *slot=i*2+1;
+    }
+    trace(3,"indexpcv: n=%d nhash=%d\n",pcvs->n,n);
+}
 /* read antenna parameters ------------------------------------------------------
 * read antenna parameters
 * args   : char   *file       I   antenna parameter file (antex)
@@ -2254,6 +2912,8 @@ static int readantex(const char *file, pcvs_t *pcvs)
 *          file except for antex is recognized ngs antenna parameters
 *          see reference [3]
 *          only support non-azimuth-depedent parameters
+*          antenna parameters are indexed for searchpcv(). free them by
+*          freepcv()
 *-----------------------------------------------------------------------------*/
 extern int readpcv(const char *file, pcvs_t *pcvs)
 {
@@ -2277,8 +2937,58 @@ extern int readpcv(const char *file, pcvs_t *pcvs)
               pcv->sat,pcv->type,pcv->code,pcv->off[0][0],pcv->off[0][1],
               pcv->off[0][2],pcv->off[1][0],pcv->off[1][1],pcv->off[1][2]);
     }
+    indexpcv(pcvs);
     return stat;
 }
+/* free antenna parameters -----------------------------------------------------
+* free antenna parameters and index read by readpcv()
+* args   : pcvs_t *pcvs       IO  antenna parameters
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void freepcv(pcvs_t *pcvs)
+{
+    freepcvidx(pcvs);
+    free(pcvs->pcv); pcvs->pcv=NULL; pcvs->n=pcvs->nmax=0;
+}
+/* test valid time of antenna parameter --------------------------------------*/
+static int validpcv(const pcv_t *pcv, gtime_t time)
+{
+    if (pcv->ts.time!=0&&timediff(pcv->ts,time)>0.0) return 0;
+    if (pcv->te.time!=0&&timediff(pcv->te,time)<0.0) return 0;
+    return 1;
+}
+/* search antenna parameter by index -----------------------------------------*/
+static pcv_t *searchpcv_idx(int sat, const char *type, gtime_t time,
+                            const pcvs_t *pcvs, int *stat)
+{
+    const pcvidx_t *idx=pcvs->idx;
+    char full[MAXANT],ant[MAXANT];
+    int i,n,*slot;
+    
+    *stat=1;
+    
+    if (sat) { /* satellite antenna in entries of the satellite */
+        if (sat<1||MAXSAT<sat) return NULL;
+        for (i=idx->sat[sat-1];i<idx->sat[sat];i++) {
+            if (validpcv(pcvs->pcv+idx->ent[i],time)) {
+                return pcvs->pcv+idx->ent[i];
+            }
+        }
+        return NULL;
+    }
+    if ((n=normtype(type,full,ant))<=0) return NULL;
+    
+    /* receiver antenna with radome at first */
+    if (*(slot=hashslot(pcvs,full))>=0) return pcvs->pcv+*slot/2;
+    
+    /* receiver antenna without radome */
+    if (n>=2&&*(slot=hashslot(pcvs,ant))>=0) {
+        trace(2,"pcv without radome is used type=%s\n",type);
+        return pcvs->pcv+*slot/2;
+    }
+    *stat=0; /* no exact match */
+    return NULL;
+}
 /* search antenna parameter ----------------------------------------------------
 * read satellite antenna phase center position
 * args   : int    sat         I   satellite number (0: receiver antenna)
@@ -2286,22 +2996,29 @@ extern int readpcv(const char *file, pcvs_t *pcvs)
 *          gtime_t time       I   time to search parameters
 *          pcvs_t *pcvs       IO  antenna parameters
 * return : antenna parameter (NULL: no antenna)
+* notes  : with the index built by readpcv(), antenna types are matched
+*          exactly as "antenna radome" or "antenna" in O(1). nonstandard
+*          types without exact match are searched as substrings.
+*          the index is not modified by searchpcv(). it is safe to call it
+*          from multiple threads sharing the antenna parameters
 *-----------------------------------------------------------------------------*/
 extern pcv_t *searchpcv(int sat, const char *type, gtime_t time,
                         const pcvs_t *pcvs)
 {
     pcv_t *pcv;
     char buff[MAXANT],*types[2],*p;
-    int i,j,n=0;
+    int i,j,n=0,stat;
     
     trace(4,"searchpcv: sat=%2d type=%s\n",sat,type);
     
+    if (pcvs->idx&&pcvs->idx->n==pcvs->n) {
+        pcv=searchpcv_idx(sat,type,time,pcvs,&stat);
+        if (pcv||stat) return pcv;
+    }
     if (sat) { /* search satellite antenna */
         for (i=0;i<pcvs->n;i++) {
             pcv=pcvs->pcv+i;
-            if (pcv->sat!=sat) continue;
-            if (pcv->ts.time!=0&&timediff(pcv->ts,time)>0.0) continue;
-            if (pcv->te.time!=0&&timediff(pcv->te,time)<0.0) continue;
+            if (pcv->sat!=sat||!validpcv(pcv,time)) continue;
             return pcv;
         }
     }
@@ -2419,17 +3136,92 @@ extern int readblq(const char *file, const char *sta, double *odisp)
     trace(2,"no otl parameters: sta=%s file=%s\n",sta,file);
     return 0;
 }
+/* add earth rotation parameter data ----------------------------------------*/
+static int adderp(erp_t *erp, const erpd_t *data)
+{
+    erpd_t *erp_data;
+    
+    if (erp->n>=erp->nmax) {
+        erp->nmax=erp->nmax<=0?128:erp->nmax*2;
+        erp_data=(erpd_t *)realloc(erp->data,sizeof(erpd_t)*erp->nmax);
+        if (!erp_data) {
+            free(erp->data); erp->data=NULL; erp->n=erp->nmax=0;
+            return 0;
+        }
+        erp->data=erp_data;
+    }
+    erp->data[erp->n++]=*data;
+    return 1;
+}
+/* decode IGS ERP record -----------------------------------------------------*/
+static int decode_igserp(const char *buff, erpd_t *data)
+{
+    const char *p=buff;
+    char *q;
+    double v[14]={0};
+    int n;
+    
+    for (n=0;n<14;n++,p=q) {
+        v[n]=strtod(p,&q);
+        if (q==p) break;
+    }
+    if (n<5) return 0;
+    data->mjd=v[0];
+    data->xp=v[1]*1E-6*AS2R;
+    data->yp=v[2]*1E-6*AS2R;
+    data->ut1_utc=v[3]*1E-7;
+    data->lod=v[4]*1E-7;
+    data->xpr=v[12]*1E-6*AS2R;
+    data->ypr=v[13]*1E-6*AS2R;
+    return 1;
+}
+/* decode IERS finals (bulletin A) record ------------------------------------*/
+static int decode_finals(const char *buff, erpd_t *data)
+{
+    if (strlen(buff)<68||(buff[16]!='I'&&buff[16]!='P')||
+        (buff[57]!='I'&&buff[57]!='P')) {
+        return 0;
+    }
+    data->mjd=str2num(buff,7,8);
+    data->xp=str2num(buff,18,9)*AS2R;
+    data->yp=str2num(buff,37,9)*AS2R;
+    data->ut1_utc=str2num(buff,58,10);
+    data->lod=str2num(buff,79,7)*1E-3; /* blank for predictions */
+    data->xpr=data->ypr=0.0;
+    return data->mjd>0.0;
+}
+/* set interpolation slopes of earth rotation parameters ---------------------*/
+static void seterpslope(erp_t *erp)
+{
+    erpd_t *p;
+    double dt;
+    int i;
+    
+    for (i=0;i<erp->n;i++) {
+        p=erp->data+i;
+        p->dxp=p->dyp=p->dut1_utc=p->dlod=0.0;
+        if (i>=erp->n-1||(dt=p[1].mjd-p->mjd)<=0.0) continue;
+        p->dxp     =(p[1].xp     -p->xp     )/dt;
+        p->dyp     =(p[1].yp     -p->yp     )/dt;
+        p->dut1_utc=(p[1].ut1_utc-p->ut1_utc)/dt;
+        p->dlod    =(p[1].lod    -p->lod    )/dt;
+    }
+}
 /* read earth rotation parameters ----------------------------------------------
 * read earth rotation parameters
-* args   : char   *file       I   IGS ERP file (IGS ERP ver.2)
+* args   : char   *file       I   IGS ERP file (IGS ERP ver.2) or
+*                                 IERS finals file (finals.all, finals.daily,
+*                                 finals2000A.all, ...)
 *          erp_t  *erp        O   earth rotation parameters
 * return : status (1:ok,0:file open error)
+* notes  : IERS finals records are recognized by the IERS/prediction flags
+*          (column 17 and 58). bulletin A values are used. pole offset rates
+*          are not included in IERS finals
 *-----------------------------------------------------------------------------*/
 extern int readerp(const char *file, erp_t *erp)
 {
     FILE *fp;
-    erpd_t *erp_data;
-    double v[14]={0};
+    erpd_t data={0};
     char buff[256];
     
     trace(3,"readerp: file=%s\n",file);
@@ -2439,29 +3231,14 @@ extern int readerp(const char *file, erp_t *erp)
         return 0;
     }
     while (fgets(buff,sizeof(buff),fp)) {
-        if (sscanf(buff,"%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
-                   v,v+1,v+2,v+3,v+4,v+5,v+6,v+7,v+8,v+9,v+10,v+11,v+12,v+13)<5) {
-            continue;
-        }
-        if (erp->n>=erp->nmax) {
-            erp->nmax=erp->nmax<=0?128:erp->nmax*2;
-            erp_data=(erpd_t *)realloc(erp->data,sizeof(erpd_t)*erp->nmax);
-            if (!erp_data) {
-                free(erp->data); erp->data=NULL; erp->n=erp->nmax=0;
-                fclose(fp);
-                return 0;
-            }
-            erp->data=erp_data;
+        if (!decode_finals(buff,&data)&&!decode_igserp(buff,&data)) continue;
+        if (!adderp(erp,&data)) {
+            fclose(fp);
+            return 0;
         }
-        erp->data[erp->n].mjd=v[0];
-        erp->data[erp->n].xp=v[1]*1E-6*AS2R;
-        erp->data[erp->n].yp=v[2]*1E-6*AS2R;
-        erp->data[erp->n].ut1_utc=v[3]*1E-7;
-        erp->data[erp->n].lod=v[4]*1E-7;
-        erp->data[erp->n].xpr=v[12]*1E-6*AS2R;
-        erp->data[erp->n++].ypr=v[13]*1E-6*AS2R;
     }
     fclose(fp);
+    seterpslope(erp);
     return 1;
 }
 /* get earth rotation parameter values -----------------------------------------
@@ -2470,11 +3247,14 @@ extern int readerp(const char *file, erp_t *erp)
 *          gtime_t time       I   time (gpst)
 *          double *erpv       O   erp values {xp,yp,ut1_utc,lod} (rad,rad,s,s/d)
 * return : status (1:ok,0:error)
+* notes  : erp is not modified. the interval is searched by bisection and
+*          interpolated with the slopes set by readerp()
 *-----------------------------------------------------------------------------*/
 extern int geterp(const erp_t *erp, gtime_t time, double *erpv)
 {
     const double ep[]={2000,1,1,12,0,0};
-    double mjd,day,a;
+    const erpd_t *p;
+    double mjd,day;
     int i,j,k;
     
     trace(4,"geterp:\n");
@@ -2484,35 +3264,41 @@ extern int geterp(const erp_t *erp, gtime_t time, double *erpv)
     mjd=51544.5+(timediff(gpst2utc(time),epoch2time(ep)))/86400.0;
     
     if (mjd<=erp->data[0].mjd) {
-        day=mjd-erp->data[0].mjd;
-        erpv[0]=erp->data[0].xp     +erp->data[0].xpr*day;
-        erpv[1]=erp->data[0].yp     +erp->data[0].ypr*day;
-        erpv[2]=erp->data[0].ut1_utc-erp->data[0].lod*day;
-        erpv[3]=erp->data[0].lod;
-        return 1;
-    }
-    if (mjd>=erp->data[erp->n-1].mjd) {
-        day=mjd-erp->data[erp->n-1].mjd;
-        erpv[0]=erp->data[erp->n-1].xp     +erp->data[erp->n-1].xpr*day;
-        erpv[1]=erp->data[erp->n-1].yp     +erp->data[erp->n-1].ypr*day;
-        erpv[2]=erp->data[erp->n-1].ut1_utc-erp->data[erp->n-1].lod*day;
-        erpv[3]=erp->data[erp->n-1].lod;
-        return 1;
-    }
-    for (j=0,k=erp->n-1;j<k-1;) {
-        i=(j+k)/2;
-        if (mjd<erp->data[i].mjd) k=i; else j=i;
+        p=erp->data;
+        day=mjd-p->mjd;
+        erpv[0]=p->xp     +p->xpr*day;
+        erpv[1]=p->yp     +p->ypr*day;
+        erpv[2]=p->ut1_utc-p->lod*day;
+        erpv[3]=p->lod;
     }
-    if (erp->data[j].mjd==erp->data[j+1].mjd) {
-        a=0.5;
+    else if (mjd>=erp->data[erp->n-1].mjd) {
+        p=erp->data+erp->n-1;
+        day=mjd-p->mjd;
+        erpv[0]=p->xp     +p->xpr*day;
+        erpv[1]=p->yp     +p->ypr*day;
+        erpv[2]=p->ut1_utc-p->lod*day;
+        erpv[3]=p->lod;
     }
     else {
-        a=(mjd-erp->data[j].mjd)/(erp->data[j+1].mjd-erp->data[j].mjd);
+        for (j=0,k=erp->n-1;j<k-1;) {
+            i=(j+k)/2;
+            if (mjd<erp->data[i].mjd) k=i; else j=i;
+        }
+        p=erp->data+j;
+        if (p->mjd==p[1].mjd) {
+            erpv[0]=0.5*(p->xp     +p[1].xp     );
+            erpv[1]=0.5*(p->yp     +p[1].yp     );
+            erpv[2]=0.5*(p->ut1_utc+p[1].ut1_utc);
+            erpv[3]=0.5*(p->lod    +p[1].lod    );
+        }
+        else {
+            day=mjd-p->mjd;
+            erpv[0]=p->xp     +p->dxp     *day;
+            erpv[1]=p->yp     +p->dyp     *day;
+            erpv[2]=p->ut1_utc+p->dut1_utc*day;
+            erpv[3]=p->lod    +p->dlod    *day;
+        }
     }
-    erpv[0]=(1.0-a)*erp->data[j].xp     +a*erp->data[j+1].xp;
-    erpv[1]=(1.0-a)*erp->data[j].yp     +a*erp->data[j+1].yp;
-    erpv[2]=(1.0-a)*erp->data[j].ut1_utc+a*erp->data[j+1].ut1_utc;
-    erpv[3]=(1.0-a)*erp->data[j].lod    +a*erp->data[j+1].lod;
     return 1;
 }
 /* compare ephemeris ---------------------------------------------------------*/
@@ -2703,17 +3489,23 @@ extern int sortobs(obs_t *obs)
     
     if (obs->n<=0) return 0;
     
-    qsort(obs->data,obs->n,sizeof(obsd_t),cmpobs);
-    
-    /* delete duplicated data */
-    for (i=j=0;i<obs->n;i++) {
-        if (obs->data[i].sat!=obs->data[j].sat||
-            obs->data[i].rcv!=obs->data[j].rcv||
-            timediff(obs->data[i].time,obs->data[j].time)!=0.0) {
-            obs->data[++j]=obs->data[i];
+    /* skip sort if already sorted without duplication */
+    for (i=1;i<obs->n;i++) {
+        if (cmpobs(obs->data+i-1,obs->data+i)>=0) break;
+    }
+    if (i<obs->n) {
+        qsort(obs->data,obs->n,sizeof(obsd_t),cmpobs);
+        
+        /* delete duplicated data */
+        for (i=j=0;i<obs->n;i++) {
+            if (obs->data[i].sat!=obs->data[j].sat||
+                obs->data[i].rcv!=obs->data[j].rcv||
+                timediff(obs->data[i].time,obs->data[j].time)!=0.0) {
+                obs->data[++j]=obs->data[i];
+            }
         }
+        obs->n=j+1;
     }
-    obs->n=j+1;
     
     for (i=n=0;i<obs->n;i=j,n++) {
         for (j=i+1;j<obs->n;j++) {
@@ -2868,6 +3660,129 @@ extern void freeobs(obs_t *obs)
 {
     free(obs->data); obs->data=NULL; obs->n=obs->nmax=0;
 }
+/* memory barrier for observation epoch ring buffer --------------------------*/
+static void membarrier(void)
+{
+#ifdef WIN32
+    MemoryBarrier();
+#elif defined(__GNUC__)
+    __sync_synchronize();
+#endif
+}
+/* initialize observation epoch ring buffer ------------------------------------
+* initialize single-producer/single-consumer ring buffer of observation epochs
+* with a preallocated observation data pool
+* args   : obsring_t *ring  IO  observation epoch ring buffer
+*          int    nslot     I   number of epoch slots (rounded up to power of 2)
+*          int    nobs      I   max number of observation data in a slot
+* return : status (1:ok,0:memory allocation error)
+* notes  : one thread may write epochs by obsringslot() and obsringcommit()
+*          and another thread may read them by obsringcount(), obsringpeek()
+*          and obsringrelease() without lock. the data of a slot is valid until
+*          the slot is released.
+*-----------------------------------------------------------------------------*/
+extern int initobsring(obsring_t *ring, int nslot, int nobs)
+{
+    int i,n;
+    
+    trace(3,"initobsring: nslot=%d nobs=%d\n",nslot,nobs);
+    
+    for (n=1;n<nslot;n<<=1) ;
+    ring->nslot=n;
+    ring->nobs=nobs;
+    ring->wp=ring->rp=ring->nover=0;
+    ring->epoch=(obs_t *)malloc(sizeof(obs_t)*n);
+    ring->pool=(obsd_t *)malloc(sizeof(obsd_t)*n*nobs);
+    if (!ring->epoch||!ring->pool) {
+        free(ring->epoch); ring->epoch=NULL;
+        free(ring->pool ); ring->pool =NULL;
+        ring->nslot=0;
+        return 0;
+    }
+    for (i=0;i<n;i++) {
+        ring->epoch[i].n=0;
+        ring->epoch[i].nmax=nobs;
+        ring->epoch[i].data=ring->pool+i*nobs;
+    }
+    return 1;
+}
+/* free observation epoch ring buffer ------------------------------------------
+* free memory for observation epoch ring buffer
+* args   : obsring_t *ring  IO  observation epoch ring buffer
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void freeobsring(obsring_t *ring)
+{
+    free(ring->epoch); ring->epoch=NULL;
+    free(ring->pool ); ring->pool =NULL;
+    ring->nslot=ring->nobs=0;
+    ring->wp=ring->rp=0;
+}
+/* get slot to write observation epoch -----------------------------------------
+* get next slot of observation epoch ring buffer to write (producer)
+* args   : obsring_t *ring  IO  observation epoch ring buffer
+* return : epoch slot (NULL: ring full)
+* notes  : the epoch written to the slot is passed to the consumer by
+*          obsringcommit(). the slot is returned again if not committed.
+*-----------------------------------------------------------------------------*/
+extern obs_t *obsringslot(obsring_t *ring)
+{
+    unsigned int wp=ring->wp;
+    
+    if (ring->nslot<=0||(int)(wp-ring->rp)>=ring->nslot) {
+        ring->nover++;
+        return NULL;
+    }
+    membarrier(); /* read slot after released by consumer */
+    return ring->epoch+(wp&(ring->nslot-1));
+}
+/* commit observation epoch ----------------------------------------------------
+* pass observation epoch written to the slot to the consumer (producer)
+* args   : obsring_t *ring  IO  observation epoch ring buffer
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void obsringcommit(obsring_t *ring)
+{
+    membarrier(); /* write slot before count */
+    ring->wp++;
+}
+/* number of observation epochs in ring ----------------------------------------
+* get number of observation epochs committed and not released (consumer)
+* args   : obsring_t *ring  I   observation epoch ring buffer
+* return : number of epochs
+*-----------------------------------------------------------------------------*/
+extern int obsringcount(const obsring_t *ring)
+{
+    return (int)(ring->wp-ring->rp);
+}
+/* peek observation epoch ------------------------------------------------------
+* get observation epoch in ring buffer without release (consumer)
+* args   : obsring_t *ring  IO  observation epoch ring buffer
+*          int    i         I   index of epoch (0:oldest)
+* return : observation epoch (NULL: no epoch)
+*-----------------------------------------------------------------------------*/
+extern obs_t *obsringpeek(obsring_t *ring, int i)
+{
+    unsigned int rp=ring->rp;
+    
+    if (i<0||i>=(int)(ring->wp-rp)) return NULL;
+    membarrier(); /* read slot after count */
+    return ring->epoch+((rp+i)&(ring->nslot-1));
+}
+/* release observation epochs --------------------------------------------------
+* release oldest observation epochs to reuse the slots (consumer)
+* args   : obsring_t *ring  IO  observation epoch ring buffer
+*          int    n         I   number of epochs to release
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void obsringrelease(obsring_t *ring, int n)
+{
+    int m=(int)(ring->wp-ring->rp);
+    
+    if (n<=0) return;
+    membarrier(); /* read slot before release */
+    ring->rp+=n<m?n:m;
+}
 /* free navigation data ---------------------------------------------------------
 * free memory for navigation data
 * args   : nav_t *nav    IO     navigation data
@@ -2875,7 +3790,10 @@ extern void freeobs(obs_t *obs)
 *                               (0x01: gps/qzs ephmeris, 0x02: glonass ephemeris,
 *                                0x04: sbas ephemeris,   0x08: precise ephemeris,
 *                                0x10: precise clock     0x20: almanac,
-*                                0x40: tec data)
+*                                0x40: tec data          0x80: fcb data,
+*                                0x100: satellite pcv,   0x200: ssr corrections,
+*                                0x400: dgps corrections,0x800: lex ephemeris,
+*                                0x1000: sbas corrections)
 * return : none
 *-----------------------------------------------------------------------------*/
 extern void freenav(nav_t *nav, int opt)
@@ -2888,6 +3806,44 @@ extern void freenav(nav_t *nav, int opt)
     if (opt&0x20) {free(nav->alm ); nav->alm =NULL; nav->na=nav->namax=0;}
     if (opt&0x40) {free(nav->tec ); nav->tec =NULL; nav->nt=nav->ntmax=0;}
     if (opt&0x80) {free(nav->fcb ); nav->fcb =NULL; nav->nf=nav->nfmax=0;}
+    if (opt&0x100) {free(nav->pcvs  ); nav->pcvs  =NULL;}
+    if (opt&0x200) {free(nav->ssr   ); nav->ssr   =NULL;}
+    if (opt&0x400) {free(nav->dgps  ); nav->dgps  =NULL;}
+    if (opt&0x800) {free(nav->lexeph); nav->lexeph=NULL;}
+    if (opt&0x1000) {
+        free(nav->sbssat); nav->sbssat=NULL;
+        free(nav->sbsion); nav->sbsion=NULL;
+    }
+}
+/* allocate navigation corrections ---------------------------------------------
+* allocate memory for navigation corrections on demand
+* args   : nav_t *nav    IO     navigation data
+*          int   opt     I      option (or of followings)
+*                               (0x100: satellite pcv,   0x200: ssr corrections,
+*                                0x400: dgps corrections,0x800: lex ephemeris,
+*                                0x1000: sbas corrections)
+* return : status (1:ok,0:memory allocation error)
+* notes  : the corrections are cleared to zero at allocation. already allocated
+*          corrections are kept. free them by freenav().
+*-----------------------------------------------------------------------------*/
+extern int allocnav(nav_t *nav, int opt)
+{
+    if (((opt&0x100)&&!nav->pcvs&&
+         !(nav->pcvs=(pcv_t *)calloc(MAXSAT,sizeof(pcv_t))))||
+        ((opt&0x200)&&!nav->ssr&&
+         !(nav->ssr=(ssr_t *)calloc(MAXSAT,sizeof(ssr_t))))||
+        ((opt&0x400)&&!nav->dgps&&
+         !(nav->dgps=(dgps_t *)calloc(MAXSAT,sizeof(dgps_t))))||
+        ((opt&0x800)&&!nav->lexeph&&
+         !(nav->lexeph=(lexeph_t *)calloc(MAXSAT,sizeof(lexeph_t))))||
+        ((opt&0x1000)&&!nav->sbssat&&
+         !(nav->sbssat=(sbssat_t *)calloc(1,sizeof(sbssat_t))))||
+        ((opt&0x1000)&&!nav->sbsion&&
+         !(nav->sbsion=(sbsion_t *)calloc(MAXBAND+1,sizeof(sbsion_t))))) {
+        trace(1,"allocnav: memory allocation error opt=%x\n",opt);
+        return 0;
+    }
+    return 1;
 }
 /* debug trace functions -----------------------------------------------------*/
 #ifdef TRACE
@@ -3933,6 +4889,29 @@ extern int rtk_uncompress(const char *file, char *uncfile)
     trace(3,"rtk_uncompress: stat=%d\n",stat);
     return stat;
 }
+/* compress file ---------------------------------------------------------------
+* compress file by gzip
+* args   : char   *file     I   input file
+*          char   *cmpfile  O   compressed file (<file>.gz)
+* return : status (-1:error,1:compress completed)
+* note   : input file is replaced by compressed file
+*          gzip command has to be installed in commands path
+*-----------------------------------------------------------------------------*/
+extern int rtk_compress(const char *file, char *cmpfile)
+{
+    char cmd[2048];
+    
+    trace(3,"rtk_compress: file=%s\n",file);
+    
+    sprintf(cmpfile,"%s.gz",file);
+    sprintf(cmd,"gzip -f \"%s\"",file);
+    
+    if (execcmd(cmd)) {
+        remove(cmpfile);
+        return -1;
+    }
+    return 1;
+}
 /* dummy application functions for shared library ----------------------------*/
 #ifdef WIN_DLL
 extern int showmsg(char *format,...) {return 0;}
@@ -252,6 +252,7 @@ extern "C" {
 #define MAXSTRRTK   8                   /* max number of stream in RTK server */
 #define MAXSBSMSG   32                  /* max number of SBAS msg in RTK server */
 #define MAXSOLMSG   8191                /* max length of solution message */
+#define MAXSOLSTATB (MAXSOLMSG+64+MAXSAT*NFREQ*60) /* max length of binary solution status */
 #define MAXRAWLEN   4096                /* max length of receiver raw message */
 #define MAXERRMSG   4096                /* max length of error/warning message */
 #define MAXANT      64                  /* max length of station name/antenna type */
@@ -357,6 +358,7 @@ extern "C" {
 #define SOLF_NMEA   3                   /* solution format: NMEA-183 */
 #define SOLF_STAT   4                   /* solution format: solution status */
 #define SOLF_GSIF   5                   /* solution format: GSI F1/F2 */
+#define SOLF_STATB  6                   /* solution format: solution status (binary) */
 
 #define SOLQ_NONE   0                   /* solution status: no solution */
 #define SOLQ_FIX    1                   /* solution status: fix */
@@ -470,6 +472,13 @@ extern "C" {
 #define STR_MODE_W  0x2                 /* stream mode: write */
 #define STR_MODE_RW 0x3                 /* stream mode: read/write */
 
+#define METF_PROM   0                   /* metrics format: prometheus text */
+#define METF_JSON   1                   /* metrics format: json */
+
+#define THRDPOL_OTHER 0                 /* thread policy: normal */
+#define THRDPOL_FIFO  1                 /* thread policy: real-time fifo */
+#define THRDPOL_RR    2                 /* thread policy: real-time round-robin */
+
 #define GEOID_EMBEDDED    0             /* geoid model: embedded geoid */
 #define GEOID_EGM96_M150  1             /* geoid model: EGM96 15x15" */
 #define GEOID_EGM2008_M25 2             /* geoid model: EGM2008 2.5x2.5" */
@@ -572,12 +581,25 @@ typedef struct {        /* observation data */
     obsd_t *data;       /* observation data records */
 } obs_t;
 
+typedef struct {        /* observation epoch ring buffer type */
+    int nslot;          /* number of epoch slots (power of 2) */
+    int nobs;           /* max number of observation data in a slot */
+    volatile unsigned int wp; /* count of written epochs (producer) */
+    volatile unsigned int rp; /* count of released epochs (consumer) */
+    unsigned int nover; /* number of epochs dropped by overflow */
+    obs_t *epoch;       /* epoch slots */
+    obsd_t *pool;       /* observation data pool (nslot x nobs) */
+} obsring_t;
+
 typedef struct {        /* earth rotation parameter data type */
     double mjd;         /* mjd (days) */
     double xp,yp;       /* pole offset (rad) */
     double xpr,ypr;     /* pole offset rate (rad/day) */
     double ut1_utc;     /* ut1-utc (s) */
     double lod;         /* length of day (s/day) */
+    double dxp,dyp;     /* pole offset slope to next data (rad/day) */
+    double dut1_utc;    /* ut1-utc slope to next data (s/day) */
+    double dlod;        /* length of day slope to next data (s/day/day) */
 } erpd_t;
 
 typedef struct {        /* earth rotation parameter type */
@@ -595,9 +617,18 @@ typedef struct {        /* antenna parameter type */
                         /* el=90,85,...,0 or nadir=0,1,2,3,... (deg) */
 } pcv_t;
 
+typedef struct {        /* antenna parameters index type */
+    int n;              /* number of indexed antenna parameters */
+    int sat[MAXSAT+1];  /* satellite antenna entries ent[sat[i-1]]...ent[sat[i]-1] */
+    int *ent;           /* satellite antenna entries grouped by satellite */
+    int nhash;          /* size of receiver antenna hash table (2^n) */
+    int *hash;          /* receiver antenna hash table (entry*2+key type,-1:empty) */
+} pcvidx_t;
+
 typedef struct {        /* antenna parameters type */
     int n,nmax;         /* number of data/allocated */
     pcv_t *pcv;         /* antenna parameters data */
+    pcvidx_t *idx;      /* antenna parameters index (NULL:no index) */
 } pcvs_t;
 
 typedef struct {        /* almanac type */
@@ -912,14 +943,15 @@ typedef struct {        /* navigation data type */
     double wlbias[MAXSAT];   /* wide-lane bias (cycle) */
     double glo_cpbias[4];    /* glonass code-phase bias {1C,1P,2C,2P} (m) */
     char glo_fcn[MAXPRNGLO+1]; /* glonass frequency channel number + 8 */
-    pcv_t pcvs[MAXSAT]; /* satellite antenna pcv */
-    sbssat_t sbssat;    /* SBAS satellite corrections */
-    sbsion_t sbsion[MAXBAND+1]; /* SBAS ionosphere corrections */
-    dgps_t dgps[MAXSAT]; /* DGPS corrections */
-    ssr_t ssr[MAXSAT];  /* SSR corrections */
-    lexeph_t lexeph[MAXSAT]; /* LEX ephemeris */
     lexion_t lexion;    /* LEX ionosphere correction */
     pppcorr_t pppcorr;  /* ppp corrections */
+    /* corrections allocated on demand by allocnav() (NULL: not allocated) */
+    pcv_t *pcvs;        /* satellite antenna pcv (MAXSAT) */
+    sbssat_t *sbssat;   /* SBAS satellite corrections */
+    sbsion_t *sbsion;   /* SBAS ionosphere corrections (MAXBAND+1) */
+    dgps_t *dgps;       /* DGPS corrections (MAXSAT) */
+    ssr_t *ssr;         /* SSR corrections (MAXSAT) */
+    lexeph_t *lexeph;   /* LEX ephemeris (MAXSAT) */
 } nav_t;
 
 typedef struct {        /* station parameter type */
@@ -989,6 +1021,59 @@ typedef struct {        /* solution status buffer type */
     solstat_t *data;    /* solution status data */
 } solstatbuf_t;
 
+typedef struct {        /* observation qc statistics type */
+    int nobs;           /* number of observations */
+    int nmp;            /* number of multipath samples */
+    int narc;           /* number of multipath arcs */
+    int nslip;          /* number of cycle-slips (lli or multipath jump) */
+    double mpss;        /* sum of squared multipath minus arc mean (m^2) */
+    int nsnr;           /* number of snr samples */
+    double snrs,snrss;  /* sum and sum of squares of snr (dBHz,dBHz^2) */
+    double snrmin,snrmax; /* min and max snr (dBHz) */
+} qcstat_t;
+
+typedef struct {        /* observation qc multipath arc type */
+    gtime_t ts,te;      /* start and end time of arc */
+    int n;              /* number of samples (0:no arc) */
+    int slip;           /* pending cycle-slip flag */
+    int first,last;     /* first and last record index (-1:no index) */
+    double mean,m2;     /* mean and sum of squared deviations (m,m^2) */
+} qcarc_t;
+
+typedef struct {        /* observation qc satellite type */
+    qcarc_t arc[NFREQ+NEXOBS]; /* multipath arcs */
+    qcstat_t stat[NFREQ+NEXOBS]; /* statistics */
+    gtime_t tion;       /* time of ionospheric delay (0:none) */
+    double ion;         /* L1 ionospheric delay plus bias (m) */
+    int nrot;           /* number of ionospheric rates */
+    double rotss,rotmax; /* sum of squares and max abs of rate (TECU/min) */
+    double lam[MAXFREQ]; /* carrier wave lengths (m) (0:not set) */
+    int last;           /* last record index (-1:none) */
+} qcsat_t;
+
+typedef struct {        /* observation qc type */
+    double thres;       /* multipath jump threshold of cycle-slip (m) */
+    double maxgap;      /* max gap of ionospheric rate (s) */
+    qcsat_t sat[MAXSAT]; /* satellite states */
+} qc_t;
+
+typedef struct decsink_tag { /* decoder event sink type */
+    void (*on_obs_epoch)(struct decsink_tag *sink, const obs_t *obs);
+                        /* observation epoch decoded (NULL: none) */
+    void (*on_ephemeris)(struct decsink_tag *sink, int sat, const nav_t *nav);
+                        /* ephemeris of sat decoded into nav (NULL: none) */
+    void (*on_ssr)(struct decsink_tag *sink, ssr_t *ssr);
+                        /* ssr corrections (MAXSAT) decoded (NULL: none) */
+    void *arg;          /* user argument */
+    int id;             /* user id of decoder */
+} decsink_t;
+
+typedef struct {        /* code priority table type */
+    unsigned char pri[7][MAXCODE+1]; /* priority (15:highest-1:lowest,0:none) */
+    char opt[256];      /* code options of the table */
+    int stamp;          /* stamp of code priority settings (0:not compiled) */
+} codepri_t;
+
 typedef struct {        /* RTCM control struct type */
     int staid;          /* station id */
     int stah;           /* station health */
@@ -1000,7 +1085,8 @@ typedef struct {        /* RTCM control struct type */
     nav_t nav;          /* satellite ephemerides */
     sta_t sta;          /* station parameters */
     dgps_t *dgps;       /* output of dgps corrections */
-    ssr_t ssr[MAXSAT];  /* output of ssr corrections */
+    ssr_t *ssr;         /* output of ssr corrections (MAXSAT) (NULL: none) */
+    decsink_t sink;     /* event sink of decoded data */
     char msg[128];      /* special message */
     char msgtype[256];  /* last message type */
     char msmtype[6][128]; /* msm signal types */
@@ -1018,6 +1104,7 @@ typedef struct {        /* RTCM control struct type */
     unsigned int nmsg2[100]; /* message count of RTCM 2 (1-99:1-99,0:other) */
     unsigned int nmsg3[400]; /* message count of RTCM 3 (1-299:1001-1299,300-399:2000-2099,0:ohter) */
     char opt[256];      /* RTCM dependent options */
+    codepri_t codepri;  /* code priority table for options */
 } rtcm_t;
 
 typedef struct {        /* rinex control struct type */
@@ -1034,6 +1121,31 @@ typedef struct {        /* rinex control struct type */
     char   opt[256];    /* rinex dependent options */
 } rnxctr_t;
 
+typedef struct {        /* compact rinex satellite state type */
+    int epoch;          /* last epoch index */
+    int arc[MAXOBSTYPE]; /* order of data arc (0:no arc) */
+    double dat[MAXOBSTYPE][4]; /* last data and differences */
+    char flag[MAXOBSTYPE*2+1]; /* last lli/ssi flags */
+} crxsat_t;
+
+typedef struct {        /* compact rinex (hatanaka) encoder type */
+    int    ver;         /* crinex version (1:1.0,3:3.0) */
+    int    nobs[7];     /* number of obs types {GPS,GLO,GAL,QZS,SBS,CMP,IRN} */
+    int    nep;         /* epoch index */
+    int    init;        /* initialize epoch line and data arcs */
+    int    stat;        /* record state (0:epoch,1:sat list,2:data,3:event) */
+    int    nline;       /* number of lines left in record */
+    int    ns,isat;     /* number of satellites / current satellite */
+    int    nc;          /* number of chars in line buffer */
+    int    nd;          /* number of chars in data buffer */
+    int    nb,nbmax;    /* number/max number of chars in output buffer */
+    char   line[16*MAXOBSTYPE+16]; /* line buffer */
+    char   data[16*MAXOBSTYPE+16]; /* data record buffer of satellite */
+    char   epoch[48+4*MAXOBS],epoch_p[48+4*MAXOBS]; /* crinex epoch lines */
+    char   *buff;       /* output buffer of data lines */
+    crxsat_t *sat;      /* satellite states */
+} crx_t;
+
 typedef struct {        /* download url type */
     char type[32];      /* data type */
     char path[1024];    /* url path */
@@ -1063,7 +1175,8 @@ typedef struct {        /* SNR mask type */
 
 typedef struct {        /* processing options type */
     int mode;           /* positioning mode (PMODE_???) */
-    int soltype;        /* solution type (0:forward,1:backward,2:combined) */
+    int soltype;        /* solution type (0:forward,1:backward,2:combined,
+                           3:batch) */
     int nf;             /* number of frequencies (1:L1,2:L1+L2,3:L1+L2+L3,4:L1+L2+L3+L4) */
     int navsys;         /* navigation system */
     double elmin;       /* elevation mask angle (rad) */
@@ -1153,6 +1266,7 @@ typedef struct {        /* solution options type */
     char sep[64];       /* field separator */
     char prog[64];      /* program name */
     double maxsolstd;   /* max std-dev for solution output (m) (0:all) */
+    int sstatf;         /* solution statistics format (0:text,1:binary) */
 } solopt_t;
 
 typedef struct {        /* file options type */
@@ -1194,13 +1308,17 @@ typedef struct {        /* RINEX options type */
     char comment[MAXCOMMENT][64]; /* comments */
     char rcvopt[256];   /* receiver dependent options */
     unsigned char exsats[MAXSAT]; /* excluded satellites */
-    int scanobs;        /* scan obs types */
+    int scanobs;        /* scan obs types (0:off,1:on,2:on in single pass) */
     int outiono;        /* output iono correction */
     int outtime;        /* output time system correction */
     int outleaps;       /* output leap seconds */
     int autopos;        /* auto approx position */
     int halfcyc;        /* half cycle correction */
     int sep_nav;        /* separated nav files */
+    int nthread;        /* number of threads to decode input files (0,1:off) */
+    int crinex;         /* output compact rinex obs (hatanaka) (0:off,1:on) */
+    int gzip;           /* compress output files by gzip (0:off,1:on) */
+    crx_t *crx;         /* compact rinex encoder (NULL: plain rinex output) */
     gtime_t tstart;     /* first obs time */
     gtime_t tend;       /* last obs time */
     gtime_t trtcm;      /* approx log start time for rtcm */
@@ -1262,6 +1380,23 @@ typedef struct {        /* RTK control/result type */
     int initial_mode;   /* initial positioning mode */
 } rtk_t;
 
+typedef struct {        /* batch static solution type */
+    int nx,nxmax;       /* number of parameters/allocated (pos+ambiguity arcs) */
+    int na;             /* number of ambiguity arcs of previous pass */
+    int ne,nv,nc;       /* number of epochs/observations/clock parameters */
+    int nrej;           /* number of rejected observations */
+    int pass;           /* number of passes done */
+    gtime_t ts,te;      /* first/last epoch time */
+    double tint;        /* observation interval (s) */
+    double x0[3];       /* rover position of linearization point (ecef) (m) */
+    double *N,*b;       /* normal matrix and vector {nxmax x nxmax,nxmax} */
+    double ll;          /* reduced weighted square sum of observations */
+    double *amb;        /* approximate ambiguities of arcs (cycle) */
+    int *sat,*frq,*nep; /* satellite/frequency/number of epochs of arcs */
+    int arc[MAXSAT][NFREQ]; /* current arc index of satellite/frequency (-1:none) */
+    gtime_t pt[MAXSAT][NFREQ]; /* last time of arcs */
+} batch_t;
+
 typedef struct half_cyc_tag {  /* half-cycle correction list type */
     unsigned char sat;  /* satellite number */
     unsigned char freq; /* frequency number (0:L1,1:L2,2:L5) */
@@ -1271,9 +1406,18 @@ typedef struct half_cyc_tag {  /* half-cycle correction list type */
     struct half_cyc_tag *next; /* pointer to next correction */
 } half_cyc_t;
 
+typedef struct {        /* receiver raw data per-satellite state type */
+    gtime_t tobs[NFREQ+NEXOBS]; /* observation data time */
+    double lockt[NFREQ+NEXOBS]; /* lock time (s) */
+    unsigned char lockflag[NFREQ+NEXOBS]; /* used for carrying forward cycle slip */
+    unsigned char halfc[NFREQ+NEXOBS]; /* half-cycle add flag */
+    double prCA,dpCA;   /* L1/CA pseudrange/doppler for javad */
+    unsigned char locksig[32]; /* lock time per signal type for septentrio */
+    unsigned char subfrm[380]; /* subframe buffer */
+} rawsat_t;
+
 typedef struct {        /* receiver raw data control type */
     gtime_t time;       /* message time */
-    gtime_t tobs[MAXSAT][NFREQ+NEXOBS]; /* observation data time */
     obs_t obs;          /* observation data */
     obs_t obuf;         /* observation data buffer */
     nav_t nav;          /* satellite ephemerides */
@@ -1281,13 +1425,9 @@ typedef struct {        /* receiver raw data control type */
     int ephsat;         /* sat number of update ephemeris (0:no satellite) */
     sbsmsg_t sbsmsg;    /* SBAS message */
     char msgtype[256];  /* last message type */
-    unsigned char subfrm[MAXSAT][380];  /* subframe buffer */
     lexmsg_t lexmsg;    /* LEX message */
-    double lockt[MAXSAT][NFREQ+NEXOBS]; /* lock time (s) */
-    unsigned char lockflag[MAXSAT][NFREQ+NEXOBS]; /* used for carrying forward cycle slip */
-    double icpp[MAXSAT],off[MAXSAT],icpc; /* carrier params for ss2 */
-    double prCA[MAXSAT],dpCA[MAXSAT]; /* L1/CA pseudrange/doppler for javad */
-    unsigned char halfc[MAXSAT][NFREQ+NEXOBS]; /* half-cycle add flag */
+    rawsat_t *sats[MAXSAT]; /* per-satellite states (NULL:not active) */
+    rawsat_t sat0;      /* state for invalid sat or allocation error */
     char freqn[MAXOBS]; /* frequency number for javad */
     int nbyte;          /* number of bytes in message buffer */ 
     int len;            /* message length (bytes) */
@@ -1298,7 +1438,9 @@ typedef struct {        /* receiver raw data control type */
     int outtype;        /* output message type */
     unsigned char buff[MAXRAWLEN]; /* message buffer */
     char opt[256];      /* receiver dependent options */
+    codepri_t codepri;  /* code priority table for options */
     half_cyc_t *half_cyc; /* half-cycle correction list */
+    decsink_t sink;     /* event sink of decoded data */
     
     int format;         /* receiver stream format */
     void *rcv_data;     /* receiver dependent data */
@@ -1331,8 +1473,16 @@ typedef struct {        /* stream converter type */
     rtcm_t rtcm;        /* rtcm input data buffer */
     raw_t raw;          /* raw  input data buffer */
     rtcm_t out;         /* rtcm output data buffer */
+    unsigned int nobs,nnav,nerr; /* input obs/nav/error message counts */
 } strconv_t;
 
+typedef struct {        /* thread options type */
+    char name[16];      /* thread name ("":no name) */
+    int cpu;            /* cpu affinity (-1:any cpu) */
+    int policy;         /* scheduling policy (THRDPOL_???) */
+    int prio;           /* real-time priority (1-99) */
+} thrdopt_t;
+
 typedef struct {        /* stream server type */
     int state;          /* server state (0:stop,1:running) */
     int cycle;          /* server cycle (ms) */
@@ -1348,10 +1498,39 @@ typedef struct {        /* stream server type */
     unsigned int tick;  /* start tick */
     stream_t stream[16]; /* input/output streams */
     strconv_t *conv[16]; /* stream converter */
+    unsigned int ncycle; /* number of server cycles */
+    unsigned int novr;  /* number of cycles over cycle time */
+    unsigned int nfull; /* number of reads filling input buffer */
+    int cputime;        /* CPU time (ms) for a server cycle */
+    unsigned int njit;  /* number of samples of cycle jitter */
+    double jitsum;      /* sum of cycle jitter (us) */
+    int jitmax;         /* max cycle jitter (us) */
+    thrdopt_t thopt;    /* server thread options */
     thread_t thread;    /* server thread */
     lock_t lock;        /* lock flag */
 } strsvr_t;
 
+typedef struct {        /* metrics buffer type */
+    int fmt;            /* format (METF_???) */
+    char *buff;         /* output buffer */
+    int n,nmax;         /* length and size of output buffer (bytes) */
+    int nmet;           /* number of metrics */
+    char name[64];      /* name of last metric */
+} metbuf_t;
+
+typedef int (*metfunc_t)(int fmt, char *buff, int nmax, void *arg);
+
+typedef struct {        /* metrics server type */
+    int state;          /* server state (0:stop,1:running) */
+    char addr[64];      /* bind address */
+    int port;           /* port number */
+    unsigned int nreq;  /* number of served requests */
+    metfunc_t func;     /* metrics output function */
+    void *arg;          /* argument of metrics output function */
+    void *svr;          /* metrics server control struct */
+    thread_t thread;    /* server thread */
+} metsvr_t;
+
 typedef struct {        /* RTK server type */
     int state;          /* server state (0:stop,1:running) */
     int cycle;          /* processing cycle (ms) */
@@ -1377,15 +1556,26 @@ typedef struct {        /* RTK server type */
     rtcm_t rtcm[3];     /* RTCM control {rov,base,corr} */
     gtime_t ftime[3];   /* download time {rov,base,corr} */
     char files[3][MAXSTRPATH]; /* download paths {rov,base,corr} */
-    obs_t obs[3][MAXOBSBUF]; /* observation data {rov,base,corr} */
+    obsring_t obsr[3];  /* observation epoch rings {rov,base,corr} */
+    int obsc[3];        /* current epoch held in rings {rov,base,corr} */
+    volatile unsigned int obsw[3]; /* epochs in rings by decoder cycles */
     nav_t nav;          /* navigation data */
     sbsmsg_t sbsmsg[MAXSBSMSG]; /* SBAS message buffer */
     stream_t stream[8]; /* streams {rov,base,corr,sol1,sol2,logr,logb,logc} */
     stream_t *moni;     /* monitor stream */
     unsigned int tick;  /* start tick */
     thread_t thread;    /* server thread */
+    thread_t dthread;   /* decoder thread */
     int cputime;        /* CPU time (ms) for a processing cycle */
     int prcout;         /* missing observation data count */
+    unsigned int nepoch; /* number of processed rover epochs */
+    unsigned int nsolq[MAXSOLQ+1]; /* number of solutions by quality */
+    unsigned int dlysum; /* sum of solution delay from cycle start (ms) */
+    int dlymax;         /* max solution delay from cycle start (ms) */
+    unsigned int njit;  /* number of samples of cycle jitter */
+    double jitsum;      /* sum of cycle jitter (us) */
+    int jitmax;         /* max cycle jitter (us) */
+    thrdopt_t thopt;    /* server thread options */
     int nave;           /* number of averaging base pos */
     double rb_ave[3];   /* averaging base pos */
     char cmds_periodic[3][MAXRCVCMD]; /* periodic commands */
@@ -1438,6 +1628,14 @@ typedef struct {        /* imu type */
     unsigned char buff[256]; /* imu data buffer */
 } imu_t;
 
+typedef struct {        /* line buffer type */
+    FILE *fp;           /* file pointer */
+    char *buff;         /* read buffer */
+    int nmax;           /* buffer size (bytes) */
+    int n,p;            /* data length, position of next line */
+    int eof;            /* end of file flag */
+} lnbuf_t;
+
 typedef void fatalfunc_t(const char *); /* fatal callback function type */
 
 /* global variables ----------------------------------------------------------*/
@@ -1463,6 +1661,8 @@ EXPORT int  testsnr(int base, int freq, double el, double snr,
                     const snrmask_t *mask);
 EXPORT void setcodepri(int sys, int freq, const char *pri);
 EXPORT int  getcodepri(int sys, unsigned char code, const char *opt);
+EXPORT void updcodepri(codepri_t *tbl, const char *opt);
+EXPORT int  tblcodepri(const codepri_t *tbl, int sys, unsigned char code);
 
 /* matrix and vector functions -----------------------------------------------*/
 EXPORT double *mat  (int n, int m);
@@ -1493,6 +1693,10 @@ EXPORT void add_fatal(fatalfunc_t *func);
 /* time and string functions -------------------------------------------------*/
 EXPORT double  str2num(const char *s, int i, int n);
 EXPORT int     str2time(const char *s, int i, int n, gtime_t *t);
+EXPORT int     str2dec (const char *s, int n, double *value);
+EXPORT int     initlnbuf(lnbuf_t *lb, FILE *fp, int nmax);
+EXPORT void    freelnbuf(lnbuf_t *lb);
+EXPORT char   *getlnbuf (lnbuf_t *lb);
 EXPORT void    time2str(gtime_t t, char *str, int n);
 EXPORT gtime_t epoch2time(const double *ep);
 EXPORT void    time2epoch(gtime_t t, double *ep);
@@ -1518,7 +1722,9 @@ EXPORT int read_leaps(const char *file);
 
 EXPORT int adjgpsweek(int week);
 EXPORT unsigned int tickget(void);
+EXPORT unsigned int tickgetus(void);
 EXPORT void sleepms(int ms);
+EXPORT int setthrdopt(const thrdopt_t *opt);
 
 EXPORT int reppath(const char *path, char *rpath, gtime_t time, const char *rov,
                    const char *base);
@@ -1545,7 +1751,15 @@ EXPORT int  screent(gtime_t time, gtime_t ts, gtime_t te, double tint);
 EXPORT int  readnav(const char *file, nav_t *nav);
 EXPORT int  savenav(const char *file, const nav_t *nav);
 EXPORT void freeobs(obs_t *obs);
+EXPORT int  initobsring(obsring_t *ring, int nslot, int nobs);
+EXPORT void freeobsring(obsring_t *ring);
+EXPORT obs_t *obsringslot(obsring_t *ring);
+EXPORT void obsringcommit(obsring_t *ring);
+EXPORT int  obsringcount(const obsring_t *ring);
+EXPORT obs_t *obsringpeek(obsring_t *ring, int i);
+EXPORT void obsringrelease(obsring_t *ring, int n);
 EXPORT void freenav(nav_t *nav, int opt);
+EXPORT int  allocnav(nav_t *nav, int opt);
 EXPORT int  readblq(const char *file, const char *sta, double *odisp);
 EXPORT int  readerp(const char *file, erp_t *erp);
 EXPORT int  geterp (const erp_t *erp, gtime_t time, double *val);
@@ -1598,6 +1812,7 @@ EXPORT int tropcorr(gtime_t time, const nav_t *nav, const double *pos,
 
 /* antenna models ------------------------------------------------------------*/
 EXPORT int  readpcv(const char *file, pcvs_t *pcvs);
+EXPORT void freepcv(pcvs_t *pcvs);
 EXPORT pcv_t *searchpcv(int sat, const char *type, gtime_t time,
                         const pcvs_t *pcvs);
 EXPORT void antmodel(const pcv_t *pcv, const double *del, const double *azel,
@@ -1629,6 +1844,7 @@ EXPORT int readrnxt(const char *file, int rcv, gtime_t ts, gtime_t te,
 EXPORT int readrnxc(const char *file, nav_t *nav);
 EXPORT int outrnxobsh(FILE *fp, const rnxopt_t *opt, const nav_t *nav);
 EXPORT int outrnxobsb(FILE *fp, const rnxopt_t *opt, const obsd_t *obsd, int n, int flag);
+EXPORT int outrnxobsr(FILE *fp, const rnxopt_t *opt, const char *buff, int n);
 EXPORT int outrnxnavh (FILE *fp, const rnxopt_t *opt, const nav_t *nav);
 EXPORT int outrnxgnavh(FILE *fp, const rnxopt_t *opt, const nav_t *nav);
 EXPORT int outrnxhnavh(FILE *fp, const rnxopt_t *opt, const nav_t *nav);
@@ -1640,11 +1856,15 @@ EXPORT int outrnxnavb (FILE *fp, const rnxopt_t *opt, const eph_t *eph);
 EXPORT int outrnxgnavb(FILE *fp, const rnxopt_t *opt, const geph_t *geph);
 EXPORT int outrnxhnavb(FILE *fp, const rnxopt_t *opt, const seph_t *seph);
 EXPORT int rtk_uncompress(const char *file, char *uncfile);
+EXPORT int rtk_compress(const char *file, char *cmpfile);
 EXPORT int convrnx(int format, rnxopt_t *opt, const char *file, char **ofile);
 EXPORT int  init_rnxctr (rnxctr_t *rnx);
 EXPORT void free_rnxctr (rnxctr_t *rnx);
 EXPORT int  open_rnxctr (rnxctr_t *rnx, FILE *fp);
 EXPORT int  input_rnxctr(rnxctr_t *rnx, FILE *fp);
+EXPORT int  init_crx  (crx_t *crx, const rnxopt_t *opt);
+EXPORT void free_crx  (crx_t *crx);
+EXPORT int  outcrxobs (crx_t *crx, FILE *fp, const char *buff, int n);
 
 /* ephemeris and clock functions ---------------------------------------------*/
 EXPORT double eph2clk (gtime_t time, const eph_t  *eph);
@@ -1682,6 +1902,14 @@ EXPORT int tle_pos(gtime_t time, const char *name, const char *satno,
                    const char *desig, const tle_t *tle, const erp_t *erp,
                    double *rs);
 
+/* observation qc functions --------------------------------------------------*/
+EXPORT void initqc (qc_t *qc);
+EXPORT int  inputqc(qc_t *qc, const obsd_t *obs, int n, const nav_t *nav,
+                    double *mp);
+EXPORT int  obsqc  (qc_t *qc, const obs_t *obs, const nav_t *nav, double **mp);
+EXPORT void closeqc(qc_t *qc);
+EXPORT int  outqc  (FILE *fp, const qc_t *qc);
+
 /* receiver raw data functions -----------------------------------------------*/
 EXPORT unsigned int getbitu(const unsigned char *buff, int pos, int len);
 EXPORT int          getbits(const unsigned char *buff, int pos, int len);
@@ -1701,6 +1929,7 @@ EXPORT int decode_gal_inav(const unsigned char *buff, eph_t *eph);
 
 EXPORT int init_raw   (raw_t *raw, int format);
 EXPORT void free_raw  (raw_t *raw);
+EXPORT rawsat_t *rawsat(raw_t *raw, int sat);
 EXPORT int input_raw  (raw_t *raw, int format, unsigned char data);
 EXPORT int input_rawf (raw_t *raw, int format, FILE *fp);
 
@@ -1751,6 +1980,8 @@ EXPORT int init_rtcm   (rtcm_t *rtcm);
 EXPORT void free_rtcm  (rtcm_t *rtcm);
 EXPORT int input_rtcm2 (rtcm_t *rtcm, unsigned char data);
 EXPORT int input_rtcm3 (rtcm_t *rtcm, unsigned char data);
+EXPORT int input_rtcm3b(rtcm_t *rtcm, const unsigned char *buff, int n,
+                         int *pos);
 EXPORT int input_rtcm2f(rtcm_t *rtcm, FILE *fp);
 EXPORT int input_rtcm3f(rtcm_t *rtcm, FILE *fp);
 EXPORT int gen_rtcm2   (rtcm_t *rtcm, int type, int sync);
@@ -1768,6 +1999,7 @@ EXPORT int readsolt(char *files[], int nfile, gtime_t ts, gtime_t te,
 EXPORT int readsolstat(char *files[], int nfile, solstatbuf_t *statbuf);
 EXPORT int readsolstatt(char *files[], int nfile, gtime_t ts, gtime_t te,
                         double tint, solstatbuf_t *statbuf);
+EXPORT int convsolstat(const char *infile, const char *outfile);
 EXPORT int inputsol(unsigned char data, gtime_t ts, gtime_t te, double tint,
                     int qflag, const solopt_t *opt, solbuf_t *solbuf);
 
@@ -1845,9 +2077,20 @@ EXPORT int  strgetsel(stream_t *stream, char *sel);
 EXPORT int  strsetsel(stream_t *stream, const char *sel);
 EXPORT int  strsetsrctbl(stream_t *stream, const char *file);
 EXPORT void strsetopt(const int *opt);
+EXPORT void strsetthrd(const thrdopt_t *opt);
 EXPORT gtime_t strgettime(stream_t *stream);
 EXPORT void strsendnmea(stream_t *stream, const sol_t *sol);
 EXPORT void strsendcmd(stream_t *stream, const char *cmd);
+
+EXPORT void metinit (metbuf_t *met, int fmt, char *buff, int nmax);
+EXPORT void metadd  (metbuf_t *met, const char *name, const char *type,
+                     const char *help, const char *label, double value);
+EXPORT int  metclose(metbuf_t *met);
+EXPORT void strmetric(metbuf_t *met, stream_t *stream, const char **name,
+                      int n);
+EXPORT int  metsvrstart(metsvr_t *svr, const char *path, metfunc_t func,
+                         void *arg);
+EXPORT void metsvrstop (metsvr_t *svr);
 EXPORT void strsettimeout(stream_t *stream, int toinact, int tirecon);
 EXPORT void strsetdir(const char *dir);
 EXPORT void strsetproxy(const char *addr);
@@ -1869,8 +2112,17 @@ EXPORT void rtkinit(rtk_t *rtk, const prcopt_t *opt);
 EXPORT void rtkfree(rtk_t *rtk);
 EXPORT int  rtkpos (rtk_t *rtk, const obsd_t *obs, int nobs, const nav_t *nav);
 EXPORT int  rtkopenstat(const char *file, int level);
+EXPORT int  rtkopenstatf(const char *file, int level, int format);
 EXPORT void rtkclosestat(void);
 EXPORT int  rtkoutstat(rtk_t *rtk, char *buff);
+EXPORT int  rtkoutstatb(rtk_t *rtk, const nav_t *nav, int level,
+                        unsigned char *buff);
+
+EXPORT void batchinit(batch_t *bat);
+EXPORT void batchfree(batch_t *bat);
+EXPORT int  batchpos (rtk_t *rtk, batch_t *bat, const obsd_t *obs, int n,
+                      const nav_t *nav);
+EXPORT int  batchsol (rtk_t *rtk, batch_t *bat, int ar);
 
 /* precise point positioning -------------------------------------------------*/
 EXPORT void pppos(rtk_t *rtk, const obsd_t *obs, int n, const nav_t *nav);
@@ -1905,6 +2157,7 @@ EXPORT strconv_t *strconvnew(int itype, int otype, const char *msgs, int staid,
                              int stasel, const char *opt);
 EXPORT void strconvfree(strconv_t *conv);
 EXPORT void strsvrsetsrctbl(strsvr_t *svr, const char *file);
+EXPORT int  strsvrmetric(strsvr_t *svr, int fmt, char *buff, int nmax);
 
 /* rtk server functions ------------------------------------------------------*/
 EXPORT int  rtksvrinit  (rtksvr_t *svr);
@@ -1920,10 +2173,12 @@ EXPORT int  rtksvropenstr(rtksvr_t *svr, int index, int str, const char *path,
 EXPORT void rtksvrclosestr(rtksvr_t *svr, int index);
 EXPORT void rtksvrlock  (rtksvr_t *svr);
 EXPORT void rtksvrunlock(rtksvr_t *svr);
+EXPORT obs_t *rtksvrobs (rtksvr_t *svr, int index);
 EXPORT int  rtksvrostat (rtksvr_t *svr, int type, gtime_t *time, int *sat,
                          double *az, double *el, int **snr, int *vsat);
 EXPORT void rtksvrsstat (rtksvr_t *svr, int *sstat, char *msg);
 EXPORT int  rtksvrmark(rtksvr_t *svr, const char *name, const char *comment);
+EXPORT int  rtksvrmetric(rtksvr_t *svr, int fmt, char *buff, int nmax);
 
 /* downloader functions ------------------------------------------------------*/
 EXPORT int dl_readurls(const char *file, char **types, int ntype, url_t *urls,
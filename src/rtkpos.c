@@ -41,6 +41,11 @@
 *           2016/08/20 1.22 fix bug on ddres() function
 *           2018/10/10 1.13 support api change of satexclude()
 *           2018/12/15 1.14 disable ambiguity resolution for gps-qzss
+*           2026/10/17 1.15 add binary solution status output
+*                           add api rtkopenstatf(),rtkoutstatb()
+*                           add batch static solution
+*                           add api batchinit(),batchfree(),batchpos(),
+*                               batchsol()
 *-----------------------------------------------------------------------------*/
 #include <stdarg.h>
 #include "rtklib.h"
@@ -64,6 +69,15 @@
 
 #define TTOL_MOVEB  (1.0+2*DTTOL)
                              /* time sync tolerance for moving-baseline (s) */
+#define MINARC_BATCH 10      /* min epochs of arc to fix ambiguity in batch */
+
+#define STATB_SYNC1 0xB5     /* binary solution status sync code 1 */
+#define STATB_SYNC2 0x53     /* binary solution status sync code 2 */
+#define STATB_EPOCH 1        /* binary solution status frame type: epoch */
+#define STATB_INDEX 2        /* binary solution status frame type: index */
+#define STATB_HLEN  24       /* binary solution status header length (bytes) */
+#define STATB_RLEN  60       /* binary solution status record length (bytes) */
+#define STATB_NBLK  256      /* number of epochs per index block */
 
 /* number of parameters (pos,ionos,tropos,hw-bias,phase-bias,real,estimated) */
 #define NF(opt)     ((opt)->ionoopt==IONOOPT_IFLC?1:(opt)->nf)
@@ -104,11 +118,25 @@ static int statlevel=0;          /* rtk status output level (0:off) */
 static FILE *fp_stat=NULL;       /* rtk status file pointer */
 static char file_stat[1024]="";  /* rtk status file original path */
 static gtime_t time_stat={0};    /* rtk status file time */
+static int statformat=0;         /* rtk status file format (0:text,1:binary) */
+static double nb_stat=0.0;       /* rtk status file length (bytes) */
+static double *idx_stat=NULL;    /* rtk status epoch index {tmin,tmax,offset} */
+static int nidx_stat=0,nidxmax_stat=0; /* number of index blocks/allocated */
+static int ne_stat=0;            /* number of epochs in last index block */
+
+/* set fields (little-endian) ------------------------------------------------*/
+static void setU1(unsigned char *p, unsigned char  u) {*p=u;}
+static void setU2(unsigned char *p, unsigned short u) {memcpy(p,&u,2);}
+static void setU4(unsigned char *p, unsigned int   u) {memcpy(p,&u,4);}
+static void setI4(unsigned char *p, int            i) {memcpy(p,&i,4);}
+static void setR4(unsigned char *p, float          r) {memcpy(p,&r,4);}
+static void setR8(unsigned char *p, double         r) {memcpy(p,&r,8);}
 
 /* open solution status file ---------------------------------------------------
 * open solution status file and set output level
 * args   : char     *file   I   rtk status file
 *          int      level   I   rtk status level (0: off)
+*          int      format  I   rtk status format (0:text,1:binary)
 * return : status (1:ok,0:error)
 * notes  : file can constain time keywords (%Y,%y,%m...) defined in reppath().
 *          The time to replace keywords is based on UTC of CPU time.
@@ -178,27 +206,96 @@ static gtime_t time_stat={0};    /* rtk status file time */
 *          bias_var : variance of phase bias
 *          lambda   : wavelength
 *
+*          binary solution status format (format=1) is a sequence of frames
+*          with little-endian fields. an epoch frame contains the records
+*          above except $SAT as text and the $SAT records in binary:
+*
+*          header (24 bytes):
+*            0 U1 sync 0xB5        1 U1 sync 0x53 ('S')
+*            2 U1 type (1:epoch,2:index)
+*            3 U1 solution status  4 U4 body length (bytes)
+*            8 U2 gps week        10 U2 number of $SAT records
+*           12 R8 time of week (s)
+*           20 U2 length of text records
+*           22 U2 reserved
+*          body: text records followed by $SAT records (60 bytes each):
+*            0 U1 sat    1 U1 frq    2 U1 flag (vsat<<5)+(slip<<3)+fix
+*            3 U1 snr (0.25 dBHz)    4 R4 az (rad)   8 R4 el (rad)
+*           12 R4 resp  16 R4 resc  20 I4 lock      24 U4 outc
+*           28 U4 slipc 32 U4 rejc  36 R8 bias      44 R8 bias_var
+*           52 R4 lambda            56 R4 icbias
+*          crc (3 bytes): CRC-24Q of header and body
+*
+*          on close, an index frame and a trailer are appended to the file.
+*          the body of the index frame contains blocks of every 256 epochs
+*          as {R8 tmin,R8 tmax,U4 offset-low,U4 offset-high} with tmin/tmax
+*          as week*604800+tow (s) and the file offset of the first epoch
+*          frame of the block. the trailer (12 bytes) is {U4 offset-low,
+*          U4 offset-high,"STBX"} with the offset of the index frame.
 *-----------------------------------------------------------------------------*/
-extern int rtkopenstat(const char *file, int level)
+extern int rtkopenstatf(const char *file, int level, int format)
 {
     gtime_t time=utc2gpst(timeget());
     char path[1024];
     
-    trace(3,"rtkopenstat: file=%s level=%d\n",file,level);
+    trace(3,"rtkopenstatf: file=%s level=%d format=%d\n",file,level,format);
     
     if (level<=0) return 0;
     
     reppath(file,path,time,"","");
     
-    if (!(fp_stat=fopen(path,"w"))) {
-        trace(1,"rtkopenstat: file open error path=%s\n",path);
+    if (!(fp_stat=fopen(path,format?"wb":"w"))) {
+        trace(1,"rtkopenstatf: file open error path=%s\n",path);
         return 0;
     }
     strcpy(file_stat,file);
     time_stat=time;
     statlevel=level;
+    statformat=format;
+    nb_stat=0.0;
+    nidx_stat=ne_stat=0;
+    if (nidxmax_stat<0) nidxmax_stat=0;
     return 1;
 }
+extern int rtkopenstat(const char *file, int level)
+{
+    return rtkopenstatf(file,level,0);
+}
+/* write epoch index of binary solution status -------------------------------*/
+static void outstatidx(void)
+{
+    unsigned char *buff,*p;
+    unsigned int crc,hi;
+    int i,n=STATB_HLEN+nidx_stat*24;
+    
+    trace(3,"outstatidx: nidx=%d\n",nidx_stat);
+    
+    if (nidxmax_stat<0) return;
+    
+    if (!(buff=(unsigned char *)calloc(n+15,1))) return;
+    
+    buff[0]=STATB_SYNC1; buff[1]=STATB_SYNC2; buff[2]=STATB_INDEX;
+    setU4(buff+4,(unsigned int)(n-STATB_HLEN));
+    
+    for (i=0,p=buff+STATB_HLEN;i<nidx_stat;i++,p+=24) {
+        hi=(unsigned int)(idx_stat[i*3+2]/4294967296.0);
+        setR8(p   ,idx_stat[i*3  ]);
+        setR8(p+ 8,idx_stat[i*3+1]);
+        setU4(p+16,(unsigned int)(idx_stat[i*3+2]-hi*4294967296.0));
+        setU4(p+20,hi);
+    }
+    crc=rtk_crc24q(buff,n);
+    setbitu(buff+n,0,24,crc); n+=3;
+    
+    /* trailer */
+    hi=(unsigned int)(nb_stat/4294967296.0);
+    setU4(buff+n  ,(unsigned int)(nb_stat-hi*4294967296.0));
+    setU4(buff+n+4,hi);
+    memcpy(buff+n+8,"STBX",4); n+=12;
+    
+    fwrite(buff,1,n,fp_stat);
+    free(buff);
+}
 /* close solution status file --------------------------------------------------
 * close solution status file
 * args   : none
@@ -208,10 +305,15 @@ extern void rtkclosestat(void)
 {
     trace(3,"rtkclosestat:\n");
     
-    if (fp_stat) fclose(fp_stat);
+    if (fp_stat) {
+        if (statformat) outstatidx();
+        fclose(fp_stat);
+    }
     fp_stat=NULL;
     file_stat[0]='\0';
-    statlevel=0;
+    statlevel=statformat=0;
+    free(idx_stat); idx_stat=NULL;
+    nidx_stat=nidxmax_stat=ne_stat=0;
 }
 /* write solution status to buffer -------------------------------------------*/
 extern int rtkoutstat(rtk_t *rtk, char *buff)
@@ -300,6 +402,105 @@ extern int rtkoutstat(rtk_t *rtk, char *buff)
     }
     return (int)(p-buff);
 }
+/* write binary solution status to buffer --------------------------------------
+* write solution status to buffer as an epoch frame of binary solution status
+* args   : rtk_t    *rtk    I   rtk control/result struct
+*          nav_t    *nav    I   navigation data
+*          int      level   I   rtk status level (1:states,2:residuals)
+*          unsigned char *buff O epoch frame (MAXSOLSTATB bytes)
+* return : length of epoch frame (bytes) (0: no solution)
+* notes  : see rtkopenstat() for the frame format
+*-----------------------------------------------------------------------------*/
+extern int rtkoutstatb(rtk_t *rtk, const nav_t *nav, int level,
+                       unsigned char *buff)
+{
+    ssat_t *ssat;
+    unsigned char *p=buff+STATB_HLEN;
+    double tow;
+    int i,j,k,n,week,nrec=0,nfreq,nf=NF(&rtk->opt),dgps;
+    
+    if (rtk->sol.stat<=SOLQ_NONE) {
+        return 0;
+    }
+    tow=time2gpst(rtk->sol.time,&week);
+    
+    /* states as text */
+    n=rtkoutstat(rtk,(char *)p);
+    p+=n;
+    
+    /* residuals and status */
+    if (level>=2) {
+        nfreq=rtk->opt.mode>=PMODE_DGPS?nf:1;
+        dgps=rtk->opt.mode<=PMODE_DGPS?1:0;
+        for (i=0;i<MAXSAT;i++) {
+            ssat=rtk->ssat+i;
+            if (!ssat->vs) continue;
+            for (j=0;j<nfreq;j++,p+=STATB_RLEN,nrec++) {
+                k=IB(i+1,j,&rtk->opt);
+                setU1(p   ,(unsigned char)(i+1));
+                setU1(p+ 1,(unsigned char)(j+1));
+                setU1(p+ 2,(unsigned char)((ssat->vsat[j]<<5)+
+                                           ((ssat->slip[j]&3)<<3)+ssat->fix[j]));
+                setU1(p+ 3,ssat->snr_rover[j]);
+                setR4(p+ 4,(float)ssat->azel[0]);
+                setR4(p+ 8,(float)ssat->azel[1]);
+                setR4(p+12,(float)ssat->resp[j]);
+                setR4(p+16,(float)ssat->resc[j]);
+                setI4(p+20,ssat->lock[j]);
+                setU4(p+24,ssat->outc[j]);
+                setU4(p+28,ssat->slipc[j]);
+                setU4(p+32,ssat->rejc[j]);
+                setR8(p+36,dgps?0.0:rtk->x[k]);
+                setR8(p+44,dgps?0.0:rtk->P[k+k*rtk->nx]);
+                setR4(p+52,(float)nav->lam[i][j]);
+                setR4(p+56,(float)ssat->icbias[j]);
+            }
+        }
+    }
+    buff[0]=STATB_SYNC1; buff[1]=STATB_SYNC2; buff[2]=STATB_EPOCH;
+    setU1(buff+ 3,rtk->sol.stat);
+    setU4(buff+ 4,(unsigned int)(p-buff-STATB_HLEN));
+    setU2(buff+ 8,(unsigned short)week);
+    setU2(buff+10,(unsigned short)nrec);
+    setR8(buff+12,tow);
+    setU2(buff+20,(unsigned short)n);
+    setU2(buff+22,0);
+    n=(int)(p-buff);
+    setbitu(buff+n,0,24,rtk_crc24q(buff,n));
+    return n+3;
+}
+/* write epoch frame to binary solution status file --------------------------*/
+static void outstatb(const unsigned char *buff, int n, gtime_t time)
+{
+    double t,*idx;
+    int week;
+    
+    t=time2gpst(time,&week)+week*604800.0;
+    
+    /* add index block every STATB_NBLK epochs (nidxmax_stat<0: no index) */
+    if (ne_stat<=0&&nidx_stat>=nidxmax_stat&&nidxmax_stat>=0) {
+        nidxmax_stat=nidxmax_stat<=0?256:nidxmax_stat*2;
+        if (!(idx=(double *)realloc(idx_stat,sizeof(double)*3*nidxmax_stat))) {
+            trace(1,"outstatb: memory allocation error\n");
+            free(idx_stat); idx_stat=NULL; nidx_stat=0; nidxmax_stat=-1;
+        }
+        else idx_stat=idx;
+    }
+    if (nidxmax_stat>0) {
+        if (ne_stat<=0) {
+            idx=idx_stat+3*nidx_stat++;
+            idx[0]=idx[1]=t;
+            idx[2]=nb_stat;
+        }
+        else {
+            idx=idx_stat+3*(nidx_stat-1);
+            if (t<idx[0]) idx[0]=t;
+            if (t>idx[1]) idx[1]=t;
+        }
+        if (++ne_stat>=STATB_NBLK) ne_stat=0;
+    }
+    nb_stat+=fwrite(buff,1,n,fp_stat);
+}
 /* swap solution status file -------------------------------------------------*/
 static void swapsolstat(void)
 {
@@ -315,9 +516,15 @@ static void swapsolstat(void)
     if (!reppath(file_stat,path,time,"","")) {
         return;
     }
-    if (fp_stat) fclose(fp_stat);
+    if (fp_stat) {
+        if (statformat) outstatidx();
+        fclose(fp_stat);
+    }
+    nb_stat=0.0;
+    nidx_stat=ne_stat=0;
+    if (nidxmax_stat<0) nidxmax_stat=0;
     
-    if (!(fp_stat=fopen(path,"w"))) {
+    if (!(fp_stat=fopen(path,statformat?"wb":"w"))) {
         trace(2,"swapsolstat: file open error path=%s\n",path);
         return;
     }
@@ -328,6 +535,7 @@ static void outsolstat(rtk_t *rtk,const nav_t *nav)
 {
     ssat_t *ssat;
     double tow;
+    unsigned char *buffb;
     char buff[MAXSOLMSG+1],id[32];
     int i,j,k,n,week,nfreq,nf=NF(&rtk->opt),dgps;
     
@@ -338,6 +546,17 @@ static void outsolstat(rtk_t *rtk,const nav_t *nav)
     /* swap solution status file */
     swapsolstat();
     
+    if (!fp_stat) return;
+    
+    /* write binary solution status */
+    if (statformat) {
+        if (!(buffb=(unsigned char *)malloc(MAXSOLSTATB))) return;
+        if ((n=rtkoutstatb(rtk,nav,statlevel,buffb))>0) {
+            outstatb(buffb,n,rtk->sol.time);
+        }
+        free(buffb);
+        return;
+    }
     /* write solution status */
     n=rtkoutstat(rtk,buff); buff[n]='\0';
     
@@ -2204,6 +2423,510 @@ static int relpos(rtk_t *rtk, const obsd_t *obs, int nu, int nr,
     
     return stat!=SOLQ_NONE;
 }
+/* system index of receiver clock parameter for batch solution ---------------*/
+static int sysidx(int sys)
+{
+    int i;
+    
+    for (i=0;i<8&&!(sys&(1<<i));i++) ;
+    return i<8?i:0;
+}
+/* expand batch normal equations ---------------------------------------------*/
+static void expandbatch(batch_t *bat, int nx)
+{
+    double *N,*b,*amb;
+    int i,j,nmax,*sat,*frq,*nep;
+    
+    if (nx<=bat->nxmax) return;
+    
+    for (nmax=bat->nxmax<=0?64:bat->nxmax*2;nmax<nx;nmax*=2) ;
+    
+    trace(3,"expandbatch: nxmax=%d->%d\n",bat->nxmax,nmax);
+    
+    N=zeros(nmax,nmax); b=zeros(nmax,1); amb=zeros(nmax,1);
+    sat=imat(nmax,1); frq=imat(nmax,1); nep=imat(nmax,1);
+    
+    for (i=0;i<bat->nxmax;i++) {
+        for (j=0;j<bat->nxmax;j++) N[i+j*nmax]=bat->N[i+j*bat->nxmax];
+        b[i]=bat->b[i]; amb[i]=bat->amb[i];
+        sat[i]=bat->sat[i]; frq[i]=bat->frq[i]; nep[i]=bat->nep[i];
+    }
+    free(bat->N); free(bat->b); free(bat->amb);
+    free(bat->sat); free(bat->frq); free(bat->nep);
+    bat->N=N; bat->b=b; bat->amb=amb;
+    bat->sat=sat; bat->frq=frq; bat->nep=nep;
+    bat->nxmax=nmax;
+}
+/* ambiguity arc of satellite/frequency for batch solution -------------------*/
+static int batcharc(rtk_t *rtk, batch_t *bat, const obsd_t *obs, int iu,
+                    int ir, int f, const nav_t *nav)
+{
+    const double *lam=nav->lam[obs[iu].sat-1];
+    double cp1,cp2,pr1,pr2,C1,C2,bias;
+    int k,sat=obs[iu].sat,slip=rtk->ssat[sat-1].slip[f];
+    
+    if (rtk->opt.ionoopt==IONOOPT_IFLC) slip|=rtk->ssat[sat-1].slip[1];
+    
+    /* continue arc unless cycle slip or outage over max outage count */
+    if ((k=bat->arc[sat-1][f])>=0&&!(slip&1)&&
+        timediff(obs[iu].time,bat->pt[sat-1][f])<=
+        bat->tint*(rtk->opt.maxout+1)+DTTOL) {
+        bat->pt[sat-1][f]=obs[iu].time;
+        bat->nep[k]++;
+        return k;
+    }
+    /* approximate phase-bias by phase - code */
+    if (rtk->opt.ionoopt!=IONOOPT_IFLC) {
+        cp1=sdobs(obs,iu,ir,f);
+        pr1=sdobs(obs,iu,ir,f+NFREQ);
+        if (cp1==0.0||pr1==0.0||lam[f]<=0.0) return -1;
+        bias=cp1-pr1/lam[f];
+    }
+    else {
+        cp1=sdobs(obs,iu,ir,0);
+        cp2=sdobs(obs,iu,ir,1);
+        pr1=sdobs(obs,iu,ir,NFREQ);
+        pr2=sdobs(obs,iu,ir,NFREQ+1);
+        if (cp1==0.0||cp2==0.0||pr1==0.0||pr2==0.0||lam[0]<=0.0||lam[1]<=0.0) {
+            return -1;
+        }
+        C1= SQR(lam[1])/(SQR(lam[1])-SQR(lam[0]));
+        C2=-SQR(lam[0])/(SQR(lam[1])-SQR(lam[0]));
+        bias=(C1*lam[0]*cp1+C2*lam[1]*cp2)-(C1*pr1+C2*pr2);
+    }
+    expandbatch(bat,bat->nx+1);
+    k=bat->nx++-3;
+    
+    /* use float phase-bias of previous pass if same arc */
+    if (k>=bat->na||bat->sat[k]!=sat||bat->frq[k]!=f) bat->amb[k]=bias;
+    bat->sat[k]=sat;
+    bat->frq[k]=f;
+    bat->nep[k]=1;
+    bat->arc[sat-1][f]=k;
+    bat->pt[sat-1][f]=obs[iu].time;
+    
+    trace(3,"batcharc: new arc k=%d sat=%3d L%d bias=%.3f\n",k,sat,f+1,
+          bat->amb[k]);
+    return k;
+}
+/* reject outliers of single-differenced residuals by clock group ------------*/
+static void rejbatch(rtk_t *rtk, batch_t *bat, const double *v, double *w,
+                     const int *ic, int nv)
+{
+    double sw,swv,dv,dvmax;
+    int i,c,imax,nc=8*NF(&rtk->opt)*2;
+    
+    for (c=0;c<nc;c++) {
+        do {
+            for (i=0,sw=swv=0.0;i<nv;i++) {
+                if (ic[i]!=c||w[i]<=0.0) continue;
+                sw+=w[i]; swv+=w[i]*v[i];
+            }
+            if (sw<=0.0) break;
+            for (i=0,imax=-1,dvmax=0.0;i<nv;i++) {
+                if (ic[i]!=c||w[i]<=0.0) continue;
+                if ((dv=fabs(v[i]-swv/sw))>dvmax) {dvmax=dv; imax=i;}
+            }
+            if (imax<0||dvmax<=rtk->opt.maxinno) break;
+            
+            errmsg(rtk,"outlier rejected (clk=%d v=%.3f)\n",c,dvmax);
+            w[imax]=0.0;
+            bat->nrej++;
+        } while (1);
+    }
+}
+/* initialize batch static solution --------------------------------------------
+* initialize batch static solution struct
+* args   : batch_t *bat     O   batch static solution struct
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void batchinit(batch_t *bat)
+{
+    batch_t bat0={0};
+    int i,j;
+    
+    trace(3,"batchinit:\n");
+    
+    *bat=bat0;
+    bat->nx=3;
+    for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ;j++) bat->arc[i][j]=-1;
+}
+/* free batch static solution --------------------------------------------------
+* free memory for batch static solution struct
+* args   : batch_t *bat     IO  batch static solution struct
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void batchfree(batch_t *bat)
+{
+    trace(3,"batchfree:\n");
+    
+    free(bat->N  ); bat->N  =NULL;
+    free(bat->b  ); bat->b  =NULL;
+    free(bat->amb); bat->amb=NULL;
+    free(bat->sat); bat->sat=NULL;
+    free(bat->frq); bat->frq=NULL;
+    free(bat->nep); bat->nep=NULL;
+    bat->nx=bat->nxmax=bat->na=0;
+}
+/* accumulate observation data to batch static solution ------------------------
+* accumulate normal equations of single-differenced phase and code for static
+* baseline by an epoch of rover and base station observation data
+* args   : rtk_t   *rtk     IO  rtk control/result struct
+*            rtk->opt       I   processing options
+*            rtk->ssat[s]   IO  sat(s+1) status for cycle slip detection
+*          batch_t *bat     IO  batch static solution struct
+*          obsd_t  *obs     I   observation data for an epoch
+*                               obs[i].rcv=1:rover,2:reference
+*                               sorted by receiver and satellte
+*          int     n        I   number of observation data
+*          nav_t   *nav     I   navigation messages
+* return : status (1:ok,0:no data accumulated)
+* notes  : the parameters are the rover position correction to the linearization
+*          point bat->x0 and the single-differenced phase-biases of ambiguity
+*          arcs (cycle). a new arc is set by cycle slip or by outage over
+*          opt->maxout epochs. the receiver clock parameters of each epoch for
+*          each system, frequency and phase/code are pre-eliminated from the
+*          normal equations, which is equivalent to double-differencing.
+*          the solution time is the rover observation time corrected by the
+*          receiver clock of single point positioning as rtkpos(). as
+*          rtkpos(), an epoch with single point positioning error is used if
+*          opt->dynamics is set.
+*          the linearization point is set by single point positioning at the
+*          first epoch. the ionosphere and troposphere are not estimated.
+*          outliers over opt->maxinno are rejected after the first pass.
+*-----------------------------------------------------------------------------*/
+extern int batchpos(rtk_t *rtk, batch_t *bat, const obsd_t *obs, int n,
+                    const nav_t *nav)
+{
+    prcopt_t *opt=&rtk->opt;
+    gtime_t time=obs[0].time;
+    double *rs,*dts,*var,*y,*e,*azel,*v,*w,*h,*lam,*u,dt,tt,bl,dr[3],hc[3];
+    double ncc,bc;
+    int i,j,k,f,c,p,q,m,nu,nr,ns,nv=0,sys,nf=NF(opt),sat[MAXSAT],iu[MAXSAT];
+    int ir[MAXSAT],svh[MAXOBS*2],*ic,*ia,*ix;
+    char msg[128]="";
+    
+    trace(3,"batchpos: time=%s n=%d\n",time_str(time,3),n);
+    
+    /* count rover/base station observations */
+    for (nu=0;nu   <n&&obs[nu   ].rcv==1;nu++) ;
+    for (nr=0;nu+nr<n&&obs[nu+nr].rcv==2;nr++) ;
+    if (nu<=0||nr<=0) return 0;
+    
+    /* set base station position */
+    if (opt->refpos<=POSOPT_RINEX) {
+        for (i=0;i<6;i++) rtk->rb[i]=i<3?opt->rb[i]:0.0;
+    }
+    if (fabs(dt=timediff(time,obs[nu].time))>opt->maxtdiff) {
+        errmsg(rtk,"age of differential error (age=%.1f)\n",dt);
+        return 0;
+    }
+    /* rover position and solution time by single point positioning */
+    if (!pntpos(obs,nu,nav,opt,&rtk->sol,NULL,NULL,msg)) {
+        errmsg(rtk,"point pos error (%s)\n",msg);
+        
+        if (!opt->dynamics||norm(bat->x0,3)<=0.0) return 0;
+    }
+    /* linearization point at first epoch */
+    if (norm(bat->x0,3)<=0.0) matcpy(bat->x0,rtk->sol.rr,3,1);
+    
+    expandbatch(bat,3);
+    
+    rs=mat(6,n); dts=mat(2,n); var=mat(1,n); y=mat(nf*2,n); e=mat(3,n);
+    azel=zeros(2,n);
+    
+    /* undifferenced residuals of base station and rover */
+    satposs(time,obs,n,nav,opt->sateph,rs,dts,var,svh);
+    
+    if (!zdres(1,obs+nu,nr,rs+nu*6,dts+nu*2,var+nu,svh+nu,nav,rtk->rb,opt,1,
+               y+nu*nf*2,e+nu*3,azel+nu*2)||
+        !zdres(0,obs,nu,rs,dts,var,svh,nav,bat->x0,opt,0,y,e,azel)) {
+        errmsg(rtk,"initial base station or rover position error\n");
+        free(rs); free(dts); free(var); free(y); free(e); free(azel);
+        return 0;
+    }
+    if ((ns=selsat(obs,azel,nu,nr,opt,sat,iu,ir))<=0) {
+        errmsg(rtk,"no common satellite\n");
+        free(rs); free(dts); free(var); free(y); free(e); free(azel);
+        return 0;
+    }
+    /* detect cycle slip by LLI and geometry-free phase jump */
+    for (i=0;i<ns;i++) {
+        for (f=0;f<opt->nf;f++) rtk->ssat[sat[i]-1].slip[f]&=0xFC;
+        detslp_ll(rtk,obs,iu[i],1);
+        detslp_ll(rtk,obs,ir[i],2);
+        detslp_gf_L1L2(rtk,obs,iu[i],ir[i],nav);
+        detslp_gf_L1L5(rtk,obs,iu[i],ir[i],nav);
+    }
+    /* observation interval */
+    if (bat->ne>0&&(tt=timediff(rtk->sol.time,bat->te))>DTTOL&&
+        (bat->tint<=0.0||tt<bat->tint)) {
+        bat->tint=tt;
+    }
+    if (bat->ne++==0) bat->ts=rtk->sol.time;
+    bat->te=rtk->sol.time;
+    
+    /* single-differenced residuals, partial derivatives and weights */
+    v=mat(ns*nf*2,1); w=mat(ns*nf*2,1); h=mat(3,ns*nf*2); lam=mat(ns*nf*2,1);
+    u=mat(ns*nf*2+3,1); ic=imat(ns*nf*2,1); ia=imat(ns*nf*2,1);
+    ix=imat(ns*nf*2+3,1);
+    bl=baseline(bat->x0,rtk->rb,dr);
+    
+    for (i=0;i<ns;i++) {
+        sys=satsys(sat[i],NULL);
+        
+        for (f=0;f<nf*2;f++) {
+            if (!validobs(iu[i],ir[i],f,nf,y)) continue;
+            
+            lam[nv]=opt->ionoopt==IONOOPT_IFLC?1.0:nav->lam[sat[i]-1][f%nf];
+            ia[nv]=-1;
+            if (f<nf&&(ia[nv]=batcharc(rtk,bat,obs,iu[i],ir[i],f,nav))<0) {
+                continue;
+            }
+            v[nv]=y[f+iu[i]*nf*2]-y[f+ir[i]*nf*2];
+            if (ia[nv]>=0) v[nv]-=lam[nv]*bat->amb[ia[nv]];
+            for (j=0;j<3;j++) h[j+nv*3]=-e[j+iu[i]*3];
+            w[nv]=1.0/varerr(sat[i],sys,azel[1+iu[i]*2],
+                             0.25*obs[iu[i]].SNR[f%nf],0.25*obs[ir[i]].SNR[f%nf],
+                             bl,dt,f,opt,obs+iu[i]);
+            ic[nv++]=sysidx(sys)*nf*2+f;
+        }
+    }
+    /* reject outliers after first pass */
+    if (bat->pass>0) rejbatch(rtk,bat,v,w,ic,nv);
+    
+    /* accumulate normal equations with pre-elimination of clock parameters */
+    for (c=0;c<8*nf*2;c++) {
+        for (i=m=0,ncc=bc=hc[0]=hc[1]=hc[2]=0.0;i<nv;i++) {
+            if (ic[i]!=c||w[i]<=0.0) continue;
+            
+            /* parameters and partial derivatives of observation */
+            for (j=0;j<3;j++) {ix[j]=j; u[j]=h[j+i*3];}
+            if ((k=ia[i])>=0) {ix[3]=k+3; u[3]=lam[i];}
+            p=k>=0?4:3;
+            
+            for (j=0;j<p;j++) {
+                for (q=0;q<p;q++) bat->N[ix[j]+ix[q]*bat->nxmax]+=w[i]*u[j]*u[q];
+                bat->b[ix[j]]+=w[i]*u[j]*v[i];
+            }
+            bat->ll+=w[i]*SQR(v[i]);
+            bat->nv++;
+            
+            /* sum of partial derivatives for clock parameter */
+            ncc+=w[i]; bc+=w[i]*v[i];
+            for (j=0;j<3;j++) hc[j]+=w[i]*h[j+i*3];
+            m++;
+        }
+        if (m<=0) continue;
+        bat->nc++;
+        
+        /* pre-eliminate clock parameter: N-=n*n'/ncc, b-=n*bc/ncc */
+        for (i=0;i<3;i++) {ix[i]=i; u[i]=hc[i];}
+        for (i=0,p=3;i<nv;i++) {
+            if (ic[i]!=c||w[i]<=0.0||ia[i]<0) continue;
+            ix[p]=ia[i]+3; u[p++]=w[i]*lam[i];
+        }
+        for (j=0;j<p;j++) {
+            for (q=0;q<p;q++) bat->N[ix[j]+ix[q]*bat->nxmax]-=u[j]*u[q]/ncc;
+            bat->b[ix[j]]-=u[j]*bc/ncc;
+        }
+        bat->ll-=bc*bc/ncc;
+    }
+    /* save phase for cycle slip detection */
+    for (i=0;i<n;i++) for (j=0;j<nf;j++) {
+        if (obs[i].L[j]==0.0) continue;
+        rtk->ssat[obs[i].sat-1].pt[obs[i].rcv-1][j]=obs[i].time;
+        rtk->ssat[obs[i].sat-1].ph[obs[i].rcv-1][j]=obs[i].L[j];
+    }
+    free(rs); free(dts); free(var); free(y); free(e); free(azel);
+    free(v); free(w); free(h); free(lam); free(u); free(ic); free(ia); free(ix);
+    
+    return nv>0;
+}
+/* resolve integer ambiguity of batch static solution by LAMBDA --------------*/
+static int batchamb(rtk_t *rtk, const batch_t *bat, const double *x,
+                    const double *Q, double *xa, double *Pa)
+{
+    prcopt_t *opt=&rtk->opt;
+    double *y,*Qb,*Qab,*F,*db,*QQ,s[2];
+    int i,j,k,g,nb=0,nx=bat->nx,sys,ref[8*NFREQ],*ki,*kj,info;
+    
+    trace(3,"batchamb: nx=%d\n",nx);
+    
+    rtk->sol.ratio=0.0f;
+    rtk->nb_ar=0;
+    
+    if (opt->modear==ARMODE_OFF||opt->thresar[0]<1.0||
+        opt->ionoopt==IONOOPT_IFLC) {
+        return 0;
+    }
+    ki=imat(nx,1); kj=imat(nx,1);
+    
+    /* reference arc of longest epochs for each system and frequency */
+    for (g=0;g<8*NFREQ;g++) ref[g]=-1;
+    for (k=0;k<nx-3;k++) {
+        sys=satsys(bat->sat[k],NULL);
+        if (sys==SYS_GLO||sys==SYS_SBS||(sys==SYS_CMP&&!opt->bdsmodear)||
+            bat->nep[k]<MAX(opt->minlock,MINARC_BATCH)) {
+            continue;
+        }
+        g=sysidx(sys)*NFREQ+bat->frq[k];
+        if (ref[g]<0||bat->nep[k]>bat->nep[ref[g]]) ref[g]=k;
+    }
+    /* double-differenced phase-biases with reference arcs */
+    for (k=0;k<nx-3;k++) {
+        sys=satsys(bat->sat[k],NULL);
+        if (sys==SYS_GLO||sys==SYS_SBS||(sys==SYS_CMP&&!opt->bdsmodear)||
+            bat->nep[k]<MAX(opt->minlock,MINARC_BATCH)) {
+            continue;
+        }
+        g=sysidx(sys)*NFREQ+bat->frq[k];
+        if (k==ref[g]) continue;
+        ki[nb]=k+3; kj[nb++]=ref[g]+3;
+    }
+    if (nb<opt->minfixsats-1) {
+        errmsg(rtk,"not enough valid double-differences\n");
+        free(ki); free(kj);
+        return 0;
+    }
+    y=mat(nb,1); Qb=mat(nb,nb); Qab=mat(3,nb); F=mat(nb,2); db=mat(nb,1);
+    QQ=mat(3,nb);
+    
+    for (i=0;i<nb;i++) {
+        y[i]=bat->amb[ki[i]-3]-bat->amb[kj[i]-3];
+        for (j=0;j<nb;j++) {
+            Qb[i+j*nb]=Q[ki[i]+ki[j]*nx]-Q[ki[i]+kj[j]*nx]-
+                       Q[kj[i]+ki[j]*nx]+Q[kj[i]+kj[j]*nx];
+        }
+        for (j=0;j<3;j++) Qab[j+i*3]=Q[j+ki[i]*nx]-Q[j+kj[i]*nx];
+    }
+    rtk->nb_ar=nb;
+    
+    if (!(info=lambda(nb,2,y,Qb,F,s))) {
+        
+        rtk->sol.ratio=s[0]>0?(float)(s[1]/s[0]):0.0f;
+        if (rtk->sol.ratio>999.9) rtk->sol.ratio=999.9f;
+        rtk->sol.thres=(float)opt->thresar[0];
+        
+        /* validation by ratio-test */
+        if (s[0]<=0.0||s[1]/s[0]>=opt->thresar[0]) {
+            for (i=0;i<nb;i++) y[i]-=F[i];
+            
+            if (!matinv(Qb,nb)) {
+                /* xa=x-Qab*Qb^-1*(y-F), Pa=P-Qab*Qb^-1*Qab' */
+                for (i=0;i<3;i++) {
+                    xa[i]=x[i];
+                    for (j=0;j<3;j++) Pa[i+j*3]=Q[i+j*nx];
+                }
+                matmul("NN",nb,1,nb, 1.0,Qb ,y ,0.0,db);
+                matmul("NN",3 ,1,nb,-1.0,Qab,db,1.0,xa);
+                matmul("NN",3,nb,nb, 1.0,Qab,Qb,0.0,QQ);
+                matmul("NT",3,3 ,nb,-1.0,QQ,Qab,1.0,Pa);
+                
+                trace(3,"batchamb: validation ok (nb=%d ratio=%.2f s=%.2f/%.2f)\n",
+                      nb,s[0]==0.0?0.0:s[1]/s[0],s[0],s[1]);
+            }
+            else nb=0;
+        }
+        else {
+            errmsg(rtk,"ambiguity validation failed (nb=%d ratio=%.2f s=%.2f/%.2f)\n",
+                   nb,s[1]/s[0],s[0],s[1]);
+            nb=0;
+        }
+    }
+    else {
+        errmsg(rtk,"lambda error (info=%d)\n",info);
+        nb=0;
+    }
+    free(ki); free(kj); free(y); free(Qb); free(Qab); free(F); free(db);
+    free(QQ);
+    return nb;
+}
+/* solve batch static solution -------------------------------------------------
+* solve accumulated normal equations of batch static solution
+* args   : rtk_t   *rtk     IO  rtk control/result struct
+*            rtk->sol       O   solution at last epoch
+*            rtk->nb_ar     O   number of double-differenced ambiguities
+*          batch_t *bat     IO  batch static solution struct
+*          int     ar       I   resolve integer ambiguity (0:off,1:on)
+* return : status (SOLQ_FIX,SOLQ_FLOAT,SOLQ_NONE:no solution)
+* notes  : the linearization point and the phase-biases are updated by the
+*          float solution and the normal equations are cleared for next pass.
+*          the phase-biases of arcs over MINARC_BATCH epochs except for glonass
+*          and sbas are resolved at once by LAMBDA with ratio-test.
+*-----------------------------------------------------------------------------*/
+extern int batchsol(rtk_t *rtk, batch_t *bat, int ar)
+{
+    prcopt_t *opt=&rtk->opt;
+    double *N,*x,xa[3],Pa[9],vv;
+    int i,j,nx=bat->nx,stat=SOLQ_FLOAT,sats[MAXSAT]={0};
+    
+    trace(3,"batchsol: pass=%d ne=%d nv=%d nc=%d nx=%d\n",bat->pass,bat->ne,
+          bat->nv,bat->nc,nx);
+    
+    if (bat->ne<=0||bat->nv<=bat->nc+nx) {
+        errmsg(rtk,"no batch solution (ne=%d nv=%d)\n",bat->ne,bat->nv);
+        stat=SOLQ_NONE;
+    }
+    N=mat(nx,nx); x=mat(nx,1);
+    
+    if (stat!=SOLQ_NONE) {
+        for (i=0;i<nx;i++) for (j=0;j<nx;j++) {
+            N[i+j*nx]=bat->N[i+j*bat->nxmax];
+        }
+        /* a priori constraint of phase-biases */
+        for (i=3;i<nx;i++) N[i+i*nx]+=1.0/SQR(opt->std[0]);
+        
+        if (matinv(N,nx)) {
+            errmsg(rtk,"batch normal matrix inverse error (nx=%d)\n",nx);
+            stat=SOLQ_NONE;
+        }
+    }
+    if (stat!=SOLQ_NONE) {
+        matmul("NN",nx,1,nx,1.0,N,bat->b,0.0,x);
+        
+        vv=bat->ll;
+        for (i=0;i<nx;i++) vv-=bat->b[i]*x[i];
+        trace(2,"batchsol: pass=%d ne=%d nv=%d nrej=%d nx=%d dx=%.4f sigma0=%.3f\n",
+              bat->pass,bat->ne,bat->nv,bat->nrej,nx,norm(x,3),
+              SQRT(vv/(bat->nv-bat->nc-nx)));
+        
+        /* update linearization point and phase-biases by float solution */
+        for (i=0;i<3;i++) x[i]=bat->x0[i]+=x[i];
+        for (i=3;i<nx;i++) bat->amb[i-3]+=x[i];
+        
+        rtk->sol.time=bat->te;
+        rtk->sol.type=0;
+        rtk->sol.age=0.0f;
+        rtk->sol.ratio=0.0f;
+        for (i=0;i<3;i++) {
+            xa[i]=x[i];
+            for (j=0;j<3;j++) Pa[i+j*3]=N[i+j*nx];
+        }
+        if (ar&&batchamb(rtk,bat,x,N,xa,Pa)>0) stat=SOLQ_FIX;
+        
+        for (i=0;i<6;i++) rtk->sol.rr[i]=i<3?xa[i]:0.0;
+        for (i=0;i<3;i++) rtk->sol.qr[i]=(float)Pa[i+i*3];
+        rtk->sol.qr[3]=(float)Pa[1];
+        rtk->sol.qr[4]=(float)Pa[5];
+        rtk->sol.qr[5]=(float)Pa[2];
+        for (i=0;i<nx-3;i++) sats[bat->sat[i]-1]=1;
+        for (i=0,rtk->sol.ns=0;i<MAXSAT;i++) rtk->sol.ns+=sats[i];
+        rtk->sol.stat=stat;
+    }
+    /* clear normal equations for next pass */
+    for (i=0;i<bat->nxmax*bat->nxmax;i++) bat->N[i]=0.0;
+    for (i=0;i<bat->nxmax;i++) bat->b[i]=0.0;
+    for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ;j++) bat->arc[i][j]=-1;
+    bat->na=nx-3;
+    bat->nx=3;
+    bat->ne=bat->nv=bat->nc=bat->nrej=0;
+    bat->ll=0.0;
+    bat->pass++;
+    
+    free(N); free(x);
+    return stat;
+}
 /* initialize rtk control ------------------------------------------------------
 * initialize rtk control struct
 * args   : rtk_t    *rtk    IO  rtk control/result struct
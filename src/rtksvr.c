@@ -37,6 +37,16 @@
 *           2016/10/04  1.19 fix problem to send nmea of single solution
 *           2016/10/09  1.20 add reset-and-single-sol mode for nmea-request
 *           2017/04/11  1.21 add rtkfree() in rtksvrfree()
+*           2026/10/17  1.22 input rtcm 3 by frames with input_rtcm3b()
+*                            support binary solution status output
+*                            allocate nav corrections on demand
+*                            receive obs, ephemeris and ssr by decoder sinks
+*                            add api rtksvrmetric()
+*                            set server thread options and measure cycle jitter
+*                            decode input streams in decoder thread and pass
+*                            observation epochs by ring buffers
+*                            add api rtksvrobs()
+*                            pair rover and base epochs by time
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -66,14 +76,28 @@ static void saveoutbuf(rtksvr_t *svr, unsigned char *buff, int n, int index)
 static void writesol(rtksvr_t *svr, int index)
 {
     solopt_t solopt=solopt_default;
-    unsigned char buff[MAXSOLMSG+1];
+    unsigned char buff[MAXSOLMSG+1],*buffb;
     int i,n;
     
     tracet(4,"writesol: index=%d\n",index);
     
     for (i=0;i<2;i++) {
         
-        if (svr->solopt[i].posf==SOLF_STAT) {
+        if (svr->solopt[i].posf==SOLF_STATB) {
+            
+            /* output binary solution status with residuals */
+            if (!(buffb=(unsigned char *)malloc(MAXSOLSTATB))) continue;
+            rtksvrlock(svr);
+            n=rtkoutstatb(&svr->rtk,&svr->nav,2,buffb);
+            rtksvrunlock(svr);
+            strwrite(svr->stream+i+3,buffb,n);
+            
+            /* save output buffer */
+            saveoutbuf(svr,buffb,n,i);
+            free(buffb);
+            continue;
+        }
+        else if (svr->solopt[i].posf==SOLF_STAT) {
             
             /* output solution status */
             rtksvrlock(svr);
@@ -137,65 +161,148 @@ static void updatefcn(rtksvr_t *svr)
         }
     }
 }
-/* update rtk server struct --------------------------------------------------*/
-static void updatesvr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav, int sat,
-                      sbsmsg_t *sbsmsg, int index, int iobs)
+/* observation epoch decoded ---------------------------------------------------
+* the decoder thread writes the epoch to the ring slot once and the server
+* thread runs rtkpos() on the slot. the epochs are passed to the server thread
+* by svr->obsw[] at the end of each decoder cycle.
+*-----------------------------------------------------------------------------*/
+static void obs_epoch(decsink_t *sink, const obs_t *obs)
 {
-    eph_t *eph1,*eph2,*eph3;
-    geph_t *geph1,*geph2,*geph3;
-    gtime_t tof;
-    double pos[3],del[3]={0},dr[3];
-    int i,n=0,prn,sbssat=svr->rtk.opt.sbassatsel,sys,iode;
+    rtksvr_t *svr=(rtksvr_t *)sink->arg;
+    obs_t *buf;
+    int i,n=0,sort=0,index=sink->id;
+    
+    tracet(4,"obs_epoch: index=%d n=%d\n",index,obs->n);
+    
+    svr->nmsg[index][0]++;
+    
+    if (!(buf=obsringslot(svr->obsr+index))) {
+        svr->prcout++;
+        return;
+    }
+    /* rover slots have room for base observation data appended */
+    for (i=0;i<obs->n&&n<MAXOBS;i++) {
+        if (svr->rtk.opt.exsats[obs->data[i].sat-1]==1||
+            !(satsys(obs->data[i].sat,NULL)&svr->rtk.opt.navsys)) continue;
+        buf->data[n]=obs->data[i];
+        buf->data[n].rcv=index+1;
+        if (n>0&&buf->data[n].sat<=buf->data[n-1].sat) sort=1;
+        n++;
+    }
+    buf->n=n;
+    if (sort) sortobs(buf);
+    obsringcommit(svr->obsr+index);
+}
+/* next observation epoch ------------------------------------------------------
+* release current epoch and hold next one of epochs passed by decoder thread
+* (wp: count of passed epochs)
+*-----------------------------------------------------------------------------*/
+static obs_t *nextobs(rtksvr_t *svr, int index, unsigned int wp)
+{
+    obsring_t *ring=svr->obsr+index;
+    obs_t *obs;
+    
+    if ((int)(wp-ring->rp)<=svr->obsc[index]||
+        !obsringpeek(ring,svr->obsc[index])) return NULL;
+    
+    rtksvrlock(svr);
+    obsringrelease(ring,svr->obsc[index]);
+    svr->obsc[index]=1;
+    obs=obsringpeek(ring,0);
+    rtksvrunlock(svr);
+    return obs;
+}
+/* ephemeris decoded ---------------------------------------------------------*/
+static void ephemeris(decsink_t *sink, int sat, const nav_t *nav)
+{
+    rtksvr_t *svr=(rtksvr_t *)sink->arg;
+    const eph_t *eph1;
+    const geph_t *geph1;
+    eph_t *eph2,*eph3;
+    geph_t *geph2,*geph3;
+    int prn,index=sink->id;
     
-    tracet(4,"updatesvr: ret=%d sat=%2d index=%d\n",ret,sat,index);
+    tracet(4,"ephemeris: index=%d sat=%2d\n",index,sat);
     
-    if (ret==1) { /* observation data */
-        if (iobs<MAXOBSBUF) {
-            for (i=0;i<obs->n;i++) {
-                if (svr->rtk.opt.exsats[obs->data[i].sat-1]==1||
-                    !(satsys(obs->data[i].sat,NULL)&svr->rtk.opt.navsys)) continue;
-                svr->obs[index][iobs].data[n]=obs->data[i];
-                svr->obs[index][iobs].data[n++].rcv=index+1;
+    if (satsys(sat,&prn)!=SYS_GLO) {
+        if (!svr->navsel||svr->navsel==index+1) {
+            eph1=nav->eph+sat-1;
+            eph2=svr->nav.eph+sat-1;
+            eph3=svr->nav.eph+sat-1+MAXSAT;
+            if (eph2->ttr.time==0||
+                (eph1->iode!=eph3->iode&&eph1->iode!=eph2->iode)||
+                (timediff(eph1->toe,eph3->toe)!=0.0&&
+                 timediff(eph1->toe,eph2->toe)!=0.0)) {
+                *eph3=*eph2;
+                *eph2=*eph1;
+                updatenav(&svr->nav);
             }
-            svr->obs[index][iobs].n=n;
-            sortobs(&svr->obs[index][iobs]);
         }
-        svr->nmsg[index][0]++;
+        svr->nmsg[index][1]++;
     }
-    else if (ret==2) { /* ephemeris */
-        if (satsys(sat,&prn)!=SYS_GLO) {
-            if (!svr->navsel||svr->navsel==index+1) {
-                eph1=nav->eph+sat-1;
-                eph2=svr->nav.eph+sat-1;
-                eph3=svr->nav.eph+sat-1+MAXSAT;
-                if (eph2->ttr.time==0||
-                    (eph1->iode!=eph3->iode&&eph1->iode!=eph2->iode)||
-                    (timediff(eph1->toe,eph3->toe)!=0.0&&
-                     timediff(eph1->toe,eph2->toe)!=0.0)) {
-                    *eph3=*eph2;
-                    *eph2=*eph1;
-                    updatenav(&svr->nav);
-                }
+    else {
+       if (!svr->navsel||svr->navsel==index+1) {
+           geph1=nav->geph+prn-1;
+           geph2=svr->nav.geph+prn-1;
+           geph3=svr->nav.geph+prn-1+MAXPRNGLO;
+           if (geph2->tof.time==0||
+               (geph1->iode!=geph3->iode&&geph1->iode!=geph2->iode)) {
+               *geph3=*geph2;
+               *geph2=*geph1;
+               updatenav(&svr->nav);
+               updatefcn(svr);
+           }
+       }
+       svr->nmsg[index][6]++;
+    }
+}
+/* ssr corrections decoded ---------------------------------------------------*/
+static void ssr_corr(decsink_t *sink, ssr_t *ssr)
+{
+    rtksvr_t *svr=(rtksvr_t *)sink->arg;
+    int i,prn,sys,iode,index=sink->id;
+    
+    tracet(4,"ssr_corr: index=%d\n",index);
+    
+    for (i=0;i<MAXSAT&&allocnav(&svr->nav,0x200);i++) {
+        if (!ssr[i].update) continue;
+        
+        /* check consistency between iods of orbit and clock */
+        if (ssr[i].iod[0]!=ssr[i].iod[1]) continue;
+        
+        ssr[i].update=0;
+        
+        iode=ssr[i].iode;
+        sys=satsys(i+1,&prn);
+        
+        /* check corresponding ephemeris exists */
+        if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS) {
+            if (svr->nav.eph[i       ].iode!=iode&&
+                svr->nav.eph[i+MAXSAT].iode!=iode) {
+                continue;
             }
-            svr->nmsg[index][1]++;
         }
-        else {
-           if (!svr->navsel||svr->navsel==index+1) {
-               geph1=nav->geph+prn-1;
-               geph2=svr->nav.geph+prn-1;
-               geph3=svr->nav.geph+prn-1+MAXPRNGLO;
-               if (geph2->tof.time==0||
-                   (geph1->iode!=geph3->iode&&geph1->iode!=geph2->iode)) {
-                   *geph3=*geph2;
-                   *geph2=*geph1;
-                   updatenav(&svr->nav);
-                   updatefcn(svr);
-               }
-           }
-           svr->nmsg[index][6]++;
+        else if (sys==SYS_GLO) {
+            if (svr->nav.geph[prn-1          ].iode!=iode&&
+                svr->nav.geph[prn-1+MAXPRNGLO].iode!=iode) {
+                continue;
+            }
         }
+        svr->nav.ssr[i]=ssr[i];
     }
-    else if (ret==3) { /* sbas message */
+    svr->nmsg[index][7]++;
+}
+/* update rtk server struct --------------------------------------------------*/
+static void updatesvr(rtksvr_t *svr, int ret, nav_t *nav, sbsmsg_t *sbsmsg,
+                      int index)
+{
+    gtime_t tof;
+    double pos[3],del[3]={0},dr[3];
+    int i,sbssat=svr->rtk.opt.sbassatsel;
+    
+    tracet(4,"updatesvr: ret=%d index=%d\n",ret,index);
+    
+    if (ret==3) { /* sbas message */
         if (sbsmsg&&(sbssat==sbsmsg->prn||sbssat==0)) {
             if (svr->nsbs<MAXSBSMSG) {
                 svr->sbsmsg[svr->nsbs++]=*sbsmsg;
@@ -266,36 +373,6 @@ static void updatesvr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav, int sat,
     else if (ret==7) { /* dgps correction */
         svr->nmsg[index][5]++;
     }
-    else if (ret==10) { /* ssr message */
-        for (i=0;i<MAXSAT;i++) {
-            if (!svr->rtcm[index].ssr[i].update) continue;
-            
-            /* check consistency between iods of orbit and clock */
-            if (svr->rtcm[index].ssr[i].iod[0]!=
-                svr->rtcm[index].ssr[i].iod[1]) continue;
-            
-            svr->rtcm[index].ssr[i].update=0;
-            
-            iode=svr->rtcm[index].ssr[i].iode;
-            sys=satsys(i+1,&prn);
-            
-            /* check corresponding ephemeris exists */
-            if (sys==SYS_GPS||sys==SYS_GAL||sys==SYS_QZS) {
-                if (svr->nav.eph[i       ].iode!=iode&&
-                    svr->nav.eph[i+MAXSAT].iode!=iode) {
-                    continue;
-                }
-            }
-            else if (sys==SYS_GLO) {
-                if (svr->nav.geph[prn-1          ].iode!=iode&&
-                    svr->nav.geph[prn-1+MAXPRNGLO].iode!=iode) {
-                    continue;
-                }
-            }
-            svr->nav.ssr[i]=svr->rtcm[index].ssr[i];
-        }
-        svr->nmsg[index][7]++;
-    }
     else if (ret==31) { /* lex message */
         lexupdatecorr(&svr->raw[index].lexmsg,&svr->nav,&tof);
         svr->nmsg[index][8]++;
@@ -305,38 +382,43 @@ static void updatesvr(rtksvr_t *svr, int ret, obs_t *obs, nav_t *nav, int sat,
     }
 }
 /* decode receiver raw/rtcm data ---------------------------------------------*/
-static int decoderaw(rtksvr_t *svr, int index)
+static void decoderaw(rtksvr_t *svr, int index)
 {
     obs_t *obs;
     nav_t *nav;
     sbsmsg_t *sbsmsg=NULL;
-    int i,ret,sat,fobs=0;
+    int i,ret;
     
     tracet(4,"decoderaw: index=%d\n",index);
     
-    rtksvrlock(svr);
-    
-    for (i=0;i<svr->nb[index];i++) {
+    /* observation data and ephemeris are passed to obs_epoch() and
+       ephemeris() by decoders. lock for each message to run rtkpos() in
+       server thread between messages */
+    for (i=0;i<svr->nb[index];) {
         
-        /* input rtcm/receiver raw data from stream */
-        if (svr->format[index]==STRFMT_RTCM2) {
-            ret=input_rtcm2(svr->rtcm+index,svr->buff[index][i]);
-            obs=&svr->rtcm[index].obs;
-            nav=&svr->rtcm[index].nav;
-            sat=svr->rtcm[index].ephsat;
-        }
-        else if (svr->format[index]==STRFMT_RTCM3) {
-            ret=input_rtcm3(svr->rtcm+index,svr->buff[index][i]);
-            obs=&svr->rtcm[index].obs;
-            nav=&svr->rtcm[index].nav;
-            sat=svr->rtcm[index].ephsat;
-        }
-        else {
-            ret=input_raw(svr->raw+index,svr->format[index],svr->buff[index][i]);
-            obs=&svr->raw[index].obs;
-            nav=&svr->raw[index].nav;
-            sat=svr->raw[index].ephsat;
-            sbsmsg=&svr->raw[index].sbsmsg;
+        rtksvrlock(svr);
+        
+        for (ret=0;!ret&&i<svr->nb[index];) {
+            
+            /* input rtcm/receiver raw data from stream */
+            if (svr->format[index]==STRFMT_RTCM2) {
+                ret=input_rtcm2(svr->rtcm+index,svr->buff[index][i++]);
+                obs=&svr->rtcm[index].obs;
+                nav=&svr->rtcm[index].nav;
+            }
+            else if (svr->format[index]==STRFMT_RTCM3) { /* by frames */
+                ret=input_rtcm3b(svr->rtcm+index,svr->buff[index],
+                                 svr->nb[index],&i);
+                obs=&svr->rtcm[index].obs;
+                nav=&svr->rtcm[index].nav;
+            }
+            else {
+                ret=input_raw(svr->raw+index,svr->format[index],
+                              svr->buff[index][i++]);
+                obs=&svr->raw[index].obs;
+                nav=&svr->raw[index].nav;
+                sbsmsg=&svr->raw[index].sbsmsg;
+            }
         }
 #if 0 /* record for receiving tick */
         if (ret==1) {
@@ -349,18 +431,11 @@ static int decoderaw(rtksvr_t *svr, int index)
             update_cmr(&svr->raw[1],svr,obs);
         }
         /* update rtk server */
-        if (ret>0) updatesvr(svr,ret,obs,nav,sat,sbsmsg,index,fobs);
+        if (ret>0) updatesvr(svr,ret,nav,sbsmsg,index);
         
-        /* observation data received */
-        if (ret==1) {
-            if (fobs<MAXOBSBUF) fobs++; else svr->prcout++;
-        }
+        rtksvrunlock(svr);
     }
     svr->nb[index]=0;
-    
-    rtksvrunlock(svr);
-    
-    return fobs;
 }
 /* decode download file ------------------------------------------------------*/
 static void decodefile(rtksvr_t *svr, int index)
@@ -428,6 +503,8 @@ static void corr_phase_bias(obsd_t *obs, int n, const nav_t *nav)
     double lam;
     int i,j,code;
     
+    if (!nav->ssr) return;
+    
     for (i=0;i<n;i++) for (j=0;j<NFREQ;j++) {
         
         if (!(code=obs[i].code[j])) continue;
@@ -526,34 +603,33 @@ static void send_nmea(rtksvr_t *svr, unsigned int *tickreset)
 			   sol_nmea.rr[2]);
 	}
 }
-/* rtk server thread ---------------------------------------------------------*/
+/* rtk server decoder thread -------------------------------------------------*/
 #ifdef WIN32
-static DWORD WINAPI rtksvrthread(void *arg)
+static DWORD WINAPI decodethread(void *arg)
 #else
-static void *rtksvrthread(void *arg)
+static void *decodethread(void *arg)
 #endif
 {
     rtksvr_t *svr=(rtksvr_t *)arg;
-    obs_t obs;
-    obsd_t data[MAXOBS*2];
-    sol_t sol={{0}};
-    double tt;
-    unsigned int tick,ticknmea,tick1hz,tickreset;
+    thrdopt_t thopt=svr->thopt;
+    unsigned int tick;
     unsigned char *p,*q;
-    char msg[128];
-    int i,j,n,fobs[3]={0},cycle,cputime;
+    int i,n,full,cputime;
     
-    tracet(3,"rtksvrthread:\n");
+    tracet(3,"decodethread:\n");
     
-    svr->state=1; obs.data=data;
-    svr->tick=tickget();
-    ticknmea=tick1hz=svr->tick-1000;
-    tickreset=svr->tick-MIN_INT_RESET;
+    if (*thopt.name) sprintf(thopt.name,"%.11s-dec",svr->thopt.name);
+    setthrdopt(&thopt);
     
-    for (cycle=0;svr->state;cycle++) {
+    while (svr->state) {
         tick=tickget();
         
-        for (i=0;i<3;i++) {
+        /* hold input streams until server thread consumes epochs (server
+           thread holds an epoch and up to nslot/4 pending base epochs) */
+        for (i=0,full=0;i<3;i++) {
+            if (obsringcount(svr->obsr+i)>svr->obsr[i].nslot/4+1) full=1;
+        }
+        for (i=0;i<3&&!full;i++) {
             p=svr->buff[i]+svr->nb[i]; q=svr->buff[i]+svr->buffsize;
             
             /* read receiver raw/rtcm data from input stream */
@@ -578,36 +654,109 @@ static void *rtksvrthread(void *arg)
             }
             else {
                 /* decode receiver raw/rtcm data */
-                fobs[i]=decoderaw(svr,i);
+                decoderaw(svr,i);
             }
         }
-        /* averaging single base pos */
-        if (fobs[1]>0&&svr->rtk.opt.refpos==POSOPT_SINGLE) {
+        /* pass epochs decoded in cycle to server thread */
+        for (i=0;i<3;i++) svr->obsw[i]=svr->obsr[i].wp;
+        
+        if ((cputime=(int)(tickget()-tick))<svr->cycle) {
+            sleepms(svr->cycle-cputime);
+        }
+    }
+    return 0;
+}
+/* rtk server thread -----------------------------------------------------------
+* the server thread runs rtkpos() for rover epochs passed by the decoder thread.
+* rover and base epochs decoded in a decoder cycle are passed together and the
+* rover epoch is paired with the latest base epoch not after it. a base epoch
+* decoded in a later cycle than the rover epoch is not waited for, and the
+* rover epoch is processed with the previous base epoch with age of
+* differential as the server without epoch pairing.
+*-----------------------------------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI rtksvrthread(void *arg)
+#else
+static void *rtksvrthread(void *arg)
+#endif
+{
+    rtksvr_t *svr=(rtksvr_t *)arg;
+    obs_t *obs,*base;
+    sol_t sol={{0}};
+    double tt;
+    unsigned int tick,ticknmea,tick1hz,tickreset,ticku,wp[3]={0},wpb;
+    char msg[128];
+    int i,j,n,nrov,cycle,cputime,dly,jit;
+    
+    tracet(3,"rtksvrthread:\n");
+    
+    setthrdopt(&svr->thopt);
+    
+    svr->state=1;
+    svr->tick=tickget();
+    ticknmea=tick1hz=svr->tick-1000;
+    tickreset=svr->tick-MIN_INT_RESET;
+    
+    /* create decoder thread */
+    for (i=0;i<3;i++) svr->obsw[i]=0;
+#ifdef WIN32
+    if (!(svr->dthread=CreateThread(NULL,0,decodethread,svr,0,NULL))) {
+#else
+    if (pthread_create(&svr->dthread,NULL,decodethread,svr)) {
+#endif
+        tracet(1,"rtksvrthread: decoder thread create error\n");
+        svr->dthread=0;
+        svr->state=0;
+    }
+    for (cycle=0;svr->state;cycle++) {
+        tick=tickget();
+        
+        /* epochs passed by decoder thread */
+        wpb=wp[1];
+        for (i=0;i<3;i++) wp[i]=svr->obsw[i];
+        
+        /* averaging single base pos by first base epoch in cycle */
+        if (wp[1]!=wpb&&svr->rtk.opt.refpos==POSOPT_SINGLE) {
+            obs=obsringpeek(svr->obsr+1,(int)(wpb-svr->obsr[1].rp));
+            rtksvrlock(svr);
             if ((svr->rtk.opt.maxaveep<=0||svr->nave<svr->rtk.opt.maxaveep)&&
-                pntpos(svr->obs[1][0].data,svr->obs[1][0].n,&svr->nav,
-                       &svr->rtk.opt,&sol,NULL,NULL,msg)) {
+                obs&&pntpos(obs->data,obs->n,&svr->nav,&svr->rtk.opt,&sol,
+                            NULL,NULL,msg)) {
                 svr->nave++;
                 for (i=0;i<3;i++) {
                     svr->rb_ave[i]+=(sol.rr[i]-svr->rb_ave[i])/svr->nave;
                 }
             }
             for (i=0;i<3;i++) svr->rtk.opt.rb[i]=svr->rb_ave[i];
+            rtksvrunlock(svr);
         }
-        for (i=0;i<fobs[0];i++) { /* for each rover observation data */
-            obs.n=0;
-            for (j=0;j<svr->obs[0][i].n&&obs.n<MAXOBS*2;j++) {
-                obs.data[obs.n++]=svr->obs[0][i].data[j];
+        nrov=(int)(wp[0]-svr->obsr[0].rp)-svr->obsc[0];
+        
+        /* for each rover observation data */
+        for (i=0;(obs=nextobs(svr,0,wp[0]));i++) {
+            
+            /* latest base observation data not after rover epoch */
+            while ((int)(wp[1]-svr->obsr[1].rp)>svr->obsc[1]&&
+                   (base=obsringpeek(svr->obsr+1,svr->obsc[1]))&&
+                   (base->n<=0||timediff(base->data[0].time,obs->data[0].time)
+                                <=DTTOL)) {
+                nextobs(svr,1,wp[1]);
             }
-            for (j=0;j<svr->obs[1][0].n&&obs.n<MAXOBS*2;j++) {
-                obs.data[obs.n++]=svr->obs[1][0].data[j];
+            /* append base observation data to rover epoch in place */
+            rtksvrlock(svr);
+            base=rtksvrobs(svr,1);
+            n=obs->n;
+            for (j=0;base&&j<base->n&&obs->n<obs->nmax;j++) {
+                obs->data[obs->n++]=base->data[j];
             }
             /* carrier phase bias correction */
             if (!strstr(svr->rtk.opt.pppopt,"-DIS_FCB")) {
-                corr_phase_bias(obs.data,obs.n,&svr->nav);
+                corr_phase_bias(obs->data,obs->n,&svr->nav);
             }
             /* rtk positioning */
-            rtksvrlock(svr);
-            rtkpos(&svr->rtk,obs.data,obs.n,&svr->nav);
+            rtkpos(&svr->rtk,obs->data,obs->n,&svr->nav);
+            obs->n=n;
+            svr->nepoch++;
             rtksvrunlock(svr);
             
             if (svr->rtk.sol.stat!=SOLQ_NONE) {
@@ -618,15 +767,31 @@ static void *rtksvrthread(void *arg)
                 
                 /* write solution */
                 writesol(svr,i);
+                
+                /* solution counts and delay from start of processing cycle */
+                dly=(int)(tickget()-tick);
+                rtksvrlock(svr);
+                if (svr->rtk.sol.stat<=MAXSOLQ) svr->nsolq[svr->rtk.sol.stat]++;
+                svr->dlysum+=dly;
+                if (dly>svr->dlymax) svr->dlymax=dly;
+                rtksvrunlock(svr);
             }
             /* if cpu overload, inclement obs outage counter and break */
             if ((int)(tickget()-tick)>=svr->cycle) {
-                svr->prcout+=fobs[0]-i-1;
+                rtksvrlock(svr);
+                svr->prcout+=nrov-i-1;
+                rtksvrunlock(svr);
 #if 0 /* omitted v.2.4.1 */
                 break;
 #endif
             }
         }
+        /* hold latest epoch of corrections and limit pending base epochs */
+        while (nextobs(svr,2,wp[2])) ;
+        while ((int)(wp[1]-svr->obsr[1].rp)-svr->obsc[1]>
+               svr->obsr[1].nslot/4) {
+            nextobs(svr,1,wp[1]);
+        }
         /* send null solution if no solution (1hz) */
         if (svr->rtk.sol.stat==SOLQ_NONE&&(int)(tick-tick1hz)>=1000) {
             writesol(svr,0);
@@ -641,11 +806,36 @@ static void *rtksvrthread(void *arg)
             send_nmea(svr,&tickreset);
             ticknmea=tick;
         }
-        if ((cputime=(int)(tickget()-tick))>0) svr->cputime=cputime;
+        if ((cputime=(int)(tickget()-tick))>0) {
+            rtksvrlock(svr);
+            svr->cputime=cputime;
+            rtksvrunlock(svr);
+        }
         
-        /* sleep until next cycle */
-        sleepms(svr->cycle-cputime);
+        /* sleep until next cycle and measure wake-up delay as jitter */
+        if (svr->cycle-cputime>0) {
+            ticku=tickgetus();
+            sleepms(svr->cycle-cputime);
+            jit=(int)(tickgetus()-ticku)-(svr->cycle-cputime)*1000;
+            if (jit<0) jit=0;
+            rtksvrlock(svr);
+            svr->jitsum+=jit;
+            svr->njit++;
+            if (jit>svr->jitmax) svr->jitmax=jit;
+            rtksvrunlock(svr);
+        }
     }
+    /* stop decoder thread */
+    svr->state=0;
+#ifdef WIN32
+    if (svr->dthread) {
+        WaitForSingleObject(svr->dthread,10000);
+        CloseHandle(svr->dthread);
+    }
+#else
+    if (svr->dthread) pthread_join(svr->dthread,NULL);
+#endif
+    svr->dthread=0;
     for (i=0;i<MAXSTRRTK;i++) strclose(svr->stream+i);
     for (i=0;i<3;i++) {
         svr->nb[i]=svr->npb[i]=0;
@@ -672,7 +862,7 @@ extern int rtksvrinit(rtksvr_t *svr)
     eph_t  eph0 ={0,-1,-1};
     geph_t geph0={0,-1};
     seph_t seph0={0};
-    int i,j;
+    int i,j,n;
     
     tracet(3,"rtksvrinit:\n");
     
@@ -684,6 +874,8 @@ extern int rtksvrinit(rtksvr_t *svr)
     svr->navsel=svr->nsbs=svr->nsol=0;
     rtkinit(&svr->rtk,&prcopt_default);
     for (i=0;i<3;i++) svr->nb[i]=0;
+    for (i=0;i<3;i++) svr->obsc[i]=0;
+    memset(svr->obsr,0,sizeof(svr->obsr));
     for (i=0;i<2;i++) svr->nsb[i]=0;
     for (i=0;i<3;i++) svr->npb[i]=0;
     for (i=0;i<3;i++) svr->buff[i]=NULL;
@@ -695,8 +887,18 @@ extern int rtksvrinit(rtksvr_t *svr)
     for (i=0;i<3;i++) svr->files[i][0]='\0';
     svr->moni=NULL;
     svr->tick=0;
-    svr->thread=0;
+    svr->thread=svr->dthread=0;
     svr->cputime=svr->prcout=svr->nave=0;
+    svr->nepoch=svr->dlysum=0;
+    svr->dlymax=0;
+    svr->njit=0;
+    svr->jitsum=0.0;
+    svr->jitmax=0;
+    strcpy(svr->thopt.name,"rtksvr");
+    svr->thopt.cpu=-1;
+    svr->thopt.policy=THRDPOL_OTHER;
+    svr->thopt.prio=0;
+    for (i=0;i<=MAXSOLQ;i++) svr->nsolq[i]=0;
     for (i=0;i<3;i++) svr->rb_ave[i]=0.0;
     
     if (!(svr->nav.eph =(eph_t  *)malloc(sizeof(eph_t )*MAXSAT *2))||
@@ -711,9 +913,12 @@ extern int rtksvrinit(rtksvr_t *svr)
     svr->nav.n =MAXSAT *2;
     svr->nav.ng=NSATGLO*2;
     svr->nav.ns=NSATSBS*2;
+    svr->nav.pcvs=NULL; svr->nav.ssr=NULL; svr->nav.dgps=NULL;
+    svr->nav.lexeph=NULL; svr->nav.sbssat=NULL; svr->nav.sbsion=NULL;
     
-    for (i=0;i<3;i++) for (j=0;j<MAXOBSBUF;j++) {
-        if (!(svr->obs[i][j].data=(obsd_t *)malloc(sizeof(obsd_t)*MAXOBS))) {
+    for (i=0;i<3;i++) {
+        n=i==0?MAXOBS*2:MAXOBS; /* rover: with base observation data */
+        if (!initobsring(svr->obsr+i,MAXOBSBUF,n)) {
             tracet(1,"rtksvrinit: malloc error\n");
             return 0;
         }
@@ -738,14 +943,13 @@ extern int rtksvrinit(rtksvr_t *svr)
 *-----------------------------------------------------------------------------*/
 extern void rtksvrfree(rtksvr_t *svr)
 {
-    int i,j;
+    int i;
     
     free(svr->nav.eph );
     free(svr->nav.geph);
     free(svr->nav.seph);
-    for (i=0;i<3;i++) for (j=0;j<MAXOBSBUF;j++) {
-        free(svr->obs[i][j].data);
-    }
+    freenav(&svr->nav,0x1F00);
+    for (i=0;i<3;i++) freeobsring(svr->obsr+i);
     rtkfree(&svr->rtk);
 }
 /* lock/unlock rtk server ------------------------------------------------------
@@ -756,6 +960,19 @@ extern void rtksvrfree(rtksvr_t *svr)
 extern void rtksvrlock  (rtksvr_t *svr) {lock  (&svr->lock);}
 extern void rtksvrunlock(rtksvr_t *svr) {unlock(&svr->lock);}
 
+/* get current observation data ------------------------------------------------
+* get current observation epoch of input stream held in ring buffer
+* args   : rtksvr_t *svr    I  rtk server
+*          int     index    I  input stream (0:rover,1:base,2:corr)
+* return : observation epoch (NULL: no data)
+* notes  : call between rtksvrlock() and rtksvrunlock()
+*-----------------------------------------------------------------------------*/
+extern obs_t *rtksvrobs(rtksvr_t *svr, int index)
+{
+    if (index<0||index>2||!svr->obsc[index]) return NULL;
+    return obsringpeek(svr->obsr+index,0);
+}
+
 /* start rtk server ------------------------------------------------------------
 * start rtk server thread
 * args   : rtksvr_t *svr    IO rtk server
@@ -828,6 +1045,12 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
     svr->nsbs=0;
     svr->nsol=0;
     svr->prcout=0;
+    svr->nepoch=svr->dlysum=0;
+    svr->dlymax=0;
+    svr->njit=0;
+    svr->jitsum=0.0;
+    svr->jitmax=0;
+    for (i=0;i<=MAXSOLQ;i++) svr->nsolq[i]=0;
     rtkfree(&svr->rtk);
     rtkinit(&svr->rtk,prcopt);
     
@@ -844,7 +1067,8 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
             return 0;
         }
         for (j=0;j<10;j++) svr->nmsg[i][j]=0;
-        for (j=0;j<MAXOBSBUF;j++) svr->obs[i][j].n=0;
+        svr->obsr[i].wp=svr->obsr[i].rp=svr->obsr[i].nover=0;
+        svr->obsc[i]=0;
         strcpy(svr->cmds_periodic[i],!cmds_periodic[i]?"":cmds_periodic[i]);
         
         /* initialize receiver raw and rtcm control */
@@ -856,7 +1080,18 @@ extern int rtksvrstart(rtksvr_t *svr, int cycle, int buffsize, int *strs,
         strcpy(svr->rtcm[i].opt,rcvopts[i]);
         
         /* connect dgps corrections */
+        if (formats[i]==STRFMT_RTCM2&&!allocnav(&svr->nav,0x400)) {
+            sprintf(errmsg,"rtk server malloc error");
+            return 0;
+        }
         svr->rtcm[i].dgps=svr->nav.dgps;
+        
+        /* connect decoded data to rtk server */
+        svr->raw[i].sink.on_obs_epoch=svr->rtcm[i].sink.on_obs_epoch=obs_epoch;
+        svr->raw[i].sink.on_ephemeris=svr->rtcm[i].sink.on_ephemeris=ephemeris;
+        svr->rtcm[i].sink.on_ssr=ssr_corr;
+        svr->raw[i].sink.arg=svr->rtcm[i].sink.arg=svr;
+        svr->raw[i].sink.id =svr->rtcm[i].sink.id =i;
     }
     for (i=0;i<2;i++) { /* output peek buffer */
         if (!(svr->sbuf[i]=(unsigned char *)malloc(buffsize))) {
@@ -1034,22 +1269,24 @@ extern void rtksvrclosestr(rtksvr_t *svr, int index)
 extern int rtksvrostat(rtksvr_t *svr, int rcv, gtime_t *time, int *sat,
                        double *az, double *el, int **snr, int *vsat)
 {
+    obs_t *obs;
     int i,j,ns;
     
     tracet(4,"rtksvrostat: rcv=%d\n",rcv);
     
     if (!svr->state) return 0;
     rtksvrlock(svr);
-    ns=svr->obs[rcv][0].n;
+    obs=rtksvrobs(svr,rcv);
+    ns=obs?obs->n:0;
     if (ns>0) {
-        *time=svr->obs[rcv][0].data[0].time;
+        *time=obs->data[0].time;
     }
     for (i=0;i<ns;i++) {
-        sat [i]=svr->obs[rcv][0].data[i].sat;
+        sat [i]=obs->data[i].sat;
         az  [i]=svr->rtk.ssat[sat[i]-1].azel[0];
         el  [i]=svr->rtk.ssat[sat[i]-1].azel[1];
         for (j=0;j<NFREQ;j++) {
-            snr[i][j]=(int)(svr->obs[rcv][0].data[i].SNR[j]*0.25);
+            snr[i][j]=(int)(obs->data[i].SNR[j]*0.25);
         }
         if (svr->rtk.sol.stat==SOLQ_NONE||svr->rtk.sol.stat==SOLQ_SINGLE) {
             vsat[i]=svr->rtk.ssat[sat[i]-1].vs;
@@ -1106,6 +1343,7 @@ extern int rtksvrmark(rtksvr_t *svr, const char *name, const char *comment)
     ecef2pos(svr->rtk.sol.rr,pos);
     
     for (i=0;i<2;i++) {
+        if (svr->solopt[i].posf==SOLF_STATB) continue; /* no mark in binary */
         p=buff;
         if (svr->solopt[i].posf==SOLF_STAT) {
             p+=sprintf(p,"$MARK,%d,%.3f,%d,%.4f,%.4f,%.4f,%s,%s\n",week,tow,
@@ -1137,3 +1375,84 @@ extern int rtksvrmark(rtksvr_t *svr, const char *name, const char *comment)
     rtksvrunlock(svr);
     return 1;
 }
+/* rtk server metrics ----------------------------------------------------------
+* output metrics of rtk server
+* args   : rtksvr_t *svr    I  rtk server
+*          int    fmt       I  format (METF_PROM:prometheus text,METF_JSON:json)
+*          char   *buff     O  metrics output buffer
+*          int    nmax      I  size of metrics output buffer (bytes)
+* return : length of metrics output (bytes)
+* notes  : the counters of rtk server are read under rtksvrlock() as a
+*          snapshot. the solution delay is measured from the start of the
+*          processing cycle, not from the reception of the input data.
+*-----------------------------------------------------------------------------*/
+extern int rtksvrmetric(rtksvr_t *svr, int fmt, char *buff, int nmax)
+{
+    const char *strname[]={"rov","base","corr","sol1","sol2","logr","logb",
+                           "logc"};
+    const char *msgtype[]={"obs","nav","ion","sbas","pos","dgps","gnav","ssr",
+                           "lex","error"};
+    const char *qname[]={"none","fix","float","sbas","dgps","single","ppp",
+                         "dr"};
+    metbuf_t met;
+    char label[64];
+    unsigned int nsol=0;
+    int i,j;
+    
+    tracet(4,"rtksvrmetric: fmt=%d\n",fmt);
+    
+    metinit(&met,fmt,buff,nmax);
+    
+    rtksvrlock(svr);
+    metadd(&met,"rtklib_rtksvr_state","gauge","rtk server state (0:stop,"
+           "1:running)","",svr->state);
+    metadd(&met,"rtklib_rtksvr_cputime_ms","gauge","cpu time of last "
+           "processing cycle (ms)","",svr->cputime);
+    metadd(&met,"rtklib_rtksvr_cycle_ms","gauge","processing cycle (ms)","",
+           svr->cycle);
+    metadd(&met,"rtklib_rtksvr_epochs_total","counter","processed rover "
+           "epochs","",svr->nepoch);
+    metadd(&met,"rtklib_rtksvr_obs_outage_total","counter","rover epochs "
+           "over processing cycle","",svr->prcout);
+    for (i=1;i<=MAXSOLQ;i++) {
+        sprintf(label,"quality=\"%s\"",qname[i]);
+        metadd(&met,"rtklib_rtksvr_solutions_total","counter","output "
+               "solutions by quality",label,svr->nsolq[i]);
+        nsol+=svr->nsolq[i];
+    }
+    metadd(&met,"rtklib_rtksvr_fix_ratio","gauge","ratio of fixed solutions",
+           "",nsol>0?(double)svr->nsolq[SOLQ_FIX]/nsol:0.0);
+    metadd(&met,"rtklib_rtksvr_solution_delay_ms_sum","counter","sum of "
+           "solution delay from start of processing cycle (ms)","",
+           svr->dlysum);
+    metadd(&met,"rtklib_rtksvr_solution_delay_ms_max","gauge","max solution "
+           "delay from start of processing cycle (ms)","",svr->dlymax);
+    metadd(&met,"rtklib_rtksvr_jitter_us_avg","gauge","average wake-up delay "
+           "of processing cycle (us)","",svr->njit>0?svr->jitsum/svr->njit:0.0);
+    metadd(&met,"rtklib_rtksvr_jitter_us_max","gauge","max wake-up delay of "
+           "processing cycle (us)","",svr->jitmax);
+    metadd(&met,"rtklib_rtksvr_nsat","gauge","number of valid satellites","",
+           svr->rtk.sol.ns);
+    for (i=0;i<3;i++) {
+        sprintf(label,"stream=\"%s\"",strname[i]);
+        metadd(&met,"rtklib_rtksvr_input_buffer_bytes","gauge","bytes in "
+               "input buffer",label,svr->nb[i]);
+    }
+    for (i=0;i<3;i++) {
+        sprintf(label,"stream=\"%s\"",strname[i]);
+        metadd(&met,"rtklib_rtksvr_peek_buffer_bytes","gauge","bytes in peek "
+               "buffer",label,svr->npb[i]);
+    }
+    metadd(&met,"rtklib_rtksvr_buffer_size_bytes","gauge","input buffer size "
+           "(bytes)","",svr->buffsize);
+    for (i=0;i<3;i++) for (j=0;j<10;j++) {
+        sprintf(label,"stream=\"%s\",type=\"%s\"",strname[i],msgtype[j]);
+        metadd(&met,"rtklib_rtksvr_messages_total","counter","input messages "
+               "by type",label,svr->nmsg[i][j]);
+    }
+    rtksvrunlock(svr);
+    
+    strmetric(&met,svr->stream,strname,8);
+    
+    return metclose(&met);
+}
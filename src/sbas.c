@@ -35,6 +35,7 @@
 *           2011/01/15 1.8  use api ionppp()
 *                           add prn mask of qzss for qzss L1SAIF
 *           2016/07/29 1.9  crc24q() -> rtk_crc24q()
+*           2026/10/17 1.10 allocate sbas corrections in nav data on demand
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -426,22 +427,22 @@ extern int sbsupdatecorr(const sbsmsg_t *msg, nav_t *nav)
     
     trace(3,"sbsupdatecorr: type=%d\n",type);
     
-    if (msg->week==0) return -1;
+    if (msg->week==0||!allocnav(nav,0x1000)) return -1;
     
     switch (type) {
-        case  0: stat=decode_sbstype2 (msg,&nav->sbssat); break;
-        case  1: stat=decode_sbstype1 (msg,&nav->sbssat); break;
+        case  0: stat=decode_sbstype2 (msg,nav->sbssat); break;
+        case  1: stat=decode_sbstype1 (msg,nav->sbssat); break;
         case  2:
         case  3:
         case  4:
-        case  5: stat=decode_sbstype2 (msg,&nav->sbssat); break;
-        case  6: stat=decode_sbstype6 (msg,&nav->sbssat); break;
-        case  7: stat=decode_sbstype7 (msg,&nav->sbssat); break;
-        case  9: stat=decode_sbstype9 (msg,nav);          break;
-        case 18: stat=decode_sbstype18(msg,nav ->sbsion); break;
-        case 24: stat=decode_sbstype24(msg,&nav->sbssat); break;
-        case 25: stat=decode_sbstype25(msg,&nav->sbssat); break;
-        case 26: stat=decode_sbstype26(msg,nav ->sbsion); break;
+        case  5: stat=decode_sbstype2 (msg,nav->sbssat); break;
+        case  6: stat=decode_sbstype6 (msg,nav->sbssat); break;
+        case  7: stat=decode_sbstype7 (msg,nav->sbssat); break;
+        case  9: stat=decode_sbstype9 (msg,nav);         break;
+        case 18: stat=decode_sbstype18(msg,nav->sbsion); break;
+        case 24: stat=decode_sbstype24(msg,nav->sbssat); break;
+        case 25: stat=decode_sbstype25(msg,nav->sbssat); break;
+        case 26: stat=decode_sbstype26(msg,nav->sbsion); break;
         case 63: break; /* null message */
         
         /*default: trace(2,"unsupported sbas message: type=%d\n",type); break;*/
@@ -670,6 +671,10 @@ extern int sbsioncorr(gtime_t time, const nav_t *nav, const double *pos,
     *delay=*var=0.0;
     if (pos[2]<-100.0||azel[1]<=0) return 1;
     
+    if (!nav->sbsion) {
+        trace(2,"no sbas ionospheric correction\n");
+        return 0;
+    }
     /* ipp (ionospheric pierce point) position */
     fp=ionppp(pos,azel,re,hion,posp);
     
@@ -860,12 +865,16 @@ extern int sbssatcorr(gtime_t time, int sat, const nav_t *nav, double *rs,
     
     trace(3,"sbssatcorr : sat=%2d\n",sat);
     
+    if (!nav->sbssat) {
+        trace(2,"no sbas satellite correction: sat=%2d\n",sat);
+        return 0;
+    }
     /* sbas long term corrections */
-    if (!sbslongcorr(time,sat,&nav->sbssat,drs,&dclk)) {
+    if (!sbslongcorr(time,sat,nav->sbssat,drs,&dclk)) {
         return 0;
     }
     /* sbas fast corrections */
-    if (!sbsfastcorr(time,sat,&nav->sbssat,&prc,var)) {
+    if (!sbsfastcorr(time,sat,nav->sbssat,&prc,var)) {
         return 0;
     }
     for (i=0;i<3;i++) rs[i]+=drs[i];
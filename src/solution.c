@@ -44,6 +44,10 @@
 *           2016/07/30  1.15 suppress output if std is over opt->maxsolstd
 *           2017/06/13  1.16 support output/input of velocity solution
 *           2018/10/10  1.17 support reading solution status file
+*           2026/10/17  1.18 decode numbers and time without atof()/sscanf()
+*                            support binary solution status file
+*                            add api convsolstat()
+*                            output batch solution type in header
 *-----------------------------------------------------------------------------*/
 #include <ctype.h>
 #include "rtklib.h"
@@ -58,6 +62,15 @@
 
 #define KNOT2M     0.514444444  /* m/knot */
 
+#define STATB_SYNC1 0xB5        /* binary solution status sync code 1 */
+#define STATB_SYNC2 0x53        /* binary solution status sync code 2 */
+#define STATB_EPOCH 1           /* binary solution status frame type: epoch */
+#define STATB_INDEX 2           /* binary solution status frame type: index */
+#define STATB_HLEN  24          /* binary solution status header length */
+#define STATB_RLEN  60          /* binary solution status record length */
+#define STATB_NBLK  256         /* number of epochs per index block */
+#define STATB_MAXLEN 0x10000000 /* max length of binary solution status frame */
+
 static const int solq_nmea[]={  /* nmea quality flags to rtklib sol quality */
     /* nmea 0183 v.2.3 quality flags: */
     /*  0=invalid, 1=gps fix (sps), 2=dgps fix, 3=pps fix, 4=rtk, 5=float rtk */
@@ -66,6 +79,13 @@ static const int solq_nmea[]={  /* nmea quality flags to rtklib sol quality */
     SOLQ_NONE ,SOLQ_SINGLE, SOLQ_DGPS, SOLQ_PPP , SOLQ_FIX,
     SOLQ_FLOAT,SOLQ_DR    , SOLQ_NONE, SOLQ_NONE, SOLQ_NONE
 };
+/* get fields (little-endian) ------------------------------------------------*/
+static unsigned short U2(const unsigned char *p) {unsigned short u; memcpy(&u,p,2); return u;}
+static unsigned int   U4(const unsigned char *p) {unsigned int   u; memcpy(&u,p,4); return u;}
+static int            I4(const unsigned char *p) {int            i; memcpy(&i,p,4); return i;}
+static float          R4(const unsigned char *p) {float          r; memcpy(&r,p,4); return r;}
+static double         R8(const unsigned char *p) {double         r; memcpy(&r,p,8); return r;}
+
 /* solution option to field separator ----------------------------------------*/
 static const char *opt2sep(const solopt_t *opt)
 {
@@ -73,6 +93,27 @@ static const char *opt2sep(const solopt_t *opt)
     else if (!strcmp(opt->sep,"\\t")) return "\t";
     return opt->sep;
 }
+/* string to number ----------------------------------------------------------*/
+static double str2dbl(const char *s)
+{
+    double value;
+    
+    str2dec(s,(int)strlen(s),&value);
+    return value;
+}
+/* string to epoch with separators -------------------------------------------*/
+static int str2ep(const char *buff, const char *sep, double *v)
+{
+    const char *p=buff,*e=buff+strlen(buff);
+    int i,k;
+    
+    /* same as sscanf("%lf/%lf/%lf %lf:%lf:%lf") for sep="// ::" */
+    for (i=0;i<6;i++,p+=k) {
+        if (i>0&&sep[i-1]!=' '&&*p++!=sep[i-1]) break;
+        if (!(k=str2dec(p,(int)(e-p),v+i))) break;
+    }
+    return i;
+}
 /* separate fields -----------------------------------------------------------*/
 static int tonum(char *buff, const char *sep, double *v)
 {
@@ -81,7 +122,7 @@ static int tonum(char *buff, const char *sep, double *v)
     
     for (p=buff,n=0;n<MAXFIELD;p=q+len) {
         if ((q=strstr(p,sep))) *q='\0'; 
-        if (*p) v[n++]=atof(p);
+        if (*p) v[n++]=str2dbl(p);
         if (!q) break;
     }
     return n;
@@ -156,16 +197,16 @@ static int decode_nmearmc(char **val, int n, sol_t *sol)
     
     for (i=0;i<n;i++) {
         switch (i) {
-            case  0: tod =atof(val[i]); break; /* time in utc (hhmmss) */
+            case  0: tod =str2dbl(val[i]); break; /* time in utc (hhmmss) */
             case  1: act =*val[i];      break; /* A=active,V=void */
-            case  2: lat =atof(val[i]); break; /* latitude (ddmm.mmm) */
+            case  2: lat =str2dbl(val[i]); break; /* latitude (ddmm.mmm) */
             case  3: ns  =*val[i];      break; /* N=north,S=south */
-            case  4: lon =atof(val[i]); break; /* longitude (dddmm.mmm) */
+            case  4: lon =str2dbl(val[i]); break; /* longitude (dddmm.mmm) */
             case  5: ew  =*val[i];      break; /* E=east,W=west */
-            case  6: vel =atof(val[i]); break; /* speed (knots) */
-            case  7: dir =atof(val[i]); break; /* track angle (deg) */
-            case  8: date=atof(val[i]); break; /* date (ddmmyy) */
-            case  9: ang =atof(val[i]); break; /* magnetic variation */
+            case  6: vel =str2dbl(val[i]); break; /* speed (knots) */
+            case  7: dir =str2dbl(val[i]); break; /* track angle (deg) */
+            case  8: date=str2dbl(val[i]); break; /* date (ddmmyy) */
+            case  9: ang =str2dbl(val[i]); break; /* magnetic variation */
             case 10: mew =*val[i];      break; /* E=east,W=west */
             case 11: mode=*val[i];      break; /* mode indicator (>nmea 2) */
                                       /* A=autonomous,D=differential */
@@ -204,10 +245,10 @@ static int decode_nmeazda(char **val, int n, sol_t *sol)
     
     for (i=0;i<n;i++) {
         switch (i) {
-            case  0: tod  =atof(val[i]); break; /* time in utc (hhmmss) */
-            case  1: ep[2]=atof(val[i]); break; /* day (0-31) */
-            case  2: ep[1]=atof(val[i]); break; /* mon (1-12) */
-            case  3: ep[0]=atof(val[i]); break; /* year */
+            case  0: tod  =str2dbl(val[i]); break; /* time in utc (hhmmss) */
+            case  1: ep[2]=str2dbl(val[i]); break; /* day (0-31) */
+            case  2: ep[1]=str2dbl(val[i]); break; /* mon (1-12) */
+            case  3: ep[0]=str2dbl(val[i]); break; /* year */
         }
     }
     septime(tod,ep+3,ep+4,ep+5);
@@ -231,17 +272,17 @@ static int decode_nmeagga(char **val, int n, sol_t *sol)
     
     for (i=0;i<n;i++) {
         switch (i) {
-            case  0: tod =atof(val[i]); break; /* time in utc (hhmmss) */
-            case  1: lat =atof(val[i]); break; /* latitude (ddmm.mmm) */
+            case  0: tod =str2dbl(val[i]); break; /* time in utc (hhmmss) */
+            case  1: lat =str2dbl(val[i]); break; /* latitude (ddmm.mmm) */
             case  2: ns  =*val[i];      break; /* N=north,S=south */
-            case  3: lon =atof(val[i]); break; /* longitude (dddmm.mmm) */
+            case  3: lon =str2dbl(val[i]); break; /* longitude (dddmm.mmm) */
             case  4: ew  =*val[i];      break; /* E=east,W=west */
             case  5: solq=atoi(val[i]); break; /* fix quality */
             case  6: nrcv=atoi(val[i]); break; /* # of satellite tracked */
-            case  7: hdop=atof(val[i]); break; /* hdop */
-            case  8: alt =atof(val[i]); break; /* altitude in msl */
+            case  7: hdop=str2dbl(val[i]); break; /* hdop */
+            case  8: alt =str2dbl(val[i]); break; /* altitude in msl */
             case  9: ua  =*val[i];      break; /* unit (M) */
-            case 10: msl =atof(val[i]); break; /* height of geoid */
+            case 10: msl =str2dbl(val[i]); break; /* height of geoid */
             case 11: um  =*val[i];      break; /* unit (M) */
         }
     }
@@ -338,7 +379,7 @@ static char *decode_soltime(char *buff, const solopt_t *opt, gtime_t *time)
         return buff;
     }
     /* yyyy/mm/dd hh:mm:ss or yyyy mm dd hh:mm:ss */
-    if (sscanf(buff,"%lf/%lf/%lf %lf:%lf:%lf",v,v+1,v+2,v+3,v+4,v+5)>=6) {
+    if (str2ep(buff,"// ::",v)>=6) {
         if (v[0]<100.0) {
             v[0]+=v[0]<80.0?2000.0:1900.0;
         }
@@ -354,7 +395,7 @@ static char *decode_soltime(char *buff, const solopt_t *opt, gtime_t *time)
         return p+len;
     }
     if (opt->posf==SOLF_GSIF) {
-        if (sscanf(buff,"%lf %lf %lf %lf:%lf:%lf",v,v+1,v+2,v+3,v+4,v+5)<6) {
+        if (str2ep(buff,"   ::",v)<6) {
             return NULL;
         }
         *time=timeadd(epoch2time(v),-12.0*3600.0);
@@ -365,7 +406,7 @@ static char *decode_soltime(char *buff, const solopt_t *opt, gtime_t *time)
     /* wwww ssss */
     for (p=buff,n=0;n<2;p=q+len) {
         if ((q=strstr(p,s))) *q='\0'; 
-        if (*p) v[n++]=atof(p);
+        if (*p) v[n++]=str2dbl(p);
         if (!q) break;
     }
     if (n>=2&&0.0<=v[0]&&v[0]<=3000.0&&0.0<=v[1]&&v[1]<604800.0) {
@@ -1072,6 +1113,158 @@ static int readsolstatdata(FILE *fp, gtime_t ts, gtime_t te, double tint,
     }
     return statbuf->n>0;
 }
+/* read frame of binary solution status after sync code 1 --------------------*/
+static int readframe(FILE *fp, unsigned char **buff, int *nmax)
+{
+    unsigned char h[STATB_HLEN],*p;
+    unsigned int len;
+    int n;
+    
+    h[0]=STATB_SYNC1;
+    if (fread(h+1,1,STATB_HLEN-1,fp)<STATB_HLEN-1) return 0;
+    
+    if (h[1]!=STATB_SYNC2||(h[2]!=STATB_EPOCH&&h[2]!=STATB_INDEX)||
+        (len=U4(h+4))>STATB_MAXLEN) {
+        return 0;
+    }
+    n=STATB_HLEN+(int)len;
+    if (n+3>*nmax) {
+        if (!(p=(unsigned char *)realloc(*buff,n+3))) {
+            trace(1,"readframe: memory allocation error\n");
+            return 0;
+        }
+        *buff=p; *nmax=n+3;
+    }
+    memcpy(*buff,h,STATB_HLEN);
+    if (fread(*buff+STATB_HLEN,1,len+3,fp)<len+3) return 0;
+    
+    if (rtk_crc24q(*buff,n)!=getbitu(*buff,n*8,24)) {
+        trace(2,"binary solution status crc error: len=%d\n",n);
+        return 0;
+    }
+    return n;
+}
+/* read next frame of binary solution status ---------------------------------*/
+static int readstatb(FILE *fp, unsigned char **buff, int *nmax)
+{
+    long pos;
+    int c,n;
+    
+    while ((c=fgetc(fp))!=EOF) {
+        if (c!=STATB_SYNC1) continue;
+        pos=ftell(fp);
+        if ((n=readframe(fp,buff,nmax))>0) return n;
+        if (feof(fp)||fseek(fp,pos,SEEK_SET)) break; /* resync */
+    }
+    return 0;
+}
+/* read epoch index of binary solution status ----------------------------------
+* return index blocks as {tmin,tmax,offset} (number of blocks, 0: no index)
+*-----------------------------------------------------------------------------*/
+static int readstatidx(FILE *fp, unsigned char **buff, int *nmax, double **idx)
+{
+    unsigned char tail[12],*p;
+    double off;
+    int i,n,nidx;
+    
+    trace(3,"readstatidx:\n");
+    
+    if (fseek(fp,-12,SEEK_END)||fread(tail,12,1,fp)<1||
+        memcmp(tail+8,"STBX",4)) {
+        return 0;
+    }
+    off=U4(tail+4)*4294967296.0+U4(tail);
+    
+    if (fseek(fp,(long)off,SEEK_SET)||fgetc(fp)!=STATB_SYNC1||
+        !(n=readframe(fp,buff,nmax))||(*buff)[2]!=STATB_INDEX) {
+        trace(2,"binary solution status index error: offset=%.0f\n",off);
+        return 0;
+    }
+    nidx=(n-STATB_HLEN)/24;
+    if (nidx<=0||!(*idx=(double *)malloc(sizeof(double)*3*nidx))) return 0;
+    
+    for (i=0,p=*buff+STATB_HLEN;i<nidx;i++,p+=24) {
+        (*idx)[i*3  ]=R8(p);
+        (*idx)[i*3+1]=R8(p+8);
+        (*idx)[i*3+2]=U4(p+20)*4294967296.0+U4(p+16);
+    }
+    return nidx;
+}
+/* decode epoch frame of binary solution status ------------------------------*/
+static int decode_solstatb(const unsigned char *buff, gtime_t ts, gtime_t te,
+                           double tint, solstatbuf_t *statbuf)
+{
+    solstat_t stat={{0}};
+    const unsigned char *p;
+    int i,nrec;
+    
+    if (buff[2]!=STATB_EPOCH) return 0;
+    
+    stat.time=gpst2time(U2(buff+8),R8(buff+12));
+    
+    if (!screent(stat.time,ts,te,tint)) return 0;
+    
+    nrec=U2(buff+10);
+    p=buff+STATB_HLEN+U2(buff+20);
+    
+    if (U2(buff+20)+nrec*STATB_RLEN>(int)U4(buff+4)) {
+        trace(2,"invalid binary solution status: nrec=%d\n",nrec);
+        return 0;
+    }
+    for (i=0;i<nrec;i++,p+=STATB_RLEN) {
+        stat.sat  =p[0];
+        stat.frq  =p[1];
+        stat.flag =p[2];
+        stat.snr  =p[3];
+        stat.az   =R4(p+ 4);
+        stat.el   =R4(p+ 8);
+        stat.resp =R4(p+12);
+        stat.resc =R4(p+16);
+        stat.lock =(unsigned short)I4(p+20);
+        stat.outc =(unsigned short)U4(p+24);
+        stat.slipc=(unsigned short)U4(p+28);
+        stat.rejc =(unsigned short)U4(p+32);
+        addsolstat(statbuf,&stat);
+    }
+    return nrec;
+}
+/* read binary solution status data ------------------------------------------*/
+static int readsolstatb(FILE *fp, gtime_t ts, gtime_t te, double tint,
+                        solstatbuf_t *statbuf)
+{
+    unsigned char *buff=NULL;
+    double *idx=NULL,t0=-1E99,t1=1E99;
+    int i,j,week,nidx=0,nmax=0;
+    
+    trace(3,"readsolstatb:\n");
+    
+    /* read epoch index for time range */
+    if (ts.time||te.time) {
+        nidx=readstatidx(fp,&buff,&nmax,&idx);
+    }
+    if (nidx<=0) { /* read all frames */
+        rewind(fp);
+        while (readstatb(fp,&buff,&nmax)) {
+            decode_solstatb(buff,ts,te,tint,statbuf);
+        }
+    }
+    else { /* read frames in index blocks overlapping time range */
+        if (ts.time) t0=time2gpst(ts,&week)+week*604800.0-DTTOL;
+        if (te.time) t1=time2gpst(te,&week)+week*604800.0+DTTOL;
+        
+        for (i=0;i<nidx;i++) {
+            if (idx[i*3+1]<t0||idx[i*3]>t1) continue;
+            if (fseek(fp,(long)idx[i*3+2],SEEK_SET)) continue;
+            for (j=0;j<STATB_NBLK&&readstatb(fp,&buff,&nmax);j++) {
+                if (buff[2]!=STATB_EPOCH) break;
+                decode_solstatb(buff,ts,te,tint,statbuf);
+            }
+        }
+    }
+    free(buff);
+    free(idx);
+    return statbuf->n>0;
+}
 /* read solution status --------------------------------------------------------
 * read solution status from solution status files
 * args   : char   *files[]  I  solution status files
@@ -1081,13 +1274,16 @@ static int readsolstatdata(FILE *fp, gtime_t ts, gtime_t te, double tint,
 *         (double tint)     I  time interval (0: all)
 *          solstatbuf_t *statbuf O  solution status buffer
 * return : status (1:ok,0:no data or error)
+* notes  : text and binary solution status files are distinguished by the
+*          first byte. for binary files with the epoch index, only the frames
+*          in the time range are read.
 *-----------------------------------------------------------------------------*/
 extern int readsolstatt(char *files[], int nfile, gtime_t ts, gtime_t te,
                         double tint, solstatbuf_t *statbuf)
 {
     FILE *fp;
     char path[1024],*p;
-    int i;
+    int i,stat;
     
     trace(3,"readsolstatt: nfile=%d\n",nfile);
     
@@ -1101,12 +1297,19 @@ extern int readsolstatt(char *files[], int nfile, gtime_t ts, gtime_t te,
         else {
         sprintf(path,"%s.stat",files[i]);
         }
-        if (!(fp=fopen(path,"r"))) {
+        if (!(fp=fopen(path,"rb"))) {
             trace(2,"readsolstatt: file open error %s\n",path);
             continue;
         }
         /* read solution status data */
-        if (!readsolstatdata(fp,ts,te,tint,statbuf)) {
+        if (fgetc(fp)==STATB_SYNC1) {
+            stat=readsolstatb(fp,ts,te,tint,statbuf);
+        }
+        else {
+            rewind(fp);
+            stat=readsolstatdata(fp,ts,te,tint,statbuf);
+        }
+        if (!stat) {
             trace(2,"readsolstatt: no solution in %s\n",path);
         }
         fclose(fp);
@@ -1121,6 +1324,61 @@ extern int readsolstat(char *files[], int nfile, solstatbuf_t *statbuf)
     
     return readsolstatt(files,nfile,time,time,0.0,statbuf);
 }
+/* convert binary solution status to text --------------------------------------
+* convert binary solution status file to text solution status file
+* args   : char   *infile   I  binary solution status file
+*          char   *outfile  I  text solution status file
+* return : number of epochs converted (-1: file open error)
+* notes  : see rtkopenstat() for the formats. $SAT records are output in the
+*          precision of the binary fields (single precision except bias and
+*          bias_var).
+*-----------------------------------------------------------------------------*/
+extern int convsolstat(const char *infile, const char *outfile)
+{
+    FILE *ifp,*ofp;
+    unsigned char *buff=NULL,*p;
+    double tow;
+    char id[32];
+    int i,week,nrec,nmax=0,ne=0;
+    
+    trace(3,"convsolstat: infile=%s outfile=%s\n",infile,outfile);
+    
+    if (!(ifp=fopen(infile,"rb"))) {
+        trace(2,"convsolstat: file open error %s\n",infile);
+        return -1;
+    }
+    if (!(ofp=fopen(outfile,"w"))) {
+        trace(2,"convsolstat: file open error %s\n",outfile);
+        fclose(ifp);
+        return -1;
+    }
+    while (readstatb(ifp,&buff,&nmax)) {
+        if (buff[2]!=STATB_EPOCH) continue;
+        week=U2(buff+8);
+        tow =R8(buff+12);
+        nrec=U2(buff+10);
+        if (U2(buff+20)+nrec*STATB_RLEN>(int)U4(buff+4)) continue;
+        
+        /* states */
+        fwrite(buff+STATB_HLEN,1,U2(buff+20),ofp);
+        
+        /* residuals and status */
+        p=buff+STATB_HLEN+U2(buff+20);
+        for (i=0;i<nrec;i++,p+=STATB_RLEN) {
+            satno2id(p[0],id);
+            fprintf(ofp,"$SAT,%d,%.3f,%s,%d,%.1f,%.1f,%.4f,%.4f,%d,%.0f,%d,%d,%d,%d,%d,%d,%.2f,%.6f,%.5f,%.5f\n",
+                    week,tow,id,p[1],R4(p+4)*R2D,R4(p+8)*R2D,R4(p+12),
+                    R4(p+16),p[2]>>5,p[3]*0.25,p[2]&7,(p[2]>>3)&3,I4(p+20),
+                    (int)U4(p+24),(int)U4(p+28),(int)U4(p+32),R8(p+36),
+                    R8(p+44),R4(p+52),R4(p+56));
+        }
+        ne++;
+    }
+    free(buff);
+    fclose(ifp);
+    fclose(ofp);
+    return ne;
+}
 /* output solution as the form of x/y/z-ecef ---------------------------------*/
 static int outecef(unsigned char *buff, const char *s, const sol_t *sol,
                    const solopt_t *opt)
@@ -1478,7 +1736,7 @@ extern int outprcopts(unsigned char *buff, const prcopt_t *opt)
     const char *s1[]={"single","dgps","kinematic","static","static-start","moving-base","fixed",
                  "ppp-kinematic","ppp-static","ppp-fixed",""};
     const char *s2[]={"L1","L1+L2/E5b","L1+L2/E5b+L5","L1+L2/E5b+L5+L6"};
-    const char *s3[]={"forward","backward","combined"};
+    const char *s3[]={"forward","backward","combined","batch"};
     const char *s4[]={"off","broadcast","sbas","iono-free","estimation",
                       "ionex tec","qzs","lex","vtec_sf","vtec_ef","gtec",""};
     const char *s5[]={"off","saastamoinen","sbas","est ztd","est ztd+grad",""};
@@ -1553,7 +1811,8 @@ extern int outsolheads(unsigned char *buff, const solopt_t *opt)
     
     trace(3,"outsolheads:\n");
     
-    if (opt->posf==SOLF_NMEA||opt->posf==SOLF_STAT||opt->posf==SOLF_GSIF) {
+    if (opt->posf==SOLF_NMEA||opt->posf==SOLF_STAT||opt->posf==SOLF_STATB||
+        opt->posf==SOLF_GSIF) {
         return 0;
     }
     if (opt->outhead) {
@@ -48,6 +48,7 @@ SOURCES += rtkcmn.c \
     streamsvr.c \
     tides.c \
     tle.c \
+    obsqc.c \
     rcv/binex.c \
     rcv/crescent.c \
     rcv/gw10.c \
@@ -64,6 +64,11 @@
 *                           update trace levels and buffer sizes
 *           2019/05/10 1.27 fix bug on dropping message on tcp stream (#144)
 *           2019/08/19 1.28 support 460800 and 921600 bps for serial
+*           2026/10/17 1.29 add metrics server functions
+*                           add api metinit(),metadd(),metclose(),strmetric(),
+*                           metsvrstart(),metsvrstop()
+*                           add api strsetthrd()
+*                           bind metrics server to loopback address by default
 *-----------------------------------------------------------------------------*/
 #include <ctype.h>
 #include "rtklib.h"
@@ -112,6 +117,11 @@
 #define FTP_CMD             "wget"      /* ftp/http command */
 #define FTP_TIMEOUT         30          /* ftp/http timeout (s) */
 
+#define MET_MAXREQ          1024        /* max length of metrics request */
+#define MET_MAXBUF          262144      /* max size of metrics output (bytes) */
+#define MET_CYCLE           10          /* metrics server cycle (ms) */
+#define MET_TIMEOUT         5000        /* metrics request timeout (ms) */
+
 #define MIN(x,y)            ((x)<(y)?(x):(y))
 
 /* macros --------------------------------------------------------------------*/
@@ -220,6 +230,13 @@ typedef struct {            /* ntrip caster control type */
     ntripc_con_t con[MAXCLI]; /* ntrip caster connections */
 } ntripc_t;
 
+typedef struct {            /* metrics server control type */
+    tcpsvr_t *tcp;          /* tcp server */
+    int nb[MAXCLI];         /* request lengths (bytes) */
+    char req[MAXCLI][MET_MAXREQ]; /* request buffers */
+    char *buff;             /* metrics output buffer */
+} metctl_t;
+
 typedef struct {            /* udp type */
     int state;              /* state (0:close,1:open) */
     int type;               /* type (0:server,1:client) */
@@ -253,7 +270,7 @@ typedef struct {            /* memory buffer type */
 
 /* proto types for static functions ------------------------------------------*/
 
-static tcpsvr_t *opentcpsvr(const char *path, char *msg);
+static tcpsvr_t *opentcpsvr(const char *path, int type, char *msg);
 static void closetcpsvr(tcpsvr_t *tcpsvr);
 static int writetcpsvr(tcpsvr_t *tcpsvr, unsigned char *buff, int n, char *msg);
 
@@ -267,7 +284,16 @@ static char localdir[1024]=""; /* local directory for ftp/http */
 static char proxyaddr[256]=""; /* http/ntrip/ftp proxy address */
 static unsigned int tick_master=0; /* time tick master for replay */
 static int fswapmargin=30;  /* file swap margin (s) */
+static thrdopt_t thrdopt={"",-1,THRDPOL_OTHER,0}; /* stream thread options */
 
+/* set options of stream thread ----------------------------------------------*/
+static void setstrthrd(const char *name)
+{
+    thrdopt_t opt=thrdopt;
+    
+    strcpy(opt.name,name);
+    setthrdopt(&opt);
+}
 /* read/write serial buffer --------------------------------------------------*/
 #ifdef WIN32
 static int readseribuff(serial_t *serial, unsigned char *buff, int nmax)
@@ -319,6 +345,8 @@ static DWORD WINAPI serialthread(void *arg)
     
     tracet(3,"serialthread:\n");
     
+    setstrthrd("strserial");
+    
     for (;;) {
         tick=tickget();
         while ((n=readseribuff(serial,buff,sizeof(buff)))>0) {
@@ -472,7 +500,7 @@ static serial_t *openserial(const char *path, int mode, char *msg)
     /* open tcp sever to output received stream */
     if (tcp_port>0) {
         sprintf(path_tcp,":%d",tcp_port);
-        serial->tcpsvr=opentcpsvr(path_tcp,msg_tcp);
+        serial->tcpsvr=opentcpsvr(path_tcp,0,msg_tcp);
     }
     tracet(3,"openserial: dev=%d\n",serial->dev);
     return serial;
@@ -1056,7 +1084,7 @@ static int send_nb(socket_t sock, unsigned char *buff, int n)
     ns=send(sock,(char *)buff,n,0);
     return ns<n?-1:ns;
 }
-/* generate tcp socket -------------------------------------------------------*/
+/* generate tcp socket (type 0:server,1:client,2:server bound to address) ----*/
 static int gentcp(tcp_t *tcp, int type, char *msg)
 {
     struct hostent *hp;
@@ -1081,8 +1109,20 @@ static int gentcp(tcp_t *tcp, int type, char *msg)
     tcp->addr.sin_family=AF_INET;
     tcp->addr.sin_port=htons(tcp->port);
     
-    if (type==0) { /* server socket */
-    
+    if (type!=1) { /* server socket */
+        
+        /* bind to address of server (type 2) or any address */
+        if (type==2) {
+            if (!(hp=gethostbyname(tcp->saddr))) {
+                sprintf(msg,"address error (%s)",tcp->saddr);
+                tracet(1,"gentcp: gethostbyname error addr=%s err=%d\n",
+                       tcp->saddr,errsock());
+                closesocket(tcp->sock);
+                tcp->state=-1;
+                return 0;
+            }
+            memcpy(&tcp->addr.sin_addr,hp->h_addr,hp->h_length);
+        }
 #ifdef SVR_REUSEADDR
         /* multiple-use of server socket */
         setsockopt(tcp->sock,SOL_SOCKET,SO_REUSEADDR,(const char *)&opt,
@@ -1124,8 +1164,8 @@ static void discontcp(tcp_t *tcp, int tcon)
     tcp->tcon=tcon;
     tcp->tdis=tickget();
 }
-/* open tcp server -----------------------------------------------------------*/
-static tcpsvr_t *opentcpsvr(const char *path, char *msg)
+/* open tcp server (type 0:any address,2:address in path) --------------------*/
+static tcpsvr_t *opentcpsvr(const char *path, int type, char *msg)
 {
     tcpsvr_t *tcpsvr,tcpsvr0={{0}};
     char port[256]="";
@@ -1141,7 +1181,7 @@ static tcpsvr_t *opentcpsvr(const char *path, char *msg)
         free(tcpsvr);
         return NULL;
     }
-    if (!gentcp(&tcpsvr->svr,0,msg)) {
+    if (!gentcp(&tcpsvr->svr,type,msg)) {
         free(tcpsvr);
         return NULL;
     }
@@ -1795,7 +1835,7 @@ static ntripc_t *openntripc(const char *path, int type, char *msg)
     sprintf(tpath,":%s",port);
     
     /* open tcp server stream */
-    if (!(ntripc->tcp=opentcpsvr(tpath,msg))) {
+    if (!(ntripc->tcp=opentcpsvr(tpath,0,msg))) {
         tracet(2,"openntripc: opentcpsvr error port=%d\n",port);
         free(ntripc);
         return NULL;
@@ -2365,6 +2405,8 @@ static void *ftpthread(void *arg)
     
     tracet(3,"ftpthread:\n");
     
+    setstrthrd("strftp");
+    
     if (!*localdir) {
         tracet(2,"no local directory\n");
         ftp->error=11;
@@ -2796,7 +2838,7 @@ extern int stropen(stream_t *stream, int type, int mode, const char *path)
     switch (type) {
         case STR_SERIAL  : stream->port=openserial(path,mode,stream->msg); break;
         case STR_FILE    : stream->port=openfile  (path,mode,stream->msg); break;
-        case STR_TCPSVR  : stream->port=opentcpsvr(path,     stream->msg); break;
+        case STR_TCPSVR  : stream->port=opentcpsvr(path,0,   stream->msg); break;
         case STR_TCPCLI  : stream->port=opentcpcli(path,     stream->msg); break;
         case STR_NTRIPSVR: stream->port=openntrip (path,0,   stream->msg); break;
         case STR_NTRIPCLI: stream->port=openntrip (path,1,   stream->msg); break;
@@ -3190,6 +3232,18 @@ extern void strsetopt(const int *opt)
     buffsize   =opt[3]<4096?4096:opt[3]; /* >=4096byte */
     fswapmargin=opt[4]<0?0:opt[4];
 }
+/* set stream thread options ---------------------------------------------------
+* set thread options of serial (windows), ftp/http and metrics server threads
+* args   : thrdopt_t *opt   I   thread options (name ignored)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void strsetthrd(const thrdopt_t *opt)
+{
+    tracet(3,"strsetthrd: cpu=%d policy=%d prio=%d\n",opt->cpu,opt->policy,
+           opt->prio);
+    
+    thrdopt=*opt;
+}
 /* set timeout time ------------------------------------------------------------
 * set timeout time
 * args   : stream_t *stream I   stream (STR_TCPCLI,STR_NTRIPCLI,STR_NTRIPSVR)
@@ -3361,4 +3415,322 @@ extern void strsendcmd(stream_t *str, const char *cmd)
         }
         if (*q=='\0') break; else p=q+1;
     }
-}
\ No newline at end of file
+}
+/* initialize metrics buffer ---------------------------------------------------
+* initialize metrics buffer for output
+* args   : metbuf_t *met    O   metrics buffer
+*          int    fmt       I   format (METF_PROM:prometheus text,METF_JSON:json)
+*          char   *buff     I   output buffer
+*          int    nmax      I   size of output buffer (bytes)
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void metinit(metbuf_t *met, int fmt, char *buff, int nmax)
+{
+    met->fmt=fmt;
+    met->buff=buff;
+    met->nmax=nmax;
+    met->n=met->nmet=0;
+    met->name[0]='\0';
+    if (nmax>0) buff[0]='\0';
+    
+    if (fmt==METF_JSON&&nmax>16) {
+        met->n=sprintf(buff,"{\"metrics\":[");
+    }
+}
+/* add metric ------------------------------------------------------------------
+* add a sample of metric to metrics buffer
+* args   : metbuf_t *met    IO  metrics buffer
+*          char   *name     I   metric name
+*          char   *type     I   metric type ("counter","gauge")
+*          char   *help     I   metric help
+*          char   *label    I   labels (name="value",...) ("":no label)
+*          double value     I   value
+* return : none
+* notes  : samples of a metric should be added in succession, since help and
+*          type are output to prometheus text if the name differs from that
+*          of the last sample. samples not fit in the buffer are discarded.
+*-----------------------------------------------------------------------------*/
+extern void metadd(metbuf_t *met, const char *name, const char *type,
+                   const char *help, const char *label, double value)
+{
+    const char *p;
+    char *q;
+    int len;
+    
+    len=(int)(2*strlen(name)+strlen(type)+strlen(help)+2*strlen(label))+128;
+    if (met->n+len>=met->nmax) return;
+    if (value!=value) value=0.0;
+    
+    q=met->buff+met->n;
+    
+    if (met->fmt==METF_JSON) {
+        q+=sprintf(q,"%s\n{\"name\":\"%s\",\"type\":\"%s\",\"labels\":{",
+                   met->nmet>0?",":"",name,type);
+        for (p=label;*p;p++) { /* name="value" -> "name":"value" */
+            if (p==label||p[-1]==',') *q++='"';
+            if (*p=='=') {
+                *q++='"'; *q++=':';
+            }
+            else *q++=*p;
+        }
+        q+=sprintf(q,"},\"value\":%.15g}",value);
+    }
+    else {
+        if (strcmp(name,met->name)) {
+            q+=sprintf(q,"# HELP %s %s\n# TYPE %s %s\n",name,help,name,type);
+        }
+        if (*label) q+=sprintf(q,"%s{%s} %.15g\n",name,label,value);
+        else        q+=sprintf(q,"%s %.15g\n",name,value);
+    }
+    met->n=(int)(q-met->buff);
+    met->nmet++;
+    strncpy(met->name,name,sizeof(met->name)-1);
+    met->name[sizeof(met->name)-1]='\0';
+}
+/* close metrics buffer --------------------------------------------------------
+* close metrics buffer
+* args   : metbuf_t *met    IO  metrics buffer
+* return : length of metrics output (bytes)
+*-----------------------------------------------------------------------------*/
+extern int metclose(metbuf_t *met)
+{
+    if (met->fmt==METF_JSON&&met->n+8<met->nmax) {
+        met->n+=sprintf(met->buff+met->n,"\n]}\n");
+    }
+    return met->n;
+}
+/* add stream metrics ----------------------------------------------------------
+* add metrics of streams to metrics buffer
+* args   : metbuf_t *met    IO  metrics buffer
+*          stream_t *stream I   streams
+*          char   **name    I   stream names for label
+*          int    n         I   number of streams
+* return : none
+* notes  : the counters of streams are read without lock.
+*-----------------------------------------------------------------------------*/
+extern void strmetric(metbuf_t *met, stream_t *stream, const char **name,
+                      int n)
+{
+    char label[256];
+    int i,j;
+    
+    for (i=0;i<5;i++) for (j=0;j<n;j++) {
+        if (stream[j].type==STR_NONE) continue;
+        sprintf(label,"stream=\"%.200s\"",name[j]);
+        switch (i) {
+            case 0: metadd(met,"rtklib_stream_state","gauge",
+                           "stream state (-1:error,0:close,1:open)",label,
+                           stream[j].state); break;
+            case 1: metadd(met,"rtklib_stream_in_bytes_total","counter",
+                           "bytes received from stream",label,
+                           stream[j].inb); break;
+            case 2: metadd(met,"rtklib_stream_out_bytes_total","counter",
+                           "bytes sent to stream",label,
+                           stream[j].outb); break;
+            case 3: metadd(met,"rtklib_stream_in_bps","gauge",
+                           "input bit rate of stream (bps)",label,
+                           stream[j].inr); break;
+            case 4: metadd(met,"rtklib_stream_out_bps","gauge",
+                           "output bit rate of stream (bps)",label,
+                           stream[j].outr); break;
+        }
+    }
+}
+/* send all data to socket ---------------------------------------------------*/
+static int send_all(socket_t sock, const char *buff, int n)
+{
+    int ns,nw=0;
+    
+    while (nw<n) {
+        if ((ns=send(sock,buff+nw,n-nw,0))<=0) return 0;
+        nw+=ns;
+    }
+    return 1;
+}
+/* disconnect metrics client -------------------------------------------------*/
+static void discon_metric(metctl_t *ctl, int i)
+{
+    tracet(4,"discon_metric: i=%d\n",i);
+    
+    discontcp(&ctl->tcp->cli[i],0);
+    ctl->nb[i]=0;
+}
+/* respond metrics request ---------------------------------------------------*/
+static int rsp_metric(metsvr_t *svr, metctl_t *ctl, int i)
+{
+    const char *rsp1="HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\n"
+                     "Connection: close\r\n\r\n";
+    const char *type[]={"text/plain; version=0.0.4","application/json"};
+    socket_t sock=ctl->tcp->cli[i].sock;
+    char *req=ctl->req[i],path[256]="",head[256],*p;
+    int fmt=METF_PROM,http,n,len;
+    
+    req[ctl->nb[i]]='\0';
+    
+    /* wait end of request line or http request header */
+    if (!(p=strchr(req,'\n'))) {
+        return ctl->nb[i]>=MET_MAXREQ-1?-1:0;
+    }
+    if ((http=!strncmp(req,"GET ",4))) {
+        if (!strstr(req,"\r\n\r\n")&&!strstr(req,"\n\n")) {
+            return ctl->nb[i]>=MET_MAXREQ-1?-1:0;
+        }
+        sscanf(req+4,"%255s",path);
+        if (strstr(path,"json")) fmt=METF_JSON;
+        else if (strcmp(path,"/")&&strncmp(path,"/metrics",8)) {
+            tracet(2,"rsp_metric: no path %s\n",path);
+            send_all(sock,rsp1,(int)strlen(rsp1));
+            return -1;
+        }
+    }
+    else if (strstr(req,"json")&&strstr(req,"json")<p) {
+        fmt=METF_JSON;
+    }
+    len=svr->func(fmt,ctl->buff,MET_MAXBUF,svr->arg);
+    
+    if (http) {
+        n=sprintf(head,"HTTP/1.0 200 OK\r\nContent-Type: %s\r\n"
+                  "Content-Length: %d\r\nConnection: close\r\n\r\n",
+                  type[fmt],len);
+        if (!send_all(sock,head,n)) return -1;
+    }
+    send_all(sock,ctl->buff,len);
+    svr->nreq++;
+    return -1;
+}
+/* metrics server thread -----------------------------------------------------*/
+#ifdef WIN32
+static DWORD WINAPI metsvrthread(void *arg)
+#else
+static void *metsvrthread(void *arg)
+#endif
+{
+    metsvr_t *svr=(metsvr_t *)arg;
+    metctl_t *ctl=(metctl_t *)svr->svr;
+    char msg[MAXSTRMSG];
+    int i,n;
+    
+    tracet(3,"metsvrthread: addr=%s port=%d\n",svr->addr,svr->port);
+    
+    setstrthrd("metsvr");
+    
+    while (svr->state) {
+        if (waittcpsvr(ctl->tcp,msg)) {
+            for (i=0;i<MAXCLI;i++) {
+                if (ctl->tcp->cli[i].state!=2) continue;
+                
+                n=recv_nb(ctl->tcp->cli[i].sock,
+                          (unsigned char *)ctl->req[i]+ctl->nb[i],
+                          MET_MAXREQ-ctl->nb[i]-1);
+                if (n>0) {
+                    ctl->nb[i]+=n;
+                    ctl->tcp->cli[i].tact=tickget();
+                    if (rsp_metric(svr,ctl,i)<0) discon_metric(ctl,i);
+                }
+                else if (n<0||(int)(tickget()-ctl->tcp->cli[i].tact)>MET_TIMEOUT) {
+                    discon_metric(ctl,i);
+                }
+            }
+        }
+        sleepms(MET_CYCLE);
+    }
+    return 0;
+}
+/* start metrics server --------------------------------------------------------
+* start metrics server on a local tcp port
+* args   : metsvr_t *svr    IO  metrics server
+*          char   *path     I   address and port of server ([addr:]port)
+*                               (addr: bind address, default 127.0.0.1)
+*          metfunc_t func   I   metrics output function
+*                               int func(int fmt, char *buff, int nmax,
+*                                        void *arg)
+*                               (fmt: METF_???, return: output length)
+*          void   *arg      I   argument of metrics output function
+* return : status (0:error,1:ok)
+* notes  : the server responds to a http request (GET /metrics: prometheus
+*          text, GET /metrics.json: json) or a request line of plain tcp
+*          ("metrics": prometheus text, "json": json) and closes connection.
+*          the metrics output function is called in the server thread.
+*          the server is bound to the loopback address unless an address is
+*          given in path (e.g. "0.0.0.0:9100" for all interfaces).
+*-----------------------------------------------------------------------------*/
+extern int metsvrstart(metsvr_t *svr, const char *path, metfunc_t func,
+                       void *arg)
+{
+    metctl_t *ctl;
+    const char *p;
+    char tpath[MAXSTRPATH],msg[MAXSTRMSG]="";
+    
+    tracet(3,"metsvrstart: path=%s\n",path);
+    
+    svr->state=0;
+    svr->nreq=0;
+    svr->func=func;
+    svr->arg=arg;
+    
+    if ((p=strrchr(path,':'))) {
+        sprintf(svr->addr,"%.*s",(int)(p-path)<63?(int)(p-path):63,path);
+        p++;
+    }
+    else {
+        *svr->addr='\0';
+        p=path;
+    }
+    if (!*svr->addr) strcpy(svr->addr,"127.0.0.1");
+    if ((svr->port=atoi(p))<=0) {
+        tracet(1,"metsvrstart: port error path=%s\n",path);
+        return 0;
+    }
+    if (!(ctl=(metctl_t *)calloc(1,sizeof(metctl_t)))) return 0;
+    if (!(ctl->buff=(char *)malloc(MET_MAXBUF))) {
+        free(ctl);
+        return 0;
+    }
+    sprintf(tpath,"%s:%d",svr->addr,svr->port);
+    if (!(ctl->tcp=opentcpsvr(tpath,2,msg))) {
+        tracet(1,"metsvrstart: open error path=%s %s\n",tpath,msg);
+        free(ctl->buff);
+        free(ctl);
+        return 0;
+    }
+    svr->svr=ctl;
+    svr->state=1;
+#ifdef WIN32
+    if (!(svr->thread=CreateThread(NULL,0,metsvrthread,svr,0,NULL))) {
+#else
+    if (pthread_create(&svr->thread,NULL,metsvrthread,svr)) {
+#endif
+        svr->state=0;
+        closetcpsvr(ctl->tcp);
+        free(ctl->buff);
+        free(ctl);
+        svr->svr=NULL;
+        return 0;
+    }
+    return 1;
+}
+/* stop metrics server ---------------------------------------------------------
+* stop metrics server
+* args   : metsvr_t *svr    IO  metrics server
+* return : none
+*-----------------------------------------------------------------------------*/
+extern void metsvrstop(metsvr_t *svr)
+{
+    metctl_t *ctl=(metctl_t *)svr->svr;
+    
+    tracet(3,"metsvrstop:\n");
+    
+    if (!svr->state||!ctl) return;
+    
+    svr->state=0;
+#ifdef WIN32
+    WaitForSingleObject(svr->thread,10000);
+    CloseHandle(svr->thread);
+#else
+    pthread_join(svr->thread,NULL);
+#endif
+    closetcpsvr(ctl->tcp);
+    free(ctl->buff);
+    free(ctl);
+    svr->svr=NULL;
+}
@@ -24,7 +24,11 @@
 *           2016/10/01 1.12 change api startstrserver()
 *           2017/04/11 1.13 fix bug on search of next satellite in nextsat()
 *           2018/11/05 1.14 update message type of beidou ephemeirs
+*           2026/10/17 1.15 input rtcm 3 by frames with input_rtcm3b()
+*                           receive obs and ephemeris by decoder sinks
 *                           support multiple msm messages if nsat x nsig > 64
+*                           add api strsvrmetric()
+*                           set server thread options and measure cycle jitter
 *-----------------------------------------------------------------------------*/
 #include "rtklib.h"
 
@@ -53,6 +57,29 @@ static int is_tint(gtime_t time, double tint)
     if (tint<=0.0) return 1;
     return fmod(time2gpst(time,NULL)+DTTOL,tint)<=2.0*DTTOL;
 }
+/* observation epoch decoded: refer input buffer as output observation data -*/
+static void conv_obs(decsink_t *sink, const obs_t *obs)
+{
+    strconv_t *conv=(strconv_t *)sink->arg;
+    
+    conv->out.obs.data=obs->data;
+    conv->out.obs.n=obs->n;
+}
+/* ephemeris decoded: copy ephemeris to output -------------------------------*/
+static void conv_eph(decsink_t *sink, int sat, const nav_t *nav)
+{
+    strconv_t *conv=(strconv_t *)sink->arg;
+    int prn;
+    
+    switch (satsys(sat,&prn)) {
+        case SYS_GLO: conv->out.nav.geph[prn-1]=nav->geph[prn-1]; break;
+        case SYS_GPS:
+        case SYS_GAL:
+        case SYS_QZS:
+        case SYS_CMP: conv->out.nav.eph [sat-1]=nav->eph [sat-1]; break;
+    }
+    conv->out.ephsat=sat;
+}
 /* new stream converter --------------------------------------------------------
 * generate new stream converter
 * args   : int    itype     I   input stream type  (STRFMT_???)
@@ -74,6 +101,7 @@ extern strconv_t *strconvnew(int itype, int otype, const char *msgs, int staid,
     if (!(conv=(strconv_t *)malloc(sizeof(strconv_t)))) return NULL;
     
     conv->nmsg=0;
+    conv->nobs=conv->nnav=conv->nerr=0;
     strcpy(buff,msgs);
     for (p=strtok(buff,",");p;p=strtok(NULL,",")) {
        tint=0.0;
@@ -101,6 +129,13 @@ extern strconv_t *strconvnew(int itype, int otype, const char *msgs, int staid,
         free(conv);
         return NULL;
     }
+    /* output observation data refer input buffers */
+    free(conv->out.obs.data);
+    conv->out.obs.data=NULL;
+    conv->rtcm.sink.on_obs_epoch=conv->raw.sink.on_obs_epoch=conv_obs;
+    conv->rtcm.sink.on_ephemeris=conv->raw.sink.on_ephemeris=conv_eph;
+    conv->rtcm.sink.arg=conv->raw.sink.arg=conv;
+    
     if (stasel) conv->out.staid=staid;
     sprintf(conv->rtcm.opt,"-EPHALL %s",opt);
     sprintf(conv->raw.opt ,"-EPHALL %s",opt);
@@ -114,6 +149,7 @@ extern strconv_t *strconvnew(int itype, int otype, const char *msgs, int staid,
 extern void strconvfree(strconv_t *conv)
 {
     if (!conv) return;
+    conv->out.obs.data=NULL; /* input buffer */
     free_rtcm(&conv->rtcm);
     free_rtcm(&conv->out);
     free_raw(&conv->raw);
@@ -122,27 +158,10 @@ extern void strconvfree(strconv_t *conv)
 /* copy received data from receiver raw to rtcm ------------------------------*/
 static void raw2rtcm(rtcm_t *out, const raw_t *raw, int ret)
 {
-    int i,sat,prn;
-    
     out->time=raw->time;
     
-    if (ret==1) {
-        for (i=0;i<raw->obs.n;i++) {
-            out->time=raw->obs.data[i].time;
-            out->obs.data[i]=raw->obs.data[i];
-        }
-        out->obs.n=raw->obs.n;
-    }
-    else if (ret==2) {
-        sat=raw->ephsat;
-        switch (satsys(sat,&prn)) {
-            case SYS_GLO: out->nav.geph[prn-1]=raw->nav.geph[prn-1]; break;
-            case SYS_GPS:
-            case SYS_GAL:
-            case SYS_QZS:
-            case SYS_CMP: out->nav.eph [sat-1]=raw->nav.eph [sat-1]; break;
-        }
-        out->ephsat=sat;
+    if (ret==1) { /* observation data by conv_obs() */
+        if (raw->obs.n>0) out->time=raw->obs.data[raw->obs.n-1].time;
     }
     else if (ret==9) {
         matcpy(out->nav.utc_gps,raw->nav.utc_gps,4,1);
@@ -158,30 +177,12 @@ static void raw2rtcm(rtcm_t *out, const raw_t *raw, int ret)
 /* copy received data from receiver rtcm to rtcm -----------------------------*/
 static void rtcm2rtcm(rtcm_t *out, const rtcm_t *rtcm, int ret, int stasel)
 {
-    int i,sat,prn;
-    
     out->time=rtcm->time;
     
     if (!stasel) out->staid=rtcm->staid;
     
-    if (ret==1) {
-        for (i=0;i<rtcm->obs.n;i++) {
-            out->obs.data[i]=rtcm->obs.data[i];
-        }
-        out->obs.n=rtcm->obs.n;
-    }
-    else if (ret==2) {
-        sat=rtcm->ephsat;
-        switch (satsys(sat,&prn)) {
-            case SYS_GLO: out->nav.geph[prn-1]=rtcm->nav.geph[prn-1]; break;
-            case SYS_GPS:
-            case SYS_GAL:
-            case SYS_QZS:
-            case SYS_CMP: out->nav.eph [sat-1]=rtcm->nav.eph [sat-1]; break;
-        }
-        out->ephsat=sat;
-    }
-    else if (ret==5) {
+    /* observation data and ephemeris by conv_obs() and conv_eph() */
+    if (ret==5) {
         if (!stasel) out->sta=rtcm->sta;
     }
     else if (ret==9) {
@@ -392,27 +393,28 @@ static void strconv(stream_t *str, strconv_t *conv, unsigned char *buff, int n)
 {
     int i,ret;
     
-    for (i=0;i<n;i++) {
+    for (i=0;i<n;) {
         
         /* input rtcm 2 messages */
         if (conv->itype==STRFMT_RTCM2) {
-            ret=input_rtcm2(&conv->rtcm,buff[i]);
+            ret=input_rtcm2(&conv->rtcm,buff[i++]);
             rtcm2rtcm(&conv->out,&conv->rtcm,ret,conv->stasel);
         }
-        /* input rtcm 3 messages */
+        /* input rtcm 3 messages by frames */
         else if (conv->itype==STRFMT_RTCM3) {
-            ret=input_rtcm3(&conv->rtcm,buff[i]);
+            ret=input_rtcm3b(&conv->rtcm,buff,n,&i);
             rtcm2rtcm(&conv->out,&conv->rtcm,ret,conv->stasel);
         }
         /* input receiver raw messages */
         else {
-            ret=input_raw(&conv->raw,conv->itype,buff[i]);
+            ret=input_raw(&conv->raw,conv->itype,buff[i++]);
             raw2rtcm(&conv->out,&conv->raw,ret);
         }
         /* write obs and nav data messages to stream */
         switch (ret) {
-            case 1: write_obs(conv->out.time,str,conv); break;
-            case 2: write_nav(conv->out.time,str,conv); break;
+            case 1: write_obs(conv->out.time,str,conv); conv->nobs++; break;
+            case 2: write_nav(conv->out.time,str,conv); conv->nnav++; break;
+            case -1: conv->nerr++; break;
         }
     }
     /* write cyclic nav data and station info messages to stream */
@@ -452,13 +454,15 @@ static void *strsvrthread(void *arg)
 {
     strsvr_t *svr=(strsvr_t *)arg;
     sol_t sol_nmea={{0}};
-    unsigned int tick,tick_nmea;
+    unsigned int tick,tick_nmea,ticku;
     unsigned char buff[1024];
     char sel[256];
-    int i,n,cyc;
+    int i,n,cyc,cputime,jit;
     
     tracet(3,"strsvrthread:\n");
     
+    setthrdopt(&svr->thopt);
+    
     svr->tick=tickget();
     tick_nmea=svr->tick-1000;
     
@@ -467,6 +471,11 @@ static void *strsvrthread(void *arg)
         
         /* read data from input stream */
         while ((n=strread(svr->stream,svr->buff,svr->buffsize))>0&&svr->state) {
+            if (n>=svr->buffsize) {
+                lock(&svr->lock);
+                svr->nfull++;
+                unlock(&svr->lock);
+            }
             
             /* get stream selection */
             strgetsel(svr->stream,sel);
@@ -478,7 +487,9 @@ static void *strsvrthread(void *arg)
                 strsetsel(svr->stream+i,sel);
                 
                 if (svr->conv[i-1]) {
+                    lock(&svr->lock); /* converter counters read by metrics */
                     strconv(svr->stream+i,svr->conv[i-1],svr->buff,n);
+                    unlock(&svr->lock);
                 }
                 else {
                     strwrite(svr->stream+i,svr->buff,n);
@@ -513,7 +524,25 @@ static void *strsvrthread(void *arg)
             strsendnmea(svr->stream,&sol_nmea);
             tick_nmea=tick;
         }
-        sleepms(svr->cycle-(int)(tickget()-tick));
+        cputime=(int)(tickget()-tick);
+        lock(&svr->lock);
+        svr->cputime=cputime;
+        svr->ncycle++;
+        if (cputime>svr->cycle) svr->novr++;
+        unlock(&svr->lock);
+        
+        /* sleep until next cycle and measure wake-up delay as jitter */
+        if (svr->cycle-cputime>0) {
+            ticku=tickgetus();
+            sleepms(svr->cycle-cputime);
+            jit=(int)(tickgetus()-ticku)-(svr->cycle-cputime)*1000;
+            if (jit<0) jit=0;
+            lock(&svr->lock);
+            svr->jitsum+=jit;
+            svr->njit++;
+            if (jit>svr->jitmax) svr->jitmax=jit;
+            unlock(&svr->lock);
+        }
     }
     for (i=0;i<svr->nstr;i++) strclose(svr->stream+i);
     svr->npb=0;
@@ -544,6 +573,15 @@ extern void strsvrinit(strsvr_t *svr, int nout)
     for (i=0;i<3;i++) svr->nmeapos[i]=0.0;
     svr->buff=svr->pbuf=NULL;
     svr->tick=0;
+    svr->ncycle=svr->novr=svr->nfull=0;
+    svr->cputime=0;
+    svr->njit=0;
+    svr->jitsum=0.0;
+    svr->jitmax=0;
+    strcpy(svr->thopt.name,"strsvr");
+    svr->thopt.cpu=-1;
+    svr->thopt.policy=THRDPOL_OTHER;
+    svr->thopt.prio=0;
     for (i=0;i<nout+1&&i<16;i++) strinit(svr->stream+i);
     svr->nstr=i;
     for (i=0;i<16;i++) svr->conv[i]=NULL;
@@ -609,6 +647,11 @@ extern int strsvrstart(strsvr_t *svr, int *opts, int *strs, char **paths,
     svr->buffsize=opts[3]<4096?4096:opts[3]; /* >=4096byte */
     svr->nmeacycle=0<opts[5]&&opts[5]<1000?1000:opts[5]; /* >=1s */
     svr->relayback=opts[7];
+    svr->ncycle=svr->novr=svr->nfull=0;
+    svr->cputime=0;
+    svr->njit=0;
+    svr->jitsum=0.0;
+    svr->jitmax=0;
     for (i=0;i<3;i++) svr->nmeapos[i]=nmeapos?nmeapos[i]:0.0;
     for (i=0;i<4;i++) {
         strcpy(svr->cmds_periodic[i],!cmds_periodic[i]?"":cmds_periodic[i]);
@@ -771,3 +814,68 @@ extern void strsvrsetsrctbl(strsvr_t *svr, const char *file)
         strsetsrctbl(svr->stream+i,file);
     }
 }
+/* stream server metrics -------------------------------------------------------
+* output metrics of stream server
+* args   : strsvr_t *svr    I   stream server struct
+*          int    fmt       I   format (METF_PROM:prometheus text,METF_JSON:json)
+*          char   *buff     O   metrics output buffer
+*          int    nmax      I   size of metrics output buffer (bytes)
+* return : length of metrics output (bytes)
+* notes  : the counters of stream server and converters are read under the
+*          server lock as a snapshot.
+*-----------------------------------------------------------------------------*/
+extern int strsvrmetric(strsvr_t *svr, int fmt, char *buff, int nmax)
+{
+    metbuf_t met;
+    char names[16][8],label[32];
+    const char *name[16];
+    int i;
+    
+    tracet(4,"strsvrmetric: fmt=%d\n",fmt);
+    
+    for (i=0;i<svr->nstr;i++) {
+        if (i==0) strcpy(names[i],"in");
+        else sprintf(names[i],"out%d",i);
+        name[i]=names[i];
+    }
+    metinit(&met,fmt,buff,nmax);
+    
+    lock(&svr->lock);
+    metadd(&met,"rtklib_strsvr_state","gauge","stream server state (0:stop,"
+           "1:running)","",svr->state);
+    metadd(&met,"rtklib_strsvr_cputime_ms","gauge","cpu time of last server "
+           "cycle (ms)","",svr->cputime);
+    metadd(&met,"rtklib_strsvr_cycle_ms","gauge","server cycle (ms)","",
+           svr->cycle);
+    metadd(&met,"rtklib_strsvr_cycles_total","counter","server cycles","",
+           svr->ncycle);
+    metadd(&met,"rtklib_strsvr_overruns_total","counter","server cycles over "
+           "cycle time","",svr->novr);
+    metadd(&met,"rtklib_strsvr_buffer_full_total","counter","input reads "
+           "filling input buffer","",svr->nfull);
+    metadd(&met,"rtklib_strsvr_jitter_us_avg","gauge","average wake-up delay "
+           "of server cycle (us)","",svr->njit>0?svr->jitsum/svr->njit:0.0);
+    metadd(&met,"rtklib_strsvr_jitter_us_max","gauge","max wake-up delay of "
+           "server cycle (us)","",svr->jitmax);
+    metadd(&met,"rtklib_strsvr_peek_buffer_bytes","gauge","bytes in peek "
+           "buffer","",svr->npb);
+    metadd(&met,"rtklib_strsvr_buffer_size_bytes","gauge","input buffer size "
+           "(bytes)","",svr->buffsize);
+    for (i=1;i<svr->nstr;i++) {
+        if (!svr->conv[i-1]) continue;
+        sprintf(label,"stream=\"%s\",type=\"obs\"",name[i]);
+        metadd(&met,"rtklib_strsvr_conv_messages_total","counter","input "
+               "messages of stream converter by type",label,svr->conv[i-1]->nobs);
+        sprintf(label,"stream=\"%s\",type=\"nav\"",name[i]);
+        metadd(&met,"rtklib_strsvr_conv_messages_total","counter","input "
+               "messages of stream converter by type",label,svr->conv[i-1]->nnav);
+        sprintf(label,"stream=\"%s\",type=\"error\"",name[i]);
+        metadd(&met,"rtklib_strsvr_conv_messages_total","counter","input "
+               "messages of stream converter by type",label,svr->conv[i-1]->nerr);
+    }
+    unlock(&svr->lock);
+    
+    strmetric(&met,svr->stream,name,svr->nstr);
+    
+    return metclose(&met);
+}
@@ -0,0 +1,185 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : batch static solution
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define FILE_ROV    "../data/rinex/07590920.05o"
+#define FILE_BASE   "../data/rinex/30400920.05o"
+#define FILE_NAV    "../data/rinex/07590920.05n"
+#define FILE_FWD    "t_batch_1.pos"
+#define FILE_BAT    "t_batch_2.pos"
+
+static obs_t obs={0};
+static nav_t nav={0};
+static sta_t sta={""};
+
+/* dummy application functions for shared library ----------------------------*/
+extern int showmsg(char *format,...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* processing options --------------------------------------------------------*/
+static prcopt_t setopt(int soltype)
+{
+    prcopt_t opt=prcopt_default;
+    opt.mode=PMODE_STATIC;
+    opt.soltype=soltype;
+    opt.navsys=SYS_GPS;
+    opt.refpos=POSOPT_RINEX;
+    return opt;
+}
+/* last solution in solution file --------------------------------------------*/
+static sol_t lastsol(char *file)
+{
+    solbuf_t solbuf={0};
+    sol_t sol={{0}};
+
+    assert(readsol(&file,1,&solbuf)>0);
+    sol=solbuf.data[solbuf.n-1];
+    freesolbuf(&solbuf);
+    remove(file);
+    return sol;
+}
+/* batch solution vs static forward solution by postpos() */
+void utest1(void)
+{
+    prcopt_t popt;
+    solopt_t sopt=solopt_default;
+    filopt_t fopt={""};
+    gtime_t t0={0};
+    sol_t solf,solb;
+    char *infile[]={FILE_ROV,FILE_BASE,FILE_NAV};
+    double dr[3];
+    int i;
+
+    popt=setopt(0);
+    assert(!postpos(t0,t0,0.0,0.0,&popt,&sopt,&fopt,infile,3,FILE_FWD,"",""));
+    popt=setopt(3);
+    assert(!postpos(t0,t0,0.0,0.0,&popt,&sopt,&fopt,infile,3,FILE_BAT,"",""));
+
+    solf=lastsol(FILE_FWD);
+    solb=lastsol(FILE_BAT);
+    for (i=0;i<3;i++) dr[i]=solb.rr[i]-solf.rr[i];
+    printf("forward: stat=%d batch: stat=%d ratio=%.1f dr=%.4f dt=%.3f\n",
+           solf.stat,solb.stat,solb.ratio,norm(dr,3),
+           timediff(solb.time,solf.time));
+
+    /* same solution time as forward and fixed baseline within 1 cm */
+    assert(fabs(timediff(solb.time,solf.time))<1E-3);
+    assert(solf.stat==SOLQ_FIX&&solb.stat==SOLQ_FIX);
+    assert(norm(dr,3)<0.01);
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* read rinex obs and nav ----------------------------------------------------*/
+static void readdata(void)
+{
+    if (obs.n>0) return;
+    assert(readrnx(FILE_ROV ,1,"",&obs,&nav,NULL)>0);
+    assert(readrnx(FILE_BASE,2,"",&obs,&nav,&sta)>0);
+    assert(readrnx(FILE_NAV ,1,"",&obs,&nav,NULL)>0);
+    sortobs(&obs);
+    uniqnav(&nav);
+    assert(obs.n>0&&nav.n>0&&norm(sta.pos,3)>0.0);
+}
+/* accumulate batch with slip at an epoch and outage of epochs of satellite --*/
+static int runbatch(rtk_t *rtk, batch_t *bat, int sat, int slip, int ts,
+                    int nout)
+{
+    prcopt_t popt=setopt(3);
+    obsd_t data[MAXOBS*2];
+    int i,j,n,ne=0;
+
+    popt.maxout=5;
+    for (i=0;i<3;i++) popt.rb[i]=sta.pos[i];
+    rtkinit(rtk,&popt);
+    batchinit(bat);
+
+    for (i=0;i<obs.n;i=j,ne++) {
+        for (j=i,n=0;j<obs.n&&fabs(timediff(obs.data[j].time,
+             obs.data[i].time))<DTTOL;j++) {
+            if (obs.data[j].rcv==1&&obs.data[j].sat==sat) {
+                if (ts<=ne&&ne<ts+nout) continue;
+                data[n]=obs.data[j];
+                if (ne==slip) data[n].LLI[0]=data[n].LLI[1]=LLI_SLIP;
+                n++;
+            }
+            else data[n++]=obs.data[j];
+        }
+        batchpos(rtk,bat,data,n,&nav);
+    }
+    rtkfree(rtk);
+    return ne;
+}
+/* number of ambiguity arcs and epochs of satellite/frequency ----------------*/
+static int narc(const batch_t *bat, int sat, int f, int *nep)
+{
+    int k,n=0;
+
+    for (k=*nep=0;k<bat->nx-3;k++) {
+        if (bat->sat[k]!=sat||bat->frq[k]!=f) continue;
+        *nep+=bat->nep[k];
+        n++;
+    }
+    return n;
+}
+/* batchpos() ambiguity arcs split by cycle slip and outage */
+void utest2(void)
+{
+    static rtk_t rtk;
+    batch_t bat;
+    int k,f,ne,sat=0,na0[2],na[2],nep0[2],nep[2],nx0,ts;
+
+    readdata();
+
+    /* no slip and no outage: satellite of longest arc */
+    ne=runbatch(&rtk,&bat,0,-1,-1,0);
+    for (k=0;k<bat.nx-3;k++) {
+        if (!sat||bat.nep[k]>nep0[0]) {sat=bat.sat[k]; nep0[0]=bat.nep[k];}
+    }
+    for (f=0;f<2;f++) na0[f]=narc(&bat,sat,f,nep0+f);
+    nx0=bat.nx;
+    printf("epochs=%d sat=%d arcs=%d,%d epochs=%d,%d nx=%d\n",ne,sat,na0[0],
+           na0[1],nep0[0],nep0[1],nx0);
+    assert(ne>20&&na0[0]>=1&&na0[1]>=1&&nep0[0]>ne/2);
+    batchfree(&bat);
+
+    /* cycle slip by lli: new arcs of L1 and L2 with same epochs */
+    runbatch(&rtk,&bat,sat,ne/2,-1,0);
+    for (f=0;f<2;f++) {
+        na[f]=narc(&bat,sat,f,nep+f);
+        assert(na[f]==na0[f]+1&&nep[f]==nep0[f]);
+    }
+    assert(bat.nx==nx0+2);
+    batchfree(&bat);
+
+    /* outage of max outage epochs: arcs continued */
+    ts=ne/2;
+    runbatch(&rtk,&bat,sat,-1,ts,5);
+    for (f=0;f<2;f++) {
+        na[f]=narc(&bat,sat,f,nep+f);
+        assert(na[f]==na0[f]&&nep[f]==nep0[f]-5);
+    }
+    batchfree(&bat);
+
+    /* outage over max outage epochs: new arcs */
+    runbatch(&rtk,&bat,sat,-1,ts,6);
+    for (f=0;f<2;f++) {
+        na[f]=narc(&bat,sat,f,nep+f);
+        assert(na[f]==na0[f]+1&&nep[f]==nep0[f]-6);
+    }
+    assert(bat.nx==nx0+2);
+    batchfree(&bat);
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    return 0;
+}
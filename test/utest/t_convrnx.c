@@ -0,0 +1,184 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : rinex conversion of split logs
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define FILE_RTCM3  "../data/rcvraw/GMSD7_20121014.rtcm3"
+#define FILE_UBX    "../data/rcvraw/ubx_20080526.ubx"
+#define FILE_TRACE  "t_convrnx.trace"
+#define NSPLIT      3                   /* number of split files */
+#define MAXLINE     4096                /* max line length */
+
+/* dummy application functions for convrnx() */
+extern int showmsg(char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* end of rtcm3 msm message of an epoch (sync flag off) */
+static int endepoch(const unsigned char *buff, int len)
+{
+    int type=getbitu(buff,24,12);
+    return 1071<=type&&type<=1127&&len>=16&&!getbitu(buff,24+54,1);
+}
+/* split log at rtcm3 epochs (epoch=1) or bytes (epoch=0) */
+static void splitlog(const char *file, const char *ext, int epoch)
+{
+    static unsigned char buff[1048576];
+    FILE *fp;
+    char path[64];
+    int i,j,k,n,len=0,cut[NSPLIT+1];
+
+    assert((fp=fopen(file,"rb")));
+    n=(int)fread(buff,1,sizeof(buff),fp);
+    fclose(fp);
+    assert(n>0&&n<(int)sizeof(buff));
+
+    cut[0]=0; cut[NSPLIT]=n;
+    for (k=1;k<NSPLIT;k++) {
+        cut[k]=n*k/NSPLIT;
+        if (!epoch) continue;
+        for (i=0;i<n-5;i+=len) {
+            if (buff[i]!=0xD3) {len=1; continue;}
+            len=(int)getbitu(buff+i,14,10)+6;
+            if (i+len>cut[k]&&endepoch(buff+i,len)) break;
+        }
+        cut[k]=i+len;
+    }
+    for (k=0;k<NSPLIT;k++) {
+        sprintf(path,"t_convrnx_%d.%s",k,ext);
+        assert((fp=fopen(path,"wb")));
+        j=cut[k+1]-cut[k];
+        assert(j>0&&(int)fwrite(buff+cut[k],1,j,fp)==j);
+        fclose(fp);
+    }
+}
+/* remove split log */
+static void removelog(const char *ext)
+{
+    char path[64];
+    int k;
+
+    for (k=0;k<NSPLIT;k++) {
+        sprintf(path,"t_convrnx_%d.%s",k,ext);
+        remove(path);
+    }
+}
+/* convert split log to rinex obs and nav */
+static void convlog(int format, const char *ext, int nthread, const char *obs,
+                    const char *nav)
+{
+    const double ep[]={2012,10,14,0,0,0};
+    rnxopt_t opt;
+    char file[64],ofile_[9][1024]={""},*ofile[9];
+    int i;
+
+    memset(&opt,0,sizeof(rnxopt_t));
+    opt.rnxver=3.03;
+    opt.navsys=SYS_ALL;
+    opt.obstype=OBSTYPE_ALL;
+    opt.freqtype=FREQTYPE_ALL;
+    opt.scanobs=1;
+    opt.nthread=nthread;
+    if (format==STRFMT_RTCM3) opt.trtcm=epoch2time(ep);
+    strcpy(opt.prog,"t_convrnx");
+    for (i=0;i<7;i++) memset(opt.mask[i],'1',63);
+    for (i=0;i<9;i++) ofile[i]=ofile_[i];
+    strcpy(ofile[0],obs);
+    strcpy(ofile[1],nav);
+    sprintf(file,"t_convrnx_*.%s",ext);
+    assert(convrnx(format,&opt,file,ofile)>0);
+}
+/* compare files except program/date line */
+static int cmpfile(const char *file1, const char *file2)
+{
+    static char buff1[MAXLINE],buff2[MAXLINE];
+    FILE *fp1,*fp2;
+    int n=0,stat1,stat2;
+
+    assert((fp1=fopen(file1,"r"))&&(fp2=fopen(file2,"r")));
+    for (;;n++) {
+        stat1=fgets(buff1,MAXLINE,fp1)!=NULL;
+        stat2=fgets(buff2,MAXLINE,fp2)!=NULL;
+        assert(stat1==stat2);
+        if (!stat1) break;
+        if (strstr(buff1,"PGM / RUN BY / DATE")) continue;
+        assert(!strcmp(buff1,buff2));
+    }
+    fclose(fp1);
+    fclose(fp2);
+    remove(file1);
+    remove(file2);
+    return n;
+}
+/* number of lines including string in file */
+static int grepfile(const char *file, const char *str)
+{
+    static char buff[MAXLINE];
+    FILE *fp;
+    int n=0;
+
+    assert((fp=fopen(file,"r")));
+    while (fgets(buff,MAXLINE,fp)) {
+        if (strstr(buff,str)) n++;
+    }
+    fclose(fp);
+    return n;
+}
+/* parallel and sequential conversion of split log, return number of fallback
+   from parallel to sequential decoding */
+static int cmpconv(int format, const char *ext)
+{
+    int nobs,nnav,nfb;
+
+    traceopen(FILE_TRACE);
+    tracelevel(2);
+    convlog(format,ext,NSPLIT,"t_convrnx_p.obs","t_convrnx_p.nav");
+    traceclose();
+    nfb=grepfile(FILE_TRACE,"decoder state at file boundary");
+    remove(FILE_TRACE);
+
+    convlog(format,ext,1,"t_convrnx_s.obs","t_convrnx_s.nav");
+
+    nobs=cmpfile("t_convrnx_s.obs","t_convrnx_p.obs");
+    nnav=cmpfile("t_convrnx_s.nav","t_convrnx_p.nav");
+    printf("%s: obs=%d nav=%d fallback=%d\n",ext,nobs,nnav,nfb);
+    assert(nobs>100&&nnav>50);
+    return nfb;
+}
+/* rtcm3 split at epochs decoded in parallel as in sequence */
+void utest1(void)
+{
+    splitlog(FILE_RTCM3,"rtcm3",1);
+    assert(cmpconv(STRFMT_RTCM3,"rtcm3")==0);
+    removelog("rtcm3");
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* rtcm3 split in messages decoded in sequence */
+void utest2(void)
+{
+    splitlog(FILE_RTCM3,"rtcm3",0);
+    assert(cmpconv(STRFMT_RTCM3,"rtcm3")==1);
+    removelog("rtcm3");
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+/* receiver raw log decoded in sequence */
+void utest3(void)
+{
+    splitlog(FILE_UBX,"ubx",0);
+    assert(cmpconv(STRFMT_UBX,"ubx")==0);
+    removelog("ubx");
+
+    printf("%s utest3 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    utest3();
+    return 0;
+}
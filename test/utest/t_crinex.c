@@ -0,0 +1,442 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : compact rinex and gzip output
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define NSAT    16                      /* number of satellites */
+#define NEPOCH  300                     /* number of epochs */
+#define MAXLINE 4096                    /* max line length */
+#define FILE_RTCM3 "../data/rcvraw/testglo.rtcm3"
+
+static const char syscodes[]="GREJSCI"; /* satellite system codes */
+
+static const char *tobs[][8]={
+    {"C1C","L1C","D1C","S1C","C2W","L2W","S2W",""},
+    {"C1C","L1C","S1C","C2C","L2C",""}
+};
+static const char *tobs2[]={"C1","L1","D1","S1","P2","L2","S2",""};
+
+/* dummy application functions for convrnx() */
+extern int showmsg(char *format, ...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* rinex options */
+static void setopt(rnxopt_t *opt, double ver)
+{
+    int i,j;
+    memset(opt,0,sizeof(rnxopt_t));
+    opt->rnxver=ver;
+    opt->navsys=SYS_GPS|SYS_GLO;
+    strcpy(opt->prog,"t_crinex");
+    for (i=0;i<2;i++) {
+        for (j=0;*tobs[i][j];j++) strcpy(opt->tobs[i][j],tobs[i][j]);
+        opt->nobs[i]=j;
+    }
+    if (ver<=2.99) {
+        for (j=0;*tobs2[j];j++) strcpy(opt->tobs[0][j],tobs2[j]);
+        opt->nobs[0]=j;
+    }
+    for (i=0;i<7;i++) for (j=0;j<64;j++) opt->mask[i][j]='1';
+}
+static double L[NSAT][2];                /* carrier-phase of satellites */
+
+/* random value without -0.000 */
+static double randval(double val, double scale)
+{
+    return floor((val+(rand()/(double)RAND_MAX-0.5)*scale)*1000.0)/1000.0;
+}
+/* observation data of an epoch */
+static int setobs(obsd_t *obs, int ep)
+{
+    int i,j,n=0;
+
+    for (i=0;i<NSAT;i++) {
+        if ((ep/25+i)%7==0) continue; /* satellite out */
+        memset(obs+n,0,sizeof(obsd_t));
+        obs[n].time=gpst2time(2000,ep*30.0);
+        obs[n].eventime=timeadd(obs[n].time,-0.5);
+        obs[n].sat=i<10?satno(SYS_GPS,i+1):satno(SYS_GLO,i-9);
+        obs[n].code[0]=CODE_L1C;
+        obs[n].code[1]=i<10?CODE_L2W:CODE_L2C;
+        for (j=0;j<2;j++) {
+            L[i][j]=L[i][j]==0.0?1E8*(j+1):L[i][j]+1500.0*(j+1);
+            if ((ep+i+j)%13==0) continue; /* data gap */
+            obs[n].P[j]=randval(2E7,1E3);
+            obs[n].L[j]=randval(L[i][j],1.0);
+            obs[n].D[j]=(float)randval(1234.0,10.0);
+            obs[n].SNR[j]=(unsigned short)(120+rand()%80);
+            obs[n].LLI[j]=(unsigned char)(rand()%10==0?1:0);
+            obs[n].qualL[j]=(unsigned char)(rand()%10);
+        }
+        n++;
+    }
+    return n;
+}
+/* write rinex obs file */
+static void writeobs(const char *file, rnxopt_t *opt, int crinex)
+{
+    static nav_t nav;
+    obsd_t obs[NSAT];
+    crx_t crx;
+    FILE *fp;
+    int i,n;
+
+    assert((fp=fopen(file,"w")));
+    if (crinex) assert(init_crx(&crx,opt));
+    opt->crx=crinex?&crx:NULL;
+    assert(outrnxobsh(fp,opt,&nav));
+    memset(L,0,sizeof(L));
+    srand(1);
+    for (i=0;i<NEPOCH;i++) {
+        n=setobs(obs,i);
+        assert(outrnxobsb(fp,opt,obs,n,i%100==50?5:0));
+    }
+    if (crinex) free_crx(&crx);
+    opt->crx=NULL;
+    fclose(fp);
+}
+/* text difference restore */
+static void repair(char *str, const char *diff, int n)
+{
+    int i;
+    for (i=(int)strlen(str);i<n;i++) str[i]=' ';
+    str[n]='\0';
+    for (i=0;diff[i];i++) {
+        if (diff[i]=='&') str[i]=' ';
+        else if (diff[i]!=' ') str[i]=diff[i];
+    }
+}
+/* read line without newline */
+static int readline(FILE *fp, char *buff)
+{
+    char *p;
+    if (!fgets(buff,MAXLINE,fp)) return 0;
+    if ((p=strchr(buff,'\n'))) *p='\0';
+    return 1;
+}
+/* compact rinex to rinex decoder for test */
+static void crx2rnx(const char *ifile, const char *ofile)
+{
+    static double dat[MAXSAT][MAXOBSTYPE][4];
+    static int arc[MAXSAT][MAXOBSTYPE],last[MAXSAT];
+    static char flag[MAXSAT][MAXOBSTYPE*2+1];
+    FILE *ifp,*ofp;
+    char line[MAXLINE],epoch[MAXLINE]="",id[4]="",*p,*q;
+    double d[4];
+    int i,j,k,m,ns,nt,sat,ver,nep=1,init,fl,has[MAXOBSTYPE],nobs[7]={0};
+
+    assert((ifp=fopen(ifile,"r"))&&(ofp=fopen(ofile,"w")));
+
+    assert(readline(ifp,line)&&strstr(line,"CRINEX VERS   / TYPE"));
+    ver=line[0]=='1'?1:3;
+    assert(readline(ifp,line)&&strstr(line,"CRINEX PROG / DATE"));
+    while (readline(ifp,line)) {
+        fprintf(ofp,"%s\n",line);
+        if (strstr(line,"# / TYPES OF OBSERV")&&line[5]!=' ') {
+            nobs[0]=(int)str2num(line,0,6);
+        }
+        else if (strstr(line,"SYS / # / OBS TYPES")&&line[0]!=' ') {
+            assert((p=strchr(syscodes,line[0])));
+            nobs[p-syscodes]=(int)str2num(line,3,3);
+        }
+        else if (strstr(line,"END OF HEADER")) break;
+    }
+    memset(last,0,sizeof(last));
+
+    while (readline(ifp,line)) {
+
+        /* epoch line */
+        if ((init=ver==1?line[0]=='&':line[0]=='>')) {
+            strcpy(epoch,line);
+            if (ver==1) epoch[0]=' ';
+        }
+        else repair(epoch,line,(int)strlen(epoch)>(int)strlen(line)?
+                    (int)strlen(epoch):(int)strlen(line));
+        fl=epoch[ver==1?28:31]-'0';
+        ns=(int)str2num(epoch,ver==1?29:32,3);
+
+        if (fl>1) { /* event */
+            for (i=(int)strlen(epoch);i>0&&epoch[i-1]==' ';i--) epoch[i-1]='\0';
+            fprintf(ofp,"%s\n",epoch);
+            for (i=0;i<ns;i++) {
+                assert(readline(ifp,line));
+                fprintf(ofp,"%s\n",line);
+            }
+            strcpy(epoch,"");
+            continue;
+        }
+        assert(readline(ifp,line)&&!*line); /* clock */
+
+        if (ver==1) {
+            fprintf(ofp,"%-32.32s",epoch);
+            for (i=0;i<ns;i++) {
+                if (i>0&&i%12==0) fprintf(ofp,"\n%32s","");
+                fprintf(ofp,"%.3s",epoch+32+i*3);
+            }
+        }
+        else fprintf(ofp,"%-41.41s%15s\n",epoch,"");
+
+        for (i=0;i<ns;i++) {
+            memcpy(id,epoch+(ver==1?32:41)+i*3,3);
+            assert((sat=satid2no(id))>0);
+            nt=ver==1?nobs[0]:nobs[strchr(syscodes,id[0])-syscodes];
+            if (init||last[sat-1]!=nep-1) {
+                memset(flag[sat-1],' ',nt*2);
+                for (j=0;j<nt;j++) arc[sat-1][j]=0;
+            }
+            last[sat-1]=nep;
+
+            assert(readline(ifp,line));
+            for (j=0,p=line;j<nt;j++) {
+                q=p;
+                while (*p&&*p!=' ') p++;
+                if ((has[j]=p>q)) {
+                    if (q[1]=='&') {
+                        dat[sat-1][j][0]=atof(q+2);
+                        arc[sat-1][j]=1;
+                    }
+                    else {
+                        m=arc[sat-1][j];
+                        assert(m>0);
+                        for (d[m]=atof(q),k=m;k>0;k--) {
+                            d[k-1]=d[k]+dat[sat-1][j][k-1];
+                        }
+                        for (k=0;k<=m&&k<4;k++) dat[sat-1][j][k]=d[k];
+                        if (arc[sat-1][j]<3) arc[sat-1][j]++;
+                    }
+                }
+                else arc[sat-1][j]=0;
+                if (*p) p++;
+            }
+            repair(flag[sat-1],p,nt*2);
+
+            if (ver==3) fprintf(ofp,"%s",id);
+            for (j=0;j<nt;j++) {
+                if (ver==1&&j%5==0) fprintf(ofp,"\n");
+                if (has[j]) fprintf(ofp,"%14.3f",dat[sat-1][j][0]/1000.0);
+                else fprintf(ofp,"%14s","");
+                fprintf(ofp,"%.2s",flag[sat-1]+j*2);
+            }
+            if (ver==3) fprintf(ofp,"\n");
+        }
+        if (ver==1) fprintf(ofp,"\n");
+        nep++;
+    }
+    assert(nep>NEPOCH/2);
+    fclose(ifp);
+    fclose(ofp);
+}
+/* compare body after header */
+static void cmpbody(const char *file1, const char *file2)
+{
+    static char buff1[MAXLINE],buff2[MAXLINE];
+    FILE *fp1,*fp2;
+    int n=0,stat1,stat2;
+
+    assert((fp1=fopen(file1,"r"))&&(fp2=fopen(file2,"r")));
+    while (fgets(buff1,MAXLINE,fp1)&&!strstr(buff1,"END OF HEADER")) ;
+    while (fgets(buff2,MAXLINE,fp2)&&!strstr(buff2,"END OF HEADER")) ;
+    for (;;n++) {
+        stat1=fgets(buff1,MAXLINE,fp1)!=NULL;
+        stat2=fgets(buff2,MAXLINE,fp2)!=NULL;
+        assert(stat1==stat2);
+        if (!stat1) break;
+        assert(!strcmp(buff1,buff2));
+    }
+    assert(n>NEPOCH);
+    fclose(fp1);
+    fclose(fp2);
+}
+/* compare obs data by rinex reader */
+static void cmpobs(const char *file1, const char *file2)
+{
+    obs_t obs1={0},obs2={0};
+    int i,j;
+
+    assert(readrnx(file1,1,"",&obs1,NULL,NULL)>0);
+    assert(readrnx(file2,1,"",&obs2,NULL,NULL)>0);
+    assert(obs1.n>NEPOCH&&obs1.n==obs2.n);
+    for (i=0;i<obs1.n;i++) {
+        assert(obs1.data[i].sat==obs2.data[i].sat);
+        assert(timediff(obs1.data[i].time,obs2.data[i].time)==0.0);
+        for (j=0;j<NFREQ;j++) {
+            assert(obs1.data[i].P[j]==obs2.data[i].P[j]);
+            assert(obs1.data[i].L[j]==obs2.data[i].L[j]);
+            assert(obs1.data[i].LLI[j]==obs2.data[i].LLI[j]);
+            assert(obs1.data[i].SNR[j]==obs2.data[i].SNR[j]);
+        }
+    }
+    free(obs1.data);
+    free(obs2.data);
+}
+/* compact rinex ver.3 round-trip */
+void utest1(void)
+{
+    rnxopt_t opt;
+
+    setopt(&opt,3.03);
+    writeobs("t_crinex_1.obs",&opt,0);
+    writeobs("t_crinex_1.crx",&opt,1);
+    crx2rnx("t_crinex_1.crx","t_crinex_1.rnx");
+    cmpbody("t_crinex_1.obs","t_crinex_1.rnx");
+    cmpobs ("t_crinex_1.obs","t_crinex_1.rnx");
+    remove("t_crinex_1.obs"); remove("t_crinex_1.crx"); remove("t_crinex_1.rnx");
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* compact rinex ver.1 (rinex ver.2) round-trip */
+void utest2(void)
+{
+    rnxopt_t opt;
+
+    setopt(&opt,2.11);
+    writeobs("t_crinex_2.obs",&opt,0);
+    writeobs("t_crinex_2.crx",&opt,1);
+    crx2rnx("t_crinex_2.crx","t_crinex_2.rnx");
+    cmpbody("t_crinex_2.obs","t_crinex_2.rnx");
+    cmpobs ("t_crinex_2.obs","t_crinex_2.rnx");
+    remove("t_crinex_2.obs"); remove("t_crinex_2.crx"); remove("t_crinex_2.rnx");
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+/* gzip round-trip */
+void utest3(void)
+{
+    rnxopt_t opt;
+    char file[1024];
+    FILE *fp;
+
+    setopt(&opt,3.03);
+    writeobs("t_crinex_3.obs",&opt,0);
+    writeobs("t_crinex_3a.obs",&opt,0);
+    assert(rtk_compress("t_crinex_3a.obs",file)>0);
+    assert(!strcmp(file,"t_crinex_3a.obs.gz"));
+    assert((fp=fopen(file,"rb"))&&fgetc(fp)==0x1F&&fgetc(fp)==0x8B);
+    fclose(fp);
+    cmpobs("t_crinex_3.obs",file);
+    remove("t_crinex_3.obs"); remove(file);
+
+    printf("%s utest3 : OK\n",__FILE__);
+}
+/* rtcm3 with station id change */
+static void genrtcm3(const char *file)
+{
+    static const int type[]={1077,1087,1097,1117,1107,1127};
+    static const int sys[]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP};
+    static rtcm_t rtcm,enc;
+    static unsigned char buff[1048576];
+    FILE *fp;
+    int i,j,k,n,m,nep=0,msg[6];
+
+    assert((fp=fopen(FILE_RTCM3,"rb")));
+    n=(int)fread(buff,1,sizeof(buff),fp);
+    fclose(fp);
+    assert((fp=fopen(file,"wb")));
+    assert(init_rtcm(&rtcm)&&init_rtcm(&enc));
+
+    for (i=0;i<n;i++) {
+        if (input_rtcm3(&rtcm,buff[i])!=1) continue;
+
+        /* station id and position changed at the middle of log */
+        if (enc.staid!=(nep++<100?100:200)) {
+            enc.staid=nep<=100?100:200;
+            enc.sta.pos[0]=-3607665.0+enc.staid;
+            enc.sta.pos[1]= 4147868.0;
+            enc.sta.pos[2]= 3223717.0;
+            assert(gen_rtcm3(&enc,1005,0));
+            fwrite(enc.buff,enc.nbyte,1,fp);
+        }
+        enc.time=rtcm.time;
+        enc.obs.n=rtcm.obs.n;
+        memcpy(enc.obs.data,rtcm.obs.data,sizeof(obsd_t)*rtcm.obs.n);
+        memcpy(enc.nav.geph,rtcm.nav.geph,sizeof(geph_t)*MAXPRNGLO);
+        for (j=m=0;j<6;j++) {
+            for (k=0;k<rtcm.obs.n;k++) {
+                if (satsys(rtcm.obs.data[k].sat,NULL)==sys[j]) break;
+            }
+            if (k<rtcm.obs.n) msg[m++]=type[j];
+        }
+        for (j=0;j<m;j++) { /* msm7 with sync flag except last */
+            assert(gen_rtcm3(&enc,msg[j],j<m-1));
+            fwrite(enc.buff,enc.nbyte,1,fp);
+        }
+    }
+    assert(nep>150);
+    free_rtcm(&rtcm); free_rtcm(&enc);
+    fclose(fp);
+}
+/* convert rtcm3 to rinex obs */
+static void convobs(const char *ifile, const char *ofile, rnxopt_t *opt,
+                    double ver, int crinex)
+{
+    const double ep[]={2012,10,12,0,0,0};
+    char ofile_[9][1024]={""},*ofiles[9];
+    int i;
+
+    memset(opt,0,sizeof(rnxopt_t));
+    opt->rnxver=ver;
+    opt->navsys=SYS_ALL;
+    opt->obstype=OBSTYPE_ALL;
+    opt->freqtype=FREQTYPE_ALL;
+    opt->scanobs=1;
+    opt->crinex=crinex;
+    opt->trtcm=epoch2time(ep);
+    strcpy(opt->prog,"t_crinex");
+    sprintf(opt->comment[0],"log: %s",ifile);
+    strcpy(opt->comment[1],"format: RTCM 3");
+    for (i=0;i<7;i++) memset(opt->mask[i],'1',63);
+    for (i=0;i<9;i++) ofiles[i]=ofile_[i];
+    strcpy(ofiles[0],ofile);
+    assert(convrnx(STRFMT_RTCM3,opt,ifile,ofiles)>0);
+}
+/* site occupation events round-trip */
+static void cmpevent(double ver)
+{
+    rnxopt_t opt;
+    char line[MAXLINE];
+    FILE *fp;
+    int n=0;
+
+    convobs("t_crinex_4.rtcm3","t_crinex_4.obs",&opt,ver,0);
+    convobs("t_crinex_4.rtcm3","t_crinex_4.crx",&opt,ver,1);
+    crx2rnx("t_crinex_4.crx","t_crinex_4.rnx");
+    cmpbody("t_crinex_4.obs","t_crinex_4.rnx");
+
+    /* new site occupation event and header records of new station */
+    assert((fp=fopen("t_crinex_4.rnx","r")));
+    while (readline(fp,line)&&!strstr(line,"END OF HEADER")) ;
+    while (readline(fp,line)) {
+        if (strlen(line)!=(ver<=2.99?32:35)||!strstr(line,"  3  6")) continue;
+        assert(ver<=2.99?line[28]=='3':line[0]=='>'&&line[31]=='3');
+        assert(readline(fp,line)&&strstr(line,"station ID:  200"));
+        assert(readline(fp,line)&&strstr(line,"0200")&&
+               strstr(line,"MARKER NAME"));
+        n++;
+    }
+    assert(n==1);
+    fclose(fp);
+    cmpobs("t_crinex_4.obs","t_crinex_4.rnx");
+    remove("t_crinex_4.obs"); remove("t_crinex_4.crx"); remove("t_crinex_4.rnx");
+}
+/* rtcm3 with station id change to compact rinex round-trip */
+void utest4(void)
+{
+    genrtcm3("t_crinex_4.rtcm3");
+    cmpevent(3.03);
+    cmpevent(2.11);
+    remove("t_crinex_4.rtcm3");
+
+    printf("%s utest4 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    utest3();
+    utest4();
+    return 0;
+}
@@ -136,7 +136,7 @@ void utest5(void)
     
     stat=readsap(file,time,&nav);
     
-    for (i=0;i<MAXSAT;i++) {
+    for (i=0;i<MAXSAT&&nav.pcvs;i++) {
         satno2id(i+1,id);
         printf("%2d %-4s %8.3f %8.3f %8.3f\n",i+1,id,
                nav.pcvs[i].off[0][0],nav.pcvs[i].off[0][1],nav.pcvs[i].off[0][2]);
@@ -0,0 +1,151 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : metrics server
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define FILE_RCV    "../data/rcvraw/testglo.rtcm3"
+#define METPORT     29100               /* first metrics port for test */
+
+/* dummy application functions for shared library ----------------------------*/
+extern int showmsg(char *format,...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* metrics output function ---------------------------------------------------*/
+static int outmetric(int fmt, char *buff, int nmax, void *arg)
+{
+    return rtksvrmetric((rtksvr_t *)arg,fmt,buff,nmax);
+}
+/* get metrics by http request -----------------------------------------------*/
+static int getmetric(const char *path, const char *req, char *buff, int nmax)
+{
+    stream_t str;
+    char *p,*q;
+    int i,n=0,m,len;
+
+    strinit(&str);
+    if (!stropen(&str,STR_TCPCLI,STR_MODE_RW,path)) return 0;
+
+    for (i=0;i<100&&strwrite(&str,(unsigned char *)req,strlen(req))<=0;i++) {
+        sleepms(50);
+    }
+    /* read response until end of body */
+    for (i=0;i<100&&n<nmax-1;i++) {
+        if ((m=strread(&str,(unsigned char *)buff+n,nmax-n-1))>0) n+=m;
+        buff[n]='\0';
+        if ((p=strstr(buff,"\r\n\r\n"))&&(q=strstr(buff,"Content-Length:"))&&
+            sscanf(q+15,"%d",&len)==1&&n>=(int)(p-buff)+4+len) break;
+        sleepms(50);
+    }
+    strclose(&str);
+    return n;
+}
+/* get value of metric -------------------------------------------------------*/
+static double metvalue(const char *buff, const char *name)
+{
+    char key[128];
+    const char *p;
+    double val=-1.0;
+
+    sprintf(key,"\n%s ",name);
+    if ((p=strstr(buff,key))) sscanf(p+strlen(key),"%lf",&val);
+    return val;
+}
+/* metsvrstart() bind address */
+void utest1(void)
+{
+    metsvr_t met={0};
+    static rtksvr_t svr;
+
+    assert(rtksvrinit(&svr));
+
+    assert(!metsvrstart(&met,"",outmetric,&svr));
+    assert(!metsvrstart(&met,"127.0.0.1:",outmetric,&svr));
+
+    /* loopback address by default */
+    assert(metsvrstart(&met,"29099",outmetric,&svr));
+    assert(!strcmp(met.addr,"127.0.0.1")&&met.port==29099);
+    metsvrstop(&met);
+
+    /* explicit bind address */
+    assert(metsvrstart(&met,"0.0.0.0:29099",outmetric,&svr));
+    assert(!strcmp(met.addr,"0.0.0.0")&&met.port==29099);
+    metsvrstop(&met);
+
+    rtksvrfree(&svr);
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* rtksvrmetric() by http request during file replay session */
+void utest2(void)
+{
+    static rtksvr_t svr;
+    metsvr_t met={0};
+    prcopt_t popt=prcopt_default;
+    solopt_t sopt[2];
+    int strs[MAXSTRRTK]={STR_FILE};
+    int fmts[3]={STRFMT_RTCM3,STRFMT_RTCM3,STRFMT_RTCM3};
+    char *paths[MAXSTRRTK]={FILE_RCV,"","","","","","",""};
+    char *cmds[3]={0},*cmds_periodic[3]={0},*rcvopts[3]={"","",""};
+    char path[64],errmsg[256],buff[65536];
+    double nmeapos[3]={0},nepoch,nsat;
+    int i,n,port;
+
+    popt.mode=PMODE_SINGLE;
+    popt.navsys=SYS_GPS|SYS_GLO;
+    sopt[0]=sopt[1]=solopt_default;
+
+    assert(rtksvrinit(&svr));
+    assert(rtksvrstart(&svr,10,32768,strs,paths,fmts,0,cmds,cmds_periodic,
+                       rcvopts,0,0,nmeapos,&popt,sopt,NULL,errmsg));
+    /* port of last run may be in time-wait state */
+    for (port=METPORT;port<METPORT+100;port++) {
+        sprintf(path,"%d",port);
+        if (metsvrstart(&met,path,outmetric,&svr)) break;
+    }
+    assert(port<METPORT+100);
+
+    /* wait until all epochs in file processed */
+    for (i=0,nepoch=0;i<200;i++) {
+        sleepms(50);
+        rtksvrlock(&svr);
+        n=(int)svr.nepoch;
+        rtksvrunlock(&svr);
+        if (n>0&&n==nepoch) break;
+        nepoch=n;
+    }
+    assert(n>0);
+
+    sprintf(path,"127.0.0.1:%d",port);
+    assert(getmetric(path,"GET /metrics HTTP/1.0\r\n\r\n",buff,sizeof(buff))>0);
+    assert(strstr(buff,"HTTP/1.0 200 OK"));
+    nepoch=metvalue(buff,"rtklib_rtksvr_epochs_total");
+    nsat  =metvalue(buff,"rtklib_rtksvr_nsat");
+    printf("epochs=%.0f nsat=%.0f nreq=%u\n",nepoch,nsat,met.nreq);
+    assert(nepoch==n&&nsat>=0.0);
+    assert(metvalue(buff,"rtklib_rtksvr_solution_delay_ms_sum")>=0.0);
+    assert(metvalue(buff,"rtklib_rtksvr_solution_delay_ms_max")>=0.0);
+    assert(!strstr(buff,"latency"));
+
+    assert(getmetric(path,"GET /metrics.json HTTP/1.0\r\n\r\n",buff,
+                     sizeof(buff))>0);
+    assert(strstr(buff,"application/json")&&
+           strstr(buff,"rtklib_rtksvr_epochs_total"));
+    assert(met.nreq==2);
+
+    metsvrstop(&met);
+    rtksvrstop(&svr,cmds);
+    rtksvrfree(&svr);
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+int main(void)
+{
+    strinitcom();
+    utest1();
+    utest2();
+    return 0;
+}
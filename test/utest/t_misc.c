@@ -2,6 +2,9 @@
 * rtklib unit test driver : misc functions
 *-----------------------------------------------------------------------------*/
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
 #include <assert.h>
 #include "../../src/rtklib.h"
 
@@ -182,11 +185,246 @@ void utest4(void)
     
     printf("%s utset4 : OK\n",__FILE__);
 }
+/* updcodepri(), tblcodepri() */
+void utest5(void)
+{
+    const int sys[]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP,SYS_IRN};
+    const char *opts[]={"","-GL1C -RL2P","-EL5Q -CL2I -JL1X -TADJ=1"};
+    codepri_t tbl={{{0}}};
+    int i,j,k;
+    
+    for (k=0;k<3;k++) {
+        updcodepri(&tbl,opts[k]);
+        for (i=0;i<7;i++) for (j=0;j<=MAXCODE+1;j++) {
+            assert(tblcodepri(&tbl,sys[i],(unsigned char)j)==
+                   getcodepri(sys[i],(unsigned char)j,opts[k]));
+        }
+    }
+    assert(tblcodepri(&tbl,SYS_GPS,CODE_L1C)>tblcodepri(&tbl,SYS_GPS,CODE_L1P));
+    assert(tblcodepri(&tbl,SYS_NONE,CODE_L1C)==0);
+    
+    /* update by code priority settings */
+    setcodepri(SYS_GPS,1,"PC");
+    updcodepri(&tbl,opts[2]);
+    assert(tblcodepri(&tbl,SYS_GPS,CODE_L1C)<tblcodepri(&tbl,SYS_GPS,CODE_L1P));
+    setcodepri(SYS_GPS,1,"CPYWMNSL");
+    updcodepri(&tbl,opts[2]);
+    assert(tblcodepri(&tbl,SYS_GPS,CODE_L1C)>tblcodepri(&tbl,SYS_GPS,CODE_L1P));
+    
+    printf("%s utset5 : OK\n",__FILE__);
+}
+/* write synthesized antex file ---------------------------------------------*/
+static void writeantex(const char *file, int nrcv)
+{
+    const char *rdms[]={"NONE","RDM1","RDM2"};
+    FILE *fp;
+    int i,j;
+    
+    assert((fp=fopen(file,"w")));
+    fprintf(fp,"%60s%-20s\n","","ANTEX VERSION / SYST");
+    for (i=0;i<32;i++) for (j=0;j<3;j++) { /* 3 blocks per prn */
+        fprintf(fp,"%60s%-20s\n","","START OF ANTENNA");
+        fprintf(fp,"%-20sG%02d%-17s%-20s%-20s\n","BLOCK IIR-M",i+1,"","",
+                "TYPE / SERIAL NO");
+        fprintf(fp,"%6d%6d%6d%6d%6d%13.7f%17s%-20s\n",2000+j*5,1,1,0,0,0.0,"",
+                "VALID FROM");
+        if (j<2) {
+            fprintf(fp,"%6d%6d%6d%6d%6d%13.7f%17s%-20s\n",2004+j*5,12,31,23,59,
+                    59.9999999,"","VALID UNTIL");
+        }
+        fprintf(fp,"%6s%-54s%-20s\n","G01","","START OF FREQUENCY");
+        fprintf(fp,"%10.2f%10.2f%10.2f%30s%-20s\n",i*1.0,j*1.0,1000.0,"",
+                "NORTH / EAST / UP");
+        fprintf(fp,"%6s%-54s%-20s\n","G01","","END OF FREQUENCY");
+        fprintf(fp,"%60s%-20s\n","","END OF ANTENNA");
+    }
+    for (i=0;i<nrcv;i++) {
+        fprintf(fp,"%60s%-20s\n","","START OF ANTENNA");
+        fprintf(fp,"ANT%05d        %-4s%20s%-20s%-20s\n",i/3,rdms[i%3],"","",
+                "TYPE / SERIAL NO");
+        fprintf(fp,"%6s%-54s%-20s\n","G01","","START OF FREQUENCY");
+        fprintf(fp,"%10.2f%10.2f%10.2f%30s%-20s\n",i*1.0,0.0,100.0,"",
+                "NORTH / EAST / UP");
+        fprintf(fp,"%6s%-54s%-20s\n","G01","","END OF FREQUENCY");
+        fprintf(fp,"%60s%-20s\n","","END OF ANTENNA");
+    }
+    fclose(fp);
+}
+/* readpcv(), searchpcv() with index */
+void utest6(void)
+{
+    const char *file="t_misc_pcv.atx";
+    const char *types[]={
+        "ANT00000        NONE","ANT00001 RDM1","ANT00002","ANT00003 RDMX",
+        "ANT00999    RDM2 ","NT0001","XXX","BLOCK IIR-M"
+    };
+    double ep[]={2000,1,1,0,0,0};
+    pcvs_t pcvs={0},pcvs0;
+    pcv_t *p,*q;
+    gtime_t time;
+    char type[64];
+    double t1,t2;
+    clock_t t0;
+    int i,j,k,nrcv=3000;
+    
+    writeantex(file,nrcv);
+    assert(readpcv(file,&pcvs)&&pcvs.n==32*3+nrcv&&pcvs.idx);
+    pcvs0=pcvs;
+    pcvs0.idx=NULL; /* linear search */
+    
+    /* satellite antennas */
+    for (i=0;i<25;i++) {
+        ep[0]=1998.0+i*0.7;
+        time=epoch2time(ep);
+        for (j=0;j<=MAXSAT;j++) {
+            p=searchpcv(j,"",time,&pcvs);
+            q=searchpcv(j,"",time,&pcvs0);
+            assert(p==q);
+            if (j>0&&j<=32&&ep[0]>=2000.0) {
+                assert(p&&fabs(p->off[0][0]-(j-1)*1E-3)<1E-9);
+            }
+        }
+    }
+    /* receiver antennas */
+    for (i=0;i<(int)(sizeof(types)/sizeof(char *));i++) {
+        p=searchpcv(0,types[i],time,&pcvs);
+        q=searchpcv(0,types[i],time,&pcvs0);
+        assert(p==q);
+    }
+    assert(!searchpcv(0,"XXX",time,&pcvs));
+    assert((p=searchpcv(0,"ANT00003 RDMX",time,&pcvs))&&p==pcvs.pcv+96+9);
+    assert((p=searchpcv(0,"ANT00999    RDM2 ",time,&pcvs))&&p==pcvs.pcv+96+2999);
+    
+    t0=clock();
+    for (k=0;k<100;k++) for (i=0;i<MAXSAT;i++) searchpcv(i+1,"",time,&pcvs);
+    for (i=0;i<nrcv;i++) {
+        sprintf(type,"ANT%05d RDM1",i/3);
+        searchpcv(0,type,time,&pcvs);
+    }
+    t1=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    t0=clock();
+    for (k=0;k<100;k++) for (i=0;i<MAXSAT;i++) searchpcv(i+1,"",time,&pcvs0);
+    for (i=0;i<nrcv;i++) {
+        sprintf(type,"ANT%05d RDM1",i/3);
+        p=searchpcv(0,type,time,&pcvs0);
+        assert(p==searchpcv(0,type,time,&pcvs));
+    }
+    t2=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    printf("searchpcv: n=%d index %.3f s linear %.3f s\n",pcvs.n,t1,t2);
+    
+    /* stale index after modification */
+    pcvs.n--;
+    assert(searchpcv(0,"ANT00999 RDM2",time,&pcvs)==pcvs.pcv+96+2997);
+    pcvs.n++;
+    
+    freepcv(&pcvs);
+    assert(!pcvs.pcv&&!pcvs.idx&&pcvs.n==0);
+    remove(file);
+    
+    printf("%s utset6 : OK\n",__FILE__);
+}
+/* gpst of mjd (utc) --------------------------------------------------------*/
+static gtime_t mjd2gpst(double mjd)
+{
+    const double ep[]={2000,1,1,12,0,0};
+    return utc2gpst(timeadd(epoch2time(ep),(mjd-51544.5)*86400.0));
+}
+/* reference erp values by linear search -------------------------------------*/
+static void referp(const erp_t *erp, double mjd, double *erpv)
+{
+    double a;
+    int j;
+    
+    for (j=0;j<erp->n-2;j++) if (mjd<erp->data[j+1].mjd) break;
+    a=(mjd-erp->data[j].mjd)/(erp->data[j+1].mjd-erp->data[j].mjd);
+    erpv[0]=(1.0-a)*erp->data[j].xp     +a*erp->data[j+1].xp;
+    erpv[1]=(1.0-a)*erp->data[j].yp     +a*erp->data[j+1].yp;
+    erpv[2]=(1.0-a)*erp->data[j].ut1_utc+a*erp->data[j+1].ut1_utc;
+    erpv[3]=(1.0-a)*erp->data[j].lod    +a*erp->data[j+1].lod;
+}
+/* readerp(), geterp() */
+void utest7(void)
+{
+    const char *file1="t_misc_erp.erp",*file2="t_misc_finals.all";
+    FILE *fp;
+    erp_t erp1={0},erp2={0};
+    double mjd,erpv[4],ref[4];
+    double t1;
+    clock_t t0;
+    int i,j,n=400;
+    
+    /* IGS ERP ver.2 */
+    assert((fp=fopen(file1,"w")));
+    fprintf(fp,"version 2\n");
+    fprintf(fp,"  MJD      Xpole   Ypole  UT1-UTC    LOD  Xsig  Ysig   UTsig LODsig  Nr Nf Nt     Xrt    Yrt  Xrtsig Yrtsig\n");
+    fprintf(fp,"         10**-6\"        .1us    .1us    10**-6\"     .1us  .1us            10**-6\"/d    10**-6\"/d\n");
+    for (i=0;i<n;i++) {
+        fprintf(fp,"%8.2f %7d %7d %8d %6d %5d %5d %6d %6d %3d %2d %2d %7d %6d %6d %6d\n",
+                57000.5+i,100000+i*100,300000-i*50,-2000000+i*1000,15000+i*7,
+                10,10,20,20,5,0,5,-300+i,200-i,10,10);
+    }
+    fclose(fp);
+    
+    /* IERS finals (bulletin A) with predictions without lod */
+    assert((fp=fopen(file2,"w")));
+    for (i=0;i<n;i++) {
+        fprintf(fp,"%2d%2d%2d %8.2f %c%10.6f%9.6f %9.6f%9.6f  %c%10.7f%10.7f",
+                14,12,9,57000.0+i,i<n-20?'I':'P',0.1+i*1E-4,0.000091,
+                0.3-i*5E-5,0.000091,i<n-20?'I':'P',-0.2+i*1E-4,0.0000102);
+        if (i<n-20) fprintf(fp," %7.4f%7.4f",1.5+i*7E-4,0.0102);
+        fprintf(fp,"\n");
+    }
+    fclose(fp);
+    
+    assert(readerp(file1,&erp1)&&erp1.n==n);
+    assert(readerp(file2,&erp2)&&erp2.n==n);
+    assert(fabs(erp1.data[1].xp-0.1001*AS2R)<1E-15);
+    assert(fabs(erp1.data[1].ut1_utc+0.1999)<1E-12);
+    assert(fabs(erp1.data[1].lod-0.0015007)<1E-12);
+    assert(fabs(erp1.data[1].xpr+299E-6*AS2R)<1E-15);
+    assert(fabs(erp2.data[1].xp-0.1001*AS2R)<1E-15);
+    assert(fabs(erp2.data[1].yp-0.29995*AS2R)<1E-15);
+    assert(fabs(erp2.data[1].ut1_utc+0.1999)<1E-12);
+    assert(fabs(erp2.data[1].lod-0.0015007)<1E-12);
+    assert(erp2.data[n-1].lod==0.0&&erp2.data[n-1].xpr==0.0);
+    
+    /* interpolation by random access and sequential access */
+    srand(0);
+    for (i=0;i<20000;i++) {
+        mjd=i<10000?57001.0+(rand()%(n*100-300))*0.01:57001.0+(i-10000)*1E-3;
+        for (j=0;j<2;j++) { /* second call by cache */
+            assert(geterp(&erp1,mjd2gpst(mjd),erpv));
+            referp(&erp1,mjd,ref);
+            assert(fabs(erpv[0]-ref[0])<1E-15&&fabs(erpv[1]-ref[1])<1E-15);
+            assert(fabs(erpv[2]-ref[2])<1E-12&&fabs(erpv[3]-ref[3])<1E-12);
+        }
+        assert(geterp(&erp2,mjd2gpst(mjd),erpv));
+        referp(&erp2,mjd,ref);
+        assert(fabs(erpv[0]-ref[0])<1E-15&&fabs(erpv[2]-ref[2])<1E-12);
+    }
+    /* extrapolation */
+    assert(geterp(&erp1,mjd2gpst(56999.5),erpv));
+    assert(fabs(erpv[0]-(0.1+300E-6)*AS2R)<1E-15);
+    assert(fabs(erpv[2]-(-0.2+0.0015))<1E-12);
+    
+    t0=clock();
+    for (i=0;i<1000000;i++) geterp(&erp1,mjd2gpst(57001.0+i*1E-5),erpv);
+    t1=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    printf("geterp: %.3f us/call\n",t1);
+    
+    free(erp1.data); free(erp2.data);
+    remove(file1); remove(file2);
+    
+    printf("%s utset7 : OK\n",__FILE__);
+}
 int main(void)
 {
     utest1();
     utest2();
     utest3();
     utest4();
+    utest5();
+    utest6();
+    utest7();
     return 0;
 }
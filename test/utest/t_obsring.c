@@ -0,0 +1,137 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : observation epoch ring buffer
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define NEPOCH      100000              /* number of epochs for stress test */
+#define NSLOT       32                  /* number of slots for stress test */
+
+/* fill epoch with sequence number -------------------------------------------*/
+static void setepoch(obs_t *obs, unsigned int seq)
+{
+    int i;
+
+    obs->n=(int)(seq%MAXOBS)+1;
+    for (i=0;i<obs->n;i++) {
+        obs->data[i].time.time=(time_t)seq;
+        obs->data[i].time.sec=0.0;
+        obs->data[i].sat=(unsigned char)(i+1);
+        obs->data[i].P[0]=seq*1000.0+i;
+    }
+}
+/* check epoch with sequence number ------------------------------------------*/
+static int chkepoch(const obs_t *obs, unsigned int seq)
+{
+    int i;
+
+    if (obs->n!=(int)(seq%MAXOBS)+1) return 0;
+    for (i=0;i<obs->n;i++) {
+        if (obs->data[i].time.time!=(time_t)seq||obs->data[i].sat!=i+1||
+            obs->data[i].P[0]!=seq*1000.0+i) return 0;
+    }
+    return 1;
+}
+/* initobsring(), obsringslot(), obsringcommit(), obsringpeek(),
+   obsringrelease() */
+void utest1(void)
+{
+    obsring_t ring={0};
+    obs_t *obs;
+    unsigned int seq;
+    int i;
+
+    assert(initobsring(&ring,5,MAXOBS));
+    assert(ring.nslot==8&&ring.nobs==MAXOBS);
+    assert(obsringcount(&ring)==0&&!obsringpeek(&ring,0));
+
+    /* fill ring until full */
+    for (i=0;i<8;i++) {
+        assert((obs=obsringslot(&ring))&&obs->nmax==MAXOBS);
+        setepoch(obs,i);
+        obsringcommit(&ring);
+    }
+    assert(obsringcount(&ring)==8);
+    assert(!obsringslot(&ring)&&ring.nover==1);
+
+    /* slot not committed is not visible to consumer */
+    for (i=0;i<8;i++) assert(chkepoch(obsringpeek(&ring,i),i));
+    assert(!obsringpeek(&ring,8)&&!obsringpeek(&ring,-1));
+
+    /* release and wrap around */
+    obsringrelease(&ring,3);
+    assert(obsringcount(&ring)==5&&chkepoch(obsringpeek(&ring,0),3));
+    for (seq=8;seq<11;seq++) {
+        assert((obs=obsringslot(&ring)));
+        setepoch(obs,seq);
+        obsringcommit(&ring);
+    }
+    for (i=0;i<8;i++) assert(chkepoch(obsringpeek(&ring,i),i+3));
+
+    /* release more than count */
+    obsringrelease(&ring,100);
+    assert(obsringcount(&ring)==0&&obsringslot(&ring));
+
+    freeobsring(&ring);
+    assert(!ring.epoch&&!ring.pool&&!obsringslot(&ring));
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* producer thread -----------------------------------------------------------*/
+static void *producer(void *arg)
+{
+    obsring_t *ring=(obsring_t *)arg;
+    obs_t *obs;
+    unsigned int seq;
+
+    for (seq=0;seq<NEPOCH;seq++) {
+        while (!(obs=obsringslot(ring))) sleepms(1);
+        setepoch(obs,seq);
+        obsringcommit(ring);
+    }
+    return NULL;
+}
+/* stress test by producer and consumer threads */
+void utest2(void)
+{
+    obsring_t ring={0};
+    pthread_t thread;
+    obs_t *obs;
+    unsigned int seq=0,nerr=0,x=1;
+    int i,n;
+
+    assert(initobsring(&ring,NSLOT,MAXOBS));
+    assert(!pthread_create(&thread,NULL,producer,&ring));
+
+    while (seq<NEPOCH) {
+        if ((n=obsringcount(&ring))<=0) {
+            sleepms(1);
+            continue;
+        }
+
+        /* consume random number of epochs in order */
+        x^=x<<13; x^=x>>17; x^=x<<5;
+        n=(int)(x%(unsigned int)n)+1;
+        for (i=0;i<n;i++,seq++) {
+            obs=obsringpeek(&ring,i);
+            if (!obs||!chkepoch(obs,seq)) nerr++;
+        }
+        obsringrelease(&ring,n);
+    }
+    pthread_join(thread,NULL);
+
+    assert(nerr==0&&seq==NEPOCH&&obsringcount(&ring)==0);
+    printf("epochs: %u  overflows: %u  errors: %u\n",seq,ring.nover,nerr);
+
+    freeobsring(&ring);
+
+    printf("%s utest2 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : standard positioning and raim fde
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define FILE_OBS    "../data/rinex/07590920.05o"
+#define FILE_NAV    "../data/rinex/07590920.05n"
+#define MAXEPOCH    400                 /* max number of epochs for test */
+
+#define SQR(x)      ((x)*(x))
+
+static obs_t obs={0};
+static nav_t nav={0};
+
+/* read rinex obs and nav ----------------------------------------------------*/
+static void readdata(void)
+{
+    if (obs.n>0) return;
+    assert(readrnx(FILE_OBS,1,"",&obs,&nav,NULL)>0);
+    assert(readrnx(FILE_NAV,1,"",&obs,&nav,NULL)>0);
+    sortobs(&obs);
+    uniqnav(&nav);
+    assert(obs.n>0&&nav.n>0);
+}
+/* processing options --------------------------------------------------------*/
+static prcopt_t setopt(int raim)
+{
+    prcopt_t opt=prcopt_default;
+    opt.mode=PMODE_SINGLE;
+    opt.navsys=SYS_GPS;
+    opt.ionoopt=IONOOPT_BRDC;
+    opt.tropopt=TROPOPT_SAAS;
+    opt.elmin=10.0*D2R;
+    opt.posopt[4]=raim;
+    return opt;
+}
+/* satellite exclusion by exhaustive search with pntpos() --------------------*/
+static int exhsearch(const obsd_t *data, int n, const prcopt_t *opt,
+                     sol_t *sol_h)
+{
+    obsd_t data_e[MAXOBS];
+    ssat_t ssat[MAXSAT];
+    sol_t sol;
+    char msg[128];
+    double rms,rms_h=100.0;
+    int i,j,k,nvsat,exc=-1;
+
+    for (i=0;i<n;i++) {
+        for (j=k=0;j<n;j++) if (j!=i) data_e[k++]=data[j];
+        memset(&sol,0,sizeof(sol));
+        if (!pntpos(data_e,n-1,&nav,opt,&sol,NULL,ssat,msg)) continue;
+
+        for (j=nvsat=0,rms=0.0;j<n-1;j++) {
+            if (!ssat[data_e[j].sat-1].vs) continue;
+            rms+=SQR(ssat[data_e[j].sat-1].resp[0]);
+            nvsat++;
+        }
+        if (nvsat<5||(rms=sqrt(rms/nvsat))>rms_h) continue;
+        rms_h=rms;
+        *sol_h=sol;
+        exc=i;
+    }
+    return exc;
+}
+/* valid satellites in solution without fault -------------------------------*/
+static int validsat(const obsd_t *data, int n, const prcopt_t *opt, int *index)
+{
+    ssat_t ssat[MAXSAT];
+    sol_t sol={{0}};
+    char msg[128];
+    int i,nv=0;
+
+    if (!pntpos(data,n,&nav,opt,&sol,NULL,ssat,msg)) return 0;
+    for (i=0;i<n;i++) if (ssat[data[i].sat-1].vs) index[nv++]=i;
+    return nv;
+}
+/* raim fde vs. exhaustive search for single fault */
+void utest1(void)
+{
+    prcopt_t opt=setopt(2),opt0=setopt(0);
+    obsd_t data[MAXOBS];
+    ssat_t ssat[MAXSAT];
+    sol_t sol,sol_h={{0}};
+    char msg[128];
+    double t1=0.0,t2=0.0;
+    clock_t t0;
+    int i,j,n,m,f,exc,nv,index[MAXOBS],nep=0,nraim=0;
+
+    readdata();
+
+    for (i=0;i<obs.n&&nep<MAXEPOCH;i=m) {
+        for (m=i+1;m<obs.n;m++) {
+            if (timediff(obs.data[m].time,obs.data[i].time)>DTTOL) break;
+        }
+        if ((n=m-i)>MAXOBS) continue;
+        for (j=0;j<n;j++) data[j]=obs.data[i+j];
+        if ((nv=validsat(data,n,&opt0,index))<7) continue;
+        nep++;
+
+        /* inject pseudorange fault */
+        f=index[nep%nv];
+        data[f].P[0]+=150.0;
+
+        memset(&sol,0,sizeof(sol));
+        t0=clock();
+        assert(pntpos(data,n,&nav,&opt,&sol,NULL,ssat,msg));
+        t1+=(double)(clock()-t0)/CLOCKS_PER_SEC;
+
+        t0=clock();
+        exc=exhsearch(data,n,&opt0,&sol_h);
+        t2+=(double)(clock()-t0)/CLOCKS_PER_SEC;
+
+        if (ssat[data[f].sat-1].vs) continue; /* not excluded */
+        nraim++;
+
+        assert(exc==f);
+        for (j=0;j<3;j++) assert(fabs(sol.rr[j]-sol_h.rr[j])<1E-3);
+        assert(sol.ns==sol_h.ns);
+    }
+    assert(nep>0&&nraim>nep*9/10);
+
+    printf("raim fde: %d/%d epochs %.1f us/epoch (exhaustive %.1f us/epoch)\n",
+           nraim,nep,t1*1E6/nep,t2*1E6/nep);
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* raim fde for multiple faults */
+void utest2(void)
+{
+    prcopt_t opt=setopt(2),opt0=setopt(0);
+    obsd_t data[MAXOBS],data_e[MAXOBS];
+    ssat_t ssat[MAXSAT];
+    sol_t sol,sol_e;
+    char msg[128];
+    int i,j,k,n,m,f1,f2,nv,index[MAXOBS],nep=0,nraim=0;
+
+    readdata();
+
+    for (i=0;i<obs.n&&nep<MAXEPOCH;i=m) {
+        for (m=i+1;m<obs.n;m++) {
+            if (timediff(obs.data[m].time,obs.data[i].time)>DTTOL) break;
+        }
+        if ((n=m-i)>MAXOBS) continue;
+        for (j=0;j<n;j++) data[j]=obs.data[i+j];
+        if ((nv=validsat(data,n,&opt0,index))<7) continue;
+        nep++;
+
+        /* inject two pseudorange faults */
+        f1=index[nep%nv]; f2=index[(nep+3)%nv];
+        data[f1].P[0]+=300.0;
+        data[f2].P[0]-=120.0;
+
+        memset(&sol,0,sizeof(sol));
+        assert(pntpos(data,n,&nav,&opt,&sol,NULL,ssat,msg));
+
+        if (ssat[data[f1].sat-1].vs||ssat[data[f2].sat-1].vs) continue;
+        nraim++;
+
+        /* solution without faulted satellites */
+        for (j=k=0;j<n;j++) if (j!=f1&&j!=f2) data_e[k++]=data[j];
+        memset(&sol_e,0,sizeof(sol_e));
+        assert(pntpos(data_e,k,&nav,&opt0,&sol_e,NULL,NULL,msg));
+        for (j=0;j<3;j++) assert(fabs(sol.rr[j]-sol_e.rr[j])<1E-3);
+    }
+    assert(nep>0&&nraim>=nep*3/4); /* weak geometry with 7 satellites */
+
+    printf("raim fde: %d/%d epochs with two faults excluded\n",nraim,nep);
+    printf("%s utest2 : OK\n",__FILE__);
+}
+/* raim fde only for invalid solution without chi-square option */
+void utest3(void)
+{
+    prcopt_t opt=setopt(1),opt0=setopt(0);
+    obsd_t data[MAXOBS];
+    ssat_t ssat[MAXSAT];
+    sol_t sol,sol0;
+    char msg[128];
+    int i,j,n,m,f,nv,index[MAXOBS],nep=0,ntest=0;
+
+    readdata();
+
+    for (i=0;i<obs.n&&nep<MAXEPOCH;i=m) {
+        for (m=i+1;m<obs.n;m++) {
+            if (timediff(obs.data[m].time,obs.data[i].time)>DTTOL) break;
+        }
+        if ((n=m-i)>MAXOBS) continue;
+        for (j=0;j<n;j++) data[j]=obs.data[i+j];
+        if ((nv=validsat(data,n,&opt0,index))<7) continue;
+        nep++;
+
+        /* pseudorange fault failing only chi-square test */
+        f=index[nep%nv];
+        data[f].P[0]+=150.0;
+
+        memset(&sol,0,sizeof(sol));
+        memset(&sol0,0,sizeof(sol0));
+        if (!pntpos(data,n,&nav,&opt0,&sol0,NULL,NULL,msg)) continue;
+        assert(pntpos(data,n,&nav,&opt,&sol,NULL,ssat,msg));
+        ntest++;
+        assert(ssat[data[f].sat-1].vs);
+        for (j=0;j<3;j++) assert(sol.rr[j]==sol0.rr[j]);
+    }
+    assert(ntest>nep/2);
+
+    printf("raim fde: %d/%d epochs without exclusion\n",ntest,nep);
+    printf("%s utest3 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    utest3();
+    return 0;
+}
@@ -179,6 +179,8 @@ void utest5(void)
         assert(stat);
     readrnx(file4,1,"",NULL,&nav,NULL);
         assert(nav.n>0);
+    stat=allocnav(&nav,0x100);
+        assert(stat);
     for (i=0;i<MAXSAT;i++) {
         if (!(pcv=searchpcv(i+1,"",time,&pcvs))) continue;
         nav.pcvs[i]=*pcv;
@@ -0,0 +1,242 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : receiver raw data decoder throughput and robustness
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define DIR_RCVRAW  "../data/rcvraw/"
+#define MAXDATA     262144              /* max input data length */
+#define NBENCH      5                   /* number of passes for benchmark */
+#define NMUTATE     8                   /* number of mutated streams */
+
+/* allocation counter (linked with -Wl,--wrap=malloc,...) */
+extern void *__real_malloc(size_t size);
+extern void *__real_calloc(size_t n, size_t size);
+extern void *__real_realloc(void *p, size_t size);
+
+static long nalloc=0;
+
+void *__wrap_malloc(size_t size)
+{
+    nalloc++;
+    return __real_malloc(size);
+}
+void *__wrap_calloc(size_t n, size_t size)
+{
+    nalloc++;
+    return __real_calloc(n,size);
+}
+void *__wrap_realloc(void *p, size_t size)
+{
+    nalloc++;
+    return __real_realloc(p,size);
+}
+/* recorded and synthesized streams for each format */
+typedef struct {
+    int format;                 /* stream format (STRFMT_???) */
+    const char *file;           /* recorded stream ("":synthesized) */
+    const char *sync;           /* sync pattern for synthesized stream */
+    int nsync;                  /* length of sync pattern */
+} rawfile_t;
+
+static const rawfile_t rawfiles[]={
+    {STRFMT_OEM4  ,"oemv_200911218.gps","\xAA\x44\x12"    ,3},
+    {STRFMT_UBX   ,"ubx_20080526.ubx"  ,"\xB5\x62"        ,2},
+    {STRFMT_CRES  ,"cres_20080526.bin" ,"$BIN"            ,4},
+    {STRFMT_GW10  ,"gw10_20110121.sbas","\x8B"            ,1},
+    {STRFMT_JAVAD ,"javad_20110115.jps","RT"              ,2},
+    {STRFMT_CNAV  ,""                  ,"\xAA\x44\x12"    ,3},
+    {STRFMT_SBP   ,""                  ,"\x55"            ,1},
+    {STRFMT_STQ   ,""                  ,"\xA0\xA1"        ,2},
+    {STRFMT_NVS   ,""                  ,"\x10"            ,1},
+    {STRFMT_BINEX ,""                  ,"\xE2"            ,1},
+    {STRFMT_RT17  ,""                  ,"\x02"            ,1},
+    {STRFMT_SEPT  ,""                  ,"$@"              ,2},
+    {STRFMT_CMR   ,""                  ,"\x02"            ,1},
+    {STRFMT_TERSUS,""                  ,"\xAA\x44\x12"    ,3}
+};
+#define NFILE ((int)(sizeof(rawfiles)/sizeof(rawfile_t)))
+
+/* read recorded stream or synthesize random stream with sync patterns -------*/
+static int readraw(const rawfile_t *f, unsigned char *buff)
+{
+    char path[256];
+    FILE *fp;
+    int n=0;
+
+    if (*f->file) {
+        sprintf(path,"%s%s",DIR_RCVRAW,f->file);
+        assert((fp=fopen(path,"rb")));
+        n=(int)fread(buff,1,MAXDATA,fp);
+        fclose(fp);
+        return n;
+    }
+    srand(f->format);
+    while (n<MAXDATA) {
+        if (rand()%32==0&&n+f->nsync<=MAXDATA) {
+            memcpy(buff+n,f->sync,f->nsync);
+            n+=f->nsync;
+        }
+        else buff[n++]=(unsigned char)(rand()%256);
+    }
+    return n;
+}
+/* check decoder outputs -----------------------------------------------------*/
+static void checkret(const raw_t *raw, int ret)
+{
+    assert(ret>=-1&&ret<=31);
+    if (ret==1) assert(raw->obs.n>=0&&raw->obs.n<=MAXOBS);
+    if (ret==2) assert(raw->ephsat>=0&&raw->ephsat<=MAXSAT);
+}
+/* input stream by input_raw() -----------------------------------------------*/
+static long inputraw(raw_t *raw, int format, const unsigned char *buff, int n)
+{
+    long nmsg=0;
+    int i,ret;
+
+    for (i=0;i<n;i++) {
+        ret=input_raw(raw,format,buff[i]);
+        checkret(raw,ret);
+        if (ret>0) nmsg++;
+    }
+    return nmsg;
+}
+/* input stream by input_rawf() ----------------------------------------------*/
+static long inputrawf(raw_t *raw, int format, const unsigned char *buff, int n)
+{
+    FILE *fp;
+    long nmsg=0;
+    int ret;
+
+    assert((fp=tmpfile()));
+    fwrite(buff,n,1,fp);
+    rewind(fp);
+    while ((ret=input_rawf(raw,format,fp))>=-1) {
+        checkret(raw,ret);
+        if (ret>0) nmsg++;
+    }
+    fclose(fp);
+    return nmsg;
+}
+/* decoder throughput by input_raw() and input_rawf() */
+void utest1(void)
+{
+    static unsigned char buff[MAXDATA];
+    static raw_t raw;
+    double t1,t2;
+    clock_t t0;
+    long nmsg1,nmsg2,na;
+    int i,j,n;
+
+    printf("%-20s %-9s %9s %9s %9s %9s %9s\n","format","stream","raw MB/s",
+           "msg/s","rawf MB/s","msg/s","alloc/msg");
+    for (i=0;i<NFILE;i++) {
+        n=readraw(rawfiles+i,buff);
+
+        t0=clock(); nmsg1=na=0;
+        for (j=0;j<NBENCH;j++) {
+            assert(init_raw(&raw,rawfiles[i].format));
+            na-=nalloc;
+            nmsg1+=inputraw(&raw,rawfiles[i].format,buff,n);
+            na+=nalloc;
+            free_raw(&raw);
+        }
+        t1=(double)(clock()-t0)/CLOCKS_PER_SEC;
+
+        t0=clock(); nmsg2=0;
+        for (j=0;j<NBENCH;j++) {
+            assert(init_raw(&raw,rawfiles[i].format));
+            nmsg2+=inputrawf(&raw,rawfiles[i].format,buff,n);
+            free_raw(&raw);
+        }
+        t2=(double)(clock()-t0)/CLOCKS_PER_SEC;
+
+        if (*rawfiles[i].file) assert(nmsg1>0&&nmsg2>0);
+
+        printf("%-20s %-9s %9.1f %9.0f %9.1f %9.0f %9.2f\n",
+               formatstrs[rawfiles[i].format],*rawfiles[i].file?"recorded":
+               "synth",n*NBENCH/1E6/(t1>0.0?t1:1E-9),nmsg1/(t1>0.0?t1:1E-9),
+               n*NBENCH/1E6/(t2>0.0?t2:1E-9),nmsg2/(t2>0.0?t2:1E-9),
+               nmsg1>0?(double)na/nmsg1:(double)na);
+    }
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* decoder robustness with corrupted and truncated streams */
+void utest2(void)
+{
+    static unsigned char buff[MAXDATA],data[MAXDATA];
+    static raw_t raw;
+    int i,j,k,n,m;
+
+    for (i=0;i<NFILE;i++) {
+        n=readraw(rawfiles+i,buff);
+        srand(i);
+
+        for (j=0;j<NMUTATE;j++) {
+            memcpy(data,buff,n);
+            m=n;
+            switch (j%4) {
+                case 0: /* bit flips */
+                    for (k=0;k<n/256;k++) data[rand()%n]^=1<<(rand()%8);
+                    break;
+                case 1: /* random bytes */
+                    for (k=0;k<n/256;k++) data[rand()%n]=(unsigned char)rand();
+                    break;
+                case 2: /* corrupted length fields (0xFF runs) */
+                    for (k=0;k<n/1024;k++) memset(data+rand()%(n-4),0xFF,4);
+                    break;
+                case 3: /* truncated stream */
+                    m=rand()%n;
+                    break;
+            }
+            assert(init_raw(&raw,rawfiles[i].format));
+            inputraw(&raw,rawfiles[i].format,data,m);
+            free_raw(&raw);
+
+            assert(init_raw(&raw,rawfiles[i].format));
+            inputrawf(&raw,rawfiles[i].format,data,m);
+            free_raw(&raw);
+        }
+    }
+    printf("%s utest2 : OK\n",__FILE__);
+}
+/* per-satellite states and decoder init/free */
+void utest3(void)
+{
+    static raw_t raw;
+    rawsat_t *p;
+    double t;
+    clock_t t0;
+    int i;
+
+    assert(init_raw(&raw,STRFMT_UBX));
+    for (i=0;i<MAXSAT;i++) assert(!raw.sats[i]);
+    assert(rawsat(&raw,0)==&raw.sat0&&rawsat(&raw,MAXSAT+1)==&raw.sat0);
+    p=rawsat(&raw,1);
+    assert(p&&p!=&raw.sat0&&p==raw.sats[0]&&p->lockt[0]==0.0&&!p->subfrm[0]);
+    p->lockt[0]=1.0;
+    assert(rawsat(&raw,1)==p&&rawsat(&raw,1)->lockt[0]==1.0);
+    assert(rawsat(&raw,MAXSAT)==raw.sats[MAXSAT-1]);
+    free_raw(&raw);
+    assert(!raw.sats[0]&&!raw.sats[MAXSAT-1]);
+
+    t0=clock();
+    for (i=0;i<1000;i++) {
+        assert(init_raw(&raw,STRFMT_UBX));
+        free_raw(&raw);
+    }
+    t=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    printf("sizeof(raw_t)=%d init_raw()+free_raw(): %.1f us\n",
+           (int)sizeof(raw_t),t*1E3);
+    printf("%s utest3 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    utest3();
+    return 0;
+}
@@ -0,0 +1,236 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : rinex obs/nav record output
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define NSAT    24                      /* number of satellites per epoch */
+#define NTOBS   6                       /* number of obs types */
+#define NEPOCH  2000                    /* number of epochs for golden test */
+#define NBENCH  20000                   /* number of epochs for benchmark */
+
+static const char *tobs[NTOBS]={"C1C","L1C","D1C","S1C","C2W","L2W"};
+
+/* reference obs field output (printf) */
+static char *refobsf(char *p, double obs, int lli, int qual)
+{
+    if (obs==0.0) p+=sprintf(p,"              ");
+    else p+=sprintf(p,"%14.3f",fmod(obs,1e9));
+    if (lli<0||!(lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK))) p+=sprintf(p," ");
+    else p+=sprintf(p,"%1.1d",lli&(LLI_SLIP|LLI_HALFC|LLI_BOCTRK));
+    if (qual<=0) p+=sprintf(p," "); else p+=sprintf(p,"%1.1x",qual);
+    return p;
+}
+/* reference nav field output (printf) */
+static char *refnavf(char *p, double value)
+{
+    double e=fabs(value)<1E-99?0.0:floor(log10(fabs(value))+1.0);
+    return p+sprintf(p," %s.%012.0fE%+03.0f",value<0.0?"-":" ",
+                     fabs(value)/pow(10.0,e-12.0),e);
+}
+/* random value including rounding edge cases */
+static double randval(double scale)
+{
+    double x=(rand()/(double)RAND_MAX-0.5)*2.0*scale;
+    switch (rand()%8) {
+        case 0: return floor(x*1000.0)/1000.0+0.0005; /* half of last digit */
+        case 1: return (rand()%2?1.0:-1.0)*rand()*1E-9; /* -0.000 */
+        case 2: return 0.0;
+        case 3: return x*1E3; /* beyond 1e9 */
+    }
+    return x;
+}
+/* rinex options */
+static void setopt(rnxopt_t *opt, double ver)
+{
+    int i;
+    memset(opt,0,sizeof(rnxopt_t));
+    opt->rnxver=ver;
+    opt->navsys=SYS_GPS;
+    opt->nobs[0]=NTOBS;
+    for (i=0;i<NTOBS;i++) strcpy(opt->tobs[0][i],tobs[i]);
+    for (i=0;i<MAXCODE;i++) opt->mask[0][i]='1';
+}
+/* observation data */
+static void setobs(obsd_t *obs, int ep)
+{
+    int i,j;
+    memset(obs,0,sizeof(obsd_t)*NSAT);
+    for (i=0;i<NSAT;i++) {
+        obs[i].time=gpst2time(2000,ep*0.1);
+        obs[i].sat=i+1;
+        obs[i].code[0]=CODE_L1C;
+        obs[i].code[1]=CODE_L2W;
+        for (j=0;j<2;j++) {
+            obs[i].P[j]=randval(3E7);
+            obs[i].L[j]=randval(2E8);
+            obs[i].D[j]=(float)randval(5E3);
+            obs[i].SNR[j]=(unsigned short)(rand()%256);
+            obs[i].LLI[j]=(unsigned char)(rand()%8);
+            obs[i].qualL[j]=(unsigned char)(rand()%20);
+            obs[i].qualP[j]=(unsigned char)(rand()%20);
+        }
+    }
+}
+/* reference obs record output (ver.3) */
+static int refobsb(char *p, const obsd_t *obs)
+{
+    double ep[6];
+    char *p0=p;
+    int i,j,k;
+    time2epoch(obs[0].time,ep);
+    p+=sprintf(p,"> %04.0f %2.0f %2.0f %2.0f %2.0f%11.7f  %d%3d%21s\n",
+               ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],0,NSAT,"");
+    for (i=0;i<NSAT;i++) {
+        p+=sprintf(p,"G%2d",obs[i].sat);
+        for (j=0;j<NTOBS;j++) {
+            k=j<4?0:1;
+            switch (tobs[j][0]) {
+                case 'C': p=refobsf(p,obs[i].P[k],-1,obs[i].qualP[k]); break;
+                case 'L': p=refobsf(p,obs[i].L[k],obs[i].LLI[k],obs[i].qualL[k]); break;
+                case 'D': p=refobsf(p,obs[i].D[k],-1,-1); break;
+                case 'S': p=refobsf(p,obs[i].SNR[k]*0.25,-1,-1); break;
+            }
+        }
+        *p++='\n';
+    }
+    return (int)(p-p0);
+}
+/* read file contents */
+static int readall(FILE *fp, char *buff, int size)
+{
+    int n;
+    rewind(fp);
+    n=(int)fread(buff,1,size,fp);
+    rewind(fp);
+    return n;
+}
+/* outrnxobsb() golden output */
+void utest1(void)
+{
+    static char out[NSAT*(NTOBS*18+4)+256],ref[NSAT*(NTOBS*18+4)+256];
+    rnxopt_t opt;
+    obsd_t obs[NSAT];
+    FILE *fp;
+    int i,n,m;
+
+    setopt(&opt,3.03);
+    srand(1);
+    for (i=0;i<NEPOCH;i++) {
+        setobs(obs,i);
+        fp=tmpfile(); assert(fp);
+        assert(outrnxobsb(fp,&opt,obs,NSAT,0));
+        n=readall(fp,out,sizeof(out));
+        fclose(fp);
+        m=refobsb(ref,obs);
+        assert(n==m&&!memcmp(out,ref,n));
+    }
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* outrnxnavb() golden output */
+void utest2(void)
+{
+    static char out[1024],ref[1024];
+    double val[29];
+    rnxopt_t opt;
+    eph_t eph={0};
+    FILE *fp;
+    char *p,*q;
+    int i,j,n,week=2000;
+
+    setopt(&opt,3.03);
+    srand(2);
+    for (i=0;i<NEPOCH;i++) {
+        eph.sat=i%32+1;
+        eph.week=week;
+        eph.toc=eph.toe=gpst2time(week,(i%336)*1800.0);
+        eph.ttr=gpst2time(week,(i%336)*1800.0+rand()%1800);
+        eph.f0=randval(1E-3); eph.f1=randval(1E-11); eph.f2=randval(1E-18);
+        eph.iode=rand()%256; eph.crs=randval(1E2); eph.deln=randval(1E-8);
+        eph.M0=randval(3.0); eph.cuc=randval(1E-5); eph.e=fabs(randval(1E-2));
+        eph.cus=randval(1E-5); eph.A=pow(5153.0+randval(1.0),2.0);
+        eph.toes=(i%336)*1800.0; eph.cic=randval(1E-7); eph.OMG0=randval(3.0);
+        eph.cis=randval(1E-7); eph.i0=randval(1.0); eph.crc=randval(3E2);
+        eph.omg=randval(3.0); eph.OMGd=randval(1E-8); eph.idot=randval(1E-9);
+        eph.code=1; eph.flag=0; eph.sva=0; eph.svh=0;
+        eph.tgd[0]=randval(1E-8); eph.iodc=eph.iode; eph.fit=4.0;
+
+        val[ 0]=eph.f0;   val[ 1]=eph.f1;   val[ 2]=eph.f2;
+        val[ 3]=eph.iode; val[ 4]=eph.crs;  val[ 5]=eph.deln; val[ 6]=eph.M0;
+        val[ 7]=eph.cuc;  val[ 8]=eph.e;    val[ 9]=eph.cus;  val[10]=sqrt(eph.A);
+        val[11]=eph.toes; val[12]=eph.cic;  val[13]=eph.OMG0; val[14]=eph.cis;
+        val[15]=eph.i0;   val[16]=eph.crc;  val[17]=eph.omg;  val[18]=eph.OMGd;
+        val[19]=eph.idot; val[20]=eph.code; val[21]=eph.week; val[22]=eph.flag;
+        val[23]=uravalue(eph.sva); val[24]=eph.svh; val[25]=eph.tgd[0];
+        val[26]=eph.iodc; val[27]=time2gpst(eph.ttr,NULL); val[28]=eph.fit;
+
+        fp=tmpfile(); assert(fp);
+        assert(outrnxnavb(fp,&opt,&eph));
+        n=readall(fp,out,sizeof(out)-1);
+        out[n]='\0';
+        fclose(fp);
+
+        /* compare data fields following epoch and line headers */
+        for (j=0,p=out;j<29;j++) {
+            if (j%4==3) {
+                assert(*p=='\n');
+                p+=5;
+            }
+            else if (j==0) p+=23;
+            q=refnavf(ref,val[j]);
+            assert(!strncmp(p,ref,q-ref));
+            p+=q-ref;
+        }
+        assert(!strcmp(p,"\n"));
+    }
+    printf("%s utest2 : OK\n",__FILE__);
+}
+/* outrnxobsb() throughput */
+void utest3(void)
+{
+    static char ref[NSAT*(NTOBS*18+4)+256];
+    static obsd_t obs[16][NSAT];
+    rnxopt_t opt;
+    FILE *fp;
+    double t1,t2;
+    long bytes=0;
+    clock_t t;
+    int i;
+
+    setopt(&opt,3.03);
+    srand(3);
+    for (i=0;i<16;i++) setobs(obs[i],i);
+
+    fp=tmpfile(); assert(fp);
+    t=clock();
+    for (i=0;i<NBENCH;i++) {
+        assert(outrnxobsb(fp,&opt,obs[i%16],NSAT,0));
+    }
+    t1=(double)(clock()-t)/CLOCKS_PER_SEC;
+    bytes=ftell(fp);
+    fclose(fp);
+
+    fp=tmpfile(); assert(fp);
+    t=clock();
+    for (i=0;i<NBENCH;i++) {
+        fwrite(ref,refobsb(ref,obs[i%16]),1,fp);
+    }
+    t2=(double)(clock()-t)/CLOCKS_PER_SEC;
+    assert(ftell(fp)==bytes);
+    fclose(fp);
+
+    printf("outrnxobsb: %d epochs %.1f MB %.3f s (%.1f MB/s) printf: %.3f s (%.1f MB/s)\n",
+           NBENCH,bytes/1E6,t1,bytes/1E6/(t1>0.0?t1:1E-9),t2,
+           bytes/1E6/(t2>0.0?t2:1E-9));
+    printf("%s utest3 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    utest3();
+    return 0;
+}
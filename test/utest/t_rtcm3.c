@@ -0,0 +1,319 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : rtcm 3 frame input and msm decoder/encoder
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define FILE_RTCM3  "../data/rcvraw/GMSD7_20121014.rtcm3"
+#define NBENCH      20                  /* number of passes for benchmark */
+
+#define MIN(x,y)    ((x)<(y)?(x):(y))
+
+extern const char *msm_sig_gps[32];
+extern const char *msm_sig_glo[32];
+extern const char *msm_sig_gal[32];
+extern const char *msm_sig_qzs[32];
+extern const char *msm_sig_sbs[32];
+extern const char *msm_sig_cmp[32];
+extern const unsigned char msm_code[6][32];
+extern const unsigned char msm_freq[6][32];
+extern const double msm_lam[6][6];
+
+static const int msm_sys[6]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_SBS,SYS_CMP};
+static const int msm7_type[6]={1077,1087,1097,1117,1107,1127};
+
+/* read file contents */
+static unsigned char *readall(const char *file, int *n)
+{
+    static unsigned char buff[1048576];
+    FILE *fp;
+    assert((fp=fopen(file,"rb")));
+    *n=(int)fread(buff,1,sizeof(buff),fp);
+    fclose(fp);
+    return buff;
+}
+/* msm signal tables vs. signal strings */
+void utest1(void)
+{
+    const char **sigs[6];
+    unsigned char code;
+    int i,j,freq,sat;
+
+    sigs[0]=msm_sig_gps; sigs[1]=msm_sig_glo; sigs[2]=msm_sig_gal;
+    sigs[3]=msm_sig_qzs; sigs[4]=msm_sig_sbs; sigs[5]=msm_sig_cmp;
+
+    for (i=0;i<6;i++) for (j=0;j<32;j++) {
+        code=obs2code(sigs[i][j],&freq);
+        if (msm_sys[i]==SYS_CMP) {
+            if      (freq==5) freq=2;
+            else if (freq==4) freq=3;
+        }
+        else if (msm_sys[i]==SYS_GAL) {
+            if (freq==5) freq=2;
+        }
+        assert(msm_code[i][j]==code);
+        assert(msm_freq[i][j]==freq);
+        if (code==CODE_NONE||msm_sys[i]==SYS_GLO) continue;
+
+        /* wave length (systems enabled in rtklib.h) */
+        switch (msm_sys[i]) {
+            case SYS_QZS: sat=satno(SYS_QZS,MINPRNQZS); break;
+            case SYS_SBS: sat=satno(SYS_SBS,MINPRNSBS); break;
+            default     : sat=satno(msm_sys[i],1); break;
+        }
+        if (!sat) continue;
+        assert(msm_lam[i][freq-1]==satwavelen(sat,freq-1,NULL));
+    }
+    printf("%s utest1 : OK\n",__FILE__);
+}
+/* msm7 encode and decode round trip */
+void utest2(void)
+{
+    static rtcm_t rtcm,enc,dec;
+    unsigned char *buff;
+    int i,j,k,m,n,ret,nobs=0,sync;
+
+    buff=readall(FILE_RTCM3,&n);
+    assert(init_rtcm(&rtcm)&&init_rtcm(&enc)&&init_rtcm(&dec));
+
+    for (i=0;i<n;i++) {
+        if ((ret=input_rtcm3(&rtcm,buff[i]))!=1) continue;
+
+        /* re-encode epoch as msm7 and decode */
+        enc.time=rtcm.time;
+        enc.staid=rtcm.staid;
+        enc.obs.n=rtcm.obs.n;
+        memcpy(enc.obs.data,rtcm.obs.data,sizeof(obsd_t)*rtcm.obs.n);
+        memcpy(enc.nav.geph,rtcm.nav.geph,sizeof(geph_t)*MAXPRNGLO);
+        for (m=0;m<6;m++) {
+            sync=m<5;
+            if (!gen_rtcm3(&enc,msm7_type[m],sync)) continue;
+            for (j=0;j<enc.nbyte;j++) input_rtcm3(&dec,enc.buff[j]);
+        }
+        assert(dec.obs.n==rtcm.obs.n);
+        for (j=0;j<rtcm.obs.n;j++) {
+            assert(dec.obs.data[j].sat==rtcm.obs.data[j].sat);
+            for (k=0;k<NFREQ+NEXOBS;k++) {
+                assert(dec.obs.data[j].code[k]==rtcm.obs.data[j].code[k]);
+                assert(fabs(dec.obs.data[j].P[k]-rtcm.obs.data[j].P[k])<1E-3);
+                assert(dec.obs.data[j].SNR[k]==rtcm.obs.data[j].SNR[k]);
+            }
+        }
+        nobs++;
+    }
+    assert(nobs>0);
+    free_rtcm(&rtcm); free_rtcm(&enc); free_rtcm(&dec);
+    printf("%s utest2 : OK (%d epochs)\n",__FILE__,nobs);
+}
+/* msm decode throughput */
+void utest3(void)
+{
+    static rtcm_t rtcm;
+    unsigned char *buff;
+    double t;
+    clock_t t0;
+    long nmsg=0;
+    int i,j,n;
+
+    buff=readall(FILE_RTCM3,&n);
+
+    t0=clock();
+    for (i=0;i<NBENCH;i++) {
+        assert(init_rtcm(&rtcm));
+        for (j=0;j<n;j++) input_rtcm3(&rtcm,buff[j]);
+        for (j=71;j<=127;j++) nmsg+=rtcm.nmsg3[j];
+        free_rtcm(&rtcm);
+    }
+    t=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    assert(nmsg>0);
+
+    printf("msm decode: %ld messages %.3f s (%.0f messages/s)\n",nmsg,t,
+           nmsg/(t>0.0?t:1E-9));
+    printf("%s utest3 : OK\n",__FILE__);
+}
+/* reference crc-24q (bitwise) */
+static unsigned int refcrc24q(const unsigned char *buff, int len)
+{
+    unsigned int crc=0;
+    int i,j;
+    for (i=0;i<len;i++) {
+        crc^=(unsigned int)buff[i]<<16;
+        for (j=0;j<8;j++) {
+            crc<<=1;
+            if (crc&0x1000000) crc^=0x1864CFB;
+        }
+    }
+    return crc;
+}
+/* rtk_crc24q() slicing-by-8 */
+void utest4(void)
+{
+    static unsigned char buff[1100];
+    int i,len;
+
+    srand(4);
+    for (i=0;i<(int)sizeof(buff);i++) buff[i]=(unsigned char)(rand()%256);
+    for (len=0;len<=(int)sizeof(buff);len++) {
+        assert(rtk_crc24q(buff,len)==refcrc24q(buff,len));
+        assert(rtk_crc24q(buff+len%8,len-len%8)==refcrc24q(buff+len%8,len-len%8));
+    }
+    printf("%s utest4 : OK\n",__FILE__);
+}
+/* input_rtcm3b() and input_rtcm3f() vs. input_rtcm3() */
+void utest5(void)
+{
+    static rtcm_t rtcm1,rtcm2;
+    static unsigned char data[1048576];
+    static int ret1[65536],ret2[65536];
+    unsigned char *buff;
+    FILE *fp;
+    int i,j,k,m,n,n1=0,n2=0,ret;
+
+    buff=readall(FILE_RTCM3,&n);
+    memcpy(data,buff,n);
+
+    /* inject noise and corrupted bytes */
+    srand(5);
+    for (i=0;i<200;i++) data[rand()%n]^=(unsigned char)(1+rand()%255);
+
+    assert(init_rtcm(&rtcm1));
+    for (i=0;i<n;i++) {
+        if ((ret=input_rtcm3(&rtcm1,data[i]))) ret1[n1++]=ret;
+    }
+    /* random block sizes */
+    assert(init_rtcm(&rtcm2));
+    for (i=0;i<n;i+=m) {
+        m=MIN(1+rand()%2048,n-i);
+        for (j=0;j<m;) {
+            if ((ret=input_rtcm3b(&rtcm2,data+i,m,&j))) ret2[n2++]=ret;
+        }
+        assert(j==m);
+    }
+    assert(n1>0&&n1==n2&&!memcmp(ret1,ret2,sizeof(int)*n1));
+    assert(rtcm1.nbyte==rtcm2.nbyte&&!memcmp(rtcm1.nmsg3,rtcm2.nmsg3,
+           sizeof(rtcm1.nmsg3)));
+    free_rtcm(&rtcm2);
+
+    /* file input */
+    assert((fp=tmpfile()));
+    fwrite(data,n,1,fp);
+    rewind(fp);
+    assert(init_rtcm(&rtcm2));
+    for (k=0;(ret=input_rtcm3f(&rtcm2,fp))>=-1;) {
+        if (ret) assert(k<n1&&ret==ret1[k++]);
+    }
+    assert(k==n1&&!memcmp(rtcm1.nmsg3,rtcm2.nmsg3,sizeof(rtcm1.nmsg3)));
+    fclose(fp);
+    free_rtcm(&rtcm1); free_rtcm(&rtcm2);
+    printf("%s utest5 : OK (%d messages)\n",__FILE__,n1);
+}
+/* frame splitter throughput */
+void utest6(void)
+{
+    static rtcm_t rtcm;
+    unsigned char *buff;
+    double t1,t2;
+    clock_t t0;
+    int i,j,n;
+
+    buff=readall(FILE_RTCM3,&n);
+
+    assert(init_rtcm(&rtcm));
+    t0=clock();
+    for (i=0;i<NBENCH;i++) {
+        for (j=0;j<n;j++) input_rtcm3(&rtcm,buff[j]);
+    }
+    t1=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    t0=clock();
+    for (i=0;i<NBENCH;i++) {
+        for (j=0;j<n;) input_rtcm3b(&rtcm,buff,n,&j);
+    }
+    t2=(double)(clock()-t0)/CLOCKS_PER_SEC;
+    free_rtcm(&rtcm);
+
+    printf("input_rtcm3: %.1f MB/s input_rtcm3b: %.1f MB/s\n",
+           n*NBENCH/1E6/(t1>0.0?t1:1E-9),n*NBENCH/1E6/(t2>0.0?t2:1E-9));
+    printf("%s utest6 : OK\n",__FILE__);
+}
+/* decoder event sink */
+static int nsink[3];
+static void sink_obs(decsink_t *sink, const obs_t *obs)
+{
+    rtcm_t *rtcm=(rtcm_t *)sink->arg;
+    assert(obs==&rtcm->obs&&obs->n>0);
+    nsink[0]++;
+}
+static void sink_eph(decsink_t *sink, int sat, const nav_t *nav)
+{
+    rtcm_t *rtcm=(rtcm_t *)sink->arg;
+    assert(nav==&rtcm->nav&&sat==rtcm->ephsat);
+    nsink[1]++;
+}
+/* input_rtcm3() with event sink */
+void utest7(void)
+{
+    static rtcm_t rtcm;
+    unsigned char *buff;
+    int i,n,ret,nret[3]={0};
+
+    buff=readall(FILE_RTCM3,&n);
+
+    assert(init_rtcm(&rtcm));
+    rtcm.sink.on_obs_epoch=sink_obs;
+    rtcm.sink.on_ephemeris=sink_eph;
+    rtcm.sink.arg=&rtcm;
+
+    for (i=0;i<n;) {
+        ret=input_rtcm3b(&rtcm,buff,n,&i);
+        if (ret==1) nret[0]++;
+        if (ret==2) nret[1]++;
+    }
+    assert(nret[0]>0&&nsink[0]==nret[0]&&nsink[1]==nret[1]);
+    free_rtcm(&rtcm);
+    printf("%s utest7 : OK (%d epochs %d ephemerides)\n",__FILE__,nsink[0],
+           nsink[1]);
+}
+/* msm decode throughput with receiver options */
+void utest8(void)
+{
+    static rtcm_t rtcm;
+    static const char *opts[]={"","-GL1C -GL2X -RL1C -EL1X -EL5Q -JL1C"};
+    unsigned char *buff;
+    double t;
+    clock_t t0;
+    long nmsg;
+    int i,j,k,n;
+
+    buff=readall(FILE_RTCM3,&n);
+
+    for (i=0;i<2;i++) {
+        t0=clock(); nmsg=0;
+        for (j=0;j<NBENCH;j++) {
+            assert(init_rtcm(&rtcm));
+            strcpy(rtcm.opt,opts[i]);
+            for (k=0;k<n;k++) input_rtcm3(&rtcm,buff[k]);
+            for (k=71;k<=127;k++) nmsg+=rtcm.nmsg3[k];
+            free_rtcm(&rtcm);
+        }
+        t=(double)(clock()-t0)/CLOCKS_PER_SEC;
+        assert(nmsg>0);
+        printf("msm decode opt=\"%s\": %.0f messages/s\n",opts[i],
+               nmsg/(t>0.0?t:1E-9));
+    }
+    printf("%s utest8 : OK\n",__FILE__);
+}
+int main(void)
+{
+    utest1();
+    utest2();
+    utest3();
+    utest4();
+    utest5();
+    utest6();
+    utest7();
+    utest8();
+    return 0;
+}
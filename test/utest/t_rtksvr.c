@@ -0,0 +1,94 @@
+/*------------------------------------------------------------------------------
+* rtklib unit test driver : rtk server
+*-----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/rtklib.h"
+
+#define FILE_RCV    "../data/rcvraw/testglo.rtcm3"
+#define FILE_SOL    "t_rtksvr_1.pos"
+
+/* dummy application functions for shared library ----------------------------*/
+extern int showmsg(char *format,...) {return 0;}
+extern void settspan(gtime_t ts, gtime_t te) {}
+extern void settime(gtime_t time) {}
+
+/* run rtk server with input files -------------------------------------------*/
+static int runsvr(rtksvr_t *svr, prcopt_t *popt, char *rov, char *base,
+                  char *sol)
+{
+    solopt_t sopt[2];
+    int strs[MAXSTRRTK]={STR_FILE,STR_FILE,STR_NONE,STR_FILE};
+    int fmts[3]={STRFMT_RTCM3,STRFMT_RTCM3,STRFMT_RTCM3};
+    char *paths[MAXSTRRTK]={0},*cmds[3]={0},*cmds_periodic[3]={0};
+    char *rcvopts[3]={"","",""},errmsg[256];
+    double nmeapos[3]={0};
+    int i,n,nepoch=0;
+
+    paths[0]=rov; paths[1]=base; paths[3]=sol;
+    for (i=0;i<MAXSTRRTK;i++) if (!paths[i]) paths[i]="";
+    sopt[0]=sopt[1]=solopt_default;
+
+    if (!rtksvrstart(svr,10,32768,strs,paths,fmts,0,cmds,cmds_periodic,
+                     rcvopts,0,0,nmeapos,popt,sopt,NULL,errmsg)) return 0;
+
+    /* wait until all epochs in files processed */
+    for (i=0;i<200;i++) {
+        sleepms(50);
+        rtksvrlock(svr);
+        n=(int)svr->nepoch;
+        rtksvrunlock(svr);
+        if (n>0&&n==nepoch) break;
+        nepoch=n;
+    }
+    rtksvrstop(svr,cmds);
+    return n;
+}
+/* rover and base epochs paired by time */
+void utest1(void)
+{
+    static rtksvr_t svr;
+    prcopt_t popt=prcopt_default;
+    FILE *fp;
+    char buff[1024];
+    double val[15];
+    int nepoch,nsol=0,nzero=0;
+
+    popt.mode=PMODE_KINEMA;
+    popt.navsys=SYS_GPS|SYS_GLO;
+    popt.refpos=POSOPT_SINGLE;
+
+    assert(rtksvrinit(&svr));
+
+    /* same data for rover and base decoded in same processing cycles */
+    nepoch=runsvr(&svr,&popt,FILE_RCV,FILE_RCV,FILE_SOL);
+    assert(nepoch>0);
+
+    assert((fp=fopen(FILE_SOL,"r")));
+    while (fgets(buff,sizeof(buff),fp)) {
+        if (buff[0]=='%') continue;
+        if (sscanf(buff,"%*s %*s %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf "
+                   "%lf %lf",val,val+1,val+2,val+3,val+4,val+5,val+6,val+7,
+                   val+8,val+9,val+10,val+11,val+12)<13) continue;
+        nsol++;
+
+        /* base epoch not after rover epoch (age of differential >= 0) */
+        assert(val[11]>=0.0);
+        if (val[11]==0.0) nzero++;
+    }
+    fclose(fp);
+    remove(FILE_SOL);
+    printf("epochs=%d solutions=%d age=0:%d\n",nepoch,nsol,nzero);
+    assert(nsol>0&&nzero==nsol);
+
+    rtksvrfree(&svr);
+
+    printf("%s utest1 : OK\n",__FILE__);
+}
+int main(void)
+{
+    strinitcom();
+    utest1();
+    return 0;
+}
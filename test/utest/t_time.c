@@ -294,6 +294,105 @@ void utest11(void)
     
     printf("%s utset11 : OK\n",__FILE__);
 }
+/* str2num() and str2time() by sscanf() as reference */
+static double ref_str2num(const char *s, int i, int n)
+{
+    double value;
+    char str[256],*p=str;
+    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<n) return 0.0;
+    for (s+=i;*s&&--n>=0;s++) *p++=*s=='d'||*s=='D'?'E':*s;
+    *p='\0';
+    return sscanf(str,"%lf",&value)==1?value:0.0;
+}
+static int ref_str2time(const char *s, int i, int n, gtime_t *t)
+{
+    double ep[6];
+    char str[256],*p=str;
+    if (i<0||(int)strlen(s)<i||(int)sizeof(str)-1<i) return -1;
+    for (s+=i;*s&&--n>=0;) *p++=*s++;
+    *p='\0';
+    if (sscanf(str,"%lf %lf %lf %lf %lf %lf",ep,ep+1,ep+2,ep+3,ep+4,ep+5)<6)
+        return -1;
+    if (ep[0]<100.0) ep[0]+=ep[0]<80.0?2000.0:1900.0;
+    *t=epoch2time(ep);
+    return 0;
+}
+static int sameval(double a, double b)
+{
+    return !memcmp(&a,&b,sizeof(double));
+}
+/* str2num(),str2time() vs sscanf() over corpus */
+void utest12(void)
+{
+    const char *nums[]={
+        "","   ","0","-0","+0.000","-0.0D+00","1","-1.","  .5",".","-.","+",
+        "-","1e","1E+","1.5e-","1d5","1D-05","1.234567890123D+04",
+        "-1.234567890123E-04"," 0.100000000000E+01","123456789012345678901234",
+        "0.1234567890123456789","1e22","1e23","1e-22","1e-23","9007199254740993",
+        "4.9406564584124654E-324","1.7976931348623157E+308","1E400","1E-400",
+        "inf","-INF","nan","0x1p3","0x","1.5x","12 34","3.14.15","  -12.5e3abc",
+        "999999.999999","-17.123456","00000000000000000000000123.5",
+        "0.000000000000000000000000001","1e00000000000000000000001","e5","D5",
+        "\t7.5","5\t","+-1","1e+-5","1.0E+01.5"
+    };
+    const char *eps[]={
+        "2004 1 1 0 1 2.345","  00 2 3 23 59 59.999","  80 10 30 6 58 9",
+        "2026 10 17  0  0  0.00000000","2026 10 17  0  0 30.000000",
+        "2026 10 17  0  1  0.000000","2026 10 17 23 59 59.9999999",
+        "2026 10 18  0  0  0.000000","2026 10 1  0  0  0","2026 10 17.5 1 2 3",
+        "2026 10 17","2026 10 17 1 2","2026/10/17 1 2 3","2026 10 17x1 2 3",
+        " 2026  10  17   1   2   3.5","2026 10 17\t1 2 3","1969 12 31 0 0 0",
+        "2100 1 1 0 0 0","2026 13 1 0 0 0","2026 10 17 0 0 -1"
+    };
+    const char *fmts[]={"%*.*f","%*.*E","%*.*e"};
+    gtime_t t1,t2;
+    double a,b,ep[6];
+    char str[256];
+    int i,j,k,n,w,d,s1,s2;
+    
+    /* fixed corpus at every position and width */
+    for (i=0;i<(int)(sizeof(nums)/sizeof(*nums));i++) {
+        sprintf(str,"..%s..",nums[i]);
+        n=(int)strlen(str);
+        for (j=0;j<=n;j++) for (k=0;k<=n-j+2;k++) {
+            a=str2num(str,j,k); b=ref_str2num(str,j,k);
+            assert(sameval(a,b));
+        }
+    }
+    for (i=0;i<(int)(sizeof(eps)/sizeof(*eps));i++) {
+        sprintf(str,"AS G01  %s  extra",eps[i]);
+        n=(int)strlen(str);
+        for (j=0;j<=10;j++) for (k=0;k<=n-j+2;k++) {
+            t1.time=t2.time=0; t1.sec=t2.sec=0.0;
+            s1=str2time(str,j,k,&t1); s2=ref_str2time(str,j,k,&t2);
+            assert(s1==s2&&t1.time==t2.time&&sameval(t1.sec,t2.sec));
+        }
+    }
+    /* random numbers in fixed-column formats */
+    srand(12345);
+    for (i=0;i<1000000;i++) {
+        w=rand()%24+1; d=rand()%16;
+        a=(rand()/(double)RAND_MAX-0.5)*pow(10.0,rand()%40-20);
+        sprintf(str,fmts[i%3],w,d,a);
+        if (i%7==0&&(n=(int)(strchr(str,'E')?strchr(str,'E')-str:-1))>=0) str[n]='D';
+        n=(int)strlen(str);
+        j=rand()%3; k=n-j+rand()%3-1;
+        a=str2num(str,j,k); b=ref_str2num(str,j,k);
+        assert(sameval(a,b));
+    }
+    /* random consecutive epochs */
+    for (i=0;i<200000;i++) {
+        t1.time=1790000000+(time_t)(i/5)*(rand()%2?30:86399); t1.sec=0.0;
+        time2epoch(t1,ep);
+        sprintf(str,i%2?"*  %4.0f %2.0f %2.0f %2.0f %2.0f %11.8f":
+                "AS G01  %4.0f %2.0f %2.0f %2.0f %2.0f %9.6f",ep[0],ep[1],
+                ep[2],ep[3],ep[4],ep[5]+(rand()%1000)*1E-3);
+        j=i%2?3:8;
+        s1=str2time(str,j,i%2?28:26,&t1); s2=ref_str2time(str,j,i%2?28:26,&t2);
+        assert(s1==s2&&t1.time==t2.time&&sameval(t1.sec,t2.sec));
+    }
+    printf("%s utset12: OK\n",__FILE__);
+}
 int main(void)
 {
     utest1();
@@ -307,5 +406,6 @@ int main(void)
     utest9();
     utest10();
     utest11();
+    utest12();
     return 0;
 }
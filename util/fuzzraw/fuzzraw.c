@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+* fuzzraw.c : receiver raw data decoder fuzzing entry point
+*
+* notes   : libFuzzer-compatible entry point for input_raw()/input_rawf().
+*           the stream format is selected by -DFUZZ_FORMAT=STRFMT_???.
+*           the first byte of the input selects input_raw() (even) or
+*           input_rawf() (odd). with -DFUZZ_MAIN, the inputs are read from
+*           the files given in the command line to replay crashes without
+*           libFuzzer.
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#ifndef FUZZ_FORMAT
+#define FUZZ_FORMAT STRFMT_UBX
+#endif
+
+static raw_t raw;
+
+/* check decoder outputs -----------------------------------------------------*/
+static void checkret(int ret)
+{
+    if (ret<-1||ret>31||(ret==1&&(raw.obs.n<0||raw.obs.n>MAXOBS))||
+        (ret==2&&(raw.ephsat<0||raw.ephsat>MAXSAT))) {
+        fprintf(stderr,"invalid decoder output: ret=%d\n",ret);
+        abort();
+    }
+}
+/* fuzzing entry point -------------------------------------------------------*/
+extern int LLVMFuzzerTestOneInput(const unsigned char *data, size_t size)
+{
+    FILE *fp;
+    size_t i;
+    int ret;
+    
+    if (size<1||!init_raw(&raw,FUZZ_FORMAT)) return 0;
+    
+    if (!(data[0]&1)) {
+        for (i=1;i<size;i++) checkret(input_raw(&raw,FUZZ_FORMAT,data[i]));
+    }
+    else if ((fp=tmpfile())) {
+        fwrite(data+1,1,size-1,fp);
+        rewind(fp);
+        while ((ret=input_rawf(&raw,FUZZ_FORMAT,fp))>=-1) checkret(ret);
+        fclose(fp);
+    }
+    free_raw(&raw);
+    return 0;
+}
+#ifdef FUZZ_MAIN
+/* replay inputs -------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    static unsigned char buff[1048576];
+    FILE *fp;
+    size_t n;
+    int i;
+    
+    for (i=1;i<argc;i++) {
+        if (!(fp=fopen(argv[i],"rb"))) {
+            fprintf(stderr,"file open error: %s\n",argv[i]);
+            continue;
+        }
+        n=fread(buff,1,sizeof(buff),fp);
+        fclose(fp);
+        LLVMFuzzerTestOneInput(buff,n);
+        fprintf(stderr,"%s: %d bytes ok\n",argv[i],(int)n);
+    }
+    return 0;
+}
+#endif /* FUZZ_MAIN */
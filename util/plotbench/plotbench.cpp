@@ -0,0 +1,198 @@
+/*------------------------------------------------------------------------------
+* plotbench.cpp : rtkplot level-of-detail index benchmark
+*
+* notes   : builds the time-series pyramid and the track grid of rtkplot_qt
+*           (app/rtkplot_qt/plotlod.cpp) over synthetic solutions in solbuf_t
+*           converted to local e/n/u as SolToPos() does, and measures build
+*           and query time and the number of points to draw for a series of
+*           zoom levels. the decimated series are checked against the min/max
+*           of the raw samples in every pixel column.
+*
+*           plotbench [-n nsol] [-w width] [-s] [-r repeat]
+*
+*           -n nsol   number of solutions (default: 604800, 1 week at 1 Hz)
+*           -w width  plot width in pixels (default: 1000)
+*           -s        static solutions (default: kinematic)
+*           -r repeat number of queries per zoom level (default: 100)
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include <vector>
+#include <algorithm>
+#include "rtklib.h"
+#include "plotlod.h"
+
+#define NZOOM       5                   /* number of zoom levels */
+
+/* solution-plot data as TIMEPOS of rtkplot ----------------------------------*/
+typedef struct {
+    int n;
+    double *t,*x,*y,*z;
+    int *q;
+} plotpos_t;
+
+/* elapsed time (ms) ---------------------------------------------------------*/
+static double elapsed(unsigned int tick)
+{
+    return (double)(tickget()-tick);
+}
+/* generate synthetic solutions ----------------------------------------------*/
+static void gensol(solbuf_t *sol, int n, int stat)
+{
+    const double pos0[]={35.0*D2R,139.0*D2R,50.0};
+    const double ep0[]={2026,10,1,0,0,0};
+    gtime_t time=epoch2time(ep0);
+    sol_t data={{0}};
+    double r0[3],enu[3]={0},dr[3],ang;
+    int i;
+
+    pos2ecef(pos0,r0);
+    srand(1);
+
+    for (i=0;i<n;i++) {
+        if (stat) { /* first-order gauss-markov noise of a few mm */
+            enu[0]=0.995*enu[0]+0.001*(rand()/(double)RAND_MAX-0.5);
+            enu[1]=0.995*enu[1]+0.001*(rand()/(double)RAND_MAX-0.5);
+            enu[2]=0.995*enu[2]+0.003*(rand()/(double)RAND_MAX-0.5);
+        }
+        else { /* laps of 2 km circuit at 10 m/s with noise */
+            ang=fmod(i*10.0/1000.0,2.0*PI);
+            enu[0]=1000.0*cos(ang)+0.02*(rand()/(double)RAND_MAX-0.5);
+            enu[1]=1000.0*sin(ang)+0.02*(rand()/(double)RAND_MAX-0.5);
+            enu[2]=5.0*sin(ang*3.0)+0.05*(rand()/(double)RAND_MAX-0.5);
+        }
+        enu2ecef(pos0,enu,dr);
+        data.time=timeadd(time,(double)i);
+        data.rr[0]=r0[0]+dr[0];
+        data.rr[1]=r0[1]+dr[1];
+        data.rr[2]=r0[2]+dr[2];
+        data.qr[0]=data.qr[1]=data.qr[2]=1E-4f;
+        data.stat=rand()%100<95?SOLQ_FIX:(rand()%2?SOLQ_FLOAT:SOLQ_SINGLE);
+        data.type=0;
+        addsol(sol,&data);
+    }
+}
+/* solutions to plot positions (Plot::SolToPos()) ----------------------------*/
+static void soltopos(solbuf_t *sol, plotpos_t *pp)
+{
+    sol_t *data;
+    double opos[3],r[3],enu[3];
+    int i,j;
+
+    pp->t=new double[sol->n]; pp->x=new double[sol->n];
+    pp->y=new double[sol->n]; pp->z=new double[sol->n];
+    pp->q=new int[sol->n];
+    pp->n=0;
+
+    ecef2pos(getsol(sol,0)->rr,opos);
+    for (i=0;(data=getsol(sol,i))!=NULL;i++) {
+        for (j=0;j<3;j++) r[j]=data->rr[j]-getsol(sol,0)->rr[j];
+        ecef2enu(opos,r,enu);
+        pp->t[pp->n]=timediff(data->time,getsol(sol,0)->time);
+        pp->x[pp->n]=enu[0];
+        pp->y[pp->n]=enu[1];
+        pp->z[pp->n]=enu[2];
+        pp->q[pp->n++]=data->stat;
+    }
+}
+/* check min/max of decimated series in each pixel column --------------------*/
+static int checkser(const plotpos_t *pp, const std::vector<int> &index,
+                    double t0, double t1, int npix)
+{
+    std::vector<double> mn(npix,1E99),mx(npix,-1E99),dmn(npix,1E99),dmx(npix,-1E99);
+    int i,c;
+
+    for (i=0;i<pp->n;i++) {
+        if (pp->t[i]<t0||pp->t[i]>t1) continue;
+        c=(int)((pp->t[i]-t0)/(t1-t0)*npix); if (c>=npix) c=npix-1;
+        if (pp->x[i]<mn[c]) mn[c]=pp->x[i];
+        if (pp->x[i]>mx[c]) mx[c]=pp->x[i];
+    }
+    for (i=0;i<(int)index.size();i++) {
+        if (pp->t[index[i]]<t0||pp->t[index[i]]>t1) continue;
+        c=(int)((pp->t[index[i]]-t0)/(t1-t0)*npix); if (c>=npix) c=npix-1;
+        if (pp->x[index[i]]<dmn[c]) dmn[c]=pp->x[index[i]];
+        if (pp->x[index[i]]>dmx[c]) dmx[c]=pp->x[index[i]];
+    }
+    for (c=0;c<npix;c++) {
+        if (mn[c]!=dmn[c]||mx[c]!=dmx[c]) return 0;
+    }
+    return 1;
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    solbuf_t sol={0};
+    plotpos_t pp;
+    SeriesLod ser;
+    TrackLod trk;
+    std::vector<int> index;
+    const double *y[3];
+    unsigned int tick;
+    double t0,t1,span,xl[2],yl[2],ext,pix,tb,tq;
+    int i,j,n=604800,width=1000,stat=0,nrep=100,np,nmark,ok=1;
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-n")&&i+1<argc) n=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-w")&&i+1<argc) width=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-r")&&i+1<argc) nrep=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s")) stat=1;
+    }
+    if (n<2||width<1||nrep<1) return -1;
+
+    initsolbuf(&sol,0,0);
+    gensol(&sol,n,stat);
+    soltopos(&sol,&pp);
+
+    printf("solutions: %d (%s)  width: %d px\n",pp.n,stat?"static":"kinematic",
+           width);
+
+    /* time series pyramid */
+    y[0]=pp.x; y[1]=pp.y; y[2]=pp.z;
+    tick=tickget();
+    ser.Build(pp.t,y,3,pp.q,pp.n);
+    printf("series build: %8.1f ms\n",elapsed(tick));
+
+    for (i=0;i<NZOOM;i++) {
+        span=(pp.t[pp.n-1]-pp.t[0])/pow(10.0,i);
+        t0=pp.t[0]+(pp.t[pp.n-1]-pp.t[0]-span)/2.0;
+        t1=t0+span;
+        tick=tickget();
+        for (j=0;j<nrep;j++) np=ser.Query(t0,t1,width,0,index);
+        tq=elapsed(tick)/nrep;
+        if (!checkser(&pp,index,t0,t1,width)) ok=0;
+        printf("series zoom 1/%-6.0f: %7d points  %8.3f ms/query\n",
+               pow(10.0,i),np,tq);
+    }
+    /* track grid */
+    tick=tickget();
+    trk.Build(pp.x,pp.y,pp.q,pp.n);
+    tb=elapsed(tick);
+    printf("track  build: %8.1f ms\n",tb);
+
+    ext=0.0;
+    for (i=0;i<pp.n;i++) {
+        ext=std::max(ext,std::max(fabs(pp.x[i]),fabs(pp.y[i])));
+    }
+    for (i=0;i<NZOOM;i++) {
+        span=2.0*ext/pow(10.0,i);
+        xl[0]=-span/2.0; xl[1]=xl[0]+span; /* zoom on first point */
+        yl[0]=-span/2.0; yl[1]=yl[0]+span;
+        pix=span/width;
+        tick=tickget();
+        for (j=0;j<nrep;j++) {
+            np=trk.QueryLine(xl,yl,pix,index);
+            nmark=trk.QueryMarks(xl,yl,pix,index);
+        }
+        tq=elapsed(tick)/nrep;
+        printf("track  zoom 1/%-6.0f: %7d line %7d marks  %8.3f ms/query\n",
+               pow(10.0,i),np,nmark,tq);
+    }
+    printf("min/max check: %s\n",ok?"OK":"NG");
+
+    delete [] pp.t; delete [] pp.x; delete [] pp.y; delete [] pp.z;
+    delete [] pp.q;
+    freesolbuf(&sol);
+    return ok?0:-1;
+}
@@ -0,0 +1,305 @@
+/*------------------------------------------------------------------------------
+* prodbench.c : sp3 and rinex clock reader benchmark
+*
+* notes   : writes synthetic full-day multi-gnss sp3 precise ephemeris and rinex
+*           clock files, reads them by readsp3() and readrnxc() and by reference
+*           readers of line-by-line fgets(), str2num() and str2time() as the
+*           previous readsp3b() and readrnxclk(), measures the read time and
+*           checks that both produce identical navigation data.
+*
+*           prodbench [-d dir] [-i sp3int] [-c clkint] [-s nsta] [-r repeat]
+*
+*           -d dir    directory of product files (default: .)
+*           -i sp3int sp3 interval (s) (default: 300)
+*           -c clkint clock interval (s) (default: 30)
+*           -s nsta   number of station clocks (default: 400)
+*           -r repeat number of reads (default: 3)
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define NSATSP3     85                  /* max satellites in sp3-c header */
+#define MAXLINE     1024                /* max line length */
+
+static const double ep0[]={2026,10,17,0,0,0}; /* product start time */
+
+/* uniform random number in [a,b] --------------------------------------------*/
+static double urand(double a, double b)
+{
+    return a+(b-a)*rand()/(double)RAND_MAX;
+}
+/* satellite list ------------------------------------------------------------*/
+static int satlist(int *sats, int nmax)
+{
+    const int sys[]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_CMP};
+    const int nsat[]={32,24,30,40};
+    int i,j,n=0,sat;
+
+    for (i=0;i<4;i++) for (j=1;j<=nsat[i]&&n<nmax;j++) {
+        if ((sat=satno(sys[i],j))) sats[n++]=sat;
+    }
+    return n;
+}
+/* write synthetic sp3 file --------------------------------------------------*/
+static int gensp3(const char *file, double tint)
+{
+    FILE *fp;
+    gtime_t t0=epoch2time(ep0),time;
+    double ep[6];
+    int i,j,k,n,ne=(int)(86400.0/tint),sats[NSATSP3];
+    char id[8];
+
+    if (!(fp=fopen(file,"w"))) return 0;
+
+    n=satlist(sats,NSATSP3);
+
+    fprintf(fp,"#cP%4.0f %2.0f %2.0f %2.0f %2.0f %11.8f %7d ORBIT IGS14 HLM  IGS\n",
+            ep0[0],ep0[1],ep0[2],ep0[3],ep0[4],ep0[5],ne);
+    fprintf(fp,"## 2336 518400.00000000 %14.8f 61330 0.0000000000000\n",tint);
+    for (i=0;i<5;i++) {
+        fprintf(fp,i==0?"+  %3d   ":"+        ",n);
+        for (j=0;j<17;j++) {
+            if ((k=i*17+j)<n) satno2id(sats[k],id); else strcpy(id,"  0");
+            fprintf(fp,"%3s",id);
+        }
+        fprintf(fp,"\n");
+    }
+    for (i=0;i<5;i++) {
+        fprintf(fp,"++       ");
+        for (j=0;j<17;j++) fprintf(fp,"%3d",i*17+j<n?2:0);
+        fprintf(fp,"\n");
+    }
+    fprintf(fp,"%%c M  cc GPS ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n");
+    fprintf(fp,"%%c cc cc ccc ccc cccc cccc cccc cccc ccccc ccccc ccccc ccccc\n");
+    fprintf(fp,"%%f  1.2500000  1.025000000  0.00000000000  0.000000000000000\n");
+    fprintf(fp,"%%f  0.0000000  0.000000000  0.00000000000  0.000000000000000\n");
+    fprintf(fp,"%%i    0    0    0    0      0      0      0      0         0\n");
+    fprintf(fp,"%%i    0    0    0    0      0      0      0      0         0\n");
+    for (i=0;i<4;i++) fprintf(fp,"/* SYNTHETIC PRODUCT\n");
+
+    for (i=0;i<ne;i++) {
+        time=timeadd(t0,i*tint);
+        time2epoch(time,ep);
+        fprintf(fp,"*  %4.0f %2.0f %2.0f %2.0f %2.0f %11.8f\n",ep[0],ep[1],ep[2],
+                ep[3],ep[4],ep[5]);
+        for (j=0;j<n;j++) {
+            satno2id(sats[j],id);
+            fprintf(fp,"P%3s%14.6f%14.6f%14.6f%14.6f %2d %2d %2d %3d\n",id,
+                    urand(-3E4,3E4),urand(-3E4,3E4),urand(-3E4,3E4),
+                    urand(-1E3,1E3),rand()%20,rand()%20,rand()%20,rand()%200);
+        }
+    }
+    fprintf(fp,"EOF\n");
+    fclose(fp);
+    return ne;
+}
+/* write synthetic rinex clock file ------------------------------------------*/
+static int genclk(const char *file, double tint, int nsta)
+{
+    FILE *fp;
+    gtime_t t0=epoch2time(ep0),time;
+    double ep[6];
+    int i,j,n,ne=(int)(86400.0/tint),sats[MAXSAT];
+    char id[8];
+
+    if (!(fp=fopen(file,"w"))) return 0;
+
+    n=satlist(sats,MAXSAT);
+
+    fprintf(fp,"%9.2f%11s%-20s%-20s%-20s\n",3.0,"","C","M","RINEX VERSION / TYPE");
+    fprintf(fp,"%-60s%-20s\n","PRODBENCH","PGM / RUN BY / DATE");
+    fprintf(fp,"%6d    %-2s    %-2s%42s%-20s\n",2,"AR","AS","",
+            "# / TYPES OF DATA");
+    fprintf(fp,"%6d%54s%-20s\n",nsta,"","# OF SOLN STA / TRF");
+    for (i=0;i<nsta;i++) {
+        fprintf(fp,"S%03d %20s%11.0f %11.0f %11.0f%-20s\n",i,"",
+                urand(-6E9,6E9),urand(-6E9,6E9),urand(-6E9,6E9),
+                "SOLN STA NAME / NUM");
+    }
+    fprintf(fp,"%6d%54s%-20s\n",n,"","# OF SOLN SATS");
+    fprintf(fp,"%60s%-20s\n","","END OF HEADER");
+
+    for (i=0;i<ne;i++) {
+        time=timeadd(t0,i*tint);
+        time2epoch(time,ep);
+        for (j=0;j<nsta;j++) {
+            fprintf(fp,"AR S%03d %4.0f %2.0f %2.0f %2.0f %2.0f%10.6f%3d   "
+                    "%19.12E %19.12E\n",j,ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],2,
+                    urand(-1E-3,1E-3),urand(1E-11,1E-10));
+        }
+        for (j=0;j<n;j++) {
+            satno2id(sats[j],id);
+            fprintf(fp,"AS %-4s %4.0f %2.0f %2.0f %2.0f %2.0f%10.6f%3d   "
+                    "%19.12E %19.12E\n",id,ep[0],ep[1],ep[2],ep[3],ep[4],ep[5],2,
+                    urand(-1E-3,1E-3),urand(1E-11,1E-10));
+        }
+    }
+    fclose(fp);
+    return ne;
+}
+/* reference sp3 reader (fgets, str2num and str2time) ------------------------*/
+static void refsp3(const char *file, nav_t *nav)
+{
+    FILE *fp;
+    peph_t *peph=NULL;
+    gtime_t time;
+    double bfact[2]={0},val,std,base;
+    int i,j,sat,sys,prn;
+    char buff[MAXLINE];
+
+    if (!(fp=fopen(file,"r"))) return;
+
+    for (i=0;i<22&&fgets(buff,sizeof(buff),fp);i++) {
+        if (i==14) {
+            bfact[0]=str2num(buff, 3,10);
+            bfact[1]=str2num(buff,14,12);
+        }
+    }
+    while (fgets(buff,sizeof(buff),fp)) {
+        if (!strncmp(buff,"EOF",3)) break;
+
+        if (buff[0]=='*'&&!str2time(buff,3,28,&time)) {
+            if (nav->ne>=nav->nemax) {
+                nav->nemax+=256;
+                nav->peph=(peph_t *)realloc(nav->peph,sizeof(peph_t)*nav->nemax);
+            }
+            peph=nav->peph+nav->ne++;
+            memset(peph,0,sizeof(peph_t));
+            peph->time=time;
+            continue;
+        }
+        if (!peph||buff[0]!='P') continue;
+
+        sys=buff[1]==' '?SYS_GPS:(buff[1]=='R'?SYS_GLO:buff[1]=='E'?SYS_GAL:
+            buff[1]=='C'?SYS_CMP:SYS_GPS);
+        prn=(int)str2num(buff,2,2);
+        if (!(sat=satno(sys,prn))) continue;
+
+        for (j=0;j<4;j++) {
+            val=str2num(buff, 4+j*14,14);
+            std=str2num(buff,61+j* 3,j<3?2:3);
+            if (val!=0.0&&fabs(val-999999.999999)>=1E-6) {
+                peph->pos[sat-1][j]=val*(j<3?1000.0:1E-6);
+            }
+            if ((base=bfact[j<3?0:1])>0.0&&std>0.0) {
+                peph->std[sat-1][j]=(float)(pow(base,std)*(j<3?1E-3:1E-12));
+            }
+        }
+    }
+    fclose(fp);
+}
+/* reference rinex clock reader (fgets, str2num and str2time) ----------------*/
+static void refclk(const char *file, nav_t *nav)
+{
+    FILE *fp;
+    pclk_t *pclk;
+    gtime_t time;
+    double data[2];
+    int i,sat;
+    char buff[MAXLINE],satid[8]="";
+
+    if (!(fp=fopen(file,"r"))) return;
+
+    while (fgets(buff,sizeof(buff),fp)) {
+        if (strstr(buff,"END OF HEADER")) break;
+    }
+    while (fgets(buff,sizeof(buff),fp)) {
+        if (str2time(buff,8,26,&time)) continue;
+
+        sprintf(satid,"%.4s",buff+3);
+
+        if (strncmp(buff,"AS",2)||!(sat=satid2no(satid))) continue;
+
+        for (i=0;i<2;i++) data[i]=str2num(buff,40+i*20,19);
+
+        if (nav->nc>=nav->ncmax) {
+            nav->ncmax+=1024;
+            nav->pclk=(pclk_t *)realloc(nav->pclk,sizeof(pclk_t)*nav->ncmax);
+        }
+        if (nav->nc<=0||fabs(timediff(time,nav->pclk[nav->nc-1].time))>1E-9) {
+            pclk=nav->pclk+nav->nc++;
+            memset(pclk,0,sizeof(pclk_t));
+            pclk->time=time;
+        }
+        nav->pclk[nav->nc-1].clk[sat-1][0]=data[0];
+        nav->pclk[nav->nc-1].std[sat-1][0]=(float)data[1];
+    }
+    fclose(fp);
+}
+/* compare precise ephemeris and clock ---------------------------------------*/
+static int cmpnav(const nav_t *nav1, const nav_t *nav2)
+{
+    int i;
+
+    if (nav1->ne!=nav2->ne||nav1->nc!=nav2->nc) return 0;
+
+    for (i=0;i<nav1->ne;i++) {
+        if (timediff(nav1->peph[i].time,nav2->peph[i].time)!=0.0||
+            memcmp(nav1->peph[i].pos,nav2->peph[i].pos,sizeof(nav1->peph[i].pos))||
+            memcmp(nav1->peph[i].std,nav2->peph[i].std,sizeof(nav1->peph[i].std))) {
+            return 0;
+        }
+    }
+    for (i=0;i<nav1->nc;i++) {
+        if (timediff(nav1->pclk[i].time,nav2->pclk[i].time)!=0.0||
+            memcmp(nav1->pclk[i].clk,nav2->pclk[i].clk,sizeof(nav1->pclk[i].clk))||
+            memcmp(nav1->pclk[i].std,nav2->pclk[i].std,sizeof(nav1->pclk[i].std))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+/* free precise ephemeris and clock ------------------------------------------*/
+static void freeprod(nav_t *nav)
+{
+    free(nav->peph); nav->peph=NULL; nav->ne=nav->nemax=0;
+    free(nav->pclk); nav->pclk=NULL; nav->nc=nav->ncmax=0;
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    nav_t nav={0},ref={0};
+    unsigned int tick;
+    double sp3int=300.0,clkint=30.0,t[4]={0};
+    int i,nsta=400,nrep=3,ne,nc,ok;
+    char *dir=".",sp3file[1024],clkfile[1024];
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) sp3int=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-c")&&i+1<argc) clkint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-s")&&i+1<argc) nsta=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-r")&&i+1<argc) nrep=atoi(argv[++i]);
+    }
+    if (sp3int<=0.0||clkint<=0.0||nsta<0||nrep<1) return -1;
+
+    sprintf(sp3file,"%s/prodbench.sp3",dir);
+    sprintf(clkfile,"%s/prodbench.clk",dir);
+    srand(1);
+
+    if (!(ne=gensp3(sp3file,sp3int))||!(nc=genclk(clkfile,clkint,nsta))) {
+        fprintf(stderr,"product file write error: %s\n",dir);
+        return -1;
+    }
+    printf("sp3: %d epochs  clk: %d epochs %d stations\n",ne,nc,nsta);
+
+    for (i=0;i<nrep;i++) {
+        freeprod(&nav); freeprod(&ref);
+
+        tick=tickget(); readsp3(sp3file,&nav,0);  t[0]+=tickget()-tick;
+        tick=tickget(); refsp3 (sp3file,&ref);    t[1]+=tickget()-tick;
+        tick=tickget(); readrnxc(clkfile,&nav);   t[2]+=tickget()-tick;
+        tick=tickget(); refclk  (clkfile,&ref);   t[3]+=tickget()-tick;
+    }
+    ok=nav.ne==ne&&nav.nc==nc&&cmpnav(&nav,&ref);
+
+    printf("sp3 read : %8.1f ms (reference: %8.1f ms)\n",t[0]/nrep,t[1]/nrep);
+    printf("clk read : %8.1f ms (reference: %8.1f ms)\n",t[2]/nrep,t[3]/nrep);
+    printf("compare  : %s\n",ok?"OK":"NG");
+
+    freeprod(&nav); freeprod(&ref);
+    remove(sp3file); remove(clkfile);
+    return ok?0:-1;
+}
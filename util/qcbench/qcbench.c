@@ -0,0 +1,226 @@
+/*------------------------------------------------------------------------------
+* qcbench.c : observation data qc benchmark
+*
+* notes   : reads rinex observation and navigation files, tiles the
+*           observation data in time to a large data set and measures the
+*           throughput of the multipath computation by obsqc() in one pass,
+*           by inputqc() epoch by epoch and by the two-pass computation of
+*           rtkplot (multipath of each record, then arc mean removal along
+*           the records of each satellite). the multipath by obsqc() is
+*           checked to be identical to that of the two-pass computation.
+*
+*           qcbench [-o obsfile] [-n navfile] [-x ntile] [-r repeat] [-s]
+*
+*           -o obsfile rinex observation file
+*                     (default: ../../test/data/rinex/07590920.05o)
+*           -n navfile rinex navigation file
+*                     (default: ../../test/data/rinex/07590920.05n)
+*           -x ntile  number of tiles of observation data (default: 1000)
+*           -r repeat number of runs (default: 3)
+*           -s        output qc statistics to stdout
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define OBSFILE     "../../test/data/rinex/07590920.05o"
+#define NAVFILE     "../../test/data/rinex/07590920.05n"
+#define THRES_SLIP  2.0                 /* threshold of cycle-slip (m) */
+
+#define SQR(x)      ((x)*(x))
+
+/* elapsed time (ms) ---------------------------------------------------------*/
+static double elapsed(unsigned int tick)
+{
+    return (double)(tickget()-tick);
+}
+/* tile observation data in time with loss-of-lock at start of tiles --------*/
+static int tileobs(obs_t *obs, int ntile)
+{
+    obsd_t *data;
+    double span;
+    int i,j,k,n=obs->n,first[MAXSAT];
+
+    if (n<=0||ntile<=1) return n;
+
+    span=timediff(obs->data[n-1].time,obs->data[0].time)+1.0;
+    if (!(data=(obsd_t *)realloc(obs->data,sizeof(obsd_t)*n*ntile))) return 0;
+    obs->data=data;
+    for (i=1;i<ntile;i++) {
+        for (j=0;j<MAXSAT;j++) first[j]=1;
+        for (j=0;j<n;j++) {
+            data[i*n+j]=data[j];
+            data[i*n+j].time=timeadd(data[j].time,span*i);
+            if (!first[data[j].sat-1]) continue;
+            for (k=0;k<NFREQ+NEXOBS;k++) data[i*n+j].LLI[k]|=1;
+            first[data[j].sat-1]=0;
+        }
+    }
+    obs->n=obs->nmax=n*ntile;
+    return obs->n;
+}
+/* frequency pair for multipath (rtkplot) ------------------------------------*/
+static void mpfreq(int sys, unsigned char code, int *f1, int *f2)
+{
+    code2obs(code,f1);
+
+    if (sys==SYS_CMP) {
+        if      (*f1==5) *f1=2;
+        else if (*f1==4) *f1=3;
+    }
+    if      (sys==SYS_GAL) *f2=*f1==1?3:1;
+    else if (sys==SYS_SBS) *f2=*f1==1?3:1;
+    else if (sys==SYS_CMP) *f2=*f1==1?2:1;
+    else                   *f2=*f1==1?2:1;
+}
+/* two-pass multipath of rtkplot ---------------------------------------------*/
+static void mpref(const obs_t *obs, const nav_t *nav, double **mp)
+{
+    const obsd_t *data;
+    double lam1,lam2,C,I,B;
+    int i,j,k,n,f1,f2,sys,sat,slip,first[MAXSAT],last[MAXSAT],*next;
+
+    next=(int *)malloc(sizeof(int)*obs->n);
+
+    /* multipath of each record */
+    for (i=0;i<MAXSAT;i++) first[i]=last[i]=-1;
+    for (i=0;i<obs->n;i++) {
+        data=obs->data+i;
+        next[i]=-1;
+        if (last[data->sat-1]<0) first[data->sat-1]=i;
+        else next[last[data->sat-1]]=i;
+        last[data->sat-1]=i;
+
+        sys=satsys(data->sat,NULL);
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            mp[j][i]=0.0;
+            mpfreq(sys,data->code[j],&f1,&f2);
+            lam1=satwavelen(data->sat,f1-1,nav);
+            lam2=satwavelen(data->sat,f2-1,nav);
+            if (lam1==0.0||lam2==0.0) continue;
+            if (data->P[j]!=0.0&&data->L[j]!=0.0&&data->L[f2-1]!=0.0) {
+                C=SQR(lam1)/(SQR(lam1)-SQR(lam2));
+                I=lam1*data->L[j]-lam2*data->L[f2-1];
+                mp[j][i]=data->P[j]-lam1*data->L[j]+2.0*C*I;
+            }
+        }
+    }
+    /* arc mean removal along records of each satellite */
+    for (sat=1;sat<=MAXSAT;sat++) {
+        sys=satsys(sat,NULL);
+        for (j=0;j<NFREQ+NEXOBS;j++) {
+            for (i=first[sat-1],k=-1,n=0,B=0.0,slip=0;i>=0;i=next[i]) {
+                data=obs->data+i;
+                if (data->L[j]==0.0&&data->P[j]==0.0) continue;
+                mpfreq(sys,data->code[j],&f1,&f2);
+                if ((data->LLI[j]&1)||(data->LLI[f2-1]&1)) slip=1;
+                if (mp[j][i]==0.0) continue;
+
+                if (n>0&&(slip||fabs(mp[j][i]-B)>THRES_SLIP)) {
+                    for (;k>=0&&k!=i;k=next[k]) if (mp[j][k]!=0.0) mp[j][k]-=B;
+                    n=0;
+                }
+                slip=0;
+                if (n==0) {
+                    k=i; B=mp[j][i]; n=1;
+                }
+                else B+=(mp[j][i]-B)/++n;
+            }
+            for (;n>0&&k>=0;k=next[k]) if (mp[j][k]!=0.0) mp[j][k]-=B;
+        }
+    }
+    free(next);
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    obs_t obs={0};
+    nav_t nav={0};
+    qc_t *qc;
+    unsigned int tick;
+    double *mp[NFREQ+NEXOBS],*ref[NFREQ+NEXOBS],*mpr,t[3]={0},dmax=0.0;
+    int i,j,k,ntile=1000,nrep=3,stat=0,nmp=0,nep,ok=1;
+    char *obsfile=OBSFILE,*navfile=NAVFILE;
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-o")&&i+1<argc) obsfile=argv[++i];
+        else if (!strcmp(argv[i],"-n")&&i+1<argc) navfile=argv[++i];
+        else if (!strcmp(argv[i],"-x")&&i+1<argc) ntile=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-r")&&i+1<argc) nrep=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-s")) stat=1;
+    }
+    if (ntile<1||nrep<1) return -1;
+
+    if (readrnx(obsfile,1,"",&obs,NULL,NULL)<=0||
+        !readrnx(navfile,0,"",NULL,&nav,NULL)) {
+        fprintf(stderr,"rinex file read error: %s %s\n",obsfile,navfile);
+        return -1;
+    }
+    sortobs(&obs);
+    if (!tileobs(&obs,ntile)) {
+        fprintf(stderr,"memory allocation error\n");
+        return -1;
+    }
+    for (j=0;j<NFREQ+NEXOBS;j++) {
+        mp [j]=(double *)calloc(obs.n,sizeof(double));
+        ref[j]=(double *)calloc(obs.n,sizeof(double));
+    }
+    mpr=(double *)malloc(sizeof(double)*MAXOBS*(NFREQ+NEXOBS));
+    qc=(qc_t *)malloc(sizeof(qc_t));
+
+    for (i=nep=0;i<obs.n;i++) {
+        if (i==0||timediff(obs.data[i].time,obs.data[i-1].time)>1E-9) nep++;
+    }
+    printf("records: %d  epochs: %d  tiles: %d\n",obs.n,nep,ntile);
+
+    for (k=0;k<nrep;k++) {
+        /* two-pass computation of rtkplot */
+        tick=tickget();
+        mpref(&obs,&nav,ref);
+        t[0]+=elapsed(tick);
+
+        /* one-pass computation by obsqc() */
+        tick=tickget();
+        initqc(qc);
+        nmp=obsqc(qc,&obs,&nav,mp);
+        t[1]+=elapsed(tick);
+
+        /* epoch by epoch computation by inputqc() */
+        tick=tickget();
+        initqc(qc);
+        for (i=0;i<obs.n;i=j) {
+            for (j=i+1;j<obs.n;j++) {
+                if (timediff(obs.data[j].time,obs.data[i].time)>1E-9) break;
+            }
+            inputqc(qc,obs.data+i,j-i<MAXOBS?j-i:MAXOBS,&nav,mpr);
+        }
+        closeqc(qc);
+        t[2]+=elapsed(tick);
+    }
+    for (j=0;j<NFREQ+NEXOBS;j++) for (i=0;i<obs.n;i++) {
+        if (fabs(mp[j][i]-ref[j][i])>dmax) dmax=fabs(mp[j][i]-ref[j][i]);
+    }
+    if (nmp<=0||dmax>1E-6) ok=0;
+
+    printf("multipath samples: %d\n",nmp);
+    printf("two-pass (rtkplot) : %8.1f ms %8.2f Mrec/s\n",t[0]/nrep,
+           t[0]>0.0?obs.n*nrep/t[0]*1E-3:0.0);
+    printf("one-pass obsqc()   : %8.1f ms %8.2f Mrec/s\n",t[1]/nrep,
+           t[1]>0.0?obs.n*nrep/t[1]*1E-3:0.0);
+    printf("epochs   inputqc() : %8.1f ms %8.2f Mrec/s\n",t[2]/nrep,
+           t[2]>0.0?obs.n*nrep/t[2]*1E-3:0.0);
+    printf("multipath check: %s (max diff=%.3E m)\n",ok?"OK":"NG",dmax);
+
+    if (stat) outqc(stdout,qc);
+
+    for (j=0;j<NFREQ+NEXOBS;j++) {
+        free(mp[j]);
+        free(ref[j]);
+    }
+    free(mpr);
+    free(qc);
+    freeobs(&obs);
+    freenav(&nav,0xFF);
+    return ok?0:-1;
+}
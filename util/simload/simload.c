@@ -0,0 +1,625 @@
+/*------------------------------------------------------------------------------
+* simload.c : multi-receiver observation data load generator
+*
+* notes   : simulates observation data of multiple static or moving receivers
+*           by broadcast ephemeris at a high rate with the error models of
+*           simobs, encodes them to rtcm 3 msm, station and ephemeris messages
+*           and outputs them to a stream in real-time or as fast as possible.
+*           the satellite positions are computed once per epoch for all of the
+*           receivers. the receiver positions, ambiguities, cycle-slips and
+*           measurement errors are generated by the random number sequence of
+*           each receiver initialized by the seed, so the output messages are
+*           reproducible for the same options.
+*
+*           simload [-n navfile ...] [-out stream] [-r nrcv] [-hz rate]
+*                   [-t span] [-ts y/m/d h:m:s] [-p lat lon hgt] [-rad km]
+*                   [-v speed] [-msg msgs] [-el mask] [-slip prob] [-seed n]
+*                   [-x speed] [-d tint]
+*
+*           -n navfile rinex navigation file (multiple -n allowed)
+*                     (default: ../../test/data/rinex/07590920.05n)
+*           -out stream output stream path (default: simload.rtcm3)
+*                     tcp server   : tcpsvr://:port
+*                     tcp client   : tcpcli://addr[:port]
+*                     ntrip server : ntrips://[:passwd@]addr[:port]/mntpnt
+*                     ntrip caster : ntripc_c://[user:passwd@][:port]/mntpnt
+*                     udp client   : udpcli://addr:port
+*                     file         : [file://]path
+*                     if the path contains %r, a stream is opened for each
+*                     receiver with %r replaced by the receiver id (0001,...).
+*                     otherwise, the messages of all receivers are output to
+*                     the stream with the station id of each receiver.
+*           -r nrcv   number of receivers (default: 10)
+*           -hz rate  observation rate (Hz) (default: 1)
+*           -t span   time span (s) (default: 60)
+*           -ts time  start time (gpst) (default: time of first ephemeris)
+*           -p lat lon hgt center of receivers area (deg,m)
+*                     (default: 35.16 139.61 70.0)
+*           -rad km   radius of receivers area (km) (default: 10)
+*           -v speed  speed of receivers moving on circles (m/s) (default: 0)
+*           -msg msgs rtcm 3 message types and intervals (s) (default:
+*                     1074,1084,1094,1124,1005(10),1019(30),1020(30),
+*                     1046(30),1042(30))
+*           -el mask  elevation mask (deg) (default: 10)
+*           -slip prob probability of cycle-slip per signal and epoch
+*                     (default: 0)
+*           -seed n   random seed (default: 1)
+*           -x speed  speed factor to real-time (0: as fast as possible)
+*                     (default: 1)
+*           -d tint   status display interval (s) (default: 1)
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include <signal.h>
+#include "rtklib.h"
+
+#define NAVFILE     "../../test/data/rinex/07590920.05n"
+#define OUTPATH     "simload.rtcm3"
+#define MAXSIMRCV   4095                /* max number of receivers */
+#define MAXMSG      32                  /* max number of messages */
+#define MAXBUFF     65536               /* max bytes of messages of an epoch */
+#define RCIRC       100.0               /* radius of circle of moving rcv (m) */
+#define TTRANS      0.075               /* nominal signal travel time (s) */
+
+#define SQR(x)      ((x)*(x))
+
+/* error models of simobs ----------------------------------------------------*/
+static const double errion=0.005;       /* ionosphere error (m/10km) */
+static const double errcp1=0.002;       /* carrier-phase meas error (m) */
+static const double errcp2=0.002;       /* carrier-phase meas error/sin(el) (m) */
+static const double errpr1=0.2;         /* pseudorange error (m) */
+static const double errpr2=0.2;         /* pseudorange error/sin(el) (m) */
+
+/* snr and snr deviation by elevation (5 deg interval) and loss (dBHz) */
+static const double snrs[]={40,42,44,45,46,47,48,49,49,50,50,51,51,51,51,51,51,51,51};
+static const double sdvs[]={ 3, 3, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1};
+static const double loss[]={ 0, 3, 0};
+
+/* signal codes of frequencies {L1,L2,L5} by system --------------------------*/
+static const int syss[]={SYS_GPS,SYS_GLO,SYS_GAL,SYS_QZS,SYS_CMP,0};
+static const unsigned char codes[][3]={
+    {CODE_L1C,CODE_L2W,CODE_L5Q},       /* GPS */
+    {CODE_L1C,CODE_L2C,0       },       /* GLONASS */
+    {CODE_L1C,CODE_L7Q,CODE_L5Q},       /* Galileo */
+    {CODE_L1C,CODE_L2L,CODE_L5Q},       /* QZSS */
+    {CODE_L2I,CODE_L7I,CODE_L6I}        /* BeiDou */
+};
+typedef struct {            /* simulated satellite type */
+    int sat;                /* satellite number */
+    double rs[6];           /* satellite position/velocity (ecef) (m,m/s) */
+    double dts[2];          /* satellite clock bias/drift (s,s/s) */
+} simsat_t;
+
+typedef struct {            /* simulated receiver type */
+    int id;                 /* receiver id */
+    unsigned int seed;      /* random number state */
+    double rc[3];           /* center position (ecef) (m) */
+    double pos[3];          /* center position {lat,lon,hgt} (rad,m) */
+    double az0;             /* initial angle on circle (rad) */
+    double bl;              /* distance from center of area (10km) */
+    double ecp[MAXSAT][NFREQ]; /* filtered carrier-phase errors (m) */
+    double epr[MAXSAT][NFREQ]; /* filtered pseudorange errors (m) */
+    double amb[MAXSAT][NFREQ]; /* carrier-phase ambiguities (cyc) */
+    rtcm_t *rtcm;           /* rtcm encoder */
+    stream_t *str;          /* output stream */
+} simrcv_t;
+
+static volatile int intrflg=0;          /* interrupt flag */
+
+/* signal handler ------------------------------------------------------------*/
+static void sigfunc(int sig)
+{
+    intrflg=1;
+}
+/* uniform random number in (0,1] by xorshift --------------------------------*/
+static double urand(unsigned int *seed)
+{
+    unsigned int x=*seed;
+
+    x^=(x<<13)&0xFFFFFFFF;
+    x^=x>>17;
+    x^=(x<<5)&0xFFFFFFFF;
+    *seed=x;
+    return ((double)x+1.0)/4294967296.0;
+}
+/* random number with normal distribution ------------------------------------*/
+static double randn(unsigned int *seed, double sig)
+{
+    double a=urand(seed),b=urand(seed);
+    return sqrt(-2.0*log(a))*sin(2.0*PI*b)*sig;
+}
+/* system index --------------------------------------------------------------*/
+static int sysind(int sys)
+{
+    int i;
+    for (i=0;syss[i];i++) if (syss[i]==sys) return i;
+    return -1;
+}
+/* msm message system --------------------------------------------------------*/
+static int msmsys(int msg)
+{
+    if (1071<=msg&&msg<=1077) return SYS_GPS;
+    if (1081<=msg&&msg<=1087) return SYS_GLO;
+    if (1091<=msg&&msg<=1097) return SYS_GAL;
+    if (1111<=msg&&msg<=1117) return SYS_QZS;
+    if (1121<=msg&&msg<=1127) return SYS_CMP;
+    return 0;
+}
+/* ephemeris message system --------------------------------------------------*/
+static int ephsys(int msg)
+{
+    switch (msg) {
+        case 1019: return SYS_GPS;
+        case 1020: return SYS_GLO;
+        case 1044: return SYS_QZS;
+        case 1045:
+        case 1046: return SYS_GAL;
+        case 1042: return SYS_CMP;
+    }
+    return 0;
+}
+/* decode stream path --------------------------------------------------------*/
+static int decodepath(const char *path, int *type, char *strpath)
+{
+    const char *p;
+
+    if (!(p=strstr(path,"://"))) {
+        strcpy(strpath,path);
+        *type=STR_FILE;
+        return 1;
+    }
+    if      (!strncmp(path,"tcpsvr",  6)) *type=STR_TCPSVR;
+    else if (!strncmp(path,"tcpcli",  6)) *type=STR_TCPCLI;
+    else if (!strncmp(path,"ntripc_c",8)) *type=STR_NTRIPC_C;
+    else if (!strncmp(path,"ntrips",  6)) *type=STR_NTRIPSVR;
+    else if (!strncmp(path,"udpcli",  6)) *type=STR_UDPCLI;
+    else if (!strncmp(path,"file",    4)) *type=STR_FILE;
+    else {
+        fprintf(stderr,"stream path error: %s\n",path);
+        return 0;
+    }
+    strcpy(strpath,p+3);
+    return 1;
+}
+/* select ephemerides to ephemeris encoder -----------------------------------*/
+static void seleph(gtime_t time, const nav_t *nav, rtcm_t *enc)
+{
+    double tt,tmin[MAXSAT];
+    int i,sat,prn;
+
+    for (i=0;i<MAXSAT;i++) tmin[i]=1E9;
+
+    for (i=0;i<nav->n;i++) {
+        sat=nav->eph[i].sat;
+        if (sat<=0||sat>MAXSAT||nav->eph[i].svh) continue;
+        if ((tt=fabs(timediff(nav->eph[i].toe,time)))>=tmin[sat-1]) continue;
+        enc->nav.eph[sat-1]=nav->eph[i];
+        tmin[sat-1]=tt;
+    }
+    for (i=0;i<nav->ng;i++) {
+        sat=nav->geph[i].sat;
+        if (satsys(sat,&prn)!=SYS_GLO||nav->geph[i].svh) continue;
+        if ((tt=fabs(timediff(nav->geph[i].toe,time)))>=tmin[sat-1]) continue;
+        enc->nav.geph[prn-1]=nav->geph[i];
+        tmin[sat-1]=tt;
+    }
+}
+/* encode ephemeris messages -------------------------------------------------*/
+static int encode_eph(rtcm_t *enc, int msg, unsigned char *buff, int nmax)
+{
+    int sat,prn,sys=ephsys(msg),n=0;
+
+    for (sat=1;sat<=MAXSAT;sat++) {
+        if (satsys(sat,&prn)!=sys) continue;
+        if (sys==SYS_GLO?enc->nav.geph[prn-1].sat!=sat:
+                         enc->nav.eph[sat-1].sat!=sat) continue;
+        enc->ephsat=sat;
+        if (!gen_rtcm3(enc,msg,0)||n+enc->nbyte>nmax) continue;
+        memcpy(buff+n,enc->buff,enc->nbyte);
+        n+=enc->nbyte;
+    }
+    return n;
+}
+/* encode msm with multiple messages if nsat x nsig > 64 ---------------------*/
+static int encode_msm(rtcm_t *rtcm, int msg, int sync, unsigned char *buff,
+                      int nmax)
+{
+    obsd_t *data=rtcm->obs.data,obs[MAXOBS];
+    int i,j,k,sys=msmsys(msg),nobs=rtcm->obs.n,nsig=0,nsat=0,ns,nmsg,n=0;
+    int mask[MAXCODE]={0};
+
+    for (i=0;i<nobs;i++) {
+        if (satsys(data[i].sat,NULL)!=sys) continue;
+        nsat++;
+        for (j=0;j<NFREQ;j++) {
+            if (!data[i].code[j]||mask[data[i].code[j]-1]) continue;
+            mask[data[i].code[j]-1]=1;
+            nsig++;
+        }
+    }
+    if (nsig<=0||nsig>64) return 0;
+
+    ns=64/nsig;         /* max number of sats in a message */
+    nmsg=(nsat-1)/ns+1; /* number of messages */
+
+    rtcm->obs.data=obs;
+
+    for (i=j=0;i<nmsg;i++) {
+        for (k=0;k<ns&&j<nobs;j++) {
+            if (satsys(data[j].sat,NULL)!=sys) continue;
+            obs[k++]=data[j];
+        }
+        rtcm->obs.n=k;
+        if (!gen_rtcm3(rtcm,msg,i<nmsg-1?1:sync)||n+rtcm->nbyte>nmax) continue;
+        memcpy(buff+n,rtcm->buff,rtcm->nbyte);
+        n+=rtcm->nbyte;
+    }
+    rtcm->obs.data=data;
+    rtcm->obs.n=nobs;
+    return n;
+}
+/* compute satellite positions at epoch --------------------------------------*/
+static int simsat(gtime_t time, int navsys, const nav_t *nav, simsat_t *ss)
+{
+    double var;
+    int i,sat,svh,ns=0,eph[MAXSAT]={0};
+
+    /* skip satellites without ephemeris to avoid search of all satellites */
+    for (i=0;i<nav->n ;i++) eph[nav->eph [i].sat-1]=1;
+    for (i=0;i<nav->ng;i++) eph[nav->geph[i].sat-1]=1;
+
+    for (sat=1;sat<=MAXSAT;sat++) {
+        if (!eph[sat-1]||!(satsys(sat,NULL)&navsys)) continue;
+        if (!satpos(timeadd(time,-TTRANS),time,sat,EPHOPT_BRDC,nav,ss[ns].rs,
+                    ss[ns].dts,&var,&svh)||svh) continue;
+        ss[ns++].sat=sat;
+    }
+    return ns;
+}
+/* simulate observation data of a receiver -----------------------------------*/
+static int simrcv(simrcv_t *rcv, gtime_t time, double t, const simsat_t *ss,
+                  int ns, const nav_t *nav, double lam[][NFREQ], double speed,
+                  double elmask, double slip, obsd_t *obs)
+{
+    obsd_t *data;
+    double rr[3],vr[3]={0},pos[3],enu[3],rs[3],e[3],azel[2],r,dt,rate,ang;
+    double iono,trop,snr,fact,cp,pr,sinel;
+    int i,j,k,m,sat,n=0;
+
+    /* receiver position and velocity */
+    if (speed>0.0) {
+        ang=rcv->az0+speed*t/RCIRC;
+        enu[0]=RCIRC*cos(ang); enu[1]=RCIRC*sin(ang); enu[2]=0.0;
+        enu2ecef(rcv->pos,enu,rr);
+        for (i=0;i<3;i++) rr[i]+=rcv->rc[i];
+        enu[0]=-speed*sin(ang); enu[1]=speed*cos(ang);
+        enu2ecef(rcv->pos,enu,vr);
+    }
+    else {
+        for (i=0;i<3;i++) rr[i]=rcv->rc[i];
+    }
+    ecef2pos(rr,pos);
+
+    for (i=0;i<ns&&n<MAXOBS;i++) {
+        sat=ss[i].sat;
+        if ((m=sysind(satsys(sat,NULL)))<0) continue;
+
+        /* satellite position at transmission time */
+        if ((r=geodist(ss[i].rs,rr,e))<=0.0) continue;
+        dt=TTRANS-r/CLIGHT;
+        for (j=0;j<3;j++) rs[j]=ss[i].rs[j]+ss[i].rs[j+3]*dt;
+        if ((r=geodist(rs,rr,e))<=0.0) continue;
+        if (satazel(pos,e,azel)<elmask) continue;
+
+        r-=CLIGHT*(ss[i].dts[0]+ss[i].dts[1]*dt);
+        for (j=0,rate=0.0;j<3;j++) rate+=(ss[i].rs[j+3]-vr[j])*e[j];
+        rate-=CLIGHT*ss[i].dts[1];
+
+        iono=ionmodel(time,nav->ion_gps,pos,azel)+errion*rcv->bl*ionmapf(pos,azel);
+        trop=tropmodel(time,pos,azel,0.3);
+        sinel=sin(azel[1]);
+        k=(int)(azel[1]*R2D/5.0);
+
+        data=obs+n++;
+        memset(data,0,sizeof(obsd_t));
+        data->time=time;
+        data->sat=(unsigned char)sat;
+        data->rcv=1;
+
+        for (j=0;j<NFREQ&&j<3;j++) {
+            if (!codes[m][j]||lam[sat-1][j]<=0.0) continue;
+
+            /* filtered errors and snr of simobs */
+            rcv->ecp[sat-1][j]=0.5*rcv->ecp[sat-1][j]+0.5*
+                randn(&rcv->seed,sqrt(SQR(errcp1)+SQR(errcp2/sinel)));
+            rcv->epr[sat-1][j]=0.5*rcv->epr[sat-1][j]+0.5*
+                randn(&rcv->seed,sqrt(SQR(errpr1)+SQR(errpr2/sinel)));
+            snr=snrs[k]+randn(&rcv->seed,sdvs[k])-loss[j];
+
+            fact=SQR(lam[sat-1][j]/lam[sat-1][0]);
+            cp=r-fact*iono+trop+rcv->ecp[sat-1][j];
+            pr=r+fact*iono+trop+rcv->epr[sat-1][j];
+
+            /* ambiguity at start of arc or cycle-slip */
+            if (rcv->amb[sat-1][j]==0.0||(slip>0.0&&urand(&rcv->seed)<slip)) {
+                rcv->amb[sat-1][j]=floor(-cp/lam[sat-1][j])+
+                                   floor(urand(&rcv->seed)*1E4)+1.0;
+                data->LLI[j]=1;
+            }
+            data->L[j]=cp/lam[sat-1][j]+rcv->amb[sat-1][j];
+            data->P[j]=pr;
+            data->D[j]=(float)(-rate/lam[sat-1][j]);
+            data->SNR[j]=(unsigned char)(snr/0.25+0.5);
+            data->code[j]=codes[m][j];
+        }
+    }
+    /* reset ambiguities of satellites out of view */
+    for (i=j=0;i<MAXSAT;i++) {
+        if (j<n&&obs[j].sat==i+1) {j++; continue;}
+        for (k=0;k<NFREQ;k++) rcv->amb[i][k]=0.0;
+    }
+    return n;
+}
+/* encode messages of a receiver epoch ---------------------------------------*/
+static int encode_rcv(simrcv_t *rcv, gtime_t time, const obsd_t *obs, int n,
+                      const int *msgs, const int *nint, int nmsg, int k,
+                      unsigned char **ephbuf, const int *nephb,
+                      unsigned char *buff)
+{
+    rtcm_t *rtcm=rcv->rtcm;
+    int i,j,last=-1,nb=0,sync;
+
+    rtcm->time=time;
+    rtcm->obs.n=n;
+    for (i=0;i<n;i++) rtcm->obs.data[i]=obs[i];
+
+    /* last msm message with observation data for sync flag */
+    for (i=0;i<nmsg;i++) {
+        if (!msmsys(msgs[i])) continue;
+        for (j=0;j<n;j++) {
+            if (satsys(obs[j].sat,NULL)==msmsys(msgs[i])) {last=i; break;}
+        }
+    }
+    for (i=0;i<nmsg;i++) {
+        if (msmsys(msgs[i])) {
+            sync=i<last;
+            nb+=encode_msm(rtcm,msgs[i],sync,buff+nb,MAXBUFF-nb);
+        }
+        else if ((k+rcv->id)%nint[i]) {
+            continue;
+        }
+        else if (ephsys(msgs[i])) {
+            if (!ephbuf||nb+nephb[i]>MAXBUFF) continue;
+            memcpy(buff+nb,ephbuf[i],nephb[i]);
+            nb+=nephb[i];
+        }
+        else if (gen_rtcm3(rtcm,msgs[i],0)&&nb+rtcm->nbyte<=MAXBUFF) {
+            memcpy(buff+nb,rtcm->buff,rtcm->nbyte);
+            nb+=rtcm->nbyte;
+        }
+    }
+    return nb;
+}
+/* initialize receivers ------------------------------------------------------*/
+static int initrcv(simrcv_t *rcv, int nrcv, const double *pos0, double rad,
+                   unsigned int seed)
+{
+    double rr0[3],enu[3],dr[3],r,az;
+    int i,j;
+
+    pos2ecef(pos0,rr0);
+
+    for (i=0;i<nrcv;i++) {
+        memset(rcv+i,0,sizeof(simrcv_t));
+        rcv[i].id=i+1;
+        rcv[i].seed=(seed*2654435761U+(unsigned int)(i+1)*40503U)&0xFFFFFFFF;
+        if (!rcv[i].seed) rcv[i].seed=1;
+        for (j=0;j<8;j++) urand(&rcv[i].seed);
+
+        /* uniform distribution in receivers area */
+        r=rad*sqrt(urand(&rcv[i].seed));
+        az=2.0*PI*urand(&rcv[i].seed);
+        enu[0]=r*sin(az); enu[1]=r*cos(az); enu[2]=0.0;
+        enu2ecef(pos0,enu,dr);
+        for (j=0;j<3;j++) rcv[i].rc[j]=rr0[j]+dr[j];
+        ecef2pos(rcv[i].rc,rcv[i].pos);
+        rcv[i].az0=2.0*PI*urand(&rcv[i].seed);
+        rcv[i].bl=r/1E4;
+
+        if (!(rcv[i].rtcm=(rtcm_t *)malloc(sizeof(rtcm_t)))||
+            !init_rtcm(rcv[i].rtcm)) {
+            return 0;
+        }
+        rcv[i].rtcm->staid=rcv[i].id;
+        matcpy(rcv[i].rtcm->sta.pos,rcv[i].rc,3,1);
+    }
+    return 1;
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    nav_t nav={0};
+    simrcv_t *rcv;
+    simsat_t ss[MAXSAT];
+    rtcm_t *enc;
+    stream_t *str;
+    obsd_t obs[MAXOBS];
+    gtime_t ts={0},time;
+    static unsigned char buff[MAXBUFF],*ephbuf[MAXMSG]={0};
+    unsigned int tick0,tick,tickd,seed=1;
+    double pos0[3]={35.16,139.61,70.0},ep[6]={0},rad=10.0,speed=0.0,hz=1.0;
+    double span=60.0,elmask=10.0,slip=0.0,xspd=1.0,dint=1.0,tint[MAXMSG];
+    double lam[MAXSAT][NFREQ],nbyte=0.0,nbyte0=0.0,t;
+    char *navfile[16],*outpath=OUTPATH,*msgstr,*p,buff2[1024],path[1024];
+    char strpath[1024],id[16],tstr[32];
+    int i,j,k,n,nnav=0,nrcv=10,ne,nstr,type,nmsg=0,msgs[MAXMSG],nint[MAXMSG];
+    int nephb[MAXMSG]={0},navsys=0,lag,lagmax=0,nepoch=0;
+
+    msgstr="1074,1084,1094,1124,1005(10),1019(30),1020(30),1046(30),1042(30)";
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-n")&&i+1<argc&&nnav<16) navfile[nnav++]=argv[++i];
+        else if (!strcmp(argv[i],"-out" )&&i+1<argc) outpath=argv[++i];
+        else if (!strcmp(argv[i],"-r"   )&&i+1<argc) nrcv=atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-hz"  )&&i+1<argc) hz=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-t"   )&&i+1<argc) span=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-ts"  )&&i+1<argc) {
+            sscanf(argv[++i],"%lf/%lf/%lf %lf:%lf:%lf",ep,ep+1,ep+2,ep+3,ep+4,
+                   ep+5);
+            ts=epoch2time(ep);
+        }
+        else if (!strcmp(argv[i],"-p"   )&&i+3<argc) {
+            for (j=0;j<3;j++) pos0[j]=atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i],"-rad" )&&i+1<argc) rad=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-v"   )&&i+1<argc) speed=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-msg" )&&i+1<argc) msgstr=argv[++i];
+        else if (!strcmp(argv[i],"-el"  )&&i+1<argc) elmask=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-slip")&&i+1<argc) slip=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-seed")&&i+1<argc) seed=(unsigned int)atoi(argv[++i]);
+        else if (!strcmp(argv[i],"-x"   )&&i+1<argc) xspd=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-d"   )&&i+1<argc) dint=atof(argv[++i]);
+    }
+    if (nnav<=0) navfile[nnav++]=NAVFILE;
+    if (nrcv<1||nrcv>MAXSIMRCV||hz<=0.0||span<=0.0||xspd<0.0) {
+        fprintf(stderr,"option error\n");
+        return -1;
+    }
+    pos0[0]*=D2R; pos0[1]*=D2R;
+    rad*=1E3;
+    elmask*=D2R;
+
+    /* rtcm 3 message types and intervals */
+    strcpy(buff2,msgstr);
+    for (p=strtok(buff2,",");p&&nmsg<MAXMSG;p=strtok(NULL,",")) {
+        tint[nmsg]=0.0;
+        if (sscanf(p,"%d(%lf)",msgs+nmsg,tint+nmsg)<1) continue;
+        nint[nmsg]=tint[nmsg]*hz<1.0?1:(int)(tint[nmsg]*hz+0.5);
+        navsys|=msmsys(msgs[nmsg]);
+        nmsg++;
+    }
+    if (!navsys) {
+        fprintf(stderr,"no msm message: %s\n",msgstr);
+        return -1;
+    }
+    /* read navigation data */
+    for (i=0;i<nnav;i++) {
+        if (!readrnx(navfile[i],0,"",NULL,&nav,NULL)) {
+            fprintf(stderr,"navigation file read error: %s\n",navfile[i]);
+            return -1;
+        }
+    }
+    uniqnav(&nav);
+    if (nav.n<=0&&nav.ng<=0) {
+        fprintf(stderr,"no navigation data\n");
+        return -1;
+    }
+    if (!ts.time) {
+        ts=nav.n>0?nav.eph[0].toe:nav.geph[0].toe;
+    }
+    for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ;j++) {
+        lam[i][j]=satwavelen(i+1,j,&nav);
+    }
+    /* initialize receivers and ephemeris encoder */
+    rcv=(simrcv_t *)malloc(sizeof(simrcv_t)*nrcv);
+    enc=(rtcm_t *)malloc(sizeof(rtcm_t));
+    str=(stream_t *)malloc(sizeof(stream_t)*nrcv);
+    if (!rcv||!enc||!str||!init_rtcm(enc)||!initrcv(rcv,nrcv,pos0,rad,seed)) {
+        fprintf(stderr,"memory allocation error\n");
+        return -1;
+    }
+    for (i=0;i<nmsg;i++) {
+        if (ephsys(msgs[i])&&!(ephbuf[i]=(unsigned char *)malloc(MAXBUFF))) {
+            fprintf(stderr,"memory allocation error\n");
+            return -1;
+        }
+    }
+    /* open output streams */
+    strinitcom();
+    nstr=strstr(outpath,"%r")?nrcv:1;
+
+    for (i=0;i<nstr;i++) {
+        sprintf(id,"%04d",i+1);
+        reppath(outpath,path,ts,id,"");
+        strinit(str+i);
+        if (!decodepath(path,&type,strpath)||
+            !stropen(str+i,type,STR_MODE_W,strpath)) {
+            fprintf(stderr,"stream open error: %s\n",path);
+            for (i--;i>=0;i--) strclose(str+i);
+            return -1;
+        }
+    }
+    for (i=0;i<nrcv;i++) rcv[i].str=str+(nstr>1?i:0);
+
+    signal(SIGTERM,sigfunc);
+    signal(SIGINT ,sigfunc);
+#ifndef WIN32
+    signal(SIGPIPE,SIG_IGN);
+#endif
+    ne=(int)(span*hz+0.5);
+    time2str(ts,tstr,1);
+    fprintf(stderr,"start: %s  receivers: %d  rate: %.1f Hz  epochs: %d  "
+            "streams: %d\n",tstr,nrcv,hz,ne,nstr);
+
+    tick0=tickd=tickget();
+
+    for (k=0;k<ne&&!intrflg;k++) {
+        t=k/hz;
+        time=timeadd(ts,t);
+
+        /* wait for epoch time in real-time */
+        if (xspd>0.0) {
+            lag=(int)(tickget()-tick0)-(int)(t*1000.0/xspd);
+            if (lag<0) sleepms(-lag);
+            else if (lag>lagmax) lagmax=lag;
+        }
+        /* satellite positions and ephemeris messages */
+        n=simsat(time,navsys,&nav,ss);
+
+        if (k%(int)(hz<1.0?1:hz+0.5)==0) {
+            seleph(time,&nav,enc);
+            for (i=0;i<nmsg;i++) {
+                if (ephbuf[i]) nephb[i]=encode_eph(enc,msgs[i],ephbuf[i],MAXBUFF);
+            }
+        }
+        for (i=0;i<nrcv;i++) {
+            j=simrcv(rcv+i,time,t,ss,n,&nav,lam,speed,elmask,slip,obs);
+
+            /* ephemeris messages once per interval in a shared stream */
+            j=encode_rcv(rcv+i,time,obs,j,msgs,nint,nmsg,k,
+                         nstr>1||i==0?ephbuf:NULL,nephb,buff);
+            strwrite(rcv[i].str,buff,j);
+            nbyte+=j;
+        }
+        nepoch++;
+
+        /* status display */
+        if ((int)(tickget()-tickd)>=dint*1000.0) {
+            tick=tickget();
+            time2str(time,tstr,1);
+            fprintf(stderr,"%s epoch=%7d %9.1f rcv-epoch/s %8.1f kbps lag=%5d ms\n",
+                    tstr,k+1,nrcv*nepoch/((tick-tickd)*1E-3),
+                    (nbyte-nbyte0)*8.0/(tick-tickd),lagmax);
+            nbyte0=nbyte; nepoch=0; lagmax=0;
+            tickd=tick;
+        }
+    }
+    t=(tickget()-tick0)*1E-3;
+    fprintf(stderr,"epochs: %d  receivers: %d  bytes: %.0f  time: %.3f s  "
+            "%.0f rcv-epoch/s  %.2f MB/s\n",k,nrcv,nbyte,t,
+            t>0.0?k*nrcv/t:0.0,t>0.0?nbyte/t*1E-6:0.0);
+
+    for (i=0;i<nstr;i++) strclose(str+i);
+    for (i=0;i<nrcv;i++) {
+        free_rtcm(rcv[i].rtcm);
+        free(rcv[i].rtcm);
+    }
+    for (i=0;i<nmsg;i++) free(ephbuf[i]);
+    free_rtcm(enc);
+    free(enc);
+    free(rcv);
+    free(str);
+    freenav(&nav,0xFF);
+    return 0;
+}
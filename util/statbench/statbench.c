@@ -0,0 +1,243 @@
+/*------------------------------------------------------------------------------
+* statbench.c : binary solution status benchmark
+*
+* notes   : simulates rover and base station observations of gps satellites
+*           by broadcast ephemeris at a high rate, processes them by rtkpos()
+*           in kinematic mode with solution status output of residuals to a
+*           text and a binary file, converts the binary file to text by
+*           convsolstat() and measures the time of full and time-range reads
+*           by readsolstatt(). the solution status read from the text, binary
+*           and converted files are checked to be identical within the
+*           precision of the text format.
+*
+*           statbench [-n navfile] [-d dir] [-i tint] [-t span] [-r repeat]
+*
+*           -n navfile rinex navigation file
+*                     (default: ../../test/data/rinex/07590920.05n)
+*           -d dir    directory of solution status files (default: .)
+*           -i tint   observation interval (s) (default: 0.1)
+*           -t span   observation time span (s) (default: 600)
+*           -r repeat number of reads (default: 3)
+*
+* version : $Revision:$ $Date:$
+* history : 2026/10/17  1.0 new
+*-----------------------------------------------------------------------------*/
+#include "rtklib.h"
+
+#define NAVFILE     "../../test/data/rinex/07590920.05n"
+#define MINEL       (15.0*D2R)          /* min elevation angle (rad) */
+
+static const double ep0[]={2005,4,2,1,0,0};  /* start time (gpst) */
+static const double pos0[]={35.16*D2R,139.61*D2R,70.0}; /* rover position */
+static const double base[]={1000.0,-500.0,10.0}; /* base e/n/u from rover (m) */
+
+/* uniform random number in [a,b] --------------------------------------------*/
+static double urand(double a, double b)
+{
+    return a+(b-a)*rand()/(double)RAND_MAX;
+}
+/* elapsed time (ms) ---------------------------------------------------------*/
+static double elapsed(unsigned int tick)
+{
+    return (double)(tickget()-tick);
+}
+/* simulate observation data of a receiver -----------------------------------*/
+static int simobs(gtime_t time, const double *rr, int rcv, const nav_t *nav,
+                  const double *amb, obsd_t *obs)
+{
+    obsd_t *data;
+    double pos[3],rs[6],dts[2],var,r,e[3],azel[2],lam;
+    int i,j,n=0,sat,svh;
+
+    ecef2pos(rr,pos);
+
+    for (i=0;i<MAXPRNGPS;i++) {
+        sat=satno(SYS_GPS,i+1);
+        if (!satpos(timeadd(time,-0.07),time,sat,EPHOPT_BRDC,nav,rs,dts,&var,
+                    &svh)||svh) continue;
+        r=geodist(rs,rr,e);
+        if (!satpos(timeadd(time,-r/CLIGHT),time,sat,EPHOPT_BRDC,nav,rs,dts,
+                    &var,&svh)) continue;
+        r=geodist(rs,rr,e)-CLIGHT*dts[0];
+        if (satazel(pos,e,azel)<MINEL) continue;
+
+        data=obs+n++;
+        memset(data,0,sizeof(obsd_t));
+        data->time=time;
+        data->sat=(unsigned char)sat;
+        data->rcv=(unsigned char)rcv;
+        for (j=0;j<2;j++) {
+            lam=satwavelen(sat,j,nav);
+            data->P[j]=r+urand(-0.3,0.3);
+            data->L[j]=(r+urand(-0.003,0.003))/lam+amb[i*2+j];
+            data->SNR[j]=(unsigned char)((35.0+15.0*sin(azel[1])+urand(-1,1))/0.25);
+            data->code[j]=j==0?CODE_L1C:CODE_L2W;
+        }
+    }
+    return n;
+}
+/* process simulated observation data with solution status output ------------*/
+static int simpos(const char *file, int format, const nav_t *nav, double tint,
+                  double span)
+{
+    prcopt_t opt=prcopt_default;
+    rtk_t rtk;
+    obsd_t obs[MAXOBS*2];
+    gtime_t t0=epoch2time(ep0),time;
+    double rr[3],rb[3],dr[3],amb[2][MAXPRNGPS*2];
+    int i,j,n,ne=(int)(span/tint+0.5);
+
+    opt.mode=PMODE_KINEMA;
+    opt.nf=2;
+    opt.navsys=SYS_GPS;
+    opt.elmin=MINEL;
+    opt.ionoopt=IONOOPT_OFF;
+    opt.tropopt=TROPOPT_OFF;
+    opt.refpos=POSOPT_POS;
+    pos2ecef(pos0,rr);
+    enu2ecef(pos0,base,dr);
+    for (i=0;i<3;i++) opt.rb[i]=rb[i]=rr[i]+dr[i];
+
+    srand(1);
+    for (i=0;i<2;i++) for (j=0;j<MAXPRNGPS*2;j++) {
+        amb[i][j]=floor(urand(-1E6,1E6));
+    }
+    if (!rtkopenstatf(file,2,format)) return 0;
+    rtkinit(&rtk,&opt);
+
+    for (i=0;i<ne;i++) {
+        time=timeadd(t0,i*tint);
+        n =simobs(time,rr,1,nav,amb[0],obs);
+        n+=simobs(time,rb,2,nav,amb[1],obs+n);
+        rtkpos(&rtk,obs,n,nav);
+    }
+    rtkfree(&rtk);
+    rtkclosestat();
+    return ne;
+}
+/* compare solution status ---------------------------------------------------*/
+static int cmpstat(const void *p1, const void *p2)
+{
+    const solstat_t *q1=(const solstat_t *)p1,*q2=(const solstat_t *)p2;
+    double tt=timediff(q1->time,q2->time);
+    if (tt<-1E-9) return -1;
+    if (tt> 1E-9) return  1;
+    if (q1->sat!=q2->sat) return q1->sat<q2->sat?-1:1;
+    return (int)q1->frq-(int)q2->frq;
+}
+/* check solution status within precision of text format ---------------------*/
+static int checkstat(const solstatbuf_t *a, const solstatbuf_t *b)
+{
+    const solstat_t *p,*q;
+    int i;
+
+    if (a->n!=b->n) return 0;
+    qsort(a->data,a->n,sizeof(solstat_t),cmpstat);
+    qsort(b->data,b->n,sizeof(solstat_t),cmpstat);
+
+    for (i=0;i<a->n;i++) {
+        p=a->data+i; q=b->data+i;
+        if (fabs(timediff(p->time,q->time))>1E-3||p->sat!=q->sat||
+            p->frq!=q->frq||p->flag!=q->flag||p->lock!=q->lock||
+            p->outc!=q->outc||p->slipc!=q->slipc||p->rejc!=q->rejc||
+            fabs(p->az-q->az)>0.101*D2R||fabs(p->el-q->el)>0.101*D2R||
+            fabs(p->resp-q->resp)>1.01E-4||fabs(p->resc-q->resc)>1.01E-4||
+            abs((int)p->snr-(int)q->snr)>2) {
+            return 0;
+        }
+    }
+    return 1;
+}
+/* file size (bytes) ---------------------------------------------------------*/
+static double filesize(const char *file)
+{
+    FILE *fp;
+    double size;
+
+    if (!(fp=fopen(file,"rb"))) return 0.0;
+    fseek(fp,0,SEEK_END);
+    size=(double)ftell(fp);
+    fclose(fp);
+    return size;
+}
+/* main ----------------------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+    nav_t nav={0};
+    solstatbuf_t stat[3]={{0}};
+    gtime_t t0=epoch2time(ep0),ts,te,time0={0};
+    unsigned int tick;
+    double tint=0.1,span=600.0,t[6]={0};
+    int i,j,k,nrep=3,ne,nrng=0,ok=1;
+    char *navfile=NAVFILE,*dir=".",txtfile[1024],binfile[1024],cnvfile[1024];
+    char *files[3];
+
+    for (i=1;i<argc;i++) {
+        if      (!strcmp(argv[i],"-n")&&i+1<argc) navfile=argv[++i];
+        else if (!strcmp(argv[i],"-d")&&i+1<argc) dir=argv[++i];
+        else if (!strcmp(argv[i],"-i")&&i+1<argc) tint=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-t")&&i+1<argc) span=atof(argv[++i]);
+        else if (!strcmp(argv[i],"-r")&&i+1<argc) nrep=atoi(argv[++i]);
+    }
+    if (tint<=0.0||span<tint||nrep<1) return -1;
+
+    if (!readrnx(navfile,0,"",NULL,&nav,NULL)) {
+        fprintf(stderr,"navigation file read error: %s\n",navfile);
+        return -1;
+    }
+    for (i=0;i<MAXSAT;i++) for (j=0;j<NFREQ;j++) {
+        nav.lam[i][j]=satwavelen(i+1,j,&nav);
+    }
+    sprintf(txtfile,"%s/statbench_txt.stat",dir);
+    sprintf(binfile,"%s/statbench_bin.stat",dir);
+    sprintf(cnvfile,"%s/statbench_cnv.stat",dir);
+    files[0]=txtfile; files[1]=binfile; files[2]=cnvfile;
+
+    tick=tickget();
+    if (!(ne=simpos(txtfile,0,&nav,tint,span))||!simpos(binfile,1,&nav,tint,span)) {
+        fprintf(stderr,"solution status file write error: %s\n",dir);
+        return -1;
+    }
+    printf("epochs: %d (%.1f s)  text: %.1f MB  binary: %.1f MB\n",ne,
+           elapsed(tick)*1E-3,filesize(txtfile)/1E6,filesize(binfile)/1E6);
+
+    /* convert binary to text */
+    tick=tickget();
+    if (convsolstat(binfile,cnvfile)!=ne) ok=0;
+    t[0]=elapsed(tick);
+
+    /* read full and time-range solution status */
+    ts=timeadd(t0,span*0.45);
+    te=timeadd(ts,span*0.05);
+    for (i=0;i<nrep;i++) {
+        for (j=0;j<2;j++) {
+            freesolstatbuf(stat+j);
+            tick=tickget(); readsolstatt(files+j,1,time0,time0,0.0,stat+j);
+            t[1+j]+=elapsed(tick);
+            freesolstatbuf(stat+2);
+            tick=tickget(); readsolstatt(files+j,1,ts,te,0.0,stat+2);
+            t[3+j]+=elapsed(tick);
+            if (j==0) nrng=stat[2].n;
+            else if (stat[2].n!=nrng) ok=0;
+        }
+    }
+    for (k=0,i=0;i<stat[0].n;i++) {
+        if (screent(stat[0].data[i].time,ts,te,0.0)) k++;
+    }
+    if (k!=nrng) ok=0;
+
+    printf("records: %d  range: %d\n",stat[0].n,nrng);
+    printf("convert binary to text     : %8.1f ms\n",t[0]);
+    printf("read full  text / binary   : %8.1f / %8.1f ms\n",t[1]/nrep,t[2]/nrep);
+    printf("read range text / binary   : %8.1f / %8.1f ms\n",t[3]/nrep,t[4]/nrep);
+
+    /* check text, binary and converted solution status */
+    freesolstatbuf(stat+2);
+    readsolstatt(files+2,1,time0,time0,0.0,stat+2);
+    if (stat[0].n<=0||!checkstat(stat,stat+1)||!checkstat(stat,stat+2)) ok=0;
+    printf("text/binary/converted check: %s\n",ok?"OK":"NG");
+
+    for (i=0;i<3;i++) freesolstatbuf(stat+i);
+    freenav(&nav,0xFF);
+    return ok?0:-1;
+}
@@ -49,6 +49,8 @@ static void updatertcm(gtime_t time, rtcm_t *rtcm, nav_t *nav, FILE *fp)
         
         if (timediff(rtcm->time,time)>=5.0) break;
     }
+    if (!rtcm->ssr||!allocnav(nav,0x200)) return;
+    
     for (i=0;i<MAXSAT;i++) nav->ssr[i]=rtcm->ssr[i];
 }
 /* update lex ephemeris ------------------------------------------------------*/
@@ -179,10 +181,10 @@ int main(int argc, char **argv)
         if (!strcmp(ext,".sp3")||!strcmp(ext,".SP3")||
            !strcmp(ext,".eph")||!strcmp(ext,".EPH")) {
            if (nav.ne>0) {
-               readsp3(files[i],&nav2); /* second precise ephemeris */
+               readsp3(files[i],&nav2,0); /* second precise ephemeris */
            }
            else {
-               readsp3(files[i],&nav);
+               readsp3(files[i],&nav,0);
            }
         }
         else if (!strcmp(ext,".atx")) {